@@ -56,6 +56,10 @@ extern "C"
 /* Defines the number of descriptors used for RX */
 #define LPC_NUM_BUFF_RXDESCS 4
 
+/* Defines the number of buffers of the static RX pbuf pool, the buffers
+   not queued in a RX descriptor can be held by the stack */
+#define LPC_NUM_BUFF_RXPOOL 8
+
 /* Defines the number of descriptors used for TX */
 #define LPC_NUM_BUFF_TXDESCS 4
 
@@ -855,6 +855,12 @@
  */
 //#define PBUF_POOL_BUFSIZE               LWIP_MEM_ALIGN_SIZE(TCP_MSS+40+PBUF_LINK_HLEN)
 
+/**
+ * LWIP_SUPPORT_CUSTOM_PBUF==1: the EMAC driver receives the frames in place
+ * in the custom pbufs of its static RX pool (LPC_NUM_BUFF_RXPOOL).
+ */
+#define LWIP_SUPPORT_CUSTOM_PBUF        1
+
 /*
    ------------------------------------------------
    ---------- Network Interfaces options ----------
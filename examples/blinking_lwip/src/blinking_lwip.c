@@ -117,6 +117,9 @@ TASK(InitTask)
    /* set blinky task */
    SetRelAlarm(ActivateBlinkTask, 250, 250);
 
+   /* wake up the lwip loop for the lwip timers */
+   SetRelAlarm(WakeUpPeriodicTask, 100, 100);
+
    /* activate lwip loop as a background loop */
    ActivateTask(PeriodicTask);
 
@@ -146,8 +149,11 @@ TASK(PeriodicTask)
 {
    while(1)
    {
-      /* lwip stack periodic loop */
+      /* lwip stack loop */
       ciaaDriverEth_mainFunction();
+
+      /* sleep until a frame is received or sent or the lwip timers expire */
+      ciaaDriverEth_wait();
    }
 }
 
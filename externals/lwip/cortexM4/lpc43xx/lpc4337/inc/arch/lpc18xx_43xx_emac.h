@@ -56,14 +56,18 @@ extern "C"
 /**
  * @brief	Attempt to read a packet from the EMAC interface
  * @param	netif	: lwip network interface structure pointer
- * @return	Nothing
+ * @return	1 if a packet was taken from the RX descriptors, 0 if none was ready
+ * @note	Call it until it returns 0 to handle all the received packets.
  */
-void lpc_enetif_input(struct netif *netif);
+s32_t lpc_enetif_input(struct netif *netif);
 
 /**
- * @brief	Attempt to allocate and requeue a new pbuf for RX
+ * @brief	Attempt to requeue the free pbufs of the RX pool
  * @param	netif	: lwip network interface structure pointer
  * @return	The number of new descriptors queued
+ * @note	The RX pbufs are taken from a static pool of LPC_NUM_BUFF_RXPOOL
+ * buffers, the packets are received in place and handed to lwIP without
+ * copy. The pbufs return to the pool when lwIP frees them.
  */
 s32_t lpc_rx_queue(struct netif *netif);
 
@@ -44,6 +44,7 @@
 
 #include "chip.h"
 #include "lpc_phy.h"
+#include "ciaaDriverEthRing.h"
 
 #include <string.h>
 
@@ -61,6 +62,20 @@ extern void msDelay(uint32_t ms);
 #error LPC_CHECK_SLOWMEM must be 0 or 1
 #endif
 
+/* Number of RX buffers of the static pool, the buffers not queued in a
+   descriptor can be held by the stack (e.g. TCP out of sequence queue) */
+#ifndef LPC_NUM_BUFF_RXPOOL
+#define LPC_NUM_BUFF_RXPOOL (LPC_NUM_BUFF_RXDESCS * 2)
+#endif
+
+#if LPC_NUM_BUFF_RXPOOL < LPC_NUM_BUFF_RXDESCS
+#error LPC_NUM_BUFF_RXPOOL must be at least LPC_NUM_BUFF_RXDESCS
+#endif
+
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error LWIP_SUPPORT_CUSTOM_PBUF is needed for the RX pbuf pool
+#endif
+
 /** @ingroup NET_LWIP_LPC18XX43XX_EMAC_DRIVER
  * @{
  */
@@ -89,22 +104,26 @@ extern void msDelay(uint32_t ms);
  * so use it only for debug. */
 // #define LOCK_RX_THREAD
 
+/* RX pbuf of the static pool, the payload is the DMA buffer */
+struct lpc_rxpbuf {
+	struct pbuf_custom pc;		/**< lwIP custom pbuf, must be the first member */
+	u32_t data[EMAC_ETH_MAX_FLEN / sizeof(u32_t)];	/**< Word aligned frame buffer */
+};
+
 /* LPC EMAC driver data structure */
 struct lpc_enetdata {
 	struct netif *netif;		/**< Reference back to LWIP parent netif */
 
 	ENET_ENHTXDESC_T ptdesc[LPC_NUM_BUFF_TXDESCS];	/**< TX descriptor list */
 	ENET_ENHRXDESC_T prdesc[LPC_NUM_BUFF_RXDESCS];	/**< RX descriptor list */
-	struct pbuf *txpbufs[LPC_NUM_BUFF_TXDESCS];	/**< Saved pbuf pointers, for free after TX */
-
-	volatile u32_t tx_free_descs;	/**< Number of free TX descriptors */
-	u32_t tx_fill_idx;	/**< Current free TX descriptor index */
-	u32_t tx_reclaim_idx;	/**< Next incoming TX packet descriptor index */
-	struct pbuf *rxpbufs[LPC_NUM_BUFF_RXDESCS];	/**< Saved pbuf pointers for RX */
-
-	volatile u32_t rx_free_descs;	/**< Number of free RX descriptors */
-	volatile u32_t rx_get_idx;	/**< Index to next RX descriptor that id to be received */
-	u32_t rx_next_idx;	/**< Index to next RX descriptor that needs a pbuf */
+	ciaaDriverEthRing_type txring;	/**< TX descriptor ring, free count and indexes */
+	void *txpbufs[LPC_NUM_BUFF_TXDESCS];	/**< Saved pbuf pointers, for free after TX */
+	ciaaDriverEthRing_type rxring;	/**< RX descriptor ring, free count and indexes */
+	void *rxpbufs[LPC_NUM_BUFF_RXDESCS];	/**< Saved pbuf pointers for RX */
+
+	struct lpc_rxpbuf rxpool[LPC_NUM_BUFF_RXPOOL];	/**< RX pbuf pool */
+	ciaaDriverEthRing_poolType rxpool_free;	/**< Free RX pbufs of the pool */
+	void *rxpool_stack[LPC_NUM_BUFF_RXPOOL];	/**< Stack of the free RX pbufs */
 #if NO_SYS == 0
 	sys_sem_t RxSem;/**< RX receive thread wakeup semaphore */
 	sys_sem_t TxCleanSem;	/**< TX cleanup thread wakeup semaphore */
@@ -135,39 +154,51 @@ const static struct lpc_slowmem_array_t slmem[] = LPC_SLOWMEM_ARRAY;
  * Private functions
  ****************************************************************************/
 
-/* Queues a pbuf into a free RX descriptor */
-static void lpc_rxqueue_pbuf(struct lpc_enetdata *lpc_netifdata,
-							 struct pbuf *p)
+/* Returns a RX pbuf to the pool, called by pbuf_free once the stack
+   released the last reference. The buffer is queued again to a descriptor
+   by the next lpc_rx_queue call. */
+static void lpc_rxpool_free(struct pbuf *p)
+{
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	ciaaDriverEthRing_poolPut(&lpc_enetdata.rxpool_free, p);
+	SYS_ARCH_UNPROTECT(lev);
+}
+
+/* Gets a RX pbuf of the pool, the pbuf references the DMA buffer */
+static struct pbuf *lpc_rxpool_alloc(struct lpc_enetdata *lpc_netifdata)
 {
-	u32_t idx = lpc_netifdata->rx_next_idx;
+	struct lpc_rxpbuf *rxp;
+	SYS_ARCH_DECL_PROTECT(lev);
 
-	/* Save location of pbuf so we know what to pass to LWIP later */
-	lpc_netifdata->rxpbufs[idx] = p;
+	SYS_ARCH_PROTECT(lev);
+	rxp = ciaaDriverEthRing_poolGet(&lpc_netifdata->rxpool_free);
+	SYS_ARCH_UNPROTECT(lev);
 
-	/* Buffer size and address for pbuf */
-	lpc_netifdata->prdesc[idx].CTRL = (u32_t) RDES_ENH_BS1(p->len) |
-									  RDES_ENH_RCH;
-	if (idx == (LPC_NUM_BUFF_RXDESCS - 1)) {
-		lpc_netifdata->prdesc[idx].CTRL |= RDES_ENH_RER;
+	if (rxp == NULL) {
+		return NULL;
 	}
-	lpc_netifdata->prdesc[idx].B1ADD = (u32_t) p->payload;
 
-	/* Give descriptor to MAC/DMA */
-	lpc_netifdata->prdesc[idx].STATUS = RDES_OWN;
+	rxp->pc.custom_free_function = lpc_rxpool_free;
+	return pbuf_alloced_custom(PBUF_RAW, (u16_t) EMAC_ETH_MAX_FLEN, PBUF_REF,
+							   &rxp->pc, rxp->data, (u16_t) EMAC_ETH_MAX_FLEN);
+}
 
-	/* Update free count */
-	lpc_netifdata->rx_free_descs--;
+/* Queues a pbuf into a free RX descriptor */
+static void lpc_rxqueue_pbuf(struct lpc_enetdata *lpc_netifdata,
+							 struct pbuf *p)
+{
+	/* Save location of pbuf so we know what to pass to LWIP later, set
+	   the buffer size and address and give the descriptor to MAC/DMA. The
+	   ring marks the end of the list on the last descriptor. */
+	ciaaDriverEthRing_put(&lpc_netifdata->rxring, p, (u32_t) p->payload,
+						  (u32_t) RDES_ENH_BS1(p->len) | RDES_ENH_RCH,
+						  0, true);
 
 	LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
-				("lpc_rxqueue_pbuf: Queueing packet %p at index %d, free %d\n",
-				 p, idx, lpc_netifdata->rx_free_descs));
-
-	/* Update index for next pbuf */
-	idx++;
-	if (idx >= LPC_NUM_BUFF_RXDESCS) {
-		idx = 0;
-	}
-	lpc_netifdata->rx_next_idx = idx;
+				("lpc_rxqueue_pbuf: Queueing packet %p, free %d\n",
+				 p, ciaaDriverEthRing_free(&lpc_netifdata->rxring)));
 }
 
 /* This function sets up the descriptor list used for receive packets */
@@ -175,10 +206,11 @@ static err_t lpc_rx_setup(struct lpc_enetdata *lpc_netifdata)
 {
 	s32_t idx;
 
-	/* Set to start of list */
-	lpc_netifdata->rx_get_idx = 0;
-	lpc_netifdata->rx_next_idx = 0;
-	lpc_netifdata->rx_free_descs = LPC_NUM_BUFF_RXDESCS;
+	/* The descriptor lists are handled as rings of ciaaDriverEthRing */
+	LWIP_ASSERT("lpc_rx_setup: RX descriptor is not a ring descriptor",
+				sizeof(ENET_ENHRXDESC_T) == sizeof(ciaaDriverEthRing_descType));
+	LWIP_ASSERT("lpc_rx_setup: TX descriptor is not a ring descriptor",
+				sizeof(ENET_ENHTXDESC_T) == sizeof(ciaaDriverEthRing_descType));
 
 	/* Clear initial RX descriptor list */
 	memset(lpc_netifdata->prdesc, 0, sizeof(lpc_netifdata->prdesc));
@@ -196,22 +228,41 @@ static err_t lpc_rx_setup(struct lpc_enetdata *lpc_netifdata)
 		(u32_t) &lpc_netifdata->prdesc[0];
 	LPC_ETHERNET->DMA_REC_DES_ADDR = (u32_t) lpc_netifdata->prdesc;
 
+	/* Set to start of list, the receive polling is restarted by the ring */
+	ciaaDriverEthRing_init(&lpc_netifdata->rxring,
+						   (ciaaDriverEthRing_descType *) lpc_netifdata->prdesc,
+						   lpc_netifdata->rxpbufs, LPC_NUM_BUFF_RXDESCS,
+						   (void *) &LPC_ETHERNET->DMA_REC_POLL_DEMAND,
+						   0, RDES_ENH_RER);
+
+	/* All buffers of the RX pool are free */
+	ciaaDriverEthRing_poolInit(&lpc_netifdata->rxpool_free,
+							   lpc_netifdata->rxpool_stack, lpc_netifdata->rxpool,
+							   LPC_NUM_BUFF_RXPOOL, sizeof(struct lpc_rxpbuf));
+
 	/* Setup up RX pbuf queue, but post a warning if not enough were
 	   queued for all descriptors. */
 	if (lpc_rx_queue(lpc_netifdata->netif) != LPC_NUM_BUFF_RXDESCS) {
 		LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
-					("lpc_rx_setup: Warning, not enough memory for RX pbufs\n"));
+					("lpc_rx_setup: Warning, not enough RX pbufs in the pool\n"));
 	}
 
 	return ERR_OK;
 }
 
+/* Checks if the next RX descriptor holds a received packet */
+static s32_t lpc_rx_ready(struct lpc_enetdata *lpc_netifdata)
+{
+	return ciaaDriverEthRing_ready(&lpc_netifdata->rxring);
+}
+
 /* Gets data from queue and forwards to LWIP */
 static struct pbuf *lpc_low_level_input(struct netif *netif) {
 	struct lpc_enetdata *lpc_netifdata = netif->state;
-	u32_t status, ridx;
+	u32_t status;
 	int rxerr = 0;
 	struct pbuf *p;
+	void *buf;
 
 #ifdef LOCK_RX_THREAD
 #if NO_SYS == 0
@@ -220,23 +271,15 @@ static struct pbuf *lpc_low_level_input(struct netif *netif) {
 #endif
 #endif
 
-	/* If there are no used descriptors, then this call was
-	   not for a received packet, try to setup some descriptors now */
-	if (lpc_netifdata->rx_free_descs == LPC_NUM_BUFF_RXDESCS) {
-		lpc_rx_queue(netif);
-#ifdef LOCK_RX_THREAD
-#if NO_SYS == 0
-		sys_mutex_unlock(&lpc_netifdata->TXLockMutex);
-#endif
-#endif
-		return NULL;
-	}
-
-	/* Get index for next descriptor with data */
-	ridx = lpc_netifdata->rx_get_idx;
-
-	/* Return if descriptor is still owned by DMA */
-	if (lpc_netifdata->prdesc[ridx].STATUS & RDES_OWN) {
+	/* Get the pbuf and the receive packet status of the next descriptor,
+	   return if the descriptor is still owned by DMA */
+	if (!ciaaDriverEthRing_take(&lpc_netifdata->rxring, &buf, &status)) {
+		/* If there are no used descriptors, then this call was
+		   not for a received packet, try to setup some descriptors now */
+		if (ciaaDriverEthRing_free(&lpc_netifdata->rxring) ==
+			LPC_NUM_BUFF_RXDESCS) {
+			lpc_rx_queue(netif);
+		}
 #ifdef LOCK_RX_THREAD
 #if NO_SYS == 0
 		sys_mutex_unlock(&lpc_netifdata->TXLockMutex);
@@ -244,12 +287,7 @@ static struct pbuf *lpc_low_level_input(struct netif *netif) {
 #endif
 		return NULL;
 	}
-
-	/* Get address of pbuf for this descriptor */
-	p = lpc_netifdata->rxpbufs[ridx];
-
-	/* Get receive packet status */
-	status = lpc_netifdata->prdesc[ridx].STATUS;
+	p = (struct pbuf *) buf;
 
 	/* Check packet for errors */
 	if (status & RDES_ES) {
@@ -287,14 +325,6 @@ static struct pbuf *lpc_low_level_input(struct netif *netif) {
 		}
 	}
 
-	/* Increment free descriptor count and next get index */
-	lpc_netifdata->rx_free_descs++;
-	ridx++;
-	if (ridx >= LPC_NUM_BUFF_RXDESCS) {
-		ridx = 0;
-	}
-	lpc_netifdata->rx_get_idx = ridx;
-
 	/* If an error occurred, just re-queue the pbuf */
 	if (rxerr) {
 		lpc_rxqueue_pbuf(lpc_netifdata, p);
@@ -319,7 +349,7 @@ static struct pbuf *lpc_low_level_input(struct netif *netif) {
 	}
 
 	/* (Re)start receive polling */
-	LPC_ETHERNET->DMA_REC_POLL_DEMAND = 1;
+	ciaaDriverEthRing_start(&lpc_netifdata->rxring);
 
 #ifdef LOCK_RX_THREAD
 #if NO_SYS == 0
@@ -338,9 +368,6 @@ static err_t lpc_tx_setup(struct lpc_enetdata *lpc_netifdata)
 
 	/* Clear TX descriptors, will be queued with pbufs as needed */
 	memset((void *) &lpc_netifdata->ptdesc[0], 0, sizeof(lpc_netifdata->ptdesc));
-	lpc_netifdata->tx_free_descs = LPC_NUM_BUFF_TXDESCS;
-	lpc_netifdata->tx_fill_idx = 0;
-	lpc_netifdata->tx_reclaim_idx = 0;
 
 	/* Link/wrap descriptors */
 	for (idx = 0; idx < LPC_NUM_BUFF_TXDESCS; idx++) {
@@ -356,6 +383,14 @@ static err_t lpc_tx_setup(struct lpc_enetdata *lpc_netifdata)
 	/* Setup pointer to TX descriptor table */
 	LPC_ETHERNET->DMA_TRANS_DES_ADDR = (u32_t) lpc_netifdata->ptdesc;
 
+	/* All descriptors are free, the ring marks the end of the list on the
+	   last descriptor */
+	ciaaDriverEthRing_init(&lpc_netifdata->txring,
+						   (ciaaDriverEthRing_descType *) lpc_netifdata->ptdesc,
+						   lpc_netifdata->txpbufs, LPC_NUM_BUFF_TXDESCS,
+						   (void *) &LPC_ETHERNET->DMA_TRANS_POLL_DEMAND,
+						   TDES_ENH_TER, 0);
+
 	return ERR_OK;
 }
 
@@ -364,14 +399,17 @@ static err_t lpc_tx_setup(struct lpc_enetdata *lpc_netifdata)
 static err_t lpc_low_level_output(struct netif *netif, struct pbuf *sendp)
 {
 	struct lpc_enetdata *lpc_netifdata = netif->state;
-	u32_t idx, fidx, dn;
+	u32_t dn, ctrlstat;
+	s32_t first = -1, didx;
 	struct pbuf *p = sendp;
+	struct pbuf *wp;
+	int pcopy = 0;
 
 #if LPC_CHECK_SLOWMEM == 1
-	struct pbuf *q, *wp;
+	struct pbuf *q;
+	u32_t idx, fidx;
 
 	u8_t *dst;
-	int pcopy = 0;
 
 	/* Check packet address to determine if it's in slow memory and
 	   relocate if necessary */
@@ -416,18 +454,33 @@ static err_t lpc_low_level_output(struct netif *netif, struct pbuf *sendp)
 	   transfer. The pbuf chaining can be a mess! */
 	dn = (u32_t) pbuf_clen(p);
 
+	/* A chain longer than the descriptor list would never be sent, send
+	   a contiguous copy of it instead */
+	if (dn > LPC_NUM_BUFF_TXDESCS) {
+		wp = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_RAM);
+		if (!wp) {
+			LINK_STATS_INC(link.memerr);
+			return ERR_MEM;
+		}
+		pbuf_copy(wp, p);
+
+		/* LWIP will free original pbuf on exit of function */
+		pcopy = 1;
+		p = sendp = wp;
+		dn = 1;
+	}
+
 	/* Wait until enough descriptors are available for the transfer. */
 	/* THIS WILL BLOCK UNTIL THERE ARE ENOUGH DESCRIPTORS AVAILABLE */
 	while (dn > lpc_tx_ready(netif))
 #if NO_SYS == 0
 	{xSemaphoreTake(lpc_netifdata->xTXDCountSem, 0); }
 #else
-	{msDelay(1); }
+	/* Without an RTOS the descriptors of the frames already sent are
+	   reclaimed here, the transfer of a frame takes some microseconds */
+	{lpc_tx_reclaim(netif); }
 #endif
 
-	/* Get the next free descriptor index */
-	fidx = idx = lpc_netifdata->tx_fill_idx;
-
 #if NO_SYS == 0
 	/* Get exclusive access */
 	sys_mutex_lock(&lpc_netifdata->TXLockMutex);
@@ -437,77 +490,54 @@ static err_t lpc_low_level_output(struct netif *netif, struct pbuf *sendp)
 	while (dn > 0) {
 		dn--;
 
-		/* Setup packet address and length */
-		lpc_netifdata->ptdesc[idx].B1ADD = (u32_t) p->payload;
-		lpc_netifdata->ptdesc[idx].BSIZE = (u32_t) TDES_ENH_BS1(p->len);
+		/* IP checksumming requires full buffering in IP */
+		ctrlstat = TDES_ENH_TCH | TDES_ENH_CIC(3);
 
-		/* Save pointer to pbuf so we can reclain the memory for
-		   the pbuf after the buffer has been sent. Only the first
-		   pbuf in a chain is saved since the full chain doesn't
-		   need to be freed. */
 		/* For first packet only, first flag */
-		lpc_netifdata->tx_free_descs--;
-		if (idx == fidx) {
-			lpc_netifdata->ptdesc[idx].CTRLSTAT |= TDES_ENH_FS;
-#if LPC_CHECK_SLOWMEM == 1
-			/* If this is a copied pbuf, then avoid getting the extra reference
-			   or the TX reclaim will be off by 1 */
+		if (first < 0) {
+			ctrlstat |= TDES_ENH_FS;
+			/* Increment reference count on this packet so LWIP doesn't
+			   attempt to free it on return from this call. If this is a
+			   copied pbuf, then avoid getting the extra reference or the
+			   TX reclaim will be off by 1 */
 			if (!pcopy) {
 				pbuf_ref(p);
 			}
-#else
-			/* Increment reference count on this packet so LWIP doesn't
-			   attempt to free it on return from this call */
-			pbuf_ref(p);
-#endif
-		}
-		else {
-			lpc_netifdata->ptdesc[idx].CTRLSTAT |= TDES_OWN;
-		}
-
-		/* Save address of pbuf, but make sure it's associated with the
-		   first chained pbuf so it gets freed once all pbuf chains are
-		   transferred. */
-		if (!dn) {
-			lpc_netifdata->txpbufs[idx] = sendp;
-		}
-		else {
-			lpc_netifdata->txpbufs[idx] = NULL;
 		}
 
 		/* For last packet only, interrupt and last flag */
 		if (dn == 0) {
-			lpc_netifdata->ptdesc[idx].CTRLSTAT |= TDES_ENH_LS |
-												   TDES_ENH_IC;
+			ctrlstat |= TDES_ENH_LS | TDES_ENH_IC;
 		}
 
-		/* IP checksumming requires full buffering in IP */
-		lpc_netifdata->ptdesc[idx].CTRLSTAT |= TDES_ENH_CIC(3);
+		/* Setup packet address and length. Save address of pbuf, but
+		   make sure it's associated with the first chained pbuf so it
+		   gets freed once all pbuf chains are transferred. The first
+		   descriptor is given to the DMA once the whole chain is set. */
+		didx = ciaaDriverEthRing_put(&lpc_netifdata->txring, dn ? NULL : sendp,
+									 (u32_t) p->payload,
+									 (u32_t) TDES_ENH_BS1(p->len), ctrlstat,
+									 first >= 0);
+		if (first < 0) {
+			first = didx;
+		}
 
 		LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
 					("lpc_low_level_output: pbuf packet %p sent, chain %d,"
-					 " size %d, index %d, free %d\n", p, dn, p->len, idx,
-					 lpc_netifdata->tx_free_descs));
-
-		/* Update next available descriptor */
-		idx++;
-		if (idx >= LPC_NUM_BUFF_TXDESCS) {
-			idx = 0;
-		}
+					 " size %d, index %d, free %d\n", p, dn, p->len, didx,
+					 ciaaDriverEthRing_free(&lpc_netifdata->txring)));
 
 		/* Next packet fragment */
 		p = p->next;
 	}
 
-	lpc_netifdata->tx_fill_idx = idx;
-
 	LINK_STATS_INC(link.xmit);
 
 	/* Give first descriptor to DMA to start transfer */
-	lpc_netifdata->ptdesc[fidx].CTRLSTAT |= TDES_OWN;
+	ciaaDriverEthRing_own(&lpc_netifdata->txring, first);
 
 	/* Tell DMA to poll descriptors to start transfer */
-	LPC_ETHERNET->DMA_TRANS_POLL_DEMAND = 1;
+	ciaaDriverEthRing_start(&lpc_netifdata->txring);
 
 #if NO_SYS == 0
 	/* Restore access */
@@ -542,8 +572,7 @@ static void vPacketReceiveTask(void *pvParameters) {
 		sys_arch_sem_wait(&lpc_netifdata->RxSem, 0);
 
 		/* Process receive packets */
-		while (!(lpc_netifdata->prdesc[lpc_netifdata->rx_get_idx].STATUS
-				 & RDES_OWN)) {
+		while (ciaaDriverEthRing_ready(&lpc_netifdata->rxring)) {
 			lpc_enetif_input(lpc_netifdata->netif);
 		}
 	}
@@ -625,14 +654,12 @@ static err_t low_level_init(struct netif *netif)
 	/* Clear all MAC interrupts */
 	LPC_ETHERNET->DMA_STAT = DMA_ST_ALL;
 
-	/* Enable MAC interrupts */
+	/* Enable MAC interrupts. Without an RTOS the interrupt is handled by
+	   the application (e.g. to wake up the task calling lpc_enetif_input),
+	   they have no effect while the ETHERNET_IRQn is not enabled. */
 	LPC_ETHERNET->DMA_INT_EN =
-#if NO_SYS == 1
-		0;
-#else
 		DMA_IE_TIE | DMA_IE_OVE | DMA_IE_UNE | DMA_IE_RIE | DMA_IE_NIE |
 		DMA_IE_AIE | DMA_IE_TUE | DMA_IE_RUE;
-#endif
 
 	/* Enable receive and transmit DMA processes */
 	LPC_ETHERNET->DMA_OP_MODE |= DMA_OM_ST | DMA_OM_SR;
@@ -641,7 +668,7 @@ static err_t low_level_init(struct netif *netif)
 	LPC_ETHERNET->MAC_CONFIG |= MAC_CFG_RE | MAC_CFG_TE;
 
 	/* Start receive polling */
-	LPC_ETHERNET->DMA_REC_POLL_DEMAND = 1;
+	ciaaDriverEthRing_start(&lpc_netifdata->rxring);
 
 	return ERR_OK;
 }
@@ -649,7 +676,7 @@ static err_t low_level_init(struct netif *netif)
 /*****************************************************************************
  * Public functions
  ****************************************************************************/
-/* Attempt to allocate and requeue a new pbuf for RX */
+/* Attempt to requeue a free pbuf of the RX pool */
 s32_t lpc_rx_queue(struct netif *netif)
 {
 	struct lpc_enetdata *lpc_netifdata = netif->state;
@@ -658,24 +685,19 @@ s32_t lpc_rx_queue(struct netif *netif)
 	s32_t queued = 0;
 
 	/* Attempt to requeue as many packets as possible */
-	while (lpc_netifdata->rx_free_descs > 0) {
-		/* Allocate a pbuf from the pool. We need to allocate at the
-		   maximum size as we don't know the size of the yet to be
-		   received packet. */
-		p = pbuf_alloc(PBUF_RAW, (u16_t) EMAC_ETH_MAX_FLEN, PBUF_RAM);
+	while (ciaaDriverEthRing_free(&lpc_netifdata->rxring) > 0) {
+		/* Get a pbuf of the RX pool. The pool buffers have the maximum
+		   size as we don't know the size of the yet to be received
+		   packet, the frame is received in place and handed to lwIP. */
+		p = lpc_rxpool_alloc(lpc_netifdata);
 		if (p == NULL) {
 			LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
-						("lpc_rx_queue: could not allocate RX pbuf index %d, "
-						 "free %d)\n", lpc_netifdata->rx_next_idx,
-						 lpc_netifdata->rx_free_descs));
-			return queued;
+						("lpc_rx_queue: no free RX pbuf for index %d, "
+						 "free %d)\n", lpc_netifdata->rxring.fill,
+						 ciaaDriverEthRing_free(&lpc_netifdata->rxring)));
+			break;
 		}
 
-		/* pbufs allocated from the RAM pool should be non-chained (although
-		   the hardware will allow chaining) */
-		LWIP_ASSERT("lpc_rx_queue: pbuf is not contiguous (chained)",
-					pbuf_clen(p) <= 1);
-
 		/* Queue packet */
 		lpc_rxqueue_pbuf(lpc_netifdata, p);
 
@@ -683,20 +705,32 @@ s32_t lpc_rx_queue(struct netif *netif)
 		queued++;
 	}
 
+	/* Restart the receive DMA if it was suspended for lack of buffers */
+	if (queued > 0) {
+		ciaaDriverEthRing_start(&lpc_netifdata->rxring);
+	}
+
 	return queued;
 }
 
 /* Attempt to read a packet from the EMAC interface */
-void lpc_enetif_input(struct netif *netif)
+s32_t lpc_enetif_input(struct netif *netif)
 {
 	struct eth_hdr *ethhdr;
 
 	struct pbuf *p;
 
-	/* move received packet into a new pbuf */
+	/* Nothing received, queue the RX pbufs released by the stack */
+	if (!lpc_rx_ready(netif->state)) {
+		lpc_rx_queue(netif);
+		return 0;
+	}
+
+	/* get the pbuf of the received packet */
 	p = lpc_low_level_input(netif);
 	if (p == NULL) {
-		return;
+		/* frame dropped because of an error */
+		return 1;
 	}
 
 	/* points to packet payload, which starts with an Ethernet header */
@@ -723,14 +757,16 @@ void lpc_enetif_input(struct netif *netif)
 		pbuf_free(p);
 		break;
 	}
+
+	return 1;
 }
 
 /* Call for freeing TX buffers that are complete */
 void lpc_tx_reclaim(struct netif *netif)
 {
 	struct lpc_enetdata *lpc_netifdata = netif->state;
-	s32_t ridx;
 	u32_t status;
+	void *buf;
 
 #if NO_SYS == 0
 	/* Get exclusive access */
@@ -738,17 +774,11 @@ void lpc_tx_reclaim(struct netif *netif)
 #endif
 
 	/* If a descriptor is available and is no longer owned by the
-	   hardware, it can be reclaimed */
-	ridx = lpc_netifdata->tx_reclaim_idx;
-	while ((lpc_netifdata->tx_free_descs < LPC_NUM_BUFF_TXDESCS) &&
-		   (!(lpc_netifdata->ptdesc[ridx].CTRLSTAT & TDES_OWN))) {
-		/* Peek at the status of the descriptor to determine if the
-		   packet is good and any status information. */
-		status = lpc_netifdata->ptdesc[ridx].CTRLSTAT;
-
+	   hardware, it can be reclaimed. The status of the descriptor
+	   tells if the packet is good and any status information. */
+	while (ciaaDriverEthRing_take(&lpc_netifdata->txring, &buf, &status)) {
 		LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
-					("lpc_tx_reclaim: Reclaiming sent packet %p, index %d\n",
-					 lpc_netifdata->txpbufs[ridx], ridx));
+					("lpc_tx_reclaim: Reclaiming sent packet %p\n", buf));
 
 		/* Check TX error conditions */
 		if (status & TDES_ES) {
@@ -764,33 +794,17 @@ void lpc_tx_reclaim(struct netif *netif)
 #endif
 		}
 
-		/* Reset control for this descriptor */
-		if (ridx == (LPC_NUM_BUFF_TXDESCS - 1)) {
-			lpc_netifdata->ptdesc[ridx].CTRLSTAT = TDES_ENH_TCH |
-												   TDES_ENH_TER;
-		}
-		else {
-			lpc_netifdata->ptdesc[ridx].CTRLSTAT = TDES_ENH_TCH;
-		}
-
-		/* Free the pbuf associate with this descriptor */
-		if (lpc_netifdata->txpbufs[ridx]) {
-			pbuf_free(lpc_netifdata->txpbufs[ridx]);
+		/* Free the pbuf associate with this descriptor, only the last
+		   descriptor of a packet has it */
+		if (buf) {
+			pbuf_free((struct pbuf *) buf);
 		}
 
-		/* Reclaim this descriptor */
-		lpc_netifdata->tx_free_descs++;
 #if NO_SYS == 0
 		xSemaphoreGive(lpc_netifdata->xTXDCountSem);
 #endif
-		ridx++;
-		if (ridx >= LPC_NUM_BUFF_TXDESCS) {
-			ridx = 0;
-		}
 	}
 
-	lpc_netifdata->tx_reclaim_idx = ridx;
-
 #if NO_SYS == 0
 	/* Restore access */
 	sys_mutex_unlock(&lpc_netifdata->TXLockMutex);
@@ -800,21 +814,19 @@ void lpc_tx_reclaim(struct netif *netif)
 /* Polls if an available TX descriptor is ready */
 s32_t lpc_tx_ready(struct netif *netif)
 {
-	return ((struct lpc_enetdata *) netif->state)->tx_free_descs;
+	return ciaaDriverEthRing_free(&((struct lpc_enetdata *) netif->state)->txring);
 }
 
+#if NO_SYS == 0
 /**
  * @brief	EMAC interrupt handler
  * @return	Nothing
  * @note	This function handles the transmit, receive, and error interrupt of
- * the LPC118xx/43xx. This is meant to be used when NO_SYS=0.
+ * the LPC118xx/43xx. This is meant to be used when NO_SYS=0, without an
+ * RTOS the interrupt handler is provided by the application.
  */
 void OSEK_ISR_ETH_IRQHandler(void)
 {
-#if NO_SYS == 1
-	/* Interrupts are not used without an RTOS */
-	NVIC_DisableIRQ((IRQn_Type) ETHERNET_IRQn);
-#else
 	signed portBASE_TYPE xRecTaskWoken = pdFALSE, XTXTaskWoken = pdFALSE;
 	uint32_t ints;
 
@@ -840,8 +852,8 @@ void OSEK_ISR_ETH_IRQHandler(void)
 
 	/* Context switch needed? */
 	portEND_SWITCHING_ISR(xRecTaskWoken || XTXTaskWoken);
-#endif
 }
+#endif
 
 /* Set up the MAC interface duplex */
 void lpc_emac_set_duplex(int full_duplex)
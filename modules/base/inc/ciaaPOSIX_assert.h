@@ -36,6 +36,10 @@
  **
  ** ciaa POSIX assert header file
  **
+ ** A failed assertion is recorded with its file, line, task and program
+ ** counter in a ring placed in the not initialized ram, the records survive
+ ** a reset and can be read with ciaaPOSIX_assertGetRecords.
+ **
  **/
 
 /** \addtogroup CIAA_Firmware CIAA Firmware
@@ -45,6 +49,7 @@
 
 /*==================[inclusions]=============================================*/
 #include "ciaaPOSIX_stdio.h"
+#include "ciaaPOSIX_stdint.h"
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -52,12 +57,16 @@ extern "C" {
 #endif
 
 /*==================[macros]=================================================*/
+/** \brief count of records kept by the assert ring, a power of 2 */
+#define CIAAPOSIX_ASSERT_RECORDS    8
+
+/** \brief task of the records of the interrupts and before the os */
+#define CIAAPOSIX_ASSERT_NO_TASK    0xFF
+
 #define ciaaPOSIX__assert(file, line, expr)                                \
    if ((expr)==0)                                                          \
    {                                                                       \
-      (void)ciaaPOSIX_printf(ciaaPOSIX_assert_msg,                         \
-            (file), (line), #expr);                                        \
-      while(1==1);                                                         \
+      ciaaPOSIX_assertFailed((file), (line), #expr);                       \
    }
 
 /* UNITY_EXCLUDE_STDINT_H macro is used in Unit Test Enviroment */
@@ -69,11 +78,50 @@ extern "C" {
 #endif
 
 /*==================[typedef]================================================*/
+/** \brief record of a failed assertion or a fault */
+typedef struct {
+   char const * file;      /** <= source file or NULL for a fault */
+   uintptr_t pc;           /** <= program counter of the failure */
+   uint16_t line;          /** <= source line */
+   uint8_t task;           /** <= task id or CIAAPOSIX_ASSERT_NO_TASK */
+} ciaaPOSIX_assertRecordType;
 
 /*==================[external data declaration]==============================*/
 extern char const * const ciaaPOSIX_assert_msg;
 
 /*==================[external functions declaration]=========================*/
+/** \brief records a failure in the assert ring
+ **
+ ** Does not format anything, may be called from the fault handlers with
+ ** the stacked program counter and a NULL file.
+ **
+ ** \param[in] file source file of the failure, a constant string
+ ** \param[in] line source line of the failure
+ ** \param[in] pc program counter of the failure
+ **/
+extern void ciaaPOSIX_assertRecord(char const * file, uint32_t line, uintptr_t pc);
+
+/** \brief records a failed assertion, prints it and halts
+ **
+ ** Called by ciaaPOSIX_assert, does not return.
+ **
+ ** \param[in] file source file of the assertion
+ ** \param[in] line source line of the assertion
+ ** \param[in] expr failed expression
+ **/
+extern void ciaaPOSIX_assertFailed(char const * file, int32_t line, char const * expr);
+
+/** \brief get the newest records of the assert ring
+ **
+ ** \param[out] records buffer for the records, oldest first
+ ** \param[in] count maximal count of records to get
+ ** \return count of records got
+ **/
+extern uint32_t ciaaPOSIX_assertGetRecords(ciaaPOSIX_assertRecordType * records,
+      uint32_t count);
+
+/** \brief discards the records of the assert ring */
+extern void ciaaPOSIX_assertClear(void);
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -0,0 +1,93 @@
+<?php
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+
+/** \brief CIAA Kernel Pool Plan of the Generator
+ **
+ ** Plan of the pools declared with the POOL objects of the oil file, shared
+ ** by the ciaak_Cfg.h and ciaak_Cfg.c templates.
+ **
+ ** \file ciaak_Plan.php
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Kernel CIAA Kernel
+ ** @{ */
+
+/** \brief Returns the pools of the POOL objects of the oil file
+ **
+ ** The POOLs without MODULE or with MODULE = ciaak are the size classes of
+ ** ciaak_malloc, the others are dedicated to the given module as
+ ** ciaak_<name>Pool. The elements are 8 bytes aligned, e.g.:
+ **    POOL Small { SIZE = 24; COUNT = 32; };
+ **    POOL RxFrame { SIZE = 64; COUNT = 4; MODULE = drivers; };
+ ** Without size classes ciaak_malloc is served by ciaaPOSIX_malloc.
+ **
+ ** \param config configuration of the oil files
+ ** \param log log of the generator, a POOL without SIZE or COUNT is an error
+ ** \return array of the size classes sorted by size (size => count) and
+ **         array of the dedicated pools
+ **/
+function ciaak_poolPlan($config, $log)
+{
+   $slabs = array();
+   $pools = array();
+
+   foreach ($config->getList("/OSEK", "POOL") as $name)
+   {
+      $size = ((int)$config->getValue("/OSEK/" . $name, "SIZE") + 7) & ~7;
+      $count = (int)$config->getValue("/OSEK/" . $name, "COUNT");
+      $module = trim($config->getValue("/OSEK/" . $name, "MODULE"), '"');
+      if (($size == 0) || ($count == 0))
+      {
+         $log->error("POOL $name shall have a SIZE and a COUNT bigger than 0");
+      }
+      if (($module === "") || ($module == "ciaak"))
+      {
+         $slabs[$size] = $count;
+      }
+      else
+      {
+         $pools[] = array("name" => $name, "module" => $module, "size" => $size, "count" => $count);
+      }
+   }
+   ksort($slabs);
+
+   return array($slabs, $pools);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
@@ -0,0 +1,257 @@
+/********************************************************
+ * DO NOT CHANGE THIS FILE, IT IS GENERATED AUTOMATICALY*
+ ********************************************************/
+
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _CIAAK_CFG_H_
+#define _CIAAK_CFG_H_
+/** \brief CIAA Kernel Generated Configuration Header File
+ **
+ ** Static memory plan of the kernel, the heap, the task stacks and the
+ ** buffers of the posix devices are sized here at generation time, so the
+ ** kernel start up does not allocate any memory from the heap.
+ **
+ ** \file ciaak_Cfg.h
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Kernel CIAA Kernel
+ ** @{ */
+
+<?php
+/* count of devices registered by the drivers of each cpu, or of each arch
+ * if the cpu is none */
+$plans = array(
+   "lpc4337" => array("SERIAL_DEVICES" => 6, "BLOCK_DEVICES" => 0, "DIO_DEVICES" => 2),
+   "x86"     => array("SERIAL_DEVICES" => 5, "BLOCK_DEVICES" => 1, "DIO_DEVICES" => 2),
+);
+
+/* default values of the plan if the cpu is not known */
+$plan = array(
+   "SERIAL_DEVICES" => 8,
+   "SERIAL_BUFFER_SIZE" => 256,
+   "BLOCK_DEVICES" => 2,
+   "DIO_DEVICES" => 4,
+   "PATH_SIZE" => 32,
+   "HEAP_SIZE" => 20000,
+);
+
+$target = "none";
+if (isset($this->definitions["CPU"]) && ($this->definitions["CPU"] != "none"))
+{
+   $target = $this->definitions["CPU"];
+}
+else if (isset($this->definitions["ARCH"]))
+{
+   $target = $this->definitions["ARCH"];
+}
+
+if (isset($plans[$target]))
+{
+   $plan = array_merge($plan, $plans[$target]);
+}
+else
+{
+   $this->log->warning("No memory plan for $target, using the default device counts");
+}
+
+/* the values of the optional CIAAK object of the oil file take precedence */
+$ciaak = $this->config->getList("/OSEK", "CIAAK");
+if (count($ciaak) > 1)
+{
+   $this->log->warning("More than one CIAAK object defined, only " . $ciaak[0] . " is used");
+}
+if (count($ciaak) > 0)
+{
+   foreach (array_keys($plan) as $attr)
+   {
+      $value = $this->config->getValue("/OSEK/" . $ciaak[0], $attr);
+      if ($value !== false)
+      {
+         $plan[$attr] = (int)$value;
+      }
+   }
+}
+
+$bufsize = $plan["SERIAL_BUFFER_SIZE"];
+if (($bufsize < 8) || (($bufsize & ($bufsize - 1)) != 0))
+{
+   $this->log->error("SERIAL_BUFFER_SIZE of CIAAK shall be a power of 2 and at least 8, $bufsize given");
+}
+
+/* size classes of ciaak_malloc and pools dedicated to a module */
+require_once(dirname(dirname(__FILE__)) . "/ginc/ciaak_Plan.php");
+list($slabs, $pools) = ciaak_poolPlan($this->config, $this->log);
+
+/* words of the status of a pool, see CIAALIBS_POOLBUF_STATUS_WORDS */
+$statusWords = function($count)
+{
+   $words = (int)(($count + 31) / 32);
+   return $words + (int)(($words + 31) / 32);
+};
+
+/* ram used by each module in bytes */
+$usage = array();
+foreach ($slabs as $size => $count)
+{
+   $usage[] = array("ciaak", "slab $size x $count",
+      $size * $count + 4 * $statusWords($count));
+}
+foreach ($pools as $pool)
+{
+   $usage[] = array($pool["module"], "pool " . $pool["name"] . " " . $pool["size"] . " x " . $pool["count"],
+      $pool["size"] * $pool["count"] + 4 * $statusWords($pool["count"]));
+}
+$usage[] = array("posix", "heap", $plan["HEAP_SIZE"]);
+$usage[] = array("posix", "serial buffers", $plan["SERIAL_DEVICES"] * 2 * $bufsize);
+$usage[] = array("posix", "device paths",
+   ($plan["SERIAL_DEVICES"] + $plan["BLOCK_DEVICES"] + $plan["DIO_DEVICES"]) * $plan["PATH_SIZE"]);
+$stacks = 0;
+$tasks = $this->config->getList("/OSEK", "TASK");
+$usage[] = array("posix", "errno", (count($tasks) + 1) * 2);
+foreach ($tasks as $task)
+{
+   $stack = (int)$this->config->getValue("/OSEK/" . $task, "STACK");
+   $stacks += $stack;
+   $usage[] = array("rtos", "stack " . $task, $stack);
+}
+
+$total = 0;
+$this->log->info("static memory plan for $target:");
+foreach ($usage as $entry)
+{
+   $total += $entry[2];
+   $this->log->info(sprintf("   %-8s %-24s %8d bytes", $entry[0], $entry[1], $entry[2]));
+}
+$this->log->info(sprintf("   %-8s %-24s %8d bytes", "total", "", $total));
+?>
+/* RAM usage report of the static memory plan for <?=$target?>, one line per
+ * module and object in bytes, the buffers of the rx and tx of each serial
+ * device and a path per device are included.
+ *
+<?php
+foreach ($usage as $entry)
+{
+   print sprintf(" * RAM: %-8s %-24s %8d\n", $entry[0], $entry[1], $entry[2]);
+}
+print sprintf(" * RAM: %-8s %-24s %8d\n", "total", "", $total);
+?>
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaLibs_PoolBuf.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief count of serial devices which can be registered */
+#define CIAAK_SERIAL_DEVICES        <?=$plan["SERIAL_DEVICES"]?>
+
+
+/** \brief size of the rx buffer of each serial device, power of 2 */
+#define CIAAK_SERIAL_RX_SIZE        <?=$bufsize?>
+
+
+/** \brief size of the tx buffer of each serial device, power of 2 */
+#define CIAAK_SERIAL_TX_SIZE        <?=$bufsize?>
+
+
+/** \brief count of block devices which can be registered */
+#define CIAAK_BLOCK_DEVICES         <?=$plan["BLOCK_DEVICES"]?>
+
+
+/** \brief count of dio devices which can be registered */
+#define CIAAK_DIO_DEVICES           <?=$plan["DIO_DEVICES"]?>
+
+
+/** \brief size of the path of each device including the termination null */
+#define CIAAK_PATH_SIZE             <?=$plan["PATH_SIZE"]?>
+
+
+/** \brief size of the heap of ciaaPOSIX_malloc */
+#define CIAA_HEAP_MEM_SIZE          <?=$plan["HEAP_SIZE"]?>
+
+
+/** \brief total of the task stacks */
+#define CIAAK_STACKS_SIZE           <?=$stacks?>
+
+
+/** \brief count of tasks, the task ids go from 0 to CIAAK_TASKS_COUNT - 1 */
+#define CIAAK_TASKS_COUNT           <?=count($tasks)?>
+
+
+/** \brief count of size classes of ciaak_malloc */
+#define CIAAK_SLAB_CLASSES          <?=count($slabs)?>
+
+
+/** \brief biggest size served by the size classes of ciaak_malloc, bigger
+ **        requests are served by ciaaPOSIX_malloc */
+#define CIAAK_SLAB_MAX_SIZE         <?=(count($slabs) > 0) ? max(array_keys($slabs)) : 0?>
+
+
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+/** \brief size classes of ciaak_malloc */
+extern ciaaLibs_slabType ciaak_slab;
+
+<?php
+foreach ($pools as $pool)
+{
+?>
+/** \brief pool <?=$pool["name"]?> of the module <?=$pool["module"]?>, <?=$pool["count"]?> elements of <?=$pool["size"]?> bytes */
+extern ciaaLibs_poolBufType ciaak_<?=$pool["name"]?>Pool;
+
+<?php
+}
+?>
+/*==================[external functions declaration]=========================*/
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAAK_CFG_H_ */
+
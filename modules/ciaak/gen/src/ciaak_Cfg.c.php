@@ -0,0 +1,146 @@
+/********************************************************
+ * DO NOT CHANGE THIS FILE, IT IS GENERATED AUTOMATICALY*
+ ********************************************************/
+
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief CIAA Kernel Generated Configuration Implementation File
+ **
+ ** Pools of the size classes of ciaak_malloc and the pools dedicated to a
+ ** module, declared with the POOL objects of the oil file.
+ **
+ ** \file ciaak_Cfg.c
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Kernel CIAA Kernel
+ ** @{ */
+
+<?php
+/* same pools as in ciaak_Cfg.h */
+require_once(dirname(dirname(__FILE__)) . "/ginc/ciaak_Plan.php");
+list($slabs, $pools) = ciaak_poolPlan($this->config, $this->log);
+?>
+/*==================[inclusions]=============================================*/
+#include "ciaak_Cfg.h"
+
+/*==================[macros and definitions]=================================*/
+<?php
+foreach ($slabs as $size => $count)
+{
+?>
+/** \brief element of the size class of <?=$size?> bytes */
+typedef uint64_t ciaak_slab<?=$size?>Type[<?=$size / 8?>];
+
+<?php
+}
+foreach ($pools as $pool)
+{
+?>
+/** \brief element of the pool <?=$pool["name"]?> */
+typedef uint64_t ciaak_<?=$pool["name"]?>Type[<?=$pool["size"] / 8?>];
+
+<?php
+}
+?>
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+<?php
+if (count($slabs) > 0)
+{
+   foreach ($slabs as $size => $count)
+   {
+?>
+CIAALIBS_POOLDECLARE(ciaak_slab<?=$size?>, ciaak_slab<?=$size?>Type, <?=$count?>)
+<?php
+   }
+?>
+
+/** \brief size classes of ciaak_malloc sorted by size */
+ciaaLibs_slabClassType ciaak_slabClasses[CIAAK_SLAB_CLASSES] = {
+<?php
+   foreach ($slabs as $size => $count)
+   {
+?>
+   CIAALIBS_SLABCLASS(ciaak_slab<?=$size?>),
+<?php
+   }
+?>
+};
+
+/** \brief size classes of ciaak_malloc */
+ciaaLibs_slabType ciaak_slab = {
+   CIAAK_SLAB_CLASSES,
+   ciaak_slabClasses
+};
+<?php
+}
+else
+{
+?>
+/** \brief without size classes ciaak_malloc is served by ciaaPOSIX_malloc */
+ciaaLibs_slabType ciaak_slab = {
+   0,
+   NULL
+};
+<?php
+}
+?>
+
+<?php
+foreach ($pools as $pool)
+{
+?>
+CIAALIBS_POOLDECLARE(ciaak_<?=$pool["name"]?>Pool, ciaak_<?=$pool["name"]?>Type, <?=$pool["count"]?>)
+<?php
+}
+?>
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+
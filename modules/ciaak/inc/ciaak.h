@@ -47,6 +47,7 @@
 
 /*==================[inclusions]=============================================*/
 #include "ciaak_main.h"
+#include "ciaak_trace.h"
 
 /*==================[cplusplus]=*============================================*/
 #ifdef __cplusplus
@@ -65,9 +65,25 @@ typedef unsigned char kciaa_semaphore;
 /** \brief Initialize the CIAA Firmware */
 void ciaak_start(void);
 
-/** \brief Kernel malloc */
+/** \brief Kernel malloc
+ **
+ ** Requests up to CIAAK_SLAB_MAX_SIZE bytes are served by the size classes
+ ** of ciaak_slab, bigger ones and the ones which do not find a free element
+ ** by ciaaPOSIX_malloc.
+ **/
 void *ciaak_malloc(size_t size);
 
+/** \brief Kernel free of the memory returned by ciaak_malloc */
+void ciaak_free(void *ptr);
+
+/** \brief Print the usage and the high water mark of each size class of
+ **        ciaak_malloc
+ **
+ ** If CIAA_CFG_MEMSTATS is defined also the heap statistics and the high
+ ** water mark of the painted stacks are printed.
+ **/
+void ciaak_memReport(void);
+
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
 }
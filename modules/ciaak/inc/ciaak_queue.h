@@ -0,0 +1,154 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _CIAAK_QUEUE_H_
+#define _CIAAK_QUEUE_H_
+/** \brief CIAA Kernel blocking queues
+ **
+ ** Blocking wrappers of the multi producer multi consumer queues of
+ ** ciaaLibs_Queue.h. A task waiting for elements or for free space sets
+ ** its bit in the waiters of the queue and waits for an OSEK event which
+ ** is set by the next put or get.
+ **
+ ** The event shall be declared in the OIL file for every extended task
+ ** which waits on the queue and shall not be used for anything else than
+ ** ciaak queues. Only the tasks with an id lower than 32 can wait, the
+ ** waiting of any other task fails an assertion.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Kernel CIAA Kernel
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaLibs_Queue.h"
+#include "os.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief initializer of a blocking queue
+ **
+ ** ciaak_queueType rxQueue = CIAAK_QUEUE(rxElements, RxEvent);
+ **
+ ** \param[in] queue queue declared with CIAALIBS_QUEUEDECLARE
+ ** \param[in] event event set to wake up the waiting tasks
+ **/
+#define CIAAK_QUEUE(queue, event)      { &(queue), (event), 0, 0 }
+
+/*==================[typedef]================================================*/
+/** \brief blocking queue type */
+typedef struct {
+   ciaaLibs_queueType * queue;      /** <= queue of the elements */
+   EventMaskType event;             /** <= event of the waiting tasks */
+   uint32_t volatile getWaiters;    /** <= tasks waiting for elements, a bit
+                                          per task id */
+   uint32_t volatile putWaiters;    /** <= tasks waiting for free space, a
+                                          bit per task id */
+} ciaak_queueType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief put elements to a blocking queue without waiting
+ **
+ ** Wakes up the tasks waiting for elements.
+ **
+ ** \param[inout] bqueue pointer to the blocking queue
+ ** \param[in] elements pointer to count elements
+ ** \param[in] count count of elements to be put
+ ** \return count of elements put, 0 if the queue is full
+ **
+ ** \remarks this function can be called from tasks and category 2 ISRs.
+ **/
+extern uint32_t ciaak_queuePut(ciaak_queueType * bqueue,
+      void const * elements, uint32_t count);
+
+/** \brief get elements from a blocking queue without waiting
+ **
+ ** Wakes up the tasks waiting for free space.
+ **
+ ** \param[inout] bqueue pointer to the blocking queue
+ ** \param[out] elements pointer to store up to count elements
+ ** \param[in] count maximal count of elements to be got
+ ** \return count of elements got, 0 if the queue is empty
+ **
+ ** \remarks this function can be called from tasks and category 2 ISRs.
+ **/
+extern uint32_t ciaak_queueGet(ciaak_queueType * bqueue,
+      void * elements, uint32_t count);
+
+/** \brief put elements to a blocking queue
+ **
+ ** Waits until all the elements have been put.
+ **
+ ** \param[inout] bqueue pointer to the blocking queue
+ ** \param[in] elements pointer to count elements
+ ** \param[in] count count of elements to be put
+ ** \return count of elements put
+ **
+ ** \remarks this function can only be called from extended tasks.
+ **/
+extern uint32_t ciaak_queuePutWait(ciaak_queueType * bqueue,
+      void const * elements, uint32_t count);
+
+/** \brief get elements from a blocking queue
+ **
+ ** Waits until at least one element has been got.
+ **
+ ** \param[inout] bqueue pointer to the blocking queue
+ ** \param[out] elements pointer to store up to count elements
+ ** \param[in] count maximal count of elements to be got, at least 1
+ ** \return count of elements got
+ **
+ ** \remarks this function can only be called from extended tasks.
+ **/
+extern uint32_t ciaak_queueGetWait(ciaak_queueType * bqueue,
+      void * elements, uint32_t count);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAAK_QUEUE_H_ */
@@ -0,0 +1,308 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _CIAAK_TRACE_H_
+#define _CIAAK_TRACE_H_
+/** \brief CIAA Kernel performance counters and trace
+ **
+ ** Counts the cpu time of each task and interrupt and the bytes transferred
+ ** by each device, and records every event with a timestamp in a circular
+ ** buffer. The buffer is written to a device with ciaak_traceDrain and
+ ** converted to the Chrome trace event format (chrome://tracing or
+ ** https://ui.perfetto.dev) by the host tool
+ ** modules/tools/scripts/ciaaTrace.pl.
+ **
+ ** The instrumentation is compiled in with CIAA_CFG_TRACE only, in other
+ ** case the hook macros are empty. To trace the tasks the application shall
+ ** call ciaak_traceTaskStart and ciaak_traceTaskEnd from the PreTaskHook
+ ** and PostTaskHook. The serial and block devices and the lpc4337 drivers
+ ** interrupts are already instrumented.
+ **
+ ** The timestamps are the DWT cycle counter on Cortex-M4 and the monotonic
+ ** clock in nanoseconds on x86. The other archs have no free running
+ ** counter, the timestamp is the sequence number of the record.
+ **
+ ** Record format (little or big endian as the target, 32 bits words):
+ **
+ **    | 31 .. 24 | 23 .. 20 | 19 .. 16 | 15 .. 0 |
+ **    | 0xCE     | type     | core     | id      |  timestamp  |  value
+ **
+ ** Each core runs its own image, so each core has its own buffer which
+ ** shall be drained to its own file.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Kernel CIAA Kernel
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stddef.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief size in bytes of the trace buffer, shall be a power of 2 */
+#ifndef CIAAK_TRACE_SIZE
+#define CIAAK_TRACE_SIZE            2048
+#endif
+
+/** \brief count of counted tasks, tasks with a higher id are only recorded */
+#ifndef CIAAK_TRACE_TASKS
+#define CIAAK_TRACE_TASKS           32
+#endif
+
+/** \brief count of counted interrupts, higher ids are only recorded */
+#ifndef CIAAK_TRACE_ISRS
+#define CIAAK_TRACE_ISRS            64
+#endif
+
+/** \brief count of counted devices */
+#ifndef CIAAK_TRACE_DEVICES
+#define CIAAK_TRACE_DEVICES         20
+#endif
+
+/** \brief id of the core in the records */
+#ifndef CIAAK_TRACE_CORE
+#if (cortexM0 == ARCH)
+#define CIAAK_TRACE_CORE            1
+#else
+#define CIAAK_TRACE_CORE            0
+#endif
+#endif
+
+/** \brief frequency of the timestamps in Hz, 0 if they are a sequence */
+#ifndef CIAAK_TRACE_FREQUENCY
+#if (ARCH == x86)
+#define CIAAK_TRACE_FREQUENCY       1000000000UL
+#elif (ARCH == cortexM4)
+#define CIAAK_TRACE_FREQUENCY       204000000UL
+#else
+#define CIAAK_TRACE_FREQUENCY       0UL
+#endif
+#endif
+
+/** \brief marker of the first word of a record */
+#define CIAAK_TRACE_MARKER          0xCE000000UL
+
+/** \brief size in bytes of a record */
+#define CIAAK_TRACE_RECORD_SIZE     12
+
+/** \brief record types */
+#define CIAAK_TRACE_CLOCK           0U    /** <= value is the frequency */
+#define CIAAK_TRACE_TASK_START      1U    /** <= id is the task */
+#define CIAAK_TRACE_TASK_END        2U    /** <= id is the task */
+#define CIAAK_TRACE_ISR_ENTER       3U    /** <= id is the interrupt */
+#define CIAAK_TRACE_ISR_EXIT        4U    /** <= id is the interrupt */
+#define CIAAK_TRACE_DEVICE_READ     5U    /** <= id is the device, value the
+                                                bytes */
+#define CIAAK_TRACE_DEVICE_WRITE    6U    /** <= id is the device, value the
+                                                bytes */
+#define CIAAK_TRACE_DEVICE_NAME     7U    /** <= id is the device, value the
+                                                address of its path */
+#define CIAAK_TRACE_DROPPED         8U    /** <= value is the count of
+                                                dropped records */
+
+/** \brief record header of type and id */
+#define ciaak_traceHeader(type, id)                                     \
+   ( CIAAK_TRACE_MARKER | ((uint32_t)(type) << 20) |                    \
+     ((uint32_t)CIAAK_TRACE_CORE << 16) | ((uint32_t)(id) & 0xFFFFUL) )
+
+#ifdef CIAA_CFG_TRACE
+/** \brief a task gets the cpu, shall be called from PreTaskHook
+ **
+ ** \param[in] task id of the task
+ **/
+#define ciaak_traceTaskStart(task)                                      \
+   ciaak_tracePut(CIAAK_TRACE_TASK_START, (task), 0)
+
+/** \brief a task leaves the cpu, shall be called from PostTaskHook
+ **
+ ** \param[in] task id of the task
+ **/
+#define ciaak_traceTaskEnd(task)                                        \
+   ciaak_tracePut(CIAAK_TRACE_TASK_END, (task), 0)
+
+/** \brief an interrupt handler starts
+ **
+ ** \param[in] isr id of the interrupt, usually its IRQn
+ **/
+#define ciaak_traceIsrEnter(isr)                                        \
+   ciaak_tracePut(CIAAK_TRACE_ISR_ENTER, (isr), 0)
+
+/** \brief an interrupt handler ends
+ **
+ ** \param[in] isr id of the interrupt, usually its IRQn
+ **/
+#define ciaak_traceIsrExit(isr)                                         \
+   ciaak_tracePut(CIAAK_TRACE_ISR_EXIT, (isr), 0)
+
+/** \brief bytes read from a device
+ **
+ ** \param[in] path path of the device, identifies the device
+ ** \param[in] nbyte count of bytes, negative values are not counted
+ **/
+#define ciaak_traceDeviceRead(path, nbyte)                              \
+   ciaak_traceDevice(CIAAK_TRACE_DEVICE_READ, (path), (nbyte))
+
+/** \brief bytes written to a device, see ciaak_traceDeviceRead */
+#define ciaak_traceDeviceWrite(path, nbyte)                             \
+   ciaak_traceDevice(CIAAK_TRACE_DEVICE_WRITE, (path), (nbyte))
+#else
+#define ciaak_traceTaskStart(task)              do { } while (0)
+#define ciaak_traceTaskEnd(task)                do { } while (0)
+#define ciaak_traceIsrEnter(isr)                do { } while (0)
+#define ciaak_traceIsrExit(isr)                 do { } while (0)
+#define ciaak_traceDeviceRead(path, nbyte)      do { } while (0)
+#define ciaak_traceDeviceWrite(path, nbyte)     do { } while (0)
+#endif /* #ifdef CIAA_CFG_TRACE */
+
+/*==================[typedef]================================================*/
+/** \brief cpu time counters of a task or an interrupt
+ **
+ ** The time of a task includes the time of the interrupts which preempt
+ ** it, the time of an interrupt the time of the nested ones.
+ **/
+typedef struct {
+   uint32_t count;               /** <= dispatches or interrupts */
+   uint32_t maxTime;             /** <= maximal time of one dispatch */
+   uint64_t time;                /** <= total time */
+   uint32_t start;               /** <= timestamp of the last start */
+} ciaak_traceTimeType;
+
+/** \brief counters of a device */
+typedef struct {
+   char const * path;            /** <= path of the device, NULL if unused */
+   uint32_t reads;               /** <= count of reads */
+   uint32_t writes;              /** <= count of writes */
+   uint64_t bytesRead;           /** <= total bytes read */
+   uint64_t bytesWritten;        /** <= total bytes written */
+} ciaak_traceDeviceType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize the counters and the trace buffer
+ **
+ ** Enables the cycle counter if needed and records the frequency of the
+ ** timestamps. Pending records are discarded.
+ **/
+extern void ciaak_traceInit(void);
+
+/** \brief get the timestamp
+ **
+ ** \return the free running counter, see CIAAK_TRACE_FREQUENCY
+ **/
+extern uint32_t ciaak_traceGetTime(void);
+
+/** \brief count and record an event
+ **
+ ** Do not call it directly, use the hook macros. May be called from tasks
+ ** and ISRs, the record is written with the OS interrupts disabled. If the
+ ** buffer is full the record is dropped and counted, the counters are
+ ** always updated.
+ **
+ ** \param[in] type record type, CIAAK_TRACE_TASK_START .. ISR_EXIT
+ ** \param[in] id task or interrupt id
+ ** \param[in] value value of the record
+ **/
+extern void ciaak_tracePut(uint32_t type, uint32_t id, uint32_t value);
+
+/** \brief count and record a device transfer
+ **
+ ** Do not call it directly, use ciaak_traceDeviceRead and
+ ** ciaak_traceDeviceWrite. The first transfer of a device also records
+ ** its name.
+ **
+ ** \param[in] type CIAAK_TRACE_DEVICE_READ or CIAAK_TRACE_DEVICE_WRITE
+ ** \param[in] path path of the device
+ ** \param[in] nbyte count of transferred bytes
+ **/
+extern void ciaak_traceDevice(uint32_t type, char const * path, ssize_t nbyte);
+
+/** \brief write the stored records to a device
+ **
+ ** Writes the buffer content to fildes with ciaaPOSIX_write, it shall be
+ ** called from a single task, usually the lowest priority one. Returns
+ ** when the buffer is empty or the device accepts less bytes than
+ ** requested.
+ **
+ ** \param[in] fildes file descriptor of the device
+ ** \return count of written bytes, -1 if the device reports an error
+ **         before any byte is written
+ **/
+extern ssize_t ciaak_traceDrain(int32_t fildes);
+
+/** \brief get the count of dropped records since the last init */
+extern uint32_t ciaak_traceGetDropped(void);
+
+/** \brief get the counters of a task
+ **
+ ** \param[in] task id of the task
+ ** \return pointer to the counters or NULL if the task is not counted
+ **/
+extern ciaak_traceTimeType const * ciaak_traceGetTask(uint32_t task);
+
+/** \brief get the counters of an interrupt
+ **
+ ** \param[in] isr id of the interrupt
+ ** \return pointer to the counters or NULL if the interrupt is not counted
+ **/
+extern ciaak_traceTimeType const * ciaak_traceGetIsr(uint32_t isr);
+
+/** \brief get the counters of a device
+ **
+ ** \param[in] index index of the device, 0 to CIAAK_TRACE_DEVICES - 1, in
+ **            order of their first transfer
+ ** \return pointer to the counters or NULL if no device has this index
+ **/
+extern ciaak_traceDeviceType const * ciaak_traceGetDevice(uint32_t index);
+
+/** \brief print the counters of the tasks, interrupts and devices */
+extern void ciaak_traceReport(void);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAAK_TRACE_H_ */
@@ -54,8 +54,13 @@
 #ifdef CIAA_CFG_NET_IP
 #include "ciaaDriverEth.h"
 #endif
+#ifdef CIAA_CFG_MEMSTATS
+#include "ciaaMemory.h"
+#endif
 
 #include "ciaaPOSIX_stdlib.h"
+#include "ciaaLibs_PoolBuf.h"
+#include "ciaak_Cfg.h"
 
 /*==================[macros and definitions]=================================*/
 
@@ -77,6 +82,11 @@ void ciaak_start(void)
     * ciaaPOSIX_malloc or ciaak_malloc */
    ciaaPOSIX_stdlib_init();
 
+#ifdef CIAA_CFG_TRACE
+   /* before the devices and drivers, their events are recorded */
+   ciaak_traceInit();
+#endif
+
    /* init device manager */
    ciaaDevices_init();
 
@@ -92,17 +102,35 @@ void ciaak_start(void)
 #endif
    ciaaDriverDio_init();
    ciaaDriverAio_init();
+
+#ifdef CIAA_CFG_MEMSTATS
+   /* paint the stacks and add /dev/mem */
+   ciaaMemory_init();
+#endif
 }
 
 void *ciaak_malloc(size_t size)
 {
-   /* try to alloc memory */
-   void* ret = ciaaPOSIX_malloc(size);
+   void* ret = NULL;
+
+   /* small requests are served by the size classes and by the heap if all
+    * classes which fit the size are full */
+   if (CIAAK_SLAB_MAX_SIZE >= size)
+   {
+      ret = ciaaLibs_slabAlloc(&ciaak_slab, size);
+   }
+   if (NULL == ret)
+   {
+      ret = ciaaPOSIX_malloc(size);
+   }
 
    /* kernel memory shall not failed :( */
    if (NULL == ret)
    {
       ciaaPOSIX_printf("Kernel out of memory :( ...\n");
+#ifdef CIAA_CFG_MEMSTATS
+      ciaak_memReport();
+#endif
       while(1)
       {
          /* TODO perform an kernel panic or like */
@@ -112,6 +140,48 @@ void *ciaak_malloc(size_t size)
    return ret;
 }
 
+void ciaak_free(void *ptr)
+{
+   /* memory not allocated from the size classes comes from the heap */
+   if (0 == ciaaLibs_slabFree(&ciaak_slab, ptr))
+   {
+      ciaaPOSIX_free(ptr);
+   }
+}
+
+void ciaak_memReport(void)
+{
+   ciaaLibs_slabStatsType stats;
+   size_t i;
+#ifdef CIAA_CFG_MEMSTATS
+   ciaaMemory_statsType mem;
+#endif
+
+   for(i = 0; i < CIAAK_SLAB_CLASSES; i++)
+   {
+      ciaaLibs_slabGetStats(&ciaak_slab, i, &stats);
+      ciaaPOSIX_printf("slab %4d: %3d of %3d used, high water %3d, full %d\n",
+            (int)stats.elementSize, (int)stats.used, (int)stats.count,
+            (int)stats.highWater, (int)stats.full);
+   }
+
+#ifdef CIAA_CFG_MEMSTATS
+   ciaaMemory_getStats(&mem);
+   ciaaPOSIX_printf("heap: %d of %d used, peak %d, largest free %d, fragmentation %d/1000, failed %d\n",
+         (int)mem.heap.used, (int)mem.heap.size, (int)mem.heap.peak,
+         (int)mem.heap.largestFree, (int)mem.heap.fragmentation,
+         (int)mem.heap.failed);
+   for(i = 0; i < mem.tasks; i++)
+   {
+      if (0 != mem.stack[i].painted)
+      {
+         ciaaPOSIX_printf("task %2d: stack high water %d of %d\n", (int)i,
+               (int)mem.stack[i].highWater, (int)mem.stack[i].size);
+      }
+   }
+#endif
+}
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /*==================[end of file]============================================*/
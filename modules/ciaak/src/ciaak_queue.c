@@ -0,0 +1,201 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief CIAA Kernel blocking queues
+ **
+ ** A waiting task clears its event, sets its bit in the waiters and tries
+ ** again before waiting, so an element put or got between the first try
+ ** and the wait is never missed: either the second try sees it or the
+ ** other side sees the bit and sets the event. The waiters are read with a
+ ** read-modify-write, which orders the read after the update of the queue.
+ **
+ ** All the waiters are woken up, the ones which find the queue empty or
+ ** full again wait again.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Kernel CIAA Kernel
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaak_queue.h"
+#include "ciaaLibs_Atomic.h"
+#include "ciaaLibs_Maths.h"
+#include "ciaaPOSIX_assert.h"
+#include "os.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief count of task ids which fit in the waiters */
+#define CIAAK_QUEUE_MAX_TASKS    32
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief set the event of the waiting tasks
+ **
+ ** \param[inout] waiters waiting tasks, a bit per task id
+ ** \param[in] event event to be set
+ **/
+static void ciaak_queueWake(uint32_t volatile * waiters, EventMaskType event)
+{
+   uint32_t pending = ciaaLibs_atomicOr(waiters, 0);
+
+   while (0 != pending)
+   {
+      (void)SetEvent((TaskType)ciaaLibs_ctz(pending), event);
+      pending &= pending - 1;
+   }
+} /* end ciaak_queueWake */
+
+/** \brief bit of the running task in the waiters */
+static uint32_t ciaak_queueWaiter(void)
+{
+   TaskType task = INVALID_TASK;
+
+   (void)GetTaskID(&task);
+
+   /* the waiters have a bit per task id */
+   ciaaPOSIX_assert(CIAAK_QUEUE_MAX_TASKS > task);
+
+   return (uint32_t)1 << task;
+} /* end ciaak_queueWaiter */
+
+/*==================[external functions definition]==========================*/
+extern uint32_t ciaak_queuePut(ciaak_queueType * bqueue,
+      void const * elements, uint32_t count)
+{
+   uint32_t ret = ciaaLibs_queuePut(bqueue->queue, elements, count);
+
+   if (0 != ret)
+   {
+      ciaak_queueWake(&bqueue->getWaiters, bqueue->event);
+   }
+
+   return ret;
+} /* end ciaak_queuePut */
+
+extern uint32_t ciaak_queueGet(ciaak_queueType * bqueue,
+      void * elements, uint32_t count)
+{
+   uint32_t ret = ciaaLibs_queueGet(bqueue->queue, elements, count);
+
+   if (0 != ret)
+   {
+      ciaak_queueWake(&bqueue->putWaiters, bqueue->event);
+   }
+
+   return ret;
+} /* end ciaak_queueGet */
+
+extern uint32_t ciaak_queuePutWait(ciaak_queueType * bqueue,
+      void const * elements, uint32_t count)
+{
+   uint8_t const * from = (uint8_t const *)elements;
+   size_t elementSize = bqueue->queue->elementSize;
+   uint32_t waiter = 0;
+   uint32_t ret = 0;
+   uint32_t put;
+
+   while (ret < count)
+   {
+      put = ciaak_queuePut(bqueue, &from[ret * elementSize], count - ret);
+
+      if (0 == put)
+      {
+         if (0 == waiter)
+         {
+            waiter = ciaak_queueWaiter();
+         }
+         (void)ClearEvent(bqueue->event);
+         (void)ciaaLibs_atomicOr(&bqueue->putWaiters, waiter);
+
+         /* try again, a get may have been done before setting the bit */
+         put = ciaak_queuePut(bqueue, &from[ret * elementSize], count - ret);
+         if (0 == put)
+         {
+            (void)WaitEvent(bqueue->event);
+         }
+         (void)ciaaLibs_atomicAnd(&bqueue->putWaiters, ~waiter);
+      }
+
+      ret += put;
+   }
+
+   return ret;
+} /* end ciaak_queuePutWait */
+
+extern uint32_t ciaak_queueGetWait(ciaak_queueType * bqueue,
+      void * elements, uint32_t count)
+{
+   uint32_t waiter = 0;
+   uint32_t ret = 0;
+
+   while ( (0 == ret) && (0 != count) )
+   {
+      ret = ciaak_queueGet(bqueue, elements, count);
+
+      if (0 == ret)
+      {
+         if (0 == waiter)
+         {
+            waiter = ciaak_queueWaiter();
+         }
+         (void)ClearEvent(bqueue->event);
+         (void)ciaaLibs_atomicOr(&bqueue->getWaiters, waiter);
+
+         /* try again, a put may have been done before setting the bit */
+         ret = ciaak_queueGet(bqueue, elements, count);
+         if (0 == ret)
+         {
+            (void)WaitEvent(bqueue->event);
+         }
+         (void)ciaaLibs_atomicAnd(&bqueue->getWaiters, ~waiter);
+      }
+   }
+
+   return ret;
+} /* end ciaak_queueGetWait */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
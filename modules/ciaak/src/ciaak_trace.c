@@ -0,0 +1,415 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief CIAA Kernel performance counters and trace
+ **
+ ** The counters and the records are updated with the OS interrupts
+ ** disabled. The drain is the only reader of the records and moves the head
+ ** without any lock, as ciaaLog does. The buffer size is a power of 2 and
+ ** the records are written word by word wrapping at the end of the buffer.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Kernel CIAA Kernel
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaak_trace.h"
+#include "ciaaLibs_CircBuf.h"
+#include "ciaaLibs_Cycles.h"
+#include "ciaaPOSIX_stdio.h"
+#include "os.h"
+#if (ARCH == x86)
+#include <time.h>
+#endif
+
+/*==================[macros and definitions]=================================*/
+/** \brief compiler barrier between the record and the index update */
+#define ciaak_traceBarrier()     __asm__ __volatile__ ("" : : : "memory")
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief trace buffer */
+static uint32_t ciaak_traceBuf[CIAAK_TRACE_SIZE / sizeof(uint32_t)];
+
+/** \brief circular buffer control of ciaak_traceBuf */
+static ciaaLibs_CircBufType ciaak_traceCbuf;
+
+/** \brief count of dropped records not yet recorded */
+static uint32_t ciaak_tracePending;
+
+/** \brief count of dropped records since the last init */
+static uint32_t ciaak_traceDropped;
+
+/** \brief timestamp of the archs without counter */
+static uint32_t ciaak_traceSequence;
+
+/** \brief counters of the tasks */
+static ciaak_traceTimeType ciaak_traceTasks[CIAAK_TRACE_TASKS];
+
+/** \brief counters of the interrupts */
+static ciaak_traceTimeType ciaak_traceIsrs[CIAAK_TRACE_ISRS];
+
+/** \brief counters of the devices */
+static ciaak_traceDeviceType ciaak_traceDevices[CIAAK_TRACE_DEVICES];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief store a record, shall be called with the interrupts disabled
+ **
+ ** \param[in] header record header
+ ** \param[in] time timestamp
+ ** \param[in] value value of the record
+ **/
+static void ciaak_traceRecord(uint32_t header, uint32_t time, uint32_t value)
+{
+   uint32_t * buf = ciaak_traceBuf;
+   size_t mask = ciaak_traceCbuf.size >> 2;
+   size_t nbytes = CIAAK_TRACE_RECORD_SIZE;
+   size_t space = ciaaLibs_circBufSpace(&ciaak_traceCbuf, ciaak_traceCbuf.head);
+   size_t pos = ciaak_traceCbuf.tail >> 2;
+
+   if ( (0 != ciaak_tracePending) &&
+        (space >= (2 * CIAAK_TRACE_RECORD_SIZE)) )
+   {
+      /* report the dropped records before the new one */
+      buf[pos] = ciaak_traceHeader(CIAAK_TRACE_DROPPED, 0);
+      buf[(pos + 1) & mask] = time;
+      buf[(pos + 2) & mask] = ciaak_tracePending;
+      pos = (pos + 3) & mask;
+      nbytes += CIAAK_TRACE_RECORD_SIZE;
+      ciaak_tracePending = 0;
+   }
+
+   if ( (space >= nbytes) && (0 == ciaak_tracePending) )
+   {
+      buf[pos] = header;
+      buf[(pos + 1) & mask] = time;
+      buf[(pos + 2) & mask] = value;
+
+      /* publish the record after it has been written */
+      ciaak_traceBarrier();
+      ciaaLibs_circBufUpdateTail(&ciaak_traceCbuf, nbytes);
+   }
+   else
+   {
+      ciaak_tracePending++;
+      ciaak_traceDropped++;
+   }
+} /* end ciaak_traceRecord */
+
+/** \brief start counting the time of a task or an interrupt */
+static void ciaak_traceStart(ciaak_traceTimeType * counter, uint32_t time)
+{
+   counter->start = time;
+   counter->count++;
+} /* end ciaak_traceStart */
+
+/** \brief stop counting the time of a task or an interrupt */
+static void ciaak_traceStop(ciaak_traceTimeType * counter, uint32_t time)
+{
+   /* modulo 2^32, the counter may wrap */
+   uint32_t elapsed = time - counter->start;
+
+   counter->time += elapsed;
+   if (elapsed > counter->maxTime)
+   {
+      counter->maxTime = elapsed;
+   }
+} /* end ciaak_traceStop */
+
+/*==================[external functions definition]==========================*/
+extern void ciaak_traceInit(void)
+{
+   ciaak_traceTimeType const timeEmpty = { 0, 0, 0, 0 };
+   ciaak_traceDeviceType const deviceEmpty = { NULL, 0, 0, 0, 0 };
+   uint32_t i;
+
+   ciaaLibs_cyclesEnable();
+
+   for(i = 0; i < CIAAK_TRACE_TASKS; i++)
+   {
+      ciaak_traceTasks[i] = timeEmpty;
+   }
+   for(i = 0; i < CIAAK_TRACE_ISRS; i++)
+   {
+      ciaak_traceIsrs[i] = timeEmpty;
+   }
+   for(i = 0; i < CIAAK_TRACE_DEVICES; i++)
+   {
+      ciaak_traceDevices[i] = deviceEmpty;
+   }
+
+   ciaaLibs_circBufInit(&ciaak_traceCbuf, ciaak_traceBuf, sizeof(ciaak_traceBuf));
+   ciaak_tracePending = 0;
+   ciaak_traceDropped = 0;
+   ciaak_traceSequence = 0;
+
+   /* the host tool needs the frequency to convert the timestamps */
+   ciaak_traceRecord(ciaak_traceHeader(CIAAK_TRACE_CLOCK, 0),
+         ciaak_traceGetTime(), CIAAK_TRACE_FREQUENCY);
+} /* end ciaak_traceInit */
+
+extern uint32_t ciaak_traceGetTime(void)
+{
+   uint32_t ret;
+#if (ARCH == x86)
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   ret = (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+#elif (ARCH == cortexM4)
+   ret = ciaaLibs_cyclesGet();
+#else
+   ret = ciaak_traceSequence++;
+#endif
+
+   return ret;
+} /* end ciaak_traceGetTime */
+
+extern void ciaak_tracePut(uint32_t type, uint32_t id, uint32_t value)
+{
+   uint32_t time;
+
+   SuspendOSInterrupts();
+
+   time = ciaak_traceGetTime();
+   switch(type)
+   {
+      case CIAAK_TRACE_TASK_START:
+         if (CIAAK_TRACE_TASKS > id)
+         {
+            ciaak_traceStart(&ciaak_traceTasks[id], time);
+         }
+         break;
+      case CIAAK_TRACE_TASK_END:
+         if (CIAAK_TRACE_TASKS > id)
+         {
+            ciaak_traceStop(&ciaak_traceTasks[id], time);
+         }
+         break;
+      case CIAAK_TRACE_ISR_ENTER:
+         if (CIAAK_TRACE_ISRS > id)
+         {
+            ciaak_traceStart(&ciaak_traceIsrs[id], time);
+         }
+         break;
+      case CIAAK_TRACE_ISR_EXIT:
+         if (CIAAK_TRACE_ISRS > id)
+         {
+            ciaak_traceStop(&ciaak_traceIsrs[id], time);
+         }
+         break;
+      default:
+         break;
+   }
+   ciaak_traceRecord(ciaak_traceHeader(type, id), time, value);
+
+   ResumeOSInterrupts();
+} /* end ciaak_tracePut */
+
+extern void ciaak_traceDevice(uint32_t type, char const * path, ssize_t nbyte)
+{
+   ciaak_traceDeviceType * device;
+   uint32_t time;
+   uint32_t id = 0;
+
+   if (0 <= nbyte)
+   {
+      SuspendOSInterrupts();
+
+      time = ciaak_traceGetTime();
+
+      /* the devices are identified by the address of their path */
+      while ( (CIAAK_TRACE_DEVICES > id) &&
+              (NULL != ciaak_traceDevices[id].path) &&
+              (path != ciaak_traceDevices[id].path) )
+      {
+         id++;
+      }
+
+      if (CIAAK_TRACE_DEVICES > id)
+      {
+         device = &ciaak_traceDevices[id];
+         if (NULL == device->path)
+         {
+            /* first transfer, the host tool gets the name from the image */
+            device->path = path;
+            ciaak_traceRecord(ciaak_traceHeader(CIAAK_TRACE_DEVICE_NAME, id),
+                  time, (uint32_t)(uintptr_t)path);
+         }
+         if (CIAAK_TRACE_DEVICE_READ == type)
+         {
+            device->reads++;
+            device->bytesRead += nbyte;
+         }
+         else
+         {
+            device->writes++;
+            device->bytesWritten += nbyte;
+         }
+         ciaak_traceRecord(ciaak_traceHeader(type, id), time, (uint32_t)nbyte);
+      }
+
+      ResumeOSInterrupts();
+   }
+} /* end ciaak_traceDevice */
+
+extern ssize_t ciaak_traceDrain(int32_t fildes)
+{
+   ssize_t ret = 0;
+   ssize_t written;
+   size_t count;
+   size_t tail = ciaak_traceCbuf.tail;
+
+   /* read the records after the tail which publishes them */
+   ciaak_traceBarrier();
+
+   while (0 < (count = ciaaLibs_circBufRawCount(&ciaak_traceCbuf, tail)))
+   {
+      written = ciaaPOSIX_write(fildes,
+            ciaaLibs_circBufReadPos(&ciaak_traceCbuf), count);
+
+      if (0 >= written)
+      {
+         if ( (0 == ret) && (0 > written) )
+         {
+            ret = -1;
+         }
+         break;
+      }
+
+      ciaak_traceBarrier();
+      ciaaLibs_circBufUpdateHead(&ciaak_traceCbuf, (size_t)written);
+      ret += written;
+
+      if ((size_t)written < count)
+      {
+         /* the device is full, try again on the next call */
+         break;
+      }
+   }
+
+   return ret;
+} /* end ciaak_traceDrain */
+
+extern uint32_t ciaak_traceGetDropped(void)
+{
+   return ciaak_traceDropped;
+} /* end ciaak_traceGetDropped */
+
+extern ciaak_traceTimeType const * ciaak_traceGetTask(uint32_t task)
+{
+   ciaak_traceTimeType const * ret = NULL;
+
+   if (CIAAK_TRACE_TASKS > task)
+   {
+      ret = &ciaak_traceTasks[task];
+   }
+
+   return ret;
+} /* end ciaak_traceGetTask */
+
+extern ciaak_traceTimeType const * ciaak_traceGetIsr(uint32_t isr)
+{
+   ciaak_traceTimeType const * ret = NULL;
+
+   if (CIAAK_TRACE_ISRS > isr)
+   {
+      ret = &ciaak_traceIsrs[isr];
+   }
+
+   return ret;
+} /* end ciaak_traceGetIsr */
+
+extern ciaak_traceDeviceType const * ciaak_traceGetDevice(uint32_t index)
+{
+   ciaak_traceDeviceType const * ret = NULL;
+
+   if ( (CIAAK_TRACE_DEVICES > index) &&
+        (NULL != ciaak_traceDevices[index].path) )
+   {
+      ret = &ciaak_traceDevices[index];
+   }
+
+   return ret;
+} /* end ciaak_traceGetDevice */
+
+extern void ciaak_traceReport(void)
+{
+   uint32_t i;
+
+   ciaaPOSIX_printf("trace: frequency %u Hz, %u records dropped\n",
+         (unsigned int)CIAAK_TRACE_FREQUENCY, (unsigned int)ciaak_traceDropped);
+   for(i = 0; i < CIAAK_TRACE_TASKS; i++)
+   {
+      if (0 != ciaak_traceTasks[i].count)
+      {
+         ciaaPOSIX_printf("task %2u: %u dispatches, time %u, max %u\n",
+               (unsigned int)i, (unsigned int)ciaak_traceTasks[i].count,
+               (unsigned int)ciaak_traceTasks[i].time,
+               (unsigned int)ciaak_traceTasks[i].maxTime);
+      }
+   }
+   for(i = 0; i < CIAAK_TRACE_ISRS; i++)
+   {
+      if (0 != ciaak_traceIsrs[i].count)
+      {
+         ciaaPOSIX_printf("isr  %2u: %u interrupts, time %u, max %u\n",
+               (unsigned int)i, (unsigned int)ciaak_traceIsrs[i].count,
+               (unsigned int)ciaak_traceIsrs[i].time,
+               (unsigned int)ciaak_traceIsrs[i].maxTime);
+      }
+   }
+   for(i = 0; (i < CIAAK_TRACE_DEVICES) && (NULL != ciaak_traceDevices[i].path); i++)
+   {
+      ciaaPOSIX_printf("%s: %u reads %u bytes, %u writes %u bytes\n",
+            ciaak_traceDevices[i].path,
+            (unsigned int)ciaak_traceDevices[i].reads,
+            (unsigned int)ciaak_traceDevices[i].bytesRead,
+            (unsigned int)ciaak_traceDevices[i].writes,
+            (unsigned int)ciaak_traceDevices[i].bytesWritten);
+   }
+} /* end ciaak_traceReport */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,270 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the test of the kernel blocking queues
+ **
+ ** \file test_ciaak_queue.c
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Kernel CIAA Kernel
+ ** @{ */
+/** \addtogroup ModuleTests Module Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaak_queue.h"
+#include "mock_ciaaLibs_Queue.h"
+#include "mock_ciaaPOSIX_assert.h"
+#include "os.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief event of the test queue */
+#define QUEUE_EVENT           0x10
+
+/** \brief id of the running task */
+#define RUNNING_TASK          3
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief queue of the test, its functions are replaced by the stubs */
+static ciaaLibs_queueType queue;
+
+/** \brief blocking queue of the test */
+static ciaak_queueType bqueue = CIAAK_QUEUE(queue, QUEUE_EVENT);
+
+/** \brief elements which can be got from the queue */
+static uint32_t available;
+
+/** \brief elements which can be put to the queue */
+static uint32_t space;
+
+/** \brief elements made available or freed by the next WaitEvent */
+static uint32_t onWait;
+
+/** \brief last elements pointer passed to the queue */
+static void const * lastElements;
+
+/** \brief tasks woken up by SetEvent, a bit per task id */
+static uint32_t woken;
+
+/** \brief count of WaitEvent and ClearEvent calls */
+static uint32_t waits;
+static uint32_t clears;
+
+/** \brief waiters seen by the last WaitEvent */
+static uint32_t waitGetWaiters;
+static uint32_t waitPutWaiters;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint32_t queuePut(ciaaLibs_queueType * q, void const * elements,
+      uint32_t count, int calls)
+{
+   uint32_t ret = (count < space) ? count : space;
+   (void)calls;
+
+   TEST_ASSERT_EQUAL_PTR(&queue, q);
+   lastElements = elements;
+   space -= ret;
+
+   return ret;
+}
+
+static uint32_t queueGet(ciaaLibs_queueType * q, void * elements,
+      uint32_t count, int calls)
+{
+   uint32_t ret = (count < available) ? count : available;
+   (void)calls;
+
+   TEST_ASSERT_EQUAL_PTR(&queue, q);
+   lastElements = elements;
+   available -= ret;
+
+   return ret;
+}
+
+/*==================[external functions definition]==========================*/
+StatusType GetTaskID(TaskType * task)
+{
+   *task = RUNNING_TASK;
+
+   return 0;
+}
+
+StatusType SetEvent(TaskType task, EventMaskType mask)
+{
+   TEST_ASSERT_EQUAL_HEX(QUEUE_EVENT, mask);
+   woken |= (uint32_t)1 << task;
+
+   return 0;
+}
+
+StatusType ClearEvent(EventMaskType mask)
+{
+   TEST_ASSERT_EQUAL_HEX(QUEUE_EVENT, mask);
+   clears++;
+
+   return 0;
+}
+
+StatusType WaitEvent(EventMaskType mask)
+{
+   TEST_ASSERT_EQUAL_HEX(QUEUE_EVENT, mask);
+   waits++;
+   waitGetWaiters = bqueue.getWaiters;
+   waitPutWaiters = bqueue.putWaiters;
+
+   /* another task puts or gets while this one waits */
+   available += onWait;
+   space += onWait;
+   onWait = 0;
+
+   return 0;
+}
+
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   queue.elementSize = sizeof(uint32_t);
+   bqueue.getWaiters = 0;
+   bqueue.putWaiters = 0;
+   available = 0;
+   space = 0;
+   onWait = 0;
+   lastElements = NULL;
+   woken = 0;
+   waits = 0;
+   clears = 0;
+   waitGetWaiters = 0;
+   waitPutWaiters = 0;
+
+   ciaaLibs_queuePut_StubWithCallback(queuePut);
+   ciaaLibs_queueGet_StubWithCallback(queueGet);
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+   /* no task is left as waiter */
+   TEST_ASSERT_EQUAL_HEX32(0, bqueue.getWaiters & (1 << RUNNING_TASK));
+   TEST_ASSERT_EQUAL_HEX32(0, bqueue.putWaiters & (1 << RUNNING_TASK));
+}
+
+/** \brief put and get wake up the waiting tasks of the other side */
+void test_ciaak_queue_wake(void) {
+   uint32_t elements[4];
+
+   bqueue.getWaiters = (1 << 1) | (1 << 5);
+   bqueue.putWaiters = (1 << 2);
+
+   /* nothing put, nobody is woken up */
+   TEST_ASSERT_EQUAL_UINT32(0, ciaak_queuePut(&bqueue, elements, 4));
+   TEST_ASSERT_EQUAL_HEX32(0, woken);
+
+   space = 2;
+   TEST_ASSERT_EQUAL_UINT32(2, ciaak_queuePut(&bqueue, elements, 4));
+   TEST_ASSERT_EQUAL_HEX32((1 << 1) | (1 << 5), woken);
+
+   /* nothing got, nobody is woken up */
+   woken = 0;
+   TEST_ASSERT_EQUAL_UINT32(0, ciaak_queueGet(&bqueue, elements, 4));
+   TEST_ASSERT_EQUAL_HEX32(0, woken);
+
+   available = 4;
+   TEST_ASSERT_EQUAL_UINT32(4, ciaak_queueGet(&bqueue, elements, 4));
+   TEST_ASSERT_EQUAL_HEX32(1 << 2, woken);
+
+   bqueue.getWaiters = 0;
+   bqueue.putWaiters = 0;
+}
+
+/** \brief get with wait returns without waiting if there are elements */
+void test_ciaak_queue_getWaitAvailable(void) {
+   uint32_t elements[4];
+
+   available = 3;
+   TEST_ASSERT_EQUAL_UINT32(3, ciaak_queueGetWait(&bqueue, elements, 4));
+   TEST_ASSERT_EQUAL_UINT32(0, waits);
+   TEST_ASSERT_EQUAL_UINT32(0, clears);
+}
+
+/** \brief get with wait waits on the event until an element is put */
+void test_ciaak_queue_getWait(void) {
+   uint32_t elements[4];
+
+   onWait = 2;
+   ciaaPOSIX_assert_Expect(1);
+   TEST_ASSERT_EQUAL_UINT32(2, ciaak_queueGetWait(&bqueue, elements, 4));
+   TEST_ASSERT_EQUAL_UINT32(1, waits);
+   TEST_ASSERT_EQUAL_UINT32(1, clears);
+   TEST_ASSERT_EQUAL_HEX32(1 << RUNNING_TASK, waitGetWaiters);
+   TEST_ASSERT_EQUAL_HEX32(0, waitPutWaiters);
+   TEST_ASSERT_EQUAL_PTR(elements, lastElements);
+}
+
+/** \brief put with wait waits until all the elements are put */
+void test_ciaak_queue_putWait(void) {
+   uint32_t elements[4];
+
+   space = 1;
+   onWait = 3;
+   ciaaPOSIX_assert_Expect(1);
+   TEST_ASSERT_EQUAL_UINT32(4, ciaak_queuePutWait(&bqueue, elements, 4));
+   TEST_ASSERT_EQUAL_UINT32(1, waits);
+   TEST_ASSERT_EQUAL_UINT32(1, clears);
+   TEST_ASSERT_EQUAL_HEX32(0, waitGetWaiters);
+   TEST_ASSERT_EQUAL_HEX32(1 << RUNNING_TASK, waitPutWaiters);
+
+   /* the rest of the elements is put after the first one */
+   TEST_ASSERT_EQUAL_PTR(&elements[1], lastElements);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
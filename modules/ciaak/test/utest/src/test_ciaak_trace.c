@@ -0,0 +1,335 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the test of the kernel trace
+ **
+ ** \file test_ciaak_trace.c
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Kernel CIAA Kernel
+ ** @{ */
+/** \addtogroup ModuleTests Module Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaak_trace.h"
+#include "mock_ciaaLibs_CircBuf.h"
+#include "mock_ciaaPOSIX_stdio.h"
+#include "os.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief count of calls of the benchmark */
+#define BENCH_CALLS           1000000
+
+/** \brief file descriptor used for the drain */
+#define TRACE_FILDES          3
+
+/** \brief words of a record */
+#define RECORD_WORDS          (CIAAK_TRACE_RECORD_SIZE / sizeof(uint32_t))
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief data written to the device */
+static uint32_t written[4096];
+
+/** \brief count of bytes written to the device */
+static size_t writtenCount;
+
+/** \brief count of nested SuspendOSInterrupts calls */
+static int32_t suspended;
+
+/** \brief paths of the test devices */
+static char const uartPath[] = "/dev/serial/uart/1";
+static char const flashPath[] = "/dev/block/fd/0";
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int32_t circBufInit(ciaaLibs_CircBufType * cbuf, void * buf,
+      size_t nbytes, int calls)
+{
+   (void)calls;
+
+   cbuf->head = 0;
+   cbuf->tail = 0;
+   cbuf->size = nbytes - 1;
+   cbuf->buf = buf;
+
+   return 1;
+}
+
+static ssize_t posixWrite(int32_t fildes, void const * buf, size_t nbyte,
+      int calls)
+{
+   (void)calls;
+   TEST_ASSERT_EQUAL_INT(TRACE_FILDES, fildes);
+
+   if (writtenCount + nbyte > sizeof(written))
+   {
+      /* discard, only the benchmark writes this much */
+      writtenCount = 0;
+   }
+   memcpy((uint8_t *)written + writtenCount, buf, nbyte);
+   writtenCount += nbyte;
+
+   return nbyte;
+}
+
+/** \brief check the record at word pos of the written data
+ **
+ ** \param[in] pos index of the first word of the record
+ ** \param[in] type expected type
+ ** \param[in] id expected id
+ ** \param[in] value expected value
+ ** \return index of the next record
+ **/
+static size_t checkRecord(size_t pos, uint32_t type, uint32_t id,
+      uint32_t value)
+{
+   TEST_ASSERT_EQUAL_HEX32(ciaak_traceHeader(type, id), written[pos]);
+   TEST_ASSERT_EQUAL_UINT32(value, written[pos + 2]);
+
+   return pos + RECORD_WORDS;
+}
+
+/*==================[external functions definition]==========================*/
+void SuspendOSInterrupts(void)
+{
+   suspended++;
+}
+
+void ResumeOSInterrupts(void)
+{
+   suspended--;
+}
+
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   writtenCount = 0;
+   suspended = 0;
+
+   ciaaLibs_circBufInit_StubWithCallback(circBufInit);
+   ciaaPOSIX_write_StubWithCallback(posixWrite);
+
+   ciaak_traceInit();
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+   TEST_ASSERT_EQUAL_INT(0, suspended);
+}
+
+/** \brief test the records of the tasks and interrupts */
+void test_ciaak_trace_records(void) {
+   size_t pos = 0;
+
+   ciaak_tracePut(CIAAK_TRACE_TASK_START, 2, 0);
+   ciaak_tracePut(CIAAK_TRACE_ISR_ENTER, 24, 0);
+   ciaak_tracePut(CIAAK_TRACE_ISR_EXIT, 24, 0);
+   ciaak_tracePut(CIAAK_TRACE_TASK_END, 2, 0);
+
+   TEST_ASSERT_EQUAL_INT(5 * CIAAK_TRACE_RECORD_SIZE,
+         ciaak_traceDrain(TRACE_FILDES));
+
+   pos = checkRecord(pos, CIAAK_TRACE_CLOCK, 0, CIAAK_TRACE_FREQUENCY);
+   pos = checkRecord(pos, CIAAK_TRACE_TASK_START, 2, 0);
+   pos = checkRecord(pos, CIAAK_TRACE_ISR_ENTER, 24, 0);
+   pos = checkRecord(pos, CIAAK_TRACE_ISR_EXIT, 24, 0);
+   pos = checkRecord(pos, CIAAK_TRACE_TASK_END, 2, 0);
+
+   /* the timestamps do not go back */
+   TEST_ASSERT_TRUE(written[1 * RECORD_WORDS + 1] <= written[2 * RECORD_WORDS + 1]);
+   TEST_ASSERT_TRUE(written[2 * RECORD_WORDS + 1] <= written[3 * RECORD_WORDS + 1]);
+   TEST_ASSERT_TRUE(written[3 * RECORD_WORDS + 1] <= written[4 * RECORD_WORDS + 1]);
+
+   /* nothing left */
+   TEST_ASSERT_EQUAL_INT(0, ciaak_traceDrain(TRACE_FILDES));
+}
+
+/** \brief test the time counters */
+void test_ciaak_trace_counters(void) {
+   ciaak_traceTimeType const * task;
+   ciaak_traceTimeType const * isr;
+   uint32_t loopi;
+
+   for (loopi = 0; loopi < 3; loopi++)
+   {
+      ciaak_tracePut(CIAAK_TRACE_TASK_START, 1, 0);
+      ciaak_tracePut(CIAAK_TRACE_ISR_ENTER, 5, 0);
+      ciaak_tracePut(CIAAK_TRACE_ISR_EXIT, 5, 0);
+      ciaak_tracePut(CIAAK_TRACE_TASK_END, 1, 0);
+   }
+
+   task = ciaak_traceGetTask(1);
+   TEST_ASSERT_NOT_NULL(task);
+   TEST_ASSERT_EQUAL_UINT32(3, task->count);
+   TEST_ASSERT_TRUE(task->maxTime <= task->time);
+   TEST_ASSERT_TRUE(3 * (uint64_t)task->maxTime >= task->time);
+
+   isr = ciaak_traceGetIsr(5);
+   TEST_ASSERT_NOT_NULL(isr);
+   TEST_ASSERT_EQUAL_UINT32(3, isr->count);
+   /* the time of the task includes the interrupt */
+   TEST_ASSERT_TRUE(isr->time <= task->time);
+
+   TEST_ASSERT_EQUAL_UINT32(0, ciaak_traceGetTask(0)->count);
+   TEST_ASSERT_NULL(ciaak_traceGetTask(CIAAK_TRACE_TASKS));
+   TEST_ASSERT_NULL(ciaak_traceGetIsr(CIAAK_TRACE_ISRS));
+
+   /* not counted ids are recorded */
+   ciaak_tracePut(CIAAK_TRACE_TASK_START, CIAAK_TRACE_TASKS, 0);
+   TEST_ASSERT_EQUAL_INT(14 * CIAAK_TRACE_RECORD_SIZE,
+         ciaak_traceDrain(TRACE_FILDES));
+   checkRecord(13 * RECORD_WORDS, CIAAK_TRACE_TASK_START, CIAAK_TRACE_TASKS, 0);
+}
+
+/** \brief test the counters and records of the devices */
+void test_ciaak_trace_devices(void) {
+   ciaak_traceDeviceType const * device;
+   size_t pos = RECORD_WORDS;
+
+   ciaak_traceDevice(CIAAK_TRACE_DEVICE_WRITE, uartPath, 10);
+   ciaak_traceDevice(CIAAK_TRACE_DEVICE_READ, flashPath, 512);
+   ciaak_traceDevice(CIAAK_TRACE_DEVICE_READ, uartPath, 3);
+   ciaak_traceDevice(CIAAK_TRACE_DEVICE_WRITE, uartPath, 5);
+   /* errors are not counted */
+   ciaak_traceDevice(CIAAK_TRACE_DEVICE_READ, uartPath, -1);
+
+   device = ciaak_traceGetDevice(0);
+   TEST_ASSERT_NOT_NULL(device);
+   TEST_ASSERT_EQUAL_PTR(uartPath, device->path);
+   TEST_ASSERT_EQUAL_UINT32(1, device->reads);
+   TEST_ASSERT_EQUAL_UINT32(3, (uint32_t)device->bytesRead);
+   TEST_ASSERT_EQUAL_UINT32(2, device->writes);
+   TEST_ASSERT_EQUAL_UINT32(15, (uint32_t)device->bytesWritten);
+
+   device = ciaak_traceGetDevice(1);
+   TEST_ASSERT_NOT_NULL(device);
+   TEST_ASSERT_EQUAL_PTR(flashPath, device->path);
+   TEST_ASSERT_EQUAL_UINT32(512, (uint32_t)device->bytesRead);
+   TEST_ASSERT_EQUAL_UINT32(0, device->writes);
+
+   TEST_ASSERT_NULL(ciaak_traceGetDevice(2));
+
+   TEST_ASSERT_EQUAL_INT(7 * CIAAK_TRACE_RECORD_SIZE,
+         ciaak_traceDrain(TRACE_FILDES));
+   pos = checkRecord(pos, CIAAK_TRACE_DEVICE_NAME, 0, (uint32_t)(uintptr_t)uartPath);
+   pos = checkRecord(pos, CIAAK_TRACE_DEVICE_WRITE, 0, 10);
+   pos = checkRecord(pos, CIAAK_TRACE_DEVICE_NAME, 1, (uint32_t)(uintptr_t)flashPath);
+   pos = checkRecord(pos, CIAAK_TRACE_DEVICE_READ, 1, 512);
+   pos = checkRecord(pos, CIAAK_TRACE_DEVICE_READ, 0, 3);
+   pos = checkRecord(pos, CIAAK_TRACE_DEVICE_WRITE, 0, 5);
+}
+
+/** \brief test dropped records */
+void test_ciaak_trace_dropped(void) {
+   uint32_t records = (CIAAK_TRACE_SIZE - 1) / CIAAK_TRACE_RECORD_SIZE;
+   uint32_t loopi;
+   size_t pos;
+
+   /* the clock record is already stored */
+   for (loopi = 0; loopi < records + 4; loopi++)
+   {
+      ciaak_tracePut(CIAAK_TRACE_ISR_ENTER, 1, 0);
+   }
+   TEST_ASSERT_EQUAL_UINT32(5, ciaak_traceGetDropped());
+   /* the counters are updated anyway */
+   TEST_ASSERT_EQUAL_UINT32(records + 4, ciaak_traceGetIsr(1)->count);
+
+   TEST_ASSERT_EQUAL_INT(records * CIAAK_TRACE_RECORD_SIZE,
+         ciaak_traceDrain(TRACE_FILDES));
+
+   /* the count of dropped records is recorded before the next record */
+   ciaak_tracePut(CIAAK_TRACE_ISR_EXIT, 1, 0);
+   writtenCount = 0;
+   TEST_ASSERT_EQUAL_INT(2 * CIAAK_TRACE_RECORD_SIZE,
+         ciaak_traceDrain(TRACE_FILDES));
+   pos = checkRecord(0, CIAAK_TRACE_DROPPED, 0, 5);
+   checkRecord(pos, CIAAK_TRACE_ISR_EXIT, 1, 0);
+}
+
+/** \brief benchmark of a task dispatch and an interrupt */
+void test_ciaak_trace_benchmark(void) {
+   uint64_t start;
+   uint64_t ns;
+   uint32_t loopi;
+
+   start = getNs();
+   for (loopi = 0; loopi < BENCH_CALLS; loopi++)
+   {
+      ciaak_tracePut(CIAAK_TRACE_ISR_ENTER, 5, 0);
+      ciaak_tracePut(CIAAK_TRACE_ISR_EXIT, 5, 0);
+      if (0 == (loopi & 63))
+      {
+         (void)ciaak_traceDrain(TRACE_FILDES);
+      }
+   }
+   ns = getNs() - start;
+
+   printf("ciaak_tracePut: %u ns per record, %u dropped\n",
+         (unsigned int)(ns / (2 * BENCH_CALLS)),
+         (unsigned int)ciaak_traceGetDropped());
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
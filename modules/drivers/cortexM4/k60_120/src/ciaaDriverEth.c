@@ -74,6 +74,11 @@ void ciaaDriverEth_init(void)
 void ciaaDriverEth_mainFunction(void)
 {
 
+}
+
+void ciaaDriverEth_wait(void)
+{
+
 }
 /*==================[interrupt handlers]=====================================*/
 
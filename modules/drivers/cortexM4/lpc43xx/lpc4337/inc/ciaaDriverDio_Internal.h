@@ -47,6 +47,8 @@
 
 /*==================[inclusions]=============================================*/
 #include "ciaaPOSIX_stdint.h"
+#include "ciaaDriverDioPort.h"
+#include "ciaaDriverDioEvent.h"
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -54,14 +56,27 @@ extern "C" {
 #endif
 
 /*==================[macros]=================================================*/
+/** \brief count of edge events queued by the inputs, a power of 2 */
+#define CIAADRVDIO_EVENTS           16
+
+/** \brief period of the debounce samples in microseconds */
+#define CIAADRVDIO_DEBOUNCE_PERIOD  1000
+
+/** \brief free running timer of the timestamps and the debounce samples */
+#define CIAADRVDIO_TIMER            LPC_TIMER3
+
+/** \brief clock of the timer */
+#define CIAADRVDIO_TIMER_CLOCK      CLK_MX_TIMER3
+
+/** \brief interrupt of the timer */
+#define CIAADRVDIO_TIMER_IRQ        TIMER3_IRQn
+
+/** \brief maximal count of inputs with pin interrupts */
+#define CIAADRVDIO_PININT_CHANNELS  8
 
 /*==================[typedef]================================================*/
 /** \brief Dio Type */
-typedef struct
-{
-   uint32_t port;
-   uint32_t pin;
-}ciaaDriverDio_dioType;
+typedef ciaaDriverDioPort_pinType ciaaDriverDio_dioType;
 
 /*==================[external data declaration]==============================*/
 
@@ -46,9 +46,12 @@
 
 /*==================[inclusions]=============================================*/
 #include "ciaaDriverAio.h"
+#include "ciaaDriverAioStream.h"
 #include "ciaaPOSIX_stdio.h"
 #include "ciaaPOSIX_stdlib.h"
 #include "ciaaPOSIX_string.h"
+#include "ciaaLibs_Cycles.h"
+#include "ciaak_trace.h"
 #include "chip.h"
 #include "os.h"
 
@@ -64,12 +67,40 @@ typedef uint8_t ContextType;
 
 #define AIO_FIFO_SIZE       (16)
 
+/** \brief samples per block of the continuous acquisition */
+#ifndef AIO_SCAN_BLOCK_SIZE
+#define AIO_SCAN_BLOCK_SIZE      (128)
+#endif
+
+/** \brief blocks of the continuous acquisition, a power of 2 */
+#ifndef AIO_SCAN_BLOCK_COUNT
+#define AIO_SCAN_BLOCK_COUNT     (4)
+#endif
+
+#if (AIO_SCAN_BLOCK_SIZE > 4095)
+#error AIO_SCAN_BLOCK_SIZE exceeds the maximal size of a DMA transfer
+#endif
+
+/** \brief count of channels of an adc */
+#define AIO_ADC_CHANNELS         (8)
+
+/** \brief channel of a conversion in the global data register */
+#define AIO_GDR_CHANNEL(n)       (((n) >> 24) & 0x7)
+
 typedef struct {
    LPC_ADC_T *handler;                  /** <= adc handler */
    int32_t interrupt;                   /** <= adc interrupt */
    ADC_CLOCK_SETUP_T setup;             /** <= adc setup */
    ADC_RESOLUTION_T resolution;         /** <= adc resolution */
    bool start;                          /** <= adc start conversion flag */
+   bool scan;                           /** <= continuous acquisition running */
+   uint8_t scan_channels;               /** <= mask of the scanned adc channels */
+   uint8_t map[AIO_ADC_CHANNELS];       /** <= ciaa channel of each adc channel */
+   uint8_t dma_conn;                    /** <= dma connection */
+   uint8_t dma_channel;                 /** <= dma channel */
+   uint8_t dma_next;                    /** <= dma descriptor to be rearmed */
+   DMA_TransferDescriptor_t dma_desc[2];/** <= ping-pong dma descriptors */
+   ciaaDriverAioStream_type stream;     /** <= blocks of the acquisition */
 } ciaaDriverAdcControlType;
 
 typedef struct {
@@ -77,6 +108,7 @@ typedef struct {
    LPC_GPDMA_T *dma_handler;            /** <= dma handler */
    int32_t dma_interrupt;               /** <= dma interrupt */
    uint8_t dma_channel;                 /** <= dma channel */
+   bool dma_active;                     /** <= dma transfer running */
 } ciaaDriverDacControlType;
 
 typedef union {
@@ -100,6 +132,12 @@ typedef struct {
 /** \brief Buffers */
 ciaaDriverAioControlType aioControl[3];
 
+/** \brief Blocks of the continuous acquisition of each adc */
+static uint32_t aioScanBuffer[2][(AIO_SCAN_BLOCK_COUNT + 1) * AIO_SCAN_BLOCK_SIZE];
+
+/** \brief Timestamps of the blocks of each adc */
+static uint32_t aioScanTimestamps[2][AIO_SCAN_BLOCK_COUNT];
+
 /** \brief Device for ADC 0 */
 static ciaaDevices_deviceType ciaaDriverAio_in0 = {
    "aio/in/0",                     /** <= driver name */
@@ -195,28 +233,190 @@ static void ciaaDriverAio_adcIRQHandler(ciaaDevices_deviceType const * const dev
    Chip_ADC_Int_SetChannelCmd(pAioControl->adc_dac.adc.handler, pAioControl->channel, ENABLE);
 }
 
+static void ciaaDriverAio_adcDmaIRQHandler(ciaaDevices_deviceType const * const device)
+{
+   ciaaDriverAioControlType *pAioControl;
+   ciaaDriverAdcControlType *pAdc;
+   uint32_t *block;
+   uint32_t i;
+
+   pAioControl = (ciaaDriverAioControlType *) device->layer;
+   pAdc = &(pAioControl->adc_dac.adc);
+
+   if ((pAdc->scan == true) &&
+       (Chip_GPDMA_Interrupt(LPC_GPDMA, pAdc->dma_channel) == SUCCESS))
+   {
+      /* hand the filled block to the readers */
+      block = ciaaDriverAioStream_filled(&(pAdc->stream), ciaaLibs_cyclesGet());
+      if (block != NULL)
+      {
+         for(i = 0; i < AIO_SCAN_BLOCK_SIZE; i++)
+         {
+            block[i] = ((uint32_t)pAdc->map[AIO_GDR_CHANNEL(block[i])] << 16) | ADC_DR_RESULT(block[i]);
+         }
+      }
+
+      /* the other descriptor is running, this one follows it */
+      pAdc->dma_desc[pAdc->dma_next].dst = (uint32_t) ciaaDriverAioStream_fill(&(pAdc->stream));
+      pAdc->dma_next ^= 1;
+   }
+}
+
 static void ciaaDriverAio_dacIRQHandler(ciaaDevices_deviceType const * const device)
 {
    ciaaDriverAioControlType *pAioControl;
 
    pAioControl = (ciaaDriverAioControlType *) device->layer;
-   NVIC_DisableIRQ(pAioControl->adc_dac.dac.dma_interrupt);
 
-   if (Chip_GPDMA_Interrupt(pAioControl->adc_dac.dac.dma_handler, pAioControl->adc_dac.dac.dma_channel) == SUCCESS)
+   /* the dma interrupt is shared with the adc acquisitions */
+   if ((pAioControl->adc_dac.dac.dma_active == true) &&
+       (Chip_GPDMA_Interrupt(pAioControl->adc_dac.dac.dma_handler, pAioControl->adc_dac.dac.dma_channel) == SUCCESS))
    {
-      ciaaDriverAio_txConfirmation(device, pAioControl->cnt);
       Chip_GPDMA_Stop(pAioControl->adc_dac.dac.dma_handler, pAioControl->adc_dac.dac.dma_channel);
+      pAioControl->adc_dac.dac.dma_active = false;
+      ciaaDriverAio_txConfirmation(device, pAioControl->cnt);
+   }
+}
+
+static int32_t ciaaDriverAio_adcChannel(int32_t const channel)
+{
+   int32_t ret = -1;
+
+   switch(channel)
+   {
+      case ciaaCHANNEL_0:
+#if(BOARD==ciaa_nxp)
+         ret = ADC_CH1;
+#endif
+         break;
+      case ciaaCHANNEL_1:
+#if(BOARD==ciaa_nxp)
+         ret = ADC_CH2;
+#elif(BOARD==edu_ciaa_nxp)
+         ret = ADC_CH1;
+#endif
+         break;
+      case ciaaCHANNEL_2:
+#if(BOARD==ciaa_nxp)
+         ret = ADC_CH3;
+#elif(BOARD==edu_ciaa_nxp)
+         ret = ADC_CH2;
+#endif
+         break;
+      case ciaaCHANNEL_3:
+#if(BOARD==ciaa_nxp)
+         ret = ADC_CH4;
+#elif(BOARD==edu_ciaa_nxp)
+         ret = ADC_CH3;
+#endif
+         break;
+      default:
+         break;
    }
-   else
+
+   return ret;
+}
+
+static void ciaaDriverAio_scanStop(ciaaDriverAioControlType * const pAioControl)
+{
+   ciaaDriverAdcControlType *pAdc = &(pAioControl->adc_dac.adc);
+   uint8_t i;
+
+   pAdc->scan = false;
+   Chip_ADC_SetBurstCmd(pAdc->handler, DISABLE);
+   Chip_GPDMA_Stop(LPC_GPDMA, pAdc->dma_channel);
+
+   for(i = 0; i < AIO_ADC_CHANNELS; i++)
    {
-       NVIC_EnableIRQ(pAioControl->adc_dac.dac.dma_interrupt);
+      if (pAdc->scan_channels & (1 << i))
+      {
+         Chip_ADC_Int_SetChannelCmd(pAdc->handler, i, DISABLE);
+         Chip_ADC_EnableChannel(pAdc->handler, (ADC_CHANNEL_T) i, DISABLE);
+      }
    }
+   pAdc->scan_channels = 0;
+}
+
+static int32_t ciaaDriverAio_scanStart(ciaaDriverAioControlType * const pAioControl, uint32_t const channels)
+{
+   ciaaDriverAdcControlType *pAdc = &(pAioControl->adc_dac.adc);
+   uint32_t *block;
+   int32_t adcChannel;
+   int32_t ret = 0;
+   uint8_t i;
+
+   if ((channels & ~((1 << ciaaCHANNEL_0) | (1 << ciaaCHANNEL_1) | (1 << ciaaCHANNEL_2) | (1 << ciaaCHANNEL_3))) != 0)
+   {
+      ret = -1;
+   }
+   for(i = ciaaCHANNEL_0; (i <= ciaaCHANNEL_3) && (ret == 0); i++)
+   {
+      if ((channels & (1 << i)) && (ciaaDriverAio_adcChannel(i) < 0))
+      {
+         ret = -1;
+      }
+   }
+
+   if (ret == 0)
+   {
+      /* stop the single channel conversions */
+      NVIC_DisableIRQ(pAdc->interrupt);
+      if (pAioControl->channel >= 0)
+      {
+         Chip_ADC_Int_SetChannelCmd(pAdc->handler, pAioControl->channel, DISABLE);
+         Chip_ADC_EnableChannel(pAdc->handler, pAioControl->channel, DISABLE);
+      }
+      pAdc->start = false;
+
+      /* each conversion of a scanned channel requests a dma transfer */
+      for(i = ciaaCHANNEL_0; i <= ciaaCHANNEL_3; i++)
+      {
+         if (channels & (1 << i))
+         {
+            adcChannel = ciaaDriverAio_adcChannel(i);
+            pAdc->map[adcChannel] = i;
+            pAdc->scan_channels |= (1 << adcChannel);
+            Chip_ADC_EnableChannel(pAdc->handler, (ADC_CHANNEL_T) adcChannel, ENABLE);
+            Chip_ADC_Int_SetChannelCmd(pAdc->handler, adcChannel, ENABLE);
+         }
+      }
+
+      ciaaDriverAioStream_init(&(pAdc->stream), pAdc->stream.buffer, pAdc->stream.timestamps,
+            AIO_SCAN_BLOCK_SIZE, AIO_SCAN_BLOCK_COUNT);
+
+      /* ping-pong: the channel fills the first block, then the descriptors
+       * 1 and 0 alternate and are rearmed by the dma interrupt */
+      pAdc->dma_channel = Chip_GPDMA_GetFreeChannel(LPC_GPDMA, pAdc->dma_conn);
+      block = ciaaDriverAioStream_fill(&(pAdc->stream));
+      Chip_GPDMA_PrepareDescriptor(LPC_GPDMA, &(pAdc->dma_desc[0]), pAdc->dma_conn,
+            (uint32_t) block, AIO_SCAN_BLOCK_SIZE, GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA, &(pAdc->dma_desc[1]));
+      Chip_GPDMA_PrepareDescriptor(LPC_GPDMA, &(pAdc->dma_desc[1]), pAdc->dma_conn,
+            (uint32_t) ciaaDriverAioStream_fill(&(pAdc->stream)), AIO_SCAN_BLOCK_SIZE,
+            GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA, &(pAdc->dma_desc[0]));
+      /* interrupt at the end of each block */
+      pAdc->dma_desc[0].ctrl |= GPDMA_DMACCxControl_I;
+      pAdc->dma_desc[1].ctrl |= GPDMA_DMACCxControl_I;
+      pAdc->dma_next = 0;
+
+      Chip_GPDMA_Transfer(LPC_GPDMA, pAdc->dma_channel, pAdc->dma_conn, (uint32_t) block,
+            GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA, AIO_SCAN_BLOCK_SIZE);
+      /* no conversion is requested before the burst starts */
+      LPC_GPDMA->CH[pAdc->dma_channel].LLI = (uint32_t) &(pAdc->dma_desc[1]);
+
+      pAdc->scan = true;
+      Chip_ADC_SetBurstCmd(pAdc->handler, ENABLE);
+   }
+
+   return ret;
 }
 
 void ciaa_lpc4337_aio_init(void)
 {
    /* ADC0 Init */
    aioControl[0].adc_dac.adc.handler = LPC_ADC0;
+   aioControl[0].adc_dac.adc.dma_conn = GPDMA_CONN_ADC_0;
+   ciaaDriverAioStream_init(&(aioControl[0].adc_dac.adc.stream), aioScanBuffer[0], aioScanTimestamps[0],
+         AIO_SCAN_BLOCK_SIZE, AIO_SCAN_BLOCK_COUNT);
    aioControl[0].adc_dac.adc.interrupt = ADC0_IRQn;
    aioControl[0].adc_dac.adc.start = false;
    Chip_ADC_Init(aioControl[0].adc_dac.adc.handler, &(aioControl[0].adc_dac.adc.setup));
@@ -225,6 +425,9 @@ void ciaa_lpc4337_aio_init(void)
 
    /* ADC1 Init */
    aioControl[1].adc_dac.adc.handler = LPC_ADC1;
+   aioControl[1].adc_dac.adc.dma_conn = GPDMA_CONN_ADC_1;
+   ciaaDriverAioStream_init(&(aioControl[1].adc_dac.adc.stream), aioScanBuffer[1], aioScanTimestamps[1],
+         AIO_SCAN_BLOCK_SIZE, AIO_SCAN_BLOCK_COUNT);
    aioControl[1].adc_dac.adc.interrupt = ADC1_IRQn;
    aioControl[1].adc_dac.adc.start = false;
    Chip_ADC_Init(aioControl[1].adc_dac.adc.handler, &(aioControl[1].adc_dac.adc.setup));
@@ -249,6 +452,9 @@ void ciaa_lpc4337_aio_init(void)
    NVIC_DisableIRQ(aioControl[2].adc_dac.dac.dma_interrupt);
    NVIC_SetPriority(aioControl[2].adc_dac.dac.dma_interrupt, ((0x01 << 3) | 0x01));
    NVIC_EnableIRQ(aioControl[2].adc_dac.dac.dma_interrupt);
+
+   /* cycle counter for the timestamps of the acquisition blocks */
+   ciaaLibs_cyclesEnable();
 }
 
 
@@ -270,6 +476,10 @@ extern int32_t ciaaDriverAio_close(ciaaDevices_deviceType const * const device)
    if ((device == ciaaDriverAioConst.devices[0]) ||
        (device == ciaaDriverAioConst.devices[1]))
    {
+      if (pAioControl->adc_dac.adc.scan == true)
+      {
+         ciaaDriverAio_scanStop(pAioControl);
+      }
       NVIC_DisableIRQ(pAioControl->adc_dac.adc.interrupt);
       Chip_ADC_Int_SetChannelCmd(pAioControl->adc_dac.adc.handler, pAioControl->channel, DISABLE);
       ret = 0;
@@ -287,8 +497,10 @@ extern int32_t ciaaDriverAio_close(ciaaDevices_deviceType const * const device)
 extern int32_t ciaaDriverAio_ioctl(ciaaDevices_deviceType const * const device, int32_t const request, void * param)
 {
    ciaaDriverAioControlType *pAioControl;
+   ciaaPOSIX_aioBlockType *block;
    uint32_t freq;
    uint32_t value;
+   int32_t channel;
    int32_t ret = -1;
 
    pAioControl = (ciaaDriverAioControlType *) device->layer;
@@ -300,58 +512,34 @@ extern int32_t ciaaDriverAio_ioctl(ciaaDevices_deviceType const * const device,
       switch(request)
       {
          case ciaaPOSIX_IOCTL_SET_CHANNEL:
-            NVIC_DisableIRQ(pAioControl->adc_dac.adc.interrupt);
-            Chip_ADC_Int_SetChannelCmd(pAioControl->adc_dac.adc.handler, pAioControl->channel, DISABLE);
-            Chip_ADC_EnableChannel(pAioControl->adc_dac.adc.handler, pAioControl->channel, DISABLE);
-
-            ret = 0;
-            switch((int32_t)param)
+            /* the continuous acquisition shall be stopped first */
+            channel = -1;
+            if (pAioControl->adc_dac.adc.scan == false)
             {
-               case ciaaCHANNEL_0:
-#if(BOARD==ciaa_nxp)
-                  pAioControl->channel = ADC_CH1;
-#elif(BOARD==edu_ciaa_nxp)
-                  ret = -1;
-#endif
-                  break;
-               case ciaaCHANNEL_1:
-#if(BOARD==ciaa_nxp)
-                  pAioControl->channel = ADC_CH2;
-#elif(BOARD==edu_ciaa_nxp)
-                  pAioControl->channel = ADC_CH1;
-#endif
-                  break;
-               case ciaaCHANNEL_2:
-#if(BOARD==ciaa_nxp)
-                  pAioControl->channel = ADC_CH3;
-#elif(BOARD==edu_ciaa_nxp)
-                  pAioControl->channel = ADC_CH2;
-#endif
-                  break;
-               case ciaaCHANNEL_3:
-#if(BOARD==ciaa_nxp)
-                  pAioControl->channel = ADC_CH4;
-#elif(BOARD==edu_ciaa_nxp)
-                  pAioControl->channel = ADC_CH3;
-#endif
-                  break;
-               default:
-                  ret = -1;
-                  break;
+               NVIC_DisableIRQ(pAioControl->adc_dac.adc.interrupt);
+               Chip_ADC_Int_SetChannelCmd(pAioControl->adc_dac.adc.handler, pAioControl->channel, DISABLE);
+               Chip_ADC_EnableChannel(pAioControl->adc_dac.adc.handler, pAioControl->channel, DISABLE);
+
+               channel = ciaaDriverAio_adcChannel((int32_t)param);
             }
-            if (ret == 0)
+            if (channel >= 0)
             {
+                pAioControl->channel = channel;
                 NVIC_EnableIRQ(pAioControl->adc_dac.adc.interrupt);
                 Chip_ADC_EnableChannel(pAioControl->adc_dac.adc.handler, pAioControl->channel, ENABLE);
                 Chip_ADC_Int_SetChannelCmd(pAioControl->adc_dac.adc.handler, pAioControl->channel, ENABLE);
                 pAioControl->adc_dac.adc.start = true;
+                ret = 0;
             }
             break;
 
          case ciaaPOSIX_IOCTL_SET_SAMPLE_RATE:
             NVIC_DisableIRQ(pAioControl->adc_dac.adc.interrupt);
             Chip_ADC_SetSampleRate(pAioControl->adc_dac.adc.handler, &(pAioControl->adc_dac.adc.setup), (uint32_t)param);
-            NVIC_EnableIRQ(pAioControl->adc_dac.adc.interrupt);
+            if (pAioControl->adc_dac.adc.scan == false)
+            {
+               NVIC_EnableIRQ(pAioControl->adc_dac.adc.interrupt);
+            }
             break;
 
          case ciaaPOSIX_IOCTL_SET_RESOLUTION:
@@ -394,12 +582,19 @@ extern int32_t ciaaDriverAio_ioctl(ciaaDevices_deviceType const * const device,
             if (ret == 0)
             {
                 Chip_ADC_SetResolution(pAioControl->adc_dac.adc.handler, &(pAioControl->adc_dac.adc.setup), pAioControl->adc_dac.adc.resolution);
-                NVIC_EnableIRQ(pAioControl->adc_dac.adc.interrupt);
+                if (pAioControl->adc_dac.adc.scan == false)
+                {
+                   NVIC_EnableIRQ(pAioControl->adc_dac.adc.interrupt);
+                }
             }
             break;
 
          case ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT:
-            if((bool)(intptr_t)param == false)
+            if (pAioControl->adc_dac.adc.scan == true)
+            {
+               /* the samples are not forwarded to the upper layer */
+            }
+            else if((bool)(intptr_t)param == false)
             {
                NVIC_DisableIRQ(pAioControl->adc_dac.adc.interrupt);
                Chip_ADC_Int_SetChannelCmd(pAioControl->adc_dac.adc.handler, &(pAioControl->adc_dac.adc.setup), DISABLE);
@@ -412,6 +607,37 @@ extern int32_t ciaaDriverAio_ioctl(ciaaDevices_deviceType const * const device,
                pAioControl->adc_dac.adc.start = true;
             }
             break;
+
+         case ciaaPOSIX_IOCTL_SET_SCAN_CHANNELS:
+            if (pAioControl->adc_dac.adc.scan == true)
+            {
+               ciaaDriverAio_scanStop(pAioControl);
+            }
+            ret = 0;
+            if ((uint32_t)param != 0)
+            {
+               ret = ciaaDriverAio_scanStart(pAioControl, (uint32_t)param);
+            }
+            break;
+
+         case ciaaPOSIX_IOCTL_GET_BLOCK:
+            block = (ciaaPOSIX_aioBlockType *) param;
+            if ((pAioControl->adc_dac.adc.scan == true) &&
+                (ciaaDriverAioStream_get(&(pAioControl->adc_dac.adc.stream), &(block->samples), &(block->timestamp))))
+            {
+               block->count = AIO_SCAN_BLOCK_SIZE;
+               block->overruns = ciaaDriverAioStream_overruns(&(pAioControl->adc_dac.adc.stream));
+               ret = 0;
+            }
+            break;
+
+         case ciaaPOSIX_IOCTL_RELEASE_BLOCK:
+            if ((pAioControl->adc_dac.adc.scan == true) &&
+                (ciaaDriverAioStream_release(&(pAioControl->adc_dac.adc.stream))))
+            {
+               ret = 0;
+            }
+            break;
       }
       if (pAioControl->adc_dac.adc.start == true)
       {
@@ -548,10 +774,13 @@ extern ssize_t ciaaDriverAio_write(ciaaDevices_deviceType const * const device,
             ptr ++;
             samples ++;
          }
-         if (samples)
+         if (pAioControl->adc_dac.dac.dma_active == true)
+         {
+            /* the previous transfer is still running */
+            ret = 0;
+         }
+         else if (samples)
          {
-            NVIC_DisableIRQ(pAioControl->adc_dac.dac.dma_interrupt);
-
             /* Get the free channel for DMA transfer */
             pAioControl->adc_dac.dac.dma_channel = Chip_GPDMA_GetFreeChannel(pAioControl->adc_dac.dac.dma_handler, GPDMA_CONN_DAC);
 
@@ -559,6 +788,7 @@ extern ssize_t ciaaDriverAio_write(ciaaDevices_deviceType const * const device,
             Chip_GPDMA_Transfer(pAioControl->adc_dac.dac.dma_handler, pAioControl->adc_dac.dac.dma_channel,
                                    (uint32_t) &dmaBuffer, GPDMA_CONN_DAC,
                                    GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA, samples);
+            pAioControl->adc_dac.dac.dma_active = true;
 
             /* Bytes transfered */
             pAioControl->cnt = size - count;
@@ -587,17 +817,25 @@ void ciaaDriverAio_init(void)
 
 ISR(ADC0_IRQHandler)
 {
+   ciaak_traceIsrEnter(ADC0_IRQn);
    ciaaDriverAio_adcIRQHandler(&ciaaDriverAio_in0);
+   ciaak_traceIsrExit(ADC0_IRQn);
 }
 
 ISR(ADC1_IRQHandler)
 {
+   ciaak_traceIsrEnter(ADC1_IRQn);
    ciaaDriverAio_adcIRQHandler(&ciaaDriverAio_in1);
+   ciaak_traceIsrExit(ADC1_IRQn);
 }
 
 ISR(DMA_IRQHandler)
 {
+   ciaak_traceIsrEnter(DMA_IRQn);
+   ciaaDriverAio_adcDmaIRQHandler(&ciaaDriverAio_in0);
+   ciaaDriverAio_adcDmaIRQHandler(&ciaaDriverAio_in1);
    ciaaDriverAio_dacIRQHandler(&ciaaDriverAio_out0);
+   ciaak_traceIsrExit(DMA_IRQn);
 }
 
 /** @} doxygen end group definition */
@@ -35,6 +35,10 @@
  **
  ** Implements the Digital Input/Output (Dio) Driver for LPC4337
  **
+ ** The edge events of the inputs use the pin interrupts GPIO0 to GPIO7 and
+ ** the timer TIMER3, the applications using them shall declare the ISRs
+ ** GPIOn_IRQHandler of their inputs and TIMER3_IRQHandler in the OIL file.
+ **
  **/
 
 /** \addtogroup CIAA_Firmware CIAA Firmware
@@ -49,7 +53,11 @@
 #include "ciaaDriverDio_Internal.h"
 #include "ciaaPOSIX_stdlib.h"
 #include "ciaaPOSIX_string.h"
+#include "ciaaPOSIX_ioctl_dio.h"
+#include "ciaaPOSIX_stdbool.h"
+#include "ciaak_trace.h"
 #include "chip.h"
+#include "os.h"
 
 /*==================[macros and definitions]=================================*/
 
@@ -59,6 +67,10 @@
 /** \brief Managed output count */
 #define ciaaDriverDio_OutputCount (sizeof(ciaaDriverDio_Outputs) / sizeof(ciaaDriverDio_dioType))
 
+/** \brief Inputs with a pin interrupt channel, the input n uses the channel n */
+#define ciaaDriverDio_PinIntCount ((ciaaDriverDio_InputCount < CIAADRVDIO_PININT_CHANNELS) ? \
+      ciaaDriverDio_InputCount : CIAADRVDIO_PININT_CHANNELS)
+
 /** \brief Pointer to Devices */
 typedef struct  {
    ciaaDevices_deviceType * const * const devices;
@@ -121,6 +133,18 @@ static ciaaDriverConstType const ciaaDriverDioConst = {
    2
 };
 
+/** \brief mask and shift table of the inputs */
+static ciaaDriverDioPort_tableType ciaaDriverDio_InputTable;
+
+/** \brief mask and shift table of the outputs */
+static ciaaDriverDioPort_tableType ciaaDriverDio_OutputTable;
+
+/** \brief edge events of the inputs */
+static ciaaDriverDioEvent_type ciaaDriverDio_Event;
+
+/** \brief queue of the edge events */
+static ciaaPOSIX_dioEventType ciaaDriverDio_Events[CIAADRVDIO_EVENTS];
+
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
@@ -206,87 +230,192 @@ static void ciaa_lpc4337_gpio_init(void)
 #endif
 }
 
-/** \brief write managed output
- *  \param[in] outputNumber number of output to set (0 to ciaaDriverDio_OutputCount)
- *  \param[in] value new state for output (true or false)
+/** \brief read the state of the managed pins
+ *  \param[in] table mask and shift table of the pins
+ *  \return state of the pins, the bit n is the pin n
  */
-static void ciaa_lpc4337_writeOutput(uint32_t outputNumber, uint32_t value)
+static uint32_t ciaa_lpc4337_readPorts(ciaaDriverDioPort_tableType const * table)
 {
-   if (outputNumber < ciaaDriverDio_OutputCount)
+   uint32_t state = 0;
+   uint32_t i;
+
+   /* one register read per gpio port */
+   for(i = 0; i < table->portCount; i++)
    {
-      Chip_GPIO_SetPinState(LPC_GPIO_PORT,
-         ciaaDriverDio_Outputs[outputNumber].port,
-         ciaaDriverDio_Outputs[outputNumber].pin,
-         value != 0 ? 1 : 0);
+      state |= ciaaDriverDioPort_gather(table, i,
+            Chip_GPIO_GetPortValue(LPC_GPIO_PORT, table->ports[i].port));
    }
+
+   return state;
 }
 
-/** \brief read managed input
- *  \param[in] inputNumber number of output to read (0 to ciaaDriverDio_InputCount)
- *  \return 1 if gpio is high, 0 if it's low, -1 if incorrect pin number
+/** \brief write the managed outputs of a mask
+ *  \param[in] state new state of the outputs, the bit n is the output n
+ *  \param[in] mask outputs to be written
  */
-static int32_t ciaa_lpc4337_readInput(uint32_t inputNumber)
+static void ciaa_lpc4337_writePorts(uint32_t state, uint32_t mask)
 {
-   int32_t rv = -1;
+   uint32_t bits, pins;
+   uint32_t i;
 
-   if (inputNumber < ciaaDriverDio_InputCount)
+   /* set and clear registers, the other pins of the ports are not modified */
+   for(i = 0; i < ciaaDriverDio_OutputTable.portCount; i++)
    {
-      rv = Chip_GPIO_GetPinState(LPC_GPIO_PORT,
-         ciaaDriverDio_Inputs[inputNumber].port,
-         ciaaDriverDio_Inputs[inputNumber].pin) ? 1 : 0;
+      pins = ciaaDriverDioPort_scatter(&ciaaDriverDio_OutputTable, i, mask);
+      bits = ciaaDriverDioPort_scatter(&ciaaDriverDio_OutputTable, i, state);
+      if(0 != (pins & bits))
+      {
+         Chip_GPIO_SetValue(LPC_GPIO_PORT, ciaaDriverDio_OutputTable.ports[i].port, pins & bits);
+      }
+      if(0 != (pins & ~bits))
+      {
+         Chip_GPIO_ClearValue(LPC_GPIO_PORT, ciaaDriverDio_OutputTable.ports[i].port, pins & ~bits);
+      }
    }
+}
+
+/** \brief toggle the managed outputs of a mask
+ *  \param[in] mask outputs to be toggled
+ */
+static void ciaa_lpc4337_togglePorts(uint32_t mask)
+{
+   uint32_t pins;
+   uint32_t i;
 
-   return rv;
+   for(i = 0; i < ciaaDriverDio_OutputTable.portCount; i++)
+   {
+      pins = ciaaDriverDioPort_scatter(&ciaaDriverDio_OutputTable, i, mask);
+      if(0 != pins)
+      {
+         Chip_GPIO_SetPortToggle(LPC_GPIO_PORT, ciaaDriverDio_OutputTable.ports[i].port, pins);
+      }
+   }
 }
 
-/** \brief read managed output
- *  \param[in] outputNumber number of output to read (0 to ciaaDriverDio_OutputCount)
- *  \return 1 if gpio is high, 0 if it's low, -1 if incorrect pin number
+/** \brief enable or disable the interrupts sampling the inputs
+ *  \param[in] enable true to enable the interrupts
+ *
+ *  The interrupts are disabled while the events are configured.
  */
-static int32_t ciaa_lpc4337_readOutput(uint32_t outputNumber)
+static void ciaa_lpc4337_enableEventIRQs(bool enable)
 {
-   int32_t rv = -1;
+   uint32_t i;
 
-   if (outputNumber < ciaaDriverDio_OutputCount)
+   for(i = 0; i < ciaaDriverDio_PinIntCount; i++)
    {
-      rv = Chip_GPIO_GetPinState(LPC_GPIO_PORT,
-         ciaaDriverDio_Outputs[outputNumber].port,
-         ciaaDriverDio_Outputs[outputNumber].pin) ? 1 : 0;
+      if(enable)
+      {
+         NVIC_EnableIRQ(PIN_INT0_IRQn + i);
+      }
+      else
+      {
+         NVIC_DisableIRQ(PIN_INT0_IRQn + i);
+      }
    }
+   if(enable)
+   {
+      NVIC_EnableIRQ(CIAADRVDIO_TIMER_IRQ);
+   }
+   else
+   {
+      NVIC_DisableIRQ(CIAADRVDIO_TIMER_IRQ);
+   }
+}
 
-   return rv;
+/** \brief initialize the pin interrupts and the timer of the events */
+static void ciaa_lpc4337_eventInit(void)
+{
+   uint32_t i;
+
+   /* free running at 1 MHz, the timestamps are in microseconds */
+   Chip_TIMER_Init(CIAADRVDIO_TIMER);
+   Chip_TIMER_PrescaleSet(CIAADRVDIO_TIMER,
+         Chip_Clock_GetRate(CIAADRVDIO_TIMER_CLOCK) / 1000000 - 1);
+   Chip_TIMER_Enable(CIAADRVDIO_TIMER);
+
+   /* both edges of each input interrupt, the interrupts are enabled with
+    * the events */
+   Chip_PININT_Init(LPC_GPIO_PIN_INT);
+   for(i = 0; i < ciaaDriverDio_PinIntCount; i++)
+   {
+      Chip_SCU_GPIOIntPinSel(i, ciaaDriverDio_Inputs[i].port, ciaaDriverDio_Inputs[i].pin);
+   }
+   i = (1 << ciaaDriverDio_PinIntCount) - 1;
+   Chip_PININT_SetPinModeEdge(LPC_GPIO_PIN_INT, i);
+   Chip_PININT_EnableIntHigh(LPC_GPIO_PIN_INT, i);
+   Chip_PININT_EnableIntLow(LPC_GPIO_PIN_INT, i);
+   Chip_PININT_ClearIntStatus(LPC_GPIO_PIN_INT, i);
+
+   ciaaDriverDioEvent_init(&ciaaDriverDio_Event, ciaaDriverDio_Events,
+         CIAADRVDIO_EVENTS, ciaa_lpc4337_readPorts(&ciaaDriverDio_InputTable));
+}
+
+/** \brief sample the inputs from a pin or timer interrupt
+ *  \param[in] tick true if called by the debounce match of the timer
+ *
+ *  The debounce match is armed with the first edge and rearmed every
+ *  period while some input is settling.
+ */
+static void ciaa_lpc4337_sampleInputs(bool tick)
+{
+   uint32_t timestamp = Chip_TIMER_ReadCount(CIAADRVDIO_TIMER);
+   uint32_t settling = ciaaDriverDio_Event.settling;
+   uint32_t count = ciaaDriverDioEvent_count(&ciaaDriverDio_Event);
+
+   if(0 != ciaaDriverDioEvent_sample(&ciaaDriverDio_Event,
+            ciaa_lpc4337_readPorts(&ciaaDriverDio_InputTable), timestamp))
+   {
+      if(tick || (0 == settling))
+      {
+         Chip_TIMER_SetMatch(CIAADRVDIO_TIMER, 0, timestamp + CIAADRVDIO_DEBOUNCE_PERIOD);
+         Chip_TIMER_MatchEnableInt(CIAADRVDIO_TIMER, 0);
+      }
+   }
+   else
+   {
+      Chip_TIMER_MatchDisableInt(CIAADRVDIO_TIMER, 0);
+   }
+
+   if(count != ciaaDriverDioEvent_count(&ciaaDriverDio_Event))
+   {
+      ciaaDioDevices_eventIndication(ciaaDriverDio_in0.upLayer);
+   }
+}
+
+/** \brief pin interrupt handler of an input
+ *  \param[in] channel pin interrupt channel, the number of the input
+ */
+static void ciaa_lpc4337_pinIRQHandler(uint32_t channel)
+{
+   ciaak_traceIsrEnter(PIN_INT0_IRQn + channel);
+   Chip_PININT_ClearIntStatus(LPC_GPIO_PIN_INT, PININTCH(channel));
+   ciaa_lpc4337_sampleInputs(false);
+   ciaak_traceIsrExit(PIN_INT0_IRQn + channel);
 }
 
 /** \brief pack bit states in byte buffer
- *  \param[in] number of pins to read (normally ciaaDriverDio_OutputCount or ciaaDriverDio_InputCount)
+ *  \param[in] table mask and shift table of the pins to read (ciaaDriverDio_InputTable or ciaaDriverDio_OutputTable)
  *  \param[out] buffer user buffer
  *  \param[in] size user buffer size
- *  \param[in] readFunction function used to read pins (normally ciaa_lpc4337_readOutput or ciaa_lpc4337_readInput)
  *  \return number bytes required in buffer to store bits
  */
-static int32_t ciaa_lpc4337_readPins(int32_t pinCount, uint8_t * buffer, size_t size, int32_t (*readFunction)(uint32_t))
+static int32_t ciaa_lpc4337_readPins(ciaaDriverDioPort_tableType const * table, uint8_t * buffer, size_t size)
 {
-   int32_t count, i, j;
-   /* amount of bytes necessary to store all input states */
-   count = pinCount >> 3; /* ciaaDriverDio_InputCount / 8 */
-   if( (pinCount & 0x07) != 0) /* (ciaaDriverDio_InputCount % 8) != 0 */
-   {
-      count += 1;
-   }
+   int32_t count, i;
+   uint32_t state;
+
+   /* amount of bytes necessary to store all pin states */
+   count = (table->pinCount + 7) >> 3;
    /* adjust gpios to read according to provided buffer length */
    if(count > size)
    {
       count = size;
    }
-   /* read and store all inputs in user buffer */
-   ciaaPOSIX_memset(buffer, 0, count);
-   for(i = 0, j = 0; (i < pinCount) && (j < count); i++)
+   /* read and store all pins in user buffer */
+   state = ciaa_lpc4337_readPorts(table);
+   for(i = 0; i < count; i++)
    {
-      if((i > 0) && ((i & 0x07)==0))
-      {
-         j++;
-      }
-      buffer[j] |= readFunction(i) << (i - 8 * j);
+      buffer[i] = (uint8_t)(state >> (8 * i));
    }
    return count;
 }
@@ -305,22 +434,97 @@ extern int32_t ciaaDriverDio_close(ciaaDevices_deviceType const * const device)
 
 extern int32_t ciaaDriverDio_ioctl(ciaaDevices_deviceType const * const device, int32_t const request, void * param)
 {
-   return -1;
+   int32_t ret = -1;
+   uint32_t mask = (uint32_t)(uintptr_t)param;
+   ciaaPOSIX_dioDebounceType const * debounce = param;
+
+   if(device == ciaaDioDevices[0])
+   {
+      switch(request)
+      {
+         case ciaaPOSIX_IOCTL_DIO_SET_EVENTS:
+            /* only the inputs with a pin interrupt generate events */
+            if(0 == (mask & ~(uint32_t)((1 << ciaaDriverDio_PinIntCount) - 1)))
+            {
+               ciaa_lpc4337_enableEventIRQs(false);
+               /* the state may have changed while the interrupts were off */
+               Chip_PININT_ClearIntStatus(LPC_GPIO_PIN_INT, (1 << ciaaDriverDio_PinIntCount) - 1);
+               ciaa_lpc4337_sampleInputs(true);
+               ciaaDriverDioEvent_enable(&ciaaDriverDio_Event, mask);
+               ciaa_lpc4337_enableEventIRQs(0 != mask);
+               ret = 0;
+            }
+            break;
+
+         case ciaaPOSIX_IOCTL_DIO_SET_DEBOUNCE:
+            if(NULL != debounce)
+            {
+               ciaa_lpc4337_enableEventIRQs(false);
+               ciaaDriverDioEvent_setDebounce(&ciaaDriverDio_Event,
+                     debounce->inputs, debounce->samples);
+               ciaa_lpc4337_enableEventIRQs(0 != ciaaDriverDio_Event.enabled);
+               ret = 0;
+            }
+            break;
+
+         case ciaaPOSIX_IOCTL_DIO_GET_EVENT_COUNT:
+            ret = ciaaDriverDioEvent_count(&ciaaDriverDio_Event);
+            break;
+
+         default:
+            ret = -1;
+            break;
+      }
+   }
+   else if(device == ciaaDioDevices[1])
+   {
+      /* only the outputs can be set, cleared or toggled */
+      switch(request)
+      {
+         case ciaaPOSIX_IOCTL_DIO_SET:
+            ciaa_lpc4337_writePorts(mask, mask);
+            ret = 0;
+            break;
+
+         case ciaaPOSIX_IOCTL_DIO_CLEAR:
+            ciaa_lpc4337_writePorts(0, mask);
+            ret = 0;
+            break;
+
+         case ciaaPOSIX_IOCTL_DIO_TOGGLE:
+            ciaa_lpc4337_togglePorts(mask);
+            ret = 0;
+            break;
+
+         default:
+            ret = -1;
+            break;
+      }
+   }
+
+   return ret;
 }
 
 extern ssize_t ciaaDriverDio_read(ciaaDevices_deviceType const * const device, uint8_t * buffer, size_t size)
 {
    ssize_t ret = -1;
 
-   if(device == ciaaDioDevices[0])
+   if((device == ciaaDioDevices[0]) && (0 != ciaaDriverDio_Event.enabled))
+   {
+      /* whole edge events, the buffer is an array of events */
+      ret = ciaaDriverDioEvent_get(&ciaaDriverDio_Event,
+            (ciaaPOSIX_dioEventType *)buffer, size / sizeof(ciaaPOSIX_dioEventType));
+      ret *= sizeof(ciaaPOSIX_dioEventType);
+   }
+   else if(device == ciaaDioDevices[0])
    {
       /* accessing to inputs */
-      ret = ciaa_lpc4337_readPins(ciaaDriverDio_InputCount, buffer, size, ciaa_lpc4337_readInput);
+      ret = ciaa_lpc4337_readPins(&ciaaDriverDio_InputTable, buffer, size);
    }
    else if(device == ciaaDioDevices[1])
    {
       /* accessing to outputs */
-      ret = ciaa_lpc4337_readPins(ciaaDriverDio_OutputCount, buffer, size, ciaa_lpc4337_readOutput);
+      ret = ciaa_lpc4337_readPins(&ciaaDriverDio_OutputTable, buffer, size);
    }
    else
    {
@@ -344,22 +548,24 @@ extern ssize_t ciaaDriverDio_write(ciaaDevices_deviceType const * const device,
       else if(device == ciaaDioDevices[1])
       {
          /* Write outputs */
-         int32_t i, j;
+         uint32_t state = 0, mask = 0;
+         int32_t i, count;
 
-         /* set outputs according to bits defined in user buffer */
-         for(i = 0, j = 0; (i < ciaaDriverDio_OutputCount) && (j < size); i++)
+         /* amount of bytes necessary to set all the outputs */
+         count = (ciaaDriverDio_OutputCount + 7) >> 3;
+         if(count > size)
          {
-            if( (i > 0) && ((i & 0x07) == 0) )
-            {
-               j++;
-            }
-            ciaa_lpc4337_writeOutput(i, buffer[j] & (1 << (i - 8 * j)));
+            count = size;
          }
-         if((ciaaDriverDio_OutputCount & 0x07) != 0)
+
+         /* set outputs according to bits defined in user buffer */
+         for(i = 0; i < count; i++)
          {
-            j++;
+            state |= (uint32_t)buffer[i] << (8 * i);
+            mask |= (uint32_t)0xFF << (8 * i);
          }
-         ret = j;
+         ciaa_lpc4337_writePorts(state, mask);
+         ret = count;
       }
       else
       {
@@ -376,6 +582,13 @@ void ciaaDriverDio_init(void)
    /* low level GPIO peripheral initialization */
    ciaa_lpc4337_gpio_init();
 
+   /* mask and shift tables of the board pin tables */
+   ciaaDriverDioPort_init(&ciaaDriverDio_InputTable, ciaaDriverDio_Inputs, ciaaDriverDio_InputCount);
+   ciaaDriverDioPort_init(&ciaaDriverDio_OutputTable, ciaaDriverDio_Outputs, ciaaDriverDio_OutputCount);
+
+   /* timestamps and pin interrupts of the edge events */
+   ciaa_lpc4337_eventInit();
+
    /* add dio driver to the list of devices */
    for(loopi = 0; loopi < ciaaDriverDioConst.countOfDevices; loopi++) {
       /* add each device */
@@ -384,6 +597,56 @@ void ciaaDriverDio_init(void)
 }
 
 /*==================[interrupt handlers]=====================================*/
+ISR(GPIO0_IRQHandler)
+{
+   ciaa_lpc4337_pinIRQHandler(0);
+}
+
+ISR(GPIO1_IRQHandler)
+{
+   ciaa_lpc4337_pinIRQHandler(1);
+}
+
+ISR(GPIO2_IRQHandler)
+{
+   ciaa_lpc4337_pinIRQHandler(2);
+}
+
+ISR(GPIO3_IRQHandler)
+{
+   ciaa_lpc4337_pinIRQHandler(3);
+}
+
+ISR(GPIO4_IRQHandler)
+{
+   ciaa_lpc4337_pinIRQHandler(4);
+}
+
+ISR(GPIO5_IRQHandler)
+{
+   ciaa_lpc4337_pinIRQHandler(5);
+}
+
+ISR(GPIO6_IRQHandler)
+{
+   ciaa_lpc4337_pinIRQHandler(6);
+}
+
+ISR(GPIO7_IRQHandler)
+{
+   ciaa_lpc4337_pinIRQHandler(7);
+}
+
+ISR(TIMER3_IRQHandler)
+{
+   ciaak_traceIsrEnter(TIMER3_IRQn);
+   if(Chip_TIMER_MatchPending(CIAADRVDIO_TIMER, 0))
+   {
+      Chip_TIMER_ClearMatch(CIAADRVDIO_TIMER, 0);
+      ciaa_lpc4337_sampleInputs(true);
+   }
+   ciaak_traceIsrExit(TIMER3_IRQn);
+}
 
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
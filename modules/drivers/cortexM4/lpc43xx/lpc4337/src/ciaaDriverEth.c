@@ -35,6 +35,11 @@
  **
  ** Implements the Eth Driver for LPC4337
  **
+ ** The received frames are handled by the task calling
+ ** ciaaDriverEth_wait and ciaaDriverEth_mainFunction in a loop. The task
+ ** sleeps until the ETH interrupt signals a received or sent frame, the
+ ** lwIP timers shall wake it up with an alarm setting the POSIXE event.
+ **
  **/
 
 /** \addtogroup CIAA_Firmware CIAA Firmware
@@ -47,7 +52,10 @@
 /*==================[inclusions]=============================================*/
 #ifdef CIAA_CFG_NET_IP
 #include "ciaaDriverEth.h"
+#include "ciaaDriverEthRingHw.h"
+#include "ciaak_trace.h"
 #include "chip.h"
+#include "os.h"
 
 /** from LWIP */
 #include "lpc_phy.h"
@@ -60,6 +68,13 @@
 
 
 /*==================[macros and definitions]=================================*/
+/** \brief period of the PHY status poll in ms */
+#ifndef CIAADRVETH_PHY_PERIOD
+#define CIAADRVETH_PHY_PERIOD       500
+#endif
+
+/** \brief task id value when no task is waiting */
+#define CIAADRVETH_NO_TASK          255
 
 /*==================[internal data declaration]==============================*/
 /* NETIF data */
@@ -68,6 +83,12 @@ static struct netif lpc_netif;
 static uint32_t physts;
 static ip_addr_t ipaddr, netmask, gw;
 
+/** \brief time of the last PHY status poll */
+static uint32_t phyPollTime;
+
+/** \brief task handling the frames, woken up by the ETH interrupt */
+static TaskType ethTaskID = CIAADRVETH_NO_TASK;
+
 static const PINMUX_GRP_T pinmuxing[] = {
    /* RMII pin group */
    {0x7, 7, MD_EHS | MD_PLN | MD_EZI | MD_ZI |FUNC6},
@@ -134,18 +155,26 @@ void ciaaDriverEth_init(void)
 #endif
 }
 
-void ciaaDriverEth_mainFunction(void)
+void ciaaDriverEth_wait(void)
 {
-   /* Handle packets as part of this loop, not in the IRQ handler */
-   lpc_enetif_input(&lpc_netif);
-
-   /* lpc_rx_queue will re-qeueu receive buffers. This normally occurs
-      automatically, but in systems were memory is constrained, pbufs
-      may not always be able to get allocated, so this function can be
-      optionally enabled to re-queue receive buffers. */
-#if 0
-   while (lpc_rx_queue(&lpc_netif)) {}
+   /* the interrupt wakes up the last task which waited */
+   GetTaskID(&ethTaskID);
+
+#ifdef POSIXE
+   /* an event set while the frames were handled is not lost */
+   WaitEvent(POSIXE);
+   ClearEvent(POSIXE);
 #endif
+}
+
+void ciaaDriverEth_mainFunction(void)
+{
+   uint32_t now;
+
+   /* Handle all received packets as part of this loop, not in the IRQ
+    * handler. The pbufs released by lwIP are queued again to the RX
+    * descriptors */
+   while (0 != lpc_enetif_input(&lpc_netif)) {}
 
    /* Free TX buffers that are done sending */
    lpc_tx_reclaim(&lpc_netif);
@@ -155,7 +184,16 @@ void ciaaDriverEth_mainFunction(void)
 
    /* Call the PHY status update state machine once in a while
       to keep the link status up-to-date */
-   physts = lpcPHYStsPoll();
+   now = sys_now();
+   if ((now - phyPollTime) < CIAADRVETH_PHY_PERIOD) {
+      return;
+   }
+   phyPollTime = now;
+
+   /* the poll takes a few MII transfers of some microseconds */
+   do {
+      physts = lpcPHYStsPoll();
+   } while (physts & PHY_LINK_BUSY);
 
    /* Only check for connection state when the PHY status has changed */
    if (physts & PHY_LINK_CHANGED) {
@@ -184,7 +222,35 @@ void ciaaDriverEth_mainFunction(void)
    }
 
 }
+
+extern void ciaaDriverEthRingHw_pollDemand(void * hw)
+{
+   /* hw is the poll demand register of the RX or TX DMA, any value written
+    * restarts the DMA */
+   *(uint32_t volatile *)hw = 1;
+} /* end ciaaDriverEthRingHw_pollDemand */
+
 /*==================[interrupt handlers]=====================================*/
+/** \brief Ethernet DMA interrupt handler
+ **
+ ** Acknowledges the interrupts and wakes up the task handling the frames.
+ **/
+ISR(ETH_IRQHandler)
+{
+   ciaak_traceIsrEnter(ETHERNET_IRQn);
+
+   /* clear the pending interrupts */
+   LPC_ETHERNET->DMA_STAT = LPC_ETHERNET->DMA_STAT & DMA_ST_ALL;
+
+#ifdef POSIXE
+   if (CIAADRVETH_NO_TASK != ethTaskID)
+   {
+      SetEvent(ethTaskID, POSIXE);
+   }
+#endif
+
+   ciaak_traceIsrExit(ETHERNET_IRQn);
+}
 
 #else /* #ifdef CIAA_CFG_NET_IP */
 /* some C compilers may have problems by compiling an empty file, this is not
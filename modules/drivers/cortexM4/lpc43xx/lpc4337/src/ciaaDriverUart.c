@@ -47,8 +47,11 @@
 
 /*==================[inclusions]=============================================*/
 #include "ciaaDriverUart.h"
+#include "ciaaDriverUartDma.h"
+#include "ciaaDriverUartDmaHw.h"
 #include "ciaaPOSIX_stdlib.h"
 #include "ciaaPOSIX_stdio.h"
+#include "ciaak_trace.h"
 #include "chip.h"
 #include "os.h"
 
@@ -61,9 +64,27 @@ typedef struct  {
 
 #define UART_RX_FIFO_SIZE       (16)
 
+/** \brief FIFO configuration in DMA mode
+ **
+ ** The RX trigger level of 8 characters leaves another 8 characters of
+ ** room in the FIFO while a full receive region is rearmed.
+ **/
+#define UART_FCR_DMA            (UART_FCR_DMAMODE_SEL | UART_FCR_TRG_LEV2)
+
+/** \brief Mask of the transfer count field of a GPDMA channel control */
+#define UART_DMA_COUNT_MASK     (0xFFF)
+
 typedef struct {
    uint8_t hwbuf[UART_RX_FIFO_SIZE];
    uint8_t rxcnt;
+   uint8_t mode;                    /** <= ciaaSERIAL_TRANSFER_IRQ or _DMA */
+   uint8_t rxConn;                  /** <= GPDMA connection of the receiver */
+   uint8_t txConn;                  /** <= GPDMA connection of the transmitter */
+   uint8_t rxChannel;               /** <= GPDMA channel of the receiver */
+   uint8_t txChannel;               /** <= GPDMA channel of the transmitter */
+   bool dmaAllocated;               /** <= GPDMA channels already allocated */
+   uint32_t rxSize;                 /** <= size of the armed receive region */
+   ciaaDriverUartDma_type dma;      /** <= DMA transfers bookkeeping */
 } ciaaDriverUartControl;
 
 /*==================[internal data declaration]==============================*/
@@ -143,6 +164,132 @@ static void ciaaDriverUart_txConfirmation(ciaaDevices_deviceType const * const d
    ciaaSerialDevices_txConfirmation(device->upLayer, 1 );
 }
 
+/** \brief Masks the interrupts of a GPDMA channel
+ **
+ ** The UART DMA transfers are supervised with the UART interrupt, the
+ ** GPDMA interrupt belongs to the Aio driver.
+ **/
+static void ciaaDriverUart_dmaMaskInt(uint8_t const channel)
+{
+   LPC_GPDMA->CH[channel].CONFIG &= ~(GPDMA_DMACCxConfig_IE | GPDMA_DMACCxConfig_ITC);
+   Chip_GPDMA_ClearIntPending(LPC_GPDMA, GPDMA_STATCLR_INTTC, channel);
+   Chip_GPDMA_ClearIntPending(LPC_GPDMA, GPDMA_STATCLR_INTERR, channel);
+}
+
+static int32_t ciaaDriverUart_setTransferMode(ciaaDevices_deviceType const * const device, uint8_t const mode)
+{
+   int32_t ret = 0;
+   ciaaDriverUartControl * pUartControl = (ciaaDriverUartControl *)device->layer;
+   LPC_USART_T * uart = (LPC_USART_T *)device->loLayer;
+
+   if(mode == pUartControl->mode)
+   {
+      /* nothing to do */
+   }
+   else if(ciaaSERIAL_TRANSFER_DMA == mode)
+   {
+      if(false == pUartControl->dmaAllocated)
+      {
+         /* the GPDMA has been initialized by the Aio driver */
+         pUartControl->rxChannel = Chip_GPDMA_GetFreeChannel(LPC_GPDMA, pUartControl->rxConn);
+         pUartControl->txChannel = Chip_GPDMA_GetFreeChannel(LPC_GPDMA, pUartControl->txConn);
+         pUartControl->dmaAllocated = true;
+      }
+
+      Chip_UART_IntDisable(uart, UART_IER_THREINT | UART_IER_RBRINT);
+
+      /* forward the bytes received in interrupt mode */
+      if(pUartControl->rxcnt != 0)
+      {
+         ciaaDriverUart_rxIndication(device, pUartControl->rxcnt);
+      }
+
+      pUartControl->mode = ciaaSERIAL_TRANSFER_DMA;
+      Chip_UART_SetupFIFOS(uart, UART_FCR_FIFO_EN | UART_FCR_DMA);
+
+      /* arm the receiver on the free space of the upper layer buffer */
+      ciaaDriverUartDma_rxStart(&pUartControl->dma);
+      ciaaDriverUart_rxIndication(device, 0);
+
+      /* the rx interrupt reports idle lines and full receive regions */
+      Chip_UART_IntEnable(uart, UART_IER_RBRINT);
+
+      /* continue a pending transmission */
+      ciaaDriverUart_txConfirmation(device);
+      if(ciaaDriverUartDma_txActive(&pUartControl->dma))
+      {
+         Chip_UART_IntEnable(uart, UART_IER_THREINT);
+      }
+   }
+   else if(ciaaSERIAL_TRANSFER_IRQ == mode)
+   {
+      if(ciaaDriverUartDma_txActive(&pUartControl->dma))
+      {
+         /* the ongoing transmission owns part of the upper layer buffer */
+         ret = -1;
+      }
+      else
+      {
+         Chip_UART_IntDisable(uart, UART_IER_THREINT | UART_IER_RBRINT);
+
+         /* forward the bytes already received and do not rearm */
+         ciaaDriverUartDma_rxStop(&pUartControl->dma);
+         ciaaDriverUart_rxIndication(device, 0);
+
+         pUartControl->mode = ciaaSERIAL_TRANSFER_IRQ;
+         Chip_UART_SetupFIFOS(uart, UART_FCR_FIFO_EN | UART_FCR_TRG_LEV0);
+
+         Chip_UART_IntEnable(uart, UART_IER_RBRINT);
+      }
+   }
+   else
+   {
+      ret = -1;
+   }
+
+   return ret;
+}
+
+/** \brief Handles the UART interrupt in DMA mode */
+static void ciaaDriverUart_dmaIRQHandler(ciaaDevices_deviceType const * const device)
+{
+   ciaaDriverUartControl * pUartControl = (ciaaDriverUartControl *)device->layer;
+   LPC_USART_T * uart = (LPC_USART_T *)device->loLayer;
+
+   /* acknowledge the THRE interrupt, RDA and CTI are cleared by the DMA */
+   Chip_UART_ReadIntIDReg(uart);
+
+   /* the region is full or the line is idle: let the DMA empty the FIFO
+    * before the received bytes are counted */
+   while((Chip_UART_ReadLineStatus(uart) & UART_LSR_RDR) &&
+         (SET == Chip_GPDMA_IntGetStatus(LPC_GPDMA, GPDMA_STAT_ENABLED_CH, pUartControl->rxChannel)))
+   {
+   }
+   /* forward the received bytes and rearm the receiver */
+   ciaaDriverUart_rxIndication(device, 0);
+
+   if(false == ciaaDriverUartDma_rxActive(&pUartControl->dma))
+   {
+      /* the upper layer buffer is full, the bytes are lost */
+      while(Chip_UART_ReadLineStatus(uart) & UART_LSR_RDR)
+      {
+         Chip_UART_ReadByte(uart);
+      }
+   }
+
+   if((Chip_UART_ReadLineStatus(uart) & UART_LSR_THRE) &&
+      (Chip_UART_GetIntsEnabled(uart) & UART_IER_THREINT))
+   {
+      /* confirm the transmitted region and start the next one */
+      ciaaDriverUart_txConfirmation(device);
+
+      if(false == ciaaDriverUartDma_txActive(&pUartControl->dma))
+      {  /* There is not more bytes to send, disable THRE irq */
+         Chip_UART_IntDisable(uart, UART_IER_THREINT);
+      }
+   }
+}
+
 static void ciaaDriverUart_hwInit(void)
 {
    /* UART0 (RS485/Profibus) */
@@ -181,13 +328,24 @@ static void ciaaDriverUart_hwInit(void)
 
    Chip_SCU_PinMux(2, 3, MD_PDN, FUNC2);              /* P2_3: UART3_TXD */
    Chip_SCU_PinMux(2, 4, MD_PLN|MD_EZI|MD_ZI, FUNC2); /* P2_4: UART3_RXD */
+
+   /* GPDMA connections */
+   uartControl[0].rxConn = GPDMA_CONN_UART0_Rx;
+   uartControl[0].txConn = GPDMA_CONN_UART0_Tx;
+   uartControl[1].rxConn = GPDMA_CONN_UART2_Rx;
+   uartControl[1].txConn = GPDMA_CONN_UART2_Tx;
+   uartControl[2].rxConn = GPDMA_CONN_UART3_Rx;
+   uartControl[2].txConn = GPDMA_CONN_UART3_Tx;
 }
 
 /*==================[external functions definition]==========================*/
 extern ciaaDevices_deviceType * ciaaDriverUart_open(char const * path, ciaaDevices_deviceType * device, uint8_t const oflag)
 {
+   ciaaDriverUartControl * pUartControl = (ciaaDriverUartControl *)device->layer;
+
    /* Restart FIFOS: set Enable, Reset content, set trigger level */
-   Chip_UART_SetupFIFOS((LPC_USART_T *)device->loLayer, UART_FCR_FIFO_EN | UART_FCR_TX_RS | UART_FCR_RX_RS | UART_FCR_TRG_LEV0);
+   Chip_UART_SetupFIFOS((LPC_USART_T *)device->loLayer, UART_FCR_FIFO_EN | UART_FCR_TX_RS | UART_FCR_RX_RS |
+         ((ciaaSERIAL_TRANSFER_DMA == pUartControl->mode) ? UART_FCR_DMA : UART_FCR_TRG_LEV0));
    /* dummy read */
    Chip_UART_ReadByte((LPC_USART_T *)device->loLayer);
    /* enable rx interrupt */
@@ -218,8 +376,12 @@ extern int32_t ciaaDriverUart_ioctl(ciaaDevices_deviceType const * const device,
             Chip_UART_IntDisable((LPC_USART_T *)device->loLayer, UART_IER_THREINT);
             /* this one calls write */
             ciaaDriverUart_txConfirmation(device);
-            /* enable THRE irq (TX) */
-            Chip_UART_IntEnable((LPC_USART_T *)device->loLayer, UART_IER_THREINT);
+            if((ciaaSERIAL_TRANSFER_IRQ == ((ciaaDriverUartControl *)device->layer)->mode) ||
+               ciaaDriverUartDma_txActive(&((ciaaDriverUartControl *)device->layer)->dma))
+            {
+               /* enable THRE irq (TX) */
+               Chip_UART_IntEnable((LPC_USART_T *)device->loLayer, UART_IER_THREINT);
+            }
             ret = 0;
             break;
 
@@ -228,7 +390,8 @@ extern int32_t ciaaDriverUart_ioctl(ciaaDevices_deviceType const * const device,
             break;
 
          case ciaaPOSIX_IOCTL_SET_FIFO_TRIGGER_LEVEL:
-            Chip_UART_SetupFIFOS((LPC_USART_T *)device->loLayer,  UART_FCR_FIFO_EN | UART_FCR_TX_RS | UART_FCR_RX_RS | (int32_t)param);
+            Chip_UART_SetupFIFOS((LPC_USART_T *)device->loLayer,  UART_FCR_FIFO_EN | UART_FCR_TX_RS | UART_FCR_RX_RS | (int32_t)param |
+                  ((ciaaSERIAL_TRANSFER_DMA == ((ciaaDriverUartControl *)device->layer)->mode) ? UART_FCR_DMAMODE_SEL : 0));
             break;
 
          case ciaaPOSIX_IOCTL_SET_ENABLE_TX_INTERRUPT:
@@ -256,6 +419,10 @@ extern int32_t ciaaDriverUart_ioctl(ciaaDevices_deviceType const * const device,
                Chip_UART_IntEnable((LPC_USART_T *)device->loLayer, UART_IER_RBRINT);
             }
             break;
+
+         case ciaaPOSIX_IOCTL_SET_TRANSFER_MODE:
+            ret = ciaaDriverUart_setTransferMode(device, (uint8_t)(intptr_t)param);
+            break;
       }
    }
    return ret;
@@ -275,28 +442,36 @@ extern ssize_t ciaaDriverUart_read(ciaaDevices_deviceType const * const device,
       {
          pUartControl = (ciaaDriverUartControl *)device->layer;
 
-         if(size > pUartControl->rxcnt)
+         if(ciaaSERIAL_TRANSFER_DMA == pUartControl->mode)
          {
-            /* buffer has enough space */
-            ret = pUartControl->rxcnt;
-            pUartControl->rxcnt = 0;
+            /* the DMA receives straight into the upper layer buffer */
+            ret = ciaaDriverUartDma_read(&pUartControl->dma, buffer, size);
          }
          else
          {
-            /* buffer hasn't enough space */
-            ret = size;
-            pUartControl->rxcnt -= size;
-         }
-         for(i = 0; i < ret; i++)
-         {
-            buffer[i] = pUartControl->hwbuf[i];
-         }
-         if(pUartControl->rxcnt != 0)
-         {
-            /* We removed data from the buffer, it is time to reorder it */
-            for(i = 0; i < pUartControl->rxcnt ; i++)
+            if(size > pUartControl->rxcnt)
+            {
+               /* buffer has enough space */
+               ret = pUartControl->rxcnt;
+               pUartControl->rxcnt = 0;
+            }
+            else
+            {
+               /* buffer hasn't enough space */
+               ret = size;
+               pUartControl->rxcnt -= size;
+            }
+            for(i = 0; i < ret; i++)
             {
-               pUartControl->hwbuf[i] = pUartControl->hwbuf[i + ret];
+               buffer[i] = pUartControl->hwbuf[i];
+            }
+            if(pUartControl->rxcnt != 0)
+            {
+               /* We removed data from the buffer, it is time to reorder it */
+               for(i = 0; i < pUartControl->rxcnt ; i++)
+               {
+                  pUartControl->hwbuf[i] = pUartControl->hwbuf[i + ret];
+               }
             }
          }
       }
@@ -312,12 +487,20 @@ extern ssize_t ciaaDriverUart_write(ciaaDevices_deviceType const * const device,
       (device == ciaaDriverUartConst.devices[1]) ||
       (device == ciaaDriverUartConst.devices[2]) )
    {
-      while((Chip_UART_ReadLineStatus((LPC_USART_T *)device->loLayer) & UART_LSR_THRE) && (ret < size))
+      if(ciaaSERIAL_TRANSFER_DMA == ((ciaaDriverUartControl *)device->layer)->mode)
+      {
+         /* the DMA transmits straight from the upper layer buffer */
+         ret = ciaaDriverUartDma_write(&((ciaaDriverUartControl *)device->layer)->dma, buffer, size);
+      }
+      else
       {
-         /* send first byte */
-         Chip_UART_SendByte((LPC_USART_T *)device->loLayer, buffer[ret]);
-         /* bytes written */
-         ret++;
+         while((Chip_UART_ReadLineStatus((LPC_USART_T *)device->loLayer) & UART_LSR_THRE) && (ret < size))
+         {
+            /* send first byte */
+            Chip_UART_SendByte((LPC_USART_T *)device->loLayer, buffer[ret]);
+            /* bytes written */
+            ret++;
+         }
       }
    }
    return ret;
@@ -330,6 +513,11 @@ void ciaaDriverUart_init(void)
    /* init hardware */
    ciaaDriverUart_hwInit();
 
+   for(loopi = 0; loopi < ciaaDriverUartConst.countOfDevices; loopi++) {
+      /* the DMA hardware functions get the device */
+      ciaaDriverUartDma_init(&uartControl[loopi].dma, ciaaDriverUartConst.devices[loopi]);
+   }
+
    /* add uart driver to the list of devices */
    for(loopi = 0; loopi < ciaaDriverUartConst.countOfDevices; loopi++) {
       /* add each device */
@@ -337,10 +525,72 @@ void ciaaDriverUart_init(void)
    }
 }
 
+extern void ciaaDriverUartDmaHw_rxStart(void * hw, uint8_t * buffer, uint32_t size)
+{
+   ciaaDevices_deviceType const * device = (ciaaDevices_deviceType const *)hw;
+   ciaaDriverUartControl * pUartControl = (ciaaDriverUartControl *)device->layer;
+
+   pUartControl->rxSize = size;
+   Chip_GPDMA_Transfer(LPC_GPDMA, pUartControl->rxChannel, pUartControl->rxConn,
+         (uint32_t)buffer, GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA, size);
+   ciaaDriverUart_dmaMaskInt(pUartControl->rxChannel);
+}
+
+extern void ciaaDriverUartDmaHw_rxStop(void * hw)
+{
+   ciaaDevices_deviceType const * device = (ciaaDevices_deviceType const *)hw;
+   ciaaDriverUartControl * pUartControl = (ciaaDriverUartControl *)device->layer;
+
+   /* halt the channel and wait for the ongoing transfer, keeping the
+    * transfer count and the channel allocation */
+   LPC_GPDMA->CH[pUartControl->rxChannel].CONFIG |= GPDMA_DMACCxConfig_H;
+   while(LPC_GPDMA->CH[pUartControl->rxChannel].CONFIG & GPDMA_DMACCxConfig_A)
+   {
+   }
+   Chip_GPDMA_ChannelCmd(LPC_GPDMA, pUartControl->rxChannel, DISABLE);
+   LPC_GPDMA->CH[pUartControl->rxChannel].CONFIG &= ~GPDMA_DMACCxConfig_H;
+}
+
+extern uint32_t ciaaDriverUartDmaHw_rxCount(void * hw)
+{
+   ciaaDevices_deviceType const * device = (ciaaDevices_deviceType const *)hw;
+   ciaaDriverUartControl * pUartControl = (ciaaDriverUartControl *)device->layer;
+
+   return pUartControl->rxSize -
+      (LPC_GPDMA->CH[pUartControl->rxChannel].CONTROL & UART_DMA_COUNT_MASK);
+}
+
+extern void ciaaDriverUartDmaHw_txStart(void * hw, uint8_t const * buffer, uint32_t size)
+{
+   ciaaDevices_deviceType const * device = (ciaaDevices_deviceType const *)hw;
+   ciaaDriverUartControl * pUartControl = (ciaaDriverUartControl *)device->layer;
+
+   Chip_GPDMA_Transfer(LPC_GPDMA, pUartControl->txChannel, (uint32_t)buffer,
+         pUartControl->txConn, GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA, size);
+   ciaaDriverUart_dmaMaskInt(pUartControl->txChannel);
+}
+
+extern bool ciaaDriverUartDmaHw_txBusy(void * hw)
+{
+   ciaaDevices_deviceType const * device = (ciaaDevices_deviceType const *)hw;
+   ciaaDriverUartControl * pUartControl = (ciaaDriverUartControl *)device->layer;
+
+   return SET == Chip_GPDMA_IntGetStatus(LPC_GPDMA, GPDMA_STAT_ENABLED_CH, pUartControl->txChannel);
+}
+
 /*==================[interrupt handlers]=====================================*/
 ISR(UART0_IRQHandler)
 {
-   uint8_t status = Chip_UART_ReadLineStatus(LPC_USART0);
+   uint8_t status;
+
+   ciaak_traceIsrEnter(USART0_IRQn);
+   status = Chip_UART_ReadLineStatus(LPC_USART0);
+
+   if(ciaaSERIAL_TRANSFER_DMA == uartControl[0].mode)
+   {
+      ciaaDriverUart_dmaIRQHandler(&ciaaDriverUart_device0);
+      status = 0;
+   }
 
    if(status & UART_LSR_RDR)
    {
@@ -363,11 +613,22 @@ ISR(UART0_IRQHandler)
          Chip_UART_IntDisable(LPC_USART0, UART_IER_THREINT);
       }
    }
+
+   ciaak_traceIsrExit(USART0_IRQn);
 }
 
 ISR(UART2_IRQHandler)
 {
-   uint8_t status = Chip_UART_ReadLineStatus(LPC_USART2);
+   uint8_t status;
+
+   ciaak_traceIsrEnter(USART2_IRQn);
+   status = Chip_UART_ReadLineStatus(LPC_USART2);
+
+   if(ciaaSERIAL_TRANSFER_DMA == uartControl[1].mode)
+   {
+      ciaaDriverUart_dmaIRQHandler(&ciaaDriverUart_device1);
+      status = 0;
+   }
 
    if(status & UART_LSR_RDR)
    {
@@ -390,11 +651,22 @@ ISR(UART2_IRQHandler)
          Chip_UART_IntDisable(LPC_USART2, UART_IER_THREINT);
       }
    }
+
+   ciaak_traceIsrExit(USART2_IRQn);
 }
 
 ISR(UART3_IRQHandler)
 {
-   uint8_t status = Chip_UART_ReadLineStatus(LPC_USART3);
+   uint8_t status;
+
+   ciaak_traceIsrEnter(USART3_IRQn);
+   status = Chip_UART_ReadLineStatus(LPC_USART3);
+
+   if(ciaaSERIAL_TRANSFER_DMA == uartControl[2].mode)
+   {
+      ciaaDriverUart_dmaIRQHandler(&ciaaDriverUart_device2);
+      status = 0;
+   }
 
    if(status & UART_LSR_RDR)
    {
@@ -417,6 +689,8 @@ ISR(UART3_IRQHandler)
          Chip_UART_IntDisable(LPC_USART3, UART_IER_THREINT);
       }
    }
+
+   ciaak_traceIsrExit(USART3_IRQn);
 }
 
 /** @} doxygen end group definition */
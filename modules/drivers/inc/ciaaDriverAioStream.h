@@ -0,0 +1,148 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef _CIAADRIVERAIOSTREAM_H_
+#define _CIAADRIVERAIOSTREAM_H_
+/** \brief CIAA Aio sample stream header file
+ **
+ ** Platform independent ring of sample blocks of the continuous
+ ** acquisition of the aio drivers. The DMA of the platform driver fills
+ ** the blocks in place, the readers get the filled blocks by reference
+ ** and release them once processed.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup AIO AIO Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+#include "ciaaPOSIX_stddef.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief count of blocks being filled at the same time (ping-pong) */
+#define CIAADRVAIOSTREAM_IN_FLIGHT     2
+
+/*==================[typedef]================================================*/
+/** \brief ring of sample blocks */
+typedef struct {
+   uint32_t * buffer;               /** <= storage of blockCount + 1 blocks */
+   uint32_t * timestamps;           /** <= storage of blockCount timestamps */
+   uint32_t blockSize;              /** <= samples per block */
+   uint32_t blockCount;             /** <= blocks of the ring, a power of 2 */
+   volatile uint32_t head;          /** <= count of filled blocks */
+   volatile uint32_t tail;          /** <= count of released blocks */
+   uint32_t reserved;               /** <= count of blocks given to the DMA */
+   uint32_t inFlight[CIAADRVAIOSTREAM_IN_FLIGHT]; /** <= blocks being filled */
+   uint8_t inFlightCount;           /** <= count of blocks being filled */
+   volatile uint32_t overruns;      /** <= count of blocks lost */
+} ciaaDriverAioStream_type;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize an empty ring of sample blocks
+ **
+ ** The block after the last one of the ring is the overrun block, it is
+ ** filled by the DMA when all blocks of the ring wait for the readers.
+ **
+ ** \param[out] stream      ring to be initialized
+ ** \param[in]  buffer      storage of (blockCount + 1) * blockSize samples
+ ** \param[in]  timestamps  storage of blockCount timestamps
+ ** \param[in]  blockSize   samples per block
+ ** \param[in]  blockCount  blocks of the ring, shall be a power of 2
+ **/
+extern void ciaaDriverAioStream_init(ciaaDriverAioStream_type * stream,
+      uint32_t * buffer, uint32_t * timestamps, uint32_t blockSize,
+      uint32_t blockCount);
+
+/** \brief reserve the next block to be filled by the DMA
+ **
+ ** \param[inout] stream  ring of sample blocks
+ ** \return       block to be filled, the overrun block if the ring is full
+ **               or NULL if CIAADRVAIOSTREAM_IN_FLIGHT blocks are reserved
+ **/
+extern uint32_t * ciaaDriverAioStream_fill(ciaaDriverAioStream_type * stream);
+
+/** \brief indicates that the oldest reserved block has been filled
+ **
+ ** \param[inout] stream     ring of sample blocks
+ ** \param[in]    timestamp  time of the end of the block
+ ** \return       filled block handed to the readers, NULL if it was the
+ **               overrun block and the samples are lost
+ **/
+extern uint32_t * ciaaDriverAioStream_filled(ciaaDriverAioStream_type * stream,
+      uint32_t timestamp);
+
+/** \brief get the oldest filled block
+ **
+ ** The block stays valid until it is released.
+ **
+ ** \param[inout] stream     ring of sample blocks
+ ** \param[out]   samples    samples of the block
+ ** \param[out]   timestamp  time of the end of the block
+ ** \return       true if a block is available
+ **/
+extern bool ciaaDriverAioStream_get(ciaaDriverAioStream_type * stream,
+      uint32_t const ** samples, uint32_t * timestamp);
+
+/** \brief release the oldest filled block
+ **
+ ** \param[inout] stream  ring of sample blocks
+ ** \return       true if a block has been released
+ **/
+extern bool ciaaDriverAioStream_release(ciaaDriverAioStream_type * stream);
+
+/** \brief returns the count of blocks lost since the initialization */
+extern uint32_t ciaaDriverAioStream_overruns(ciaaDriverAioStream_type const * stream);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAADRIVERAIOSTREAM_H_ */
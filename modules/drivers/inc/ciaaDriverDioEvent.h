@@ -0,0 +1,153 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef _CIAADRIVERDIOEVENT_H_
+#define _CIAADRIVERDIOEVENT_H_
+/** \brief CIAA Dio edge events header file
+ **
+ ** Platform independent debounce of the inputs and queue of their edge
+ ** events. The platform driver samples the inputs on each pin interrupt
+ ** and periodically while some input is not stable, the readers get the
+ ** queued events.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup DIO DIO Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_ioctl_dio.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief maximal count of inputs */
+#define CIAADRVDIOEVENT_MAX_INPUTS     32
+
+/*==================[typedef]================================================*/
+/** \brief debounce and edge events of the inputs of a device */
+typedef struct {
+   ciaaPOSIX_dioEventType * events; /** <= storage of the queue */
+   uint32_t size;                   /** <= events of the queue, a power of 2 */
+   volatile uint32_t head;          /** <= count of queued events */
+   volatile uint32_t tail;          /** <= count of read events */
+   volatile uint32_t overruns;      /** <= count of events lost */
+   uint32_t enabled;                /** <= inputs generating events */
+   uint32_t state;                  /** <= debounced state of the inputs */
+   uint32_t settling;               /** <= inputs not stable */
+   uint32_t edgeTime[CIAADRVDIOEVENT_MAX_INPUTS];  /** <= time of the first
+                                                     **    edge while settling */
+   uint8_t samples[CIAADRVDIOEVENT_MAX_INPUTS];    /** <= samples to change
+                                                     **    the state, 0 none */
+   uint8_t counters[CIAADRVDIOEVENT_MAX_INPUTS];   /** <= integrators */
+} ciaaDriverDioEvent_type;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize the events of a device without debounce
+ **
+ ** \param[out] event   events to be initialized
+ ** \param[in]  events  storage of the queue
+ ** \param[in]  size    events of the queue, shall be a power of 2
+ ** \param[in]  state   current state of the inputs
+ **/
+extern void ciaaDriverDioEvent_init(ciaaDriverDioEvent_type * event,
+      ciaaPOSIX_dioEventType * events, uint32_t size, uint32_t state);
+
+/** \brief configure the debounce of some inputs
+ **
+ ** The integrators of the inputs are reset to their debounced state.
+ **
+ ** \param[inout] event   events of the device
+ ** \param[in]    inputs  mask of the inputs
+ ** \param[in]    samples samples to change the state, 0 to disable
+ **/
+extern void ciaaDriverDioEvent_setDebounce(ciaaDriverDioEvent_type * event,
+      uint32_t inputs, uint8_t samples);
+
+/** \brief select the inputs generating events
+ **
+ ** The queued events are discarded.
+ **
+ ** \param[inout] event   events of the device
+ ** \param[in]    inputs  mask of the inputs, 0 to disable the events
+ **/
+extern void ciaaDriverDioEvent_enable(ciaaDriverDioEvent_type * event,
+      uint32_t inputs);
+
+/** \brief sample the inputs
+ **
+ ** Shall be called from the pin interrupt and periodically while inputs
+ ** are settling. The inputs not stable are only visited.
+ **
+ ** \param[inout] event      events of the device
+ ** \param[in]    state      raw state of the inputs, the bit n is input n
+ ** \param[in]    timestamp  time of the sample in microseconds
+ ** \return       mask of the inputs still settling, the driver shall keep
+ **               sampling while it is not 0
+ **/
+extern uint32_t ciaaDriverDioEvent_sample(ciaaDriverDioEvent_type * event,
+      uint32_t state, uint32_t timestamp);
+
+/** \brief returns the count of queued events */
+extern uint32_t ciaaDriverDioEvent_count(ciaaDriverDioEvent_type const * event);
+
+/** \brief get the oldest queued events
+ **
+ ** \param[inout] event   events of the device
+ ** \param[out]   events  buffer for the events
+ ** \param[in]    count   maximal count of events to get
+ ** \return       count of events got
+ **/
+extern uint32_t ciaaDriverDioEvent_get(ciaaDriverDioEvent_type * event,
+      ciaaPOSIX_dioEventType * events, uint32_t count);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAADRIVERDIOEVENT_H_ */
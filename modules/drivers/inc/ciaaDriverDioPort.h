@@ -0,0 +1,145 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef _CIAADRIVERDIOPORT_H_
+#define _CIAADRIVERDIOPORT_H_
+/** \brief CIAA Dio port access header file
+ **
+ ** Platform independent mapping between the managed pins of a dio device,
+ ** the bit n is the pin n of the board pin table, and the registers of the
+ ** gpio ports. The table built from the board pin table allows to read or
+ ** write all the pins with one register access per gpio port.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup DIO DIO Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief maximal count of managed pins of a table */
+#define CIAADRVDIOPORT_MAX_PINS        32
+
+/** \brief maximal count of gpio ports of a table */
+#define CIAADRVDIOPORT_MAX_PORTS       8
+
+/*==================[typedef]================================================*/
+/** \brief pin of the board pin table */
+typedef struct {
+   uint32_t port;                   /** <= gpio port */
+   uint32_t pin;                    /** <= pin in the gpio port */
+} ciaaDriverDioPort_pinType;
+
+/** \brief pins of a port moved by the same shift */
+typedef struct {
+   uint32_t mask;                   /** <= pins of the run in the port */
+   int32_t shift;                   /** <= port bit - pin number, the bits
+                                      **    are moved right if positive */
+} ciaaDriverDioPort_runType;
+
+/** \brief managed pins of a gpio port */
+typedef struct {
+   uint32_t port;                   /** <= gpio port */
+   uint32_t mask;                   /** <= managed pins of the port */
+   uint8_t first;                   /** <= first run of the port */
+   uint8_t count;                   /** <= count of runs of the port */
+   bool ordered;                    /** <= the pins follow the port bits,
+                                      **    bits extract/deposit can be used */
+   uint8_t lowest;                  /** <= lowest pin number of the port */
+} ciaaDriverDioPort_portType;
+
+/** \brief mask and shift table of the managed pins */
+typedef struct {
+   uint8_t pinCount;                /** <= count of managed pins */
+   uint8_t portCount;               /** <= count of gpio ports */
+   ciaaDriverDioPort_portType ports[CIAADRVDIOPORT_MAX_PORTS];
+   ciaaDriverDioPort_runType runs[CIAADRVDIOPORT_MAX_PINS];
+} ciaaDriverDioPort_tableType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief build the mask and shift table of a board pin table
+ **
+ ** \param[out] table  table to be built
+ ** \param[in]  pins   board pin table, the entry n is the pin n
+ ** \param[in]  count  count of entries of the board pin table
+ ** \return     -1 if the pins do not fit in CIAADRVDIOPORT_MAX_PINS pins
+ **             or in CIAADRVDIOPORT_MAX_PORTS ports, 0 if success
+ **/
+extern int32_t ciaaDriverDioPort_init(ciaaDriverDioPort_tableType * table,
+      ciaaDriverDioPort_pinType const * pins, uint32_t count);
+
+/** \brief gather the managed pins of a port register
+ **
+ ** \param[in] table  mask and shift table
+ ** \param[in] index  index of the port in the table
+ ** \param[in] value  value of the port register
+ ** \return    state of the managed pins of the port, the bit n is the pin n
+ **/
+extern uint32_t ciaaDriverDioPort_gather(ciaaDriverDioPort_tableType const * table,
+      uint32_t index, uint32_t value);
+
+/** \brief scatter the state of the pins in a port register
+ **
+ ** \param[in] table  mask and shift table
+ ** \param[in] index  index of the port in the table
+ ** \param[in] state  state of the pins, the bit n is the pin n
+ ** \return    bits of the port register of the managed pins of the port,
+ **            the bits of the other pins are 0
+ **/
+extern uint32_t ciaaDriverDioPort_scatter(ciaaDriverDioPort_tableType const * table,
+      uint32_t index, uint32_t state);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAADRIVERDIOPORT_H_ */
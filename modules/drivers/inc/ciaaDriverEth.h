@@ -67,8 +67,21 @@ extern "C" {
 extern void ciaaDriverEth_init(void);
 
 /** \brief main function of the ethernet driver
+ **
+ ** Handles all the received frames, the lwIP timers and the link status.
  **/
 extern void ciaaDriverEth_mainFunction(void);
+
+/** \brief waits for ethernet activity
+ **
+ ** Blocks the calling task until a frame has been received or sent. The
+ ** task shall be EXTENDED with the POSIXE event and be called periodically
+ ** by an alarm setting POSIXE to serve the lwIP timers. The ETH interrupt
+ ** handler ETH_IRQHandler has to be declared in the OIL file.
+ **
+ ** Returns immediately on platforms without ethernet interrupt.
+ **/
+extern void ciaaDriverEth_wait(void);
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
 }
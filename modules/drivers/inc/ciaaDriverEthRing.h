@@ -0,0 +1,209 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _CIAADRIVERETHRING_H_
+#define _CIAADRIVERETHRING_H_
+/** \brief CIAA Ethernet descriptor ring header file
+ **
+ ** Platform independent bookkeeping of the DMA descriptors of an ethernet
+ ** MAC and of a pool of receive buffers. The descriptors are the enhanced
+ ** descriptors of the Synopsys MAC of the LPC18xx/43xx: 8 words, the first
+ ** one holds the status and the own bit, the second one the control and
+ ** buffer size and the third one the buffer address. The fourth word, the
+ ** address of the next descriptor, is set once by the platform driver and
+ ** not changed here.
+ **
+ ** The descriptors are given to the DMA in order and taken back in the
+ ** same order once the DMA has cleared their own bit. Each descriptor keeps
+ ** a buffer of the driver (e.g. a pbuf) which is returned when the
+ ** descriptor is taken back.
+ **
+ ** The functions are not reentrant, the driver serializes the calls with
+ ** the same ring or pool.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup ETH Ethernet Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+#include "ciaaPOSIX_stddef.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief the descriptor is owned by the DMA, bit of the status word */
+#define CIAADRVETHRING_OWN             0x80000000UL
+
+/*==================[typedef]================================================*/
+/** \brief DMA descriptor */
+typedef struct {
+   uint32_t volatile status;  /** <= status and control, own bit */
+   uint32_t volatile ctrl;    /** <= control and buffer size */
+   uint32_t volatile addr;    /** <= buffer address */
+   uint32_t volatile next;    /** <= address of the next descriptor */
+   uint32_t volatile ext[4];  /** <= extended status and timestamp */
+} ciaaDriverEthRing_descType;
+
+/** \brief descriptor ring */
+typedef struct {
+   ciaaDriverEthRing_descType * desc;  /** <= descriptors */
+   void ** bufs;              /** <= buffer kept by each descriptor */
+   void * hw;                 /** <= DMA passed to the ciaaDriverEthRingHw functions */
+   uint32_t size;             /** <= count of descriptors */
+   uint32_t endStatus;        /** <= status bits of the last descriptor */
+   uint32_t endCtrl;          /** <= control bits of the last descriptor */
+   uint32_t fill;             /** <= next descriptor to be given to the DMA */
+   uint32_t reclaim;          /** <= next descriptor to be taken back */
+   uint32_t free;             /** <= count of descriptors without buffer */
+} ciaaDriverEthRing_type;
+
+/** \brief pool of buffers */
+typedef struct {
+   void ** free;              /** <= stack of the free buffers */
+   uint32_t count;            /** <= count of free buffers */
+   uint32_t size;             /** <= count of buffers */
+} ciaaDriverEthRing_poolType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize a descriptor ring
+ **
+ ** All the descriptors are free and owned by the driver. The status and
+ ** control bits which mark the last descriptor (e.g. the end of ring bits)
+ ** are added to the last descriptor each time it is given to the DMA.
+ **
+ ** \param[out] ring       ring to be initialized
+ ** \param[in]  desc       array of size descriptors
+ ** \param[in]  bufs       array of size pointers
+ ** \param[in]  size       count of descriptors
+ ** \param[in]  hw         DMA passed to the ciaaDriverEthRingHw functions
+ ** \param[in]  endStatus  status bits of the last descriptor
+ ** \param[in]  endCtrl    control bits of the last descriptor
+ **/
+extern void ciaaDriverEthRing_init(ciaaDriverEthRing_type * ring,
+      ciaaDriverEthRing_descType * desc, void ** bufs, uint32_t size,
+      void * hw, uint32_t endStatus, uint32_t endCtrl);
+
+/** \brief returns the count of descriptors without buffer */
+extern uint32_t ciaaDriverEthRing_free(ciaaDriverEthRing_type const * ring);
+
+/** \brief returns true if the DMA has released the next descriptor to
+ **        be taken back */
+extern bool ciaaDriverEthRing_ready(ciaaDriverEthRing_type const * ring);
+
+/** \brief put a buffer in the next free descriptor
+ **
+ ** \param[inout] ring     descriptor ring
+ ** \param[in]    buf      buffer returned by ciaaDriverEthRing_take
+ ** \param[in]    addr     address of the data for the DMA
+ ** \param[in]    ctrl     control word, e.g. the buffer size
+ ** \param[in]    status   status word without the own bit
+ ** \param[in]    own      give the descriptor to the DMA, if false it is
+ **                        given later with ciaaDriverEthRing_own
+ ** \return       index of the descriptor, -1 if there is none free
+ **/
+extern int32_t ciaaDriverEthRing_put(ciaaDriverEthRing_type * ring,
+      void * buf, uint32_t addr, uint32_t ctrl, uint32_t status, bool own);
+
+/** \brief give a descriptor filled by ciaaDriverEthRing_put to the DMA
+ **
+ ** Used to give the first descriptor of a frame once the rest of the frame
+ ** is ready, so the DMA does not start a partial frame.
+ **
+ ** \param[inout] ring     descriptor ring
+ ** \param[in]    idx      index returned by ciaaDriverEthRing_put
+ **/
+extern void ciaaDriverEthRing_own(ciaaDriverEthRing_type * ring, int32_t idx);
+
+/** \brief (re)start the DMA with the descriptors given to it */
+extern void ciaaDriverEthRing_start(ciaaDriverEthRing_type * ring);
+
+/** \brief take back the next descriptor released by the DMA
+ **
+ ** \param[inout] ring     descriptor ring
+ ** \param[out]   buf      buffer of the descriptor, it may be NULL
+ ** \param[out]   status   status word written by the DMA
+ ** \return       true if a descriptor has been taken back, false if the DMA
+ **               still owns it or no descriptor is used
+ **/
+extern bool ciaaDriverEthRing_take(ciaaDriverEthRing_type * ring,
+      void ** buf, uint32_t * status);
+
+/** \brief initialize a pool of buffers
+ **
+ ** \param[out] pool       pool to be initialized
+ ** \param[in]  stack      array of count pointers
+ ** \param[in]  bufs       first buffer
+ ** \param[in]  count      count of buffers
+ ** \param[in]  bufSize    size in bytes of each buffer
+ **/
+extern void ciaaDriverEthRing_poolInit(ciaaDriverEthRing_poolType * pool,
+      void ** stack, void * bufs, uint32_t count, size_t bufSize);
+
+/** \brief get a buffer of a pool
+ **
+ ** \param[inout] pool     pool of buffers
+ ** \return       pointer to the buffer, NULL if the pool is exhausted
+ **/
+extern void * ciaaDriverEthRing_poolGet(ciaaDriverEthRing_poolType * pool);
+
+/** \brief return a buffer to its pool
+ **
+ ** \param[inout] pool     pool of buffers
+ ** \param[in]    buf      buffer returned by ciaaDriverEthRing_poolGet
+ **/
+extern void ciaaDriverEthRing_poolPut(ciaaDriverEthRing_poolType * pool,
+      void * buf);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAADRIVERETHRING_H_ */
@@ -0,0 +1,241 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef _CIAADRIVERSIM_H_
+#define _CIAADRIVERSIM_H_
+/** \brief CIAA host simulation header file
+ **
+ ** Virtual time of the simulated boards. The time advances only when all
+ ** the emulated peripherals are idle, jumping to the next scheduled event,
+ ** so a run is reproducible and faster than real time. The peripheral models
+ ** consume virtual time: uart characters at the configured baudrate, flash
+ ** program and erase times and the adc sample rate.
+ **
+ ** The peripheral models are enabled with CIAADRVSIM_VIRTUAL_TIME, in other
+ ** case the drivers work in wall clock time as before. To run in virtual
+ ** time the board shall:
+ **   - call ciaaDriverSim_run from the background task with the lowest
+ **     priority, the events are fired there as interrupts
+ **   - drive the counter of the alarms with ciaaDriverSim_setTick instead
+ **     of the host timer
+ **   - call ciaaDriverSim_taskStart and ciaaDriverSim_taskEnd from the
+ **     PreTaskHook and PostTaskHook to get the simulated cycles per task
+ **
+ ** The simulation is only available for the x86 architecture.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup SIM Host Simulation
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief simulated cpu frequency in Hz, used to count the cycles */
+#ifndef CIAADRVSIM_CPU_FREQUENCY
+#define CIAADRVSIM_CPU_FREQUENCY       204000000
+#endif
+
+/** \brief count of tasks in the trace, tasks with a higher id are not traced */
+#ifndef CIAADRVSIM_TRACE_TASKS
+#define CIAADRVSIM_TRACE_TASKS         32
+#endif
+
+/** \brief nanoseconds per second */
+#define CIAADRVSIM_SECOND              1000000000ULL
+
+/** \brief nanoseconds per millisecond */
+#define CIAADRVSIM_MILLISECOND         1000000ULL
+
+/** \brief nanoseconds per microsecond */
+#define CIAADRVSIM_MICROSECOND         1000ULL
+
+/** \brief convert a count of cycles of the simulated cpu to time */
+#define CIAADRVSIM_CYCLES_TO_TIME(cycles)                               \
+   ((ciaaDriverSim_timeType)(cycles) * CIAADRVSIM_SECOND / CIAADRVSIM_CPU_FREQUENCY)
+
+/** \brief convert a time to cycles of the simulated cpu */
+#define CIAADRVSIM_TIME_TO_CYCLES(time)                                 \
+   ((uint64_t)(time) * CIAADRVSIM_CPU_FREQUENCY / CIAADRVSIM_SECOND)
+
+/*==================[typedef]================================================*/
+/** \brief simulated time in nanoseconds */
+typedef uint64_t ciaaDriverSim_timeType;
+
+/** \brief event of the simulation
+ **
+ ** The event is provided by the caller and shall not be modified while
+ ** scheduled.
+ **/
+typedef struct ciaaDriverSim_eventStruct {
+   ciaaDriverSim_timeType time;           /** <= time to fire the event */
+   ciaaDriverSim_timeType period;         /** <= period or 0 if one shot */
+   void (*fct)(void * param);             /** <= function to be called */
+   void * param;                          /** <= parameter of the function */
+   bool scheduled;                        /** <= the event is scheduled */
+   struct ciaaDriverSim_eventStruct * next;
+} ciaaDriverSim_eventType;
+
+/** \brief trace of a task */
+typedef struct {
+   uint32_t dispatches;                   /** <= times the task got the cpu */
+   uint64_t cycles;                       /** <= total simulated cycles */
+   uint64_t maxCycles;                    /** <= maximal cycles of a dispatch */
+   uint64_t startCycles;                  /** <= cycles when dispatched */
+} ciaaDriverSim_traceType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize the simulation
+ **
+ ** Sets the time to 0 and removes all the events.
+ **/
+extern void ciaaDriverSim_init(void);
+
+/** \brief get the simulated time
+ **
+ ** \return the virtual time in nanoseconds
+ **/
+extern ciaaDriverSim_timeType ciaaDriverSim_getTime(void);
+
+/** \brief schedule an event
+ **
+ ** If the event is already scheduled it is moved to the new time. Events
+ ** scheduled for the same time are fired in the order they were scheduled.
+ **
+ ** \param[inout] event event to be scheduled
+ ** \param[in] delay time from now to fire the event
+ ** \param[in] period period to fire the event again or 0 for one shot
+ **/
+extern void ciaaDriverSim_schedule(ciaaDriverSim_eventType * event,
+      ciaaDriverSim_timeType delay, ciaaDriverSim_timeType period);
+
+/** \brief cancel an event
+ **
+ ** \param[inout] event event to be canceled
+ **/
+extern void ciaaDriverSim_cancel(ciaaDriverSim_eventType * event);
+
+/** \brief hold the virtual time
+ **
+ ** Called by a peripheral model when it has work pending on the host, the
+ ** time does not advance until all the holds are released.
+ **/
+extern void ciaaDriverSim_hold(void);
+
+/** \brief release a hold of the virtual time */
+extern void ciaaDriverSim_release(void);
+
+/** \brief wait in the calling context
+ **
+ ** Advances the time, firing the due events, as a cpu stalled by a
+ ** peripheral. The time is charged to the running task.
+ **
+ ** \param[in] time time to wait
+ **/
+extern void ciaaDriverSim_wait(ciaaDriverSim_timeType time);
+
+/** \brief consume cycles of the simulated cpu
+ **
+ ** Annotates the execution cost of the calling code, the time is charged to
+ ** the running task.
+ **
+ ** \param[in] cycles count of cycles
+ **/
+extern void ciaaDriverSim_consume(uint32_t cycles);
+
+/** \brief fire the next event if the system is idle
+ **
+ ** \return true if an event was fired, false if no event is scheduled
+ **/
+extern bool ciaaDriverSim_step(void);
+
+/** \brief run the simulation
+ **
+ ** Shall be called from the background task, fires the events when the
+ ** peripherals are idle and waits for events scheduled by the host if
+ ** none is pending. Does not return.
+ **/
+extern void ciaaDriverSim_run(void);
+
+/** \brief drive the counter of the alarms
+ **
+ ** \param[in] period period of the counter tick
+ ** \param[in] fct function handling the tick, shall increment the counter
+ **/
+extern void ciaaDriverSim_setTick(ciaaDriverSim_timeType period, void (*fct)(void));
+
+/** \brief a task gets the cpu, shall be called from PreTaskHook
+ **
+ ** \param[in] task id of the task
+ **/
+extern void ciaaDriverSim_taskStart(uint32_t task);
+
+/** \brief a task leaves the cpu, shall be called from PostTaskHook
+ **
+ ** \param[in] task id of the task
+ **/
+extern void ciaaDriverSim_taskEnd(uint32_t task);
+
+/** \brief get the trace of a task
+ **
+ ** \param[in] task id of the task
+ ** \return pointer to the trace or NULL if the task is not traced
+ **/
+extern ciaaDriverSim_traceType const * ciaaDriverSim_getTrace(uint32_t task);
+
+/** \brief print the simulated time and the cycles of each task */
+extern void ciaaDriverSim_printTrace(void);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAADRIVERSIM_H_ */
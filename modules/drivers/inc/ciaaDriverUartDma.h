@@ -0,0 +1,154 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _CIAADRIVERUARTDMA_H_
+#define _CIAADRIVERUARTDMA_H_
+/** \brief CIAA Uart DMA transfer header file
+ **
+ ** Platform independent bookkeeping of the DMA mode of the uart drivers. The
+ ** receive DMA writes directly into the free region of the receive buffer of
+ ** the serial device and the transmit DMA reads directly from the used
+ ** region of the transmit buffer. The regions are the ones passed by
+ ** ciaaSerialDevices to the read and write functions of the driver.
+ **
+ ** The DMA channels are handled by the ciaaDriverUartDmaHw functions of the
+ ** platform driver.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UART UART Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+#include "ciaaPOSIX_stddef.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief maximal count of bytes of a DMA transfer */
+#ifndef CIAADRVUARTDMA_MAX_TRANSFER
+#define CIAADRVUARTDMA_MAX_TRANSFER    4095
+#endif
+
+/*==================[typedef]================================================*/
+/** \brief DMA state of an uart */
+typedef struct {
+   void * hw;                 /** <= uart passed to the ciaaDriverUartDmaHw functions */
+   bool rxEnabled;            /** <= the receive DMA shall be (re)started */
+   uint8_t * rxBuf;           /** <= region of the receive DMA, NULL if stopped */
+   uint32_t rxSize;           /** <= size of the receive region */
+   uint32_t rxCount;          /** <= bytes of the receive region already forwarded */
+   uint8_t const * txBuf;     /** <= region of the transmit DMA, NULL if idle */
+   uint32_t txSize;           /** <= size of the transmit region */
+} ciaaDriverUartDma_type;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize the DMA state of an uart
+ **
+ ** \param[out] dma   DMA state to be initialized
+ ** \param[in]  hw    uart passed to the ciaaDriverUartDmaHw functions
+ **/
+extern void ciaaDriverUartDma_init(ciaaDriverUartDma_type * dma, void * hw);
+
+/** \brief enable the reception over DMA
+ **
+ ** The receive DMA is started by the next ciaaDriverUartDma_read call.
+ **
+ ** \param[inout] dma  DMA state of the uart
+ **/
+extern void ciaaDriverUartDma_rxStart(ciaaDriverUartDma_type * dma);
+
+/** \brief disable the reception over DMA
+ **
+ ** Stops the receive DMA, the bytes already received are returned by the
+ ** next ciaaDriverUartDma_read call.
+ **
+ ** \param[inout] dma  DMA state of the uart
+ **/
+extern void ciaaDriverUartDma_rxStop(ciaaDriverUartDma_type * dma);
+
+/** \brief returns true if the receive DMA is running */
+extern bool ciaaDriverUartDma_rxActive(ciaaDriverUartDma_type const * dma);
+
+/** \brief returns true if a transmission has not been confirmed yet */
+extern bool ciaaDriverUartDma_txActive(ciaaDriverUartDma_type const * dma);
+
+/** \brief read function of the uart driver in DMA mode
+ **
+ ** Returns the bytes received by the DMA in the region starting at buffer
+ ** and (re)starts the receive DMA in the remaining free region.
+ **
+ ** \param[inout] dma     DMA state of the uart
+ ** \param[in]    buffer  free region of the receive buffer
+ ** \param[in]    size    size of the free region
+ ** \return       count of bytes received at buffer
+ **/
+extern ssize_t ciaaDriverUartDma_read(ciaaDriverUartDma_type * dma,
+      uint8_t * buffer, size_t size);
+
+/** \brief write function of the uart driver in DMA mode
+ **
+ ** Confirms the finished transmission and starts the transmit DMA for the
+ ** rest of the region. The bytes of a running transmission are not
+ ** confirmed, they stay in the transmit buffer until the DMA has read them.
+ **
+ ** \param[inout] dma     DMA state of the uart
+ ** \param[in]    buffer  used region of the transmit buffer
+ ** \param[in]    size    size of the used region
+ ** \return       count of bytes already sent from buffer
+ **/
+extern ssize_t ciaaDriverUartDma_write(ciaaDriverUartDma_type * dma,
+      uint8_t const * buffer, size_t size);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAADRIVERUARTDMA_H_ */
@@ -0,0 +1,113 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _CIAADRIVERUARTDMAHW_H_
+#define _CIAADRIVERUARTDMAHW_H_
+/** \brief CIAA Uart DMA hardware header file
+ **
+ ** Functions to be provided by the platform uart drivers supporting the DMA
+ ** mode, they are called by ciaaDriverUartDma.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UART UART Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief starts the receive DMA
+ **
+ ** \param[in] hw      uart
+ ** \param[in] buffer  destination of the received bytes
+ ** \param[in] size    count of bytes to be received, at most
+ **                    CIAADRVUARTDMA_MAX_TRANSFER
+ **/
+extern void ciaaDriverUartDmaHw_rxStart(void * hw, uint8_t * buffer, uint32_t size);
+
+/** \brief stops the receive DMA
+ **
+ ** \param[in] hw      uart
+ **/
+extern void ciaaDriverUartDmaHw_rxStop(void * hw);
+
+/** \brief returns the count of bytes written by the receive DMA
+ **
+ ** \param[in] hw      uart
+ ** \return    bytes written in the buffer since ciaaDriverUartDmaHw_rxStart
+ **/
+extern uint32_t ciaaDriverUartDmaHw_rxCount(void * hw);
+
+/** \brief starts the transmit DMA
+ **
+ ** \param[in] hw      uart
+ ** \param[in] buffer  bytes to be sent
+ ** \param[in] size    count of bytes to be sent, at most
+ **                    CIAADRVUARTDMA_MAX_TRANSFER
+ **/
+extern void ciaaDriverUartDmaHw_txStart(void * hw, uint8_t const * buffer, uint32_t size);
+
+/** \brief returns true while the transmit DMA is reading the buffer
+ **
+ ** \param[in] hw      uart
+ **/
+extern bool ciaaDriverUartDmaHw_txBusy(void * hw);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAADRIVERUARTDMAHW_H_ */
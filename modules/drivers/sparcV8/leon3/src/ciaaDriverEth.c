@@ -84,6 +84,12 @@ void ciaaDriverEth_mainFunction(void)
 }
 
 
+void ciaaDriverEth_wait(void)
+{
+
+}
+
+
 /*==================[interrupt handlers]=====================================*/
 
 
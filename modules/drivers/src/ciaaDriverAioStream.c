@@ -0,0 +1,179 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief CIAA Aio sample stream
+ **
+ ** Ring of sample blocks of the continuous acquisition. The counters head,
+ ** tail and reserved run freely, the blocks are indexed with the counters
+ ** masked by blockCount - 1. The producer (DMA interrupt) only writes head,
+ ** reserved and overruns, the reader only writes tail.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup AIO AIO Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDriverAioStream.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+extern void ciaaDriverAioStream_init(ciaaDriverAioStream_type * stream,
+      uint32_t * buffer, uint32_t * timestamps, uint32_t blockSize,
+      uint32_t blockCount)
+{
+   stream->buffer = buffer;
+   stream->timestamps = timestamps;
+   stream->blockSize = blockSize;
+   stream->blockCount = blockCount;
+   stream->head = 0;
+   stream->tail = 0;
+   stream->reserved = 0;
+   stream->inFlightCount = 0;
+   stream->overruns = 0;
+} /* end ciaaDriverAioStream_init */
+
+extern uint32_t * ciaaDriverAioStream_fill(ciaaDriverAioStream_type * stream)
+{
+   uint32_t * ret = NULL;
+   uint32_t block;
+
+   if(stream->inFlightCount < CIAADRVAIOSTREAM_IN_FLIGHT)
+   {
+      if((stream->reserved - stream->tail) < stream->blockCount)
+      {
+         block = stream->reserved & (stream->blockCount - 1);
+         stream->reserved++;
+      }
+      else
+      {
+         /* all blocks wait for the readers */
+         block = stream->blockCount;
+      }
+
+      stream->inFlight[stream->inFlightCount] = block;
+      stream->inFlightCount++;
+
+      ret = &stream->buffer[block * stream->blockSize];
+   }
+
+   return ret;
+} /* end ciaaDriverAioStream_fill */
+
+extern uint32_t * ciaaDriverAioStream_filled(ciaaDriverAioStream_type * stream,
+      uint32_t timestamp)
+{
+   uint32_t * ret = NULL;
+   uint32_t block;
+   uint8_t i;
+
+   if(stream->inFlightCount > 0)
+   {
+      block = stream->inFlight[0];
+      stream->inFlightCount--;
+      for(i = 0; i < stream->inFlightCount; i++)
+      {
+         stream->inFlight[i] = stream->inFlight[i + 1];
+      }
+
+      if(block == stream->blockCount)
+      {
+         stream->overruns++;
+      }
+      else
+      {
+         stream->timestamps[block] = timestamp;
+         ret = &stream->buffer[block * stream->blockSize];
+         /* hand the block to the readers once it is complete */
+         stream->head++;
+      }
+   }
+
+   return ret;
+} /* end ciaaDriverAioStream_filled */
+
+extern bool ciaaDriverAioStream_get(ciaaDriverAioStream_type * stream,
+      uint32_t const ** samples, uint32_t * timestamp)
+{
+   bool ret = false;
+   uint32_t block;
+
+   if(stream->head != stream->tail)
+   {
+      block = stream->tail & (stream->blockCount - 1);
+      *samples = &stream->buffer[block * stream->blockSize];
+      *timestamp = stream->timestamps[block];
+      ret = true;
+   }
+
+   return ret;
+} /* end ciaaDriverAioStream_get */
+
+extern bool ciaaDriverAioStream_release(ciaaDriverAioStream_type * stream)
+{
+   bool ret = false;
+
+   if(stream->head != stream->tail)
+   {
+      stream->tail++;
+      ret = true;
+   }
+
+   return ret;
+} /* end ciaaDriverAioStream_release */
+
+extern uint32_t ciaaDriverAioStream_overruns(ciaaDriverAioStream_type const * stream)
+{
+   return stream->overruns;
+} /* end ciaaDriverAioStream_overruns */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,232 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief CIAA Dio edge events
+ **
+ ** Each debounced input has an integrator counting from 0 to its samples,
+ ** up with each sample at 1 and down with each sample at 0. The debounced
+ ** state changes when the integrator reaches the opposite end, so a short
+ ** glitch only moves the integrator and a bouncing edge is reported once,
+ ** with the time of its first edge.
+ **
+ ** The queue of events is a ring indexed with the free running counters
+ ** head and tail masked by size - 1. The producer (pin interrupt) only
+ ** writes head and overruns, the reader only writes tail.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup DIO DIO Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDriverDioEvent.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief queue an edge event, it is lost if the queue is full */
+static void ciaaDriverDioEvent_put(ciaaDriverDioEvent_type * event,
+      uint32_t input, uint32_t level, uint32_t timestamp)
+{
+   ciaaPOSIX_dioEventType * slot;
+
+   if((event->head - event->tail) < event->size)
+   {
+      slot = &event->events[event->head & (event->size - 1)];
+      slot->timestamp = timestamp;
+      slot->input = (uint8_t)input;
+      slot->level = (uint8_t)level;
+      event->head++;
+   }
+   else
+   {
+      event->overruns++;
+   }
+} /* end ciaaDriverDioEvent_put */
+
+/*==================[external functions definition]==========================*/
+extern void ciaaDriverDioEvent_init(ciaaDriverDioEvent_type * event,
+      ciaaPOSIX_dioEventType * events, uint32_t size, uint32_t state)
+{
+   uint32_t loopi;
+
+   event->events = events;
+   event->size = size;
+   event->head = 0;
+   event->tail = 0;
+   event->overruns = 0;
+   event->enabled = 0;
+   event->state = state;
+   event->settling = 0;
+
+   for(loopi = 0; loopi < CIAADRVDIOEVENT_MAX_INPUTS; loopi++)
+   {
+      event->edgeTime[loopi] = 0;
+      event->samples[loopi] = 0;
+      event->counters[loopi] = 0;
+   }
+} /* end ciaaDriverDioEvent_init */
+
+extern void ciaaDriverDioEvent_setDebounce(ciaaDriverDioEvent_type * event,
+      uint32_t inputs, uint8_t samples)
+{
+   uint32_t loopi;
+
+   for(loopi = 0; loopi < CIAADRVDIOEVENT_MAX_INPUTS; loopi++)
+   {
+      if(0 != (inputs & ((uint32_t)1 << loopi)))
+      {
+         event->samples[loopi] = samples;
+         event->counters[loopi] =
+            (0 != (event->state & ((uint32_t)1 << loopi))) ? samples : 0;
+      }
+   }
+   event->settling &= ~inputs;
+} /* end ciaaDriverDioEvent_setDebounce */
+
+extern void ciaaDriverDioEvent_enable(ciaaDriverDioEvent_type * event,
+      uint32_t inputs)
+{
+   event->enabled = inputs;
+   event->tail = event->head;
+} /* end ciaaDriverDioEvent_enable */
+
+extern uint32_t ciaaDriverDioEvent_sample(ciaaDriverDioEvent_type * event,
+      uint32_t state, uint32_t timestamp)
+{
+   /* only the inputs which changed or are settling are visited */
+   uint32_t pending = (state ^ event->state) | event->settling;
+   uint32_t input;
+   uint32_t mask;
+   uint32_t level;
+   uint8_t rest;
+
+   while(0 != pending)
+   {
+      input = (uint32_t)__builtin_ctz(pending);
+      mask = (uint32_t)1 << input;
+      pending &= pending - 1;
+      level = (state >> input) & 1;
+
+      if(0 == event->samples[input])
+      {
+         /* not debounced, each edge is an event */
+         event->state ^= mask;
+         if(0 != (event->enabled & mask))
+         {
+            ciaaDriverDioEvent_put(event, input, level, timestamp);
+         }
+      }
+      else
+      {
+         if(0 == (event->settling & mask))
+         {
+            /* first edge of a transition */
+            event->edgeTime[input] = timestamp;
+         }
+
+         if((0 != level) && (event->counters[input] < event->samples[input]))
+         {
+            event->counters[input]++;
+         }
+         else if((0 == level) && (event->counters[input] > 0))
+         {
+            event->counters[input]--;
+         }
+
+         /* the integrator reached the opposite end */
+         if( ((0 != level) && (event->counters[input] == event->samples[input]) &&
+              (0 == (event->state & mask))) ||
+             ((0 == level) && (0 == event->counters[input]) &&
+              (0 != (event->state & mask))) )
+         {
+            event->state ^= mask;
+            if(0 != (event->enabled & mask))
+            {
+               ciaaDriverDioEvent_put(event, input, level, event->edgeTime[input]);
+            }
+         }
+
+         rest = (0 != (event->state & mask)) ? event->samples[input] : 0;
+         if(event->counters[input] != rest)
+         {
+            event->settling |= mask;
+         }
+         else
+         {
+            event->settling &= ~mask;
+         }
+      }
+   }
+
+   return event->settling;
+} /* end ciaaDriverDioEvent_sample */
+
+extern uint32_t ciaaDriverDioEvent_count(ciaaDriverDioEvent_type const * event)
+{
+   return event->head - event->tail;
+} /* end ciaaDriverDioEvent_count */
+
+extern uint32_t ciaaDriverDioEvent_get(ciaaDriverDioEvent_type * event,
+      ciaaPOSIX_dioEventType * events, uint32_t count)
+{
+   uint32_t ret = 0;
+   uint32_t head = event->head;
+
+   while((ret < count) && (event->tail != head))
+   {
+      events[ret] = event->events[event->tail & (event->size - 1)];
+      event->tail++;
+      ret++;
+   }
+
+   return ret;
+} /* end ciaaDriverDioEvent_get */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,261 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief CIAA Dio port access
+ **
+ ** The managed pins of each gpio port are grouped in runs, the pins of a
+ ** run are moved by the same shift between the port register and the state
+ ** of the pins. A port usually needs one or two runs, therefore gathering
+ ** or scattering a port costs a mask and a shift per run.
+ **
+ ** If the pins of a port are consecutive and follow the order of the port
+ ** bits and the bits extract/deposit instructions are available (BMI2 on
+ ** x86) the port is moved with one instruction.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup DIO DIO Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDriverDioPort.h"
+#include "ciaaPOSIX_stddef.h"
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief add the runs of a port to the table
+ **
+ ** \param[inout] table  table being built
+ ** \param[inout] port   port of the table
+ ** \param[in]    first  first free run of the table
+ ** \param[in]    pins   board pin table
+ ** \param[in]    count  count of entries of the board pin table
+ ** \return       count of runs added
+ **/
+static uint32_t ciaaDriverDioPort_addRuns(ciaaDriverDioPort_tableType * table,
+      ciaaDriverDioPort_portType * port, uint32_t first,
+      ciaaDriverDioPort_pinType const * pins, uint32_t count)
+{
+   ciaaDriverDioPort_runType * run;
+   uint32_t loopi;
+   uint32_t loopj;
+   int32_t shift;
+   uint32_t next = 0;
+
+   port->first = first;
+   port->count = 0;
+   port->mask = 0;
+   port->ordered = true;
+
+   for(loopi = 0; loopi < count; loopi++)
+   {
+      if(pins[loopi].port == port->port)
+      {
+         shift = (int32_t)pins[loopi].pin - (int32_t)loopi;
+
+         /* look for a run with the same shift */
+         run = NULL;
+         for(loopj = port->first; (loopj < (uint32_t)(port->first + port->count)) && (NULL == run); loopj++)
+         {
+            if(table->runs[loopj].shift == shift)
+            {
+               run = &table->runs[loopj];
+            }
+         }
+         if(NULL == run)
+         {
+            run = &table->runs[port->first + port->count];
+            run->mask = 0;
+            run->shift = shift;
+            port->count++;
+         }
+         run->mask |= (uint32_t)1 << pins[loopi].pin;
+
+         /* the pins of an ordered port are consecutive and the port bits
+          * increase with the pin number */
+         if(0 == port->mask)
+         {
+            port->lowest = loopi;
+         }
+         else if((next != loopi) || ((port->mask >> pins[loopi].pin) != 0))
+         {
+            port->ordered = false;
+         }
+         next = loopi + 1;
+
+         port->mask |= (uint32_t)1 << pins[loopi].pin;
+      }
+   }
+
+   return port->count;
+} /* end ciaaDriverDioPort_addRuns */
+
+/*==================[external functions definition]==========================*/
+extern int32_t ciaaDriverDioPort_init(ciaaDriverDioPort_tableType * table,
+      ciaaDriverDioPort_pinType const * pins, uint32_t count)
+{
+   int32_t ret = 0;
+   uint32_t loopi;
+   uint32_t loopj;
+   uint32_t runs = 0;
+   bool found;
+
+   table->pinCount = 0;
+   table->portCount = 0;
+
+   if(count > CIAADRVDIOPORT_MAX_PINS)
+   {
+      ret = -1;
+   }
+
+   for(loopi = 0; (loopi < count) && (0 == ret); loopi++)
+   {
+      /* each port is added once, with the runs of all its pins */
+      found = false;
+      for(loopj = 0; (loopj < table->portCount) && (!found); loopj++)
+      {
+         found = (table->ports[loopj].port == pins[loopi].port);
+      }
+
+      if((!found) && (table->portCount >= CIAADRVDIOPORT_MAX_PORTS))
+      {
+         ret = -1;
+      }
+      else if(!found)
+      {
+         table->ports[table->portCount].port = pins[loopi].port;
+         runs += ciaaDriverDioPort_addRuns(table, &table->ports[table->portCount],
+               runs, pins, count);
+         table->portCount++;
+      }
+   }
+
+   if(0 == ret)
+   {
+      table->pinCount = count;
+   }
+   else
+   {
+      table->portCount = 0;
+   }
+
+   return ret;
+} /* end ciaaDriverDioPort_init */
+
+extern uint32_t ciaaDriverDioPort_gather(ciaaDriverDioPort_tableType const * table,
+      uint32_t index, uint32_t value)
+{
+   ciaaDriverDioPort_portType const * port = &table->ports[index];
+   ciaaDriverDioPort_runType const * run;
+   uint32_t ret = 0;
+   uint32_t loopi;
+
+#ifdef __BMI2__
+   if(port->ordered)
+   {
+      ret = _pext_u32(value, port->mask) << port->lowest;
+   }
+   else
+#endif
+   {
+      for(loopi = 0; loopi < port->count; loopi++)
+      {
+         run = &table->runs[port->first + loopi];
+         if(run->shift >= 0)
+         {
+            ret |= (value & run->mask) >> run->shift;
+         }
+         else
+         {
+            ret |= (value & run->mask) << -run->shift;
+         }
+      }
+   }
+
+   return ret;
+} /* end ciaaDriverDioPort_gather */
+
+extern uint32_t ciaaDriverDioPort_scatter(ciaaDriverDioPort_tableType const * table,
+      uint32_t index, uint32_t state)
+{
+   ciaaDriverDioPort_portType const * port = &table->ports[index];
+   ciaaDriverDioPort_runType const * run;
+   uint32_t ret = 0;
+   uint32_t loopi;
+
+#ifdef __BMI2__
+   if(port->ordered)
+   {
+      ret = _pdep_u32(state >> port->lowest, port->mask);
+   }
+   else
+#endif
+   {
+      for(loopi = 0; loopi < port->count; loopi++)
+      {
+         run = &table->runs[port->first + loopi];
+         if(run->shift >= 0)
+         {
+            ret |= (state << run->shift) & run->mask;
+         }
+         else
+         {
+            ret |= (state >> -run->shift) & run->mask;
+         }
+      }
+   }
+
+   return ret;
+} /* end ciaaDriverDioPort_scatter */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,212 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief CIAA Ethernet descriptor ring
+ **
+ ** The descriptors between reclaim and fill are used, they are owned by
+ ** the DMA or released by it and not taken back yet. The own bit is the
+ ** last word written when a descriptor is given to the DMA.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup ETH Ethernet Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDriverEthRing.h"
+#include "ciaaDriverEthRingHw.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+extern void ciaaDriverEthRing_init(ciaaDriverEthRing_type * ring,
+      ciaaDriverEthRing_descType * desc, void ** bufs, uint32_t size,
+      void * hw, uint32_t endStatus, uint32_t endCtrl)
+{
+   uint32_t idx;
+
+   ring->desc = desc;
+   ring->bufs = bufs;
+   ring->hw = hw;
+   ring->size = size;
+   ring->endStatus = endStatus;
+   ring->endCtrl = endCtrl;
+   ring->fill = 0;
+   ring->reclaim = 0;
+   ring->free = size;
+
+   for (idx = 0; idx < size; idx++)
+   {
+      desc[idx].status &= ~CIAADRVETHRING_OWN;
+      bufs[idx] = NULL;
+   }
+} /* end ciaaDriverEthRing_init */
+
+extern uint32_t ciaaDriverEthRing_free(ciaaDriverEthRing_type const * ring)
+{
+   return ring->free;
+} /* end ciaaDriverEthRing_free */
+
+extern bool ciaaDriverEthRing_ready(ciaaDriverEthRing_type const * ring)
+{
+   return (ring->free < ring->size) &&
+      (0 == (ring->desc[ring->reclaim].status & CIAADRVETHRING_OWN));
+} /* end ciaaDriverEthRing_ready */
+
+extern int32_t ciaaDriverEthRing_put(ciaaDriverEthRing_type * ring,
+      void * buf, uint32_t addr, uint32_t ctrl, uint32_t status, bool own)
+{
+   int32_t ret = -1;
+   uint32_t idx = ring->fill;
+
+   if (0 < ring->free)
+   {
+      if ((ring->size - 1) == idx)
+      {
+         status |= ring->endStatus;
+         ctrl |= ring->endCtrl;
+         ring->fill = 0;
+      }
+      else
+      {
+         ring->fill = idx + 1;
+      }
+      if (own)
+      {
+         status |= CIAADRVETHRING_OWN;
+      }
+
+      ring->bufs[idx] = buf;
+      ring->desc[idx].addr = addr;
+      ring->desc[idx].ctrl = ctrl;
+      /* the own bit is written once the descriptor is complete */
+      ring->desc[idx].status = status;
+      ring->free--;
+
+      ret = (int32_t)idx;
+   }
+
+   return ret;
+} /* end ciaaDriverEthRing_put */
+
+extern void ciaaDriverEthRing_own(ciaaDriverEthRing_type * ring, int32_t idx)
+{
+   ring->desc[idx].status |= CIAADRVETHRING_OWN;
+} /* end ciaaDriverEthRing_own */
+
+extern void ciaaDriverEthRing_start(ciaaDriverEthRing_type * ring)
+{
+   ciaaDriverEthRingHw_pollDemand(ring->hw);
+} /* end ciaaDriverEthRing_start */
+
+extern bool ciaaDriverEthRing_take(ciaaDriverEthRing_type * ring,
+      void ** buf, uint32_t * status)
+{
+   bool ret = false;
+   uint32_t idx = ring->reclaim;
+
+   if (ciaaDriverEthRing_ready(ring))
+   {
+      *status = ring->desc[idx].status;
+      *buf = ring->bufs[idx];
+      ring->bufs[idx] = NULL;
+
+      ring->reclaim = ((ring->size - 1) == idx) ? 0 : (idx + 1);
+      ring->free++;
+
+      ret = true;
+   }
+
+   return ret;
+} /* end ciaaDriverEthRing_take */
+
+extern void ciaaDriverEthRing_poolInit(ciaaDriverEthRing_poolType * pool,
+      void ** stack, void * bufs, uint32_t count, size_t bufSize)
+{
+   uint32_t idx;
+
+   pool->free = stack;
+   pool->size = count;
+
+   /* the first buffer is the first one got */
+   for (idx = 0; idx < count; idx++)
+   {
+      stack[count - 1 - idx] = (uint8_t *)bufs + (idx * bufSize);
+   }
+   pool->count = count;
+} /* end ciaaDriverEthRing_poolInit */
+
+extern void * ciaaDriverEthRing_poolGet(ciaaDriverEthRing_poolType * pool)
+{
+   void * ret = NULL;
+
+   if (0 < pool->count)
+   {
+      pool->count--;
+      ret = pool->free[pool->count];
+   }
+
+   return ret;
+} /* end ciaaDriverEthRing_poolGet */
+
+extern void ciaaDriverEthRing_poolPut(ciaaDriverEthRing_poolType * pool,
+      void * buf)
+{
+   /* a pool never gets more buffers than it has */
+   if (pool->size > pool->count)
+   {
+      pool->free[pool->count] = buf;
+      pool->count++;
+   }
+} /* end ciaaDriverEthRing_poolPut */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
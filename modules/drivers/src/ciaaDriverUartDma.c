@@ -0,0 +1,188 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief CIAA Uart DMA transfers
+ **
+ ** Bookkeeping of the DMA mode of the uart drivers. A receive region is
+ ** filled by the DMA until it is full or the DMA is stopped, the bytes are
+ ** forwarded on each read call. A transmit region is confirmed once the DMA
+ ** has read all its bytes.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UART UART Drivers
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDriverUartDma.h"
+#include "ciaaDriverUartDmaHw.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+extern void ciaaDriverUartDma_init(ciaaDriverUartDma_type * dma, void * hw)
+{
+   dma->hw = hw;
+   dma->rxEnabled = false;
+   dma->rxBuf = NULL;
+   dma->rxSize = 0;
+   dma->rxCount = 0;
+   dma->txBuf = NULL;
+   dma->txSize = 0;
+} /* end ciaaDriverUartDma_init */
+
+extern void ciaaDriverUartDma_rxStart(ciaaDriverUartDma_type * dma)
+{
+   dma->rxEnabled = true;
+} /* end ciaaDriverUartDma_rxStart */
+
+extern void ciaaDriverUartDma_rxStop(ciaaDriverUartDma_type * dma)
+{
+   dma->rxEnabled = false;
+
+   if (NULL != dma->rxBuf)
+   {
+      /* the region is kept until the received bytes are read */
+      ciaaDriverUartDmaHw_rxStop(dma->hw);
+   }
+} /* end ciaaDriverUartDma_rxStop */
+
+extern bool ciaaDriverUartDma_rxActive(ciaaDriverUartDma_type const * dma)
+{
+   return (NULL != dma->rxBuf) && dma->rxEnabled;
+} /* end ciaaDriverUartDma_rxActive */
+
+extern bool ciaaDriverUartDma_txActive(ciaaDriverUartDma_type const * dma)
+{
+   return NULL != dma->txBuf;
+} /* end ciaaDriverUartDma_txActive */
+
+extern ssize_t ciaaDriverUartDma_read(ciaaDriverUartDma_type * dma,
+      uint8_t * buffer, size_t size)
+{
+   size_t ret = 0;
+
+   if (NULL != dma->rxBuf)
+   {
+      if (&dma->rxBuf[dma->rxCount] == buffer)
+      {
+         /* forward the bytes received since the last call */
+         ret = ciaaDriverUartDmaHw_rxCount(dma->hw) - dma->rxCount;
+         if (ret > size)
+         {
+            ret = size;
+         }
+         dma->rxCount += ret;
+
+         /* the region is full or the DMA has been stopped */
+         if ((dma->rxCount >= dma->rxSize) || (!dma->rxEnabled))
+         {
+            dma->rxBuf = NULL;
+         }
+      }
+      else
+      {
+         /* the receive buffer has been reset, restart in the new region */
+         ciaaDriverUartDmaHw_rxStop(dma->hw);
+         dma->rxBuf = NULL;
+      }
+   }
+
+   /* receive in the rest of the free region */
+   if ((NULL == dma->rxBuf) && (dma->rxEnabled) && (size > ret))
+   {
+      dma->rxBuf = &buffer[ret];
+      dma->rxSize = size - ret;
+      if (dma->rxSize > CIAADRVUARTDMA_MAX_TRANSFER)
+      {
+         dma->rxSize = CIAADRVUARTDMA_MAX_TRANSFER;
+      }
+      dma->rxCount = 0;
+      ciaaDriverUartDmaHw_rxStart(dma->hw, dma->rxBuf, dma->rxSize);
+   }
+
+   return (ssize_t)ret;
+} /* end ciaaDriverUartDma_read */
+
+extern ssize_t ciaaDriverUartDma_write(ciaaDriverUartDma_type * dma,
+      uint8_t const * buffer, size_t size)
+{
+   size_t ret = 0;
+
+   /* a region still read by the DMA is not confirmed */
+   if ((NULL != dma->txBuf) && (!ciaaDriverUartDmaHw_txBusy(dma->hw)))
+   {
+      /* confirm the sent region, it is at the start of buffer */
+      ret = dma->txSize;
+      if (ret > size)
+      {
+         ret = size;
+      }
+      dma->txBuf = NULL;
+   }
+
+   /* send the rest of the used region */
+   if ((NULL == dma->txBuf) && (size > ret))
+   {
+      dma->txBuf = &buffer[ret];
+      dma->txSize = size - ret;
+      if (dma->txSize > CIAADRVUARTDMA_MAX_TRANSFER)
+      {
+         dma->txSize = CIAADRVUARTDMA_MAX_TRANSFER;
+      }
+      ciaaDriverUartDmaHw_txStart(dma->hw, dma->txBuf, dma->txSize);
+   }
+
+   return (ssize_t)ret;
+} /* end ciaaDriverUartDma_write */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
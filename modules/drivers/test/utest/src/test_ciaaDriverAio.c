@@ -0,0 +1,381 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the x86 aio driver
+ **
+ ** The adc converts a stimulus file written by the test and the dac records
+ ** to a file read back by the test, the serial devices layer is replaced by
+ ** callbacks. The conversions at 1 MS/s report the throughput of the model.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDriverAio.h"
+#include "ciaaDriverAio_Internal.h"
+#include "ciaaPOSIX_stdio.h"
+#include "mock_ciaaSerialDevices.h"
+#include "mock_ciaaPOSIX_string.h"
+#include "mock_os.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+#include "unistd.h"
+#include "pthread.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief frames of the stimulus written by the test */
+#define TEST_FRAMES           1000
+
+/** \brief maximal count of samples received by the test */
+#define TEST_SAMPLES          (256 * 1024)
+
+/** \brief duration of the conversions in ms */
+#define TEST_DURATION         100
+
+/** \brief samples written to the dac */
+#define TEST_DAC_SAMPLES      20000
+
+/** \brief timeout waiting for the sampler in ms */
+#define TEST_TIMEOUT          2000
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief devices registered by the driver */
+static ciaaDevices_deviceType * devices[3];
+
+/** \brief protects the data shared with the sampler */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** \brief signaled on each indication and confirmation */
+static pthread_cond_t changed = PTHREAD_COND_INITIALIZER;
+
+/** \brief samples received from the adc */
+static uint16_t rxData[TEST_SAMPLES];
+
+/** \brief count of samples received from the adc */
+static size_t rxCount;
+
+/** \brief samples to be written to the dac */
+static uint16_t txData[TEST_DAC_SAMPLES];
+
+/** \brief count of samples already written to the dac */
+static size_t txCount;
+
+/** \brief count of samples confirmed by the dac */
+static size_t txConfirmed;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/** \brief input of a channel in a frame of the stimulus */
+static uint16_t stimulus(uint32_t frame, uint32_t channel)
+{
+   return (uint16_t)((frame * CIAADRVAIO_CHANNELS + channel) & 0x3FF);
+}
+
+static void * stringMemcpy(void * s1, void const * s2, size_t n, int calls)
+{
+   (void)calls;
+
+   return memcpy(s1, s2, n);
+}
+
+/** \brief keep the registered devices, the driver device is its own upper
+ ** layer so the callbacks get it back */
+static void serialAddDriver(ciaaDevices_deviceType * driver, int calls)
+{
+   devices[calls] = driver;
+   driver->upLayer = driver;
+}
+
+/** \brief serial devices rx indication, reads all the samples */
+static void serialRxIndication(ciaaDevices_deviceType const * const device,
+      uint32_t const nbyte, int calls)
+{
+   ssize_t count;
+
+   (void)nbyte;
+   (void)calls;
+
+   pthread_mutex_lock(&lock);
+   count = ciaaDriverAio_read(device, (uint8_t *)&rxData[rxCount],
+         (TEST_SAMPLES - rxCount) * sizeof(uint16_t));
+   rxCount += count / sizeof(uint16_t);
+   pthread_cond_broadcast(&changed);
+   pthread_mutex_unlock(&lock);
+}
+
+/** \brief serial devices tx confirmation, writes the next samples */
+static void serialTxConfirmation(ciaaDevices_deviceType const * const device,
+      uint32_t const nbyte, int calls)
+{
+   (void)calls;
+
+   pthread_mutex_lock(&lock);
+   if (1 < nbyte)
+   {
+      /* not the confirmation of the start of the transmission */
+      txConfirmed += nbyte / sizeof(uint16_t);
+   }
+   if (txCount < TEST_DAC_SAMPLES)
+   {
+      txCount += ciaaDriverAio_write(device, (uint8_t const *)&txData[txCount],
+            (TEST_DAC_SAMPLES - txCount) * sizeof(uint16_t)) / sizeof(uint16_t);
+   }
+   pthread_cond_broadcast(&changed);
+   pthread_mutex_unlock(&lock);
+}
+
+/** \brief wait until the dac confirms count samples */
+static size_t waitConfirmed(size_t count)
+{
+   struct timespec until;
+   size_t ret;
+
+   clock_gettime(CLOCK_REALTIME, &until);
+   until.tv_sec += TEST_TIMEOUT / 1000;
+
+   pthread_mutex_lock(&lock);
+   while ((txConfirmed < count) &&
+          (0 == pthread_cond_timedwait(&changed, &lock, &until)))
+   {
+   }
+   ret = txConfirmed;
+   pthread_mutex_unlock(&lock);
+
+   return ret;
+}
+
+/** \brief close the devices, the callbacks are not called anymore */
+static void closeDevices(void)
+{
+   ciaaDriverAio_close(devices[0]);
+   ciaaDriverAio_close(devices[1]);
+   ciaaDriverAio_close(devices[2]);
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   uint16_t frame[CIAADRVAIO_CHANNELS];
+   uint32_t loopi;
+   uint32_t loopj;
+   FILE * file;
+
+   rxCount = 0;
+   txCount = 0;
+   txConfirmed = 0;
+
+   /* stimulus of the adc 0, the adc 1 has none */
+   file = fopen(CIAADRVAIO_STIMULUS_0, "wb");
+   TEST_ASSERT_NOT_NULL(file);
+   for (loopi = 0; loopi < TEST_FRAMES; loopi++)
+   {
+      for (loopj = 0; loopj < CIAADRVAIO_CHANNELS; loopj++)
+      {
+         frame[loopj] = stimulus(loopi, loopj);
+      }
+      fwrite(frame, sizeof(frame), 1, file);
+   }
+   fclose(file);
+   remove(CIAADRVAIO_STIMULUS_1);
+
+   ciaaPOSIX_memcpy_StubWithCallback(stringMemcpy);
+   ciaaSerialDevices_addDriver_StubWithCallback(serialAddDriver);
+   ciaaSerialDevices_rxIndication_StubWithCallback(serialRxIndication);
+   ciaaSerialDevices_txConfirmation_StubWithCallback(serialTxConfirmation);
+
+   ciaaDriverAio_init();
+   TEST_ASSERT_EQUAL_PTR(devices[0], ciaaDriverAio_open("/dev/serial/aio/in/0", devices[0], 0));
+   TEST_ASSERT_EQUAL_PTR(devices[1], ciaaDriverAio_open("/dev/serial/aio/in/1", devices[1], 0));
+   TEST_ASSERT_EQUAL_PTR(devices[2], ciaaDriverAio_open("/dev/serial/aio/out/0", devices[2], 0));
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+   remove(CIAADRVAIO_STIMULUS_0);
+   remove(CIAADRVAIO_RECORD_0);
+}
+
+/** \brief test the configuration of the devices */
+void test_ciaaDriverAio_ioctl(void) {
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_CHANNEL, (void*)ciaaCHANNEL_3));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_CHANNEL, (void*)4));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverAio_ioctl(devices[2], ciaaPOSIX_IOCTL_SET_CHANNEL, (void*)ciaaCHANNEL_1));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_SAMPLE_RATE, (void*)CIAADRVAIO_MAX_SAMPLE_RATE));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_SAMPLE_RATE, (void*)(CIAADRVAIO_MAX_SAMPLE_RATE + 1)));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_SAMPLE_RATE, (void*)0));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_RESOLUTION, (void*)ciaaRESOLUTION_3BITS));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverAio_ioctl(devices[2], ciaaPOSIX_IOCTL_SET_RESOLUTION, (void*)ciaaRESOLUTION_3BITS));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverAio_read(devices[2], (uint8_t *)rxData, sizeof(rxData)));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverAio_write(devices[0], (uint8_t const *)txData, sizeof(txData)));
+
+   closeDevices();
+}
+
+/** \brief test the conversion of the stimulus at 1 MS/s */
+void test_ciaaDriverAio_stimulus(void) {
+   uint64_t start;
+   uint64_t elapsed;
+   size_t count;
+   size_t loopi;
+
+   ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT, (void*)false);
+   ciaaDriverAio_ioctl(devices[1], ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT, (void*)false);
+   ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_CHANNEL, (void*)ciaaCHANNEL_2);
+   pthread_mutex_lock(&lock);
+   rxCount = 0;
+   pthread_mutex_unlock(&lock);
+   start = getNs();
+   ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_SAMPLE_RATE, (void*)CIAADRVAIO_MAX_SAMPLE_RATE);
+   ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT, (void*)true);
+
+   usleep(TEST_DURATION * 1000);
+   closeDevices();
+   elapsed = getNs() - start;
+
+   pthread_mutex_lock(&lock);
+   count = rxCount;
+   pthread_mutex_unlock(&lock);
+   printf("aio adc: %.0f samples/s, %u overruns\n",
+         (double)count * 1e9 / (double)elapsed, ciaaDriverAio_aio0.overruns);
+
+   /* the samples follow the stimulus of the channel from the first frame */
+   TEST_ASSERT_TRUE(count > (size_t)CIAADRVAIO_MAX_SAMPLE_RATE / 1000 * TEST_DURATION / 2);
+   TEST_ASSERT_TRUE(count <= (size_t)CIAADRVAIO_MAX_SAMPLE_RATE / 1000 * (elapsed / 1000000 + 1));
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverAio_aio0.overruns);
+   for (loopi = 0; loopi < count; loopi++)
+   {
+      TEST_ASSERT_EQUAL_UINT16(stimulus(loopi % TEST_FRAMES, ciaaCHANNEL_2), rxData[loopi]);
+   }
+}
+
+/** \brief test the resolution and an adc without stimulus */
+void test_ciaaDriverAio_resolution(void) {
+   size_t count;
+   size_t loopi;
+   bool zero = true;
+
+   ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_RESOLUTION, (void*)ciaaRESOLUTION_8BITS);
+   ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT, (void*)false);
+   ciaaDriverAio_ioctl(devices[1], ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT, (void*)false);
+   ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_SAMPLE_RATE, (void*)100000);
+   ciaaDriverAio_ioctl(devices[1], ciaaPOSIX_IOCTL_SET_SAMPLE_RATE, (void*)100000);
+
+   usleep(20000);
+   closeDevices();
+
+   /* the samples are kept in the fifo of each adc */
+   count = ciaaDriverAio_read(devices[0], (uint8_t *)rxData, sizeof(rxData)) / sizeof(uint16_t);
+   TEST_ASSERT_TRUE(count > 0);
+   for (loopi = 0; loopi < count; loopi++)
+   {
+      TEST_ASSERT_EQUAL_UINT16(stimulus(loopi % TEST_FRAMES, ciaaCHANNEL_0) >> 2, rxData[loopi]);
+   }
+
+   count = ciaaDriverAio_read(devices[1], (uint8_t *)rxData, sizeof(rxData)) / sizeof(uint16_t);
+   TEST_ASSERT_TRUE(count > 0);
+   for (loopi = 0; loopi < count; loopi++)
+   {
+      zero = zero && (0 == rxData[loopi]);
+   }
+   TEST_ASSERT_TRUE(zero);
+}
+
+/** \brief test the output of the dac at 1 MS/s and its record */
+void test_ciaaDriverAio_dac(void) {
+   static uint16_t record[TEST_DAC_SAMPLES + 1];
+   uint64_t start;
+   uint64_t elapsed;
+   size_t loopi;
+   FILE * file;
+
+   for (loopi = 0; loopi < TEST_DAC_SAMPLES; loopi++)
+   {
+      txData[loopi] = (uint16_t)(loopi & 0x3FF);
+   }
+   ciaaDriverAio_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT, (void*)false);
+   ciaaDriverAio_ioctl(devices[1], ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT, (void*)false);
+   ciaaDriverAio_ioctl(devices[2], ciaaPOSIX_IOCTL_SET_SAMPLE_RATE, (void*)CIAADRVAIO_MAX_SAMPLE_RATE);
+
+   start = getNs();
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverAio_ioctl(devices[2], ciaaPOSIX_IOCTL_STARTTX, NULL));
+   TEST_ASSERT_EQUAL_INT(TEST_DAC_SAMPLES, waitConfirmed(TEST_DAC_SAMPLES));
+   elapsed = getNs() - start;
+   closeDevices();
+   printf("aio dac: %.0f samples/s\n",
+         (double)TEST_DAC_SAMPLES * 1e9 / (double)elapsed);
+
+   /* the output takes at least the time of the samples at the sample rate */
+   TEST_ASSERT_TRUE(elapsed >= 1000000000ULL / CIAADRVAIO_MAX_SAMPLE_RATE * TEST_DAC_SAMPLES);
+
+   file = fopen(CIAADRVAIO_RECORD_0, "rb");
+   TEST_ASSERT_NOT_NULL(file);
+   TEST_ASSERT_EQUAL_INT(TEST_DAC_SAMPLES, fread(record, sizeof(uint16_t), TEST_DAC_SAMPLES + 1, file));
+   fclose(file);
+   TEST_ASSERT_EQUAL_MEMORY(txData, record, sizeof(txData));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,213 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the aio sample stream
+ **
+ ** The DMA is simulated by writing the samples into the reserved blocks.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDriverAioStream.h"
+
+/*==================[macros and definitions]=================================*/
+#define BLOCK_SIZE      8
+#define BLOCK_COUNT     4
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief ring under test */
+static ciaaDriverAioStream_type stream;
+
+/** \brief storage of the blocks and the overrun block */
+static uint32_t buffer[(BLOCK_COUNT + 1) * BLOCK_SIZE];
+
+/** \brief storage of the timestamps */
+static uint32_t timestamps[BLOCK_COUNT];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief simulates the DMA filling a block with value */
+static void fillBlock(uint32_t * block, uint32_t value)
+{
+   uint32_t i;
+
+   for(i = 0; i < BLOCK_SIZE; i++)
+   {
+      block[i] = value;
+   }
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   ciaaDriverAioStream_init(&stream, buffer, timestamps, BLOCK_SIZE, BLOCK_COUNT);
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test that an empty ring has no blocks to read */
+void test_ciaaDriverAioStream_empty(void) {
+   uint32_t const * samples;
+   uint32_t timestamp;
+
+   TEST_ASSERT_FALSE(ciaaDriverAioStream_get(&stream, &samples, &timestamp));
+   TEST_ASSERT_FALSE(ciaaDriverAioStream_release(&stream));
+   TEST_ASSERT_NULL(ciaaDriverAioStream_filled(&stream, 0));
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverAioStream_overruns(&stream));
+}
+
+/** \brief test the ping-pong filling of the blocks */
+void test_ciaaDriverAioStream_pingPong(void) {
+   uint32_t * ping;
+   uint32_t * pong;
+   uint32_t const * samples;
+   uint32_t timestamp;
+
+   ping = ciaaDriverAioStream_fill(&stream);
+   pong = ciaaDriverAioStream_fill(&stream);
+   TEST_ASSERT_EQUAL_PTR(&buffer[0], ping);
+   TEST_ASSERT_EQUAL_PTR(&buffer[BLOCK_SIZE], pong);
+   /* only two blocks can be filled at the same time */
+   TEST_ASSERT_NULL(ciaaDriverAioStream_fill(&stream));
+
+   /* a block is not handed to the readers while it is filled */
+   TEST_ASSERT_FALSE(ciaaDriverAioStream_get(&stream, &samples, &timestamp));
+
+   fillBlock(ping, 0x11);
+   TEST_ASSERT_EQUAL_PTR(ping, ciaaDriverAioStream_filled(&stream, 100));
+   TEST_ASSERT_TRUE(ciaaDriverAioStream_get(&stream, &samples, &timestamp));
+   TEST_ASSERT_EQUAL_PTR(ping, samples);
+   TEST_ASSERT_EQUAL_UINT32(100, timestamp);
+   TEST_ASSERT_EQUAL_UINT32(0x11, samples[BLOCK_SIZE - 1]);
+
+   /* the freed slot gets the next block */
+   TEST_ASSERT_EQUAL_PTR(&buffer[2 * BLOCK_SIZE], ciaaDriverAioStream_fill(&stream));
+
+   fillBlock(pong, 0x22);
+   TEST_ASSERT_EQUAL_PTR(pong, ciaaDriverAioStream_filled(&stream, 200));
+
+   /* the blocks are read in order */
+   TEST_ASSERT_TRUE(ciaaDriverAioStream_get(&stream, &samples, &timestamp));
+   TEST_ASSERT_EQUAL_PTR(ping, samples);
+   TEST_ASSERT_TRUE(ciaaDriverAioStream_release(&stream));
+   TEST_ASSERT_TRUE(ciaaDriverAioStream_get(&stream, &samples, &timestamp));
+   TEST_ASSERT_EQUAL_PTR(pong, samples);
+   TEST_ASSERT_EQUAL_UINT32(200, timestamp);
+   TEST_ASSERT_TRUE(ciaaDriverAioStream_release(&stream));
+   TEST_ASSERT_FALSE(ciaaDriverAioStream_get(&stream, &samples, &timestamp));
+}
+
+/** \brief test the overrun block when the readers are too slow */
+void test_ciaaDriverAioStream_overrun(void) {
+   uint32_t const * samples;
+   uint32_t timestamp;
+   uint32_t i;
+
+   /* fill the whole ring without reading */
+   ciaaDriverAioStream_fill(&stream);
+   for(i = 0; i < BLOCK_COUNT; i++)
+   {
+      ciaaDriverAioStream_fill(&stream);
+      ciaaDriverAioStream_filled(&stream, i);
+   }
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverAioStream_overruns(&stream));
+
+   /* the in flight block is the overrun block, it is lost */
+   TEST_ASSERT_NULL(ciaaDriverAioStream_filled(&stream, 10));
+   TEST_ASSERT_EQUAL_UINT32(1, ciaaDriverAioStream_overruns(&stream));
+   TEST_ASSERT_EQUAL_PTR(&buffer[BLOCK_COUNT * BLOCK_SIZE], ciaaDriverAioStream_fill(&stream));
+
+   /* the blocks of the readers are untouched */
+   TEST_ASSERT_TRUE(ciaaDriverAioStream_get(&stream, &samples, &timestamp));
+   TEST_ASSERT_EQUAL_PTR(&buffer[0], samples);
+   TEST_ASSERT_EQUAL_UINT32(0, timestamp);
+
+   /* a released block is filled again */
+   TEST_ASSERT_TRUE(ciaaDriverAioStream_release(&stream));
+   TEST_ASSERT_EQUAL_PTR(&buffer[0], ciaaDriverAioStream_fill(&stream));
+   TEST_ASSERT_NULL(ciaaDriverAioStream_filled(&stream, 20));
+   TEST_ASSERT_EQUAL_PTR(&buffer[0], ciaaDriverAioStream_filled(&stream, 30));
+   TEST_ASSERT_EQUAL_UINT32(2, ciaaDriverAioStream_overruns(&stream));
+}
+
+/** \brief test the wrap around of the ring */
+void test_ciaaDriverAioStream_wrap(void) {
+   uint32_t const * samples;
+   uint32_t timestamp;
+   uint32_t * block;
+   uint32_t i;
+
+   ciaaDriverAioStream_fill(&stream);
+   for(i = 0; i < 3 * BLOCK_COUNT; i++)
+   {
+      ciaaDriverAioStream_fill(&stream);
+      block = ciaaDriverAioStream_filled(&stream, i);
+      fillBlock(block, i);
+
+      TEST_ASSERT_TRUE(ciaaDriverAioStream_get(&stream, &samples, &timestamp));
+      TEST_ASSERT_EQUAL_PTR(&buffer[(i % BLOCK_COUNT) * BLOCK_SIZE], samples);
+      TEST_ASSERT_EQUAL_UINT32(i, timestamp);
+      TEST_ASSERT_EQUAL_UINT32(i, samples[0]);
+      TEST_ASSERT_TRUE(ciaaDriverAioStream_release(&stream));
+   }
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverAioStream_overruns(&stream));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
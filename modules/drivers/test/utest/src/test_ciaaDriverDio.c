@@ -0,0 +1,351 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the x86 dio driver
+ **
+ ** The inputs follow a stimulus script written by the test and the record
+ ** of the outputs is read back by the test.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDriverDio.h"
+#include "ciaaDriverDio_Internal.h"
+#include "mock_ciaaDioDevices.h"
+#include "mock_ciaaPOSIX_string.h"
+#include "mock_ciaaDriverDioEvent.h"
+#include "ciaaPOSIX_ioctl_dio.h"
+#include "stdio.h"
+#include "string.h"
+#include "unistd.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief devices registered by the driver */
+static ciaaDevices_deviceType * devices[2];
+
+/** \brief state and timestamp of each sample of the inputs */
+static uint32_t sampleStates[16];
+static uint32_t sampleTimes[16];
+static int sampleCount;
+
+/** \brief samples left to the end of the settling of the inputs */
+static int settlingLeft;
+
+/** \brief last sampled state of the inputs */
+static uint32_t sampleState;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief keep the registered devices */
+static void dioAddDriver(ciaaDevices_deviceType * driver, int calls)
+{
+   devices[calls] = driver;
+}
+
+/** \brief record the samples, an edge settles during 3 samples */
+static uint32_t dioSample(ciaaDriverDioEvent_type * event, uint32_t state,
+      uint32_t timestamp, int calls)
+{
+   if (sampleCount < 16)
+   {
+      sampleStates[sampleCount] = state;
+      sampleTimes[sampleCount] = timestamp;
+      sampleCount++;
+   }
+   if (state != sampleState)
+   {
+      sampleState = state;
+      settlingLeft = 3;
+   }
+   if (0 < settlingLeft)
+   {
+      settlingLeft--;
+   }
+   event->settling = (0 != settlingLeft) ? 1 : 0;
+
+   return event->settling;
+}
+
+/** \brief select the inputs generating events */
+static void dioEnable(ciaaDriverDioEvent_type * event, uint32_t inputs,
+      int calls)
+{
+   event->enabled = inputs;
+}
+
+/** \brief two events are queued */
+static uint32_t dioCount(ciaaDriverDioEvent_type const * event, int calls)
+{
+   return 2;
+}
+
+/** \brief get two events */
+static uint32_t dioGet(ciaaDriverDioEvent_type * event,
+      ciaaPOSIX_dioEventType * events, uint32_t count, int calls)
+{
+   uint32_t ret = (2 < count) ? 2 : count;
+   uint32_t loopi;
+
+   for (loopi = 0; loopi < ret; loopi++)
+   {
+      events[loopi].timestamp = 1000 * loopi;
+      events[loopi].input = 0;
+      events[loopi].level = 1 - loopi;
+   }
+
+   return ret;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   FILE * file;
+
+   file = fopen(CIAADRVDIO_STIMULUS, "w");
+   TEST_ASSERT_NOT_NULL(file);
+   fputs("# inputs of the test\n"
+         "0 0x01\n"
+         "\n"
+         "20000 0x82\n"
+         "40000 0x1FF\n", file);
+   fclose(file);
+
+   ciaaDioDevices_addDriver_StubWithCallback(dioAddDriver);
+   memset(&ciaaDriverDio_dio0.event, 0, sizeof(ciaaDriverDio_dio0.event));
+   ciaaDriverDioEvent_init_Ignore();
+   ciaaDriverDioEvent_sample_StubWithCallback(dioSample);
+   sampleCount = 0;
+   settlingLeft = 0;
+   sampleState = 0;
+
+   ciaaDriverDio_init();
+   TEST_ASSERT_EQUAL_PTR(devices[0], ciaaDriverDio_open("/dev/dio/in/0", devices[0], 0));
+   TEST_ASSERT_EQUAL_PTR(devices[1], ciaaDriverDio_open("/dev/dio/out/0", devices[1], 0));
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+   ciaaDriverDio_close(devices[0]);
+   ciaaDriverDio_close(devices[1]);
+
+   remove(CIAADRVDIO_STIMULUS);
+   remove(CIAADRVDIO_RECORD);
+}
+
+/** \brief test the inputs following the stimulus */
+void test_ciaaDriverDio_inputs(void) {
+   uint8_t buffer[4] = { 0xAA, 0xAA, 0xAA, 0xAA };
+
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_read(devices[0], buffer, sizeof(buffer)));
+   TEST_ASSERT_EQUAL_HEX8(0x01, buffer[0]);
+   TEST_ASSERT_EQUAL_HEX8(0xAA, buffer[1]);
+
+   usleep(25000);
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_read(devices[0], buffer, sizeof(buffer)));
+   TEST_ASSERT_EQUAL_HEX8(0x82, buffer[0]);
+
+   usleep(20000);
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_read(devices[0], buffer, sizeof(buffer)));
+   TEST_ASSERT_EQUAL_HEX8(0xFF, buffer[0]);
+
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverDio_write(devices[0], buffer, 1));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverDio_read(devices[0], buffer, 0));
+}
+
+/** \brief test the outputs and their record */
+void test_ciaaDriverDio_outputs(void) {
+   uint8_t buffer[1];
+   unsigned long long time[3];
+   unsigned int state[3];
+   FILE * file;
+
+   buffer[0] = 0x05;
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_write(devices[1], buffer, 1));
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_write(devices[1], buffer, 1));
+   usleep(2000);
+   buffer[0] = 0xA0;
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_write(devices[1], buffer, 1));
+
+   buffer[0] = 0;
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_read(devices[1], buffer, 1));
+   TEST_ASSERT_EQUAL_HEX8(0xA0, buffer[0]);
+   ciaaDriverDio_close(devices[1]);
+
+   /* only the changes are recorded */
+   file = fopen(CIAADRVDIO_RECORD, "r");
+   TEST_ASSERT_NOT_NULL(file);
+   TEST_ASSERT_EQUAL_INT(2, fscanf(file, "%llu %x", &time[0], &state[0]));
+   TEST_ASSERT_EQUAL_INT(2, fscanf(file, "%llu %x", &time[1], &state[1]));
+   TEST_ASSERT_EQUAL_INT(EOF, fscanf(file, "%llu %x", &time[2], &state[2]));
+   fclose(file);
+
+   TEST_ASSERT_EQUAL_HEX32(0x05, state[0]);
+   TEST_ASSERT_EQUAL_HEX32(0xA0, state[1]);
+   TEST_ASSERT_TRUE(time[1] >= time[0] + 2000);
+
+   TEST_ASSERT_EQUAL_PTR(devices[1], ciaaDriverDio_open("/dev/dio/out/0", devices[1], 0));
+}
+
+/** \brief test the set, clear and toggle of the outputs */
+void test_ciaaDriverDio_ioctl(void) {
+   uint8_t buffer[1];
+   unsigned long long time;
+   unsigned int state[4];
+   FILE * file;
+
+   buffer[0] = 0x81;
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_write(devices[1], buffer, 1));
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverDio_ioctl(devices[1], ciaaPOSIX_IOCTL_DIO_SET, (void *)0x06));
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_read(devices[1], buffer, 1));
+   TEST_ASSERT_EQUAL_HEX8(0x87, buffer[0]);
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverDio_ioctl(devices[1], ciaaPOSIX_IOCTL_DIO_CLEAR, (void *)0x82));
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_read(devices[1], buffer, 1));
+   TEST_ASSERT_EQUAL_HEX8(0x05, buffer[0]);
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverDio_ioctl(devices[1], ciaaPOSIX_IOCTL_DIO_TOGGLE, (void *)0x0F));
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_read(devices[1], buffer, 1));
+   TEST_ASSERT_EQUAL_HEX8(0x0A, buffer[0]);
+
+   /* the outputs not managed are ignored */
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverDio_ioctl(devices[1], ciaaPOSIX_IOCTL_DIO_SET, (void *)0x100));
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_read(devices[1], buffer, 1));
+   TEST_ASSERT_EQUAL_HEX8(0x0A, buffer[0]);
+
+   /* the inputs can not be written and unknown requests fail */
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverDio_ioctl(devices[0], ciaaPOSIX_IOCTL_DIO_SET, (void *)0x01));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverDio_ioctl(devices[1], 0, NULL));
+   ciaaDriverDio_close(devices[1]);
+
+   /* each change is recorded */
+   file = fopen(CIAADRVDIO_RECORD, "r");
+   TEST_ASSERT_NOT_NULL(file);
+   TEST_ASSERT_EQUAL_INT(2, fscanf(file, "%llu %x", &time, &state[0]));
+   TEST_ASSERT_EQUAL_INT(2, fscanf(file, "%llu %x", &time, &state[1]));
+   TEST_ASSERT_EQUAL_INT(2, fscanf(file, "%llu %x", &time, &state[2]));
+   TEST_ASSERT_EQUAL_INT(2, fscanf(file, "%llu %x", &time, &state[3]));
+   TEST_ASSERT_EQUAL_INT(EOF, fscanf(file, "%llu %x", &time, &state[0]));
+   fclose(file);
+
+   TEST_ASSERT_EQUAL_HEX32(0x81, state[0]);
+   TEST_ASSERT_EQUAL_HEX32(0x87, state[1]);
+   TEST_ASSERT_EQUAL_HEX32(0x05, state[2]);
+   TEST_ASSERT_EQUAL_HEX32(0x0A, state[3]);
+
+   TEST_ASSERT_EQUAL_PTR(devices[1], ciaaDriverDio_open("/dev/dio/out/0", devices[1], 0));
+}
+
+/** \brief test the pin interrupts, debounce samples and events */
+void test_ciaaDriverDio_events(void) {
+   ciaaPOSIX_dioDebounceType debounce = { 0x01, 5 };
+   ciaaPOSIX_dioEventType events[4];
+   FILE * file;
+
+   /* a bouncing rising edge of the input 0 */
+   ciaaDriverDio_close(devices[0]);
+   file = fopen(CIAADRVDIO_STIMULUS, "w");
+   TEST_ASSERT_NOT_NULL(file);
+   fputs("10000 0x01\n"
+         "10300 0x00\n"
+         "10500 0x01\n", file);
+   fclose(file);
+   TEST_ASSERT_EQUAL_PTR(devices[0], ciaaDriverDio_open("/dev/dio/in/0", devices[0], 0));
+
+   ciaaDriverDioEvent_setDebounce_Expect(&ciaaDriverDio_dio0.event, 0x01, 5);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverDio_ioctl(devices[0], ciaaPOSIX_IOCTL_DIO_SET_DEBOUNCE, &debounce));
+
+   /* only the inputs can be enabled */
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverDio_ioctl(devices[0], ciaaPOSIX_IOCTL_DIO_SET_EVENTS, (void *)0x100));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverDio_ioctl(devices[1], ciaaPOSIX_IOCTL_DIO_SET_EVENTS, (void *)0x01));
+
+   ciaaDriverDioEvent_enable_StubWithCallback(dioEnable);
+   ciaaDriverDioEvent_count_StubWithCallback(dioCount);
+   ciaaDriverDioEvent_get_StubWithCallback(dioGet);
+   ciaaDioDevices_eventIndication_Ignore();
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverDio_ioctl(devices[0], ciaaPOSIX_IOCTL_DIO_SET_EVENTS, (void *)0x01));
+   usleep(15000);
+
+   /* each edge at its time, then the debounce samples while settling */
+   TEST_ASSERT_EQUAL_INT(5, sampleCount);
+   TEST_ASSERT_EQUAL_UINT32(10000, sampleTimes[0]);
+   TEST_ASSERT_EQUAL_UINT32(10300, sampleTimes[1]);
+   TEST_ASSERT_EQUAL_UINT32(10500, sampleTimes[2]);
+   TEST_ASSERT_EQUAL_UINT32(11000, sampleTimes[3]);
+   TEST_ASSERT_EQUAL_UINT32(12000, sampleTimes[4]);
+   TEST_ASSERT_EQUAL_HEX32(0x01, sampleStates[0]);
+   TEST_ASSERT_EQUAL_HEX32(0x00, sampleStates[1]);
+   TEST_ASSERT_EQUAL_HEX32(0x01, sampleStates[2]);
+   TEST_ASSERT_EQUAL_HEX32(0x01, sampleStates[4]);
+
+   /* whole events are read */
+   TEST_ASSERT_EQUAL_INT(2, ciaaDriverDio_ioctl(devices[0], ciaaPOSIX_IOCTL_DIO_GET_EVENT_COUNT, NULL));
+   TEST_ASSERT_EQUAL_INT(sizeof(ciaaPOSIX_dioEventType), ciaaDriverDio_read(devices[0], (uint8_t *)events, sizeof(ciaaPOSIX_dioEventType) + 1));
+   TEST_ASSERT_EQUAL_INT(2 * sizeof(ciaaPOSIX_dioEventType), ciaaDriverDio_read(devices[0], (uint8_t *)events, sizeof(events)));
+   TEST_ASSERT_EQUAL_UINT32(1000, events[1].timestamp);
+   TEST_ASSERT_EQUAL_UINT8(0, events[1].level);
+
+   /* disabled the state of the inputs is read again */
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverDio_ioctl(devices[0], ciaaPOSIX_IOCTL_DIO_SET_EVENTS, NULL));
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverDio_read(devices[0], (uint8_t *)events, 1));
+   TEST_ASSERT_EQUAL_HEX8(0x01, ((uint8_t *)events)[0]);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
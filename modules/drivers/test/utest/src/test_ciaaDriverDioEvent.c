@@ -0,0 +1,191 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the dio edge events
+ **
+ ** The pin interrupts and the debounce period are simulated by calling the
+ ** sample function with the raw state of the inputs.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDriverDioEvent.h"
+
+/*==================[macros and definitions]=================================*/
+#define QUEUE_SIZE      8
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief events under test */
+static ciaaDriverDioEvent_type event;
+
+/** \brief storage of the queue */
+static ciaaPOSIX_dioEventType queue[QUEUE_SIZE];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief checks the next queued event */
+static void checkEvent(uint32_t timestamp, uint8_t input, uint8_t level)
+{
+   ciaaPOSIX_dioEventType got;
+
+   TEST_ASSERT_EQUAL_UINT32(1, ciaaDriverDioEvent_get(&event, &got, 1));
+   TEST_ASSERT_EQUAL_UINT32(timestamp, got.timestamp);
+   TEST_ASSERT_EQUAL_UINT8(input, got.input);
+   TEST_ASSERT_EQUAL_UINT8(level, got.level);
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   ciaaDriverDioEvent_init(&event, queue, QUEUE_SIZE, 0x01);
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test the edges without debounce */
+void test_ciaaDriverDioEvent_edges(void) {
+   /* no events before they are enabled */
+   TEST_ASSERT_EQUAL_HEX32(0, ciaaDriverDioEvent_sample(&event, 0x03, 10));
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverDioEvent_count(&event));
+
+   ciaaDriverDioEvent_enable(&event, 0x05);
+   TEST_ASSERT_EQUAL_HEX32(0, ciaaDriverDioEvent_sample(&event, 0x06, 20));
+   /* the input 1 is not enabled */
+   TEST_ASSERT_EQUAL_UINT32(2, ciaaDriverDioEvent_count(&event));
+   checkEvent(20, 0, 0);
+   checkEvent(20, 2, 1);
+
+   TEST_ASSERT_EQUAL_HEX32(0, ciaaDriverDioEvent_sample(&event, 0x06, 30));
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverDioEvent_count(&event));
+
+   TEST_ASSERT_EQUAL_HEX32(0, ciaaDriverDioEvent_sample(&event, 0x03, 40));
+   checkEvent(40, 0, 1);
+   checkEvent(40, 2, 0);
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverDioEvent_count(&event));
+}
+
+/** \brief test a bouncing edge and a glitch with debounce */
+void test_ciaaDriverDioEvent_debounce(void) {
+   ciaaDriverDioEvent_enable(&event, 0x02);
+   ciaaDriverDioEvent_setDebounce(&event, 0x02, 3);
+
+   /* bouncing rising edge, the integrator goes 1 0 and is stable again */
+   TEST_ASSERT_EQUAL_HEX32(0x02, ciaaDriverDioEvent_sample(&event, 0x03, 100));
+   TEST_ASSERT_EQUAL_HEX32(0, ciaaDriverDioEvent_sample(&event, 0x01, 150));
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverDioEvent_count(&event));
+   TEST_ASSERT_EQUAL_HEX32(0, ciaaDriverDioEvent_sample(&event, 0x01, 1000));
+   /* then 1 2 3 */
+   TEST_ASSERT_EQUAL_HEX32(0x02, ciaaDriverDioEvent_sample(&event, 0x03, 1200));
+   TEST_ASSERT_EQUAL_HEX32(0x02, ciaaDriverDioEvent_sample(&event, 0x03, 2000));
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverDioEvent_count(&event));
+   TEST_ASSERT_EQUAL_HEX32(0, ciaaDriverDioEvent_sample(&event, 0x03, 3000));
+   /* reported once with the time of its first edge */
+   checkEvent(1200, 1, 1);
+   TEST_ASSERT_EQUAL_HEX32(0x03, event.state);
+
+   /* a glitch shorter than the debounce is filtered */
+   TEST_ASSERT_EQUAL_HEX32(0x02, ciaaDriverDioEvent_sample(&event, 0x01, 4000));
+   TEST_ASSERT_EQUAL_HEX32(0x02, ciaaDriverDioEvent_sample(&event, 0x01, 5000));
+   TEST_ASSERT_EQUAL_HEX32(0x02, ciaaDriverDioEvent_sample(&event, 0x03, 5500));
+   TEST_ASSERT_EQUAL_HEX32(0, ciaaDriverDioEvent_sample(&event, 0x03, 6000));
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverDioEvent_count(&event));
+
+   /* falling edge */
+   TEST_ASSERT_EQUAL_HEX32(0x02, ciaaDriverDioEvent_sample(&event, 0x01, 7000));
+   TEST_ASSERT_EQUAL_HEX32(0x02, ciaaDriverDioEvent_sample(&event, 0x01, 8000));
+   TEST_ASSERT_EQUAL_HEX32(0, ciaaDriverDioEvent_sample(&event, 0x01, 9000));
+   checkEvent(7000, 1, 0);
+
+   /* the input 0 is not debounced but follows each edge */
+   TEST_ASSERT_EQUAL_HEX32(0, ciaaDriverDioEvent_sample(&event, 0x00, 9500));
+   TEST_ASSERT_EQUAL_HEX32(0x00, event.state);
+}
+
+/** \brief test the queue of events */
+void test_ciaaDriverDioEvent_queue(void) {
+   ciaaPOSIX_dioEventType got[QUEUE_SIZE];
+   uint32_t loopi;
+
+   ciaaDriverDioEvent_enable(&event, 0x01);
+
+   /* the events which do not fit are lost */
+   for(loopi = 0; loopi < QUEUE_SIZE + 2; loopi++)
+   {
+      ciaaDriverDioEvent_sample(&event, loopi & 1, loopi);
+   }
+   TEST_ASSERT_EQUAL_UINT32(QUEUE_SIZE, ciaaDriverDioEvent_count(&event));
+   TEST_ASSERT_EQUAL_UINT32(2, event.overruns);
+
+   /* partial reads keep the order */
+   TEST_ASSERT_EQUAL_UINT32(3, ciaaDriverDioEvent_get(&event, got, 3));
+   TEST_ASSERT_EQUAL_UINT32(0, got[0].timestamp);
+   TEST_ASSERT_EQUAL_UINT32(2, got[2].timestamp);
+   TEST_ASSERT_EQUAL_UINT32(QUEUE_SIZE - 3, ciaaDriverDioEvent_get(&event, got, QUEUE_SIZE));
+   TEST_ASSERT_EQUAL_UINT32(QUEUE_SIZE - 1, got[QUEUE_SIZE - 4].timestamp);
+   TEST_ASSERT_EQUAL_UINT8(1, got[QUEUE_SIZE - 4].level);
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverDioEvent_get(&event, got, QUEUE_SIZE));
+
+   /* disabling discards the queued events */
+   ciaaDriverDioEvent_sample(&event, 0, 100);
+   ciaaDriverDioEvent_enable(&event, 0);
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverDioEvent_count(&event));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
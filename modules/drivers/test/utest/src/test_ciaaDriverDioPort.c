@@ -0,0 +1,284 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the dio port access
+ **
+ ** The gather and scatter of the ports are compared against a per pin
+ ** reference with the board pin tables and with random pin tables.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDriverDioPort.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief count of random values tested per table */
+#define VALUES          1000
+
+/** \brief count of random tables */
+#define TABLES          200
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief inputs of the ciaa_nxp board */
+static const ciaaDriverDioPort_pinType ciaaNxpInputs[] = {
+   {2,0},{2,1},{2,2},{2,3},{3,11},{3,12},{3,13},{3,14} };
+
+/** \brief outputs of the ciaa_nxp board */
+static const ciaaDriverDioPort_pinType ciaaNxpOutputs[] = {
+   {5,1},{2,6},{2,5},{2,4},{5,12},{5,13},{5,14},{1,8} };
+
+/** \brief inputs of the edu_ciaa_nxp board */
+static const ciaaDriverDioPort_pinType eduCiaaNxpInputs[] = {
+   {0,4},{0,8},{0,9},{1,9} };
+
+/** \brief outputs of the edu_ciaa_nxp board */
+static const ciaaDriverDioPort_pinType eduCiaaNxpOutputs[] = {
+   {5,0},{5,1},{5,2},{0,14},{1,11},{1,12},{3,0},{3,3},{3,4} };
+
+/** \brief table under test */
+static ciaaDriverDioPort_tableType table;
+
+/** \brief state of the pseudo random generator */
+static uint32_t seed;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief pseudo random 32 bits value */
+static uint32_t random32(void)
+{
+   seed = seed * 1664525 + 1013904223;
+   return (seed & 0xFFFF0000) | ((seed * 1664525 + 1013904223) >> 16);
+}
+
+/** \brief per pin reference of the gather of all ports */
+static uint32_t gatherPerPin(ciaaDriverDioPort_pinType const * pins,
+      uint32_t count, uint32_t const * registers)
+{
+   uint32_t ret = 0;
+   uint32_t i;
+
+   for(i = 0; i < count; i++)
+   {
+      ret |= ((registers[pins[i].port] >> pins[i].pin) & 1) << i;
+   }
+
+   return ret;
+}
+
+/** \brief per pin reference of the scatter in a port */
+static uint32_t scatterPerPin(ciaaDriverDioPort_pinType const * pins,
+      uint32_t count, uint32_t port, uint32_t state)
+{
+   uint32_t ret = 0;
+   uint32_t i;
+
+   for(i = 0; i < count; i++)
+   {
+      if((pins[i].port == port) && (0 != (state & ((uint32_t)1 << i))))
+      {
+         ret |= (uint32_t)1 << pins[i].pin;
+      }
+   }
+
+   return ret;
+}
+
+/** \brief compares the table against the per pin reference */
+static void checkTable(ciaaDriverDioPort_pinType const * pins, uint32_t count)
+{
+   uint32_t registers[CIAADRVDIOPORT_MAX_PORTS * 2];
+   uint32_t state;
+   uint32_t mask;
+   uint32_t i;
+   uint32_t v;
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverDioPort_init(&table, pins, count));
+   TEST_ASSERT_EQUAL_UINT8(count, table.pinCount);
+
+   mask = (count < 32) ? (((uint32_t)1 << count) - 1) : 0xFFFFFFFF;
+   for(v = 0; v < VALUES; v++)
+   {
+      for(i = 0; i < sizeof(registers) / sizeof(registers[0]); i++)
+      {
+         registers[i] = random32();
+      }
+
+      /* one register read per port */
+      state = 0;
+      for(i = 0; i < table.portCount; i++)
+      {
+         state |= ciaaDriverDioPort_gather(&table, i, registers[table.ports[i].port]);
+      }
+      TEST_ASSERT_EQUAL_HEX32(gatherPerPin(pins, count, registers), state);
+
+      /* the scatter only touches the managed pins of the port */
+      state = random32();
+      for(i = 0; i < table.portCount; i++)
+      {
+         TEST_ASSERT_EQUAL_HEX32(scatterPerPin(pins, count, table.ports[i].port, state),
+               ciaaDriverDioPort_scatter(&table, i, state));
+         TEST_ASSERT_EQUAL_HEX32(table.ports[i].mask,
+               ciaaDriverDioPort_scatter(&table, i, mask));
+      }
+   }
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   seed = 0x1234567;
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test the pin tables of the boards */
+void test_ciaaDriverDioPort_boards(void) {
+   checkTable(ciaaNxpInputs, 8);
+   TEST_ASSERT_EQUAL_UINT8(2, table.portCount);
+   /* each port is a single run */
+   TEST_ASSERT_EQUAL_UINT8(1, table.ports[0].count);
+   TEST_ASSERT_EQUAL_UINT8(1, table.ports[1].count);
+   TEST_ASSERT_TRUE(table.ports[0].ordered);
+   TEST_ASSERT_TRUE(table.ports[1].ordered);
+
+   checkTable(ciaaNxpOutputs, 8);
+   TEST_ASSERT_EQUAL_UINT8(3, table.portCount);
+   /* the relays of port 2 are in reverse order */
+   TEST_ASSERT_EQUAL_UINT32(2, table.ports[1].port);
+   TEST_ASSERT_EQUAL_UINT8(3, table.ports[1].count);
+   TEST_ASSERT_FALSE(table.ports[1].ordered);
+
+   checkTable(eduCiaaNxpInputs, 4);
+   TEST_ASSERT_EQUAL_UINT8(2, table.portCount);
+   TEST_ASSERT_TRUE(table.ports[0].ordered);
+
+   checkTable(eduCiaaNxpOutputs, 9);
+   TEST_ASSERT_EQUAL_UINT8(4, table.portCount);
+}
+
+/** \brief test random pin tables */
+void test_ciaaDriverDioPort_random(void) {
+   ciaaDriverDioPort_pinType pins[CIAADRVDIOPORT_MAX_PINS];
+   uint32_t used[CIAADRVDIOPORT_MAX_PORTS * 2];
+   uint32_t count;
+   uint32_t ports;
+   uint32_t t;
+   uint32_t i;
+
+   for(t = 0; t < TABLES; t++)
+   {
+      count = 1 + random32() % CIAADRVDIOPORT_MAX_PINS;
+      /* port numbers are not consecutive */
+      ports = 1 + random32() % CIAADRVDIOPORT_MAX_PORTS;
+      for(i = 0; i < sizeof(used) / sizeof(used[0]); i++)
+      {
+         used[i] = 0;
+      }
+
+      /* each pin is used once */
+      for(i = 0; i < count; i++)
+      {
+         do
+         {
+            pins[i].port = (random32() % ports) * 2;
+            pins[i].pin = random32() % 32;
+         } while(0 != (used[pins[i].port] & ((uint32_t)1 << pins[i].pin)));
+         used[pins[i].port] |= (uint32_t)1 << pins[i].pin;
+      }
+
+      checkTable(pins, count);
+   }
+}
+
+/** \brief test the limits of the table */
+void test_ciaaDriverDioPort_limits(void) {
+   ciaaDriverDioPort_pinType pins[CIAADRVDIOPORT_MAX_PINS + 1];
+   uint32_t i;
+
+   /* all the pins of a port */
+   for(i = 0; i < 32; i++)
+   {
+      pins[i].port = 3;
+      pins[i].pin = 31 - i;
+   }
+   checkTable(pins, 32);
+   TEST_ASSERT_EQUAL_UINT8(1, table.portCount);
+   TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, table.ports[0].mask);
+
+   /* too many pins */
+   pins[32].port = 4;
+   pins[32].pin = 0;
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverDioPort_init(&table, pins, 33));
+
+   /* too many ports */
+   for(i = 0; i <= CIAADRVDIOPORT_MAX_PORTS; i++)
+   {
+      pins[i].port = i;
+      pins[i].pin = i;
+   }
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverDioPort_init(&table, pins, CIAADRVDIOPORT_MAX_PORTS + 1));
+   TEST_ASSERT_EQUAL_UINT8(0, table.portCount);
+
+   /* no pins */
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverDioPort_init(&table, pins, 0));
+   TEST_ASSERT_EQUAL_UINT8(0, table.portCount);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,327 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the Ethernet driver for x86
+ **
+ ** Several ports are opened on the virtual wire in the test process, the
+ ** last test runs a second board in a thread which echoes the frames and
+ ** reports the round trip time and the throughput.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDriverEth.h"
+#include "ciaaDriverEth_Internal.h"
+#include "poll.h"
+#include "pthread.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief round trips of the latency benchmark */
+#define BENCH_ROUND_TRIPS     20000
+
+/** \brief frames of the throughput benchmark */
+#define BENCH_FRAMES          200000
+
+/** \brief size of the frames of the throughput benchmark */
+#define BENCH_FRAME_SIZE      1514
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief ports of the test */
+static ciaaDriverEth_ethType eth[3];
+
+/** \brief the echo board is running */
+static volatile bool echoRunning;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/** \brief queue a frame from port src to node dst */
+static void sendFrame(ciaaDriverEth_ethType * src, uint8_t const * dst,
+      uint16_t length, uint32_t seq)
+{
+   uint8_t * frame = ciaaDriverEth_getTxBuffer(src);
+
+   memcpy(&frame[0], dst, 6);
+   memcpy(&frame[6], src->mac, 6);
+   frame[12] = 0x88;
+   frame[13] = 0xB5;
+   memcpy(&frame[14], &seq, sizeof(seq));
+   ciaaDriverEth_send(src, length);
+}
+
+/** \brief wait up to 1 s for frames on a port
+ **
+ ** The boards sleep while waiting, so the benchmark also works on a single
+ ** cpu.
+ **/
+static uint32_t receiveFrames(ciaaDriverEth_ethType * port)
+{
+   struct pollfd pfd = { port->fd, POLLIN, 0 };
+   uint32_t ret = 0;
+
+   if (0 < poll(&pfd, 1, 1000))
+   {
+      ret = ciaaDriverEth_receive(port);
+   }
+
+   return ret;
+}
+
+/** \brief second board, echoes every frame to its source
+ **
+ ** Works like ciaaDriverEth_mainFunction: one batch received, one batch
+ ** sent per loop.
+ **/
+static void * echoBoard(void * arg)
+{
+   ciaaDriverEth_ethType * port = arg;
+   struct pollfd pfd = { port->fd, POLLIN, 0 };
+   uint32_t count;
+   uint32_t loopi;
+   uint8_t * frame;
+
+   while (echoRunning)
+   {
+      poll(&pfd, 1, 10);
+      count = ciaaDriverEth_receive(port);
+      for (loopi = 0; loopi < count; loopi++)
+      {
+         frame = ciaaDriverEth_getTxBuffer(port);
+         memcpy(&frame[0], &port->rx[loopi].data[6], 6);
+         memcpy(&frame[6], port->mac, 6);
+         memcpy(&frame[12], &port->rx[loopi].data[12],
+               port->rx[loopi].length - 12);
+         ciaaDriverEth_send(port, port->rx[loopi].length);
+      }
+      ciaaDriverEth_flush(port);
+   }
+
+   return NULL;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverEth_openPort(&eth[0], 1));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverEth_openPort(&eth[1], 2));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverEth_openPort(&eth[2], 3));
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+   ciaaDriverEth_closePort(&eth[0]);
+   ciaaDriverEth_closePort(&eth[1]);
+   ciaaDriverEth_closePort(&eth[2]);
+}
+
+/** \brief test a unicast frame */
+void test_ciaaDriverEth_unicast(void) {
+   uint32_t seq;
+
+   TEST_ASSERT_EQUAL_HEX8(0x02, eth[1].mac[0]);
+   TEST_ASSERT_EQUAL_HEX8(2, eth[1].mac[5]);
+
+   sendFrame(&eth[0], eth[1].mac, 60, 0x12345678);
+   /* nothing is sent before the flush */
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverEth_receive(&eth[1]));
+   ciaaDriverEth_flush(&eth[0]);
+
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverEth_receive(&eth[1]));
+   TEST_ASSERT_EQUAL_INT(60, eth[1].rx[0].length);
+   TEST_ASSERT_EQUAL_MEMORY(eth[1].mac, &eth[1].rx[0].data[0], 6);
+   TEST_ASSERT_EQUAL_MEMORY(eth[0].mac, &eth[1].rx[0].data[6], 6);
+   memcpy(&seq, &eth[1].rx[0].data[14], sizeof(seq));
+   TEST_ASSERT_EQUAL_HEX32(0x12345678, seq);
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverEth_receive(&eth[2]));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverEth_receive(&eth[0]));
+   TEST_ASSERT_EQUAL_UINT32(1, eth[0].txFrames);
+   TEST_ASSERT_EQUAL_UINT32(0, eth[0].txDropped);
+}
+
+/** \brief test a broadcast frame */
+void test_ciaaDriverEth_broadcast(void) {
+   static uint8_t const broadcast[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+   sendFrame(&eth[1], broadcast, 42, 1);
+
+   /* broadcasts are sent at once */
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverEth_receive(&eth[0]));
+   TEST_ASSERT_EQUAL_INT(42, eth[0].rx[0].length);
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverEth_receive(&eth[2]));
+   TEST_ASSERT_EQUAL_MEMORY(broadcast, eth[2].rx[0].data, 6);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverEth_receive(&eth[1]));
+}
+
+/** \brief test frames to absent nodes and foreign addresses */
+void test_ciaaDriverEth_dropped(void) {
+   uint8_t absent[6];
+   static uint8_t const foreign[6] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x02 };
+
+   memcpy(absent, eth[0].mac, 6);
+   absent[5] = 9;
+
+   sendFrame(&eth[0], absent, 60, 1);
+   sendFrame(&eth[0], eth[2].mac, 60, 2);
+   sendFrame(&eth[0], foreign, 60, 3);
+   ciaaDriverEth_flush(&eth[0]);
+
+   TEST_ASSERT_EQUAL_UINT32(3, eth[0].txFrames);
+   TEST_ASSERT_EQUAL_UINT32(2, eth[0].txDropped);
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverEth_receive(&eth[2]));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverEth_receive(&eth[1]));
+}
+
+/** \brief test the batches */
+void test_ciaaDriverEth_batch(void) {
+   uint32_t loopi;
+   uint32_t seq;
+
+   /* the queue is sent when full */
+   for (loopi = 0; loopi < CIAADRVETH_BATCH + 2; loopi++)
+   {
+      sendFrame(&eth[0], eth[1].mac, 100 + loopi, loopi);
+   }
+   TEST_ASSERT_EQUAL_UINT32(2, eth[0].txCount);
+   ciaaDriverEth_flush(&eth[0]);
+
+   TEST_ASSERT_EQUAL_INT(CIAADRVETH_BATCH, ciaaDriverEth_receive(&eth[1]));
+   for (loopi = 0; loopi < CIAADRVETH_BATCH; loopi++)
+   {
+      memcpy(&seq, &eth[1].rx[loopi].data[14], sizeof(seq));
+      TEST_ASSERT_EQUAL_UINT32(loopi, seq);
+      TEST_ASSERT_EQUAL_INT(100 + loopi, eth[1].rx[loopi].length);
+   }
+   TEST_ASSERT_EQUAL_INT(2, ciaaDriverEth_receive(&eth[1]));
+   TEST_ASSERT_EQUAL_UINT32(CIAADRVETH_BATCH + 2, eth[1].rxFrames);
+   TEST_ASSERT_EQUAL_UINT32(0, eth[0].txDropped);
+}
+
+/** \brief echo benchmark between two boards */
+void test_ciaaDriverEth_benchmark(void) {
+   pthread_t echo;
+   uint64_t start;
+   uint64_t ns;
+   uint32_t loopi;
+   uint32_t sent = 0;
+   uint32_t received = 0;
+
+   echoRunning = true;
+   TEST_ASSERT_EQUAL_INT(0, pthread_create(&echo, NULL, echoBoard, &eth[1]));
+
+   /* latency, one frame of minimal size at a time */
+   start = getNs();
+   for (loopi = 0; loopi < BENCH_ROUND_TRIPS; loopi++)
+   {
+      sendFrame(&eth[0], eth[1].mac, 60, loopi);
+      ciaaDriverEth_flush(&eth[0]);
+      if (1 != receiveFrames(&eth[0]))
+      {
+         break;
+      }
+   }
+   ns = getNs() - start;
+   printf("eth echo: %.1f us round trip\n",
+         (double)ns / BENCH_ROUND_TRIPS / 1000.0);
+
+   /* throughput, a batch of full frames in flight */
+   start = getNs();
+   while (received < BENCH_FRAMES)
+   {
+      while ((sent < BENCH_FRAMES) &&
+            (sent - received < CIAADRVETH_BATCH))
+      {
+         sendFrame(&eth[0], eth[1].mac, BENCH_FRAME_SIZE, sent);
+         sent++;
+      }
+      ciaaDriverEth_flush(&eth[0]);
+      received += receiveFrames(&eth[0]);
+
+      if ((0 != eth[0].txDropped) || (0 != eth[1].txDropped))
+      {
+         break;
+      }
+   }
+   ns = getNs() - start;
+
+   echoRunning = false;
+   pthread_join(echo, NULL);
+
+   printf("eth echo: %.0f frames/s, %.1f MB/s each direction\n",
+         (double)received * 1e9 / ns,
+         (double)received * BENCH_FRAME_SIZE * 1e3 / ns);
+
+   TEST_ASSERT_EQUAL_UINT32(BENCH_ROUND_TRIPS, loopi);
+   TEST_ASSERT_EQUAL_UINT32(BENCH_FRAMES, received);
+   TEST_ASSERT_EQUAL_UINT32(0, eth[0].txDropped);
+   TEST_ASSERT_EQUAL_UINT32(0, eth[1].txDropped);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+
@@ -0,0 +1,315 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the test of the ethernet descriptor ring
+ **
+ ** The DMA is emulated by clearing the own bit of the descriptors, the poll
+ ** demand of the DMA is mocked.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDriverEthRing.h"
+#include "mock_ciaaDriverEthRingHw.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief count of descriptors of the test ring */
+#define RING_SIZE          4
+
+/** \brief count of buffers of the test pool */
+#define POOL_SIZE          6
+
+/** \brief size of the buffers of the test pool */
+#define BUF_SIZE           16
+
+/** \brief end of ring bits of the test ring */
+#define END_STATUS         0x00200000UL
+#define END_CTRL           0x00008000UL
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief ring under test */
+static ciaaDriverEthRing_type ring;
+
+/** \brief descriptors of the ring */
+static ciaaDriverEthRing_descType desc[RING_SIZE];
+
+/** \brief buffers kept by the descriptors */
+static void * ringBufs[RING_SIZE];
+
+/** \brief DMA passed to the hardware functions */
+static int hw;
+
+/** \brief pool under test */
+static ciaaDriverEthRing_poolType pool;
+
+/** \brief free buffers of the pool */
+static void * poolFree[POOL_SIZE];
+
+/** \brief buffers of the pool */
+static uint8_t poolBufs[POOL_SIZE][BUF_SIZE];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief the DMA writes a descriptor and releases it */
+static void dmaRelease(uint32_t idx, uint32_t status)
+{
+   desc[idx].status = status;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   ciaaDriverEthRing_init(&ring, desc, ringBufs, RING_SIZE, &hw,
+         END_STATUS, END_CTRL);
+   ciaaDriverEthRing_poolInit(&pool, poolFree, poolBufs, POOL_SIZE,
+         BUF_SIZE);
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test that an empty ring has nothing to take back */
+void test_ciaaDriverEthRing_empty(void) {
+   void * buf;
+   uint32_t status;
+
+   TEST_ASSERT_EQUAL_UINT32(RING_SIZE, ciaaDriverEthRing_free(&ring));
+   TEST_ASSERT_FALSE(ciaaDriverEthRing_ready(&ring));
+   TEST_ASSERT_FALSE(ciaaDriverEthRing_take(&ring, &buf, &status));
+}
+
+/** \brief test the wrap around of the receive descriptors */
+void test_ciaaDriverEthRing_rxWrap(void) {
+   void * buf;
+   uint32_t status;
+   uint32_t idx;
+
+   /* all the descriptors are given to the DMA */
+   for (idx = 0; idx < RING_SIZE; idx++)
+   {
+      TEST_ASSERT_EQUAL_INT(idx, ciaaDriverEthRing_put(&ring,
+               poolBufs[idx], 0x1000 + idx, 0x100 + idx, 0, true));
+      TEST_ASSERT_EQUAL_HEX32(CIAADRVETHRING_OWN, desc[idx].status &
+            CIAADRVETHRING_OWN);
+      TEST_ASSERT_EQUAL_HEX32(0x1000 + idx, desc[idx].addr);
+   }
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDriverEthRing_put(&ring, poolBufs[4],
+            0x2000, 0x100, 0, true));
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverEthRing_free(&ring));
+
+   /* only the last descriptor marks the end of the ring */
+   TEST_ASSERT_EQUAL_HEX32(0x101, desc[1].ctrl);
+   TEST_ASSERT_EQUAL_HEX32(0x103 | END_CTRL, desc[3].ctrl);
+   TEST_ASSERT_EQUAL_HEX32(CIAADRVETHRING_OWN | END_STATUS, desc[3].status);
+
+   /* a descriptor owned by the DMA is not taken back */
+   TEST_ASSERT_FALSE(ciaaDriverEthRing_take(&ring, &buf, &status));
+
+   /* the frames are taken back in order and the freed descriptor is used
+    * again after the last one */
+   for (idx = 0; idx < 2 * RING_SIZE; idx++)
+   {
+      dmaRelease(idx % RING_SIZE, 0x40 + idx);
+      TEST_ASSERT_TRUE(ciaaDriverEthRing_ready(&ring));
+      TEST_ASSERT_TRUE(ciaaDriverEthRing_take(&ring, &buf, &status));
+      TEST_ASSERT_EQUAL_PTR(poolBufs[idx % POOL_SIZE], buf);
+      TEST_ASSERT_EQUAL_HEX32(0x40 + idx, status);
+      TEST_ASSERT_FALSE(ciaaDriverEthRing_ready(&ring));
+
+      TEST_ASSERT_EQUAL_INT(idx % RING_SIZE, ciaaDriverEthRing_put(&ring,
+               poolBufs[(idx + RING_SIZE) % POOL_SIZE], 0x1000, 0x100, 0,
+               true));
+   }
+
+   ciaaDriverEthRingHw_pollDemand_Expect(&hw);
+   ciaaDriverEthRing_start(&ring);
+}
+
+/** \brief test the transmission of a frame of several descriptors */
+void test_ciaaDriverEthRing_txFrame(void) {
+   int32_t first;
+   void * buf;
+   uint32_t status;
+
+   /* a previous frame leaves the next frame across the end of the ring */
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverEthRing_put(&ring, &pool, 0x1000, 10,
+            0x3, true));
+   TEST_ASSERT_EQUAL_INT(1, ciaaDriverEthRing_put(&ring, &pool, 0x1000, 10,
+            0x3, true));
+   dmaRelease(0, 0);
+   dmaRelease(1, 0);
+   TEST_ASSERT_TRUE(ciaaDriverEthRing_take(&ring, &buf, &status));
+   TEST_ASSERT_TRUE(ciaaDriverEthRing_take(&ring, &buf, &status));
+
+   /* the first descriptor is given to the DMA once the frame is ready,
+    * the frame is kept by the last one */
+   first = ciaaDriverEthRing_put(&ring, NULL, 0x2000, 60, 0x1, false);
+   TEST_ASSERT_EQUAL_INT(2, first);
+   TEST_ASSERT_EQUAL_INT(3, ciaaDriverEthRing_put(&ring, NULL, 0x2100, 60,
+            0x0, true));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverEthRing_put(&ring, poolBufs[0],
+            0x2200, 60, 0x2, true));
+   TEST_ASSERT_EQUAL_HEX32(0x1, desc[2].status);
+   TEST_ASSERT_EQUAL_HEX32(CIAADRVETHRING_OWN | END_STATUS, desc[3].status);
+   TEST_ASSERT_EQUAL_UINT32(1, ciaaDriverEthRing_free(&ring));
+
+   /* the whole frame is given to the DMA */
+   ciaaDriverEthRing_own(&ring, first);
+   TEST_ASSERT_EQUAL_HEX32(CIAADRVETHRING_OWN | 0x1, desc[2].status);
+
+   ciaaDriverEthRingHw_pollDemand_Expect(&hw);
+   ciaaDriverEthRing_start(&ring);
+
+   /* the DMA sends the first fragments, the frame is not returned yet */
+   dmaRelease(2, 0x1);
+   dmaRelease(3, END_STATUS);
+   TEST_ASSERT_TRUE(ciaaDriverEthRing_take(&ring, &buf, &status));
+   TEST_ASSERT_NULL(buf);
+   TEST_ASSERT_TRUE(ciaaDriverEthRing_take(&ring, &buf, &status));
+   TEST_ASSERT_NULL(buf);
+   TEST_ASSERT_FALSE(ciaaDriverEthRing_take(&ring, &buf, &status));
+
+   /* the buffer of the frame is returned on completion */
+   dmaRelease(0, 0x2);
+   TEST_ASSERT_TRUE(ciaaDriverEthRing_take(&ring, &buf, &status));
+   TEST_ASSERT_EQUAL_PTR(poolBufs[0], buf);
+   TEST_ASSERT_EQUAL_UINT32(RING_SIZE, ciaaDriverEthRing_free(&ring));
+   TEST_ASSERT_FALSE(ciaaDriverEthRing_take(&ring, &buf, &status));
+}
+
+/** \brief test the exhaustion of the buffer pool */
+void test_ciaaDriverEthRing_poolExhausted(void) {
+   void * bufs[POOL_SIZE];
+   uint32_t idx;
+
+   for (idx = 0; idx < POOL_SIZE; idx++)
+   {
+      bufs[idx] = ciaaDriverEthRing_poolGet(&pool);
+      TEST_ASSERT_EQUAL_PTR(poolBufs[idx], bufs[idx]);
+   }
+   TEST_ASSERT_NULL(ciaaDriverEthRing_poolGet(&pool));
+
+   /* a returned buffer is got again */
+   ciaaDriverEthRing_poolPut(&pool, bufs[3]);
+   TEST_ASSERT_EQUAL_PTR(bufs[3], ciaaDriverEthRing_poolGet(&pool));
+   TEST_ASSERT_NULL(ciaaDriverEthRing_poolGet(&pool));
+
+   /* all the buffers come back, a pool never holds more */
+   for (idx = 0; idx < POOL_SIZE; idx++)
+   {
+      ciaaDriverEthRing_poolPut(&pool, bufs[idx]);
+   }
+   ciaaDriverEthRing_poolPut(&pool, bufs[0]);
+   for (idx = 0; idx < POOL_SIZE; idx++)
+   {
+      TEST_ASSERT_NOT_NULL(ciaaDriverEthRing_poolGet(&pool));
+   }
+   TEST_ASSERT_NULL(ciaaDriverEthRing_poolGet(&pool));
+}
+
+/** \brief test the receive path of a driver, a pool refills the ring */
+void test_ciaaDriverEthRing_rxPool(void) {
+   void * held[POOL_SIZE];
+   void * buf;
+   uint32_t status;
+   uint32_t count = 0;
+   uint32_t idx;
+
+   /* the ring is filled from the pool */
+   while ((0 < ciaaDriverEthRing_free(&ring)) &&
+          (NULL != (buf = ciaaDriverEthRing_poolGet(&pool))))
+   {
+      TEST_ASSERT_TRUE(0 <= ciaaDriverEthRing_put(&ring, buf, 0, BUF_SIZE,
+               0, true));
+   }
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDriverEthRing_free(&ring));
+
+   /* the stack holds all the received frames, the pool runs out and the
+    * ring is left with free descriptors */
+   for (idx = 0; idx < RING_SIZE + 2; idx++)
+   {
+      dmaRelease(idx % RING_SIZE, 0);
+      TEST_ASSERT_TRUE(ciaaDriverEthRing_take(&ring, &held[count], &status));
+      count++;
+      buf = ciaaDriverEthRing_poolGet(&pool);
+      if (NULL != buf)
+      {
+         TEST_ASSERT_TRUE(0 <= ciaaDriverEthRing_put(&ring, buf, 0,
+                  BUF_SIZE, 0, true));
+      }
+   }
+   TEST_ASSERT_EQUAL_UINT32(RING_SIZE, ciaaDriverEthRing_free(&ring));
+   TEST_ASSERT_FALSE(ciaaDriverEthRing_ready(&ring));
+
+   /* the frames freed by the stack are queued again */
+   for (idx = 0; idx < count; idx++)
+   {
+      ciaaDriverEthRing_poolPut(&pool, held[idx]);
+   }
+   for (idx = 0; idx < RING_SIZE; idx++)
+   {
+      buf = ciaaDriverEthRing_poolGet(&pool);
+      TEST_ASSERT_NOT_NULL(buf);
+      TEST_ASSERT_EQUAL_INT((idx + 2) % RING_SIZE, ciaaDriverEthRing_put(
+               &ring, buf, 0, BUF_SIZE, 0, true));
+   }
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,291 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the host simulation
+ **
+ ** The last test reports how much faster than real time the virtual time
+ ** advances.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDriverSim.h"
+#include "mock_ciaaPOSIX_string.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+#include "unistd.h"
+#include "pthread.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief simulated time of the speed test */
+#define BENCH_TIME            (60 * CIAADRVSIM_SECOND)
+
+/** \brief period of the tick of the speed test */
+#define BENCH_TICK            CIAADRVSIM_MILLISECOND
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief events of the test */
+static ciaaDriverSim_eventType events[3];
+
+/** \brief order of the fired events */
+static uintptr_t fired[8];
+
+/** \brief count of fired events */
+static uint32_t firedCount;
+
+/** \brief time of the fired events */
+static ciaaDriverSim_timeType firedTime[8];
+
+/** \brief count of ticks */
+static uint32_t ticks;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void * stringMemset(void * s, int c, size_t n, int calls)
+{
+   (void)calls;
+
+   return memset(s, c, n);
+}
+
+static void record(void * param)
+{
+   if (8 > firedCount)
+   {
+      fired[firedCount] = (uintptr_t)param;
+      firedTime[firedCount] = ciaaDriverSim_getTime();
+   }
+   firedCount++;
+}
+
+static void tick(void)
+{
+   ticks++;
+}
+
+static void * stepThread(void * arg)
+{
+   (void)arg;
+
+   (void)ciaaDriverSim_step();
+
+   return NULL;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   uint32_t loopi;
+
+   ciaaPOSIX_memset_StubWithCallback(stringMemset);
+
+   ciaaDriverSim_init();
+
+   memset(events, 0, sizeof(events));
+   for (loopi = 0; loopi < 3; loopi++)
+   {
+      events[loopi].fct = record;
+      events[loopi].param = (void *)(uintptr_t)loopi;
+   }
+   firedCount = 0;
+   ticks = 0;
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test the order of the events */
+void test_ciaaDriverSim_order(void) {
+   ciaaDriverSim_schedule(&events[0], 30, 0);
+   ciaaDriverSim_schedule(&events[1], 10, 0);
+   ciaaDriverSim_schedule(&events[2], 10, 0);
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverSim_getTime());
+
+   /* events of the same time in the order they were scheduled */
+   TEST_ASSERT_TRUE(ciaaDriverSim_step());
+   TEST_ASSERT_TRUE(ciaaDriverSim_step());
+   TEST_ASSERT_TRUE(ciaaDriverSim_step());
+   TEST_ASSERT_FALSE(ciaaDriverSim_step());
+
+   TEST_ASSERT_EQUAL_INT(3, firedCount);
+   TEST_ASSERT_EQUAL_INT(1, fired[0]);
+   TEST_ASSERT_EQUAL_INT(2, fired[1]);
+   TEST_ASSERT_EQUAL_INT(0, fired[2]);
+   TEST_ASSERT_EQUAL_INT(10, firedTime[0]);
+   TEST_ASSERT_EQUAL_INT(10, firedTime[1]);
+   TEST_ASSERT_EQUAL_INT(30, firedTime[2]);
+   TEST_ASSERT_EQUAL_INT(30, ciaaDriverSim_getTime());
+}
+
+/** \brief test rescheduling and canceling events */
+void test_ciaaDriverSim_cancel(void) {
+   ciaaDriverSim_schedule(&events[0], 10, 0);
+   ciaaDriverSim_schedule(&events[1], 20, 0);
+   ciaaDriverSim_schedule(&events[0], 30, 0);
+   ciaaDriverSim_cancel(&events[1]);
+   ciaaDriverSim_cancel(&events[2]);
+
+   TEST_ASSERT_TRUE(ciaaDriverSim_step());
+   TEST_ASSERT_FALSE(ciaaDriverSim_step());
+   TEST_ASSERT_EQUAL_INT(1, firedCount);
+   TEST_ASSERT_EQUAL_INT(0, fired[0]);
+   TEST_ASSERT_EQUAL_INT(30, firedTime[0]);
+   TEST_ASSERT_FALSE(events[0].scheduled);
+}
+
+/** \brief test the tick and the waits of the cpu */
+void test_ciaaDriverSim_tick(void) {
+   ciaaDriverSim_setTick(CIAADRVSIM_MILLISECOND, tick);
+
+   /* the due ticks are fired while waiting */
+   ciaaDriverSim_wait(10 * CIAADRVSIM_MILLISECOND + 1);
+   TEST_ASSERT_EQUAL_INT(10, ticks);
+   TEST_ASSERT_EQUAL_INT(10 * CIAADRVSIM_MILLISECOND + 1, ciaaDriverSim_getTime());
+
+   /* 204000 cycles are 1 ms */
+   ciaaDriverSim_consume(CIAADRVSIM_CPU_FREQUENCY / 1000);
+   TEST_ASSERT_EQUAL_INT(11, ticks);
+
+   TEST_ASSERT_TRUE(ciaaDriverSim_step());
+   TEST_ASSERT_EQUAL_INT(12, ticks);
+   TEST_ASSERT_EQUAL_INT(12 * CIAADRVSIM_MILLISECOND, ciaaDriverSim_getTime());
+}
+
+/** \brief test that the time waits for the peripherals */
+void test_ciaaDriverSim_hold(void) {
+   pthread_t thread;
+
+   ciaaDriverSim_schedule(&events[0], 10, 0);
+   ciaaDriverSim_hold();
+
+   TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, stepThread, NULL));
+   usleep(20000);
+   TEST_ASSERT_EQUAL_INT(0, firedCount);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverSim_getTime());
+
+   ciaaDriverSim_release();
+   pthread_join(thread, NULL);
+   TEST_ASSERT_EQUAL_INT(1, firedCount);
+   TEST_ASSERT_EQUAL_INT(10, ciaaDriverSim_getTime());
+}
+
+/** \brief test the cycles of the tasks */
+void test_ciaaDriverSim_trace(void) {
+   ciaaDriverSim_traceType const * trace;
+
+   ciaaDriverSim_taskStart(1);
+   ciaaDriverSim_consume(1000);
+   ciaaDriverSim_taskEnd(1);
+
+   ciaaDriverSim_taskStart(1);
+   ciaaDriverSim_wait(CIAADRVSIM_MILLISECOND);
+   ciaaDriverSim_taskEnd(1);
+
+   ciaaDriverSim_taskStart(2);
+   ciaaDriverSim_taskEnd(2);
+
+   /* not running in a task */
+   ciaaDriverSim_consume(500);
+
+   trace = ciaaDriverSim_getTrace(1);
+   TEST_ASSERT_EQUAL_INT(2, trace->dispatches);
+   TEST_ASSERT_EQUAL_INT(1000 + CIAADRVSIM_CPU_FREQUENCY / 1000, trace->cycles);
+   TEST_ASSERT_EQUAL_INT(CIAADRVSIM_CPU_FREQUENCY / 1000, trace->maxCycles);
+
+   trace = ciaaDriverSim_getTrace(2);
+   TEST_ASSERT_EQUAL_INT(1, trace->dispatches);
+   TEST_ASSERT_EQUAL_INT(0, trace->cycles);
+
+   TEST_ASSERT_NULL(ciaaDriverSim_getTrace(CIAADRVSIM_TRACE_TASKS));
+}
+
+/** \brief report the speed of the virtual time */
+void test_ciaaDriverSim_speed(void) {
+   uint64_t start;
+   uint64_t elapsed;
+
+   ciaaDriverSim_setTick(BENCH_TICK, tick);
+
+   start = getNs();
+   while (BENCH_TIME > ciaaDriverSim_getTime())
+   {
+      ciaaDriverSim_taskStart(0);
+      ciaaDriverSim_consume(1000);
+      ciaaDriverSim_taskEnd(0);
+      (void)ciaaDriverSim_step();
+   }
+   elapsed = getNs() - start;
+
+   TEST_ASSERT_EQUAL_INT(BENCH_TIME / BENCH_TICK, ticks);
+   printf("sim: %u ticks in %.1f ms, %.0f times faster than real time\n",
+         ticks, (double)elapsed / 1e6, (double)BENCH_TIME / (double)elapsed);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
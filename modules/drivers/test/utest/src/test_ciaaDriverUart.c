@@ -0,0 +1,551 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the x86 uart driver
+ **
+ ** The emulated ports are served on loopback TCP ports, the test connects
+ ** clients to them and replaces the serial devices layer by callbacks. The
+ ** last test reports the throughput and the echo latency of the emulation.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDriverUart.h"
+#include "ciaaDriverUart_Internal.h"
+#include "ciaaPOSIX_stdio.h"
+#include "mock_ciaaSerialDevices.h"
+#include "mock_ciaaPOSIX_string.h"
+#include "mock_os.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+#include "unistd.h"
+#include "pthread.h"
+#include "arpa/inet.h"
+#include "netinet/tcp.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief size of the data received by the test */
+#define TEST_RX_SIZE          65536
+
+/** \brief size of the transfers of the backpressure tests and benchmark */
+#define TEST_BULK_SIZE        (32 * 1024 * 1024)
+
+/** \brief timeout waiting for the I/O thread in ms */
+#define TEST_TIMEOUT          2000
+
+/** \brief count of round trips of the latency benchmark */
+#define BENCH_ROUNDTRIPS      10000
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief devices registered by the driver */
+static ciaaDevices_deviceType * devices[2];
+
+/** \brief protects the data shared with the I/O thread */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** \brief signaled on each reception */
+static pthread_cond_t received = PTHREAD_COND_INITIALIZER;
+
+/** \brief data received from the driver */
+static uint8_t rxData[TEST_RX_SIZE];
+
+/** \brief count of bytes received from the driver */
+static size_t rxCount;
+
+/** \brief the received data is counted but not stored */
+static bool rxDiscard;
+
+/** \brief the received data is not read from the driver */
+static bool rxHold;
+
+/** \brief the received data is transmitted back */
+static bool rxEcho;
+
+/** \brief data transmitted to the driver */
+static uint8_t const * txData;
+
+/** \brief length of the data to be transmitted */
+static size_t txLength;
+
+/** \brief count of bytes already written to the driver */
+static size_t txCount;
+
+/** \brief count of tx confirmations */
+static uint32_t txConfirmations;
+
+/** \brief bulk data of the backpressure tests and the benchmark */
+static uint8_t bulk[TEST_BULK_SIZE];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void * stringMemcpy(void * s1, void const * s2, size_t n, int calls)
+{
+   (void)calls;
+
+   return memcpy(s1, s2, n);
+}
+
+/** \brief keep the registered devices, the driver device is its own upper
+ ** layer so the callbacks get it back */
+static void serialAddDriver(ciaaDevices_deviceType * driver, int calls)
+{
+   devices[calls] = driver;
+   driver->upLayer = driver;
+}
+
+/** \brief serial devices rx indication, reads all the data */
+static void serialRxIndication(ciaaDevices_deviceType const * const device,
+      uint32_t const nbyte, int calls)
+{
+   static uint8_t discard[2048];
+   ssize_t count = 0;
+   bool echo;
+
+   (void)nbyte;
+   (void)calls;
+
+   pthread_mutex_lock(&lock);
+   if (!rxHold)
+   {
+      if (rxDiscard)
+      {
+         count = ciaaDriverUart_read(device, discard, sizeof(discard));
+      }
+      else
+      {
+         count = ciaaDriverUart_read(device, &rxData[rxCount], TEST_RX_SIZE - rxCount);
+      }
+      rxCount += count;
+   }
+   echo = rxEcho && (0 < count);
+   if (echo)
+   {
+      txData = rxData;
+      txLength = rxCount;
+   }
+   pthread_cond_broadcast(&received);
+   pthread_mutex_unlock(&lock);
+
+   if (echo)
+   {
+      ciaaDriverUart_ioctl(device, ciaaPOSIX_IOCTL_STARTTX, NULL);
+   }
+}
+
+/** \brief serial devices tx confirmation, writes the next data */
+static void serialTxConfirmation(ciaaDevices_deviceType const * const device,
+      uint32_t const nbyte, int calls)
+{
+   (void)nbyte;
+   (void)calls;
+
+   pthread_mutex_lock(&lock);
+   txConfirmations++;
+   if (txCount < txLength)
+   {
+      txCount += ciaaDriverUart_write(device, &txData[txCount], txLength - txCount);
+   }
+   pthread_mutex_unlock(&lock);
+}
+
+/** \brief start the transmission of data as ciaaSerialDevices_write */
+static void transmit(ciaaDevices_deviceType * device, uint8_t const * data, size_t length)
+{
+   pthread_mutex_lock(&lock);
+   txData = data;
+   txLength = length;
+   txCount = 0;
+   pthread_mutex_unlock(&lock);
+
+   ciaaDriverUart_ioctl(device, ciaaPOSIX_IOCTL_STARTTX, NULL);
+}
+
+/** \brief wait until count bytes are received from the driver */
+static size_t waitRx(size_t count)
+{
+   struct timespec until;
+   size_t ret;
+
+   clock_gettime(CLOCK_REALTIME, &until);
+   until.tv_sec += TEST_TIMEOUT / 1000;
+
+   pthread_mutex_lock(&lock);
+   while ((rxCount < count) &&
+          (0 == pthread_cond_timedwait(&received, &lock, &until)))
+   {
+   }
+   ret = rxCount;
+   pthread_mutex_unlock(&lock);
+
+   return ret;
+}
+
+/** \brief count the clients accepted by an uart */
+static uint32_t clients(ciaaDriverUart_uartType * uart)
+{
+   uint32_t ret = 0;
+   uint32_t loopi;
+
+   for (loopi = 0; loopi < CIAADRVUART_TCP_MAX_CLIENTS; loopi++)
+   {
+      if (0 <= uart->clients[loopi].fileDescriptor)
+      {
+         ret++;
+      }
+   }
+
+   return ret;
+}
+
+/** \brief wait until an uart has accepted count clients */
+static uint32_t waitClients(ciaaDriverUart_uartType * uart, uint32_t count)
+{
+   uint32_t loopi;
+
+   for (loopi = 0; (loopi < TEST_TIMEOUT) && (count != clients(uart)); loopi++)
+   {
+      usleep(1000);
+   }
+
+   return clients(uart);
+}
+
+/** \brief connect a client to an emulated port */
+static int clientConnect(int port)
+{
+   struct sockaddr_in address;
+   struct timeval timeout = { TEST_TIMEOUT / 1000, 0 };
+   int noDelay = 1;
+   int fd;
+
+   fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+   TEST_ASSERT_TRUE(0 <= fd);
+
+   memset(&address, 0, sizeof(address));
+   address.sin_family = AF_INET;
+   address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   address.sin_port = htons(port);
+   TEST_ASSERT_EQUAL_INT(0, connect(fd, (struct sockaddr *)&address, sizeof(address)));
+
+   setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+   setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+   return fd;
+}
+
+/** \brief receive length bytes on a client, returns the received count */
+static size_t clientRecv(int fd, uint8_t * buffer, size_t length)
+{
+   size_t count = 0;
+   ssize_t result = 1;
+
+   while ((count < length) && (0 < result))
+   {
+      result = recv(fd, &buffer[count], length - count, 0);
+      if (0 < result)
+      {
+         count += result;
+      }
+   }
+
+   return count;
+}
+
+/** \brief send length bytes from a client */
+static void clientSend(int fd, uint8_t const * buffer, size_t length)
+{
+   size_t count = 0;
+   ssize_t result;
+
+   while (count < length)
+   {
+      result = send(fd, &buffer[count], length - count, 0);
+      TEST_ASSERT_TRUE(0 < result);
+      count += result;
+   }
+}
+
+/** \brief close the ports at the end of a test
+ **
+ ** The mocks are destroyed before tearDown, so the I/O thread shall finish
+ ** the callbacks started before closing while they are still registered.
+ **/
+static void closePorts(void)
+{
+   ciaaDriverUart_close(devices[0]);
+   ciaaDriverUart_close(devices[1]);
+
+   usleep(10000);
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   size_t loopi;
+
+   rxCount = 0;
+   rxDiscard = false;
+   rxHold = false;
+   rxEcho = false;
+   txData = NULL;
+   txLength = 0;
+   txCount = 0;
+   txConfirmations = 0;
+
+   for (loopi = 0; loopi < TEST_BULK_SIZE; loopi++)
+   {
+      bulk[loopi] = (uint8_t)(loopi % 251);
+   }
+
+   ciaaPOSIX_memcpy_StubWithCallback(stringMemcpy);
+   ciaaSerialDevices_addDriver_StubWithCallback(serialAddDriver);
+   ciaaSerialDevices_rxIndication_StubWithCallback(serialRxIndication);
+   ciaaSerialDevices_txConfirmation_StubWithCallback(serialTxConfirmation);
+
+   ciaaDriverUart_init();
+   TEST_ASSERT_EQUAL_PTR(devices[0], ciaaDriverUart_open("/dev/serial/uart/0", devices[0], 0));
+   TEST_ASSERT_EQUAL_PTR(devices[1], ciaaDriverUart_open("/dev/serial/uart/1", devices[1], 0));
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+   ciaaDriverUart_close(devices[0]);
+   ciaaDriverUart_close(devices[1]);
+}
+
+/** \brief test the reception from a client */
+void test_ciaaDriverUart_receive(void) {
+   int fd = clientConnect(CIAADRVUART_TCP_PORT_0);
+
+   clientSend(fd, (uint8_t const *)"hello world", 11);
+
+   TEST_ASSERT_EQUAL_INT(11, waitRx(11));
+   TEST_ASSERT_EQUAL_MEMORY("hello world", rxData, 11);
+
+   closePorts();
+   close(fd);
+}
+
+/** \brief test that all clients of a broadcast port receive the data */
+void test_ciaaDriverUart_broadcast(void) {
+   uint8_t buffer[2][5000];
+   int fd[2];
+
+   fd[0] = clientConnect(CIAADRVUART_TCP_PORT_0);
+   fd[1] = clientConnect(CIAADRVUART_TCP_PORT_0);
+   TEST_ASSERT_EQUAL_INT(2, waitClients(&ciaaDriverUart_uart0, 2));
+
+   /* more than a txBuffer, confirmed in several steps */
+   transmit(devices[0], bulk, sizeof(buffer[0]));
+
+   TEST_ASSERT_EQUAL_INT(sizeof(buffer[0]), clientRecv(fd[0], buffer[0], sizeof(buffer[0])));
+   TEST_ASSERT_EQUAL_INT(sizeof(buffer[1]), clientRecv(fd[1], buffer[1], sizeof(buffer[1])));
+   TEST_ASSERT_EQUAL_MEMORY(bulk, buffer[0], sizeof(buffer[0]));
+   TEST_ASSERT_EQUAL_MEMORY(bulk, buffer[1], sizeof(buffer[1]));
+
+   /* both clients may send data */
+   clientSend(fd[0], (uint8_t const *)"a", 1);
+   TEST_ASSERT_EQUAL_INT(1, waitRx(1));
+   clientSend(fd[1], (uint8_t const *)"b", 1);
+   TEST_ASSERT_EQUAL_INT(2, waitRx(2));
+   TEST_ASSERT_EQUAL_MEMORY("ab", rxData, 2);
+
+   closePorts();
+   close(fd[0]);
+   close(fd[1]);
+}
+
+/** \brief test that an exclusive port refuses a second client */
+void test_ciaaDriverUart_exclusive(void) {
+   uint8_t buffer[4];
+   int fd[2];
+
+   fd[0] = clientConnect(CIAADRVUART_TCP_PORT_1);
+   TEST_ASSERT_EQUAL_INT(1, waitClients(&ciaaDriverUart_uart1, 1));
+
+   /* the connection is closed by the driver */
+   fd[1] = clientConnect(CIAADRVUART_TCP_PORT_1);
+   TEST_ASSERT_EQUAL_INT(0, recv(fd[1], buffer, sizeof(buffer), 0));
+   TEST_ASSERT_EQUAL_INT(1, clients(&ciaaDriverUart_uart1));
+
+   /* the first client is still served */
+   transmit(devices[1], (uint8_t const *)"uart", 4);
+   TEST_ASSERT_EQUAL_INT(4, clientRecv(fd[0], buffer, 4));
+   TEST_ASSERT_EQUAL_MEMORY("uart", buffer, 4);
+
+   closePorts();
+   close(fd[0]);
+   close(fd[1]);
+}
+
+/** \brief test that the transmission waits for a slow client */
+void test_ciaaDriverUart_txBackpressure(void) {
+   static uint8_t buffer[TEST_BULK_SIZE];
+   size_t count;
+   int fd;
+
+   fd = clientConnect(CIAADRVUART_TCP_PORT_0);
+   TEST_ASSERT_EQUAL_INT(1, waitClients(&ciaaDriverUart_uart0, 1));
+
+   transmit(devices[0], bulk, TEST_BULK_SIZE);
+
+   /* the socket buffers are full, the driver does not confirm more data */
+   usleep(200000);
+   pthread_mutex_lock(&lock);
+   count = txCount;
+   pthread_mutex_unlock(&lock);
+   TEST_ASSERT_TRUE(TEST_BULK_SIZE > count);
+
+   /* nothing is lost when the client reads */
+   TEST_ASSERT_EQUAL_INT(TEST_BULK_SIZE, clientRecv(fd, buffer, TEST_BULK_SIZE));
+   TEST_ASSERT_EQUAL_MEMORY(bulk, buffer, TEST_BULK_SIZE);
+   TEST_ASSERT_EQUAL_INT(TEST_BULK_SIZE, txCount);
+
+   closePorts();
+   close(fd);
+}
+
+/** \brief test that the reception stops while the upper layer does not read */
+void test_ciaaDriverUart_rxBackpressure(void) {
+   int fd;
+
+   rxHold = true;
+   fd = clientConnect(CIAADRVUART_TCP_PORT_0);
+   clientSend(fd, bulk, TEST_RX_SIZE);
+
+   /* rxBuffer gets full and the data is kept by the host */
+   usleep(200000);
+   pthread_mutex_lock(&lock);
+   TEST_ASSERT_TRUE(ciaaDriverUart_uart0.rxStopped);
+   TEST_ASSERT_EQUAL_INT(sizeof(ciaaDriverUart_uart0.rxBuffer.buffer),
+         ciaaDriverUart_uart0.rxBuffer.length);
+   rxHold = false;
+   pthread_mutex_unlock(&lock);
+
+   /* the upper layer waits for data as ciaaSerialDevices_read */
+   ciaaDriverUart_ioctl(devices[0], ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT, (void*)true);
+
+   TEST_ASSERT_EQUAL_INT(TEST_RX_SIZE, waitRx(TEST_RX_SIZE));
+   TEST_ASSERT_EQUAL_MEMORY(bulk, rxData, TEST_RX_SIZE);
+   TEST_ASSERT_FALSE(ciaaDriverUart_uart0.rxStopped);
+
+   closePorts();
+   close(fd);
+}
+
+/** \brief benchmark of the emulated port */
+void test_ciaaDriverUart_benchmark(void) {
+   static uint8_t buffer[TEST_BULK_SIZE];
+   uint64_t start;
+   uint64_t elapsed;
+   uint32_t loopi;
+   int fd;
+
+   fd = clientConnect(CIAADRVUART_TCP_PORT_0);
+   TEST_ASSERT_EQUAL_INT(1, waitClients(&ciaaDriverUart_uart0, 1));
+
+   /* transmission */
+   start = getNs();
+   transmit(devices[0], bulk, TEST_BULK_SIZE);
+   TEST_ASSERT_EQUAL_INT(TEST_BULK_SIZE, clientRecv(fd, buffer, TEST_BULK_SIZE));
+   elapsed = getNs() - start;
+   printf("uart tx throughput: %.1f MB/s in %u confirmations\n",
+         (double)TEST_BULK_SIZE * 1e3 / (double)elapsed, txConfirmations);
+
+   /* reception */
+   rxDiscard = true;
+   start = getNs();
+   clientSend(fd, bulk, TEST_BULK_SIZE);
+   TEST_ASSERT_EQUAL_INT(TEST_BULK_SIZE, waitRx(TEST_BULK_SIZE));
+   elapsed = getNs() - start;
+   printf("uart rx throughput: %.1f MB/s\n",
+         (double)TEST_BULK_SIZE * 1e3 / (double)elapsed);
+
+   /* latency of one byte echoed by the upper layer */
+   pthread_mutex_lock(&lock);
+   rxDiscard = false;
+   rxEcho = true;
+   rxCount = 0;
+   txCount = 0;
+   pthread_mutex_unlock(&lock);
+   start = getNs();
+   for (loopi = 0; loopi < BENCH_ROUNDTRIPS; loopi++)
+   {
+      clientSend(fd, &bulk[loopi], 1);
+      TEST_ASSERT_EQUAL_INT(1, clientRecv(fd, buffer, 1));
+      TEST_ASSERT_EQUAL_INT(bulk[loopi], buffer[0]);
+   }
+   elapsed = getNs() - start;
+   printf("uart echo: %.1f us per round trip\n",
+         (double)elapsed / 1000.0 / (double)BENCH_ROUNDTRIPS);
+
+   closePorts();
+   close(fd);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
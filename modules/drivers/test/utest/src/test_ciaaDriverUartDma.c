@@ -0,0 +1,230 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the test of the uart DMA transfers
+ **
+ ** The DMA channels are mocked, the test checks the regions passed to them
+ ** and the bytes forwarded to the serial device buffers.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDriverUartDma.h"
+#include "mock_ciaaDriverUartDmaHw.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief DMA state under test */
+static ciaaDriverUartDma_type dma;
+
+/** \brief uart passed to the hardware functions */
+static int hw;
+
+/** \brief serial device buffer */
+static uint8_t buffer[5000];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   ciaaDriverUartDma_init(&dma, &hw);
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test that nothing is received while the reception is disabled */
+void test_ciaaDriverUartDma_readDisabled(void) {
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_read(&dma, buffer, 100));
+   TEST_ASSERT_FALSE(ciaaDriverUartDma_rxActive(&dma));
+}
+
+/** \brief test the reception in the free region of the buffer */
+void test_ciaaDriverUartDma_readRegion(void) {
+   ciaaDriverUartDma_rxStart(&dma);
+
+   /* the first call starts the DMA in the free region */
+   ciaaDriverUartDmaHw_rxStart_Expect(&hw, buffer, 100);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_read(&dma, buffer, 100));
+   TEST_ASSERT_TRUE(ciaaDriverUartDma_rxActive(&dma));
+
+   /* the received bytes are forwarded, the DMA keeps running */
+   ciaaDriverUartDmaHw_rxCount_ExpectAndReturn(&hw, 10);
+   TEST_ASSERT_EQUAL_INT(10, ciaaDriverUartDma_read(&dma, buffer, 100));
+
+   /* the next call starts after the forwarded bytes */
+   ciaaDriverUartDmaHw_rxCount_ExpectAndReturn(&hw, 25);
+   TEST_ASSERT_EQUAL_INT(15, ciaaDriverUartDma_read(&dma, &buffer[10], 120));
+   ciaaDriverUartDmaHw_rxCount_ExpectAndReturn(&hw, 25);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_read(&dma, &buffer[25], 120));
+   TEST_ASSERT_TRUE(ciaaDriverUartDma_rxActive(&dma));
+}
+
+/** \brief test the restart of the reception once the region is full */
+void test_ciaaDriverUartDma_readFull(void) {
+   ciaaDriverUartDma_rxStart(&dma);
+
+   /* region at the end of the buffer */
+   ciaaDriverUartDmaHw_rxStart_Expect(&hw, &buffer[90], 10);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_read(&dma, &buffer[90], 10));
+
+   /* full region, the serial device continues at the start of the buffer */
+   ciaaDriverUartDmaHw_rxCount_ExpectAndReturn(&hw, 10);
+   TEST_ASSERT_EQUAL_INT(10, ciaaDriverUartDma_read(&dma, &buffer[90], 10));
+   TEST_ASSERT_FALSE(ciaaDriverUartDma_rxActive(&dma));
+
+   ciaaDriverUartDmaHw_rxStart_Expect(&hw, buffer, 50);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_read(&dma, buffer, 50));
+
+   /* a full region with more free space continues after it */
+   ciaaDriverUartDmaHw_rxCount_ExpectAndReturn(&hw, 50);
+   ciaaDriverUartDmaHw_rxStart_Expect(&hw, &buffer[50], 30);
+   TEST_ASSERT_EQUAL_INT(50, ciaaDriverUartDma_read(&dma, buffer, 80));
+   TEST_ASSERT_TRUE(ciaaDriverUartDma_rxActive(&dma));
+}
+
+/** \brief test the regions limited to the maximal transfer size */
+void test_ciaaDriverUartDma_readMaxTransfer(void) {
+   ciaaDriverUartDma_rxStart(&dma);
+
+   ciaaDriverUartDmaHw_rxStart_Expect(&hw, buffer, CIAADRVUARTDMA_MAX_TRANSFER);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_read(&dma, buffer, sizeof(buffer)));
+
+   ciaaDriverUartDmaHw_rxCount_ExpectAndReturn(&hw, CIAADRVUARTDMA_MAX_TRANSFER);
+   ciaaDriverUartDmaHw_rxStart_Expect(&hw, &buffer[CIAADRVUARTDMA_MAX_TRANSFER],
+         sizeof(buffer) - CIAADRVUARTDMA_MAX_TRANSFER);
+   TEST_ASSERT_EQUAL_INT(CIAADRVUARTDMA_MAX_TRANSFER,
+         ciaaDriverUartDma_read(&dma, buffer, sizeof(buffer)));
+}
+
+/** \brief test the bytes received before the stop of the reception */
+void test_ciaaDriverUartDma_readStop(void) {
+   ciaaDriverUartDma_rxStart(&dma);
+
+   ciaaDriverUartDmaHw_rxStart_Expect(&hw, buffer, 100);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_read(&dma, buffer, 100));
+
+   ciaaDriverUartDmaHw_rxStop_Expect(&hw);
+   ciaaDriverUartDma_rxStop(&dma);
+   TEST_ASSERT_FALSE(ciaaDriverUartDma_rxActive(&dma));
+
+   /* the received bytes are forwarded, the DMA is not restarted */
+   ciaaDriverUartDmaHw_rxCount_ExpectAndReturn(&hw, 7);
+   TEST_ASSERT_EQUAL_INT(7, ciaaDriverUartDma_read(&dma, buffer, 100));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_read(&dma, &buffer[7], 93));
+
+   /* stop without running DMA */
+   ciaaDriverUartDma_rxStop(&dma);
+}
+
+/** \brief test a region which does not follow the forwarded bytes */
+void test_ciaaDriverUartDma_readMoved(void) {
+   ciaaDriverUartDma_rxStart(&dma);
+
+   ciaaDriverUartDmaHw_rxStart_Expect(&hw, &buffer[40], 60);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_read(&dma, &buffer[40], 60));
+
+   /* e.g. the serial device buffer has been reset */
+   ciaaDriverUartDmaHw_rxStop_Expect(&hw);
+   ciaaDriverUartDmaHw_rxStart_Expect(&hw, buffer, 100);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_read(&dma, buffer, 100));
+}
+
+/** \brief test the transmission of a region */
+void test_ciaaDriverUartDma_write(void) {
+   TEST_ASSERT_FALSE(ciaaDriverUartDma_txActive(&dma));
+
+   ciaaDriverUartDmaHw_txStart_Expect(&hw, buffer, 20);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_write(&dma, buffer, 20));
+   TEST_ASSERT_TRUE(ciaaDriverUartDma_txActive(&dma));
+
+   /* the region is not confirmed while the DMA reads it */
+   ciaaDriverUartDmaHw_txBusy_ExpectAndReturn(&hw, true);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_write(&dma, buffer, 30));
+
+   /* confirmed at the end, the rest of the region is sent */
+   ciaaDriverUartDmaHw_txBusy_ExpectAndReturn(&hw, false);
+   ciaaDriverUartDmaHw_txStart_Expect(&hw, &buffer[20], 10);
+   TEST_ASSERT_EQUAL_INT(20, ciaaDriverUartDma_write(&dma, buffer, 30));
+
+   ciaaDriverUartDmaHw_txBusy_ExpectAndReturn(&hw, false);
+   TEST_ASSERT_EQUAL_INT(10, ciaaDriverUartDma_write(&dma, &buffer[20], 10));
+   TEST_ASSERT_FALSE(ciaaDriverUartDma_txActive(&dma));
+
+   /* nothing to send */
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_write(&dma, buffer, 0));
+}
+
+/** \brief test the transmission of a region larger than a DMA transfer */
+void test_ciaaDriverUartDma_writeMaxTransfer(void) {
+   ciaaDriverUartDmaHw_txStart_Expect(&hw, buffer, CIAADRVUARTDMA_MAX_TRANSFER);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDriverUartDma_write(&dma, buffer, sizeof(buffer)));
+
+   ciaaDriverUartDmaHw_txBusy_ExpectAndReturn(&hw, false);
+   ciaaDriverUartDmaHw_txStart_Expect(&hw, &buffer[CIAADRVUARTDMA_MAX_TRANSFER],
+         sizeof(buffer) - CIAADRVUARTDMA_MAX_TRANSFER);
+   TEST_ASSERT_EQUAL_INT(CIAADRVUARTDMA_MAX_TRANSFER,
+         ciaaDriverUartDma_write(&dma, buffer, sizeof(buffer)));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
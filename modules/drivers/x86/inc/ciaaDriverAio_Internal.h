@@ -45,6 +45,10 @@
 
 /*==================[inclusions]=============================================*/
 #include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+#include "ciaaDriverSim.h"
+#include <pthread.h>
+#include <stdio.h>
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -52,35 +56,102 @@ extern "C" {
 #endif
 
 /*==================[macros]=================================================*/
+/** \brief count of channels of each adc */
+#define CIAADRVAIO_CHANNELS         4
 
-/*==================[typedef]================================================*/
-/** \brief Buffer Structure */
-typedef struct {
-   uint16_t length;
-   uint8_t buffer[2048];
-} ciaaDriverAio_bufferType;
+/** Define the conversions per second after open */
+#ifndef CIAADRVAIO_SAMPLE_RATE
+   #define CIAADRVAIO_SAMPLE_RATE   10000
+#endif
+
+/** \brief maximal sample rate accepted by ciaaPOSIX_IOCTL_SET_SAMPLE_RATE */
+#ifndef CIAADRVAIO_MAX_SAMPLE_RATE
+   #define CIAADRVAIO_MAX_SAMPLE_RATE  1000000
+#endif
+
+/** \brief period in ns to convert the due samples
+ **
+ ** The samples are converted in batches as done by a dma, the upper layer is
+ ** indicated once per batch. If the sample period is longer each sample is
+ ** indicated by itself.
+ **/
+#ifndef CIAADRVAIO_BATCH_PERIOD
+   #define CIAADRVAIO_BATCH_PERIOD  CIAADRVSIM_MILLISECOND
+#endif
+
+/** \brief samples stored in the fifo of a device */
+#ifndef CIAADRVAIO_FIFO_SIZE
+   #define CIAADRVAIO_FIFO_SIZE     4096
+#endif
+
+/** \brief stimulus of the adc 0
+ **
+ ** The file contains frames of CIAADRVAIO_CHANNELS samples of 16 bits in the
+ ** byte order of the host, the frame n is the input of the channels at the
+ ** n-th conversion after setting the sample rate. The file is replayed in a
+ ** loop and mapped shared, it may be placed in /dev/shm and modified by a
+ ** host tool while the firmware is running. If the file does not exist the
+ ** inputs are 0.
+ **/
+#ifndef CIAADRVAIO_STIMULUS_0
+   #define CIAADRVAIO_STIMULUS_0    "AIN0.BIN"
+#endif
+
+/** \brief stimulus of the adc 1 */
+#ifndef CIAADRVAIO_STIMULUS_1
+   #define CIAADRVAIO_STIMULUS_1    "AIN1.BIN"
+#endif
 
+/** \brief record of the dac 0
+ **
+ ** Every sample written to the dac is appended with 16 bits in the byte
+ ** order of the host. The file is truncated when the device is opened.
+ **/
+#ifndef CIAADRVAIO_RECORD_0
+   #define CIAADRVAIO_RECORD_0      "AOUT0.BIN"
+#endif
+
+/*==================[typedef]================================================*/
 /** \brief Aio Type */
 typedef struct {
-   ciaaDriverAio_bufferType rxBuffer;
-   ciaaDriverAio_bufferType txBuffer;
-} ciaaDriverAio_uartType;
+   bool adc;                              /** <= true for an adc, false for the dac */
+   char const * filename;                 /** <= stimulus of the adc or record of the dac */
+   int32_t channel;                       /** <= selected channel */
+   uint8_t shift;                         /** <= bits dropped by the resolution */
+   bool rxInterrupt;                      /** <= indicate the conversions */
+   uint32_t sampleRate;                   /** <= samples per second */
+   ciaaDriverSim_timeType start;          /** <= time of the first sample */
+   uint64_t samples;                      /** <= samples converted since start */
+   uint64_t outputEnd;                    /** <= sample when the dac output ends */
+   uint32_t pending;                      /** <= bytes written to the dac not confirmed */
+   uint16_t fifo[CIAADRVAIO_FIFO_SIZE];   /** <= converted samples */
+   uint32_t head;                         /** <= first sample of the fifo */
+   uint32_t count;                        /** <= samples in the fifo */
+   uint32_t overruns;                     /** <= samples lost with the fifo full */
+   uint16_t const * stimulus;             /** <= mapped stimulus or NULL */
+   size_t stimulusSize;                   /** <= size of the mapping in bytes */
+   uint32_t frames;                       /** <= frames of the stimulus */
+   FILE * record;                         /** <= record of the dac or NULL */
+   pthread_mutex_t lock;                  /** <= protects the device */
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   ciaaDriverSim_eventType service;       /** <= converts the due samples */
+#else
+   pthread_t sampler;                     /** <= converts the due samples */
+   bool running;                          /** <= the sampler is running */
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+} ciaaDriverAio_aioType;
 
 /*==================[external data declaration]==============================*/
-/** \brief Aio 0 */
-extern ciaaDriverAio_uartType ciaaDriverAio_uart0;
-
-/** \brief Aio 1 */
-extern ciaaDriverAio_uartType ciaaDriverAio_uart1;
+/** \brief Adc 0 */
+extern ciaaDriverAio_aioType ciaaDriverAio_aio0;
 
-/*==================[external functions declaration]=========================*/
-extern void ciaaDriverAio_uart0_rxIndication(void);
-
-extern void ciaaDriverAio_uart0_txConfirmation(void);
+/** \brief Adc 1 */
+extern ciaaDriverAio_aioType ciaaDriverAio_aio1;
 
-extern void ciaaDriverAio_uart1_rxIndication(void);
+/** \brief Dac 0 */
+extern ciaaDriverAio_aioType ciaaDriverAio_aio2;
 
-extern void ciaaDriverAio_uart1_txConfirmation(void);
+/*==================[external functions declaration]=========================*/
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -45,6 +45,11 @@
 
 /*==================[inclusions]=============================================*/
 #include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+#include "ciaaDriverSim.h"
+#include "ciaaDriverDioEvent.h"
+#include <pthread.h>
+#include <stdio.h>
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -52,10 +57,65 @@ extern "C" {
 #endif
 
 /*==================[macros]=================================================*/
+/** \brief count of digital inputs */
+#define CIAADRVDIO_INPUTS           8
+
+/** \brief count of digital outputs */
+#define CIAADRVDIO_OUTPUTS          8
+
+/** \brief count of edge events queued by the inputs, a power of 2 */
+#define CIAADRVDIO_EVENTS           16
+
+/** \brief period of the debounce samples while inputs are settling */
+#define CIAADRVDIO_DEBOUNCE_PERIOD  CIAADRVSIM_MILLISECOND
+
+/** \brief stimulus of the inputs
+ **
+ ** Each line of the text file contains the time in microseconds since the
+ ** device was opened and the state of the inputs in hexadecimal, the bit n
+ ** is the input n, e.g. "1500 0x05". The lines shall be sorted by time,
+ ** empty lines and lines starting with # are ignored. The state holds until
+ ** the time of the next line. If the file does not exist the inputs are 0.
+ ** Each line is a pin interrupt at its exact time, so bounces shorter than
+ ** the debounce period can be stimulated.
+ **/
+#ifndef CIAADRVDIO_STIMULUS
+   #define CIAADRVDIO_STIMULUS      "DIN.TXT"
+#endif
+
+/** \brief record of the outputs
+ **
+ ** Each change of the outputs is appended with the format of the stimulus,
+ ** the time is counted since the device was opened. The file is truncated
+ ** when the device is opened.
+ **/
+#ifndef CIAADRVDIO_RECORD
+   #define CIAADRVDIO_RECORD        "DOUT.TXT"
+#endif
 
 /*==================[typedef]================================================*/
 /** \brief Dio Type */
-typedef uint32_t ciaaDriverDio_dioType;
+typedef struct {
+   bool input;                            /** <= true for the inputs */
+   char const * filename;                 /** <= stimulus or record */
+   FILE * file;                           /** <= opened stimulus or record */
+   uint32_t state;                        /** <= state of the pins */
+   ciaaDriverSim_timeType start;          /** <= time when opened */
+   bool next;                             /** <= a next state is pending */
+   ciaaDriverSim_timeType nextTime;       /** <= time of the next state */
+   uint32_t nextState;                    /** <= next state of the inputs */
+   pthread_mutex_t lock;                  /** <= protects the device */
+   ciaaDriverDioEvent_type event;         /** <= edge events of the inputs */
+   ciaaPOSIX_dioEventType events[CIAADRVDIO_EVENTS]; /** <= queued events */
+   ciaaDriverSim_timeType tick;           /** <= time of the next debounce
+                                            **    sample */
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   ciaaDriverSim_eventType service;       /** <= indicates the events */
+#else
+   pthread_t sampler;                     /** <= indicates the events */
+   bool running;                          /** <= the sampler is running */
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+} ciaaDriverDio_dioType;
 
 /*==================[external data declaration]==============================*/
 /** \brief Dio 0 */
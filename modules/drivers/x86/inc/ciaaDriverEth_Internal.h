@@ -37,6 +37,13 @@
  **
  ** This files contains the internal header file of the CIAA Ethernet driver
  **
+ ** The frames are exchanged over a virtual wire: each simulated board binds
+ ** a unix datagram socket named node<n> in the CIAADRVETH_WIRE directory and
+ ** its mac address ends with n. Unicast frames are sent to the socket of
+ ** the destination node, broadcast and multicast frames to all the sockets
+ ** of the directory. If CIAADRVETH_TAP is defined the frames are exchanged
+ ** with this tap interface of the host instead.
+ **
  **/
 
 /** \addtogroup CIAA_Firmware CIAA Firmware
@@ -47,6 +54,10 @@
  ** @{ */
 
 /*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+#include <sys/socket.h>
+#include <sys/un.h>
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -54,12 +65,125 @@ extern "C" {
 #endif
 
 /*==================[macros]=================================================*/
+/** \brief directory of the virtual wire */
+#ifndef CIAADRVETH_WIRE
+   #define CIAADRVETH_WIRE          "/tmp/ciaa_wire"
+#endif
+
+/** \brief node of this board on the virtual wire, 1 to 254
+ **
+ ** May be overwritten at run time with the CIAADRVETH_NODE environment
+ ** variable to run several boards from the same binary.
+ **/
+#ifndef CIAADRVETH_NODE
+   #define CIAADRVETH_NODE          1
+#endif
+
+/** \brief name of the host tap interface, e.g. "tap0"
+ **
+ ** If defined the virtual wire is not used, the interface has to be created
+ ** before, e.g. ip tuntap add dev tap0 mode tap user $USER
+ **/
+/* #define CIAADRVETH_TAP           "tap0" */
+
+/** \brief frames received or sent with a single system call
+ **
+ ** Linux queues up to /proc/sys/net/unix/max_dgram_qlen (10) datagrams per
+ ** unix socket, bigger batches to a single node would wait for it.
+ **/
+#ifndef CIAADRVETH_BATCH
+   #define CIAADRVETH_BATCH         8
+#endif
+
+/** \brief time in ms a frame waits for space in the queue of the receiver
+ **
+ ** The wire is lossless while the receiving board keeps reading, a board
+ ** which is stopped looses the frames after this time.
+ **/
+#ifndef CIAADRVETH_TX_TIMEOUT
+   #define CIAADRVETH_TX_TIMEOUT    10
+#endif
+
+/** \brief maximal size of a frame without fcs (vlan tagged) */
+#define CIAADRVETH_FRAME_SIZE       1518
+
+/** \brief first 5 bytes of the mac address, the 6th is the node */
+#define CIAADRVETH_MAC              0x02, 0xC1, 0xAA, 0x00, 0x00
+
+/** \brief last byte of the ip address of node 1 (10.0.0.123) */
+#define CIAADRVETH_IP_BASE          122
 
 /*==================[typedef]================================================*/
+/** \brief Ethernet frame */
+typedef struct {
+   uint16_t length;                       /** <= length of the frame */
+   uint8_t data[CIAADRVETH_FRAME_SIZE];   /** <= frame starting with the destination */
+} ciaaDriverEth_frameType;
+
+/** \brief Ethernet port of a simulated board */
+typedef struct {
+   int fd;                                /** <= socket or tap, -1 if closed */
+   bool tap;                              /** <= frames are exchanged with a tap */
+   uint8_t mac[6];                        /** <= mac address */
+   struct sockaddr_un addr;               /** <= own address on the wire */
+   ciaaDriverEth_frameType rx[CIAADRVETH_BATCH];   /** <= last received frames */
+   ciaaDriverEth_frameType tx[CIAADRVETH_BATCH];   /** <= frames to be sent */
+   struct sockaddr_un txAddr[CIAADRVETH_BATCH];    /** <= destination of the frames */
+   uint32_t txCount;                      /** <= frames to be sent */
+   uint32_t rxFrames;                     /** <= count of received frames */
+   uint32_t txFrames;                     /** <= count of sent frames */
+   uint32_t txDropped;                    /** <= frames without receiver or timed out */
+} ciaaDriverEth_ethType;
 
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
+/** \brief opens an Ethernet port
+ **
+ ** \param[out] eth port to be opened
+ ** \param[in] node node on the virtual wire, 1 to 254
+ ** \return 0 on success, -1 if the socket or the tap can not be opened
+ **/
+extern int32_t ciaaDriverEth_openPort(ciaaDriverEth_ethType * eth, uint8_t node);
+
+/** \brief closes an Ethernet port
+ **
+ ** \param[inout] eth port to be closed
+ **/
+extern void ciaaDriverEth_closePort(ciaaDriverEth_ethType * eth);
+
+/** \brief get the buffer for the next frame to be sent
+ **
+ ** Sends the pending frames if all buffers are used.
+ **
+ ** \param[inout] eth port
+ ** \return buffer of CIAADRVETH_FRAME_SIZE bytes
+ **/
+extern uint8_t * ciaaDriverEth_getTxBuffer(ciaaDriverEth_ethType * eth);
+
+/** \brief queues the frame written to the buffer of ciaaDriverEth_getTxBuffer
+ **
+ ** Broadcast and multicast frames are sent to every node at once.
+ **
+ ** \param[inout] eth port
+ ** \param[in] length length of the frame
+ **/
+extern void ciaaDriverEth_send(ciaaDriverEth_ethType * eth, uint16_t length);
+
+/** \brief sends the queued frames
+ **
+ ** \param[inout] eth port
+ **/
+extern void ciaaDriverEth_flush(ciaaDriverEth_ethType * eth);
+
+/** \brief receives the pending frames
+ **
+ ** Receives up to CIAADRVETH_BATCH frames to eth->rx without blocking.
+ **
+ ** \param[inout] eth port
+ ** \return count of received frames
+ **/
+extern uint32_t ciaaDriverEth_receive(ciaaDriverEth_ethType * eth);
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -69,5 +193,5 @@ extern "C" {
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /*==================[end of file]============================================*/
-#endif /* #ifndef _CIAADRIVERETH_INTERNAL_H_ */
+#endif /* #ifndef CIAADRIVERETH_INTERNAL_H */
 
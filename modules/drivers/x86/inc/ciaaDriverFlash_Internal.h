@@ -52,6 +52,9 @@
 #include "ciaaPOSIX_stdint.h"
 #include "ciaaPOSIX_stdbool.h"
 #include <stdio.h>
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+#include "ciaaDriverSim.h"
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -74,6 +77,18 @@ extern "C" {
    #define CIAADRVFLASH_BLOCK_CANT  32
 #endif
 
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+/** Define virtual time to erase a block */
+#ifndef CIAADRVFLASH_ERASE_TIME
+   #define CIAADRVFLASH_ERASE_TIME  (100 * CIAADRVSIM_MILLISECOND)
+#endif
+
+/** Define virtual time to program a block */
+#ifndef CIAADRVFLASH_PROGRAM_TIME
+   #define CIAADRVFLASH_PROGRAM_TIME (1 * CIAADRVSIM_MILLISECOND)
+#endif
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+
 /** Define flahs memory size in bytes */
 #define CIAADRVFLASH_SIZE           (CIAADRVFLASH_BLOCK_SIZE * CIAADRVFLASH_BLOCK_CANT)
 
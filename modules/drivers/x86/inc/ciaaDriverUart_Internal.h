@@ -48,6 +48,9 @@
 #include <netinet/in.h>
 #include "ciaaPOSIX_stdint.h"
 #include "ciaaPOSIX_stdbool.h"
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+#include "ciaaDriverSim.h"
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -63,6 +66,22 @@ extern "C" {
 //#define CIAADRVUART_TCP_PORT_0  2000
 /* Define TCP PORT for lisening socket emulation serial port 1 */
 //#define CIAADRVUART_TCP_PORT_1 2001
+/* Define client mode of the emulation serial port 0 */
+//#define CIAADRVUART_TCP_MODE_0 CIAADRVUART_TCP_MODE_EXCLUSIVE
+/* Define client mode of the emulation serial port 1 */
+//#define CIAADRVUART_TCP_MODE_1 CIAADRVUART_TCP_MODE_EXCLUSIVE
+
+/** \brief all connected clients receive the transmitted data and all of them
+ ** may send data */
+#define CIAADRVUART_TCP_MODE_BROADCAST       0
+
+/** \brief only one client may be connected, other connections are refused */
+#define CIAADRVUART_TCP_MODE_EXCLUSIVE       1
+
+/** \brief maximal count of clients connected to each emulated port */
+#ifndef CIAADRVUART_TCP_MAX_CLIENTS
+#define CIAADRVUART_TCP_MAX_CLIENTS          4
+#endif
 
 /** Enable uart transmition via host interfaces */
 #if defined(CIAADRVUART_PORT_SERIAL_0) || defined(CIAADRVUART_PORT_SERIAL_1)
@@ -90,6 +109,14 @@ extern "C" {
    #ifndef CIAADRVUART_TCP_PORT_1
       #define CIAADRVUART_TCP_PORT_1         0
    #endif
+
+   #ifndef CIAADRVUART_TCP_MODE_0
+      #define CIAADRVUART_TCP_MODE_0         CIAADRVUART_TCP_MODE_BROADCAST
+   #endif
+
+   #ifndef CIAADRVUART_TCP_MODE_1
+      #define CIAADRVUART_TCP_MODE_1         CIAADRVUART_TCP_MODE_BROADCAST
+   #endif
 #endif
 
 /** Enable funcionality of uart driver via transmition and/or emulation */
@@ -97,6 +124,16 @@ extern "C" {
    #define CIAADRVUART_ENABLE_FUNCIONALITY
 #endif
 
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+/** \brief bits on the wire for each character, 8N1 */
+#define CIAADRVUART_BITS_PER_CHAR            10
+
+/** \brief virtual time to transfer count characters */
+#define CIAADRVUART_CHARS_TIME(uart, count)                             \
+   ((ciaaDriverSim_timeType)(count) * CIAADRVUART_BITS_PER_CHAR *       \
+    CIAADRVSIM_SECOND / (uart)->baudRate)
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+
 /*==================[typedef]================================================*/
 /** \brief Buffer Structure */
 typedef struct {
@@ -104,21 +141,42 @@ typedef struct {
    uint8_t buffer[2048];         /** <= Data storage */
 } ciaaDriverUart_bufferType;
 
+#ifdef CIAADRVUART_ENABLE_FUNCIONALITY
+/** \brief Host file descriptor served by the I/O thread */
+typedef struct {
+   int fileDescriptor;           /** <= file descriptor or -1 if not used */
+   uint8_t kind;                 /** <= serial port, server or client */
+   uint8_t index;                /** <= index of the uart */
+   uint16_t sent;                /** <= bytes of txBuffer written to it */
+   uint32_t events;              /** <= events registered in the epoll set */
+} ciaaDriverUart_endpointType;
+#endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
+
 /** \brief Uart Type */
 typedef struct {
    ciaaDriverUart_bufferType rxBuffer;
    ciaaDriverUart_bufferType txBuffer;
 #ifdef CIAADRVUART_ENABLE_FUNCIONALITY
-   pthread_t handlerThread;
-   int fileDescriptor;
+   bool rxStopped;               /** <= reception stopped, rxBuffer is full */
+   bool rxResume;                /** <= reception shall be restarted */
 #endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
 #ifdef CIAADRVUART_ENABLE_TRANSMITION
+   ciaaDriverUart_endpointType serial;
    char const * deviceName;
    struct termios deviceOptions;
 #endif /* CIAADRVUART_ENABLE_TRANSMITION */
 #ifdef CIAADRVUART_ENABLE_EMULATION
+   ciaaDriverUart_endpointType server;
+   ciaaDriverUart_endpointType clients[CIAADRVUART_TCP_MAX_CLIENTS];
+   uint8_t mode;                 /** <= CIAADRVUART_TCP_MODE_BROADCAST or
+                                      CIAADRVUART_TCP_MODE_EXCLUSIVE */
    struct sockaddr_in serverAddress;
 #endif /* CIAADRVUART_ENABLE_EMULATION */
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   uint32_t baudRate;                  /** <= baudrate of the characters */
+   ciaaDriverSim_eventType txEvent;    /** <= end of the transmission */
+   ciaaDriverSim_eventType rxEvent;    /** <= end of the reception */
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
 } ciaaDriverUart_uartType;
 
 /*==================[external data declaration]==============================*/
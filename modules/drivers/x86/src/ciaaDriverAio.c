@@ -35,6 +35,11 @@
  **
  ** Simulated AIO Driver for Posix for testing proposes
  **
+ ** The adcs convert the samples of a stimulus file at the configured sample
+ ** rate and the samples written to the dac are recorded to a file, see
+ ** ciaaDriverAio_Internal.h. The time base is the wall clock or the virtual
+ ** time if CIAADRVSIM_VIRTUAL_TIME is defined.
+ **
  **/
 
 /** \addtogroup CIAA_Firmware CIAA Firmware
@@ -47,9 +52,15 @@
 /*==================[inclusions]=============================================*/
 #include "ciaaDriverAio.h"
 #include "ciaaDriverAio_Internal.h"
+#include "ciaaPOSIX_stdio.h"
 #include "ciaaPOSIX_stdlib.h"
 #include "ciaaPOSIX_string.h"
 #include "os.h"
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 /*==================[macros and definitions]=================================*/
 /** \brief Pointer to Devices */
@@ -63,9 +74,9 @@ typedef struct  {
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
-/** \brief Device for UART 0 */
+/** \brief Device for ADC 0 */
 static ciaaDevices_deviceType ciaaDriverAio_device0 = {
-   "aio/0",                        /** <= driver name */
+   "aio/in/0",                     /** <= driver name */
    ciaaDriverAio_open,             /** <= open function */
    ciaaDriverAio_close,            /** <= close function */
    ciaaDriverAio_read,             /** <= read function */
@@ -73,13 +84,13 @@ static ciaaDevices_deviceType ciaaDriverAio_device0 = {
    ciaaDriverAio_ioctl,            /** <= ioctl function */
    NULL,                            /** <= seek function is not provided */
    NULL,                            /** <= upper layer */
-   (void*)&ciaaDriverAio_uart0,    /** <= layer */
+   (void*)&ciaaDriverAio_aio0,     /** <= layer */
    NULL                             /** <= NULL no lower layer */
 };
 
-/** \brief Device for UART 1 */
+/** \brief Device for ADC 1 */
 static ciaaDevices_deviceType ciaaDriverAio_device1 = {
-   "aio/1",                        /** <= driver name */
+   "aio/in/1",                     /** <= driver name */
    ciaaDriverAio_open,             /** <= open function */
    ciaaDriverAio_close,            /** <= close function */
    ciaaDriverAio_read,             /** <= read function */
@@ -87,96 +98,494 @@ static ciaaDevices_deviceType ciaaDriverAio_device1 = {
    ciaaDriverAio_ioctl,            /** <= ioctl function */
    NULL,                            /** <= seek function is not provided */
    NULL,                            /** <= upper layer */
-   (void*)&ciaaDriverAio_uart1,    /** <= layer */
+   (void*)&ciaaDriverAio_aio1,     /** <= layer */
+   NULL                             /** <= NULL no lower layer */
+};
+
+/** \brief Device for DAC 0 */
+static ciaaDevices_deviceType ciaaDriverAio_device2 = {
+   "aio/out/0",                    /** <= driver name */
+   ciaaDriverAio_open,             /** <= open function */
+   ciaaDriverAio_close,            /** <= close function */
+   ciaaDriverAio_read,             /** <= read function */
+   ciaaDriverAio_write,            /** <= write function */
+   ciaaDriverAio_ioctl,            /** <= ioctl function */
+   NULL,                            /** <= seek function is not provided */
+   NULL,                            /** <= upper layer */
+   (void*)&ciaaDriverAio_aio2,     /** <= layer */
    NULL                             /** <= NULL no lower layer */
 };
 
 static ciaaDevices_deviceType * const ciaaAioDevices[] = {
    &ciaaDriverAio_device0,
-   &ciaaDriverAio_device1
+   &ciaaDriverAio_device1,
+   &ciaaDriverAio_device2
 };
 
 static ciaaDriverConstType const ciaaDriverAioConst = {
    ciaaAioDevices,
-   2
+   3
 };
 
 /*==================[external data definition]===============================*/
-/** \brief Aio 0 */
-ciaaDriverAio_uartType ciaaDriverAio_uart0;
+/** \brief Adc 0 */
+ciaaDriverAio_aioType ciaaDriverAio_aio0 = {
+   true, CIAADRVAIO_STIMULUS_0
+};
 
-/** \brief Aio 1 */
-ciaaDriverAio_uartType ciaaDriverAio_uart1;
+/** \brief Adc 1 */
+ciaaDriverAio_aioType ciaaDriverAio_aio1 = {
+   true, CIAADRVAIO_STIMULUS_1
+};
+
+/** \brief Dac 0 */
+ciaaDriverAio_aioType ciaaDriverAio_aio2 = {
+   false, CIAADRVAIO_RECORD_0
+};
 
 /*==================[internal functions definition]==========================*/
-static void ciaaDriverAio_rxIndication(ciaaDevices_deviceType const * const device)
+static void ciaaDriverAio_rxIndication(ciaaDevices_deviceType const * const device, uint32_t const nbyte)
 {
    /* receive the data and forward to upper layer */
-   ciaaDriverAio_uartType * uart = device->layer;
-
-   ciaaSerialDevices_rxIndication(device->upLayer, uart->rxBuffer.length);
+   ciaaSerialDevices_rxIndication(device->upLayer, nbyte);
 }
 
-static void ciaaDriverAio_txConfirmation(ciaaDevices_deviceType const * const device)
+static void ciaaDriverAio_txConfirmation(ciaaDevices_deviceType const * const device, uint32_t const nbyte)
 {
    /* receive the data and forward to upper layer */
-   ciaaDriverAio_uartType * uart = device->layer;
+   ciaaSerialDevices_txConfirmation(device->upLayer, nbyte);
+}
+
+/** \brief get the time of the peripheral models */
+static ciaaDriverSim_timeType ciaaDriverAio_getTime(void)
+{
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   return ciaaDriverSim_getTime();
+#else
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+
+   return (ciaaDriverSim_timeType)now.tv_sec * CIAADRVSIM_SECOND + now.tv_nsec;
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+}
+
+/** \brief get the count of samples due since the start
+ **
+ ** Shall be called with the lock of the device taken.
+ **/
+static uint64_t ciaaDriverAio_due(ciaaDriverAio_aioType const * aio)
+{
+   ciaaDriverSim_timeType elapsed = ciaaDriverAio_getTime() - aio->start;
+
+   /* split the time to avoid overflowing with high sample rates */
+   return (elapsed / CIAADRVSIM_SECOND) * aio->sampleRate +
+      (elapsed % CIAADRVSIM_SECOND) * aio->sampleRate / CIAADRVSIM_SECOND;
+}
+
+/** \brief restart the time base of a device
+ **
+ ** The samples converted before are discarded. Shall be called with the lock
+ ** of the device taken.
+ **/
+static void ciaaDriverAio_restart(ciaaDriverAio_aioType * aio)
+{
+   aio->start = ciaaDriverAio_getTime();
+   aio->samples = 0;
+   aio->outputEnd = 0;
+   aio->head = 0;
+   aio->count = 0;
+}
+
+/** \brief get the period to convert the due samples */
+static ciaaDriverSim_timeType ciaaDriverAio_period(ciaaDriverAio_aioType const * aio)
+{
+   ciaaDriverSim_timeType ret = CIAADRVSIM_SECOND / aio->sampleRate;
+
+   if (CIAADRVAIO_BATCH_PERIOD > ret)
+   {
+      ret = CIAADRVAIO_BATCH_PERIOD;
+   }
+
+   return ret;
+}
+
+/** \brief convert the due samples of an adc
+ **
+ ** Shall be called with the lock of the device taken. The samples which do
+ ** not fit in the fifo are lost as in an adc not serviced in time.
+ **/
+static void ciaaDriverAio_convert(ciaaDriverAio_aioType * aio)
+{
+   uint64_t due = ciaaDriverAio_due(aio);
+   uint16_t sample = 0;
+
+   if ((due - aio->samples) > CIAADRVAIO_FIFO_SIZE)
+   {
+      /* skip the samples which can not be stored anyway */
+      aio->overruns += (uint32_t)(due - aio->samples - CIAADRVAIO_FIFO_SIZE);
+      aio->samples = due - CIAADRVAIO_FIFO_SIZE;
+   }
+
+   for(; aio->samples < due; aio->samples++)
+   {
+      if (NULL != aio->stimulus)
+      {
+         sample = aio->stimulus[(aio->samples % aio->frames) *
+            CIAADRVAIO_CHANNELS + aio->channel];
+         sample = (sample & 0x3FF) >> aio->shift;
+      }
+
+      if (CIAADRVAIO_FIFO_SIZE > aio->count)
+      {
+         aio->fifo[(aio->head + aio->count) % CIAADRVAIO_FIFO_SIZE] = sample;
+         aio->count++;
+      }
+      else
+      {
+         aio->overruns++;
+      }
+   }
+}
+
+/** \brief convert the due samples or output the written ones
+ **
+ ** Called periodically by the sampler or the simulation. The upper layer is
+ ** called without the lock of the device.
+ **/
+static void ciaaDriverAio_service(void * param)
+{
+   ciaaDevices_deviceType const * const device = param;
+   ciaaDriverAio_aioType * aio = device->layer;
+   uint32_t indicate = 0;
+   uint32_t confirm = 0;
+
+   pthread_mutex_lock(&aio->lock);
+   if (aio->adc)
+   {
+      ciaaDriverAio_convert(aio);
+      if (aio->rxInterrupt)
+      {
+         indicate = aio->count * sizeof(uint16_t);
+      }
+   }
+   else if ((0 != aio->pending) && (ciaaDriverAio_due(aio) >= aio->outputEnd))
+   {
+      /* the written samples have been output */
+      confirm = aio->pending;
+      aio->pending = 0;
+   }
+   pthread_mutex_unlock(&aio->lock);
+
+   if (0 != indicate)
+   {
+      ciaaDriverAio_rxIndication(device, indicate);
+   }
+   if (0 != confirm)
+   {
+      ciaaDriverAio_txConfirmation(device, confirm);
+   }
+}
+
+#ifndef CIAADRVSIM_VIRTUAL_TIME
+/** \brief sampler thread of a device
+ **
+ ** Services the device with the period of the batches in the wall clock.
+ **/
+static void * ciaaDriverAio_sampler(void * param)
+{
+   ciaaDevices_deviceType const * const device = param;
+   ciaaDriverAio_aioType * aio = device->layer;
+   ciaaDriverSim_timeType period;
+   struct timespec next;
+   bool running;
+
+   clock_gettime(CLOCK_MONOTONIC, &next);
+
+   pthread_mutex_lock(&aio->lock);
+   running = aio->running;
+   period = ciaaDriverAio_period(aio);
+   pthread_mutex_unlock(&aio->lock);
+
+   while (running)
+   {
+      next.tv_nsec += period;
+      while (CIAADRVSIM_SECOND <= (ciaaDriverSim_timeType)next.tv_nsec)
+      {
+         next.tv_nsec -= CIAADRVSIM_SECOND;
+         next.tv_sec++;
+      }
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+      ciaaDriverAio_service(param);
+
+      pthread_mutex_lock(&aio->lock);
+      running = aio->running;
+      period = ciaaDriverAio_period(aio);
+      pthread_mutex_unlock(&aio->lock);
+   }
+
+   return NULL;
+}
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
 
-   ciaaSerialDevices_txConfirmation(device->upLayer, uart->txBuffer.length);
+/** \brief start servicing a device */
+static void ciaaDriverAio_startService(ciaaDevices_deviceType * device)
+{
+   ciaaDriverAio_aioType * aio = device->layer;
+
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   aio->service.fct = ciaaDriverAio_service;
+   aio->service.param = device;
+   ciaaDriverSim_schedule(&aio->service, ciaaDriverAio_period(aio),
+         ciaaDriverAio_period(aio));
+#else
+   aio->running = true;
+   pthread_create(&aio->sampler, NULL, ciaaDriverAio_sampler, device);
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+}
+
+/** \brief stop servicing a device
+ **
+ ** Once returned the upper layer is not called anymore.
+ **/
+static void ciaaDriverAio_stopService(ciaaDevices_deviceType const * device)
+{
+   ciaaDriverAio_aioType * aio = device->layer;
+
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   ciaaDriverSim_cancel(&aio->service);
+#else
+   pthread_mutex_lock(&aio->lock);
+   aio->running = false;
+   pthread_mutex_unlock(&aio->lock);
+   pthread_join(aio->sampler, NULL);
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+}
+
+/** \brief map the stimulus of an adc, the inputs are 0 without it */
+static void ciaaDriverAio_mapStimulus(ciaaDriverAio_aioType * aio)
+{
+   struct stat info;
+   void * map;
+   int fd;
+
+   aio->stimulus = NULL;
+   aio->frames = 0;
+
+   fd = open(aio->filename, O_RDONLY);
+   if (0 <= fd)
+   {
+      if ((0 == fstat(fd, &info)) &&
+          (CIAADRVAIO_CHANNELS * sizeof(uint16_t) <= (size_t)info.st_size))
+      {
+         map = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+         if (MAP_FAILED != map)
+         {
+            aio->stimulus = map;
+            aio->stimulusSize = info.st_size;
+            aio->frames = info.st_size / (CIAADRVAIO_CHANNELS * sizeof(uint16_t));
+         }
+      }
+      close(fd);
+   }
 }
 
 /*==================[external functions definition]==========================*/
 extern ciaaDevices_deviceType * ciaaDriverAio_open(char const * path,
       ciaaDevices_deviceType * device, uint8_t const oflag)
 {
+   ciaaDriverAio_aioType * aio = device->layer;
+
+   pthread_mutex_init(&aio->lock, NULL);
+   aio->channel = ciaaCHANNEL_0;
+   aio->shift = ciaaRESOLUTION_10BITS;
+   aio->rxInterrupt = true;
+   aio->sampleRate = CIAADRVAIO_SAMPLE_RATE;
+   aio->pending = 0;
+   aio->overruns = 0;
+   aio->record = NULL;
+
+   if (aio->adc)
+   {
+      ciaaDriverAio_mapStimulus(aio);
+   }
+   else
+   {
+      aio->stimulus = NULL;
+      aio->record = fopen(aio->filename, "wb");
+   }
+
+   /* start the continuous conversions */
+   ciaaDriverAio_restart(aio);
+   ciaaDriverAio_startService(device);
+
    return device;
 }
 
 extern int32_t ciaaDriverAio_close(ciaaDevices_deviceType const * const device)
 {
+   ciaaDriverAio_aioType * aio = device->layer;
+
+   ciaaDriverAio_stopService(device);
+
+   if (NULL != aio->stimulus)
+   {
+      munmap((void *)aio->stimulus, aio->stimulusSize);
+      aio->stimulus = NULL;
+   }
+   if (NULL != aio->record)
+   {
+      fclose(aio->record);
+      aio->record = NULL;
+   }
+   pthread_mutex_destroy(&aio->lock);
+
    return 0;
 }
 
 extern int32_t ciaaDriverAio_ioctl(ciaaDevices_deviceType const * const device, int32_t const request, void * param)
 {
-   return -1;
+   ciaaDriverAio_aioType * aio = device->layer;
+   int32_t ret = -1;
+   bool confirm = false;
+
+   pthread_mutex_lock(&aio->lock);
+   switch(request)
+   {
+      case ciaaPOSIX_IOCTL_SET_CHANNEL:
+         if ((0 <= (intptr_t)param) &&
+             ((aio->adc ? CIAADRVAIO_CHANNELS : 1) > (intptr_t)param))
+         {
+            aio->channel = (intptr_t)param;
+            ret = 0;
+         }
+         break;
+
+      case ciaaPOSIX_IOCTL_SET_SAMPLE_RATE:
+         if ((0 < (uintptr_t)param) &&
+             (CIAADRVAIO_MAX_SAMPLE_RATE >= (uintptr_t)param))
+         {
+            aio->sampleRate = (uintptr_t)param;
+            ciaaDriverAio_restart(aio);
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+            ciaaDriverSim_schedule(&aio->service, ciaaDriverAio_period(aio),
+                  ciaaDriverAio_period(aio));
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+            ret = 0;
+         }
+         break;
+
+      case ciaaPOSIX_IOCTL_SET_RESOLUTION:
+         if (aio->adc && (ciaaRESOLUTION_3BITS >= (uintptr_t)param))
+         {
+            aio->shift = (uintptr_t)param;
+            ret = 0;
+         }
+         break;
+
+      case ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT:
+         if (aio->adc)
+         {
+            aio->rxInterrupt = (bool)(intptr_t)param;
+            ret = 0;
+         }
+         break;
+
+      case ciaaPOSIX_IOCTL_STARTTX:
+         if (!aio->adc)
+         {
+            /* this one calls write if the dac is idle */
+            confirm = (0 == aio->pending);
+            ret = 0;
+         }
+         break;
+   }
+   pthread_mutex_unlock(&aio->lock);
+
+   if (confirm)
+   {
+      ciaaDriverAio_txConfirmation(device, 1);
+   }
+
+   return ret;
 }
 
 extern ssize_t ciaaDriverAio_read(ciaaDevices_deviceType const * const device, uint8_t * const buffer, size_t const size)
 {
-   size_t ret = size;
-
-   /* receive the data and forward to upper layer */
-   ciaaDriverAio_uartType * uart = device->layer;
+   ciaaDriverAio_aioType * aio = device->layer;
+   uint16_t * samples = (uint16_t *)buffer;
+   ssize_t ret = -1;
+   uint32_t count;
+   uint32_t first;
 
-   if (size > uart->rxBuffer.length)
+   if (aio->adc)
    {
-      ret = uart->rxBuffer.length;
+      pthread_mutex_lock(&aio->lock);
+      count = size / sizeof(uint16_t);
+      if (count > aio->count)
+      {
+         count = aio->count;
+      }
+
+      /* copy the samples in up to two chunks of the fifo */
+      first = CIAADRVAIO_FIFO_SIZE - aio->head;
+      if (first > count)
+      {
+         first = count;
+      }
+      ciaaPOSIX_memcpy(samples, &aio->fifo[aio->head], first * sizeof(uint16_t));
+      ciaaPOSIX_memcpy(&samples[first], &aio->fifo[0],
+            (count - first) * sizeof(uint16_t));
+
+      aio->head = (aio->head + count) % CIAADRVAIO_FIFO_SIZE;
+      aio->count -= count;
+      pthread_mutex_unlock(&aio->lock);
+
+      ret = count * sizeof(uint16_t);
    }
 
-   /* copy received bytes to upper layer */
-   ciaaPOSIX_memcpy(buffer, &uart->rxBuffer.buffer[0], ret);
-
    return ret;
 }
 
 extern ssize_t ciaaDriverAio_write(ciaaDevices_deviceType const * const device, uint8_t const * const buffer, size_t const size)
 {
-   size_t ret = 0;
+   ciaaDriverAio_aioType * aio = device->layer;
+   ssize_t ret = -1;
+   uint64_t due;
+   uint32_t count;
 
-   /* write data */
-   ciaaDriverAio_uartType * uart = device->layer;
-
-   if (0 == uart->txBuffer.length)
+   if (!aio->adc)
    {
-      /* copy data */
-      ciaaPOSIX_memcpy(&uart->txBuffer.buffer, buffer, size);
-
-      /* return lenght and set 0 for the next */
-      ret = size;
-
-      /* set length of the buffer */
-      uart->txBuffer.length = size;
+      ret = 0;
+
+      pthread_mutex_lock(&aio->lock);
+      if (0 == aio->pending)
+      {
+         count = size / sizeof(uint16_t);
+         if (CIAADRVAIO_FIFO_SIZE < count)
+         {
+            count = CIAADRVAIO_FIFO_SIZE;
+         }
+
+         if (NULL != aio->record)
+         {
+            fwrite(buffer, sizeof(uint16_t), count, aio->record);
+         }
+
+         /* the samples are output at the sample rate from now or from the
+          * end of the previous output if it is not over */
+         due = ciaaDriverAio_due(aio);
+         if (aio->outputEnd < due)
+         {
+            aio->outputEnd = due;
+         }
+         aio->outputEnd += count;
+
+         ret = count * sizeof(uint16_t);
+         aio->pending = ret;
+      }
+      pthread_mutex_unlock(&aio->lock);
    }
 
    return ret;
@@ -186,7 +595,7 @@ void ciaaDriverAio_init(void)
 {
    uint8_t loopi;
 
-   /* add uart driver to the list of devices */
+   /* add aio driver to the list of devices */
    for(loopi = 0; loopi < ciaaDriverAioConst.countOfDevices; loopi++) {
       /* add each device */
       ciaaSerialDevices_addDriver(ciaaDriverAioConst.devices[loopi]);
@@ -197,17 +606,17 @@ void ciaaDriverAio_init(void)
 /*==================[interrupt hanlders]=====================================*/
 ISR(ADC0_IRQHandler)
 {
-   ciaaDriverAio_rxIndication(&ciaaDriverAio_device0);
+   ciaaDriverAio_service(&ciaaDriverAio_device0);
 }
 
 ISR(ADC1_IRQHandler)
 {
-   ciaaDriverAio_txConfirmation(&ciaaDriverAio_device0);
+   ciaaDriverAio_service(&ciaaDriverAio_device1);
 }
 
 ISR(DMA_IRQHandler)
 {
-   ciaaDriverAio_txConfirmation(&ciaaDriverAio_device1);
+   ciaaDriverAio_service(&ciaaDriverAio_device2);
 }
 
 /** @} doxygen end group definition */
@@ -34,6 +34,12 @@
  **
  ** Simulated DIO Driver for Posix for testing proposes
  **
+ ** The inputs follow a stimulus script and the changes of the outputs are
+ ** recorded to a file, see ciaaDriverDio_Internal.h. The time base is the
+ ** wall clock or the virtual time if CIAADRVSIM_VIRTUAL_TIME is defined.
+ ** While edge events are enabled the inputs are serviced every debounce
+ ** period and the upper layer is indicated of the queued events.
+ **
  **/
 
 /** \addtogroup CIAA_Firmware CIAA Firmware
@@ -48,6 +54,8 @@
 #include "ciaaDriverDio_Internal.h"
 #include "ciaaPOSIX_stdlib.h"
 #include "ciaaPOSIX_string.h"
+#include "ciaaPOSIX_ioctl_dio.h"
+#include <time.h>
 
 /*==================[macros and definitions]=================================*/
 /** \brief Pointer to Devices */
@@ -101,38 +109,438 @@ static ciaaDriverConstType const ciaaDriverDioConst = {
 
 /*==================[external data definition]===============================*/
 /** \brief Dio 0 */
-ciaaDriverDio_dioType ciaaDriverDio_dio0;
+ciaaDriverDio_dioType ciaaDriverDio_dio0 = {
+   true, CIAADRVDIO_STIMULUS
+};
 
 /** \brief Dio 1 */
-ciaaDriverDio_dioType ciaaDriverDio_dio1;
+ciaaDriverDio_dioType ciaaDriverDio_dio1 = {
+   false, CIAADRVDIO_RECORD
+};
 
 /*==================[internal functions definition]==========================*/
+/** \brief get the time of the peripheral models */
+static ciaaDriverSim_timeType ciaaDriverDio_getTime(void)
+{
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   return ciaaDriverSim_getTime();
+#else
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+
+   return (ciaaDriverSim_timeType)now.tv_sec * CIAADRVSIM_SECOND + now.tv_nsec;
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+}
+
+/** \brief load the next state of the stimulus
+ **
+ ** Shall be called with the lock of the device taken.
+ **/
+static void ciaaDriverDio_loadNext(ciaaDriverDio_dioType * dio)
+{
+   char line[80];
+   unsigned long long time;
+   unsigned int state;
+
+   dio->next = false;
+   while ((NULL != dio->file) && (!dio->next) &&
+          (NULL != fgets(line, sizeof(line), dio->file)))
+   {
+      if (('#' != line[0]) &&
+          (2 == sscanf(line, "%llu %x", &time, &state)))
+      {
+         dio->next = true;
+         dio->nextTime = dio->start + time * CIAADRVSIM_MICROSECOND;
+         dio->nextState = state & ((1 << CIAADRVDIO_INPUTS) - 1);
+      }
+   }
+}
+
+/** \brief timestamp of the events in microseconds since opened */
+static uint32_t ciaaDriverDio_timestamp(ciaaDriverDio_dioType const * dio,
+      ciaaDriverSim_timeType time)
+{
+   return (uint32_t)((time - dio->start) / CIAADRVSIM_MICROSECOND);
+}
+
+/** \brief take the debounce samples due until a time
+ **
+ ** Models the periodic timer running while some input is settling. Shall
+ ** be called with the lock of the device taken.
+ **/
+static void ciaaDriverDio_debounce(ciaaDriverDio_dioType * dio,
+      ciaaDriverSim_timeType time)
+{
+   uint32_t settling = dio->event.settling;
+
+   while ((0 != settling) && (dio->tick <= time))
+   {
+      settling = ciaaDriverDioEvent_sample(&dio->event, dio->state,
+            ciaaDriverDio_timestamp(dio, dio->tick));
+      dio->tick += CIAADRVDIO_DEBOUNCE_PERIOD;
+   }
+}
+
+/** \brief update the inputs to the current time
+ **
+ ** Each change of the stimulus is sampled at its time like a pin interrupt,
+ ** interleaved with the debounce samples. Shall be called with the lock of
+ ** the device taken.
+ **/
+static void ciaaDriverDio_update(ciaaDriverDio_dioType * dio)
+{
+   ciaaDriverSim_timeType now = ciaaDriverDio_getTime();
+
+   while (dio->next && (dio->nextTime <= now))
+   {
+      ciaaDriverDio_debounce(dio, dio->nextTime);
+      if (0 == dio->event.settling)
+      {
+         /* the debounce timer starts with the first edge */
+         dio->tick = dio->nextTime + CIAADRVDIO_DEBOUNCE_PERIOD;
+      }
+      dio->state = dio->nextState;
+      ciaaDriverDioEvent_sample(&dio->event, dio->state,
+            ciaaDriverDio_timestamp(dio, dio->nextTime));
+      ciaaDriverDio_loadNext(dio);
+   }
+   ciaaDriverDio_debounce(dio, now);
+}
+
+/** \brief update the inputs and indicate the queued events
+ **
+ ** Called periodically by the sampler or the simulation. The upper layer is
+ ** called without the lock of the device.
+ **/
+static void ciaaDriverDio_service(void * param)
+{
+   ciaaDevices_deviceType const * const device = param;
+   ciaaDriverDio_dioType * dio = device->layer;
+   uint32_t count;
+
+   pthread_mutex_lock(&dio->lock);
+   ciaaDriverDio_update(dio);
+   count = ciaaDriverDioEvent_count(&dio->event);
+   pthread_mutex_unlock(&dio->lock);
+
+   if (0 != count)
+   {
+      ciaaDioDevices_eventIndication(device->upLayer);
+   }
+}
+
+#ifndef CIAADRVSIM_VIRTUAL_TIME
+/** \brief sampler thread of the inputs
+ **
+ ** Services the device every debounce period in the wall clock.
+ **/
+static void * ciaaDriverDio_sampler(void * param)
+{
+   ciaaDevices_deviceType const * const device = param;
+   ciaaDriverDio_dioType * dio = device->layer;
+   struct timespec next;
+   bool running;
+
+   clock_gettime(CLOCK_MONOTONIC, &next);
+
+   pthread_mutex_lock(&dio->lock);
+   running = dio->running;
+   pthread_mutex_unlock(&dio->lock);
+
+   while (running)
+   {
+      next.tv_nsec += CIAADRVDIO_DEBOUNCE_PERIOD;
+      while (CIAADRVSIM_SECOND <= (ciaaDriverSim_timeType)next.tv_nsec)
+      {
+         next.tv_nsec -= CIAADRVSIM_SECOND;
+         next.tv_sec++;
+      }
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+      ciaaDriverDio_service(param);
+
+      pthread_mutex_lock(&dio->lock);
+      running = dio->running;
+      pthread_mutex_unlock(&dio->lock);
+   }
+
+   return NULL;
+}
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+
+/** \brief start servicing the inputs */
+static void ciaaDriverDio_startService(ciaaDevices_deviceType const * device)
+{
+   ciaaDriverDio_dioType * dio = device->layer;
+
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   dio->service.fct = ciaaDriverDio_service;
+   dio->service.param = (void *)device;
+   ciaaDriverSim_schedule(&dio->service, CIAADRVDIO_DEBOUNCE_PERIOD,
+         CIAADRVDIO_DEBOUNCE_PERIOD);
+#else
+   dio->running = true;
+   pthread_create(&dio->sampler, NULL, ciaaDriverDio_sampler, (void *)device);
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+}
+
+/** \brief stop servicing the inputs
+ **
+ ** Once returned the upper layer is not called anymore.
+ **/
+static void ciaaDriverDio_stopService(ciaaDevices_deviceType const * device)
+{
+   ciaaDriverDio_dioType * dio = device->layer;
+
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   ciaaDriverSim_cancel(&dio->service);
+#else
+   pthread_mutex_lock(&dio->lock);
+   dio->running = false;
+   pthread_mutex_unlock(&dio->lock);
+   pthread_join(dio->sampler, NULL);
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+}
+
+/** \brief pack the state of the pins in a byte buffer
+ **
+ ** \param[in] state state of the pins, the bit n is the pin n
+ ** \param[in] pinCount count of pins
+ ** \param[out] buffer user buffer
+ ** \param[in] size user buffer size
+ ** \return count of bytes stored in the buffer
+ **/
+static ssize_t ciaaDriverDio_packPins(uint32_t state, uint32_t pinCount,
+      uint8_t * buffer, size_t size)
+{
+   size_t count = (pinCount + 7) >> 3;
+   size_t loopi;
+
+   /* adjust the bytes according to provided buffer length */
+   if (count > size)
+   {
+      count = size;
+   }
+   for (loopi = 0; loopi < count; loopi++)
+   {
+      buffer[loopi] = (uint8_t)(state >> (8 * loopi));
+   }
+
+   return count;
+}
+
+/** \brief set the state of the outputs and record the change
+ **
+ ** Shall be called with the lock of the device taken.
+ **/
+static void ciaaDriverDio_setOutputs(ciaaDriverDio_dioType * dio, uint32_t state)
+{
+   state &= (1 << CIAADRVDIO_OUTPUTS) - 1;
+
+   if ((state != dio->state) && (NULL != dio->file))
+   {
+      /* record the change */
+      fprintf(dio->file, "%llu 0x%02x\n", (unsigned long long)
+            ((ciaaDriverDio_getTime() - dio->start) / CIAADRVSIM_MICROSECOND),
+            (unsigned int)state);
+   }
+   dio->state = state;
+}
 
 /*==================[external functions definition]==========================*/
 extern ciaaDevices_deviceType * ciaaDriverDio_open(char const * path,
       ciaaDevices_deviceType * device, uint8_t const oflag)
 {
+   ciaaDriverDio_dioType * dio = device->layer;
+
+   pthread_mutex_init(&dio->lock, NULL);
+   dio->state = 0;
+   dio->start = ciaaDriverDio_getTime();
+   dio->next = false;
+
+   if (dio->input)
+   {
+      dio->file = fopen(dio->filename, "r");
+      ciaaDriverDio_loadNext(dio);
+      ciaaDriverDioEvent_init(&dio->event, dio->events, CIAADRVDIO_EVENTS,
+            dio->state);
+   }
+   else
+   {
+      dio->file = fopen(dio->filename, "w");
+   }
+
    return device;
 }
 
 extern int32_t ciaaDriverDio_close(ciaaDevices_deviceType const * const device)
 {
+   ciaaDriverDio_dioType * dio = device->layer;
+
+   if (dio->input && (0 != dio->event.enabled))
+   {
+      ciaaDriverDio_stopService(device);
+      dio->event.enabled = 0;
+   }
+   if (NULL != dio->file)
+   {
+      fclose(dio->file);
+      dio->file = NULL;
+   }
+   pthread_mutex_destroy(&dio->lock);
+
    return 0;
 }
 
 extern int32_t ciaaDriverDio_ioctl(ciaaDevices_deviceType const * const device, int32_t const request, void * param)
 {
-   return -1;
+   ciaaDriverDio_dioType * dio = device->layer;
+   uint32_t mask = (uint32_t)(uintptr_t)param;
+   ciaaPOSIX_dioDebounceType const * debounce = param;
+   bool start = false;
+   bool stop = false;
+   int32_t ret = -1;
+
+   if (dio->input)
+   {
+      pthread_mutex_lock(&dio->lock);
+      ciaaDriverDio_update(dio);
+      switch (request)
+      {
+         case ciaaPOSIX_IOCTL_DIO_SET_EVENTS:
+            if (0 == (mask & ~(uint32_t)((1 << CIAADRVDIO_INPUTS) - 1)))
+            {
+               start = (0 == dio->event.enabled) && (0 != mask);
+               stop = (0 != dio->event.enabled) && (0 == mask);
+               ciaaDriverDioEvent_enable(&dio->event, mask);
+               ret = 0;
+            }
+            break;
+
+         case ciaaPOSIX_IOCTL_DIO_SET_DEBOUNCE:
+            if (NULL != debounce)
+            {
+               ciaaDriverDioEvent_setDebounce(&dio->event,
+                     debounce->inputs & ((1 << CIAADRVDIO_INPUTS) - 1),
+                     debounce->samples);
+               ret = 0;
+            }
+            break;
+
+         case ciaaPOSIX_IOCTL_DIO_GET_EVENT_COUNT:
+            ret = ciaaDriverDioEvent_count(&dio->event);
+            break;
+
+         default:
+            ret = -1;
+            break;
+      }
+      pthread_mutex_unlock(&dio->lock);
+
+      /* the service takes the lock, it is started and stopped without it */
+      if (start)
+      {
+         ciaaDriverDio_startService(device);
+      }
+      if (stop)
+      {
+         ciaaDriverDio_stopService(device);
+      }
+   }
+   else
+   {
+      pthread_mutex_lock(&dio->lock);
+      switch (request)
+      {
+         case ciaaPOSIX_IOCTL_DIO_SET:
+            ciaaDriverDio_setOutputs(dio, dio->state | mask);
+            ret = 0;
+            break;
+
+         case ciaaPOSIX_IOCTL_DIO_CLEAR:
+            ciaaDriverDio_setOutputs(dio, dio->state & ~mask);
+            ret = 0;
+            break;
+
+         case ciaaPOSIX_IOCTL_DIO_TOGGLE:
+            ciaaDriverDio_setOutputs(dio, dio->state ^ mask);
+            ret = 0;
+            break;
+
+         default:
+            ret = -1;
+            break;
+      }
+      pthread_mutex_unlock(&dio->lock);
+   }
+
+   return ret;
 }
 
 extern ssize_t ciaaDriverDio_read(ciaaDevices_deviceType const * const device, uint8_t* buffer, size_t size)
 {
-   return 0;
+   ciaaDriverDio_dioType * dio = device->layer;
+   ssize_t ret;
+
+   pthread_mutex_lock(&dio->lock);
+   if (dio->input)
+   {
+      ciaaDriverDio_update(dio);
+      if (0 != dio->event.enabled)
+      {
+         /* whole events, the buffer is an array of events */
+         ret = ciaaDriverDioEvent_get(&dio->event,
+               (ciaaPOSIX_dioEventType *)buffer,
+               size / sizeof(ciaaPOSIX_dioEventType));
+         ret *= sizeof(ciaaPOSIX_dioEventType);
+      }
+      else
+      {
+         ret = ciaaDriverDio_packPins(dio->state, CIAADRVDIO_INPUTS, buffer,
+               size);
+      }
+   }
+   else
+   {
+      ret = ciaaDriverDio_packPins(dio->state, CIAADRVDIO_OUTPUTS, buffer, size);
+   }
+   pthread_mutex_unlock(&dio->lock);
+
+   return ret;
 }
 
 extern ssize_t ciaaDriverDio_write(ciaaDevices_deviceType const * const device, uint8_t const * const buffer, size_t const size)
 {
-   return 0;
+   ciaaDriverDio_dioType * dio = device->layer;
+   ssize_t ret = -1;
+   uint32_t state;
+   size_t count;
+   size_t loopi;
+
+   if ((0 != size) && (!dio->input))
+   {
+      /* amount of bytes necessary to set all the outputs */
+      count = (CIAADRVDIO_OUTPUTS + 7) >> 3;
+      if (count > size)
+      {
+         count = size;
+      }
+
+      pthread_mutex_lock(&dio->lock);
+      state = dio->state;
+      for (loopi = 0; loopi < count; loopi++)
+      {
+         state &= ~((uint32_t)0xFF << (8 * loopi));
+         state |= (uint32_t)buffer[loopi] << (8 * loopi);
+      }
+      ciaaDriverDio_setOutputs(dio, state);
+      pthread_mutex_unlock(&dio->lock);
+
+      ret = count;
+   }
+
+   return ret;
 }
 
 void ciaaDriverDio_init(void)
@@ -35,6 +35,11 @@
  **
  ** Implements the Eth Driver for x86
  **
+ ** The frames are exchanged over the virtual wire or the tap described in
+ ** ciaaDriverEth_Internal.h. ciaaDriverEth_mainFunction receives a batch of
+ ** frames with one system call, passes them to lwIP and sends the frames
+ ** produced meanwhile with one system call.
+ **
  **/
 
 /** \addtogroup CIAA_Firmware CIAA Firmware
@@ -45,26 +50,442 @@
  ** @{ */
 
 /*==================[inclusions]=============================================*/
+/* sendmmsg and recvmmsg */
+#define _GNU_SOURCE
 #include "ciaaDriverEth.h"
 #include "ciaaDriverEth_Internal.h"
+#include "ciaaDriverSim.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#ifdef CIAADRVETH_TAP
+#include <net/if.h>
+#include <linux/if_tun.h>
+#endif
 
+#ifdef CIAA_CFG_NET_IP
 /** from LWIP */
-
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/timers.h"
+#include "netif/etharp.h"
+#endif /* #ifdef CIAA_CFG_NET_IP */
 
 /*==================[macros and definitions]=================================*/
+/** \brief prefix of the socket names on the virtual wire */
+#define CIAADRVETH_NODE_PREFIX      "node"
 
 /*==================[internal data declaration]==============================*/
 
 /*==================[internal functions declaration]=========================*/
+/** \brief sets the address of a node on the virtual wire */
+static void ciaaDriverEth_nodeAddr(struct sockaddr_un * addr, uint8_t node);
+
+/** \brief sends a broadcast frame to every other node of the wire */
+static void ciaaDriverEth_broadcast(ciaaDriverEth_ethType * eth,
+      ciaaDriverEth_frameType const * frame);
 
 /*==================[internal data definition]===============================*/
+#ifdef CIAA_CFG_NET_IP
+/** \brief Ethernet port of the board */
+static ciaaDriverEth_ethType ciaaDriverEth_eth;
+
+/** \brief lwIP interface */
+static struct netif ciaaDriverEth_netif;
+#endif /* #ifdef CIAA_CFG_NET_IP */
 
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static void ciaaDriverEth_nodeAddr(struct sockaddr_un * addr, uint8_t node)
+{
+   memset(addr, 0, sizeof(struct sockaddr_un));
+   addr->sun_family = AF_UNIX;
+   snprintf(addr->sun_path, sizeof(addr->sun_path), "%s/%s%u",
+         CIAADRVETH_WIRE, CIAADRVETH_NODE_PREFIX, node);
+}
+
+static void ciaaDriverEth_broadcast(ciaaDriverEth_ethType * eth,
+      ciaaDriverEth_frameType const * frame)
+{
+   DIR * wire = opendir(CIAADRVETH_WIRE);
+   struct dirent * entry;
+   struct sockaddr_un addr;
+   unsigned int node;
+
+   while ((NULL != wire) && (NULL != (entry = readdir(wire))))
+   {
+      if ( (1 == sscanf(entry->d_name, CIAADRVETH_NODE_PREFIX "%u", &node)) &&
+           (node != eth->mac[5]) )
+      {
+         ciaaDriverEth_nodeAddr(&addr, (uint8_t)node);
+         if (0 > sendto(eth->fd, frame->data, frame->length, 0,
+                  (struct sockaddr *)&addr, sizeof(addr)))
+         {
+            eth->txDropped++;
+         }
+      }
+   }
+
+   if (NULL != wire)
+   {
+      closedir(wire);
+   }
+}
+
+#ifdef CIAA_CFG_NET_IP
+/** \brief sends a frame from lwIP */
+static err_t ciaaDriverEth_linkOutput(struct netif * netif, struct pbuf * p)
+{
+   ciaaDriverEth_ethType * eth = netif->state;
+   uint16_t length = p->tot_len - ETH_PAD_SIZE;
+
+   if (CIAADRVETH_FRAME_SIZE < length)
+   {
+      length = CIAADRVETH_FRAME_SIZE;
+   }
+
+   /* copy the chain directly to the batch, skipping the padding */
+   pbuf_copy_partial(p, ciaaDriverEth_getTxBuffer(eth), length, ETH_PAD_SIZE);
+   ciaaDriverEth_send(eth, length);
+
+   return ERR_OK;
+}
+
+/** \brief initializes the lwIP interface */
+static err_t ciaaDriverEth_netifInit(struct netif * netif)
+{
+   ciaaDriverEth_ethType * eth = netif->state;
+
+   netif->name[0] = 'e';
+   netif->name[1] = 'n';
+   netif->hwaddr_len = ETHARP_HWADDR_LEN;
+   memcpy(netif->hwaddr, eth->mac, ETHARP_HWADDR_LEN);
+   netif->mtu = 1500;
+   netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP |
+      NETIF_FLAG_LINK_UP;
+   netif->output = etharp_output;
+   netif->linkoutput = ciaaDriverEth_linkOutput;
+
+   return ERR_OK;
+}
+
+/** \brief passes the received frames to lwIP */
+static void ciaaDriverEth_input(struct netif * netif)
+{
+   ciaaDriverEth_ethType * eth = netif->state;
+   uint32_t count = ciaaDriverEth_receive(eth);
+   uint32_t loopi;
+   struct pbuf * p;
+
+   for (loopi = 0; loopi < count; loopi++)
+   {
+      p = pbuf_alloc(PBUF_RAW, eth->rx[loopi].length + ETH_PAD_SIZE,
+            PBUF_POOL);
+
+      if (NULL != p)
+      {
+         pbuf_header(p, -ETH_PAD_SIZE);
+         pbuf_take(p, eth->rx[loopi].data, eth->rx[loopi].length);
+         pbuf_header(p, ETH_PAD_SIZE);
+
+         if (ERR_OK != netif->input(p, netif))
+         {
+            pbuf_free(p);
+         }
+      }
+   }
+}
+#endif /* #ifdef CIAA_CFG_NET_IP */
 
 /*==================[external functions definition]==========================*/
+extern int32_t ciaaDriverEth_openPort(ciaaDriverEth_ethType * eth, uint8_t node)
+{
+   static uint8_t const mac[] = { CIAADRVETH_MAC };
+   int32_t ret = -1;
+#ifdef CIAADRVETH_TAP
+   struct ifreq ifr;
+#else
+   int size = 1 << 20;
+   struct timeval timeout = { 0, CIAADRVETH_TX_TIMEOUT * 1000 };
+#endif
+
+   memcpy(eth->mac, mac, sizeof(mac));
+   eth->mac[5] = node;
+   eth->txCount = 0;
+   eth->rxFrames = 0;
+   eth->txFrames = 0;
+   eth->txDropped = 0;
+
+#ifdef CIAADRVETH_TAP
+   eth->tap = true;
+   eth->fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+   if (0 <= eth->fd)
+   {
+      memset(&ifr, 0, sizeof(ifr));
+      ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+      strncpy(ifr.ifr_name, CIAADRVETH_TAP, IFNAMSIZ - 1);
+      if (0 == ioctl(eth->fd, TUNSETIFF, &ifr))
+      {
+         ret = 0;
+      }
+      else
+      {
+         perror("Error attaching to " CIAADRVETH_TAP ": ");
+      }
+   }
+#else
+   eth->tap = false;
+   mkdir(CIAADRVETH_WIRE, 0777);
+   ciaaDriverEth_nodeAddr(&eth->addr, node);
+   /* a stale socket of a previous run would block the bind */
+   unlink(eth->addr.sun_path);
+
+   /* the receptions do not block, the transmissions wait for the receiver
+    * up to the timeout */
+   eth->fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+   if (0 <= eth->fd)
+   {
+      /* room for a few batches of full frames */
+      setsockopt(eth->fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+      setsockopt(eth->fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+      setsockopt(eth->fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+      if (0 == bind(eth->fd, (struct sockaddr *)&eth->addr, sizeof(eth->addr)))
+      {
+         ret = 0;
+      }
+      else
+      {
+         perror("Error binding " CIAADRVETH_WIRE ": ");
+      }
+   }
+#endif /* #ifdef CIAADRVETH_TAP */
+
+   if ((0 != ret) && (0 <= eth->fd))
+   {
+      close(eth->fd);
+      eth->fd = -1;
+   }
+
+   return ret;
+} /* end ciaaDriverEth_openPort */
+
+extern void ciaaDriverEth_closePort(ciaaDriverEth_ethType * eth)
+{
+   if (0 <= eth->fd)
+   {
+      ciaaDriverEth_flush(eth);
+      close(eth->fd);
+      eth->fd = -1;
+
+      if (!eth->tap)
+      {
+         unlink(eth->addr.sun_path);
+      }
+   }
+} /* end ciaaDriverEth_closePort */
+
+extern uint8_t * ciaaDriverEth_getTxBuffer(ciaaDriverEth_ethType * eth)
+{
+   if (CIAADRVETH_BATCH <= eth->txCount)
+   {
+      ciaaDriverEth_flush(eth);
+   }
+
+   return eth->tx[eth->txCount].data;
+} /* end ciaaDriverEth_getTxBuffer */
 
+extern void ciaaDriverEth_send(ciaaDriverEth_ethType * eth, uint16_t length)
+{
+   ciaaDriverEth_frameType * frame = &eth->tx[eth->txCount];
+
+   frame->length = length;
+
+   if (!eth->tap && (0 != (frame->data[0] & 1)))
+   {
+      /* keep the order of the frames */
+      ciaaDriverEth_flush(eth);
+      ciaaDriverEth_broadcast(eth, frame);
+      eth->txFrames++;
+   }
+   else if (eth->tap || (0 == memcmp(frame->data, eth->mac, 5)))
+   {
+      ciaaDriverEth_nodeAddr(&eth->txAddr[eth->txCount], frame->data[5]);
+      eth->txCount++;
+   }
+   else
+   {
+      /* the destination is not on the wire */
+      eth->txDropped++;
+      eth->txFrames++;
+   }
+} /* end ciaaDriverEth_send */
+
+extern void ciaaDriverEth_flush(ciaaDriverEth_ethType * eth)
+{
+   struct mmsghdr msgs[CIAADRVETH_BATCH];
+   struct iovec iov[CIAADRVETH_BATCH];
+   uint32_t first = 0;
+   uint32_t loopi;
+   int ret;
+
+   if (eth->tap)
+   {
+      /* a tap takes one frame per write */
+      for (loopi = 0; loopi < eth->txCount; loopi++)
+      {
+         if (0 > write(eth->fd, eth->tx[loopi].data, eth->tx[loopi].length))
+         {
+            eth->txDropped++;
+         }
+      }
+   }
+   else
+   {
+      memset(msgs, 0, eth->txCount * sizeof(struct mmsghdr));
+      for (loopi = 0; loopi < eth->txCount; loopi++)
+      {
+         iov[loopi].iov_base = eth->tx[loopi].data;
+         iov[loopi].iov_len = eth->tx[loopi].length;
+         msgs[loopi].msg_hdr.msg_iov = &iov[loopi];
+         msgs[loopi].msg_hdr.msg_iovlen = 1;
+         msgs[loopi].msg_hdr.msg_name = &eth->txAddr[loopi];
+         msgs[loopi].msg_hdr.msg_namelen = sizeof(struct sockaddr_un);
+      }
+
+      while (first < eth->txCount)
+      {
+         ret = sendmmsg(eth->fd, &msgs[first], eth->txCount - first, 0);
+
+         if (0 < ret)
+         {
+            first += ret;
+         }
+         else if ((0 > ret) && (EINTR == errno))
+         {
+            /* try again */
+         }
+         else
+         {
+            /* no receiver or it does not read, the frame is lost */
+            eth->txDropped++;
+            first++;
+         }
+      }
+   }
+
+   eth->txFrames += eth->txCount;
+   eth->txCount = 0;
+} /* end ciaaDriverEth_flush */
+
+extern uint32_t ciaaDriverEth_receive(ciaaDriverEth_ethType * eth)
+{
+   struct mmsghdr msgs[CIAADRVETH_BATCH];
+   struct iovec iov[CIAADRVETH_BATCH];
+   uint32_t loopi;
+   ssize_t length = 1;
+   int ret = 0;
+
+   if (eth->tap)
+   {
+      /* a tap gives one frame per read */
+      while ((ret < CIAADRVETH_BATCH) && (0 < length))
+      {
+         length = read(eth->fd, eth->rx[ret].data, CIAADRVETH_FRAME_SIZE);
+         if (0 < length)
+         {
+            eth->rx[ret].length = (uint16_t)length;
+            ret++;
+         }
+      }
+   }
+   else
+   {
+      memset(msgs, 0, sizeof(msgs));
+      for (loopi = 0; loopi < CIAADRVETH_BATCH; loopi++)
+      {
+         iov[loopi].iov_base = eth->rx[loopi].data;
+         iov[loopi].iov_len = CIAADRVETH_FRAME_SIZE;
+         msgs[loopi].msg_hdr.msg_iov = &iov[loopi];
+         msgs[loopi].msg_hdr.msg_iovlen = 1;
+      }
+
+      ret = recvmmsg(eth->fd, msgs, CIAADRVETH_BATCH, MSG_DONTWAIT, NULL);
+      if (0 > ret)
+      {
+         ret = 0;
+      }
+
+      for (loopi = 0; loopi < (uint32_t)ret; loopi++)
+      {
+         eth->rx[loopi].length = (uint16_t)msgs[loopi].msg_len;
+      }
+   }
+
+   eth->rxFrames += ret;
+
+   return (uint32_t)ret;
+} /* end ciaaDriverEth_receive */
+
+#ifdef CIAA_CFG_NET_IP
+void ciaaDriverEth_init(void)
+{
+   ip_addr_t ipaddr, netmask, gw;
+   char const * node = getenv("CIAADRVETH_NODE");
+   uint8_t id = CIAADRVETH_NODE;
+
+   if (NULL != node)
+   {
+      id = (uint8_t)atoi(node);
+   }
+
+   if (0 != ciaaDriverEth_openPort(&ciaaDriverEth_eth, id))
+   {
+      fprintf(stderr, "Ethernet of node %u not available\n", id);
+   }
+
+   /* Initialize LWIP */
+   lwip_init();
+
+   IP4_ADDR(&gw, 10, 0, 0, 1);
+   IP4_ADDR(&ipaddr, 10, 0, 0, CIAADRVETH_IP_BASE + id);
+   IP4_ADDR(&netmask, 255, 255, 255, 0);
+
+   netif_add(&ciaaDriverEth_netif, &ipaddr, &netmask, &gw,
+         &ciaaDriverEth_eth, ciaaDriverEth_netifInit, ethernet_input);
+   netif_set_default(&ciaaDriverEth_netif);
+   netif_set_up(&ciaaDriverEth_netif);
+}
+
+void ciaaDriverEth_mainFunction(void)
+{
+   /* Handle the received batch, the answers are queued */
+   ciaaDriverEth_input(&ciaaDriverEth_netif);
+
+   /* LWIP timers - ARP, DHCP, TCP, etc. */
+   sys_check_timeouts();
+
+   /* send the frames of this call at once */
+   ciaaDriverEth_flush(&ciaaDriverEth_eth);
+}
+
+/** \brief time base of the lwIP timers
+ **
+ ** Follows the virtual time if CIAADRVSIM_VIRTUAL_TIME is defined.
+ **/
+u32_t sys_now(void)
+{
+   return (u32_t)(ciaaDriverSim_getTime() / CIAADRVSIM_MILLISECOND);
+}
+#else /* #ifdef CIAA_CFG_NET_IP */
 void ciaaDriverEth_init(void)
 {
 
@@ -73,6 +494,12 @@ void ciaaDriverEth_init(void)
 void ciaaDriverEth_mainFunction(void)
 {
 
+}
+#endif /* #ifdef CIAA_CFG_NET_IP */
+
+void ciaaDriverEth_wait(void)
+{
+   /* the frames are polled, there is nothing to wait for */
 }
 /*==================[interrupt handlers]=====================================*/
 
@@ -80,4 +507,3 @@ void ciaaDriverEth_mainFunction(void)
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /*==================[end of file]============================================*/
-
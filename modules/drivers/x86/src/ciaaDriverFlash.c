@@ -118,6 +118,10 @@ static int32_t ciaaDriverFlash_blockErase(uint32_t start, uint32_t end) {
          {
             fwrite(buffer, CIAADRVFLASH_BLOCK_SIZE, 1, flash->storage);
          }
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+         /* the cpu is stalled while erasing */
+         ciaaDriverSim_wait((end - start + 1) * CIAADRVFLASH_ERASE_TIME);
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
          ret = 0;
       }
    }
@@ -167,6 +171,10 @@ static int32_t ciaaDriverFlash_blockWrite(uint32_t address, uint8_t const * cons
          /* write in to the previously sought position */
          ret = fwrite(buffer, 1, write_size, flash->storage);
          ciaaPOSIX_assert(ret == write_size);
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+         /* the cpu is stalled while programming */
+         ciaaDriverSim_wait(CIAADRVFLASH_PROGRAM_TIME);
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
       }
    }
    return data_index;
@@ -0,0 +1,386 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief CIAA host simulation
+ **
+ ** The events are kept in a list sorted by time. The time only advances
+ ** when no peripheral holds it, so the host scheduling does not change the
+ ** order nor the time of the events.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Drivers CIAA Drivers
+ ** @{ */
+/** \addtogroup SIM Host Simulation
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDriverSim.h"
+#include "ciaaPOSIX_stddef.h"
+#include "ciaaPOSIX_string.h"
+#include <pthread.h>
+#include <stdio.h>
+
+/*==================[macros and definitions]=================================*/
+/** \brief no task is running */
+#define CIAADRVSIM_NO_TASK             0xFFFFFFFF
+
+/** \brief limit to fire all the scheduled events */
+#define CIAADRVSIM_FOREVER             0xFFFFFFFFFFFFFFFFULL
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief protects the simulation data */
+static pthread_mutex_t ciaaDriverSim_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** \brief signaled when an event is scheduled or the holds are released */
+static pthread_cond_t ciaaDriverSim_changed = PTHREAD_COND_INITIALIZER;
+
+/** \brief virtual time */
+static ciaaDriverSim_timeType ciaaDriverSim_time;
+
+/** \brief scheduled events sorted by time */
+static ciaaDriverSim_eventType * ciaaDriverSim_events;
+
+/** \brief count of holds of the time */
+static uint32_t ciaaDriverSim_holds;
+
+/** \brief cycles consumed since the start of the simulation */
+static uint64_t ciaaDriverSim_cycles;
+
+/** \brief running task */
+static uint32_t ciaaDriverSim_running = CIAADRVSIM_NO_TASK;
+
+/** \brief trace of the tasks */
+static ciaaDriverSim_traceType ciaaDriverSim_trace[CIAADRVSIM_TRACE_TASKS];
+
+/** \brief event of the counter tick */
+static ciaaDriverSim_eventType ciaaDriverSim_tickEvent;
+
+/** \brief function handling the counter tick */
+static void (*ciaaDriverSim_tickFct)(void);
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief remove an event from the list, shall be called with the lock */
+static void ciaaDriverSim_remove(ciaaDriverSim_eventType * event)
+{
+   ciaaDriverSim_eventType ** prev = &ciaaDriverSim_events;
+
+   if (event->scheduled)
+   {
+      while (*prev != event)
+      {
+         prev = &(*prev)->next;
+      }
+      *prev = event->next;
+      event->scheduled = false;
+   }
+}
+
+/** \brief insert an event in the list, shall be called with the lock */
+static void ciaaDriverSim_insert(ciaaDriverSim_eventType * event)
+{
+   ciaaDriverSim_eventType ** prev = &ciaaDriverSim_events;
+
+   /* after the events of the same time */
+   while ((NULL != *prev) && ((*prev)->time <= event->time))
+   {
+      prev = &(*prev)->next;
+   }
+   event->next = *prev;
+   *prev = event;
+   event->scheduled = true;
+
+   pthread_cond_broadcast(&ciaaDriverSim_changed);
+}
+
+/** \brief fire the next event up to a time
+ **
+ ** Waits until the peripherals release the time.
+ **
+ ** \param[in] limit latest time of the event
+ ** \return true if an event was fired
+ **/
+static bool ciaaDriverSim_fire(ciaaDriverSim_timeType limit)
+{
+   ciaaDriverSim_eventType * event = NULL;
+
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   while (0 < ciaaDriverSim_holds)
+   {
+      pthread_cond_wait(&ciaaDriverSim_changed, &ciaaDriverSim_lock);
+   }
+
+   if ((NULL != ciaaDriverSim_events) && (ciaaDriverSim_events->time <= limit))
+   {
+      event = ciaaDriverSim_events;
+      ciaaDriverSim_events = event->next;
+      event->scheduled = false;
+      ciaaDriverSim_time = event->time;
+
+      if (0 < event->period)
+      {
+         event->time += event->period;
+         ciaaDriverSim_insert(event);
+      }
+   }
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+
+   /* the function is called as an interrupt handler, without the lock */
+   if (NULL != event)
+   {
+      event->fct(event->param);
+   }
+
+   return (NULL != event);
+}
+
+/** \brief advance the time firing the due events */
+static void ciaaDriverSim_advance(ciaaDriverSim_timeType time)
+{
+   while (ciaaDriverSim_fire(time))
+   {
+   }
+
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   if (ciaaDriverSim_time < time)
+   {
+      ciaaDriverSim_time = time;
+   }
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+}
+
+/** \brief call the tick function */
+static void ciaaDriverSim_tick(void * param)
+{
+   (void)param;
+
+   ciaaDriverSim_tickFct();
+}
+
+/*==================[external functions definition]==========================*/
+extern void ciaaDriverSim_init(void)
+{
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   while (NULL != ciaaDriverSim_events)
+   {
+      ciaaDriverSim_remove(ciaaDriverSim_events);
+   }
+   ciaaDriverSim_time = 0;
+   ciaaDriverSim_holds = 0;
+   ciaaDriverSim_cycles = 0;
+   ciaaDriverSim_running = CIAADRVSIM_NO_TASK;
+   ciaaPOSIX_memset(ciaaDriverSim_trace, 0, sizeof(ciaaDriverSim_trace));
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+} /* end ciaaDriverSim_init */
+
+extern ciaaDriverSim_timeType ciaaDriverSim_getTime(void)
+{
+   ciaaDriverSim_timeType ret;
+
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   ret = ciaaDriverSim_time;
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+
+   return ret;
+} /* end ciaaDriverSim_getTime */
+
+extern void ciaaDriverSim_schedule(ciaaDriverSim_eventType * event,
+      ciaaDriverSim_timeType delay, ciaaDriverSim_timeType period)
+{
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   ciaaDriverSim_remove(event);
+   event->time = ciaaDriverSim_time + delay;
+   event->period = period;
+   ciaaDriverSim_insert(event);
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+} /* end ciaaDriverSim_schedule */
+
+extern void ciaaDriverSim_cancel(ciaaDriverSim_eventType * event)
+{
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   ciaaDriverSim_remove(event);
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+} /* end ciaaDriverSim_cancel */
+
+extern void ciaaDriverSim_hold(void)
+{
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   ciaaDriverSim_holds++;
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+} /* end ciaaDriverSim_hold */
+
+extern void ciaaDriverSim_release(void)
+{
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   if (0 < ciaaDriverSim_holds)
+   {
+      ciaaDriverSim_holds--;
+      if (0 == ciaaDriverSim_holds)
+      {
+         pthread_cond_broadcast(&ciaaDriverSim_changed);
+      }
+   }
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+} /* end ciaaDriverSim_release */
+
+extern void ciaaDriverSim_wait(ciaaDriverSim_timeType time)
+{
+   ciaaDriverSim_timeType until;
+
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   until = ciaaDriverSim_time + time;
+   ciaaDriverSim_cycles += CIAADRVSIM_TIME_TO_CYCLES(time);
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+
+   ciaaDriverSim_advance(until);
+} /* end ciaaDriverSim_wait */
+
+extern void ciaaDriverSim_consume(uint32_t cycles)
+{
+   ciaaDriverSim_timeType until;
+
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   until = ciaaDriverSim_time + CIAADRVSIM_CYCLES_TO_TIME(cycles);
+   ciaaDriverSim_cycles += cycles;
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+
+   ciaaDriverSim_advance(until);
+} /* end ciaaDriverSim_consume */
+
+extern bool ciaaDriverSim_step(void)
+{
+   return ciaaDriverSim_fire(CIAADRVSIM_FOREVER);
+} /* end ciaaDriverSim_step */
+
+extern void ciaaDriverSim_run(void)
+{
+   while (1)
+   {
+      /* without events only the host may schedule a new one */
+      pthread_mutex_lock(&ciaaDriverSim_lock);
+      while (NULL == ciaaDriverSim_events)
+      {
+         pthread_cond_wait(&ciaaDriverSim_changed, &ciaaDriverSim_lock);
+      }
+      pthread_mutex_unlock(&ciaaDriverSim_lock);
+
+      (void)ciaaDriverSim_fire(CIAADRVSIM_FOREVER);
+   }
+} /* end ciaaDriverSim_run */
+
+extern void ciaaDriverSim_setTick(ciaaDriverSim_timeType period, void (*fct)(void))
+{
+   ciaaDriverSim_tickFct = fct;
+   ciaaDriverSim_tickEvent.fct = ciaaDriverSim_tick;
+   ciaaDriverSim_tickEvent.param = NULL;
+   ciaaDriverSim_schedule(&ciaaDriverSim_tickEvent, period, period);
+} /* end ciaaDriverSim_setTick */
+
+extern void ciaaDriverSim_taskStart(uint32_t task)
+{
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   if (CIAADRVSIM_TRACE_TASKS > task)
+   {
+      ciaaDriverSim_trace[task].dispatches++;
+      ciaaDriverSim_trace[task].startCycles = ciaaDriverSim_cycles;
+   }
+   ciaaDriverSim_running = task;
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+} /* end ciaaDriverSim_taskStart */
+
+extern void ciaaDriverSim_taskEnd(uint32_t task)
+{
+   ciaaDriverSim_traceType * trace;
+   uint64_t cycles;
+
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   if ((CIAADRVSIM_TRACE_TASKS > task) && (task == ciaaDriverSim_running))
+   {
+      trace = &ciaaDriverSim_trace[task];
+      cycles = ciaaDriverSim_cycles - trace->startCycles;
+      trace->cycles += cycles;
+      if (trace->maxCycles < cycles)
+      {
+         trace->maxCycles = cycles;
+      }
+   }
+   ciaaDriverSim_running = CIAADRVSIM_NO_TASK;
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+} /* end ciaaDriverSim_taskEnd */
+
+extern ciaaDriverSim_traceType const * ciaaDriverSim_getTrace(uint32_t task)
+{
+   ciaaDriverSim_traceType const * ret = NULL;
+
+   if (CIAADRVSIM_TRACE_TASKS > task)
+   {
+      ret = &ciaaDriverSim_trace[task];
+   }
+
+   return ret;
+} /* end ciaaDriverSim_getTrace */
+
+extern void ciaaDriverSim_printTrace(void)
+{
+   uint32_t loopi;
+
+   pthread_mutex_lock(&ciaaDriverSim_lock);
+   printf("simulated time: %llu ns, %llu cycles\n",
+         (unsigned long long)ciaaDriverSim_time,
+         (unsigned long long)ciaaDriverSim_cycles);
+   for (loopi = 0; loopi < CIAADRVSIM_TRACE_TASKS; loopi++)
+   {
+      if (0 < ciaaDriverSim_trace[loopi].dispatches)
+      {
+         printf("task %u: %u dispatches, %llu cycles, %llu cycles max\n",
+               loopi, ciaaDriverSim_trace[loopi].dispatches,
+               (unsigned long long)ciaaDriverSim_trace[loopi].cycles,
+               (unsigned long long)ciaaDriverSim_trace[loopi].maxCycles);
+      }
+   }
+   pthread_mutex_unlock(&ciaaDriverSim_lock);
+} /* end ciaaDriverSim_printTrace */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -34,6 +34,14 @@
  **
  ** Simulated UART Driver for Posix for testing proposes
  **
+ ** Simulated UART Driver for Posix for testing proposes
+ **
+ ** All the host ports (serial ports, emulation servers and their clients)
+ ** are served by a single I/O thread waiting on an epoll set, so idle ports
+ ** use no CPU and the data is forwarded as soon as it is available. The
+ ** transmission is confirmed to the upper layer only when the whole buffer
+ ** has been accepted by every host port.
+ **
  **/
 
 /** \addtogroup CIAA_Firmware CIAA Firmware
@@ -48,12 +56,14 @@
 #ifdef CIAADRVUART_ENABLE_FUNCIONALITY
    #include <pthread.h>
    #include <fcntl.h>
-   #include <signal.h>
    #include <stdio.h>
    #include <string.h>
    #include <unistd.h>
    #include <stdlib.h>
    #include <errno.h>
+   #include <sys/epoll.h>
+   #include <sys/eventfd.h>
+   #include <netinet/tcp.h>
 #endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
 
 #include "ciaaDriverUart.h"
@@ -68,6 +78,21 @@ typedef struct  {
    uint8_t countOfDevices;
 } ciaaDriverConstType;
 
+#ifdef CIAADRVUART_ENABLE_FUNCIONALITY
+/** \brief kinds of endpoints */
+#define CIAADRVUART_ENDPOINT_SERIAL    0
+#define CIAADRVUART_ENDPOINT_SERVER    1
+#define CIAADRVUART_ENDPOINT_CLIENT    2
+#define CIAADRVUART_ENDPOINT_WAKEUP    3
+
+/** \brief count of events processed by each epoll_wait call */
+#define CIAADRVUART_MAX_EVENTS         16
+
+/** \brief get the uart of an endpoint */
+#define ciaaDriverUart_getUart(index)  \
+   ((ciaaDriverUart_uartType *) ciaaDriverUartConst.devices[(index)]->layer)
+#endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
+
 /*==================[internal data declaration]==============================*/
 
 /*==================[internal functions declaration]=========================*/
@@ -134,8 +159,32 @@ static const int ciaaDriverUart_serverPorts[] = {
    CIAADRVUART_TCP_PORT_1
 };
 
+/* Constant with client mode of the serial emulation */
+static const uint8_t ciaaDriverUart_serverModes[] = {
+   CIAADRVUART_TCP_MODE_0,
+   CIAADRVUART_TCP_MODE_1
+};
+
 #endif /* CIAADRVUART_ENABLE_EMULATION */
 
+#ifdef CIAADRVUART_ENABLE_FUNCIONALITY
+
+/** \brief protects the uarts against the I/O thread */
+static pthread_mutex_t ciaaDriverUart_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** \brief I/O thread serving all host ports */
+static pthread_t ciaaDriverUart_ioThread;
+
+/** \brief epoll set of the I/O thread, -1 if the thread is not running */
+static int ciaaDriverUart_epoll = -1;
+
+/** \brief endpoint used to wake up the I/O thread */
+static ciaaDriverUart_endpointType ciaaDriverUart_wakeup = {
+   -1, CIAADRVUART_ENDPOINT_WAKEUP, 0, 0, 0
+};
+
+#endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
+
 /*==================[external data definition]===============================*/
 /** \brief Uart 0 */
 ciaaDriverUart_uartType ciaaDriverUart_uart0;
@@ -159,256 +208,742 @@ static void ciaaDriverUart_txConfirmation(ciaaDevices_deviceType const * const d
    ciaaSerialDevices_txConfirmation(device->upLayer, uart->txBuffer.length);
 }
 
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+/** \brief The last character of txBuffer left the wire */
+static void ciaaDriverUart_txEvent(void * param)
+{
+   ciaaDriverUart_txConfirmation(param);
+}
+
+/** \brief The received characters arrived through the wire */
+static void ciaaDriverUart_rxEvent(void * param)
+{
+   ciaaDriverUart_rxIndication(param);
+}
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+
+#ifdef CIAADRVUART_ENABLE_FUNCIONALITY
+/** \brief Register, modify or remove the events of an endpoint */
+static void ciaaDriverUart_setEvents(ciaaDriverUart_endpointType * endpoint, uint32_t events)
+{
+   struct epoll_event event;
+   int operation;
+
+   if ((0 <= endpoint->fileDescriptor) && (events != endpoint->events))
+   {
+      if (0 == endpoint->events)
+      {
+         operation = EPOLL_CTL_ADD;
+      }
+      else if (0 == events)
+      {
+         operation = EPOLL_CTL_DEL;
+      }
+      else
+      {
+         operation = EPOLL_CTL_MOD;
+      }
+
+      event.events = events;
+      event.data.ptr = endpoint;
+      if (0 == epoll_ctl(ciaaDriverUart_epoll, operation, endpoint->fileDescriptor, &event))
+      {
+         endpoint->events = events;
+      }
+      else
+      {
+         perror("Error setting epoll events: ");
+      }
+   }
+}
+
+/** \brief Events of an endpoint which transports data */
+static uint32_t ciaaDriverUart_dataEvents(ciaaDriverUart_endpointType const * endpoint)
+{
+   ciaaDriverUart_uartType * uart = ciaaDriverUart_getUart(endpoint->index);
+   uint32_t events = 0;
+
+   /* while rxBuffer is full the host keeps the data, this is the flow
+    * control of the reception */
+   if (!uart->rxStopped)
+   {
+      events |= EPOLLIN | EPOLLRDHUP;
+   }
+
+   /* wait until the host accepts more data */
+   if (endpoint->sent < uart->txBuffer.length)
+   {
+      events |= EPOLLOUT;
+   }
+
+   return events;
+}
+
+/** \brief Close an endpoint and remove it from the epoll set */
+static void ciaaDriverUart_closeEndpoint(ciaaDriverUart_endpointType * endpoint)
+{
+   if (0 <= endpoint->fileDescriptor)
+   {
+      ciaaDriverUart_setEvents(endpoint, 0);
+      close(endpoint->fileDescriptor);
+      endpoint->fileDescriptor = -1;
+   }
+   endpoint->sent = 0;
+}
+
+/** \brief Call a function for each endpoint of an uart which transports data */
+static void ciaaDriverUart_forEachData(ciaaDriverUart_uartType * uart,
+      void (*fct)(ciaaDriverUart_endpointType * endpoint))
+{
+#ifdef CIAADRVUART_ENABLE_EMULATION
+   uint8_t loopi;
+#endif /* CIAADRVUART_ENABLE_EMULATION */
+
 #ifdef CIAADRVUART_ENABLE_TRANSMITION
-/** \brief Initialize host serial port name and options */
-void ciaaDriverUart_serialInit(ciaaDevices_deviceType * device, uint8_t index)
+   if (0 <= uart->serial.fileDescriptor)
+   {
+      fct(&uart->serial);
+   }
+#endif /* CIAADRVUART_ENABLE_TRANSMITION */
+
+#ifdef CIAADRVUART_ENABLE_EMULATION
+   for (loopi = 0; loopi < CIAADRVUART_TCP_MAX_CLIENTS; loopi++)
+   {
+      if (0 <= uart->clients[loopi].fileDescriptor)
+      {
+         fct(&uart->clients[loopi]);
+      }
+   }
+#endif /* CIAADRVUART_ENABLE_EMULATION */
+}
+
+/** \brief Update the events of an endpoint which transports data */
+static void ciaaDriverUart_updateEvents(ciaaDriverUart_endpointType * endpoint)
 {
-   ciaaDriverUart_uartType * uart = device->layer;
+   ciaaDriverUart_setEvents(endpoint, ciaaDriverUart_dataEvents(endpoint));
+}
 
-   uart->deviceName = ciaaDriverUart_serialPorts[index];
+/** \brief Write the pending data of txBuffer to an endpoint */
+static void ciaaDriverUart_sendEndpoint(ciaaDriverUart_endpointType * endpoint)
+{
+   ciaaDriverUart_uartType * uart = ciaaDriverUart_getUart(endpoint->index);
+   ssize_t result = 1;
 
-   /* Set RAW mode */
-   cfmakeraw(&uart->deviceOptions);
+   while ((endpoint->sent < uart->txBuffer.length) && (0 < result))
+   {
+      if (CIAADRVUART_ENDPOINT_CLIENT == endpoint->kind)
+      {
+         /* a closed client shall not raise SIGPIPE */
+         result = send(endpoint->fileDescriptor,
+               &uart->txBuffer.buffer[endpoint->sent],
+               uart->txBuffer.length - endpoint->sent,
+               MSG_DONTWAIT | MSG_NOSIGNAL);
+      }
+      else
+      {
+         result = write(endpoint->fileDescriptor,
+               &uart->txBuffer.buffer[endpoint->sent],
+               uart->txBuffer.length - endpoint->sent);
+      }
 
-   /* Set baudreate 115200 */
-   cfsetspeed(&uart->deviceOptions, B115200);
+      if (0 < result)
+      {
+         endpoint->sent += result;
+      }
+      else if ((0 > result) && (EAGAIN != errno) && (EWOULDBLOCK != errno) &&
+               (CIAADRVUART_ENDPOINT_CLIENT == endpoint->kind))
+      {
+         printf("Client disconected\r\n");
+         ciaaDriverUart_closeEndpoint(endpoint);
+      }
+   }
 
-   /* Set to 8 Data bits, Parity None, 1 Stop bit */
-   uart->deviceOptions.c_cflag |= CS8;
-   uart->deviceOptions.c_cflag &= ~PARENB;
-   uart->deviceOptions.c_cflag &= ~CSTOPB;
+   if (0 <= endpoint->fileDescriptor)
+   {
+      ciaaDriverUart_updateEvents(endpoint);
+   }
+}
 
-   /* Set without hardware flow control */
-   uart->deviceOptions.c_cflag |= CLOCAL;
-   uart->deviceOptions.c_cflag &= ~CRTSCTS;
+/** \brief Mark an endpoint as up to date, used when txBuffer is confirmed */
+static void ciaaDriverUart_resetEndpoint(ciaaDriverUart_endpointType * endpoint)
+{
+   endpoint->sent = 0;
 }
 
-/** \brief Handle the serial port transmission and reception in a separated thread */
-static void * ciaaDriverUart_serialHandler(ciaaDevices_deviceType const * const device)
+/** \brief Write txBuffer to all the endpoints of an uart
+ **
+ ** Shall be called with the lock taken.
+ **
+ ** \return true if the whole buffer has been written to all the endpoints
+ **/
+static bool ciaaDriverUart_send(ciaaDriverUart_uartType * uart)
 {
-   ciaaDriverUart_uartType * uart = device->layer;
-   int result = 0;
+   bool ret = false;
+   uint16_t pending = 0;
+   uint8_t count = 0;
+#ifdef CIAADRVUART_ENABLE_EMULATION
+   uint8_t loopi;
+#endif /* CIAADRVUART_ENABLE_EMULATION */
 
-   /* while not KILL signal is received */
-   while (!result)
+   if (0 < uart->txBuffer.length)
    {
-      /* if data avaiable to send transmit it to host port */
-      if (uart->txBuffer.length)
+      ciaaDriverUart_forEachData(uart, ciaaDriverUart_sendEndpoint);
+
+#ifdef CIAADRVUART_ENABLE_TRANSMITION
+      if (0 <= uart->serial.fileDescriptor)
       {
-         result = write(uart->fileDescriptor, uart->txBuffer.buffer, uart->txBuffer.length);
-         uart->txBuffer.length -= result;
-         if (0 == uart->txBuffer.length)
+         count++;
+         pending |= uart->txBuffer.length - uart->serial.sent;
+      }
+#endif /* CIAADRVUART_ENABLE_TRANSMITION */
+
+#ifdef CIAADRVUART_ENABLE_EMULATION
+      for (loopi = 0; loopi < CIAADRVUART_TCP_MAX_CLIENTS; loopi++)
+      {
+         if (0 <= uart->clients[loopi].fileDescriptor)
          {
-            ciaaDriverUart_txConfirmation(device);
+            count++;
+            pending |= uart->txBuffer.length - uart->clients[loopi].sent;
          }
       }
-      /* try receive data from the host port */
-      result = read(uart->fileDescriptor, uart->rxBuffer.buffer + uart->rxBuffer.length, sizeof(uart->rxBuffer) - uart->rxBuffer.length);
-      if (result > 0) {
+#endif /* CIAADRVUART_ENABLE_EMULATION */
+
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+      /* the characters leave the wire even if nobody listens */
+      count = 1;
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+
+      /* without host port the data is kept until a client connects */
+      if ((0 < count) && (0 == pending))
+      {
+         ciaaDriverUart_forEachData(uart, ciaaDriverUart_resetEndpoint);
+         ret = true;
+      }
+   }
+
+   return ret;
+}
+
+/** \brief Transmit and confirm txBuffer while the upper layer provides data
+ **
+ ** Shall be called without the lock.
+ **/
+static void ciaaDriverUart_transmit(uint8_t index)
+{
+   ciaaDriverUart_uartType * uart = ciaaDriverUart_getUart(index);
+   bool confirm;
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   uint16_t length;
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+
+   do
+   {
+      pthread_mutex_lock(&ciaaDriverUart_lock);
+      confirm = ciaaDriverUart_send(uart);
+      if (confirm)
+      {
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+         length = uart->txBuffer.length;
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+         uart->txBuffer.length = 0;
+      }
+      pthread_mutex_unlock(&ciaaDriverUart_lock);
+
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+      /* the confirmation is given when the characters left the wire, the
+       * time may advance from now on */
+      if (confirm)
+      {
+         ciaaDriverSim_schedule(&uart->txEvent, CIAADRVUART_CHARS_TIME(uart, length), 0);
+         ciaaDriverSim_release();
+         confirm = false;
+      }
+#else
+      /* the upper layer writes the next data into txBuffer */
+      if (confirm)
+      {
+         ciaaDriverUart_txConfirmation(ciaaDriverUartConst.devices[index]);
+      }
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+   } while (confirm && (0 < uart->txBuffer.length));
+}
+
+/** \brief Indicate the received data to the upper layer
+ **
+ ** \param[in] index index of the uart
+ ** \param[in] count count of characters received from the host
+ **/
+static void ciaaDriverUart_indicate(uint8_t index, size_t count)
+{
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   ciaaDriverUart_uartType * uart = ciaaDriverUart_getUart(index);
+
+   /* an indication already scheduled reports these characters too */
+   if (!uart->rxEvent.scheduled)
+   {
+      ciaaDriverSim_schedule(&uart->rxEvent, CIAADRVUART_CHARS_TIME(uart, count), 0);
+   }
+#else
+   (void)count;
+
+   ciaaDriverUart_rxIndication(ciaaDriverUartConst.devices[index]);
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+}
+
+/** \brief Receive data from an endpoint and indicate it to the upper layer */
+static void ciaaDriverUart_receive(ciaaDriverUart_endpointType * endpoint)
+{
+   ciaaDriverUart_uartType * uart = ciaaDriverUart_getUart(endpoint->index);
+   ssize_t result = 0;
+   size_t space;
+
+   pthread_mutex_lock(&ciaaDriverUart_lock);
+   space = sizeof(uart->rxBuffer.buffer) - uart->rxBuffer.length;
+   if (0 < space)
+   {
+      result = read(endpoint->fileDescriptor,
+            &uart->rxBuffer.buffer[uart->rxBuffer.length], space);
+      if (0 < result)
+      {
          uart->rxBuffer.length += result;
-         ciaaDriverUart_rxIndication(device);
       }
-      result = usleep(100);
+      else if ((0 == result) || ((EAGAIN != errno) && (EWOULDBLOCK != errno)))
+      {
+         /* the client was disconected or the host port failed */
+         if (CIAADRVUART_ENDPOINT_CLIENT == endpoint->kind)
+         {
+            printf("Client disconected\r\n");
+         }
+         else
+         {
+            perror("Error reading serial port: ");
+         }
+         ciaaDriverUart_closeEndpoint(endpoint);
+      }
+   }
+   else
+   {
+      /* stop reading from all the endpoints until the upper layer reads */
+      uart->rxStopped = true;
+      ciaaDriverUart_forEachData(uart, ciaaDriverUart_updateEvents);
    }
+   pthread_mutex_unlock(&ciaaDriverUart_lock);
 
-   return NULL;
+   if (0 < result)
+   {
+      ciaaDriverUart_indicate(endpoint->index, result);
+   }
 }
 
-/** \brief Open and configure the host port and create a thread to handle the comunication */
-ciaaDevices_deviceType * ciaaDriverUart_serialOpen(ciaaDevices_deviceType * device)
+/** \brief Restart the reception of an uart if requested */
+static void ciaaDriverUart_resume(uint8_t index)
 {
-   ciaaDriverUart_uartType * uart = device->layer;
-   int result;
+   ciaaDriverUart_uartType * uart = ciaaDriverUart_getUart(index);
+   bool indicate = false;
 
-   /* if host serial port name is defined */
-   if (0 != uart->deviceName[0])
+   pthread_mutex_lock(&ciaaDriverUart_lock);
+   if (uart->rxResume)
    {
-      /* open host serial port */
-      result = open(uart->deviceName, O_RDWR | O_NOCTTY | O_NDELAY | O_NONBLOCK);
-      if (result > 0)
+      uart->rxResume = false;
+      if (uart->rxStopped)
       {
-         uart->fileDescriptor = result;
+         uart->rxStopped = false;
+         ciaaDriverUart_forEachData(uart, ciaaDriverUart_updateEvents);
+      }
+      indicate = (0 < uart->rxBuffer.length);
+   }
+   pthread_mutex_unlock(&ciaaDriverUart_lock);
+
+   /* the data kept in rxBuffer is indicated again */
+   if (indicate)
+   {
+      ciaaDriverUart_indicate(index, 0);
+   }
+}
+
+#ifdef CIAADRVUART_ENABLE_EMULATION
+/** \brief Accept the pending connections of a server */
+static void ciaaDriverUart_accept(ciaaDriverUart_endpointType * server)
+{
+   ciaaDriverUart_uartType * uart = ciaaDriverUart_getUart(server->index);
+   ciaaDriverUart_endpointType * client;
+   int clientSocket;
+   int noDelay = 1;
+   uint8_t loopi;
+   uint8_t connected;
+
+   pthread_mutex_lock(&ciaaDriverUart_lock);
+   while (0 <= (clientSocket = accept(server->fileDescriptor, NULL, NULL)))
+   {
+      client = NULL;
+      connected = 0;
+      for (loopi = 0; loopi < CIAADRVUART_TCP_MAX_CLIENTS; loopi++)
+      {
+         if (0 <= uart->clients[loopi].fileDescriptor)
+         {
+            connected++;
+         }
+         else if (NULL == client)
+         {
+            client = &uart->clients[loopi];
+         }
+      }
+
+      if ((NULL == client) ||
+          ((CIAADRVUART_TCP_MODE_EXCLUSIVE == uart->mode) && (0 < connected)))
+      {
+         /* refuse the connection */
+         close(clientSocket);
       }
       else
       {
-         perror("Error open serial port: ");
+         printf("Client Conected\r\n");
+         fcntl(clientSocket, F_SETFL, fcntl(clientSocket, F_GETFL, 0) | O_NONBLOCK);
+         /* as an uart the bytes are transmitted without waiting for more */
+         setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+         client->fileDescriptor = clientSocket;
+         client->kind = CIAADRVUART_ENDPOINT_CLIENT;
+         client->index = server->index;
+         client->events = 0;
+         /* a new client receives the data from the next buffer on */
+         client->sent = uart->txBuffer.length;
+         ciaaDriverUart_updateEvents(client);
       }
-      if (uart->fileDescriptor) {
-         /* configure serial port opstions */
-         /* Issue #173, Under MAC OS X the function returns error even when the port is properly configured */
-         #if 0
-            /* This is the correct code, but in MAC OS X returns error if an thread was created previously to this call */
-            result = tcsetattr(uart->fileDescriptor, TCSANOW, &uart->deviceOptions);
-         #else
-            /* This is a turn around to avoid the error on MAC OS X, in Linux it's unnecessary */
-            result = 0;
-            tcsetattr(uart->fileDescriptor, TCSANOW, &uart->deviceOptions);
-         #endif
-         if (result)
+   }
+   pthread_mutex_unlock(&ciaaDriverUart_lock);
+
+   /* the data kept without client can be sent now */
+   ciaaDriverUart_transmit(server->index);
+}
+#endif /* CIAADRVUART_ENABLE_EMULATION */
+
+/** \brief Serve all host ports until the epoll set is closed */
+static void * ciaaDriverUart_ioHandler(void * arg)
+{
+   struct epoll_event events[CIAADRVUART_MAX_EVENTS];
+   ciaaDriverUart_endpointType * endpoint;
+   eventfd_t value;
+   int count;
+   int loopi;
+   uint8_t index;
+
+   (void)arg;
+
+   while (1)
+   {
+      count = epoll_wait(ciaaDriverUart_epoll, events, CIAADRVUART_MAX_EVENTS, -1);
+
+      for (loopi = 0; loopi < count; loopi++)
+      {
+         endpoint = events[loopi].data.ptr;
+
+         if (CIAADRVUART_ENDPOINT_WAKEUP == endpoint->kind)
          {
-            perror("Error setting serial port parameters: ");
+            /* new data to transmit or reception to be restarted */
+            (void)eventfd_read(endpoint->fileDescriptor, &value);
+            for (index = 0; index < ciaaDriverUartConst.countOfDevices; index++)
+            {
+               ciaaDriverUart_resume(index);
+               ciaaDriverUart_transmit(index);
+            }
          }
+#ifdef CIAADRVUART_ENABLE_EMULATION
+         else if (CIAADRVUART_ENDPOINT_SERVER == endpoint->kind)
+         {
+            ciaaDriverUart_accept(endpoint);
+         }
+#endif /* CIAADRVUART_ENABLE_EMULATION */
+         else
+         {
+            if (events[loopi].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            {
+               ciaaDriverUart_receive(endpoint);
+            }
+            if (events[loopi].events & EPOLLOUT)
+            {
+               ciaaDriverUart_transmit(endpoint->index);
+            }
+         }
+      }
 
-         /* create thread to handle serial port trasmission and reception */
-         result += pthread_create(&uart->handlerThread, NULL, (void *) &ciaaDriverUart_serialHandler, device);
+      if ((0 > count) && (EINTR != errno))
+      {
+         perror("Error waiting for host ports: ");
+         break;
+      }
+   }
+
+   return NULL;
+}
+
+/** \brief Wake up the I/O thread */
+static void ciaaDriverUart_wakeUp(void)
+{
+   if (0 <= ciaaDriverUart_wakeup.fileDescriptor)
+   {
+      (void)eventfd_write(ciaaDriverUart_wakeup.fileDescriptor, 1);
+   }
+}
+
+/** \brief Start the I/O thread if not already running */
+static int ciaaDriverUart_ioStart(void)
+{
+   int result = 0;
+
+   if (0 > ciaaDriverUart_epoll)
+   {
+      ciaaDriverUart_epoll = epoll_create1(0);
+      ciaaDriverUart_wakeup.fileDescriptor = eventfd(0, EFD_NONBLOCK);
+      if ((0 > ciaaDriverUart_epoll) || (0 > ciaaDriverUart_wakeup.fileDescriptor))
+      {
+         perror("Error creating epoll set: ");
+         result = -1;
+      }
+      else
+      {
+         ciaaDriverUart_setEvents(&ciaaDriverUart_wakeup, EPOLLIN);
+
+         result = pthread_create(&ciaaDriverUart_ioThread, NULL, ciaaDriverUart_ioHandler, NULL);
          if (result)
          {
             perror("Error creating handler thread: ");
          }
       }
+   }
 
-      /* if error release was ocurred device pointer */
-      if (result) {
-         close(uart->fileDescriptor);
-         device = NULL;
+   return result;
+}
+
+/** \brief Register an opened host file descriptor in the epoll set */
+static int ciaaDriverUart_addEndpoint(ciaaDriverUart_endpointType * endpoint,
+      int fileDescriptor, uint8_t kind, uint8_t index)
+{
+   int result;
+
+   pthread_mutex_lock(&ciaaDriverUart_lock);
+   result = ciaaDriverUart_ioStart();
+   if (0 == result)
+   {
+      endpoint->fileDescriptor = fileDescriptor;
+      endpoint->kind = kind;
+      endpoint->index = index;
+      endpoint->sent = 0;
+      endpoint->events = 0;
+      if (CIAADRVUART_ENDPOINT_SERVER == kind)
+      {
+         ciaaDriverUart_setEvents(endpoint, EPOLLIN);
+      }
+      else
+      {
+         ciaaDriverUart_updateEvents(endpoint);
+      }
+      if (0 == endpoint->events)
+      {
+         endpoint->fileDescriptor = -1;
+         result = -1;
       }
    }
-   return device;
+   pthread_mutex_unlock(&ciaaDriverUart_lock);
+
+   return result;
+}
+
+/** \brief Get the index of a device */
+static uint8_t ciaaDriverUart_getIndex(ciaaDevices_deviceType const * const device)
+{
+   uint8_t index = 0;
+
+   while ((index < ciaaDriverUartConst.countOfDevices) &&
+          (device != ciaaDriverUartConst.devices[index]))
+   {
+      index++;
+   }
+
+   return index;
 }
 
+/** \brief Check if an uart has an open host port */
+static bool ciaaDriverUart_isOpen(ciaaDriverUart_uartType const * uart)
+{
+   bool ret = false;
 
+#ifdef CIAADRVUART_ENABLE_TRANSMITION
+   ret = ret || (0 <= uart->serial.fileDescriptor);
 #endif /* CIAADRVUART_ENABLE_TRANSMITION */
 
 #ifdef CIAADRVUART_ENABLE_EMULATION
-/** \brief Initialize TCP server address and port */
-void ciaaDriverUart_serverInit(ciaaDevices_deviceType * device, uint8_t index)
+   ret = ret || (0 <= uart->server.fileDescriptor);
+#endif /* CIAADRVUART_ENABLE_EMULATION */
+
+   return ret;
+}
+#endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
+
+#ifdef CIAADRVUART_ENABLE_TRANSMITION
+/** \brief Initialize host serial port name and options */
+void ciaaDriverUart_serialInit(ciaaDevices_deviceType * device, uint8_t index)
 {
    ciaaDriverUart_uartType * uart = device->layer;
 
-   uart->rxBuffer.length = 0;
+   uart->deviceName = ciaaDriverUart_serialPorts[index];
+   uart->serial.fileDescriptor = -1;
 
-   uart->serverAddress.sin_family = AF_INET;
-   uart->serverAddress.sin_addr.s_addr = INADDR_ANY;
-   uart->serverAddress.sin_port = htons(ciaaDriverUart_serverPorts[index]);
+   /* Set RAW mode */
+   cfmakeraw(&uart->deviceOptions);
+
+   /* Set baudreate 115200 */
+   cfsetspeed(&uart->deviceOptions, B115200);
+
+   /* Set to 8 Data bits, Parity None, 1 Stop bit */
+   uart->deviceOptions.c_cflag |= CS8;
+   uart->deviceOptions.c_cflag &= ~PARENB;
+   uart->deviceOptions.c_cflag &= ~CSTOPB;
+
+   /* Set without hardware flow control */
+   uart->deviceOptions.c_cflag |= CLOCAL;
+   uart->deviceOptions.c_cflag &= ~CRTSCTS;
 }
 
-/** \brief Handle the server conections, transmission and reception in a separated thread */
-static void * ciaaDriverUart_serverHandler(ciaaDevices_deviceType const * const device)
+/** \brief Open and configure the host port and register it in the I/O thread */
+ciaaDevices_deviceType * ciaaDriverUart_serialOpen(ciaaDevices_deviceType * device)
 {
    ciaaDriverUart_uartType * uart = device->layer;
-   struct sockaddr_in clientAddress;
-   socklen_t addressSize = sizeof(clientAddress);
-   int clientSocket = 0;
-   int result = 0;
+   int fileDescriptor;
+   int result = -1;
 
-   /* while not KILL signal is received */
-   while (!result)
+   /* if host serial port name is defined */
+   if (0 != uart->deviceName[0])
    {
-      /* if not client conected try to accept a new client */
-      if (clientSocket <= 0)
+      /* open host serial port */
+      fileDescriptor = open(uart->deviceName, O_RDWR | O_NOCTTY | O_NDELAY | O_NONBLOCK);
+      if (fileDescriptor >= 0)
       {
-         clientSocket = accept(uart->fileDescriptor, (struct sockaddr *) &clientAddress, &addressSize);
-         if (clientSocket > 0)
+         /* configure serial port opstions */
+         /* Issue #173, Under MAC OS X the function returns error even when the port is properly configured */
+         #if 0
+            /* This is the correct code, but in MAC OS X returns error if an thread was created previously to this call */
+            result = tcsetattr(fileDescriptor, TCSANOW, &uart->deviceOptions);
+         #else
+            /* This is a turn around to avoid the error on MAC OS X, in Linux it's unnecessary */
+            result = 0;
+            tcsetattr(fileDescriptor, TCSANOW, &uart->deviceOptions);
+         #endif
+         if (result)
          {
-            printf("Client Conected\r\n");
+            perror("Error setting serial port parameters: ");
          }
-      }
 
-      /* if a client is conected */
-      if (clientSocket > 0)
-      {
-         /* if data avaiable tod send transmit it to client */
-         if (uart->txBuffer.length > 0)
+         /* serve the serial port trasmission and reception in the I/O thread */
+         if (0 == result)
          {
-            result = send(clientSocket, uart->txBuffer.buffer, uart->txBuffer.length, MSG_DONTWAIT);
-            uart->txBuffer.length -= result;
-            if (0 == uart->txBuffer.length)
-            {
-               ciaaDriverUart_txConfirmation(device);
-            }
+            result = ciaaDriverUart_addEndpoint(&uart->serial, fileDescriptor,
+                  CIAADRVUART_ENDPOINT_SERIAL, ciaaDriverUart_getIndex(device));
          }
 
-         /* try to receive data from client */
-         if(uart->rxBuffer.length < sizeof(uart->rxBuffer.buffer))
+         /* if error release was ocurred device pointer */
+         if (result)
          {
-            result = recv(clientSocket, uart->rxBuffer.buffer + uart->rxBuffer.length, sizeof(uart->rxBuffer) - uart->rxBuffer.length, MSG_DONTWAIT);
-            if (0 == result)
-            {
-               /* the cliente was disconected */
-               printf("Client disconected\r\n");
-               close(clientSocket);
-               clientSocket = 0;
-            }
-            else if (result > 0)
-            {
-               /* the cliente was send data */
-               uart->rxBuffer.length += result;
-               ciaaDriverUart_rxIndication(device);
-            } else
-            {
-               /* nothing to do */
-            }
+            close(fileDescriptor);
          }
       }
-      result = usleep(100);
+      else
+      {
+         perror("Error open serial port: ");
+      }
+
+      if (result)
+      {
+         device = NULL;
+      }
    }
+   return device;
+}
+#endif /* CIAADRVUART_ENABLE_TRANSMITION */
 
-   /* close client conection if remains open */
-   if (clientSocket > 0)
-      close(clientSocket);
+#ifdef CIAADRVUART_ENABLE_EMULATION
+/** \brief Initialize TCP server address and port */
+void ciaaDriverUart_serverInit(ciaaDevices_deviceType * device, uint8_t index)
+{
+   ciaaDriverUart_uartType * uart = device->layer;
+   uint8_t loopi;
 
-   return NULL;
+   uart->rxBuffer.length = 0;
+
+   uart->server.fileDescriptor = -1;
+   for (loopi = 0; loopi < CIAADRVUART_TCP_MAX_CLIENTS; loopi++)
+   {
+      uart->clients[loopi].fileDescriptor = -1;
+   }
+   uart->mode = ciaaDriverUart_serverModes[index];
+
+   uart->serverAddress.sin_family = AF_INET;
+   uart->serverAddress.sin_addr.s_addr = INADDR_ANY;
+   uart->serverAddress.sin_port = htons(ciaaDriverUart_serverPorts[index]);
 }
 
-/** \brief Start the server and create a thread to handle the comunication */
+/** \brief Start the server and register it in the I/O thread */
 ciaaDevices_deviceType * ciaaDriverUart_serverOpen(ciaaDevices_deviceType * device)
 {
    ciaaDriverUart_uartType * uart = device->layer;
-   int result;
+   int fileDescriptor;
+   int result = -1;
+   int reuse = 1;
 
    /* if server port is defined */
    if (0 != uart->serverAddress.sin_port)
    {
       /* create a server socket */
-      result = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-      if (result > 0)
+      fileDescriptor = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+      if (fileDescriptor >= 0)
       {
-         uart->fileDescriptor = result;
-      }
-      else
-      {
-         perror("Error creating server socket: ");
-      }
+         /* the port can be used again immediately after closing it */
+         setsockopt(fileDescriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
 
-      if (uart->fileDescriptor)
-      {
          /* retrieve current flags of server sockets */
-         result = fcntl(uart->fileDescriptor, F_GETFL, 0);
+         result = fcntl(fileDescriptor, F_GETFL, 0);
          if (result < 0)
          {
             perror("Error getting file descriptor flags: ");
          }
 
          /* set server flags to operate in non block mode */
-         result = fcntl(uart->fileDescriptor, F_SETFL, result | O_NONBLOCK);
+         result = fcntl(fileDescriptor, F_SETFL, result | O_NONBLOCK);
          if (result < 0) perror("Error setting file descriptor asincronous flags: ");
 
          /* bind socket to server address and port */
-         result += bind(uart->fileDescriptor, (struct sockaddr *) &(uart->serverAddress), sizeof(uart->serverAddress));
+         result += bind(fileDescriptor, (struct sockaddr *) &(uart->serverAddress), sizeof(uart->serverAddress));
          if (result)
          {
             perror("Error binding socket address: ");
          }
 
          /* start server to lisen client requests */
-         result += listen(uart->fileDescriptor, 1);
+         result += listen(fileDescriptor, CIAADRVUART_TCP_MAX_CLIENTS);
          if (result < 0)
          {
             perror("Error listen on socket: ");
          }
 
-          /* create thread to serves conections, trasmission and reception */
-         result += pthread_create(&uart->handlerThread, NULL, (void *) &ciaaDriverUart_serverHandler, device);
+         /* serve conections, trasmission and reception in the I/O thread */
+         if (0 == result)
+         {
+            result = ciaaDriverUart_addEndpoint(&uart->server, fileDescriptor,
+                  CIAADRVUART_ENDPOINT_SERVER, ciaaDriverUart_getIndex(device));
+         }
+
+         /* if error release was ocurred device pointer */
          if (result)
          {
-            perror("Error creating handler thread: ");
+            close(fileDescriptor);
          }
       }
+      else
+      {
+         perror("Error creating server socket: ");
+      }
 
-      /* if error release was ocurred device pointer */
       if (result)
       {
-         close(uart->fileDescriptor);
          device = NULL;
       }
    }
@@ -440,16 +975,42 @@ extern int32_t ciaaDriverUart_close(ciaaDevices_deviceType const * const device)
 {
 #ifdef CIAADRVUART_ENABLE_FUNCIONALITY
    ciaaDriverUart_uartType * uart = device->layer;
+#ifdef CIAADRVUART_ENABLE_EMULATION
+   uint8_t loopi;
+#endif /* CIAADRVUART_ENABLE_EMULATION */
 
-   if (uart->fileDescriptor > 0)
+   /* the I/O thread keeps running for the other ports */
+   pthread_mutex_lock(&ciaaDriverUart_lock);
+
+#ifdef CIAADRVUART_ENABLE_TRANSMITION
+   /* Close serial port descriptor */
+   ciaaDriverUart_closeEndpoint(&uart->serial);
+#endif /* CIAADRVUART_ENABLE_TRANSMITION */
+
+#ifdef CIAADRVUART_ENABLE_EMULATION
+   /* close client conections and server */
+   for (loopi = 0; loopi < CIAADRVUART_TCP_MAX_CLIENTS; loopi++)
    {
-      /* Signal thread to exit and wait it */
-      pthread_kill(uart->handlerThread, SIGALRM);
-      pthread_join(uart->handlerThread, NULL);
+      ciaaDriverUart_closeEndpoint(&uart->clients[loopi]);
+   }
+   ciaaDriverUart_closeEndpoint(&uart->server);
+#endif /* CIAADRVUART_ENABLE_EMULATION */
 
-      /* Close serial port descriptor */
-      close(uart->fileDescriptor);
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   /* the data being transmitted does not hold the time anymore */
+   if (0 < uart->txBuffer.length)
+   {
+      ciaaDriverSim_release();
    }
+   ciaaDriverSim_cancel(&uart->txEvent);
+   ciaaDriverSim_cancel(&uart->rxEvent);
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+
+   uart->txBuffer.length = 0;
+   uart->rxBuffer.length = 0;
+   uart->rxStopped = false;
+
+   pthread_mutex_unlock(&ciaaDriverUart_lock);
 #endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
    return 0;
 }
@@ -460,6 +1021,8 @@ extern int32_t ciaaDriverUart_ioctl(ciaaDevices_deviceType const * const device,
 
 #ifdef CIAADRVUART_ENABLE_FUNCIONALITY
    ciaaDriverUart_uartType * uart = device->layer;
+   bool idle;
+   bool resume;
 
    if((device == ciaaDriverUartConst.devices[0]) ||
       (device == ciaaDriverUartConst.devices[1]) )
@@ -468,22 +1031,54 @@ extern int32_t ciaaDriverUart_ioctl(ciaaDevices_deviceType const * const device,
       {
          /* signal to start transmition */
          case ciaaPOSIX_IOCTL_STARTTX:
-            if (uart->fileDescriptor)
+            pthread_mutex_lock(&ciaaDriverUart_lock);
+            idle = ciaaDriverUart_isOpen(uart) && (0 == uart->txBuffer.length);
+            pthread_mutex_unlock(&ciaaDriverUart_lock);
+
+            /* while txBuffer is being transmitted the upper layer is
+             * confirmed by the I/O thread */
+            if (idle)
             {
                ciaaDriverUart_txConfirmation(device);
             }
+            ret = 0;
          break;
 
-#ifdef CIAADRVUART_ENABLE_TRANSMITION
+         /* the upper layer waits for data, restart the reception if it
+          * was stopped because rxBuffer was full */
+         case ciaaPOSIX_IOCTL_SET_ENABLE_RX_INTERRUPT:
+            if ((void*)false != param)
+            {
+               pthread_mutex_lock(&ciaaDriverUart_lock);
+               resume = uart->rxStopped;
+               uart->rxResume = resume;
+               pthread_mutex_unlock(&ciaaDriverUart_lock);
+
+               if (resume)
+               {
+                  ciaaDriverUart_wakeUp();
+               }
+            }
+            ret = 0;
+         break;
+
+#if defined(CIAADRVUART_ENABLE_TRANSMITION) || defined(CIAADRVSIM_VIRTUAL_TIME)
          /* set serial port baudrate */
          case ciaaPOSIX_IOCTL_SET_BAUDRATE:
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+            /* the baudrate sets the character time */
+            uart->baudRate = (uint32_t)(uintptr_t)param;
+            ret = 0;
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
+#ifdef CIAADRVUART_ENABLE_TRANSMITION
             ret = cfsetspeed(&uart->deviceOptions, (speed_t)(param));
-            if ((0 == ret ) && (0 != uart->fileDescriptor))
+            if ((0 == ret ) && (0 <= uart->serial.fileDescriptor))
             {
-               ret = tcsetattr(uart->fileDescriptor, TCSANOW, &uart->deviceOptions);
+               ret = tcsetattr(uart->serial.fileDescriptor, TCSANOW, &uart->deviceOptions);
             }
-         break;
 #endif /* CIAADRVUART_ENABLE_TRANSMITION */
+         break;
+#endif
 
       }
    }
@@ -497,6 +1092,10 @@ extern ssize_t ciaaDriverUart_read(ciaaDevices_deviceType const * const device,
    ciaaDriverUart_uartType * uart = device->layer;
    ssize_t ret = size;
 
+#ifdef CIAADRVUART_ENABLE_FUNCIONALITY
+   pthread_mutex_lock(&ciaaDriverUart_lock);
+#endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
+
    /* receive the data and forward to upper layer */
    if (size > uart->rxBuffer.length)
    {
@@ -505,16 +1104,19 @@ extern ssize_t ciaaDriverUart_read(ciaaDevices_deviceType const * const device,
    /* copy received bytes to upper layer */
    ciaaPOSIX_memcpy(buffer, &uart->rxBuffer.buffer[0], ret);
 
-
    uart->rxBuffer.length -= ret;
-   /* TODO: here is a synchronization problem: if a new packet arrives then
-    * buffer length changes and data may be overwritten */
 
+   /* move the remaining bytes to the begin of the buffer, the I/O thread
+    * does not write to the buffer meanwhile */
    for(i = 0; i < uart->rxBuffer.length; ++i)
    {
       uart->rxBuffer.buffer[i] = uart->rxBuffer.buffer[i+ret];
    }
 
+#ifdef CIAADRVUART_ENABLE_FUNCIONALITY
+   pthread_mutex_unlock(&ciaaDriverUart_lock);
+#endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
+
    return ret;
 }
 
@@ -524,25 +1126,50 @@ extern ssize_t ciaaDriverUart_write(ciaaDevices_deviceType const * const device,
 
    int32_t ret = 0;
 
+#ifdef CIAADRVUART_ENABLE_FUNCIONALITY
+   pthread_mutex_lock(&ciaaDriverUart_lock);
+#endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
+
    /* write data */
    if (0 == uart->txBuffer.length)
    {
-      /* copy data */
-      ciaaPOSIX_memcpy(&uart->txBuffer.buffer[0], buffer, size);
-
-      /* return lenght and set 0 for the next */
       ret = size;
+      if (size > sizeof(uart->txBuffer.buffer))
+      {
+         ret = sizeof(uart->txBuffer.buffer);
+      }
+
+      /* copy data */
+      ciaaPOSIX_memcpy(&uart->txBuffer.buffer[0], buffer, ret);
 
       /* set length of the buffer */
-      uart->txBuffer.length = size;
+      uart->txBuffer.length = ret;
+
+#if defined(CIAADRVSIM_VIRTUAL_TIME) && defined(CIAADRVUART_ENABLE_FUNCIONALITY)
+      /* the time waits until the I/O thread passed the data to the host */
+      ciaaDriverSim_hold();
+#endif
    }
 
+#ifdef CIAADRVUART_ENABLE_FUNCIONALITY
+   pthread_mutex_unlock(&ciaaDriverUart_lock);
+
+   /* the I/O thread transmits the data */
+   if (0 < ret)
+   {
+      ciaaDriverUart_wakeUp();
+   }
+#endif /* CIAADRVUART_ENABLE_FUNCIONALITY */
+
    return ret;
 }
 
 void ciaaDriverUart_init(void)
 {
    uint8_t loopi;
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+   ciaaDriverUart_uartType * uart;
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
 
    /* add uart driver to the list of devices */
    for(loopi = 0; loopi < ciaaDriverUartConst.countOfDevices; loopi++) {
@@ -558,6 +1185,16 @@ void ciaaDriverUart_init(void)
       /* initialize server address and port */
       ciaaDriverUart_serverInit(ciaaDriverUartConst.devices[loopi], loopi);
 #endif /* CIAADRVUART_ENABLE_EMULATION */
+
+#ifdef CIAADRVSIM_VIRTUAL_TIME
+      /* initialize the character time and the events of the wire */
+      uart = ciaaDriverUartConst.devices[loopi]->layer;
+      uart->baudRate = ciaaBAUDRATE_115200;
+      uart->txEvent.fct = ciaaDriverUart_txEvent;
+      uart->txEvent.param = ciaaDriverUartConst.devices[loopi];
+      uart->rxEvent.fct = ciaaDriverUart_rxEvent;
+      uart->rxEvent.param = ciaaDriverUartConst.devices[loopi];
+#endif /* CIAADRVSIM_VIRTUAL_TIME */
    }
 }
 
@@ -0,0 +1,271 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef CIAADSP_H
+#define CIAADSP_H
+/** \brief CIAA Streaming signal processing
+ **
+ ** A pipeline is a chain of stages processing blocks of samples in place:
+ ** each stage reads the block left by the previous one and leaves its
+ ** output in the same buffer, so no intermediate blocks are copied. The
+ ** count of samples may change from stage to stage (decimation, FFT) and
+ ** so may the sample format (ciaaDsp_convertType stages), as long as the
+ ** block fits in the capacity of the buffer.
+ **
+ ** Samples are Q15, Q31 or single precision float. The fixed point stages
+ ** use the dual 16 bits multiply accumulate instructions of the Cortex-M4
+ ** (__ARM_FEATURE_DSP), the float stages are vectorized with SSE on x86.
+ **
+ ** Each stage counts the cycles (cycle counter of the cpu) it needs per
+ ** block, see ciaaDsp_stageType.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup DSP Streaming signal processing
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stddef.h"
+#include "ciaaPOSIX_stdio.h"
+#include "ciaaLibs_Cycles.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief bits of the samples of the analog inputs */
+#ifndef CIAADSP_ADC_BITS
+#define CIAADSP_ADC_BITS         10
+#endif
+
+/*==================[typedef]================================================*/
+/** \brief Q15 fixed point sample, range [-1, 1) */
+typedef int16_t q15_t;
+
+/** \brief Q31 fixed point sample, range [-1, 1) */
+typedef int32_t q31_t;
+
+/** \brief format of the samples of a block */
+typedef enum {
+   CIAADSP_Q15 = 0,                 /** <= q15_t samples */
+   CIAADSP_Q31,                     /** <= q31_t samples */
+   CIAADSP_F32                      /** <= float samples */
+} ciaaDsp_formatType;
+
+struct ciaaDsp_stageStruct;
+
+/** \brief processes a block in place
+ **
+ ** \param[inout] stage     stage processing the block
+ ** \param[inout] buffer    block of samples
+ ** \param[in]    count     count of input samples
+ ** \param[in]    capacity  size of the buffer in bytes
+ ** \return       count of output samples
+ **/
+typedef uint32_t (*ciaaDsp_processType)(struct ciaaDsp_stageStruct * stage,
+      void * buffer, uint32_t count, uint32_t capacity);
+
+/** \brief stage of a pipeline
+ **
+ ** First member of each stage type, initialized by the init function of
+ ** the stage.
+ **/
+typedef struct ciaaDsp_stageStruct {
+   ciaaDsp_processType process;     /** <= processing of a block */
+   ciaaDsp_formatType inFormat;     /** <= format of the input samples */
+   ciaaDsp_formatType outFormat;    /** <= format of the output samples */
+   struct ciaaDsp_stageStruct * next; /** <= next stage of the pipeline */
+   uint32_t cycles;                 /** <= cycles of the last block */
+   uint32_t maxCycles;              /** <= cycles of the slowest block */
+   uint64_t totalCycles;            /** <= cycles of all blocks */
+   uint32_t blocks;                 /** <= count of processed blocks */
+   uint32_t samples;                /** <= count of processed input samples */
+} ciaaDsp_stageType;
+
+/** \brief pipeline of stages */
+typedef struct {
+   ciaaDsp_stageType * first;       /** <= first stage */
+   ciaaDsp_stageType * last;        /** <= last stage */
+   ciaaDsp_formatType inFormat;     /** <= format of the input blocks */
+   uint32_t capacity;               /** <= size of the block buffer in bytes */
+} ciaaDsp_pipelineType;
+
+/** \brief conversion of the sample format */
+typedef struct {
+   ciaaDsp_stageType stage;
+} ciaaDsp_convertType;
+
+/** \brief moving root mean square
+ **
+ ** Each output sample is the RMS of the last size input samples.
+ **/
+typedef struct {
+   ciaaDsp_stageType stage;
+   void * window;                   /** <= last size input samples */
+   uint32_t size;                   /** <= samples of the window */
+   uint32_t shift;                  /** <= log2(size) */
+   uint32_t pos;                    /** <= oldest sample of the window */
+   uint64_t sumQ15;                 /** <= sum of squares (Q30) */
+   float sumF32;                    /** <= sum of squares */
+} ciaaDsp_rmsType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief returns the size in bytes of a sample */
+extern uint32_t ciaaDsp_formatSize(ciaaDsp_formatType format);
+
+/** \brief initialize the common part of a stage
+ **
+ ** Used by the init functions of the stages, also by user defined stages.
+ **
+ ** \param[out] stage      stage to be initialized
+ ** \param[in]  process    processing of a block
+ ** \param[in]  inFormat   format of the input samples
+ ** \param[in]  outFormat  format of the output samples
+ **/
+extern void ciaaDsp_stageInit(ciaaDsp_stageType * stage, ciaaDsp_processType process,
+      ciaaDsp_formatType inFormat, ciaaDsp_formatType outFormat);
+
+/** \brief initialize an empty pipeline
+ **
+ ** \param[out] pipeline  pipeline to be initialized
+ ** \param[in]  inFormat  format of the input blocks
+ ** \param[in]  capacity  size in bytes of the buffers passed to
+ **                       ciaaDsp_pipelineProcess
+ **/
+extern void ciaaDsp_pipelineInit(ciaaDsp_pipelineType * pipeline,
+      ciaaDsp_formatType inFormat, uint32_t capacity);
+
+/** \brief append a stage to a pipeline
+ **
+ ** \param[inout] pipeline  pipeline
+ ** \param[in]    stage     initialized stage
+ ** \return       0 on success, -1 if the stage does not accept the output
+ **               format of the pipeline
+ **/
+extern int32_t ciaaDsp_pipelineAdd(ciaaDsp_pipelineType * pipeline,
+      ciaaDsp_stageType * stage);
+
+/** \brief returns the format of the output blocks of a pipeline */
+extern ciaaDsp_formatType ciaaDsp_pipelineFormat(ciaaDsp_pipelineType const * pipeline);
+
+/** \brief process a block in place
+ **
+ ** \param[inout] pipeline  pipeline
+ ** \param[inout] buffer    block of samples of capacity bytes, word aligned
+ ** \param[in]    count     count of input samples
+ ** \return       count of output samples left in buffer
+ **/
+extern uint32_t ciaaDsp_pipelineProcess(ciaaDsp_pipelineType * pipeline,
+      void * buffer, uint32_t count);
+
+/** \brief process the samples of a channel of a continuous acquisition
+ **
+ ** The samples of channel are converted to the input format of the
+ ** pipeline into buffer, then processed.
+ **
+ ** \param[inout] pipeline  pipeline
+ ** \param[out]   buffer    block of samples of capacity bytes, word aligned
+ ** \param[in]    block     block got with ciaaPOSIX_IOCTL_GET_BLOCK
+ ** \param[in]    channel   channel to be processed (ciaaCHANNEL_n)
+ ** \return       count of output samples left in buffer
+ **/
+extern uint32_t ciaaDsp_pipelineFeedAio(ciaaDsp_pipelineType * pipeline,
+      void * buffer, ciaaPOSIX_aioBlockType const * block, uint8_t channel);
+
+/** \brief process the samples read from an analog input
+ **
+ ** \param[inout] pipeline  pipeline
+ ** \param[out]   buffer    block of samples of capacity bytes, word aligned
+ ** \param[in]    samples   samples read with ciaaPOSIX_read
+ ** \param[in]    count     count of samples
+ ** \return       count of output samples left in buffer
+ **/
+extern uint32_t ciaaDsp_pipelineFeedAdc(ciaaDsp_pipelineType * pipeline,
+      void * buffer, uint16_t const * samples, uint32_t count);
+
+/** \brief reset the cycle counts of the stages of a pipeline */
+extern void ciaaDsp_pipelineResetStats(ciaaDsp_pipelineType * pipeline);
+
+/** \brief initialize a conversion of the sample format
+ **
+ ** Float samples are saturated to [-1, 1) when converted to fixed point.
+ **
+ ** \param[out] convert    stage to be initialized
+ ** \param[in]  inFormat   format of the input samples
+ ** \param[in]  outFormat  format of the output samples
+ **/
+extern void ciaaDsp_convertInit(ciaaDsp_convertType * convert,
+      ciaaDsp_formatType inFormat, ciaaDsp_formatType outFormat);
+
+/** \brief initialize a moving RMS of Q15 samples
+ **
+ ** \param[out] rms     stage to be initialized
+ ** \param[in]  window  storage of size samples
+ ** \param[in]  size    samples of the window, a power of 2
+ ** \return     0 on success, -1 if size is not a power of 2
+ **/
+extern int32_t ciaaDsp_rmsInitQ15(ciaaDsp_rmsType * rms, q15_t * window,
+      uint32_t size);
+
+/** \brief initialize a moving RMS of float samples
+ **
+ ** \param[out] rms     stage to be initialized
+ ** \param[in]  window  storage of size samples
+ ** \param[in]  size    samples of the window, a power of 2
+ ** \return     0 on success, -1 if size is not a power of 2
+ **/
+extern int32_t ciaaDsp_rmsInitF32(ciaaDsp_rmsType * rms, float * window,
+      uint32_t size);
+
+/** \brief returns the square root of a 32 bits integer, rounded down */
+extern uint32_t ciaaDsp_sqrtU32(uint32_t value);
+
+/** \brief returns the square root of a non negative float */
+extern float ciaaDsp_sqrtF32(float value);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef CIAADSP_H */
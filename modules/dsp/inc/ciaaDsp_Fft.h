@@ -0,0 +1,114 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef CIAADSP_FFT_H
+#define CIAADSP_FFT_H
+/** \brief CIAA Streaming signal processing FFT stage
+ **
+ ** Magnitude spectrum of frames of real samples.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup DSP Streaming signal processing
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDsp.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief count of samples of the work buffer of a FFT of size points */
+#define CIAADSP_FFT_WORK_SIZE(size)       (2 * (size))
+
+/** \brief count of samples of the twiddle table of a FFT of size points */
+#define CIAADSP_FFT_TWIDDLES_SIZE(size)   (size)
+
+/*==================[typedef]================================================*/
+/** \brief magnitude spectrum
+ **
+ ** Each frame of size input samples is replaced by the size / 2
+ ** magnitudes |X[k]| / size, k = 0 .. size / 2 - 1. Samples after the
+ ** last complete frame of a block are discarded, so blocks shall be a
+ ** multiple of size samples.
+ **/
+typedef struct {
+   ciaaDsp_stageType stage;
+   uint32_t size;                   /** <= points of the FFT */
+   uint32_t bits;                   /** <= log2(size) */
+   void * work;                     /** <= complex samples {re, im} */
+   void * twiddles;                 /** <= {cos, sin} of size / 2 angles */
+} ciaaDsp_fftType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize a FFT of Q15 samples
+ **
+ ** The butterflies are scaled by 1/2 at each of the log2(size) passes so
+ ** they can not overflow.
+ **
+ ** \param[out] fft       stage to be initialized
+ ** \param[in]  size      points of the FFT, a power of 2 and at least 2
+ ** \param[in]  work      storage of CIAADSP_FFT_WORK_SIZE samples
+ ** \param[in]  twiddles  storage of CIAADSP_FFT_TWIDDLES_SIZE samples
+ ** \return     0 on success, -1 on invalid parameters
+ **/
+extern int32_t ciaaDsp_fftInitQ15(ciaaDsp_fftType * fft, uint32_t size,
+      q15_t * work, q15_t * twiddles);
+
+/** \brief initialize a FFT of float samples
+ **
+ ** \param[out] fft       stage to be initialized
+ ** \param[in]  size      points of the FFT, a power of 2 and at least 2
+ ** \param[in]  work      storage of CIAADSP_FFT_WORK_SIZE samples
+ ** \param[in]  twiddles  storage of CIAADSP_FFT_TWIDDLES_SIZE samples
+ ** \return     0 on success, -1 on invalid parameters
+ **/
+extern int32_t ciaaDsp_fftInitF32(ciaaDsp_fftType * fft, uint32_t size,
+      float * work, float * twiddles);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef CIAADSP_FFT_H */
@@ -0,0 +1,162 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef CIAADSP_FILTER_H
+#define CIAADSP_FILTER_H
+/** \brief CIAA Streaming signal processing filter stages
+ **
+ ** FIR filters with optional decimation and cascades of biquad (IIR)
+ ** sections, both processing blocks in place.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup DSP Streaming signal processing
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDsp.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief count of samples of the state of a FIR filter */
+#define CIAADSP_FIR_STATE_SIZE(numTaps, blockSize)    ((numTaps) - 1 + (blockSize))
+
+/** \brief count of coefficients of a cascade of biquad sections */
+#define CIAADSP_BIQUAD_COEFFS_SIZE(sections)          (5 * (sections))
+
+/** \brief count of samples of the state of a cascade of biquad sections */
+#define CIAADSP_BIQUAD_STATE_SIZE(sections)           (4 * (sections))
+
+/*==================[typedef]================================================*/
+/** \brief FIR filter
+ **
+ ** The input block is filtered in chunks of up to blockSize samples. With
+ ** a decimation factor M only one of each M output samples is kept, the
+ ** phase of the decimation is kept from block to block.
+ **/
+typedef struct {
+   ciaaDsp_stageType stage;
+   void const * coeffs;             /** <= coefficients, time reversed */
+   void * state;                    /** <= last numTaps - 1 input samples
+                                     **    followed by the current chunk */
+   uint32_t numTaps;                /** <= count of coefficients */
+   uint32_t blockSize;              /** <= maximal samples of a chunk */
+   uint32_t decimation;             /** <= decimation factor */
+   uint32_t phase;                  /** <= phase of the decimation */
+} ciaaDsp_firType;
+
+/** \brief cascade of biquad sections
+ **
+ ** Each section computes
+ **   y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2]
+ ** with the coefficients {b0, b1, b2, a1, a2}, note the sign of the
+ ** feedback coefficients.
+ **/
+typedef struct {
+   ciaaDsp_stageType stage;
+   void const * coeffs;             /** <= 5 coefficients per section */
+   void * state;                    /** <= 4 samples per section */
+   uint32_t sections;               /** <= count of sections */
+   uint32_t postShift;              /** <= Q31 only: coefficients are scaled
+                                     **    by 2^-postShift */
+} ciaaDsp_biquadType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize a FIR filter of Q15 samples
+ **
+ ** \param[out] fir         stage to be initialized
+ ** \param[in]  coeffs      numTaps Q15 coefficients in time reversed order
+ **                         {h[numTaps-1], ..., h[1], h[0]}
+ ** \param[in]  numTaps     count of coefficients
+ ** \param[in]  state       storage of CIAADSP_FIR_STATE_SIZE samples
+ ** \param[in]  blockSize   maximal count of samples filtered at once
+ ** \param[in]  decimation  decimation factor, 1 for no decimation
+ ** \return     0 on success, -1 on invalid parameters
+ **/
+extern int32_t ciaaDsp_firInitQ15(ciaaDsp_firType * fir, q15_t const * coeffs,
+      uint32_t numTaps, q15_t * state, uint32_t blockSize, uint32_t decimation);
+
+/** \brief initialize a FIR filter of float samples
+ **
+ ** \param[out] fir         stage to be initialized
+ ** \param[in]  coeffs      numTaps coefficients in time reversed order
+ ** \param[in]  numTaps     count of coefficients
+ ** \param[in]  state       storage of CIAADSP_FIR_STATE_SIZE samples
+ ** \param[in]  blockSize   maximal count of samples filtered at once
+ ** \param[in]  decimation  decimation factor, 1 for no decimation
+ ** \return     0 on success, -1 on invalid parameters
+ **/
+extern int32_t ciaaDsp_firInitF32(ciaaDsp_firType * fir, float const * coeffs,
+      uint32_t numTaps, float * state, uint32_t blockSize, uint32_t decimation);
+
+/** \brief initialize a cascade of biquad sections of Q31 samples
+ **
+ ** \param[out] biquad     stage to be initialized
+ ** \param[in]  coeffs     CIAADSP_BIQUAD_COEFFS_SIZE Q31 coefficients
+ **                        scaled by 2^-postShift
+ ** \param[in]  state      storage of CIAADSP_BIQUAD_STATE_SIZE samples
+ ** \param[in]  sections   count of sections
+ ** \param[in]  postShift  scale of the coefficients, up to 30
+ ** \return     0 on success, -1 on invalid parameters
+ **/
+extern int32_t ciaaDsp_biquadInitQ31(ciaaDsp_biquadType * biquad, q31_t const * coeffs,
+      q31_t * state, uint32_t sections, uint32_t postShift);
+
+/** \brief initialize a cascade of biquad sections of float samples
+ **
+ ** \param[out] biquad     stage to be initialized
+ ** \param[in]  coeffs     CIAADSP_BIQUAD_COEFFS_SIZE coefficients
+ ** \param[in]  state      storage of CIAADSP_BIQUAD_STATE_SIZE samples
+ ** \param[in]  sections   count of sections
+ ** \return     0 on success, -1 on invalid parameters
+ **/
+extern int32_t ciaaDsp_biquadInitF32(ciaaDsp_biquadType * biquad, float const * coeffs,
+      float * state, uint32_t sections);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef CIAADSP_FILTER_H */
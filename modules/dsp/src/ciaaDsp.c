@@ -0,0 +1,477 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief CIAA Streaming signal processing
+ **
+ ** Pipeline, sample format conversions and moving RMS.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup DSP Streaming signal processing
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDsp.h"
+#include "ciaaDsp_Internal.h"
+#include "ciaaPOSIX_stdbool.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief offset of the unsigned samples of the analog inputs */
+#define CIAADSP_ADC_OFFSET       (1 << (CIAADSP_ADC_BITS - 1))
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief reads a sample as Q31, float samples are saturated */
+static q31_t ciaaDsp_readQ31(void const * buffer, ciaaDsp_formatType format, uint32_t index)
+{
+   q31_t ret;
+   float value;
+
+   switch(format)
+   {
+      case CIAADSP_Q15:
+         ret = (q31_t)((uint32_t)((q15_t const *)buffer)[index] << 16);
+         break;
+      case CIAADSP_Q31:
+         ret = ((q31_t const *)buffer)[index];
+         break;
+      default:
+         value = ((float const *)buffer)[index] * 2147483648.0f;
+         if (value >= 2147483647.0f)
+         {
+            ret = INT32_MAX;
+         }
+         else if (value <= -2147483648.0f)
+         {
+            ret = INT32_MIN;
+         }
+         else
+         {
+            ret = (q31_t)value;
+         }
+         break;
+   }
+
+   return ret;
+}
+
+/** \brief writes a sample given as Q31 or as float */
+static void ciaaDsp_write(void * buffer, ciaaDsp_formatType format, uint32_t index,
+      q31_t fixed, float value, bool isFloat)
+{
+   switch(format)
+   {
+      case CIAADSP_Q15:
+         ((q15_t *)buffer)[index] = (q15_t)(fixed >> 16);
+         break;
+      case CIAADSP_Q31:
+         ((q31_t *)buffer)[index] = fixed;
+         break;
+      default:
+         ((float *)buffer)[index] = isFloat ? value : ((float)fixed * (1.0f / 2147483648.0f));
+         break;
+   }
+}
+
+static uint32_t ciaaDsp_convertProcess(ciaaDsp_stageType * stage, void * buffer,
+      uint32_t count, uint32_t capacity)
+{
+   uint32_t inSize = ciaaDsp_formatSize(stage->inFormat);
+   uint32_t outSize = ciaaDsp_formatSize(stage->outFormat);
+   uint32_t i;
+   bool isFloat = (CIAADSP_F32 == stage->inFormat);
+
+   if ((count * outSize) > capacity)
+   {
+      /* the block does not fit, it is dropped */
+      count = 0;
+   }
+   else if (outSize > inSize)
+   {
+      /* growing samples: from the end, each sample overwrites read ones */
+      for(i = count; i > 0; i--)
+      {
+         ciaaDsp_write(buffer, stage->outFormat, i - 1, ciaaDsp_readQ31(buffer, stage->inFormat, i - 1),
+               isFloat ? ((float *)buffer)[i - 1] : 0.0f, isFloat);
+      }
+   }
+   else
+   {
+      for(i = 0; i < count; i++)
+      {
+         ciaaDsp_write(buffer, stage->outFormat, i, ciaaDsp_readQ31(buffer, stage->inFormat, i),
+               isFloat ? ((float *)buffer)[i] : 0.0f, isFloat);
+      }
+   }
+
+   return count;
+}
+
+static uint32_t ciaaDsp_rmsProcessQ15(ciaaDsp_stageType * stage, void * buffer,
+      uint32_t count, uint32_t capacity)
+{
+   ciaaDsp_rmsType * rms = (ciaaDsp_rmsType *)stage;
+   q15_t * window = (q15_t *)rms->window;
+   q15_t * samples = (q15_t *)buffer;
+   int32_t value;
+   uint32_t i;
+
+   for(i = 0; i < count; i++)
+   {
+      /* the sum of squares is exact, it does not drift */
+      rms->sumQ15 -= (uint64_t)((int32_t)window[rms->pos] * window[rms->pos]);
+      rms->sumQ15 += (uint64_t)((int32_t)samples[i] * samples[i]);
+      window[rms->pos] = samples[i];
+      rms->pos = (rms->pos + 1) & (rms->size - 1);
+
+      /* mean square is Q30, its square root Q15 */
+      value = (int32_t)ciaaDsp_sqrtU32((uint32_t)(rms->sumQ15 >> rms->shift));
+      samples[i] = ciaaDsp_satQ15(value);
+   }
+
+   return count;
+}
+
+static uint32_t ciaaDsp_rmsProcessF32(ciaaDsp_stageType * stage, void * buffer,
+      uint32_t count, uint32_t capacity)
+{
+   ciaaDsp_rmsType * rms = (ciaaDsp_rmsType *)stage;
+   float * window = (float *)rms->window;
+   float * samples = (float *)buffer;
+   float mean;
+   uint32_t i;
+   uint32_t j;
+
+   for(i = 0; i < count; i++)
+   {
+      rms->sumF32 += (samples[i] * samples[i]) - (window[rms->pos] * window[rms->pos]);
+      window[rms->pos] = samples[i];
+      rms->pos = (rms->pos + 1) & (rms->size - 1);
+
+      if (0 == rms->pos)
+      {
+         /* recompute the sum once per window against rounding drift */
+         rms->sumF32 = 0.0f;
+         for(j = 0; j < rms->size; j++)
+         {
+            rms->sumF32 += window[j] * window[j];
+         }
+      }
+
+      mean = rms->sumF32 / (float)rms->size;
+      samples[i] = ciaaDsp_sqrtF32((mean > 0.0f) ? mean : 0.0f);
+   }
+
+   return count;
+}
+
+static int32_t ciaaDsp_rmsInit(ciaaDsp_rmsType * rms, void * window, uint32_t size)
+{
+   int32_t ret = -1;
+
+   if ((size != 0) && (0 == (size & (size - 1))))
+   {
+      rms->window = window;
+      rms->size = size;
+      rms->shift = 0;
+      while ((1UL << rms->shift) < size)
+      {
+         rms->shift++;
+      }
+      rms->pos = 0;
+      rms->sumQ15 = 0;
+      rms->sumF32 = 0.0f;
+      ret = 0;
+   }
+
+   return ret;
+}
+
+/*==================[external functions definition]==========================*/
+extern uint32_t ciaaDsp_formatSize(ciaaDsp_formatType format)
+{
+   return (CIAADSP_Q15 == format) ? sizeof(q15_t) : sizeof(q31_t);
+} /* end ciaaDsp_formatSize */
+
+extern void ciaaDsp_stageInit(ciaaDsp_stageType * stage, ciaaDsp_processType process,
+      ciaaDsp_formatType inFormat, ciaaDsp_formatType outFormat)
+{
+   stage->process = process;
+   stage->inFormat = inFormat;
+   stage->outFormat = outFormat;
+   stage->next = NULL;
+   stage->cycles = 0;
+   stage->maxCycles = 0;
+   stage->totalCycles = 0;
+   stage->blocks = 0;
+   stage->samples = 0;
+} /* end ciaaDsp_stageInit */
+
+extern void ciaaDsp_pipelineInit(ciaaDsp_pipelineType * pipeline,
+      ciaaDsp_formatType inFormat, uint32_t capacity)
+{
+   pipeline->first = NULL;
+   pipeline->last = NULL;
+   pipeline->inFormat = inFormat;
+   pipeline->capacity = capacity;
+
+   ciaaLibs_cyclesEnable();
+} /* end ciaaDsp_pipelineInit */
+
+extern int32_t ciaaDsp_pipelineAdd(ciaaDsp_pipelineType * pipeline,
+      ciaaDsp_stageType * stage)
+{
+   int32_t ret = -1;
+
+   if (stage->inFormat == ciaaDsp_pipelineFormat(pipeline))
+   {
+      stage->next = NULL;
+      if (NULL == pipeline->last)
+      {
+         pipeline->first = stage;
+      }
+      else
+      {
+         pipeline->last->next = stage;
+      }
+      pipeline->last = stage;
+      ret = 0;
+   }
+
+   return ret;
+} /* end ciaaDsp_pipelineAdd */
+
+extern ciaaDsp_formatType ciaaDsp_pipelineFormat(ciaaDsp_pipelineType const * pipeline)
+{
+   return (NULL == pipeline->last) ? pipeline->inFormat : pipeline->last->outFormat;
+} /* end ciaaDsp_pipelineFormat */
+
+extern uint32_t ciaaDsp_pipelineProcess(ciaaDsp_pipelineType * pipeline,
+      void * buffer, uint32_t count)
+{
+   ciaaDsp_stageType * stage = pipeline->first;
+   uint32_t start;
+   uint32_t cycles;
+
+   if ((count * ciaaDsp_formatSize(pipeline->inFormat)) > pipeline->capacity)
+   {
+      count = 0;
+   }
+
+   while ((NULL != stage) && (0 != count))
+   {
+      start = ciaaLibs_cyclesGet();
+      stage->samples += count;
+      count = stage->process(stage, buffer, count, pipeline->capacity);
+      cycles = ciaaLibs_cyclesGet() - start;
+
+      stage->cycles = cycles;
+      if (cycles > stage->maxCycles)
+      {
+         stage->maxCycles = cycles;
+      }
+      stage->totalCycles += cycles;
+      stage->blocks++;
+
+      stage = stage->next;
+   }
+
+   return count;
+} /* end ciaaDsp_pipelineProcess */
+
+extern uint32_t ciaaDsp_pipelineFeedAio(ciaaDsp_pipelineType * pipeline,
+      void * buffer, ciaaPOSIX_aioBlockType const * block, uint8_t channel)
+{
+   uint32_t max = pipeline->capacity / ciaaDsp_formatSize(pipeline->inFormat);
+   uint32_t count = 0;
+   uint32_t i;
+   uint16_t value;
+
+   for(i = 0; (i < block->count) && (count < max); i++)
+   {
+      if (channel == ciaaAIO_SAMPLE_CHANNEL(block->samples[i]))
+      {
+         value = ciaaAIO_SAMPLE_VALUE(block->samples[i]);
+         ciaaDsp_write(buffer, pipeline->inFormat, count,
+               (q31_t)((uint32_t)(value - CIAADSP_ADC_OFFSET) << (32 - CIAADSP_ADC_BITS)),
+               (float)((int32_t)value - CIAADSP_ADC_OFFSET) * (1.0f / CIAADSP_ADC_OFFSET), true);
+         count++;
+      }
+   }
+
+   return ciaaDsp_pipelineProcess(pipeline, buffer, count);
+} /* end ciaaDsp_pipelineFeedAio */
+
+extern uint32_t ciaaDsp_pipelineFeedAdc(ciaaDsp_pipelineType * pipeline,
+      void * buffer, uint16_t const * samples, uint32_t count)
+{
+   uint32_t max = pipeline->capacity / ciaaDsp_formatSize(pipeline->inFormat);
+   uint32_t i;
+
+   if (count > max)
+   {
+      count = max;
+   }
+
+   for(i = 0; i < count; i++)
+   {
+      ciaaDsp_write(buffer, pipeline->inFormat, i,
+            (q31_t)((uint32_t)(samples[i] - CIAADSP_ADC_OFFSET) << (32 - CIAADSP_ADC_BITS)),
+            (float)((int32_t)samples[i] - CIAADSP_ADC_OFFSET) * (1.0f / CIAADSP_ADC_OFFSET), true);
+   }
+
+   return ciaaDsp_pipelineProcess(pipeline, buffer, count);
+} /* end ciaaDsp_pipelineFeedAdc */
+
+extern void ciaaDsp_pipelineResetStats(ciaaDsp_pipelineType * pipeline)
+{
+   ciaaDsp_stageType * stage;
+
+   for(stage = pipeline->first; NULL != stage; stage = stage->next)
+   {
+      stage->cycles = 0;
+      stage->maxCycles = 0;
+      stage->totalCycles = 0;
+      stage->blocks = 0;
+      stage->samples = 0;
+   }
+} /* end ciaaDsp_pipelineResetStats */
+
+extern void ciaaDsp_convertInit(ciaaDsp_convertType * convert,
+      ciaaDsp_formatType inFormat, ciaaDsp_formatType outFormat)
+{
+   ciaaDsp_stageInit(&convert->stage, ciaaDsp_convertProcess, inFormat, outFormat);
+} /* end ciaaDsp_convertInit */
+
+extern int32_t ciaaDsp_rmsInitQ15(ciaaDsp_rmsType * rms, q15_t * window,
+      uint32_t size)
+{
+   uint32_t i;
+   int32_t ret = ciaaDsp_rmsInit(rms, window, size);
+
+   if (0 == ret)
+   {
+      for(i = 0; i < size; i++)
+      {
+         window[i] = 0;
+      }
+      ciaaDsp_stageInit(&rms->stage, ciaaDsp_rmsProcessQ15, CIAADSP_Q15, CIAADSP_Q15);
+   }
+
+   return ret;
+} /* end ciaaDsp_rmsInitQ15 */
+
+extern int32_t ciaaDsp_rmsInitF32(ciaaDsp_rmsType * rms, float * window,
+      uint32_t size)
+{
+   uint32_t i;
+   int32_t ret = ciaaDsp_rmsInit(rms, window, size);
+
+   if (0 == ret)
+   {
+      for(i = 0; i < size; i++)
+      {
+         window[i] = 0.0f;
+      }
+      ciaaDsp_stageInit(&rms->stage, ciaaDsp_rmsProcessF32, CIAADSP_F32, CIAADSP_F32);
+   }
+
+   return ret;
+} /* end ciaaDsp_rmsInitF32 */
+
+extern uint32_t ciaaDsp_sqrtU32(uint32_t value)
+{
+   uint32_t ret = 0;
+   uint32_t bit = 1UL << 30;
+
+   while (bit > value)
+   {
+      bit >>= 2;
+   }
+
+   while (0 != bit)
+   {
+      if (value >= (ret + bit))
+      {
+         value -= ret + bit;
+         ret = (ret >> 1) + bit;
+      }
+      else
+      {
+         ret >>= 1;
+      }
+      bit >>= 2;
+   }
+
+   return ret;
+} /* end ciaaDsp_sqrtU32 */
+
+extern float ciaaDsp_sqrtF32(float value)
+{
+   union {
+      float f;
+      uint32_t u;
+   } guess;
+   uint8_t i;
+
+   if (value > 0.0f)
+   {
+      /* halve the exponent for the first guess, then Newton iterations */
+      guess.f = value;
+      guess.u = (guess.u >> 1) + 0x1FC00000UL;
+      for(i = 0; i < 3; i++)
+      {
+         guess.f = 0.5f * (guess.f + (value / guess.f));
+      }
+   }
+   else
+   {
+      guess.f = 0.0f;
+   }
+
+   return guess.f;
+} /* end ciaaDsp_sqrtF32 */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,301 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief CIAA Streaming signal processing FFT stage
+ **
+ ** Radix 2 decimation in time FFT.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup DSP Streaming signal processing
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDsp_Fft.h"
+#include "ciaaDsp_Internal.h"
+
+/*==================[macros and definitions]=================================*/
+#define CIAADSP_PI            3.14159265358979f
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief sine of an angle in [-pi, pi]
+ **
+ ** Only used to build the twiddle tables, there is no libm on every
+ ** target.
+ **/
+static float ciaaDsp_sin(float x)
+{
+   float x2;
+   float ret;
+
+   /* reduce to [-pi/2, pi/2] where the series converges fast */
+   if (x > (CIAADSP_PI / 2.0f))
+   {
+      x = CIAADSP_PI - x;
+   }
+   else if (x < (-CIAADSP_PI / 2.0f))
+   {
+      x = -CIAADSP_PI - x;
+   }
+
+   x2 = x * x;
+   ret = x * (1.0f - (x2 / 6.0f) * (1.0f - (x2 / 20.0f) * (1.0f - (x2 / 42.0f) *
+         (1.0f - (x2 / 72.0f) * (1.0f - (x2 / 110.0f))))));
+
+   return ret;
+}
+
+/** \brief returns i with its bits lower bits reversed */
+static uint32_t ciaaDsp_reverse(uint32_t i, uint32_t bits)
+{
+   uint32_t ret = 0;
+   uint32_t b;
+
+   for(b = 0; b < bits; b++)
+   {
+      ret = (ret << 1) | (i & 1);
+      i >>= 1;
+   }
+
+   return ret;
+}
+
+static uint32_t ciaaDsp_fftProcessQ15(ciaaDsp_stageType * stage, void * buffer,
+      uint32_t count, uint32_t capacity)
+{
+   ciaaDsp_fftType * fft = (ciaaDsp_fftType *)stage;
+   q15_t * work = (q15_t *)fft->work;
+   q15_t const * twiddles = (q15_t const *)fft->twiddles;
+   q15_t * samples = (q15_t *)buffer;
+   uint32_t frame;
+   uint32_t out = 0;
+   uint32_t half;
+   uint32_t step;
+   uint32_t group;
+   uint32_t k;
+   uint32_t a;
+   uint32_t b;
+   int32_t tr;
+   int32_t ti;
+   int32_t re;
+   int32_t im;
+   int32_t value;
+
+   for(frame = 0; (frame + fft->size) <= count; frame += fft->size)
+   {
+      for(k = 0; k < fft->size; k++)
+      {
+         a = ciaaDsp_reverse(k, fft->bits);
+         work[2 * a] = samples[frame + k];
+         work[(2 * a) + 1] = 0;
+      }
+
+      for(half = 1, step = fft->size / 2; half < fft->size; half <<= 1, step >>= 1)
+      {
+         for(group = 0; group < fft->size; group += 2 * half)
+         {
+            for(k = 0; k < half; k++)
+            {
+               a = 2 * (group + k);
+               b = a + (2 * half);
+               /* t = W^k * x[b], W = exp(-j 2 pi / size) */
+               tr = (((int32_t)work[b] * twiddles[2 * k * step]) +
+                     ((int32_t)work[b + 1] * twiddles[(2 * k * step) + 1])) >> 15;
+               ti = (((int32_t)work[b + 1] * twiddles[2 * k * step]) -
+                     ((int32_t)work[b] * twiddles[(2 * k * step) + 1])) >> 15;
+               re = work[a];
+               im = work[a + 1];
+               work[a] = (q15_t)((re + tr) >> 1);
+               work[a + 1] = (q15_t)((im + ti) >> 1);
+               work[b] = (q15_t)((re - tr) >> 1);
+               work[b + 1] = (q15_t)((im - ti) >> 1);
+            }
+         }
+      }
+
+      /* out < frame + k, the frame was already copied to work */
+      for(k = 0; k < (fft->size / 2); k++)
+      {
+         re = work[2 * k];
+         im = work[(2 * k) + 1];
+         value = (int32_t)ciaaDsp_sqrtU32((uint32_t)(re * re) + (uint32_t)(im * im));
+         samples[out++] = ciaaDsp_satQ15(value);
+      }
+   }
+
+   return out;
+}
+
+static uint32_t ciaaDsp_fftProcessF32(ciaaDsp_stageType * stage, void * buffer,
+      uint32_t count, uint32_t capacity)
+{
+   ciaaDsp_fftType * fft = (ciaaDsp_fftType *)stage;
+   float * work = (float *)fft->work;
+   float const * twiddles = (float const *)fft->twiddles;
+   float * samples = (float *)buffer;
+   float scale = 1.0f / (float)fft->size;
+   uint32_t frame;
+   uint32_t out = 0;
+   uint32_t half;
+   uint32_t step;
+   uint32_t group;
+   uint32_t k;
+   uint32_t a;
+   uint32_t b;
+   float tr;
+   float ti;
+   float re;
+   float im;
+
+   for(frame = 0; (frame + fft->size) <= count; frame += fft->size)
+   {
+      for(k = 0; k < fft->size; k++)
+      {
+         a = ciaaDsp_reverse(k, fft->bits);
+         work[2 * a] = samples[frame + k] * scale;
+         work[(2 * a) + 1] = 0.0f;
+      }
+
+      for(half = 1, step = fft->size / 2; half < fft->size; half <<= 1, step >>= 1)
+      {
+         for(group = 0; group < fft->size; group += 2 * half)
+         {
+            for(k = 0; k < half; k++)
+            {
+               a = 2 * (group + k);
+               b = a + (2 * half);
+               tr = (work[b] * twiddles[2 * k * step]) + (work[b + 1] * twiddles[(2 * k * step) + 1]);
+               ti = (work[b + 1] * twiddles[2 * k * step]) - (work[b] * twiddles[(2 * k * step) + 1]);
+               re = work[a];
+               im = work[a + 1];
+               work[a] = re + tr;
+               work[a + 1] = im + ti;
+               work[b] = re - tr;
+               work[b + 1] = im - ti;
+            }
+         }
+      }
+
+      for(k = 0; k < (fft->size / 2); k++)
+      {
+         re = work[2 * k];
+         im = work[(2 * k) + 1];
+         samples[out++] = ciaaDsp_sqrtF32((re * re) + (im * im));
+      }
+   }
+
+   return out;
+}
+
+static int32_t ciaaDsp_fftInit(ciaaDsp_fftType * fft, uint32_t size,
+      void * work, void * twiddles)
+{
+   int32_t ret = -1;
+
+   if ((size >= 2) && (0 == (size & (size - 1))))
+   {
+      fft->size = size;
+      fft->bits = 0;
+      while ((1UL << fft->bits) < size)
+      {
+         fft->bits++;
+      }
+      fft->work = work;
+      fft->twiddles = twiddles;
+      ret = 0;
+   }
+
+   return ret;
+}
+
+/*==================[external functions definition]==========================*/
+extern int32_t ciaaDsp_fftInitQ15(ciaaDsp_fftType * fft, uint32_t size,
+      q15_t * work, q15_t * twiddles)
+{
+   uint32_t k;
+   float angle;
+   int32_t cosine;
+   int32_t sine;
+   int32_t ret = ciaaDsp_fftInit(fft, size, work, twiddles);
+
+   if (0 == ret)
+   {
+      for(k = 0; k < (size / 2); k++)
+      {
+         angle = (2.0f * CIAADSP_PI * (float)k) / (float)size;
+         cosine = (int32_t)(ciaaDsp_sin((CIAADSP_PI / 2.0f) - angle) * 32768.0f);
+         sine = (int32_t)(ciaaDsp_sin(angle) * 32768.0f);
+         twiddles[2 * k] = ciaaDsp_satQ15(cosine);
+         twiddles[(2 * k) + 1] = ciaaDsp_satQ15(sine);
+      }
+      ciaaDsp_stageInit(&fft->stage, ciaaDsp_fftProcessQ15, CIAADSP_Q15, CIAADSP_Q15);
+   }
+
+   return ret;
+} /* end ciaaDsp_fftInitQ15 */
+
+extern int32_t ciaaDsp_fftInitF32(ciaaDsp_fftType * fft, uint32_t size,
+      float * work, float * twiddles)
+{
+   uint32_t k;
+   float angle;
+   int32_t ret = ciaaDsp_fftInit(fft, size, work, twiddles);
+
+   if (0 == ret)
+   {
+      for(k = 0; k < (size / 2); k++)
+      {
+         angle = (2.0f * CIAADSP_PI * (float)k) / (float)size;
+         twiddles[2 * k] = ciaaDsp_sin((CIAADSP_PI / 2.0f) - angle);
+         twiddles[(2 * k) + 1] = ciaaDsp_sin(angle);
+      }
+      ciaaDsp_stageInit(&fft->stage, ciaaDsp_fftProcessF32, CIAADSP_F32, CIAADSP_F32);
+   }
+
+   return ret;
+} /* end ciaaDsp_fftInitF32 */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
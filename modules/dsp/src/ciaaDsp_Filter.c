@@ -0,0 +1,440 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief CIAA Streaming signal processing filter stages
+ **
+ ** FIR and biquad filters.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup DSP Streaming signal processing
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaDsp_Filter.h"
+#include "ciaaDsp_Internal.h"
+#if defined(__ARM_FEATURE_DSP)
+#include <arm_acle.h>
+#endif
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief accumulates the products of two pairs of q15_t
+ **
+ ** acc + x[0] * y[0] + x[1] * y[1], a single SMLALD on Cortex-M4.
+ **/
+static inline int64_t ciaaDsp_mac2Q15(int64_t acc, q15_t const * x, q15_t const * y)
+{
+#if defined(__ARM_FEATURE_DSP)
+   uint32_t x2;
+   uint32_t y2;
+
+   /* unaligned word loads are allowed for LDR */
+   __builtin_memcpy(&x2, x, sizeof(x2));
+   __builtin_memcpy(&y2, y, sizeof(y2));
+   return __smlald((int16x2_t)x2, (int16x2_t)y2, acc);
+#else
+   return acc + ((int32_t)x[0] * y[0]) + ((int32_t)x[1] * y[1]);
+#endif
+}
+
+/** \brief dot product of Q15 vectors, returns a Q30 sum */
+static int64_t ciaaDsp_dotQ15(q15_t const * x, q15_t const * y, uint32_t count)
+{
+   int64_t acc = 0;
+   uint32_t i;
+
+   for(i = 0; (i + 1) < count; i += 2)
+   {
+      acc = ciaaDsp_mac2Q15(acc, &x[i], &y[i]);
+   }
+   if (i < count)
+   {
+      acc += (int32_t)x[i] * y[i];
+   }
+
+   return acc;
+}
+
+/** \brief dot product of float vectors */
+static float ciaaDsp_dotF32(float const * x, float const * y, uint32_t count)
+{
+   float acc;
+   uint32_t i = 0;
+#if defined(__SSE__)
+   float part[4];
+   __m128 sum = _mm_setzero_ps();
+
+   for(; (i + 3) < count; i += 4)
+   {
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&x[i]), _mm_loadu_ps(&y[i])));
+   }
+   _mm_storeu_ps(part, sum);
+   acc = (part[0] + part[1]) + (part[2] + part[3]);
+#else
+   /* independent accumulators keep the FPU pipeline busy */
+   float acc0 = 0.0f;
+   float acc1 = 0.0f;
+   float acc2 = 0.0f;
+   float acc3 = 0.0f;
+
+   for(; (i + 3) < count; i += 4)
+   {
+      acc0 += x[i] * y[i];
+      acc1 += x[i + 1] * y[i + 1];
+      acc2 += x[i + 2] * y[i + 2];
+      acc3 += x[i + 3] * y[i + 3];
+   }
+   acc = (acc0 + acc1) + (acc2 + acc3);
+#endif
+
+   for(; i < count; i++)
+   {
+      acc += x[i] * y[i];
+   }
+
+   return acc;
+}
+
+static uint32_t ciaaDsp_firProcessQ15(ciaaDsp_stageType * stage, void * buffer,
+      uint32_t count, uint32_t capacity)
+{
+   ciaaDsp_firType * fir = (ciaaDsp_firType *)stage;
+   q15_t const * coeffs = (q15_t const *)fir->coeffs;
+   q15_t * state = (q15_t *)fir->state;
+   q15_t * samples = (q15_t *)buffer;
+   uint32_t history = fir->numTaps - 1;
+   uint32_t in = 0;
+   uint32_t out = 0;
+   uint32_t chunk;
+   uint32_t i;
+   int64_t value;
+
+   while (in < count)
+   {
+      chunk = count - in;
+      if (chunk > fir->blockSize)
+      {
+         chunk = fir->blockSize;
+      }
+
+      for(i = 0; i < chunk; i++)
+      {
+         state[history + i] = samples[in + i];
+      }
+
+      /* out <= in, the outputs never overwrite unread input samples */
+      for(i = 0; i < chunk; i++)
+      {
+         if (0 == fir->phase)
+         {
+            value = ciaaDsp_dotQ15(&state[i], coeffs, fir->numTaps) >> 15;
+            samples[out++] = ciaaDsp_satQ15(value);
+         }
+         if (++fir->phase == fir->decimation)
+         {
+            fir->phase = 0;
+         }
+      }
+
+      for(i = 0; i < history; i++)
+      {
+         state[i] = state[chunk + i];
+      }
+
+      in += chunk;
+   }
+
+   return out;
+}
+
+static uint32_t ciaaDsp_firProcessF32(ciaaDsp_stageType * stage, void * buffer,
+      uint32_t count, uint32_t capacity)
+{
+   ciaaDsp_firType * fir = (ciaaDsp_firType *)stage;
+   float const * coeffs = (float const *)fir->coeffs;
+   float * state = (float *)fir->state;
+   float * samples = (float *)buffer;
+   uint32_t history = fir->numTaps - 1;
+   uint32_t in = 0;
+   uint32_t out = 0;
+   uint32_t chunk;
+   uint32_t i;
+
+   while (in < count)
+   {
+      chunk = count - in;
+      if (chunk > fir->blockSize)
+      {
+         chunk = fir->blockSize;
+      }
+
+      for(i = 0; i < chunk; i++)
+      {
+         state[history + i] = samples[in + i];
+      }
+
+      for(i = 0; i < chunk; i++)
+      {
+         if (0 == fir->phase)
+         {
+            samples[out++] = ciaaDsp_dotF32(&state[i], coeffs, fir->numTaps);
+         }
+         if (++fir->phase == fir->decimation)
+         {
+            fir->phase = 0;
+         }
+      }
+
+      for(i = 0; i < history; i++)
+      {
+         state[i] = state[chunk + i];
+      }
+
+      in += chunk;
+   }
+
+   return out;
+}
+
+static uint32_t ciaaDsp_biquadProcessQ31(ciaaDsp_stageType * stage, void * buffer,
+      uint32_t count, uint32_t capacity)
+{
+   ciaaDsp_biquadType * biquad = (ciaaDsp_biquadType *)stage;
+   q31_t const * coeffs = (q31_t const *)biquad->coeffs;
+   q31_t * state = (q31_t *)biquad->state;
+   q31_t * samples = (q31_t *)buffer;
+   uint32_t shift = 31 - biquad->postShift;
+   uint32_t section;
+   uint32_t i;
+   int64_t acc;
+   q31_t x1;
+   q31_t x2;
+   q31_t y1;
+   q31_t y2;
+
+   /* one section over the whole block keeps its state in registers */
+   for(section = 0; section < biquad->sections; section++)
+   {
+      x1 = state[0];
+      x2 = state[1];
+      y1 = state[2];
+      y2 = state[3];
+
+      for(i = 0; i < count; i++)
+      {
+         acc = (int64_t)coeffs[0] * samples[i];
+         acc += (int64_t)coeffs[1] * x1;
+         acc += (int64_t)coeffs[2] * x2;
+         acc += (int64_t)coeffs[3] * y1;
+         acc += (int64_t)coeffs[4] * y2;
+
+         x2 = x1;
+         x1 = samples[i];
+         y2 = y1;
+         acc >>= shift;
+         y1 = ciaaDsp_satQ31(acc);
+         samples[i] = y1;
+      }
+
+      state[0] = x1;
+      state[1] = x2;
+      state[2] = y1;
+      state[3] = y2;
+
+      coeffs += 5;
+      state += 4;
+   }
+
+   return count;
+}
+
+static uint32_t ciaaDsp_biquadProcessF32(ciaaDsp_stageType * stage, void * buffer,
+      uint32_t count, uint32_t capacity)
+{
+   ciaaDsp_biquadType * biquad = (ciaaDsp_biquadType *)stage;
+   float const * coeffs = (float const *)biquad->coeffs;
+   float * state = (float *)biquad->state;
+   float * samples = (float *)buffer;
+   uint32_t section;
+   uint32_t i;
+   float x;
+   float y;
+   float d1;
+   float d2;
+
+   /* transposed direct form II, only 2 of the 4 state samples are used */
+   for(section = 0; section < biquad->sections; section++)
+   {
+      d1 = state[0];
+      d2 = state[1];
+
+      for(i = 0; i < count; i++)
+      {
+         x = samples[i];
+         y = (coeffs[0] * x) + d1;
+         d1 = (coeffs[1] * x) + (coeffs[3] * y) + d2;
+         d2 = (coeffs[2] * x) + (coeffs[4] * y);
+         samples[i] = y;
+      }
+
+      state[0] = d1;
+      state[1] = d2;
+
+      coeffs += 5;
+      state += 4;
+   }
+
+   return count;
+}
+
+static int32_t ciaaDsp_firInit(ciaaDsp_firType * fir, void const * coeffs,
+      uint32_t numTaps, void * state, uint32_t blockSize, uint32_t decimation)
+{
+   int32_t ret = -1;
+
+   if ((0 != numTaps) && (0 != blockSize) && (0 != decimation))
+   {
+      fir->coeffs = coeffs;
+      fir->state = state;
+      fir->numTaps = numTaps;
+      fir->blockSize = blockSize;
+      fir->decimation = decimation;
+      fir->phase = 0;
+      ret = 0;
+   }
+
+   return ret;
+}
+
+/*==================[external functions definition]==========================*/
+extern int32_t ciaaDsp_firInitQ15(ciaaDsp_firType * fir, q15_t const * coeffs,
+      uint32_t numTaps, q15_t * state, uint32_t blockSize, uint32_t decimation)
+{
+   uint32_t i;
+   int32_t ret = ciaaDsp_firInit(fir, coeffs, numTaps, state, blockSize, decimation);
+
+   if (0 == ret)
+   {
+      for(i = 0; i < CIAADSP_FIR_STATE_SIZE(numTaps, blockSize); i++)
+      {
+         state[i] = 0;
+      }
+      ciaaDsp_stageInit(&fir->stage, ciaaDsp_firProcessQ15, CIAADSP_Q15, CIAADSP_Q15);
+   }
+
+   return ret;
+} /* end ciaaDsp_firInitQ15 */
+
+extern int32_t ciaaDsp_firInitF32(ciaaDsp_firType * fir, float const * coeffs,
+      uint32_t numTaps, float * state, uint32_t blockSize, uint32_t decimation)
+{
+   uint32_t i;
+   int32_t ret = ciaaDsp_firInit(fir, coeffs, numTaps, state, blockSize, decimation);
+
+   if (0 == ret)
+   {
+      for(i = 0; i < CIAADSP_FIR_STATE_SIZE(numTaps, blockSize); i++)
+      {
+         state[i] = 0.0f;
+      }
+      ciaaDsp_stageInit(&fir->stage, ciaaDsp_firProcessF32, CIAADSP_F32, CIAADSP_F32);
+   }
+
+   return ret;
+} /* end ciaaDsp_firInitF32 */
+
+extern int32_t ciaaDsp_biquadInitQ31(ciaaDsp_biquadType * biquad, q31_t const * coeffs,
+      q31_t * state, uint32_t sections, uint32_t postShift)
+{
+   uint32_t i;
+   int32_t ret = -1;
+
+   if ((0 != sections) && (postShift <= 30))
+   {
+      biquad->coeffs = coeffs;
+      biquad->state = state;
+      biquad->sections = sections;
+      biquad->postShift = postShift;
+      for(i = 0; i < CIAADSP_BIQUAD_STATE_SIZE(sections); i++)
+      {
+         state[i] = 0;
+      }
+      ciaaDsp_stageInit(&biquad->stage, ciaaDsp_biquadProcessQ31, CIAADSP_Q31, CIAADSP_Q31);
+      ret = 0;
+   }
+
+   return ret;
+} /* end ciaaDsp_biquadInitQ31 */
+
+extern int32_t ciaaDsp_biquadInitF32(ciaaDsp_biquadType * biquad, float const * coeffs,
+      float * state, uint32_t sections)
+{
+   uint32_t i;
+   int32_t ret = -1;
+
+   if (0 != sections)
+   {
+      biquad->coeffs = coeffs;
+      biquad->state = state;
+      biquad->sections = sections;
+      biquad->postShift = 0;
+      for(i = 0; i < CIAADSP_BIQUAD_STATE_SIZE(sections); i++)
+      {
+         state[i] = 0.0f;
+      }
+      ciaaDsp_stageInit(&biquad->stage, ciaaDsp_biquadProcessF32, CIAADSP_F32, CIAADSP_F32);
+      ret = 0;
+   }
+
+   return ret;
+} /* end ciaaDsp_biquadInitF32 */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,324 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the DSP pipeline
+ **
+ ** Pipeline, format conversions, moving RMS and the feeding from analog
+ ** inputs. The last test measures the cycles per sample of the stages.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup DSP Streaming signal processing
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDsp.h"
+#include "stdio.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief samples of the blocks of the tests */
+#define BLOCK_SIZE            64
+
+/** \brief blocks processed by the benchmark */
+#define BENCH_BLOCKS          10000
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief block buffer, big enough for BLOCK_SIZE float samples */
+static union {
+   q15_t q15[2 * BLOCK_SIZE];
+   q31_t q31[BLOCK_SIZE];
+   float f32[BLOCK_SIZE];
+} buffer;
+
+static ciaaDsp_pipelineType pipeline;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief stage keeping one of each 2 samples */
+static uint32_t halveProcess(ciaaDsp_stageType * stage, void * buffer,
+      uint32_t count, uint32_t capacity)
+{
+   q15_t * samples = (q15_t *)buffer;
+   uint32_t i;
+
+   for(i = 0; i < (count / 2); i++)
+   {
+      samples[i] = samples[2 * i];
+   }
+
+   return count / 2;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   ciaaDsp_pipelineInit(&pipeline, CIAADSP_Q15, sizeof(buffer));
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test the chaining of stages and their statistics */
+void test_ciaaDsp_pipeline(void) {
+   ciaaDsp_stageType halve1;
+   ciaaDsp_stageType halve2;
+   ciaaDsp_convertType convert;
+   uint32_t i;
+
+   ciaaDsp_stageInit(&halve1, halveProcess, CIAADSP_Q15, CIAADSP_Q15);
+   ciaaDsp_stageInit(&halve2, halveProcess, CIAADSP_Q15, CIAADSP_Q15);
+   ciaaDsp_convertInit(&convert, CIAADSP_F32, CIAADSP_Q15);
+
+   TEST_ASSERT_EQUAL_INT(CIAADSP_Q15, ciaaDsp_pipelineFormat(&pipeline));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDsp_pipelineAdd(&pipeline, &convert.stage));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_pipelineAdd(&pipeline, &halve1));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_pipelineAdd(&pipeline, &halve2));
+
+   for(i = 0; i < 16; i++)
+   {
+      buffer.q15[i] = (q15_t)i;
+   }
+   TEST_ASSERT_EQUAL_UINT32(4, ciaaDsp_pipelineProcess(&pipeline, &buffer, 16));
+   for(i = 0; i < 4; i++)
+   {
+      TEST_ASSERT_EQUAL_INT16(4 * i, buffer.q15[i]);
+   }
+
+   TEST_ASSERT_EQUAL_UINT32(1, halve1.blocks);
+   TEST_ASSERT_EQUAL_UINT32(16, halve1.samples);
+   TEST_ASSERT_EQUAL_UINT32(8, halve2.samples);
+   TEST_ASSERT_TRUE(halve1.maxCycles >= halve1.cycles);
+
+   /* a block bigger than the buffer is not processed */
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDsp_pipelineProcess(&pipeline, &buffer, 2 * BLOCK_SIZE + 1));
+   TEST_ASSERT_EQUAL_UINT32(1, halve1.blocks);
+
+   ciaaDsp_pipelineResetStats(&pipeline);
+   TEST_ASSERT_EQUAL_UINT32(0, halve1.blocks);
+   TEST_ASSERT_EQUAL_UINT32(0, halve2.samples);
+}
+
+/** \brief test the in place conversions of the sample format */
+void test_ciaaDsp_convert(void) {
+   ciaaDsp_convertType toF32;
+   ciaaDsp_convertType toQ31;
+   ciaaDsp_convertType toQ15;
+   q15_t const input[4] = { 0, 16384, -16384, -32768 };
+   uint32_t i;
+
+   ciaaDsp_convertInit(&toF32, CIAADSP_Q15, CIAADSP_F32);
+   ciaaDsp_convertInit(&toQ31, CIAADSP_F32, CIAADSP_Q31);
+   ciaaDsp_convertInit(&toQ15, CIAADSP_Q31, CIAADSP_Q15);
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_pipelineAdd(&pipeline, &toF32.stage));
+   TEST_ASSERT_EQUAL_INT(CIAADSP_F32, ciaaDsp_pipelineFormat(&pipeline));
+
+   for(i = 0; i < 4; i++)
+   {
+      buffer.q15[i] = input[i];
+   }
+   TEST_ASSERT_EQUAL_UINT32(4, ciaaDsp_pipelineProcess(&pipeline, &buffer, 4));
+   TEST_ASSERT_EQUAL_FLOAT(0.0f, buffer.f32[0]);
+   TEST_ASSERT_EQUAL_FLOAT(0.5f, buffer.f32[1]);
+   TEST_ASSERT_EQUAL_FLOAT(-0.5f, buffer.f32[2]);
+   TEST_ASSERT_EQUAL_FLOAT(-1.0f, buffer.f32[3]);
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_pipelineAdd(&pipeline, &toQ31.stage));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_pipelineAdd(&pipeline, &toQ15.stage));
+   for(i = 0; i < 4; i++)
+   {
+      buffer.q15[i] = input[i];
+   }
+   TEST_ASSERT_EQUAL_UINT32(4, ciaaDsp_pipelineProcess(&pipeline, &buffer, 4));
+   TEST_ASSERT_EQUAL_INT16_ARRAY(input, buffer.q15, 4);
+
+   /* float samples out of range saturate */
+   ciaaDsp_pipelineInit(&pipeline, CIAADSP_F32, sizeof(buffer));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_pipelineAdd(&pipeline, &toQ31.stage));
+   buffer.f32[0] = 2.0f;
+   buffer.f32[1] = -2.0f;
+   TEST_ASSERT_EQUAL_UINT32(2, ciaaDsp_pipelineProcess(&pipeline, &buffer, 2));
+   TEST_ASSERT_EQUAL_INT32(INT32_MAX, buffer.q31[0]);
+   TEST_ASSERT_EQUAL_INT32(INT32_MIN, buffer.q31[1]);
+
+   /* the float samples of a full Q15 block do not fit */
+   ciaaDsp_pipelineInit(&pipeline, CIAADSP_Q15, sizeof(buffer));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_pipelineAdd(&pipeline, &toF32.stage));
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDsp_pipelineProcess(&pipeline, &buffer, 2 * BLOCK_SIZE));
+}
+
+/** \brief test the moving RMS */
+void test_ciaaDsp_rms(void) {
+   ciaaDsp_rmsType rms;
+   q15_t windowQ15[8];
+   float windowF32[8];
+   uint32_t i;
+
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDsp_rmsInitQ15(&rms, windowQ15, 6));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_rmsInitQ15(&rms, windowQ15, 8));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_pipelineAdd(&pipeline, &rms.stage));
+
+   /* square wave of amplitude 0.5 */
+   for(i = 0; i < 16; i++)
+   {
+      buffer.q15[i] = (i & 1) ? -16384 : 16384;
+   }
+   TEST_ASSERT_EQUAL_UINT32(16, ciaaDsp_pipelineProcess(&pipeline, &buffer, 16));
+   /* 4 of 8 samples of the window: sqrt(0.5) * 0.5 */
+   TEST_ASSERT_INT_WITHIN(1, 11585, buffer.q15[3]);
+   for(i = 7; i < 16; i++)
+   {
+      TEST_ASSERT_EQUAL_INT16(16384, buffer.q15[i]);
+   }
+
+   ciaaDsp_pipelineInit(&pipeline, CIAADSP_F32, sizeof(buffer));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_rmsInitF32(&rms, windowF32, 8));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_pipelineAdd(&pipeline, &rms.stage));
+   for(i = 0; i < 16; i++)
+   {
+      buffer.f32[i] = (i & 1) ? -0.25f : 0.25f;
+   }
+   TEST_ASSERT_EQUAL_UINT32(16, ciaaDsp_pipelineProcess(&pipeline, &buffer, 16));
+   for(i = 7; i < 16; i++)
+   {
+      TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.25f, buffer.f32[i]);
+   }
+}
+
+/** \brief test the feeding of samples of the analog inputs */
+void test_ciaaDsp_feed(void) {
+   uint32_t const samples[6] = {
+      (0 << 16) | 512, (1 << 16) | 0, (0 << 16) | 1023,
+      (1 << 16) | 1, (0 << 16) | 0, (1 << 16) | 2,
+   };
+   uint16_t const adc[3] = { 512, 1023, 0 };
+   ciaaPOSIX_aioBlockType block;
+
+   block.samples = samples;
+   block.count = 6;
+   block.timestamp = 0;
+   block.overruns = 0;
+
+   TEST_ASSERT_EQUAL_UINT32(3, ciaaDsp_pipelineFeedAio(&pipeline, &buffer, &block, 0));
+   TEST_ASSERT_EQUAL_INT16(0, buffer.q15[0]);
+   TEST_ASSERT_EQUAL_INT16(511 << 6, buffer.q15[1]);
+   TEST_ASSERT_EQUAL_INT16(-32768, buffer.q15[2]);
+
+   ciaaDsp_pipelineInit(&pipeline, CIAADSP_Q31, sizeof(buffer));
+   TEST_ASSERT_EQUAL_UINT32(3, ciaaDsp_pipelineFeedAio(&pipeline, &buffer, &block, 1));
+   TEST_ASSERT_EQUAL_INT32(INT32_MIN, buffer.q31[0]);
+   TEST_ASSERT_EQUAL_INT32(-511 << 22, buffer.q31[1]);
+   TEST_ASSERT_EQUAL_INT32(-510 << 22, buffer.q31[2]);
+
+   ciaaDsp_pipelineInit(&pipeline, CIAADSP_F32, sizeof(buffer));
+   TEST_ASSERT_EQUAL_UINT32(3, ciaaDsp_pipelineFeedAdc(&pipeline, &buffer, adc, 3));
+   TEST_ASSERT_EQUAL_FLOAT(0.0f, buffer.f32[0]);
+   TEST_ASSERT_EQUAL_FLOAT(511.0f / 512.0f, buffer.f32[1]);
+   TEST_ASSERT_EQUAL_FLOAT(-1.0f, buffer.f32[2]);
+
+   /* not more than the capacity */
+   ciaaDsp_pipelineInit(&pipeline, CIAADSP_F32, 2 * sizeof(float));
+   TEST_ASSERT_EQUAL_UINT32(2, ciaaDsp_pipelineFeedAdc(&pipeline, &buffer, adc, 3));
+}
+
+/** \brief test the square roots */
+void test_ciaaDsp_sqrt(void) {
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaDsp_sqrtU32(0));
+   TEST_ASSERT_EQUAL_UINT32(3, ciaaDsp_sqrtU32(15));
+   TEST_ASSERT_EQUAL_UINT32(4, ciaaDsp_sqrtU32(16));
+   TEST_ASSERT_EQUAL_UINT32(65535, ciaaDsp_sqrtU32(UINT32_MAX));
+   TEST_ASSERT_EQUAL_FLOAT(0.0f, ciaaDsp_sqrtF32(-1.0f));
+   TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5f, ciaaDsp_sqrtF32(0.25f));
+   TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1000.0f, ciaaDsp_sqrtF32(1e6f));
+}
+
+/** \brief measure the cycles per sample of the stages of a pipeline */
+void test_ciaaDsp_benchmark(void) {
+   ciaaDsp_rmsType rms;
+   ciaaDsp_convertType toF32;
+   ciaaDsp_convertType toQ15;
+   q15_t window[32];
+   uint16_t adc[BLOCK_SIZE];
+   char const * const names[] = { "rms Q15", "Q15 to F32", "F32 to Q15" };
+   ciaaDsp_stageType * stage;
+   uint32_t i;
+
+   for(i = 0; i < BLOCK_SIZE; i++)
+   {
+      adc[i] = (uint16_t)((i * 37) & 0x3FF);
+   }
+
+   ciaaDsp_pipelineInit(&pipeline, CIAADSP_Q15, BLOCK_SIZE * sizeof(float));
+   ciaaDsp_rmsInitQ15(&rms, window, 32);
+   ciaaDsp_convertInit(&toF32, CIAADSP_Q15, CIAADSP_F32);
+   ciaaDsp_convertInit(&toQ15, CIAADSP_F32, CIAADSP_Q15);
+   ciaaDsp_pipelineAdd(&pipeline, &rms.stage);
+   ciaaDsp_pipelineAdd(&pipeline, &toF32.stage);
+   ciaaDsp_pipelineAdd(&pipeline, &toQ15.stage);
+
+   for(i = 0; i < BENCH_BLOCKS; i++)
+   {
+      TEST_ASSERT_EQUAL_UINT32(BLOCK_SIZE, ciaaDsp_pipelineFeedAdc(&pipeline, &buffer, adc, BLOCK_SIZE));
+   }
+
+   for(stage = pipeline.first, i = 0; NULL != stage; stage = stage->next, i++)
+   {
+      TEST_ASSERT_EQUAL_UINT32(BENCH_BLOCKS, stage->blocks);
+      printf("ciaaDsp %-10s: %6.2f cycles per sample, %u cycles max per block\n",
+            names[i], (double)stage->totalCycles / stage->samples, stage->maxCycles);
+   }
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
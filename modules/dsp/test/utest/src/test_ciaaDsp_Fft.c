@@ -0,0 +1,238 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the DSP FFT stage
+ **
+ ** The magnitudes of tones are checked at their bins. The last test
+ ** measures the cycles per sample of the stages.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup DSP Streaming signal processing
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDsp_Fft.h"
+#include "mock_ciaaDsp.h"
+#include "math.h"
+#include "stdio.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief points of the FFTs of the tests */
+#define FFT_SIZE              64
+
+/** \brief frames processed by the benchmark */
+#define BENCH_FRAMES          10000
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static ciaaDsp_fftType fft;
+
+static union {
+   q15_t q15[CIAADSP_FFT_WORK_SIZE(FFT_SIZE)];
+   float f32[CIAADSP_FFT_WORK_SIZE(FFT_SIZE)];
+} work;
+
+static union {
+   q15_t q15[CIAADSP_FFT_TWIDDLES_SIZE(FFT_SIZE)];
+   float f32[CIAADSP_FFT_TWIDDLES_SIZE(FFT_SIZE)];
+} twiddles;
+
+/** \brief 2 frames and some samples */
+static union {
+   q15_t q15[2 * FFT_SIZE + 8];
+   float f32[2 * FFT_SIZE + 8];
+} samples;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void stageInit(ciaaDsp_stageType * stage, ciaaDsp_processType process,
+      ciaaDsp_formatType inFormat, ciaaDsp_formatType outFormat, int calls)
+{
+   (void)calls;
+
+   stage->process = process;
+   stage->inFormat = inFormat;
+   stage->outFormat = outFormat;
+   stage->next = NULL;
+}
+
+static uint32_t sqrtU32(uint32_t value, int calls)
+{
+   (void)calls;
+
+   return (uint32_t)sqrt((double)value);
+}
+
+static float sqrtF32(float value, int calls)
+{
+   (void)calls;
+
+   return sqrtf(value);
+}
+
+/** \brief processes samples through the stage */
+static uint32_t process(void * buffer, uint32_t count)
+{
+   return fft.stage.process(&fft.stage, buffer, count, sizeof(samples));
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   ciaaDsp_stageInit_StubWithCallback(stageInit);
+   ciaaDsp_sqrtU32_StubWithCallback(sqrtU32);
+   ciaaDsp_sqrtF32_StubWithCallback(sqrtF32);
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test the sizes accepted */
+void test_ciaaDsp_fftInit(void) {
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDsp_fftInitF32(&fft, 1, work.f32, twiddles.f32));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDsp_fftInitF32(&fft, 48, work.f32, twiddles.f32));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_fftInitF32(&fft, 2, work.f32, twiddles.f32));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_fftInitQ15(&fft, FFT_SIZE, work.q15, twiddles.q15));
+   TEST_ASSERT_EQUAL_UINT32(6, fft.bits);
+
+   /* cos(2 pi k / N), sin(2 pi k / N) */
+   TEST_ASSERT_EQUAL_INT16(32767, twiddles.q15[0]);
+   TEST_ASSERT_EQUAL_INT16(0, twiddles.q15[1]);
+   TEST_ASSERT_INT_WITHIN(1, 0, twiddles.q15[2 * (FFT_SIZE / 4)]);
+   TEST_ASSERT_EQUAL_INT16(32767, twiddles.q15[(2 * (FFT_SIZE / 4)) + 1]);
+}
+
+/** \brief test the magnitudes of a float tone and a DC level */
+void test_ciaaDsp_fftF32(void) {
+   uint32_t i;
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_fftInitF32(&fft, FFT_SIZE, work.f32, twiddles.f32));
+
+   for(i = 0; i < FFT_SIZE; i++)
+   {
+      samples.f32[i] = sinf((2.0f * 3.14159265f * 5.0f * i) / FFT_SIZE);
+      samples.f32[FFT_SIZE + i] = 0.25f;
+   }
+
+   /* the samples after the last frame are discarded */
+   TEST_ASSERT_EQUAL_UINT32(FFT_SIZE, process(&samples, 2 * FFT_SIZE + 8));
+
+   for(i = 0; i < (FFT_SIZE / 2); i++)
+   {
+      TEST_ASSERT_FLOAT_WITHIN(1e-4f, (5 == i) ? 0.5f : 0.0f, samples.f32[i]);
+      TEST_ASSERT_FLOAT_WITHIN(1e-4f, (0 == i) ? 0.25f : 0.0f, samples.f32[(FFT_SIZE / 2) + i]);
+   }
+}
+
+/** \brief test the magnitudes of a Q15 tone */
+void test_ciaaDsp_fftQ15(void) {
+   uint32_t i;
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_fftInitQ15(&fft, FFT_SIZE, work.q15, twiddles.q15));
+
+   for(i = 0; i < FFT_SIZE; i++)
+   {
+      samples.q15[i] = (q15_t)(16384.0f * cosf((2.0f * 3.14159265f * 3.0f * i) / FFT_SIZE));
+   }
+
+   TEST_ASSERT_EQUAL_UINT32(FFT_SIZE / 2, process(&samples, FFT_SIZE));
+
+   /* 0.25 at the bin of the tone, the scaling costs log2(N) bits */
+   for(i = 0; i < (FFT_SIZE / 2); i++)
+   {
+      TEST_ASSERT_INT_WITHIN(16, (3 == i) ? 8192 : 0, samples.q15[i]);
+   }
+}
+
+/** \brief measure the cycles per sample of the FFT stages */
+void test_ciaaDsp_Fft_benchmark(void) {
+   uint64_t cycles;
+   uint32_t start;
+   uint32_t frame;
+   uint32_t i;
+
+   ciaaDsp_fftInitQ15(&fft, FFT_SIZE, work.q15, twiddles.q15);
+   cycles = 0;
+   for(frame = 0; frame < BENCH_FRAMES; frame++)
+   {
+      for(i = 0; i < FFT_SIZE; i++)
+      {
+         samples.q15[i] = (q15_t)((i * 1237) + frame);
+      }
+      start = ciaaLibs_cyclesGet();
+      TEST_ASSERT_EQUAL_UINT32(FFT_SIZE / 2, process(&samples, FFT_SIZE));
+      cycles += ciaaLibs_cyclesGet() - start;
+   }
+   printf("ciaaDsp fft Q15 %u: %6.2f cycles per sample\n", FFT_SIZE,
+         (double)cycles / (BENCH_FRAMES * FFT_SIZE));
+
+   ciaaDsp_fftInitF32(&fft, FFT_SIZE, work.f32, twiddles.f32);
+   cycles = 0;
+   for(frame = 0; frame < BENCH_FRAMES; frame++)
+   {
+      for(i = 0; i < FFT_SIZE; i++)
+      {
+         samples.f32[i] = (float)((i * 1237) & 0xFF) / 256.0f;
+      }
+      start = ciaaLibs_cyclesGet();
+      TEST_ASSERT_EQUAL_UINT32(FFT_SIZE / 2, process(&samples, FFT_SIZE));
+      cycles += ciaaLibs_cyclesGet() - start;
+   }
+   printf("ciaaDsp fft F32 %u: %6.2f cycles per sample\n", FFT_SIZE,
+         (double)cycles / (BENCH_FRAMES * FFT_SIZE));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,363 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the DSP filter stages
+ **
+ ** The stages are processed directly, without pipeline. The outputs are
+ ** compared with direct implementations of the filters. The last test
+ ** measures the cycles per sample of the stages.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup DSP Streaming signal processing
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaDsp_Filter.h"
+#include "mock_ciaaDsp.h"
+#include "stdio.h"
+#include "stdlib.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief samples of the blocks of the tests */
+#define BLOCK_SIZE            64
+
+/** \brief blocks processed by the benchmark */
+#define BENCH_BLOCKS          10000
+
+/** \brief taps of the filters of the benchmark */
+#define BENCH_TAPS            32
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static ciaaDsp_firType fir;
+
+static ciaaDsp_biquadType biquad;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void stageInit(ciaaDsp_stageType * stage, ciaaDsp_processType process,
+      ciaaDsp_formatType inFormat, ciaaDsp_formatType outFormat, int calls)
+{
+   (void)calls;
+
+   stage->process = process;
+   stage->inFormat = inFormat;
+   stage->outFormat = outFormat;
+   stage->next = NULL;
+}
+
+/** \brief processes samples through a stage */
+static uint32_t process(ciaaDsp_stageType * stage, void * samples, uint32_t count)
+{
+   return stage->process(stage, samples, count, BLOCK_SIZE * sizeof(float));
+}
+
+/** \brief returns a random sample in [-0.5, 0.5) */
+static float randomF32(void)
+{
+   return ((float)(rand() & 0xFFFF) / 65536.0f) - 0.5f;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   ciaaDsp_stageInit_StubWithCallback(stageInit);
+   srand(1);
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test the impulse response of a Q15 FIR across blocks */
+void test_ciaaDsp_firQ15(void) {
+   /* h = {0.5, 0.25, 0.125} time reversed */
+   q15_t const coeffs[3] = { 4096, 8192, 16384 };
+   q15_t const expected[6] = { 8192, 4096, 2048, 0, 16383, 8191 };
+   q15_t state[CIAADSP_FIR_STATE_SIZE(3, 4)];
+   q15_t samples[6] = { 16384, 0, 0, 0, 32767, 0 };
+
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDsp_firInitQ15(&fir, coeffs, 0, state, 4, 1));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_firInitQ15(&fir, coeffs, 3, state, 4, 1));
+   TEST_ASSERT_EQUAL_INT(CIAADSP_Q15, fir.stage.inFormat);
+
+   /* two chunks in the first block, the history is kept for the second */
+   TEST_ASSERT_EQUAL_UINT32(5, process(&fir.stage, samples, 5));
+   TEST_ASSERT_EQUAL_UINT32(1, process(&fir.stage, &samples[5], 1));
+   TEST_ASSERT_EQUAL_INT16_ARRAY(expected, samples, 6);
+}
+
+/** \brief test the phase of the decimation across blocks */
+void test_ciaaDsp_firDecimation(void) {
+   /* mean of 2 samples */
+   q15_t const coeffs[2] = { 16384, 16384 };
+   q15_t state[CIAADSP_FIR_STATE_SIZE(2, 8)];
+   q15_t samples[8];
+   uint32_t i;
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_firInitQ15(&fir, coeffs, 2, state, 8, 2));
+
+   for(i = 0; i < 8; i++)
+   {
+      samples[i] = (q15_t)(100 * (i + 1));
+   }
+   /* outputs 0, 2, 4 of the 5 first samples, then 6 of the 3 next */
+   TEST_ASSERT_EQUAL_UINT32(3, process(&fir.stage, samples, 5));
+   TEST_ASSERT_EQUAL_INT16(50, samples[0]);
+   TEST_ASSERT_EQUAL_INT16(250, samples[1]);
+   TEST_ASSERT_EQUAL_INT16(450, samples[2]);
+   samples[0] = 600;
+   samples[1] = 700;
+   samples[2] = 800;
+   TEST_ASSERT_EQUAL_UINT32(1, process(&fir.stage, samples, 3));
+   TEST_ASSERT_EQUAL_INT16(650, samples[0]);
+}
+
+/** \brief test a float FIR against the direct convolution */
+void test_ciaaDsp_firF32(void) {
+   float coeffs[13];
+   float state[CIAADSP_FIR_STATE_SIZE(13, 16)];
+   float input[3 * BLOCK_SIZE];
+   float samples[BLOCK_SIZE];
+   float expected;
+   uint32_t block;
+   uint32_t i;
+   uint32_t k;
+
+   for(k = 0; k < 13; k++)
+   {
+      coeffs[k] = randomF32();
+   }
+   for(i = 0; i < (3 * BLOCK_SIZE); i++)
+   {
+      input[i] = randomF32();
+   }
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_firInitF32(&fir, coeffs, 13, state, 16, 1));
+
+   for(block = 0; block < 3; block++)
+   {
+      for(i = 0; i < BLOCK_SIZE; i++)
+      {
+         samples[i] = input[(block * BLOCK_SIZE) + i];
+      }
+      TEST_ASSERT_EQUAL_UINT32(BLOCK_SIZE, process(&fir.stage, samples, BLOCK_SIZE));
+
+      for(i = 0; i < BLOCK_SIZE; i++)
+      {
+         expected = 0.0f;
+         for(k = 0; (k < 13) && (k <= ((block * BLOCK_SIZE) + i)); k++)
+         {
+            expected += coeffs[12 - k] * input[(block * BLOCK_SIZE) + i - k];
+         }
+         TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected, samples[i]);
+      }
+   }
+}
+
+/** \brief test the impulse response of a Q31 biquad */
+void test_ciaaDsp_biquadQ31(void) {
+   /* y[n] = 0.5 x[n] + 0.5 y[n-1] */
+   q31_t const coeffs[5] = { 0x40000000, 0, 0, 0x40000000, 0 };
+   /* y[n] = x[n] - 0.5 y[n-1], coefficients scaled by 1/2 */
+   q31_t const scaled[5] = { 0x40000000, 0, 0, -0x20000000, 0 };
+   q31_t state[CIAADSP_BIQUAD_STATE_SIZE(1)];
+   q31_t samples[4] = { 0x40000000, 0, 0, 0 };
+
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDsp_biquadInitQ31(&biquad, coeffs, state, 1, 31));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_biquadInitQ31(&biquad, coeffs, state, 1, 0));
+   TEST_ASSERT_EQUAL_UINT32(2, process(&biquad.stage, samples, 2));
+   TEST_ASSERT_EQUAL_UINT32(2, process(&biquad.stage, &samples[2], 2));
+   TEST_ASSERT_EQUAL_HEX32(0x20000000, samples[0]);
+   TEST_ASSERT_EQUAL_HEX32(0x10000000, samples[1]);
+   TEST_ASSERT_EQUAL_HEX32(0x08000000, samples[2]);
+   TEST_ASSERT_EQUAL_HEX32(0x04000000, samples[3]);
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_biquadInitQ31(&biquad, scaled, state, 1, 1));
+   samples[0] = 0x40000000;
+   samples[1] = 0;
+   samples[2] = 0;
+   TEST_ASSERT_EQUAL_UINT32(3, process(&biquad.stage, samples, 3));
+   TEST_ASSERT_EQUAL_HEX32(0x40000000, samples[0]);
+   TEST_ASSERT_EQUAL_HEX32(-0x20000000, samples[1]);
+   TEST_ASSERT_EQUAL_HEX32(0x10000000, samples[2]);
+}
+
+/** \brief test a float biquad cascade against direct form I */
+void test_ciaaDsp_biquadF32(void) {
+   /* two low pass sections */
+   float const coeffs[10] = {
+      0.2f, 0.4f, 0.2f, 0.6f, -0.2f,
+      0.1f, 0.2f, 0.1f, 0.9f, -0.3f,
+   };
+   float state[CIAADSP_BIQUAD_STATE_SIZE(2)];
+   float input[BLOCK_SIZE];
+   float samples[BLOCK_SIZE];
+   float reference[BLOCK_SIZE];
+   float const * c;
+   float x1;
+   float x2;
+   float y1;
+   float y2;
+   float y;
+   uint32_t section;
+   uint32_t i;
+
+   for(i = 0; i < BLOCK_SIZE; i++)
+   {
+      input[i] = randomF32();
+      samples[i] = input[i];
+      reference[i] = input[i];
+   }
+
+   TEST_ASSERT_EQUAL_INT(-1, ciaaDsp_biquadInitF32(&biquad, coeffs, state, 0));
+   TEST_ASSERT_EQUAL_INT(0, ciaaDsp_biquadInitF32(&biquad, coeffs, state, 2));
+   TEST_ASSERT_EQUAL_UINT32(BLOCK_SIZE / 2, process(&biquad.stage, samples, BLOCK_SIZE / 2));
+   TEST_ASSERT_EQUAL_UINT32(BLOCK_SIZE / 2, process(&biquad.stage, &samples[BLOCK_SIZE / 2], BLOCK_SIZE / 2));
+
+   for(section = 0; section < 2; section++)
+   {
+      c = &coeffs[5 * section];
+      x1 = x2 = y1 = y2 = 0.0f;
+      for(i = 0; i < BLOCK_SIZE; i++)
+      {
+         y = (c[0] * reference[i]) + (c[1] * x1) + (c[2] * x2) + (c[3] * y1) + (c[4] * y2);
+         x2 = x1;
+         x1 = reference[i];
+         y2 = y1;
+         y1 = y;
+         reference[i] = y;
+      }
+   }
+
+   for(i = 0; i < BLOCK_SIZE; i++)
+   {
+      TEST_ASSERT_FLOAT_WITHIN(1e-5f, reference[i], samples[i]);
+   }
+}
+
+/** \brief measure the cycles per sample of the filter stages */
+void test_ciaaDsp_Filter_benchmark(void) {
+   static q15_t coeffsQ15[BENCH_TAPS];
+   static float coeffsF32[BENCH_TAPS];
+   static q15_t stateQ15[CIAADSP_FIR_STATE_SIZE(BENCH_TAPS, BLOCK_SIZE)];
+   static float stateF32[CIAADSP_FIR_STATE_SIZE(BENCH_TAPS, BLOCK_SIZE)];
+   static q31_t biquadQ31[CIAADSP_BIQUAD_COEFFS_SIZE(2)] = {
+      0x0CCCCCCD, 0x1999999A, 0x0CCCCCCD, 0x4CCCCCCD, -0x1999999A,
+      0x06666666, 0x0CCCCCCD, 0x06666666, 0x73333333, -0x26666666,
+   };
+   static float biquadF32[CIAADSP_BIQUAD_COEFFS_SIZE(2)] = {
+      0.1f, 0.2f, 0.1f, 0.6f, -0.2f,
+      0.05f, 0.1f, 0.05f, 0.9f, -0.3f,
+   };
+   static q31_t biquadStateQ31[CIAADSP_BIQUAD_STATE_SIZE(2)];
+   static float biquadStateF32[CIAADSP_BIQUAD_STATE_SIZE(2)];
+   static union {
+      q15_t q15[BLOCK_SIZE];
+      q31_t q31[BLOCK_SIZE];
+      float f32[BLOCK_SIZE];
+   } samples;
+   ciaaDsp_stageType * stages[4];
+   char const * const names[4] = { "fir Q15", "fir F32", "biquad Q31", "biquad F32" };
+   uint64_t cycles;
+   uint32_t start;
+   uint32_t stage;
+   uint32_t block;
+   uint32_t i;
+   ciaaDsp_firType firQ15;
+   ciaaDsp_firType firF32;
+   ciaaDsp_biquadType iirQ31;
+   ciaaDsp_biquadType iirF32;
+
+   for(i = 0; i < BENCH_TAPS; i++)
+   {
+      coeffsF32[i] = 1.0f / BENCH_TAPS;
+      coeffsQ15[i] = 32768 / BENCH_TAPS;
+   }
+   ciaaDsp_firInitQ15(&firQ15, coeffsQ15, BENCH_TAPS, stateQ15, BLOCK_SIZE, 1);
+   ciaaDsp_firInitF32(&firF32, coeffsF32, BENCH_TAPS, stateF32, BLOCK_SIZE, 1);
+   ciaaDsp_biquadInitQ31(&iirQ31, biquadQ31, biquadStateQ31, 2, 0);
+   ciaaDsp_biquadInitF32(&iirF32, biquadF32, biquadStateF32, 2);
+   stages[0] = &firQ15.stage;
+   stages[1] = &firF32.stage;
+   stages[2] = &iirQ31.stage;
+   stages[3] = &iirF32.stage;
+
+   for(stage = 0; stage < 4; stage++)
+   {
+      cycles = 0;
+      for(block = 0; block < BENCH_BLOCKS; block++)
+      {
+         for(i = 0; i < BLOCK_SIZE; i++)
+         {
+            samples.q31[i] = rand();
+         }
+         if (CIAADSP_F32 == stages[stage]->inFormat)
+         {
+            for(i = 0; i < BLOCK_SIZE; i++)
+            {
+               samples.f32[i] = randomF32();
+            }
+         }
+         start = ciaaLibs_cyclesGet();
+         TEST_ASSERT_EQUAL_UINT32(BLOCK_SIZE, process(stages[stage], &samples, BLOCK_SIZE));
+         cycles += ciaaLibs_cyclesGet() - start;
+      }
+      printf("ciaaDsp %-10s: %6.2f cycles per sample\n", names[stage],
+            (double)cycles / (BENCH_BLOCKS * BLOCK_SIZE));
+   }
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
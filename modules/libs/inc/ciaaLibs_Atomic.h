@@ -0,0 +1,183 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef CIAALIBS_ATOMIC_H
+#define CIAALIBS_ATOMIC_H
+/** \brief Atomic operations Library header
+ **
+ ** This library provides atomic operations on 32 bits words which can be
+ ** used from tasks and from ISRs without a critical section.
+ **
+ ** Cortex-M3/M4 and x86 use the exclusive access and the locked
+ ** instructions of the core. Cortex-M0 has no exclusive access, the read
+ ** modify write operations disable the interrupts for a few instructions.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Libs CIAA Libraries
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief Read a word shared with other tasks or ISRs
+ **
+ ** \param[in] ptr pointer to the word
+ ** \return value of the word
+ **/
+#define ciaaLibs_atomicLoad(ptr)                                     \
+   __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+
+/** \brief Write a word shared with other tasks or ISRs
+ **
+ ** \param[out] ptr pointer to the word
+ ** \param[in] value value to be written
+ **/
+#define ciaaLibs_atomicStore(ptr, value)                             \
+   __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+
+#if (cortexM0 == ARCH)
+#define ciaaLibs_atomicCas(ptr, expected, desired)                   \
+   ciaaLibs_atomicCompareExchange((ptr), (expected), (desired))
+#define ciaaLibs_atomicOr(ptr, value)                                \
+   ciaaLibs_atomicFetchOr((ptr), (value))
+#define ciaaLibs_atomicAnd(ptr, value)                               \
+   ciaaLibs_atomicFetchAnd((ptr), (value))
+#define ciaaLibs_atomicAdd(ptr, value)                               \
+   ciaaLibs_atomicFetchAdd((ptr), (value))
+#else
+/** \brief Compare and swap a word
+ **
+ ** \param[inout] ptr pointer to the word
+ ** \param[inout] expected pointer to the expected value, updated with the
+ **               current value of the word if they are not equal
+ ** \param[in] desired value written if the word equals the expected value
+ ** \return true if the word has been written, false in other case
+ **/
+#define ciaaLibs_atomicCas(ptr, expected, desired)                   \
+   __atomic_compare_exchange_n((ptr), (expected), (desired), false,  \
+         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+/** \brief Set bits of a word
+ **
+ ** \param[inout] ptr pointer to the word
+ ** \param[in] value bits to be set
+ ** \return value of the word before the operation
+ **/
+#define ciaaLibs_atomicOr(ptr, value)                                \
+   __atomic_fetch_or((ptr), (value), __ATOMIC_ACQ_REL)
+
+/** \brief Clear bits of a word
+ **
+ ** \param[inout] ptr pointer to the word
+ ** \param[in] value mask of the bits to be kept
+ ** \return value of the word before the operation
+ **/
+#define ciaaLibs_atomicAnd(ptr, value)                               \
+   __atomic_fetch_and((ptr), (value), __ATOMIC_ACQ_REL)
+
+/** \brief Add to a word
+ **
+ ** \param[inout] ptr pointer to the word
+ ** \param[in] value value to be added
+ ** \return value of the word before the operation
+ **/
+#define ciaaLibs_atomicAdd(ptr, value)                               \
+   __atomic_fetch_add((ptr), (value), __ATOMIC_ACQ_REL)
+#endif
+
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Compare and swap a word with the interrupts disabled
+ **
+ ** Implementation of ciaaLibs_atomicCas for the cores without exclusive
+ ** access, do not call it directly.
+ **
+ ** \param[inout] ptr pointer to the word
+ ** \param[inout] expected pointer to the expected value
+ ** \param[in] desired value written if the word equals the expected value
+ ** \return true if the word has been written, false in other case
+ **/
+extern bool ciaaLibs_atomicCompareExchange(uint32_t volatile * ptr,
+      uint32_t * expected, uint32_t desired);
+
+/** \brief Set bits of a word with the interrupts disabled
+ **
+ ** \param[inout] ptr pointer to the word
+ ** \param[in] value bits to be set
+ ** \return value of the word before the operation
+ **/
+extern uint32_t ciaaLibs_atomicFetchOr(uint32_t volatile * ptr,
+      uint32_t value);
+
+/** \brief Clear bits of a word with the interrupts disabled
+ **
+ ** \param[inout] ptr pointer to the word
+ ** \param[in] value mask of the bits to be kept
+ ** \return value of the word before the operation
+ **/
+extern uint32_t ciaaLibs_atomicFetchAnd(uint32_t volatile * ptr,
+      uint32_t value);
+
+/** \brief Add to a word with the interrupts disabled
+ **
+ ** \param[inout] ptr pointer to the word
+ ** \param[in] value value to be added
+ ** \return value of the word before the operation
+ **/
+extern uint32_t ciaaLibs_atomicFetchAdd(uint32_t volatile * ptr,
+      uint32_t value);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef CIAALIBS_ATOMIC_H */
+
@@ -36,6 +36,17 @@
  **
  ** This library provides a circular buffer
  **
+ ** ciaaLibs_circBufPut and ciaaLibs_circBufGet copy any count of bytes with
+ ** memcpy. The inline fast paths ciaaLibs_circBufPutByte,
+ ** ciaaLibs_circBufGetByte, ciaaLibs_circBufPutSmall and
+ ** ciaaLibs_circBufGetSmall are for the callers which move a few bytes at a
+ ** time, as the serial drivers, and avoid the call and the wrapping
+ ** calculation. CIAALIBS_RING_DECLARE declares a ring of elements of any
+ ** type with the mask known at compile time.
+ **
+ ** All the functions can be used by one writer and one reader at the same
+ ** time, eg. a task and an ISR, without a critical section.
+ **
  **/
 
 /** \addtogroup CIAA_Firmware CIAA Firmware
@@ -47,6 +58,7 @@
 #include "ciaaPOSIX_stdint.h"
 #include "ciaaPOSIX_stdlib.h"
 #include "ciaaLibs_Maths.h"
+#include "ciaaLibs_Atomic.h"
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -181,6 +193,68 @@ extern "C" {
       (cbuf)->tail = 0;                \
    }
 
+/** \brief maximal count of bytes of ciaaLibs_circBufPutSmall and
+ **        ciaaLibs_circBufGetSmall
+ **
+ ** The small fast paths copy byte by byte, above this size ciaaLibs_circBufPut
+ ** and ciaaLibs_circBufGet with memcpy are faster.
+ **/
+#ifndef CIAALIBS_CIRCBUF_SMALL
+#define CIAALIBS_CIRCBUF_SMALL   16
+#endif
+
+/** \brief macro to declare a ring of elements
+ **
+ ** This macro generates the definition of a ring of size elements of type
+ ** type called name and the inline functions:
+ **  * size_t <name>_put(type const * element): stores a copy of the element,
+ **    returns 1 or 0 if the ring is full
+ **  * size_t <name>_get(type * element): removes the oldest element, returns
+ **    1 or 0 if the ring is empty
+ **  * size_t <name>_count(void): returns the count of stored elements
+ **
+ ** The indexes run free and are masked with size - 1 on access, so all size
+ ** elements can be used. The size shall be a power of 2, other sizes do not
+ ** compile. The ring is static to the file which declares it.
+ **
+ ** \param[in] name name of the ring
+ ** \param[in] type type of the elements
+ ** \param[in] size count of elements, shall be a power of 2
+ **/
+#define CIAALIBS_RING_DECLARE(name, type, size)                              \
+   typedef char name ## _sizeIsPowerOf2[                                     \
+      ((0 != (size)) && (0 == ((size) & ((size) - 1)))) ? 1 : -1];           \
+   static type name ## _buf[(size)];                                         \
+   static ciaaLibs_RingType name;                                            \
+   static inline size_t name ## _put(type const * element)                   \
+   {                                                                         \
+      size_t ret = 0;                                                        \
+      size_t tail = name.tail;                                               \
+      if ((size) > (tail - ciaaLibs_atomicLoad(&name.head)))                 \
+      {                                                                      \
+         name ## _buf[tail & ((size) - 1)] = *element;                       \
+         ciaaLibs_atomicStore(&name.tail, tail + 1);                         \
+         ret = 1;                                                            \
+      }                                                                      \
+      return ret;                                                            \
+   }                                                                         \
+   static inline size_t name ## _get(type * element)                         \
+   {                                                                         \
+      size_t ret = 0;                                                        \
+      size_t head = name.head;                                               \
+      if (ciaaLibs_atomicLoad(&name.tail) != head)                           \
+      {                                                                      \
+         *element = name ## _buf[head & ((size) - 1)];                       \
+         ciaaLibs_atomicStore(&name.head, head + 1);                         \
+         ret = 1;                                                            \
+      }                                                                      \
+      return ret;                                                            \
+   }                                                                         \
+   static inline size_t name ## _count(void)                                 \
+   {                                                                         \
+      return ciaaLibs_atomicLoad(&name.tail) - ciaaLibs_atomicLoad(&name.head); \
+   }
+
 /*==================[typedef]================================================*/
 /** \brief circular buffer type
  **
@@ -195,6 +269,16 @@ typedef struct {
    uint8_t * buf;       /** <= pointer to the buffer */
 } ciaaLibs_CircBufType;
 
+/** \brief ring type of CIAALIBS_RING_DECLARE
+ **
+ ** The indexes count all the elements put and got and wrap at the size of
+ ** size_t. The ring is empty if they are equal.
+ **/
+typedef struct {
+   size_t head;         /** <= count of elements got */
+   size_t tail;         /** <= count of elements put */
+} ciaaLibs_RingType;
+
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
@@ -249,6 +333,138 @@ extern size_t ciaaLibs_circBufPut(ciaaLibs_CircBufType * cbuf, void const * data
  **/
 extern size_t ciaaLibs_circBufGet(ciaaLibs_CircBufType * cbuf, void * data, size_t nbytes);
 
+/*==================[inline functions definition]==========================*/
+/** \brief put a byte to a circular buffer
+ **
+ ** \param[inout] cbuf pointer to the circular buffer
+ ** \param[in]    data byte to be stored in the buffer
+ ** \returns 1 if the byte has been stored, 0 if the buffer is full
+ **/
+static inline size_t ciaaLibs_circBufPutByte(ciaaLibs_CircBufType * cbuf,
+      uint8_t data)
+{
+   size_t ret = 0;
+   size_t tail = cbuf->tail;
+   size_t next = (tail + 1) & cbuf->size;
+
+   /* the head may be changed by the reader, it is read only once */
+   if (ciaaLibs_atomicLoad(&cbuf->head) != next)
+   {
+      cbuf->buf[tail] = data;
+      ciaaLibs_atomicStore(&cbuf->tail, next);
+      ret = 1;
+   }
+
+   return ret;
+} /* end ciaaLibs_circBufPutByte */
+
+/** \brief get a byte from a circular buffer
+ **
+ ** \param[inout] cbuf pointer to the circular buffer
+ ** \param[out]   data pointer to store the read byte
+ ** \returns 1 if a byte has been read, 0 if the buffer is empty
+ **/
+static inline size_t ciaaLibs_circBufGetByte(ciaaLibs_CircBufType * cbuf,
+      uint8_t * data)
+{
+   size_t ret = 0;
+   size_t head = cbuf->head;
+
+   /* the tail may be changed by the writer, it is read only once */
+   if (ciaaLibs_atomicLoad(&cbuf->tail) != head)
+   {
+      *data = cbuf->buf[head];
+      ciaaLibs_atomicStore(&cbuf->head, (head + 1) & cbuf->size);
+      ret = 1;
+   }
+
+   return ret;
+} /* end ciaaLibs_circBufGetByte */
+
+/** \brief put a few bytes to a circular buffer
+ **
+ ** Same as ciaaLibs_circBufPut, all or none of the bytes are stored. The
+ ** bytes are copied one by one, when nbytes is a constant the copy is
+ ** unrolled by the compiler.
+ **
+ ** \param[inout] cbuf pointer to the circular buffer
+ ** \param[in]    data data to be stored in the buffer
+ ** \param[in]    nbytes size of the data, at most CIAALIBS_CIRCBUF_SMALL
+ ** \returns count of stored bytes
+ **/
+static inline size_t ciaaLibs_circBufPutSmall(ciaaLibs_CircBufType * cbuf,
+      void const * data, size_t nbytes)
+{
+   size_t ret = 0;
+   size_t tail = cbuf->tail;
+   size_t head = ciaaLibs_atomicLoad(&cbuf->head);
+   size_t i;
+
+   if (((head - tail - 1) & cbuf->size) >= nbytes)
+   {
+      if (cbuf->size >= (tail + nbytes - 1))
+      {
+         /* no wrapping, plain copy which the compiler can widen */
+         for(i = 0; i < nbytes; i++)
+         {
+            cbuf->buf[tail + i] = ((uint8_t const *)data)[i];
+         }
+      }
+      else
+      {
+         for(i = 0; i < nbytes; i++)
+         {
+            cbuf->buf[(tail + i) & cbuf->size] = ((uint8_t const *)data)[i];
+         }
+      }
+      ciaaLibs_atomicStore(&cbuf->tail, (tail + nbytes) & cbuf->size);
+      ret = nbytes;
+   }
+
+   return ret;
+} /* end ciaaLibs_circBufPutSmall */
+
+/** \brief get a few bytes from a circular buffer
+ **
+ ** Same as ciaaLibs_circBufGet, if less than nbytes are stored only the
+ ** stored bytes are read.
+ **
+ ** \param[inout] cbuf pointer to the circular buffer
+ ** \param[out]   data pointer to store the read data
+ ** \param[in]    nbytes size of the data, at most CIAALIBS_CIRCBUF_SMALL
+ ** \returns count of read bytes
+ **/
+static inline size_t ciaaLibs_circBufGetSmall(ciaaLibs_CircBufType * cbuf,
+      void * data, size_t nbytes)
+{
+   size_t head = cbuf->head;
+   size_t count = (ciaaLibs_atomicLoad(&cbuf->tail) - head) & cbuf->size;
+   size_t i;
+
+   if (nbytes > count)
+   {
+      nbytes = count;
+   }
+   if (cbuf->size >= (head + nbytes - 1))
+   {
+      /* no wrapping, plain copy which the compiler can widen */
+      for(i = 0; i < nbytes; i++)
+      {
+         ((uint8_t *)data)[i] = cbuf->buf[head + i];
+      }
+   }
+   else
+   {
+      for(i = 0; i < nbytes; i++)
+      {
+         ((uint8_t *)data)[i] = cbuf->buf[(head + i) & cbuf->size];
+      }
+   }
+   ciaaLibs_atomicStore(&cbuf->head, (head + nbytes) & cbuf->size);
+
+   return nbytes;
+} /* end ciaaLibs_circBufGetSmall */
+
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
 }
@@ -0,0 +1,114 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef CIAALIBS_CYCLES_H
+#define CIAALIBS_CYCLES_H
+/** \brief Cycle counter Library header
+ **
+ ** Access to the cycle counter of the cpu, used to measure the time spent
+ ** by the kernel, the drivers and the dsp stages.
+ **
+ ** Cortex-M4 uses the DWT cycle counter of the CMSIS, x86 the time stamp
+ ** counter. The other cores have no cycle counter and read 0.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Libs CIAA Libraries
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#if (cortexM4 == ARCH)
+#if (k60_120 == CPUTYPE)
+#include "fsl_device_registers.h"
+#else
+#include "chip.h"
+#endif
+#elif (x86 == ARCH)
+#include <x86intrin.h>
+#endif
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+#if (cortexM4 == ARCH)
+/** \brief Enable the cycle counter
+ **
+ ** Sets DEMCR.TRCENA and DWT_CTRL.CYCCNTENA, can be called several times.
+ **/
+#define ciaaLibs_cyclesEnable()                                      \
+   do {                                                              \
+      CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;                \
+      DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;                           \
+   } while (0)
+
+/** \brief Read the cycle counter
+ **
+ ** \return cycles counted since the counter has been enabled, modulo 2^32
+ **/
+#define ciaaLibs_cyclesGet()                                         \
+   ((uint32_t)DWT->CYCCNT)
+#elif (x86 == ARCH)
+#define ciaaLibs_cyclesEnable()                                      \
+   do { } while (0)
+#define ciaaLibs_cyclesGet()                                         \
+   ((uint32_t)__rdtsc())
+#else
+#define ciaaLibs_cyclesEnable()                                      \
+   do { } while (0)
+#define ciaaLibs_cyclesGet()                                         \
+   ((uint32_t)0)
+#endif
+
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef CIAALIBS_CYCLES_H */
+
@@ -98,11 +98,30 @@ extern "C" {
 #define ciaaLibs_clearBit(var, bit)   \
    ((var) &= (~( 1 << (bit) )))
 
-/*==================[typedef]================================================*/
+/** \brief Count the trailing zeros of a uint32
+ **
+ ** Cortex-M3/M4 and x86 use the rbit/clz and bsf instructions, Cortex-M0
+ ** has no clz and uses a de Bruijn sequence instead.
+ **
+ ** \param[in] value value to be scanned, shall not be 0
+ ** \return position of the first set bit starting on the LSB
+ **/
+#if (cortexM0 == ARCH)
+#define ciaaLibs_ctz(value)                                          \
+   ((uint32_t)ciaaLibs_deBruijnCtz[                                  \
+      ((uint32_t)((value) & (0u - (value))) * 0x077CB531u) >> 27])
+#else
+#define ciaaLibs_ctz(value)      ((uint32_t)__builtin_ctz(value))
+#endif
 
-/*==================[external data declaration]==============================*/
+/** \brief Count the leading zeros of a uint32
+ **
+ ** \param[in] value value to be scanned, shall not be 0
+ ** \return count of not set bits before the first set bit starting on
+ **         the MSB
+ **/
+#define ciaaLibs_clz(value)      ((uint32_t)__builtin_clz(value))
 
-/*==================[external functions declaration]=========================*/
 /** \brief get the first not set bit in a uint32
  **
  ** Finds the first not set bit in a uint32_t. It start searching in the LSB.
@@ -111,10 +130,22 @@ extern "C" {
  ** \return -1 if all bits are set and a value between 0 and 31 if a not set
  **         bit is found.
  **
- ** \remarks this function does not call any other service and returns in a
- **          defined time so it can be called while in a critical section.
+ ** \remarks this macro does not call any other service and executes in
+ **          constant time so it can be used while in a critical section.
  **/
-extern int8_t ciaaLibs_getFirstNotSetBit(uint32_t value);
+#define ciaaLibs_getFirstNotSetBit(value)                            \
+   ( (0xffffffffu == (uint32_t)(value)) ?                            \
+     (int8_t)-1 :                                                    \
+     (int8_t)ciaaLibs_ctz(~(uint32_t)(value)) )
+
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+/** \brief bit positions indexed by the de Bruijn product of the lowest set
+ **        bit, used by ciaaLibs_ctz on Cortex-M0 */
+extern uint8_t const ciaaLibs_deBruijnCtz[32];
+
+/*==================[external functions declaration]=========================*/
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -35,7 +35,8 @@
 #define CIAALIBS_POOLBUF_H
 /** \brief Pool of Buffer Library header
  **
- ** This library provides a pool of buffers
+ ** This library provides a pool of buffers and a slab allocator which
+ ** groups several pools by the size of their elements.
  **
  **/
 
@@ -54,6 +55,16 @@ extern "C" {
 #endif
 
 /*==================[macros]=================================================*/
+/** \brief count of status words of a pool
+ **
+ ** One bit per element plus one summary bit per status word, the summary
+ ** words are stored after the status words.
+ **
+ ** \param[in] size size of the pool
+ **/
+#define CIAALIBS_POOLBUF_STATUS_WORDS(size)                          \
+   ( (((size) + 31) / 32) + (((((size) + 31) / 32) + 31) / 32) )
+
 /** \brief macro to define the pool declaration variables
  **
  ** This macro genertes the definition of 3 variables called:
@@ -69,16 +80,22 @@ extern "C" {
  ** \param[in] size size of the pool
  **
  **/
-#define CIAALIBS_POOLDECLARE(name, type, size)  \
-   type name ## _buf[(size)];                   \
-   uint32_t name ## _status[(size)/32] = { 0 }; \
-   ciaaLibs_poolBufType name = {                \
-      (size),                                   \
-      sizeof(type),                             \
-      name ## _status,                          \
-      name ## _buf                              \
+#define CIAALIBS_POOLDECLARE(name, type, size)                       \
+   type name ## _buf[(size)];                                        \
+   uint32_t name ## _status[CIAALIBS_POOLBUF_STATUS_WORDS(size)] = { 0 }; \
+   ciaaLibs_poolBufType name = {                                     \
+      (size),                                                        \
+      sizeof(type),                                                  \
+      name ## _status,                                               \
+      &name ## _status[((size) + 31) / 32],                          \
+      (uint8_t *)name ## _buf                                        \
    };
 
+/** \brief initializer of a size class of a slab
+ **
+ ** \param[in] pool pool buffer of the size class
+ **/
+#define CIAALIBS_SLABCLASS(pool)      { &(pool), 0, 0, 0 }
 
 /*==================[typedef]================================================*/
 /** \brief pool buffer type
@@ -86,16 +103,46 @@ extern "C" {
  **/
 typedef struct {
    size_t poolSize;      /** <= count of elements which can be stored in this
-                               pool. Shall be 32 * x */
+                               pool */
    size_t elementSize;   /** <= size of each element */
-   uint32_t * statusPtr; /** <= pointer to an array of size poolSize / 32, each
-                                bit indicataes with 0 that the corresponding
-                                pool element is not used, with one that is
-                                beeing used. */
+   uint32_t * statusPtr; /** <= pointer to an array of (poolSize + 31) / 32
+                                words, each bit indicataes with 0 that the
+                                corresponding pool element is not used, with
+                                one that is beeing used. */
+   uint32_t * summaryPtr; /** <= pointer to an array of one bit per status
+                                word, each bit indicates with 1 that the
+                                corresponding status word is full. It is a
+                                hint for the search of a free element. */
    uint8_t * buf;        /** <= pointer to the buffer. Buffer shall be
                                poolSize * elementSize */
 } ciaaLibs_poolBufType;
 
+/** \brief size class of a slab */
+typedef struct {
+   ciaaLibs_poolBufType * pool; /** <= pool of the elements of this class */
+   uint32_t used;               /** <= count of locked elements */
+   uint32_t highWater;          /** <= maximal count of locked elements */
+   uint32_t full;               /** <= count of allocations which did not
+                                      find a free element in this class */
+} ciaaLibs_slabClassType;
+
+/** \brief slab allocator type */
+typedef struct {
+   size_t classesCount;             /** <= count of size classes */
+   ciaaLibs_slabClassType * classes; /** <= size classes sorted by element
+                                          size in increasing order */
+} ciaaLibs_slabType;
+
+/** \brief statistics of a size class of a slab */
+typedef struct {
+   size_t elementSize;  /** <= size of the elements of the class */
+   size_t count;        /** <= count of elements of the class */
+   uint32_t used;       /** <= count of locked elements */
+   uint32_t highWater;  /** <= maximal count of locked elements */
+   uint32_t full;       /** <= count of allocations which did not find a free
+                               element in this class */
+} ciaaLibs_slabStatsType;
+
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
@@ -105,8 +152,9 @@ typedef struct {
  **
  ** \param[inout] pbuf pool buffer to be initializated
  ** \param[in] buf pointer to the buffer with size poolSize * elementSize
- ** \param[in] statusPtr pointer to the buffer of poolSize / 32 of type uint32
- ** \param[in] poolSize size of the pool shall be multiple of 32
+ ** \param[in] statusPtr pointer to the buffer of
+ **            CIAALIBS_POOLBUF_STATUS_WORDS(poolSize) words of type uint32
+ ** \param[in] poolSize size of the pool
  ** \param[in] elementSize size of an element in the pool
  ** \return 1 if init can be performed -1 in other case
  **
@@ -115,13 +163,16 @@ extern int32_t ciaaLibs_poolBufInit(ciaaLibs_poolBufType * pbuf,
       void * buf, uint32_t * statusPtr, size_t poolSize, size_t elementSize);
 
 /** \brief get free place on the pool buffer
+ **
+ ** The summary words are scanned to find a status word with free elements
+ ** so the time to find an element does not depend on the count of used
+ ** elements.
  **
  ** \param[inout] pbuf pointer to the pool buffer
  ** \return a pointer to the element or NULL if not free element is available
  **
- ** \remarks this function is not thread safe, in a multi task environment
- **          ensure that this function is not executed concurrently with the
- **          same pbuf parameter.
+ ** \remarks this function uses atomic operations and can be called
+ **          concurrently from tasks and ISRs with the same pbuf parameter.
  **/
 extern void * ciaaLibs_poolBufLock(ciaaLibs_poolBufType * pbuf);
 
@@ -129,10 +180,49 @@ extern void * ciaaLibs_poolBufLock(ciaaLibs_poolBufType * pbuf);
  **
  ** \param[inout] pbuf pointer to the pool buffer
  ** \param[in]    element pointer to the element to be removed from the pool
- ** \returns 1 if success 0 if an error occurs
+ ** \returns 1 if success 0 if the element does not belong to the pool or
+ **          is not locked
+ **
+ ** \remarks this function uses atomic operations and can be called
+ **          concurrently from tasks and ISRs with the same pbuf parameter.
  **/
 extern size_t ciaaLibs_poolBufFree(ciaaLibs_poolBufType * pbuf, void * data);
 
+/** \brief allocate an element of a slab
+ **
+ ** The element is taken from the smallest size class which fits size, if
+ ** that class is full the next bigger classes are tried.
+ **
+ ** \param[inout] slab pointer to the slab
+ ** \param[in] size count of bytes to be allocated
+ ** \return a pointer to the element or NULL if no class has a free element
+ **         which fits size
+ **
+ ** \remarks this function can be called concurrently from tasks and ISRs.
+ **/
+extern void * ciaaLibs_slabAlloc(ciaaLibs_slabType * slab, size_t size);
+
+/** \brief free an element of a slab
+ **
+ ** \param[inout] slab pointer to the slab
+ ** \param[in] data pointer to the element to be freed
+ ** \return 1 if the element has been freed, 0 if data does not belong to
+ **         the slab and -1 if data is not an allocated element of the slab
+ **
+ ** \remarks this function can be called concurrently from tasks and ISRs.
+ **/
+extern int32_t ciaaLibs_slabFree(ciaaLibs_slabType * slab, void * data);
+
+/** \brief get the statistics of a size class of a slab
+ **
+ ** \param[in] slab pointer to the slab
+ ** \param[in] index index of the size class
+ ** \param[out] stats pointer to the statistics
+ ** \return 1 if success -1 if the class does not exist
+ **/
+extern int32_t ciaaLibs_slabGetStats(ciaaLibs_slabType const * slab,
+      size_t index, ciaaLibs_slabStatsType * stats);
+
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
 }
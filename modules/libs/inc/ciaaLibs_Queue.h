@@ -0,0 +1,169 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef CIAALIBS_QUEUE_H
+#define CIAALIBS_QUEUE_H
+/** \brief Multi producer multi consumer queue Library header
+ **
+ ** Bounded queue of elements of a fixed size which can be used by any count
+ ** of writers and readers at the same time, tasks and ISRs, without a
+ ** critical section.
+ **
+ ** Each element has a turn, the position in the queue which may use it
+ ** next: the lap of the position while the element is free and the lap + 1
+ ** while it holds data. Writers and readers reserve consecutive positions
+ ** with a compare and swap of the tail or the head and release each element
+ ** by updating its turn, as the bounded queue of D. Vyukov. A reader or
+ ** writer interrupted between the reservation and the release delays the
+ ** other ones only on that element.
+ **
+ ** The blocking wrappers for the tasks are provided by ciaak_queue.h.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Libs CIAA Libraries
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stddef.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief macro to define a queue
+ **
+ ** This macro generates the definition of 3 variables called:
+ **  * <name>_buf: array of type type and size size
+ **  * <name>_turn: turn of each element of <name>_buf
+ **  * <name>: queue
+ **
+ ** If you use this macro you do not need to call ciaaLibs_queueInit.
+ **
+ ** \param[in] name name of the queue
+ ** \param[in] type type of the elements
+ ** \param[in] size count of elements, shall be a power of 2 and at least 2
+ **/
+#define CIAALIBS_QUEUEDECLARE(name, type, size)                      \
+   type name ## _buf[(size)];                                        \
+   uint32_t volatile name ## _turn[(size)] = { 0 };                  \
+   ciaaLibs_queueType name = {                                       \
+      0,                                                             \
+      0,                                                             \
+      (size) - 1,                                                    \
+      sizeof(type),                                                  \
+      name ## _turn,                                                 \
+      (uint8_t *)name ## _buf                                        \
+   };
+
+/*==================[typedef]================================================*/
+/** \brief queue type
+ **
+ ** The positions count all the elements put and got and wrap at 2^32.
+ **/
+typedef struct {
+   uint32_t volatile tail;      /** <= position of the next element to put */
+   uint32_t volatile head;      /** <= position of the next element to get */
+   uint32_t mask;               /** <= count of elements - 1 */
+   size_t elementSize;          /** <= size of each element */
+   uint32_t volatile * turn;    /** <= turn of each element */
+   uint8_t * buf;               /** <= pointer to the elements */
+} ciaaLibs_queueType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize a queue
+ **
+ ** \param[out] queue queue to be initialized
+ ** \param[in] buf pointer to the buffer of size * elementSize bytes
+ ** \param[in] turn pointer to an array of size words
+ ** \param[in] size count of elements, shall be a power of 2 and at least 2
+ ** \param[in] elementSize size of each element
+ ** \return 1 if init can be performed -1 in other case
+ **/
+extern int32_t ciaaLibs_queueInit(ciaaLibs_queueType * queue, void * buf,
+      uint32_t volatile * turn, uint32_t size, size_t elementSize);
+
+/** \brief put elements to a queue
+ **
+ ** The elements put by one call are consecutive in the queue. If the queue
+ ** has less free elements than count only the first ones are put.
+ **
+ ** \param[inout] queue pointer to the queue
+ ** \param[in] elements pointer to count elements
+ ** \param[in] count count of elements to be put
+ ** \return count of elements put, 0 if the queue is full
+ **
+ ** \remarks this function can be called concurrently from tasks and ISRs
+ **          with the same queue parameter.
+ **/
+extern uint32_t ciaaLibs_queuePut(ciaaLibs_queueType * queue,
+      void const * elements, uint32_t count);
+
+/** \brief get elements from a queue
+ **
+ ** \param[inout] queue pointer to the queue
+ ** \param[out] elements pointer to store up to count elements
+ ** \param[in] count maximal count of elements to be got
+ ** \return count of elements got, 0 if the queue is empty
+ **
+ ** \remarks this function can be called concurrently from tasks and ISRs
+ **          with the same queue parameter.
+ **/
+extern uint32_t ciaaLibs_queueGet(ciaaLibs_queueType * queue,
+      void * elements, uint32_t count);
+
+/** \brief get the count of elements of a queue
+ **
+ ** \param[in] queue pointer to the queue
+ ** \return count of reserved elements, it may be already outdated if other
+ **         tasks or ISRs use the queue
+ **/
+extern uint32_t ciaaLibs_queueCount(ciaaLibs_queueType const * queue);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef CIAALIBS_QUEUE_H */
@@ -0,0 +1,141 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief Atomic operations Library sources
+ **
+ ** Read modify write operations of the cores without exclusive access. The
+ ** interrupts are disabled through PRIMASK and restored to their previous
+ ** state so the functions can also be called with the interrupts disabled.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Libs CIAA Libraries
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaLibs_Atomic.h"
+
+/*==================[macros and definitions]=================================*/
+#if (cortexM0 == ARCH)
+/** \brief disable the interrupts and return the previous PRIMASK */
+#define ciaaLibs_atomicEnter(primask)                                \
+   __asm__ volatile ("mrs %0, primask\n\tcpsid i"                    \
+         : "=r" (primask) : : "memory")
+
+/** \brief restore the PRIMASK returned by ciaaLibs_atomicEnter */
+#define ciaaLibs_atomicExit(primask)                                 \
+   __asm__ volatile ("msr primask, %0" : : "r" (primask) : "memory")
+#else
+#define ciaaLibs_atomicEnter(primask)  ((primask) = 0)
+#define ciaaLibs_atomicExit(primask)   ((void)(primask))
+#endif
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+extern bool ciaaLibs_atomicCompareExchange(uint32_t volatile * ptr,
+      uint32_t * expected, uint32_t desired)
+{
+   uint32_t primask;
+   bool ret = false;
+
+   ciaaLibs_atomicEnter(primask);
+   if (*ptr == *expected) {
+      *ptr = desired;
+      ret = true;
+   } else {
+      *expected = *ptr;
+   }
+   ciaaLibs_atomicExit(primask);
+
+   return ret;
+} /* end ciaaLibs_atomicCompareExchange */
+
+extern uint32_t ciaaLibs_atomicFetchOr(uint32_t volatile * ptr,
+      uint32_t value)
+{
+   uint32_t primask;
+   uint32_t ret;
+
+   ciaaLibs_atomicEnter(primask);
+   ret = *ptr;
+   *ptr = ret | value;
+   ciaaLibs_atomicExit(primask);
+
+   return ret;
+} /* end ciaaLibs_atomicFetchOr */
+
+extern uint32_t ciaaLibs_atomicFetchAnd(uint32_t volatile * ptr,
+      uint32_t value)
+{
+   uint32_t primask;
+   uint32_t ret;
+
+   ciaaLibs_atomicEnter(primask);
+   ret = *ptr;
+   *ptr = ret & value;
+   ciaaLibs_atomicExit(primask);
+
+   return ret;
+} /* end ciaaLibs_atomicFetchAnd */
+
+extern uint32_t ciaaLibs_atomicFetchAdd(uint32_t volatile * ptr,
+      uint32_t value)
+{
+   uint32_t primask;
+   uint32_t ret;
+
+   ciaaLibs_atomicEnter(primask);
+   ret = *ptr;
+   *ptr = ret + value;
+   ciaaLibs_atomicExit(primask);
+
+   return ret;
+} /* end ciaaLibs_atomicFetchAdd */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+
@@ -43,7 +43,7 @@
  ** @{ */
 
 /*==================[inclusions]=============================================*/
-#include "ciaaPOSIX_stdlib.h"
+#include "ciaaLibs_Maths.h"
 
 /*==================[macros and definitions]=================================*/
 
@@ -54,40 +54,14 @@
 /*==================[internal data definition]===============================*/
 
 /*==================[external data definition]===============================*/
+uint8_t const ciaaLibs_deBruijnCtz[32] = {
+    0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8,
+   31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9
+};
 
 /*==================[internal functions definition]==========================*/
 
 /*==================[external functions definition]==========================*/
-extern int8_t ciaaLibs_getFirstNotSetBit(uint32_t value)
-{
-   uint32_t mask = 0xffffffffu;
-   bool found = false;
-   uint8_t searchSize = 16;
-   uint8_t searchPos = 0;
-
-   if (mask != value) {
-      while(false == found)
-      {
-         /* check if one or more bits are 0 */
-         if (((mask >> (32-searchSize)) << searchPos) !=
-               (value & ((mask >> (32-searchSize)) << searchPos))) {
-            if (1 != searchSize) {
-               searchSize >>= 1;
-            } else {
-               found = true;
-            }
-         } else {
-            searchPos += searchSize;
-         }
-      }
-   }
-
-   if (false == found) {
-      searchPos = -1;
-   }
-
-   return searchPos;
-}
 
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
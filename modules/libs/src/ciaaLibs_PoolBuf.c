@@ -33,7 +33,7 @@
 
 /** \brief Pool Buffer Library sources
  **
- ** This library provides a pool buffer
+ ** This library provides a pool buffer and a slab allocator
  **
  **/
 
@@ -45,9 +45,18 @@
 /*==================[inclusions]=============================================*/
 #include "ciaaLibs_PoolBuf.h"
 #include "ciaaLibs_Maths.h"
+#include "ciaaLibs_Atomic.h"
 #include "ciaaPOSIX_string.h"
 
 /*==================[macros and definitions]=================================*/
+/** \brief bits of a word which do not correspond to an element
+ **
+ ** \param[in] count count of bits of the bitmap
+ ** \param[in] word index of the word of the bitmap
+ ** \return bits of the word beyond count, they are handled as used
+ **/
+#define ciaaLibs_poolBufTail(count, word)                            \
+   ( (((count) >> 5) == (word)) ? (0xffffffffu << ((count) & 0x1f)) : 0u )
 
 /*==================[internal data declaration]==============================*/
 
@@ -82,10 +91,11 @@ extern int32_t ciaaLibs_poolBufInit(ciaaLibs_poolBufType * pbuf,
    if (1 == ret) {
       pbuf->buf = buf;
       pbuf->statusPtr = statusPtr;
+      pbuf->summaryPtr = &statusPtr[(poolSize + 31) >> 5];
       pbuf->poolSize = poolSize;
       pbuf->elementSize = elementSize;
 
-      for(i = 0; i < (poolSize >> 5); i++) {
+      for(i = 0; i < CIAALIBS_POOLBUF_STATUS_WORDS(poolSize); i++) {
          /* indicate that all elements are free and not beeing used */
          pbuf->statusPtr[i] = 0;
       }
@@ -97,39 +107,56 @@ extern int32_t ciaaLibs_poolBufInit(ciaaLibs_poolBufType * pbuf,
 extern void * ciaaLibs_poolBufLock(ciaaLibs_poolBufType * pbuf)
 {
    void * ret = NULL;
-   uint32_t i; /** <= variable for the loop */
-   uint32_t loopCount;
-   uint32_t freePos = 0; /** variable to indicate which position is free */
-   int8_t pos;
-   bool found = false;
-
-   loopCount = (pbuf->poolSize + 31 ) >> 5;
-
-   /* enter critical section */
-
-   for(i = 0; (i < loopCount) && (false == found); i++) {
-      pos = ciaaLibs_getFirstNotSetBit(pbuf->statusPtr[i]);
-      if (-1 != pos) {
-         freePos += pos;
-         found = true;
-      } else {
-         /* no free place in the first 32 positions */
-         freePos += 32;
-      }
-   }
+   uint32_t words = (pbuf->poolSize + 31) >> 5;
+   uint32_t sum;     /** <= index of the summary word */
+   uint32_t summary; /** <= full status words, including the ones skipped */
+   uint32_t word;    /** <= index of the status word */
+   uint32_t status;
+   uint32_t tail;
+   uint32_t free;
+   uint32_t bit = 0;
+   bool locked;
+
+   for(sum = 0; (sum < ((words + 31) >> 5)) && (NULL == ret); sum++) {
+      summary = ciaaLibs_atomicLoad(&pbuf->summaryPtr[sum]) |
+         ciaaLibs_poolBufTail(words, sum);
 
-   /* if found and the found free element is within the size */
-   if ((true == found) && (freePos < pbuf->poolSize))
-   {
-      /* reserve the element in the pool */
-      ciaaLibs_setBit(pbuf->statusPtr[i-1], freePos & 0x1f);
+      while ((0xffffffffu != summary) && (NULL == ret)) {
+         word = (sum << 5) + ciaaLibs_ctz(~summary);
+         tail = ciaaLibs_poolBufTail(pbuf->poolSize, word);
+         status = ciaaLibs_atomicLoad(&pbuf->statusPtr[word]);
+         locked = false;
 
-      /* exit critical section */
+         /* reserve the first free element of the status word, on failure
+          * the status is updated with the current value and retried */
+         do {
+            free = ~(status | tail);
+            if (0 != free) {
+               bit = ciaaLibs_ctz(free);
+               locked = ciaaLibs_atomicCas(&pbuf->statusPtr[word], &status,
+                     status | (1u << bit));
+            }
+         } while ((0 != free) && (false == locked));
 
-      /* get element address */
-      ret = (void*) &pbuf->buf[freePos * pbuf->elementSize];
-   } else {
-      /* exit critical section */
+         if (true == locked) {
+            if (0xffffffffu == (status | tail | (1u << bit))) {
+               /* the status word is full, an element freed before the
+                * summary bit is set would be hidden so check it again */
+               ciaaLibs_atomicOr(&pbuf->summaryPtr[sum], 1u << (word & 0x1f));
+               if (0xffffffffu !=
+                     (ciaaLibs_atomicLoad(&pbuf->statusPtr[word]) | tail)) {
+                  ciaaLibs_atomicAnd(&pbuf->summaryPtr[sum],
+                        ~(1u << (word & 0x1f)));
+               }
+            }
+
+            /* get element address */
+            ret = (void*) &pbuf->buf[((word << 5) + bit) * pbuf->elementSize];
+         } else {
+            /* locked by others since the summary has been read */
+            summary |= 1u << (word & 0x1f);
+         }
+      }
    }
 
    return ret;
@@ -137,18 +164,105 @@ extern void * ciaaLibs_poolBufLock(ciaaLibs_poolBufType * pbuf)
 
 extern size_t ciaaLibs_poolBufFree(ciaaLibs_poolBufType * pbuf, void * data)
 {
-   /* if data is smaller pbuf->buf this will crash, but it shall never
-    * happens. */
+   size_t ret = 0;
+   /* if data is smaller pbuf->buf the difference wraps around and is
+    * rejected as out of the pool */
    uintptr_t diff = (uintptr_t)data - (uintptr_t)(pbuf->buf);
-
    size_t element = diff / pbuf->elementSize;
+   uint32_t word = element >> 5;
+   uint32_t mask = 1u << (element & 0x1f);
+   uint32_t status;
+
+   if ((element < pbuf->poolSize) && (0 == (diff % pbuf->elementSize))) {
+      /* free the element */
+      status = ciaaLibs_atomicAnd(&pbuf->statusPtr[word], ~mask);
 
-   /* free the element */
-   ciaaLibs_clearBit(pbuf->statusPtr[element>>5], element & 0x1f);
+      /* an element which is not locked is a double free */
+      if (0 != (status & mask)) {
+         if (0xffffffffu ==
+               (status | ciaaLibs_poolBufTail(pbuf->poolSize, word))) {
+            /* the status word is not full anymore */
+            ciaaLibs_atomicAnd(&pbuf->summaryPtr[word >> 5],
+                  ~(1u << (word & 0x1f)));
+         }
+         ret = 1;
+      }
+   }
 
-   return 1;
+   return ret;
 } /* end of ciaaLibs_poolBufFree */
 
+extern void * ciaaLibs_slabAlloc(ciaaLibs_slabType * slab, size_t size)
+{
+   void * ret = NULL;
+   ciaaLibs_slabClassType * sizeClass;
+   uint32_t i;
+   uint32_t used;
+   uint32_t highWater;
+
+   for(i = 0; (i < slab->classesCount) && (NULL == ret); i++) {
+      sizeClass = &slab->classes[i];
+      if (size <= sizeClass->pool->elementSize) {
+         ret = ciaaLibs_poolBufLock(sizeClass->pool);
+         if (NULL == ret) {
+            /* try the next bigger class */
+            ciaaLibs_atomicAdd(&sizeClass->full, 1);
+         } else {
+            used = ciaaLibs_atomicAdd(&sizeClass->used, 1) + 1;
+            highWater = ciaaLibs_atomicLoad(&sizeClass->highWater);
+            while ((used > highWater) &&
+                  (false == ciaaLibs_atomicCas(&sizeClass->highWater, &highWater,
+                                               used))) {
+               /* highWater is updated by the failed compare and swap */
+            }
+         }
+      }
+   }
+
+   return ret;
+} /* end of ciaaLibs_slabAlloc */
+
+extern int32_t ciaaLibs_slabFree(ciaaLibs_slabType * slab, void * data)
+{
+   int32_t ret = 0;
+   ciaaLibs_poolBufType * pool;
+   uint32_t i;
+
+   for(i = 0; (i < slab->classesCount) && (0 == ret); i++) {
+      pool = slab->classes[i].pool;
+      if (((uint8_t *)data >= pool->buf) &&
+            ((uint8_t *)data < &pool->buf[pool->poolSize * pool->elementSize])) {
+         if (1 == ciaaLibs_poolBufFree(pool, data)) {
+            ciaaLibs_atomicAdd(&slab->classes[i].used, 0xffffffffu);
+            ret = 1;
+         } else {
+            ret = -1;
+         }
+      }
+   }
+
+   return ret;
+} /* end of ciaaLibs_slabFree */
+
+extern int32_t ciaaLibs_slabGetStats(ciaaLibs_slabType const * slab,
+      size_t index, ciaaLibs_slabStatsType * stats)
+{
+   int32_t ret = -1;
+   ciaaLibs_slabClassType * sizeClass;
+
+   if (index < slab->classesCount) {
+      sizeClass = &slab->classes[index];
+      stats->elementSize = sizeClass->pool->elementSize;
+      stats->count = sizeClass->pool->poolSize;
+      stats->used = ciaaLibs_atomicLoad(&sizeClass->used);
+      stats->highWater = ciaaLibs_atomicLoad(&sizeClass->highWater);
+      stats->full = ciaaLibs_atomicLoad(&sizeClass->full);
+      ret = 1;
+   }
+
+   return ret;
+} /* end of ciaaLibs_slabGetStats */
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /*==================[end of file]============================================*/
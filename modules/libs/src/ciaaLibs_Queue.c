@@ -0,0 +1,273 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief Multi producer multi consumer queue Library source file
+ **
+ ** A writer reserves the positions from the tail while the turn of their
+ ** elements is the lap of the position (the element has been freed by the
+ ** reader of the previous lap), copies the data and sets the turn to the
+ ** lap + 1. A reader reserves the positions from the head while the turn is
+ ** the lap + 1, copies the data and sets the turn to the next lap. The turn
+ ** of an element is only written by the owner of its position, so the
+ ** elements found ready before the compare and swap of the tail or the head
+ ** are still ready if the swap succeeds.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Libs CIAA Libraries
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaLibs_Queue.h"
+#include "ciaaLibs_Maths.h"
+#include "ciaaLibs_Atomic.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief lap of a position, the turn of its element while it is free
+ **
+ ** \param[in] queue pointer to the queue
+ ** \param[in] pos position in the queue
+ **/
+#define ciaaLibs_queueLap(queue, pos)     ((pos) & ~((queue)->mask))
+
+/** \brief pointer to the element of a position
+ **
+ ** \param[in] queue pointer to the queue
+ ** \param[in] pos position in the queue
+ **/
+#define ciaaLibs_queueElement(queue, pos)                            \
+   (&(queue)->buf[((pos) & (queue)->mask) * (queue)->elementSize])
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/** \brief copy an element
+ **
+ ** The elements are usually a few words, they are copied inline without
+ ** the call of ciaaPOSIX_memcpy.
+ **
+ ** \param[out] dst destination of the copy
+ ** \param[in] src source of the copy
+ ** \param[in] size size of the element
+ **/
+static void ciaaLibs_queueCopy(uint8_t * dst, uint8_t const * src,
+      size_t size);
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void ciaaLibs_queueCopy(uint8_t * dst, uint8_t const * src,
+      size_t size)
+{
+   size_t i;
+
+   for(i = 0; i < size; i++)
+   {
+      dst[i] = src[i];
+   }
+} /* end ciaaLibs_queueCopy */
+
+/*==================[external functions definition]==========================*/
+extern int32_t ciaaLibs_queueInit(ciaaLibs_queueType * queue, void * buf,
+      uint32_t volatile * turn, uint32_t size, size_t elementSize)
+{
+   int32_t ret = -1;
+   uint32_t i;
+
+   if ( (NULL != queue) && (NULL != buf) && (NULL != turn) && (size > 1) &&
+        (ciaaLibs_isPowerOfTwo(size)) && (0 != elementSize) )
+   {
+      queue->tail = 0;
+      queue->head = 0;
+      queue->mask = size - 1;
+      queue->elementSize = elementSize;
+      queue->turn = turn;
+      queue->buf = (uint8_t *)buf;
+
+      /* all the elements are free for the first lap */
+      for(i = 0; i < size; i++)
+      {
+         turn[i] = 0;
+      }
+
+      ret = 1;
+   }
+
+   return ret;
+} /* end ciaaLibs_queueInit */
+
+extern uint32_t ciaaLibs_queuePut(ciaaLibs_queueType * queue,
+      void const * elements, uint32_t count)
+{
+   uint32_t pos = ciaaLibs_atomicLoad(&queue->tail);
+   uint32_t ready = 0;
+   uint32_t i;
+   bool reserved = false;
+
+   if (count > (queue->mask + 1))
+   {
+      count = queue->mask + 1;
+   }
+
+   while ((0 != count) && (false == reserved))
+   {
+      /* count the free elements following the tail */
+      for(ready = 0; (ready < count) &&
+            (ciaaLibs_atomicLoad(&queue->turn[(pos + ready) & queue->mask]) ==
+             ciaaLibs_queueLap(queue, pos + ready)); ready++)
+      {
+      }
+
+      if (0 == ready)
+      {
+         if ((int32_t)(ciaaLibs_atomicLoad(&queue->turn[pos & queue->mask]) -
+               ciaaLibs_queueLap(queue, pos)) < 0)
+         {
+            /* the element still holds the data of the previous lap, the
+             * queue is full */
+            count = 0;
+         }
+         else
+         {
+            /* other writer has reserved the element, retry on the tail */
+            pos = ciaaLibs_atomicLoad(&queue->tail);
+         }
+      }
+      else
+      {
+         /* on failure pos is updated with the current tail */
+         reserved = ciaaLibs_atomicCas(&queue->tail, &pos, pos + ready);
+      }
+   }
+
+   if (false == reserved)
+   {
+      ready = 0;
+   }
+
+   for(i = 0; i < ready; i++)
+   {
+      ciaaLibs_queueCopy(ciaaLibs_queueElement(queue, pos + i),
+            &((uint8_t const *)elements)[i * queue->elementSize],
+            queue->elementSize);
+      ciaaLibs_atomicStore(&queue->turn[(pos + i) & queue->mask],
+            ciaaLibs_queueLap(queue, pos + i) + 1);
+   }
+
+   return ready;
+} /* end ciaaLibs_queuePut */
+
+extern uint32_t ciaaLibs_queueGet(ciaaLibs_queueType * queue,
+      void * elements, uint32_t count)
+{
+   uint32_t pos = ciaaLibs_atomicLoad(&queue->head);
+   uint32_t ready = 0;
+   uint32_t i;
+   bool reserved = false;
+
+   if (count > (queue->mask + 1))
+   {
+      count = queue->mask + 1;
+   }
+
+   while ((0 != count) && (false == reserved))
+   {
+      /* count the elements with data following the head */
+      for(ready = 0; (ready < count) &&
+            (ciaaLibs_atomicLoad(&queue->turn[(pos + ready) & queue->mask]) ==
+             (ciaaLibs_queueLap(queue, pos + ready) + 1)); ready++)
+      {
+      }
+
+      if (0 == ready)
+      {
+         if ((int32_t)(ciaaLibs_atomicLoad(&queue->turn[pos & queue->mask]) -
+               (ciaaLibs_queueLap(queue, pos) + 1)) < 0)
+         {
+            /* the element has not been written in this lap, the queue is
+             * empty */
+            count = 0;
+         }
+         else
+         {
+            /* other reader has reserved the element, retry on the head */
+            pos = ciaaLibs_atomicLoad(&queue->head);
+         }
+      }
+      else
+      {
+         /* on failure pos is updated with the current head */
+         reserved = ciaaLibs_atomicCas(&queue->head, &pos, pos + ready);
+      }
+   }
+
+   if (false == reserved)
+   {
+      ready = 0;
+   }
+
+   for(i = 0; i < ready; i++)
+   {
+      ciaaLibs_queueCopy(&((uint8_t *)elements)[i * queue->elementSize],
+            ciaaLibs_queueElement(queue, pos + i), queue->elementSize);
+      ciaaLibs_atomicStore(&queue->turn[(pos + i) & queue->mask],
+            ciaaLibs_queueLap(queue, pos + i) + queue->mask + 1);
+   }
+
+   return ready;
+} /* end ciaaLibs_queueGet */
+
+extern uint32_t ciaaLibs_queueCount(ciaaLibs_queueType const * queue)
+{
+   uint32_t head = ciaaLibs_atomicLoad(&queue->head);
+   uint32_t tail = ciaaLibs_atomicLoad(&queue->tail);
+   uint32_t ret = tail - head;
+
+   /* the tail may have moved several laps after the head has been read */
+   if (ret > (queue->mask + 1))
+   {
+      ret = queue->mask + 1;
+   }
+
+   return ret;
+} /* end ciaaLibs_queueCount */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,121 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the test of the atomic operations library
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Libs CIAA Libraries
+ ** @{ */
+/** \addtogroup ModuleTests Module Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaLibs_Atomic.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint32_t word;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   word = 0x0000ff00u;
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+void test_ciaaLibs_atomicCompareExchange(void) {
+   uint32_t expected = 0;
+
+   TEST_ASSERT_FALSE(ciaaLibs_atomicCompareExchange(&word, &expected, 1));
+   TEST_ASSERT_EQUAL_HEX32(0x0000ff00u, expected);
+   TEST_ASSERT_EQUAL_HEX32(0x0000ff00u, word);
+
+   TEST_ASSERT_TRUE(ciaaLibs_atomicCompareExchange(&word, &expected, 1));
+   TEST_ASSERT_EQUAL_HEX32(1, word);
+}
+
+void test_ciaaLibs_atomicFetch(void) {
+   TEST_ASSERT_EQUAL_HEX32(0x0000ff00u, ciaaLibs_atomicFetchOr(&word, 0xf000000fu));
+   TEST_ASSERT_EQUAL_HEX32(0xf000ff0fu, word);
+
+   TEST_ASSERT_EQUAL_HEX32(0xf000ff0fu, ciaaLibs_atomicFetchAnd(&word, 0x0ffffff0u));
+   TEST_ASSERT_EQUAL_HEX32(0x0000ff00u, word);
+
+   TEST_ASSERT_EQUAL_HEX32(0x0000ff00u, ciaaLibs_atomicFetchAdd(&word, 0xffffffffu));
+   TEST_ASSERT_EQUAL_HEX32(0x0000feffu, word);
+}
+
+void test_ciaaLibs_atomicMacros(void) {
+   uint32_t expected = 0x0000ff00u;
+
+   TEST_ASSERT_TRUE(ciaaLibs_atomicCas(&word, &expected, 2));
+   TEST_ASSERT_EQUAL_HEX32(2, ciaaLibs_atomicLoad(&word));
+   TEST_ASSERT_EQUAL_HEX32(2, ciaaLibs_atomicOr(&word, 1));
+   TEST_ASSERT_EQUAL_HEX32(3, ciaaLibs_atomicAnd(&word, 1));
+   TEST_ASSERT_EQUAL_HEX32(1, ciaaLibs_atomicAdd(&word, 1));
+   ciaaLibs_atomicStore(&word, 7);
+   TEST_ASSERT_EQUAL_HEX32(7, word);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+
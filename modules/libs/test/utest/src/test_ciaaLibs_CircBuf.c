@@ -56,6 +56,13 @@
 void ciaaLibs_circBufPrint(ciaaLibs_CircBufType * cbuf);
 
 /*==================[internal data definition]===============================*/
+/** \brief element of the typed ring */
+typedef struct {
+   uint16_t id;
+   uint32_t value;
+} ringElementType;
+
+CIAALIBS_RING_DECLARE(ring, ringElementType, 4);
 
 /*==================[external data definition]===============================*/
 
@@ -317,6 +324,141 @@ void test_ciaaLibs_circBufEmptyFull(void) {
    ciaaLibs_circBufRel(cbuf);
 }
 
+/** \brief test ciaaLibs_circBufPutByte and ciaaLibs_circBufGetByte
+ **/
+void test_ciaaLibs_circBufPutGetByte(void) {
+   ciaaLibs_CircBufType cbuf;
+   uint8_t buf[8];
+   uint8_t data;
+   size_t ret;
+   uint8_t i;
+
+   ciaaLibs_circBufInit(&cbuf, buf, sizeof(buf));
+
+   /* nothing to get from an empty buffer */
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_circBufGetByte(&cbuf, &data));
+
+   /* fill the buffer, 7 bytes can be stored */
+   for(i = 0; i < 7; i++)
+   {
+      TEST_ASSERT_EQUAL_INT(1, ciaaLibs_circBufPutByte(&cbuf, 'a' + i));
+   }
+   TEST_ASSERT_TRUE(ciaaLibs_circBufFull(&cbuf));
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_circBufPutByte(&cbuf, 'z'));
+
+   /* get 5 and put 5 more wrapping at the end of the buffer */
+   for(i = 0; i < 5; i++)
+   {
+      TEST_ASSERT_EQUAL_INT(1, ciaaLibs_circBufGetByte(&cbuf, &data));
+      TEST_ASSERT_EQUAL_UINT8('a' + i, data);
+   }
+   for(i = 0; i < 5; i++)
+   {
+      TEST_ASSERT_EQUAL_INT(1, ciaaLibs_circBufPutByte(&cbuf, 'A' + i));
+   }
+
+   /* the bytes are read in order */
+   for(i = 0; i < 2; i++)
+   {
+      ret = ciaaLibs_circBufGetByte(&cbuf, &data);
+      TEST_ASSERT_EQUAL_INT(1, ret);
+      TEST_ASSERT_EQUAL_UINT8('f' + i, data);
+   }
+   for(i = 0; i < 5; i++)
+   {
+      ret = ciaaLibs_circBufGetByte(&cbuf, &data);
+      TEST_ASSERT_EQUAL_INT(1, ret);
+      TEST_ASSERT_EQUAL_UINT8('A' + i, data);
+   }
+   TEST_ASSERT_TRUE(ciaaLibs_circBufEmpty(&cbuf));
+} /* end test_ciaaLibs_circBufPutGetByte */
+
+/** \brief test ciaaLibs_circBufPutSmall and ciaaLibs_circBufGetSmall
+ **/
+void test_ciaaLibs_circBufPutGetSmall(void) {
+   ciaaLibs_CircBufType cbuf;
+   uint8_t buf[16];
+   char * from = "0hallo123-10HALLO12-20hallo12-30";
+   char to[20];
+   size_t ret;
+
+   /* use linux memcpy for ciaaLibs_circBufGet */
+   ciaaPOSIX_memcpy_StubWithCallback(memcpy);
+
+   ciaaLibs_circBufInit(&cbuf, buf, sizeof(buf));
+
+   /* put 10 and get 10 to move the head and the tail */
+   TEST_ASSERT_EQUAL_INT(10, ciaaLibs_circBufPutSmall(&cbuf, from, 10));
+   memset((void*)to, 0, sizeof(to));
+   TEST_ASSERT_EQUAL_INT(10, ciaaLibs_circBufGetSmall(&cbuf, to, 10));
+   TEST_ASSERT_EQUAL_UINT8_ARRAY(from, to, 10);
+
+   /* put 12 wrapping at the end of the buffer */
+   TEST_ASSERT_EQUAL_INT(12, ciaaLibs_circBufPutSmall(&cbuf, &from[10], 12));
+   TEST_ASSERT_EQUAL_INT(12, ciaaLibs_circBufCount(&cbuf, cbuf.tail));
+
+   /* all or nothing is stored */
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_circBufPutSmall(&cbuf, from, 4));
+   TEST_ASSERT_EQUAL_INT(3, ciaaLibs_circBufPutSmall(&cbuf, &from[22], 3));
+   TEST_ASSERT_TRUE(ciaaLibs_circBufFull(&cbuf));
+
+   /* the fast paths and ciaaLibs_circBufGet share the same buffer */
+   memset((void*)to, 0, sizeof(to));
+   ret = ciaaLibs_circBufGet(&cbuf, to, 5);
+   TEST_ASSERT_EQUAL_INT(5, ret);
+   TEST_ASSERT_EQUAL_UINT8_ARRAY(&from[10], to, 5);
+
+   /* only the stored bytes are read */
+   memset((void*)to, 0, sizeof(to));
+   ret = ciaaLibs_circBufGetSmall(&cbuf, to, 16);
+   TEST_ASSERT_EQUAL_INT(10, ret);
+   TEST_ASSERT_EQUAL_UINT8_ARRAY(&from[15], to, 10);
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_circBufGetSmall(&cbuf, to, 16));
+   TEST_ASSERT_TRUE(ciaaLibs_circBufEmpty(&cbuf));
+} /* end test_ciaaLibs_circBufPutGetSmall */
+
+/** \brief test CIAALIBS_RING_DECLARE
+ **/
+void test_ciaaLibs_ring(void) {
+   ringElementType element;
+   uint16_t i;
+   uint16_t next = 0;
+
+   TEST_ASSERT_EQUAL_INT(0, ring_count());
+   TEST_ASSERT_EQUAL_INT(0, ring_get(&element));
+
+   /* all the 4 elements can be used */
+   for(i = 0; i < 4; i++)
+   {
+      element.id = i;
+      element.value = 1000u * i;
+      TEST_ASSERT_EQUAL_INT(1, ring_put(&element));
+   }
+   TEST_ASSERT_EQUAL_INT(4, ring_count());
+   TEST_ASSERT_EQUAL_INT(0, ring_put(&element));
+
+   /* get and put several times around the ring */
+   for(i = 4; i < 20; i++)
+   {
+      TEST_ASSERT_EQUAL_INT(1, ring_get(&element));
+      TEST_ASSERT_EQUAL_UINT16(next, element.id);
+      TEST_ASSERT_EQUAL_UINT32(1000u * next, element.value);
+      next++;
+
+      element.id = i;
+      element.value = 1000u * i;
+      TEST_ASSERT_EQUAL_INT(1, ring_put(&element));
+   }
+
+   while (0 != ring_get(&element))
+   {
+      TEST_ASSERT_EQUAL_UINT16(next, element.id);
+      next++;
+   }
+   TEST_ASSERT_EQUAL_INT(20, next);
+   TEST_ASSERT_EQUAL_INT(0, ring_count());
+} /* end test_ciaaLibs_ring */
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
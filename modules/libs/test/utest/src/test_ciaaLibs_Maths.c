@@ -175,6 +175,29 @@ void test_ciaaLibs_getFirstNotSetBit(void) {
 
    val = ciaaLibs_getFirstNotSetBit(0xdfffffffu);
    TEST_ASSERT_EQUAL_INT(29, val);
+
+   val = ciaaLibs_getFirstNotSetBit(0x7fffffffu);
+   TEST_ASSERT_EQUAL_INT(31, val);
+
+   val = ciaaLibs_getFirstNotSetBit(0u);
+   TEST_ASSERT_EQUAL_INT(0, val);
+}
+
+void test_ciaaLibs_ctzAndClz(void) {
+   uint32_t bit;
+   uint32_t value;
+
+   for(bit = 0; bit < 32; bit++) {
+      /* the bits above the lowest set bit shall not change the result */
+      value = (0xA5A5A5A5u << bit) | (1u << bit);
+      TEST_ASSERT_EQUAL_UINT32(bit, ciaaLibs_ctz(value));
+      /* table used on the cores without clz */
+      TEST_ASSERT_EQUAL_UINT32(bit,
+            ciaaLibs_deBruijnCtz[((value & (0u - value)) * 0x077CB531u) >> 27]);
+
+      value = (0x80000000u >> bit) | (0x5A5A5A5Au >> bit >> 1);
+      TEST_ASSERT_EQUAL_UINT32(bit, ciaaLibs_clz(value));
+   }
 }
 
 /** @} doxygen end group definition */
@@ -46,9 +46,23 @@
 #include "unity.h"
 #include "ciaaPOSIX_stdint.h"
 #include "ciaaLibs_PoolBuf.h"
-#include "mock_ciaaLibs_Maths.h"
+#include "stdio.h"
+#include "time.h"
 
 /*==================[macros and definitions]=================================*/
+/** \brief count of lock and free pairs of the benchmark */
+#define BENCH_CALLS           1000000
+
+/** \brief biggest pool of the benchmark */
+#define BENCH_POOL_SIZE       4096
+
+/** \brief count of elements allocated at the same time by the slab
+ **        benchmark, the same workload is used by the ciaaPOSIX_malloc
+ **        benchmark of test_ciaaPOSIX_stdlib.c */
+#define BENCH_LIVE            16
+
+/** \brief sizes requested by the slab benchmark */
+#define BENCH_SIZES           { 12, 24, 40, 60, 100, 8, 30, 16 }
 
 /*==================[internal data declaration]==============================*/
 
@@ -57,9 +71,66 @@
 /*==================[internal data definition]===============================*/
 CIAALIBS_POOLDECLARE(pool, uint32_t, 60);
 
+/** \brief pool of the benchmark */
+static ciaaLibs_poolBufType bigPool;
+
+/** \brief elements of the benchmark pool */
+static uint32_t bigBuf[BENCH_POOL_SIZE];
+
+/** \brief status of the benchmark pool */
+static uint32_t bigStatus[CIAALIBS_POOLBUF_STATUS_WORDS(BENCH_POOL_SIZE)];
+
+/** \brief elements of the size classes of the slab */
+typedef uint64_t slab16Type[2];
+typedef uint64_t slab32Type[4];
+typedef uint64_t slab64Type[8];
+typedef uint64_t slab128Type[16];
+
+CIAALIBS_POOLDECLARE(slab16, slab16Type, 16);
+CIAALIBS_POOLDECLARE(slab32, slab32Type, 16);
+CIAALIBS_POOLDECLARE(slab64, slab64Type, 16);
+CIAALIBS_POOLDECLARE(slab128, slab128Type, 16);
+
+/** \brief size classes of the slab */
+static ciaaLibs_slabClassType slabClasses[] = {
+   CIAALIBS_SLABCLASS(slab16),
+   CIAALIBS_SLABCLASS(slab32),
+   CIAALIBS_SLABCLASS(slab64),
+   CIAALIBS_SLABCLASS(slab128),
+};
+
+/** \brief slab of the tests */
+static ciaaLibs_slabType slab = {
+   sizeof(slabClasses) / sizeof(slabClasses[0]),
+   slabClasses
+};
+
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static void slabInit(void)
+{
+   uint32_t i;
+
+   ciaaLibs_poolBufInit(&slab16, slab16_buf, slab16_status, 16, sizeof(slab16Type));
+   ciaaLibs_poolBufInit(&slab32, slab32_buf, slab32_status, 16, sizeof(slab32Type));
+   ciaaLibs_poolBufInit(&slab64, slab64_buf, slab64_status, 16, sizeof(slab64Type));
+   ciaaLibs_poolBufInit(&slab128, slab128_buf, slab128_status, 16, sizeof(slab128Type));
+   for(i = 0; i < slab.classesCount; i++) {
+      slabClasses[i].used = 0;
+      slabClasses[i].highWater = 0;
+      slabClasses[i].full = 0;
+   }
+}
+
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
 
 /*==================[external functions definition]==========================*/
 /** \brief set Up function
@@ -80,6 +151,12 @@ void tearDown(void) {
 
 void test_ciaaLibs_poolBufInit(void) {
    int32_t val;
+
+   /* one status word is needed for the 28 elements beyond the first 32 */
+   TEST_ASSERT_EQUAL_INT(3, CIAALIBS_POOLBUF_STATUS_WORDS(60));
+   TEST_ASSERT_EQUAL_INT(128 + 4, CIAALIBS_POOLBUF_STATUS_WORDS(4096));
+   TEST_ASSERT_EQUAL_PTR(&pool_status[2], pool.summaryPtr);
+
    val = ciaaLibs_poolBufInit((ciaaLibs_poolBufType*)NULL, (void*)pool_buf, pool_status, 60, sizeof(uint32_t));
    TEST_ASSERT_EQUAL_INT(-1, val);
 
@@ -91,37 +168,254 @@ void test_ciaaLibs_poolBufInit(void) {
 
    val = ciaaLibs_poolBufInit(&pool, (void*)pool_buf, pool_status, 60, sizeof(uint32_t));
    TEST_ASSERT_EQUAL_INT(1, val);
+   TEST_ASSERT_EQUAL_PTR(&pool_status[2], pool.summaryPtr);
 }
 
 
 void test_ciaaLibs_poolBufLockAndFree(void) {
    uint32_t * element;
    size_t ret;
+   uint32_t i;
+
+   ciaaLibs_poolBufInit(&pool, (void*)pool_buf, pool_status, 60, sizeof(uint32_t));
 
-   ciaaLibs_getFirstNotSetBit_ExpectAndReturn(0, 0);
    element = ciaaLibs_poolBufLock(&pool);
    TEST_ASSERT_EQUAL_PTR(&pool_buf[0], element);
 
-   ciaaLibs_getFirstNotSetBit_ExpectAndReturn(1, 1);
    element = ciaaLibs_poolBufLock(&pool);
    TEST_ASSERT_EQUAL_PTR(&pool_buf[1], element);
 
-   ciaaLibs_getFirstNotSetBit_ExpectAndReturn(3, 2);
    element = ciaaLibs_poolBufLock(&pool);
    TEST_ASSERT_EQUAL_PTR(&pool_buf[2], element);
 
-   /* simulate full */
-   ciaaLibs_getFirstNotSetBit_ExpectAndReturn(7,-1);
-   ciaaLibs_getFirstNotSetBit_ExpectAndReturn(0,60-32);
+   for(i = 3; i < 60; i++) {
+      element = ciaaLibs_poolBufLock(&pool);
+      TEST_ASSERT_EQUAL_PTR(&pool_buf[i], element);
+   }
+   /* both status words are full, the 4 bits beyond the pool are not used */
+   TEST_ASSERT_EQUAL_HEX32(0xffffffffu, pool_status[0]);
+   TEST_ASSERT_EQUAL_HEX32(0x0fffffffu, pool_status[1]);
+   TEST_ASSERT_EQUAL_HEX32(0x3u, pool_status[2]);
+
+   /* full */
    element = ciaaLibs_poolBufLock(&pool);
    TEST_ASSERT_EQUAL_PTR(NULL, element);
 
    ret = ciaaLibs_poolBufFree(&pool, &pool_buf[1]);
    TEST_ASSERT_EQUAL_INT(1, ret);
+   TEST_ASSERT_EQUAL_HEX32(0x2u, pool_status[2]);
+
+   ret = ciaaLibs_poolBufFree(&pool, &pool_buf[59]);
+   TEST_ASSERT_EQUAL_INT(1, ret);
+   TEST_ASSERT_EQUAL_HEX32(0x0u, pool_status[2]);
 
-   ciaaLibs_getFirstNotSetBit_ExpectAndReturn(5, 1);
    element = ciaaLibs_poolBufLock(&pool);
    TEST_ASSERT_EQUAL_PTR(&pool_buf[1], element);
+
+   element = ciaaLibs_poolBufLock(&pool);
+   TEST_ASSERT_EQUAL_PTR(&pool_buf[59], element);
+
+   element = ciaaLibs_poolBufLock(&pool);
+   TEST_ASSERT_EQUAL_PTR(NULL, element);
+}
+
+void test_ciaaLibs_poolBufFreeErrors(void) {
+   uint32_t * element;
+   size_t ret;
+
+   ciaaLibs_poolBufInit(&pool, (void*)pool_buf, pool_status, 60, sizeof(uint32_t));
+
+   element = ciaaLibs_poolBufLock(&pool);
+   TEST_ASSERT_EQUAL_PTR(&pool_buf[0], element);
+
+   /* not locked */
+   ret = ciaaLibs_poolBufFree(&pool, &pool_buf[1]);
+   TEST_ASSERT_EQUAL_INT(0, ret);
+
+   /* not in the pool */
+   ret = ciaaLibs_poolBufFree(&pool, &pool_buf[60]);
+   TEST_ASSERT_EQUAL_INT(0, ret);
+   ret = ciaaLibs_poolBufFree(&pool, &pool_buf[0] - 1);
+   TEST_ASSERT_EQUAL_INT(0, ret);
+
+   /* not the start of an element */
+   ret = ciaaLibs_poolBufFree(&pool, (uint8_t*)&pool_buf[0] + 1);
+   TEST_ASSERT_EQUAL_INT(0, ret);
+
+   ret = ciaaLibs_poolBufFree(&pool, &pool_buf[0]);
+   TEST_ASSERT_EQUAL_INT(1, ret);
+
+   /* double free */
+   ret = ciaaLibs_poolBufFree(&pool, &pool_buf[0]);
+   TEST_ASSERT_EQUAL_INT(0, ret);
+   TEST_ASSERT_EQUAL_HEX32(0x0u, pool_status[0]);
+}
+
+void test_ciaaLibs_poolBufBigPool(void) {
+   uint32_t * element;
+   uint32_t i;
+
+   ciaaLibs_poolBufInit(&bigPool, (void*)bigBuf, bigStatus, BENCH_POOL_SIZE,
+         sizeof(uint32_t));
+
+   for(i = 0; i < BENCH_POOL_SIZE; i++) {
+      element = ciaaLibs_poolBufLock(&bigPool);
+      TEST_ASSERT_EQUAL_PTR(&bigBuf[i], element);
+   }
+   TEST_ASSERT_EQUAL_PTR(NULL, ciaaLibs_poolBufLock(&bigPool));
+
+   /* element 4000 is in the status word 125, bit 29 of the last summary */
+   TEST_ASSERT_EQUAL_INT(1, ciaaLibs_poolBufFree(&bigPool, &bigBuf[4000]));
+   TEST_ASSERT_EQUAL_HEX32(0xdfffffffu, bigPool.summaryPtr[3]);
+   TEST_ASSERT_EQUAL_PTR(&bigBuf[4000], ciaaLibs_poolBufLock(&bigPool));
+   TEST_ASSERT_EQUAL_HEX32(0xffffffffu, bigPool.summaryPtr[3]);
+
+   for(i = 0; i < BENCH_POOL_SIZE; i++) {
+      TEST_ASSERT_EQUAL_INT(1, ciaaLibs_poolBufFree(&bigPool, &bigBuf[i]));
+   }
+   for(i = 0; i < CIAALIBS_POOLBUF_STATUS_WORDS(BENCH_POOL_SIZE); i++) {
+      TEST_ASSERT_EQUAL_HEX32(0, bigStatus[i]);
+   }
+}
+
+void test_ciaaLibs_slabAllocAndFree(void) {
+   void * element[20];
+   ciaaLibs_slabStatsType stats;
+   uint32_t i;
+
+   slabInit();
+
+   /* the smallest class which fits the size is used */
+   element[0] = ciaaLibs_slabAlloc(&slab, 1);
+   TEST_ASSERT_EQUAL_PTR(&slab16_buf[0], element[0]);
+   element[1] = ciaaLibs_slabAlloc(&slab, 16);
+   TEST_ASSERT_EQUAL_PTR(&slab16_buf[1], element[1]);
+   element[2] = ciaaLibs_slabAlloc(&slab, 17);
+   TEST_ASSERT_EQUAL_PTR(&slab32_buf[0], element[2]);
+   element[3] = ciaaLibs_slabAlloc(&slab, 128);
+   TEST_ASSERT_EQUAL_PTR(&slab128_buf[0], element[3]);
+
+   /* bigger than the biggest class */
+   TEST_ASSERT_EQUAL_PTR(NULL, ciaaLibs_slabAlloc(&slab, 129));
+
+   TEST_ASSERT_EQUAL_INT(1, ciaaLibs_slabFree(&slab, element[1]));
+   TEST_ASSERT_EQUAL_INT(1, ciaaLibs_slabFree(&slab, element[2]));
+   TEST_ASSERT_EQUAL_INT(1, ciaaLibs_slabFree(&slab, element[3]));
+
+   /* double free and not from the slab */
+   TEST_ASSERT_EQUAL_INT(-1, ciaaLibs_slabFree(&slab, element[1]));
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_slabFree(&slab, &stats));
+
+   TEST_ASSERT_EQUAL_INT(1, ciaaLibs_slabGetStats(&slab, 0, &stats));
+   TEST_ASSERT_EQUAL_INT(16, stats.elementSize);
+   TEST_ASSERT_EQUAL_INT(16, stats.count);
+   TEST_ASSERT_EQUAL_UINT32(1, stats.used);
+   TEST_ASSERT_EQUAL_UINT32(2, stats.highWater);
+   TEST_ASSERT_EQUAL_UINT32(0, stats.full);
+   TEST_ASSERT_EQUAL_INT(-1, ciaaLibs_slabGetStats(&slab, 4, &stats));
+
+   /* a full class falls back to the next bigger one */
+   for(i = 1; i < 16; i++) {
+      TEST_ASSERT_EQUAL_PTR(&slab16_buf[i], ciaaLibs_slabAlloc(&slab, 8));
+   }
+   TEST_ASSERT_EQUAL_PTR(&slab32_buf[0], ciaaLibs_slabAlloc(&slab, 8));
+
+   ciaaLibs_slabGetStats(&slab, 0, &stats);
+   TEST_ASSERT_EQUAL_UINT32(16, stats.used);
+   TEST_ASSERT_EQUAL_UINT32(16, stats.highWater);
+   TEST_ASSERT_EQUAL_UINT32(1, stats.full);
+   ciaaLibs_slabGetStats(&slab, 1, &stats);
+   TEST_ASSERT_EQUAL_UINT32(1, stats.used);
+   TEST_ASSERT_EQUAL_UINT32(1, stats.highWater);
+}
+
+/** \brief measure the latency and the waste of the slab
+ **
+ ** A window of BENCH_LIVE elements of different sizes is allocated, each
+ ** step frees a pseudo random element of the window and allocates a new
+ ** one.
+ **/
+void test_ciaaLibs_slabBenchmark(void) {
+   static size_t const sizes[] = BENCH_SIZES;
+   void * live[BENCH_LIVE];
+   size_t liveSize[BENCH_LIVE];
+   uint64_t start;
+   uint64_t ns;
+   uint64_t requested = 0;
+   uint64_t reserved = 0;
+   uint32_t seed = 1;
+   uint32_t failed = 0;
+   uint32_t i;
+   uint32_t j;
+   ciaaLibs_slabStatsType stats;
+
+   slabInit();
+   for(i = 0; i < BENCH_LIVE; i++) {
+      liveSize[i] = sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+      live[i] = ciaaLibs_slabAlloc(&slab, liveSize[i]);
+   }
+
+   start = getNs();
+   for(i = 0; i < BENCH_CALLS; i++) {
+      seed = seed * 1103515245u + 12345u;
+      j = (seed >> 16) % BENCH_LIVE;
+      ciaaLibs_slabFree(&slab, live[j]);
+      liveSize[j] = sizes[(seed >> 8) % (sizeof(sizes) / sizeof(sizes[0]))];
+      live[j] = ciaaLibs_slabAlloc(&slab, liveSize[j]);
+      if (NULL == live[j]) {
+         failed++;
+      }
+   }
+   ns = getNs() - start;
+
+   for(i = 0; i < BENCH_LIVE; i++) {
+      requested += liveSize[i];
+   }
+   for(i = 0; i < slab.classesCount; i++) {
+      ciaaLibs_slabGetStats(&slab, i, &stats);
+      reserved += stats.used * stats.elementSize;
+      printf("ciaaLibs_slab class %3u: high water %2u of %2u, %u times full\n",
+            (uint32_t)stats.elementSize, stats.highWater,
+            (uint32_t)stats.count, stats.full);
+   }
+
+   TEST_ASSERT_EQUAL_UINT32(0, failed);
+   printf("ciaaLibs_slab: %.1f ns per free and alloc, %u failed, "
+         "%u bytes reserved for %u requested\n",
+         (double)ns / BENCH_CALLS, failed, (uint32_t)reserved,
+         (uint32_t)requested);
+}
+
+/** \brief measure a lock and free pair with the pools almost full
+ **
+ ** All elements but the last one are locked, each lock has to skip the
+ ** full status words.
+ **/
+void test_ciaaLibs_poolBufBenchmark(void) {
+   uint64_t start;
+   uint64_t ns;
+   uint32_t size;
+   uint32_t i;
+   void * element;
+
+   for(size = 32; size <= BENCH_POOL_SIZE; size <<= 1) {
+      ciaaLibs_poolBufInit(&bigPool, (void*)bigBuf, bigStatus, size,
+            sizeof(uint32_t));
+      for(i = 0; i < (size - 1); i++) {
+         ciaaLibs_poolBufLock(&bigPool);
+      }
+
+      start = getNs();
+      for(i = 0; i < BENCH_CALLS; i++) {
+         element = ciaaLibs_poolBufLock(&bigPool);
+         ciaaLibs_poolBufFree(&bigPool, element);
+      }
+      ns = getNs() - start;
+
+      TEST_ASSERT_EQUAL_PTR(&bigBuf[size - 1], element);
+      printf("ciaaLibs_poolBuf %4u elements: %.1f ns per lock and free\n",
+            size, (double)ns / BENCH_CALLS);
+   }
 }
 
 /** @} doxygen end group definition */
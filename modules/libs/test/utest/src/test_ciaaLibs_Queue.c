@@ -0,0 +1,170 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the test of the queue library
+ **
+ ** The concurrent producers and consumers run in the queue cases of the
+ ** benchmark runner, make bench.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Libs CIAA Libraries
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
+#include "ciaaLibs_Queue.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+CIAALIBS_QUEUEDECLARE(queue, uint32_t, 8);
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   ciaaLibs_queueInit(&queue, queue_buf, queue_turn, 8, sizeof(uint32_t));
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+void doNothing(void) {
+}
+
+/** \brief test ciaaLibs_queueInit
+ **/
+void test_ciaaLibs_queueInit(void) {
+   ciaaLibs_queueType q;
+   uint32_t buf[16];
+   uint32_t volatile turn[16];
+
+   /* wrong parameters */
+   TEST_ASSERT_EQUAL_INT(-1, ciaaLibs_queueInit(&q, buf, turn, 1, 4));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaLibs_queueInit(&q, buf, turn, 12, 4));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaLibs_queueInit(&q, NULL, turn, 16, 4));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaLibs_queueInit(&q, buf, NULL, 16, 4));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaLibs_queueInit(&q, buf, turn, 16, 0));
+
+   TEST_ASSERT_EQUAL_INT(1, ciaaLibs_queueInit(&q, buf, turn, 16, 4));
+   TEST_ASSERT_EQUAL_INT(15, q.mask);
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_queueCount(&q));
+}
+
+/** \brief test ciaaLibs_queuePut and ciaaLibs_queueGet with one element
+ **/
+void test_ciaaLibs_queuePutGet(void) {
+   uint32_t element;
+   uint32_t i;
+
+   /* nothing to get from an empty queue */
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_queueGet(&queue, &element, 1));
+
+   /* all the 8 elements can be used */
+   for(i = 0; i < 8; i++)
+   {
+      element = 100 + i;
+      TEST_ASSERT_EQUAL_INT(1, ciaaLibs_queuePut(&queue, &element, 1));
+   }
+   TEST_ASSERT_EQUAL_INT(8, ciaaLibs_queueCount(&queue));
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_queuePut(&queue, &element, 1));
+
+   /* get and put several laps */
+   for(i = 0; i < 30; i++)
+   {
+      TEST_ASSERT_EQUAL_INT(1, ciaaLibs_queueGet(&queue, &element, 1));
+      TEST_ASSERT_EQUAL_UINT32(100 + i, element);
+      element = 108 + i;
+      TEST_ASSERT_EQUAL_INT(1, ciaaLibs_queuePut(&queue, &element, 1));
+   }
+   for(i = 30; i < 38; i++)
+   {
+      TEST_ASSERT_EQUAL_INT(1, ciaaLibs_queueGet(&queue, &element, 1));
+      TEST_ASSERT_EQUAL_UINT32(100 + i, element);
+   }
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_queueGet(&queue, &element, 1));
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_queueCount(&queue));
+}
+
+/** \brief test the batch operations
+ **/
+void test_ciaaLibs_queueBatch(void) {
+   uint32_t from[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+   uint32_t to[12];
+
+   /* 5 and then only 3 of 5 fit */
+   TEST_ASSERT_EQUAL_INT(5, ciaaLibs_queuePut(&queue, from, 5));
+   TEST_ASSERT_EQUAL_INT(3, ciaaLibs_queuePut(&queue, &from[5], 5));
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_queuePut(&queue, from, 1));
+
+   /* get 6 of them and put 6 more wrapping at the end of the buffer */
+   TEST_ASSERT_EQUAL_INT(6, ciaaLibs_queueGet(&queue, to, 6));
+   TEST_ASSERT_EQUAL_UINT32_ARRAY(from, to, 6);
+   TEST_ASSERT_EQUAL_INT(6, ciaaLibs_queuePut(&queue, &from[6], 12));
+
+   /* only the stored elements are got, more than the size is limited */
+   TEST_ASSERT_EQUAL_INT(8, ciaaLibs_queueGet(&queue, to, 12));
+   TEST_ASSERT_EQUAL_UINT32_ARRAY(&from[6], to, 2);
+   TEST_ASSERT_EQUAL_UINT32_ARRAY(&from[6], &to[2], 6);
+   TEST_ASSERT_EQUAL_INT(0, ciaaLibs_queueGet(&queue, to, 12));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,211 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef CIAALOG_H
+#define CIAALOG_H
+/** \brief CIAA Deferred binary logging
+ **
+ ** The log calls do not format anything on the target. Each call stores the
+ ** offset of its format string within the ciaaLog section and up to
+ ** CIAALOG_MAXARGS raw 32 bits arguments in a circular buffer. The buffer is
+ ** written to a device (serial port or flash) with ciaaLog_drain, which is
+ ** meant to be called from the lowest priority task. The host tool
+ ** modules/tools/scripts/ciaaLog.pl reads the format strings from the ciaaLog
+ ** section of the elf file and rebuilds the messages.
+ **
+ ** Record format (little or big endian as the target, 32 bits words):
+ **
+ **    | 31 .. 24 | 23 .. 3               | 2 .. 0 |
+ **    | 0xC1     | format string offset  | nargs  |  followed by nargs words
+ **
+ ** Each core runs its own image, so each core has its own buffer and its own
+ ** ciaaLog section.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Log Deferred binary logging
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stddef.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief size in bytes of the log buffer, shall be a power of 2 */
+#ifndef CIAALOG_SIZE
+#define CIAALOG_SIZE          1024
+#endif
+
+/** \brief maximal count of arguments of a log record */
+#define CIAALOG_MAXARGS       4
+
+/** \brief marker of the first word of a record */
+#define CIAALOG_MARKER        0xC1000000UL
+
+/** \brief mask of the marker */
+#define CIAALOG_MARKER_MASK   0xFF000000UL
+
+/** \brief count of bits used for the count of arguments */
+#define CIAALOG_NARGS_BITS    3
+
+/** \brief mask of the count of arguments */
+#define CIAALOG_NARGS_MASK    0x00000007UL
+
+/** \brief name of the section containing the format strings
+ **
+ ** The name is a valid C identifier so the linker provides the
+ ** __start_ciaaLog symbol, no linker script changes are needed.
+ **/
+#define CIAALOG_SECTION       "ciaaLog"
+
+/** \brief record header for the format string fmt and n arguments */
+#define ciaaLog_header(fmt, n)                                          \
+   ( CIAALOG_MARKER |                                                   \
+     ( (uint32_t)( (fmt) - __start_ciaaLog ) << CIAALOG_NARGS_BITS ) |  \
+     (uint32_t)(n) )
+
+/** \brief stores a format string in the ciaaLog section and logs it */
+#define ciaaLog_record(fmt, n, a0, a1, a2, a3)                          \
+   do {                                                                 \
+      static char const ciaaLog_fmt[]                                   \
+         __attribute__ ((section (CIAALOG_SECTION), used)) = fmt;       \
+      ciaaLog_put(ciaaLog_header(ciaaLog_fmt, n),                       \
+            (uint32_t)(a0), (uint32_t)(a1),                             \
+            (uint32_t)(a2), (uint32_t)(a3));                            \
+   } while (0)
+
+#ifndef CIAALOG_DISABLE
+/** \brief log a message without arguments
+ **
+ ** \param[in] fmt string literal, printf like format
+ **/
+#define ciaaLog_log0(fmt)                                               \
+   ciaaLog_record(fmt, 0, 0, 0, 0, 0)
+
+/** \brief log a message with 1 argument
+ **
+ ** The arguments are stored as 32 bits integers, the format string may
+ ** only use integer conversions (d i u x X o c) and %s for pointers to
+ ** constant strings of the image.
+ **
+ ** \param[in] fmt string literal, printf like format
+ ** \param[in] a0 first argument
+ **/
+#define ciaaLog_log1(fmt, a0)                                           \
+   ciaaLog_record(fmt, 1, a0, 0, 0, 0)
+
+/** \brief log a message with 2 arguments, see ciaaLog_log1 */
+#define ciaaLog_log2(fmt, a0, a1)                                       \
+   ciaaLog_record(fmt, 2, a0, a1, 0, 0)
+
+/** \brief log a message with 3 arguments, see ciaaLog_log1 */
+#define ciaaLog_log3(fmt, a0, a1, a2)                                   \
+   ciaaLog_record(fmt, 3, a0, a1, a2, 0)
+
+/** \brief log a message with 4 arguments, see ciaaLog_log1 */
+#define ciaaLog_log4(fmt, a0, a1, a2, a3)                               \
+   ciaaLog_record(fmt, 4, a0, a1, a2, a3)
+#else
+#define ciaaLog_log0(fmt)                 do { } while (0)
+#define ciaaLog_log1(fmt, a0)             do { } while (0)
+#define ciaaLog_log2(fmt, a0, a1)         do { } while (0)
+#define ciaaLog_log3(fmt, a0, a1, a2)     do { } while (0)
+#define ciaaLog_log4(fmt, a0, a1, a2, a3) do { } while (0)
+#endif /* #ifndef CIAALOG_DISABLE */
+
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+/** \brief start of the ciaaLog section, provided by the linker */
+extern char const __start_ciaaLog[];
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize the log buffer
+ **
+ ** Shall be called before any other ciaaLog function, pending records are
+ ** discarded.
+ **/
+extern void ciaaLog_init(void);
+
+/** \brief store a record in the log buffer
+ **
+ ** Do not call it directly, use ciaaLog_log0 .. ciaaLog_log4. The function
+ ** may be called from tasks and ISRs, the record is written with the OS
+ ** interrupts disabled for a few instructions only. If the buffer is full
+ ** the record is dropped and counted, the count is logged as soon as there
+ ** is space again.
+ **
+ ** \param[in] header record header, see ciaaLog_header
+ ** \param[in] a0 .. a3 arguments, only the first nargs are stored
+ **/
+extern void ciaaLog_put(uint32_t header, uint32_t a0, uint32_t a1,
+      uint32_t a2, uint32_t a3);
+
+/** \brief write the stored records to a device
+ **
+ ** Writes the buffer content to fildes with ciaaPOSIX_write, e.g. a
+ ** /dev/serial/uart/x device or a /dev/block/fd/x device. Only the drain
+ ** reads the buffer, so it shall be called from a single task, usually the
+ ** lowest priority one. Returns when the buffer is empty or the device
+ ** accepts less bytes than requested.
+ **
+ ** \param[in] fildes file descriptor of the device
+ ** \return count of written bytes, -1 if the device reports an error
+ **         before any byte is written
+ **/
+extern ssize_t ciaaLog_drain(int32_t fildes);
+
+/** \brief get the count of dropped records since the last init
+ **
+ ** \return count of records which could not be stored
+ **/
+extern uint32_t ciaaLog_getDropped(void);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef CIAALOG_H */
+
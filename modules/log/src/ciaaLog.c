@@ -0,0 +1,208 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief CIAA Deferred binary logging
+ **
+ ** The writers (tasks and ISRs) store complete records at the tail of the
+ ** buffer with the OS interrupts disabled, the drain is the only reader and
+ ** moves the head without any lock. The buffer size is a power of 2 and the
+ ** records are a multiple of 4 bytes, so every record starts aligned and is
+ ** written word by word wrapping at the end of the buffer.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Log Deferred binary logging
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaLog.h"
+#include "ciaaLibs_CircBuf.h"
+#include "ciaaPOSIX_stdio.h"
+#include "os.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief compiler barrier between the record and the index update
+ **
+ ** Writers and drain run on the same core, ordering the stores of the
+ ** compiler is enough.
+ **/
+#define ciaaLog_barrier()     __asm__ __volatile__ ("" : : : "memory")
+
+/** \brief size in bytes of the dropped records record */
+#define CIAALOG_DROPPED_SIZE  8
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief log buffer */
+static uint32_t ciaaLog_buf[CIAALOG_SIZE / sizeof(uint32_t)];
+
+/** \brief circular buffer control of ciaaLog_buf */
+static ciaaLibs_CircBufType ciaaLog_cbuf;
+
+/** \brief count of dropped records not yet logged */
+static uint32_t ciaaLog_pending;
+
+/** \brief count of dropped records since the last init */
+static uint32_t ciaaLog_dropped;
+
+/** \brief format string of the dropped records record */
+static char const ciaaLog_droppedFmt[]
+   __attribute__ ((section (CIAALOG_SECTION), used)) =
+   "ciaaLog: %u records dropped";
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+extern void ciaaLog_init(void)
+{
+   ciaaLibs_circBufInit(&ciaaLog_cbuf, ciaaLog_buf, sizeof(ciaaLog_buf));
+   ciaaLog_pending = 0;
+   ciaaLog_dropped = 0;
+} /* end ciaaLog_init */
+
+extern void ciaaLog_put(uint32_t header, uint32_t a0, uint32_t a1,
+      uint32_t a2, uint32_t a3)
+{
+   uint32_t * buf = ciaaLog_buf;
+   size_t mask = ciaaLog_cbuf.size >> 2;
+   size_t nbytes = ((header & CIAALOG_NARGS_MASK) + 1) << 2;
+   size_t space;
+   size_t pos;
+
+   SuspendOSInterrupts();
+
+   space = ciaaLibs_circBufSpace(&ciaaLog_cbuf, ciaaLog_cbuf.head);
+   pos = ciaaLog_cbuf.tail >> 2;
+
+   if ( (0 != ciaaLog_pending) &&
+        (space >= (nbytes + CIAALOG_DROPPED_SIZE)) )
+   {
+      /* report the dropped records before the new one */
+      buf[pos] = ciaaLog_header(ciaaLog_droppedFmt, 1);
+      buf[(pos + 1) & mask] = ciaaLog_pending;
+      pos = (pos + 2) & mask;
+      space -= CIAALOG_DROPPED_SIZE;
+      nbytes += CIAALOG_DROPPED_SIZE;
+      ciaaLog_pending = 0;
+   }
+
+   if ( (space >= nbytes) && (0 == ciaaLog_pending) )
+   {
+      buf[pos] = header;
+      switch(header & CIAALOG_NARGS_MASK)
+      {
+         case 4:
+            buf[(pos + 4) & mask] = a3;
+            /* fall through */
+         case 3:
+            buf[(pos + 3) & mask] = a2;
+            /* fall through */
+         case 2:
+            buf[(pos + 2) & mask] = a1;
+            /* fall through */
+         case 1:
+            buf[(pos + 1) & mask] = a0;
+            /* fall through */
+         default:
+            break;
+      }
+
+      /* publish the record after it has been written */
+      ciaaLog_barrier();
+      ciaaLibs_circBufUpdateTail(&ciaaLog_cbuf, nbytes);
+   }
+   else
+   {
+      ciaaLog_pending++;
+      ciaaLog_dropped++;
+   }
+
+   ResumeOSInterrupts();
+} /* end ciaaLog_put */
+
+extern ssize_t ciaaLog_drain(int32_t fildes)
+{
+   ssize_t ret = 0;
+   ssize_t written;
+   size_t count;
+   size_t tail = ciaaLog_cbuf.tail;
+
+   /* read the records after the tail which publishes them */
+   ciaaLog_barrier();
+
+   while (0 < (count = ciaaLibs_circBufRawCount(&ciaaLog_cbuf, tail)))
+   {
+      written = ciaaPOSIX_write(fildes, ciaaLibs_circBufReadPos(&ciaaLog_cbuf),
+            count);
+
+      if (0 >= written)
+      {
+         if ( (0 == ret) && (0 > written) )
+         {
+            ret = -1;
+         }
+         break;
+      }
+
+      ciaaLog_barrier();
+      ciaaLibs_circBufUpdateHead(&ciaaLog_cbuf, (size_t)written);
+      ret += written;
+
+      if ((size_t)written < count)
+      {
+         /* the device is full, try again on the next call */
+         break;
+      }
+   }
+
+   return ret;
+} /* end ciaaLog_drain */
+
+extern uint32_t ciaaLog_getDropped(void)
+{
+   return ciaaLog_dropped;
+} /* end ciaaLog_getDropped */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+
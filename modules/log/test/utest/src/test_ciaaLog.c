@@ -0,0 +1,342 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the deferred binary logging
+ **
+ ** The drained records are decoded as the host tool does, the format string
+ ** is taken from the ciaaLog section of the test binary. The last test
+ ** measures the cost of a log call.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Log Deferred binary logging
+ ** @{ */
+/** \addtogroup ModuleTests Module Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaLog.h"
+#include "mock_ciaaLibs_CircBuf.h"
+#include "mock_ciaaPOSIX_stdio.h"
+#include "os.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+#if (defined(__x86_64__) || defined(__i386__))
+#include "x86intrin.h"
+#endif
+
+/*==================[macros and definitions]=================================*/
+/** \brief count of calls of the benchmark */
+#define BENCH_CALLS           1000000
+
+/** \brief file descriptor used for the drain */
+#define LOG_FILDES            3
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief data written to the device */
+static uint32_t written[4096];
+
+/** \brief count of bytes written to the device */
+static size_t writtenCount;
+
+/** \brief maximal count of bytes accepted by each write, 0 fails */
+static size_t writeLimit;
+
+/** \brief count of nested SuspendOSInterrupts calls */
+static int32_t suspended;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int32_t circBufInit(ciaaLibs_CircBufType * cbuf, void * buf,
+      size_t nbytes, int calls)
+{
+   (void)calls;
+
+   cbuf->head = 0;
+   cbuf->tail = 0;
+   cbuf->size = nbytes - 1;
+   cbuf->buf = buf;
+
+   return 1;
+}
+
+static ssize_t posixWrite(int32_t fildes, void const * buf, size_t nbyte,
+      int calls)
+{
+   ssize_t ret = -1;
+
+   (void)calls;
+   TEST_ASSERT_EQUAL_INT(LOG_FILDES, fildes);
+
+   if (0 < writeLimit)
+   {
+      if (nbyte > writeLimit)
+      {
+         nbyte = writeLimit;
+      }
+      if (writtenCount + nbyte > sizeof(written))
+      {
+         /* discard, only the benchmark writes this much */
+         writtenCount = 0;
+      }
+      memcpy((uint8_t *)written + writtenCount, buf, nbyte);
+      writtenCount += nbyte;
+      ret = nbyte;
+   }
+
+   return ret;
+}
+
+/** \brief decode the record at word pos of the written data
+ **
+ ** \param[in] pos index of the first word of the record
+ ** \param[out] text decoded message
+ ** \return index of the next record
+ **/
+static size_t decode(size_t pos, char * text, size_t size)
+{
+   uint32_t header = written[pos];
+   uint32_t nargs = header & CIAALOG_NARGS_MASK;
+   char const * fmt = &__start_ciaaLog[(header & ~CIAALOG_MARKER_MASK) >>
+      CIAALOG_NARGS_BITS];
+
+   TEST_ASSERT_EQUAL_HEX32(CIAALOG_MARKER, header & CIAALOG_MARKER_MASK);
+   TEST_ASSERT_TRUE(nargs <= CIAALOG_MAXARGS);
+
+   snprintf(text, size, fmt, written[pos + 1], written[pos + 2],
+         written[pos + 3], written[pos + 4]);
+
+   return pos + 1 + nargs;
+}
+
+/*==================[external functions definition]==========================*/
+void SuspendOSInterrupts(void)
+{
+   suspended++;
+}
+
+void ResumeOSInterrupts(void)
+{
+   suspended--;
+}
+
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   writtenCount = 0;
+   writeLimit = sizeof(written);
+   suspended = 0;
+
+   ciaaLibs_circBufInit_StubWithCallback(circBufInit);
+   ciaaPOSIX_write_StubWithCallback(posixWrite);
+
+   ciaaLog_init();
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+   TEST_ASSERT_EQUAL_INT(0, suspended);
+}
+
+/** \brief test logging and decoding of records */
+void test_ciaaLog_records(void) {
+   char text[64];
+   size_t pos = 0;
+
+   ciaaLog_log0("started");
+   ciaaLog_log1("value %d", -5);
+   ciaaLog_log2("%u of %u", 3, 4);
+   ciaaLog_log3("%x %x %x", 0xA, 0xB, 0xC);
+   ciaaLog_log4("%c%c%c%c", 'c', 'i', 'a', 'a');
+
+   TEST_ASSERT_EQUAL_INT(15 * 4, ciaaLog_drain(LOG_FILDES));
+   TEST_ASSERT_EQUAL_INT(15 * 4, writtenCount);
+
+   pos = decode(pos, text, sizeof(text));
+   TEST_ASSERT_EQUAL_STRING("started", text);
+   pos = decode(pos, text, sizeof(text));
+   TEST_ASSERT_EQUAL_STRING("value -5", text);
+   pos = decode(pos, text, sizeof(text));
+   TEST_ASSERT_EQUAL_STRING("3 of 4", text);
+   pos = decode(pos, text, sizeof(text));
+   TEST_ASSERT_EQUAL_STRING("a b c", text);
+   pos = decode(pos, text, sizeof(text));
+   TEST_ASSERT_EQUAL_STRING("ciaa", text);
+   TEST_ASSERT_EQUAL_INT(15, pos);
+
+   /* nothing left */
+   TEST_ASSERT_EQUAL_INT(0, ciaaLog_drain(LOG_FILDES));
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaLog_getDropped());
+}
+
+/** \brief test records wrapping at the end of the buffer */
+void test_ciaaLog_wrap(void) {
+   char text[64];
+   char expected[64];
+   size_t pos = 0;
+   uint32_t loopi;
+
+   /* 5 words records do not divide the buffer, all positions are used */
+   for (loopi = 0; loopi < 3 * CIAALOG_SIZE / 20; loopi++)
+   {
+      ciaaLog_log4("%u %u %u %u", loopi, loopi + 1, loopi + 2, loopi + 3);
+      TEST_ASSERT_EQUAL_INT(20, ciaaLog_drain(LOG_FILDES));
+   }
+
+   for (loopi = 0; loopi < 3 * CIAALOG_SIZE / 20; loopi++)
+   {
+      pos = decode(pos, text, sizeof(text));
+      snprintf(expected, sizeof(expected), "%u %u %u %u", loopi, loopi + 1,
+            loopi + 2, loopi + 3);
+      TEST_ASSERT_EQUAL_STRING(expected, text);
+   }
+}
+
+/** \brief test dropped records */
+void test_ciaaLog_dropped(void) {
+   char text[64];
+   size_t pos = 0;
+   uint32_t loopi;
+
+   /* 2 words records, one word can not be used */
+   for (loopi = 0; loopi < CIAALOG_SIZE / 8 + 9; loopi++)
+   {
+      ciaaLog_log1("%u", loopi);
+   }
+   TEST_ASSERT_EQUAL_UINT32(10, ciaaLog_getDropped());
+
+   TEST_ASSERT_EQUAL_INT(CIAALOG_SIZE - 8, ciaaLog_drain(LOG_FILDES));
+   ciaaLog_log0("after");
+   TEST_ASSERT_EQUAL_INT(12, ciaaLog_drain(LOG_FILDES));
+
+   for (loopi = 0; loopi < CIAALOG_SIZE / 8 - 1; loopi++)
+   {
+      pos = decode(pos, text, sizeof(text));
+   }
+   TEST_ASSERT_EQUAL_STRING("126", text);
+   pos = decode(pos, text, sizeof(text));
+   TEST_ASSERT_EQUAL_STRING("ciaaLog: 10 records dropped", text);
+   pos = decode(pos, text, sizeof(text));
+   TEST_ASSERT_EQUAL_STRING("after", text);
+   TEST_ASSERT_EQUAL_UINT32(10, ciaaLog_getDropped());
+}
+
+/** \brief test the drain with a slow and a failing device */
+void test_ciaaLog_drain(void) {
+   char text[64];
+
+   ciaaLog_log2("%d %d", 1, 2);
+
+   writeLimit = 0;
+   TEST_ASSERT_EQUAL_INT(-1, ciaaLog_drain(LOG_FILDES));
+
+   writeLimit = 5;
+   TEST_ASSERT_EQUAL_INT(5, ciaaLog_drain(LOG_FILDES));
+   TEST_ASSERT_EQUAL_INT(5, ciaaLog_drain(LOG_FILDES));
+   TEST_ASSERT_EQUAL_INT(2, ciaaLog_drain(LOG_FILDES));
+   TEST_ASSERT_EQUAL_INT(0, ciaaLog_drain(LOG_FILDES));
+
+   decode(0, text, sizeof(text));
+   TEST_ASSERT_EQUAL_STRING("1 2", text);
+}
+
+/** \brief measure the cost of a log call */
+void test_ciaaLog_benchmark(void) {
+   uint64_t start;
+   uint64_t ns;
+   uint64_t cycles = 0;
+   uint32_t loopi;
+
+   start = getNs();
+#if (defined(__x86_64__) || defined(__i386__))
+   cycles = __rdtsc();
+#endif
+   for (loopi = 0; loopi < BENCH_CALLS; loopi++)
+   {
+      ciaaLog_log2("bench %u %u", loopi, start);
+      if (0 == (loopi & 31))
+      {
+         ciaaLog_drain(LOG_FILDES);
+      }
+   }
+#if (defined(__x86_64__) || defined(__i386__))
+   cycles = __rdtsc() - cycles;
+#endif
+   ns = getNs() - start;
+
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaLog_getDropped());
+   printf("ciaaLog_log2 including drain: %.1f ns, %.1f tsc cycles per call\n",
+         (double)ns / BENCH_CALLS, (double)cycles / BENCH_CALLS);
+
+   start = getNs();
+   for (loopi = 0; loopi < BENCH_CALLS; loopi++)
+   {
+      ciaaLog_log2("bench %u %u", loopi, start);
+   }
+   ns = getNs() - start;
+
+   printf("ciaaLog_log2 with full buffer: %.1f ns per call\n",
+         (double)ns / BENCH_CALLS);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+
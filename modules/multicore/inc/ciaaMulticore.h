@@ -46,7 +46,8 @@
 /*==================[inclusions]=============================================*/
 
 #include "ciaaPOSIX_stdlib.h"
-#include "ciaaLibs_CircBuf.h"
+#include "ciaaMulticore_Ipc.h"
+#include "ciaaMulticore_Rpc.h"
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -55,6 +56,11 @@ extern "C" {
 
 /*==================[macros]=================================================*/
 
+/** \brief rpc instance called by the stubs of CIAA_MULTICORE_RPC_DEFINE */
+#ifndef CIAA_MULTICORE_RPC_INSTANCE
+#define CIAA_MULTICORE_RPC_INSTANCE (&ciaaMulticore_rpc)
+#endif
+
 /*==================[typedef]================================================*/
 
 /** \brief List of available cores
@@ -70,7 +76,8 @@ typedef struct
 {
       struct
       {
-         uint32_t cpuid;
+         uint32_t cpuid;   /**< core which sent the message, set by
+                                ciaaMulticore_sendMessage */
          uint32_t pid;
       }id;
       uint32_t data0;
@@ -84,9 +91,36 @@ typedef enum
    CIAA_MULTICORE_CMD_SETEVENT = 0x200
 }ciaaMulticore_ipcCmd_t;
 
+/** \brief message types of the descriptors
+ *
+ * The types below CIAA_MULTICORE_MSG_USER are reserved for the messages
+ * handled by this module, like the OSEK services and the rpc.
+ */
+typedef enum
+{
+   CIAA_MULTICORE_MSG_OSEK = 0,     /**< OSEK service, see ciaaMulticore_ipcCmd_t */
+   CIAA_MULTICORE_MSG_RPC_REQ = CIAA_MULTICORE_RPC_MSG_REQ, /**< rpc request */
+   CIAA_MULTICORE_MSG_RPC_RSP = CIAA_MULTICORE_RPC_MSG_RSP, /**< rpc response */
+   CIAA_MULTICORE_MSG_USER = 0x100  /**< first type available for the user */
+}ciaaMulticore_msgType_t;
+
+/** \brief callback for the received messages of type CIAA_MULTICORE_MSG_USER
+ * or bigger
+ *
+ * The messages of the reserved types are handled internally and never
+ * passed to the callback. The payload is released after the callback
+ * returns.
+ */
+typedef void (*ciaaMulticore_msgCallback_t)(ciaaMulticore_ipcDesc_t const * desc, void * payload);
+
 /*==================[external data declaration]==============================*/
 
-extern ciaaLibs_CircBufType * ipc_queue;
+/** \brief inter-core channels, the channel i transports the messages to the
+ * core i */
+extern ciaaMulticore_ipcChannel_t * const ciaaMulticore_ipcChannels;
+
+/** \brief rpc instance of this core */
+extern ciaaMulticore_rpc_t ciaaMulticore_rpc;
 
 /*==================[external functions declaration]=========================*/
 
@@ -96,12 +130,40 @@ extern ciaaLibs_CircBufType * ipc_queue;
 extern int32_t ciaaMulticore_init(void);
 
 /** \brief Send message to inter-core queue and irq to other cores
+ *
+ * The cpuid of the message is ignored, the receiver gets the id of this
+ * core.
  *
  * @param m message to send
  * @return != 0 on success, -1 on error
  */
 extern int32_t ciaaMulticore_sendMessage(ciaaMulticore_ipcMsg_t m);
 
+/** \brief Get a payload buffer to be sent to the other core
+ *
+ * @param size size of the payload in bytes
+ * @return pointer to the payload or NULL if no buffer is available
+ */
+extern void * ciaaMulticore_alloc(size_t size);
+
+/** \brief Post a message to the other core without signaling it
+ *
+ * Many messages can be posted and signaled at once with ciaaMulticore_flush.
+ *
+ * @param desc message descriptor, its type shall be CIAA_MULTICORE_MSG_USER
+ *        or bigger
+ * @param payload payload returned by ciaaMulticore_alloc or NULL
+ * @return 1 on success, -1 if the type is reserved or the channel is full
+ *         (the payload is not sent and still owned by the caller)
+ */
+extern int32_t ciaaMulticore_post(ciaaMulticore_ipcDesc_t const * desc, void * payload);
+
+/** \brief Publish the posted messages and signal the other core once
+ *
+ * @return count of published messages
+ */
+extern uint32_t ciaaMulticore_flush(void);
+
 /** \brief Receive message from inter-core queue
  *
  * @param m message received
@@ -109,6 +171,67 @@ extern int32_t ciaaMulticore_sendMessage(ciaaMulticore_ipcMsg_t m);
  */
 extern int32_t ciaaMulticore_recvMessage(ciaaMulticore_ipcMsg_t  * m);
 
+/** \brief Set the callback for the received messages of type
+ * CIAA_MULTICORE_MSG_USER or bigger
+ *
+ * Received messages of an unknown reserved type are discarded.
+ *
+ * @param cb callback or NULL to ignore these messages
+ */
+extern void ciaaMulticore_setMsgCallback(ciaaMulticore_msgCallback_t cb);
+
+/** \brief Receive and dispatch all the messages received from the other core
+ *
+ * Called from the inter-core interrupt handler.
+ *
+ * @return count of processed messages
+ */
+extern uint32_t ciaaMulticore_processMessages(void);
+
+/** \brief Set the procedures served by this core
+ *
+ * @param procs dispatch table generated by CIAA_MULTICORE_RPC_DEFINE
+ * @param count count of procedures, see CIAA_MULTICORE_RPC_COUNT
+ */
+extern void ciaaMulticore_setInterface(ciaaMulticore_rpcProc_t const * procs, uint32_t count);
+
+/** \brief Get an inter-core resource, arbitrated by the core 0
+ *
+ * @param res inter-core resource
+ * @param done called with CIAA_MULTICORE_RPC_OK when the resource is granted
+ * @param ctx context of the callback
+ * @return 1 on success, -1 on error
+ */
+extern int32_t ciaaMulticore_getResource(uint32_t res, ciaaMulticore_rpcDone_t done, void * ctx);
+
+/** \brief Release an inter-core resource held by this core
+ *
+ * @param res inter-core resource
+ * @return 1 on success, -1 on error
+ */
+extern int32_t ciaaMulticore_releaseResource(uint32_t res);
+
+/** \brief Set a relative alarm of the other core
+ *
+ * @param alarm alarm of the other core
+ * @param increment relative value in ticks
+ * @param cycle cycle value in ticks
+ * @param done called with the status of SetRelAlarm or NULL
+ * @param ctx context of the callback
+ * @return 1 on success, -1 on error
+ */
+extern int32_t ciaaMulticore_setRelAlarm(uint32_t alarm, uint32_t increment,
+      uint32_t cycle, ciaaMulticore_rpcDone_t done, void * ctx);
+
+/** \brief Cancel an alarm of the other core
+ *
+ * @param alarm alarm of the other core
+ * @param done called with the status of CancelAlarm or NULL
+ * @param ctx context of the callback
+ * @return 1 on success, -1 on error
+ */
+extern int32_t ciaaMulticore_cancelAlarm(uint32_t alarm, ciaaMulticore_rpcDone_t done, void * ctx);
+
 /** \brief Process and dispatch a message received from a remote core
  *
  * @param m message to dispatch
@@ -0,0 +1,216 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef MULTICORE_IPC_H
+#define MULTICORE_IPC_H
+/** \brief Multicore inter-processor communication channels header file.
+ **
+ ** A channel transports messages in one direction between two cores over
+ ** shared memory. Each channel has a ring of descriptors, a pool of payload
+ ** buffers and a ring to give the payload buffers back to the sender, so
+ ** the payloads are passed by reference and never copied.
+ **
+ ** Every variable of a channel is written by only one of both cores, so no
+ ** atomic operations are needed (the Cortex-M0 does not provide them).
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Multicore Multicore module
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdlib.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief count of descriptors of each channel, shall be a power of 2 */
+#ifndef CIAA_MULTICORE_IPC_DESC_COUNT
+#define CIAA_MULTICORE_IPC_DESC_COUNT     32
+#endif
+
+/** \brief count of payload buffers of each channel, shall be a power of 2 */
+#ifndef CIAA_MULTICORE_IPC_BUF_COUNT
+#define CIAA_MULTICORE_IPC_BUF_COUNT      16
+#endif
+
+/** \brief size in bytes of each payload buffer, shall be a multiple of 4 */
+#ifndef CIAA_MULTICORE_IPC_BUF_SIZE
+#define CIAA_MULTICORE_IPC_BUF_SIZE       128
+#endif
+
+/** \brief buffer index of a descriptor without payload */
+#define CIAA_MULTICORE_IPC_NOBUF          0xFFFF
+
+/** \brief memory barrier
+ **
+ ** Ensures that the data written to the shared memory is visible to the
+ ** other core before an index referencing it is published.
+ **/
+#define ciaaMulticore_ipcBarrier()        __sync_synchronize()
+
+/** \brief count of descriptors which can be received
+ **
+ ** \param[in] ch pointer to the channel
+ ** \return count of published and not yet received descriptors
+ **/
+#define ciaaMulticore_ipcCount(ch)        \
+   ( (ch)->descTail - (ch)->descHead )
+
+/*==================[typedef]================================================*/
+/** \brief message descriptor */
+typedef struct
+{
+   uint16_t type;    /** <= type of the message */
+   uint16_t src;     /** <= core which sent the message */
+   uint16_t buf;     /** <= payload buffer index or CIAA_MULTICORE_IPC_NOBUF */
+   uint16_t len;     /** <= length of the payload in bytes */
+   uint32_t id;      /** <= identifier of the message, free for the user */
+   uint32_t data0;   /** <= user data */
+   uint32_t data1;   /** <= user data */
+} ciaaMulticore_ipcDesc_t;
+
+/** \brief inter-processor communication channel
+ **
+ ** The indexes are free running counters, they are masked only to access
+ ** the rings.
+ **/
+typedef struct
+{
+   /* written by the sender */
+   volatile uint32_t descTail;   /** <= count of published descriptors */
+   uint32_t descWr;              /** <= count of written descriptors, the
+                                        ones between descTail and descWr are
+                                        not published yet */
+   uint32_t relHead;             /** <= count of reclaimed buffers */
+   uint32_t freeCount;           /** <= count of entries in freeList */
+   uint16_t freeList[CIAA_MULTICORE_IPC_BUF_COUNT]; /** <= free buffers */
+
+   /* written by the receiver */
+   volatile uint32_t descHead;   /** <= count of received descriptors */
+   volatile uint32_t relTail;    /** <= count of released buffers */
+   uint16_t rel[CIAA_MULTICORE_IPC_BUF_COUNT]; /** <= released buffers */
+
+   /* descriptors written by the sender */
+   ciaaMulticore_ipcDesc_t desc[CIAA_MULTICORE_IPC_DESC_COUNT];
+
+   /* payload buffers, owned by the sender until they are posted and owned by
+    * the receiver until they are released */
+   uint32_t pool[CIAA_MULTICORE_IPC_BUF_COUNT][CIAA_MULTICORE_IPC_BUF_SIZE / 4];
+} ciaaMulticore_ipcChannel_t;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize a channel
+ **
+ ** Shall be called once by only one of both cores before the channel is
+ ** used.
+ **
+ ** \param[out] ch channel to be initialized
+ **/
+extern void ciaaMulticore_ipcInit(ciaaMulticore_ipcChannel_t * ch);
+
+/** \brief get a payload buffer (sender)
+ **
+ ** \param[inout] ch pointer to the channel
+ ** \param[in] size size of the payload in bytes
+ ** \return pointer to the payload buffer or NULL if size is bigger than
+ **         CIAA_MULTICORE_IPC_BUF_SIZE or no buffer is available
+ **/
+extern void * ciaaMulticore_ipcAlloc(ciaaMulticore_ipcChannel_t * ch, size_t size);
+
+/** \brief give back a payload buffer which has not been posted (sender)
+ **
+ ** \param[inout] ch pointer to the channel
+ ** \param[in] payload buffer returned by ciaaMulticore_ipcAlloc
+ **/
+extern void ciaaMulticore_ipcFree(ciaaMulticore_ipcChannel_t * ch, void * payload);
+
+/** \brief write a descriptor (sender)
+ **
+ ** The descriptor is not visible to the receiver until
+ ** ciaaMulticore_ipcFlush is called, so many messages can be posted and
+ ** signaled at once.
+ **
+ ** \param[inout] ch pointer to the channel
+ ** \param[in] desc descriptor to be posted, the field buf is ignored
+ ** \param[in] payload buffer returned by ciaaMulticore_ipcAlloc or NULL
+ ** \return 1 on success, -1 if the descriptor ring is full. On error the
+ **         caller keeps the ownership of the payload.
+ **/
+extern int32_t ciaaMulticore_ipcPost(ciaaMulticore_ipcChannel_t * ch,
+      ciaaMulticore_ipcDesc_t const * desc, void * payload);
+
+/** \brief publish the posted descriptors (sender)
+ **
+ ** \param[inout] ch pointer to the channel
+ ** \return count of descriptors published by this call, the other core has
+ **         to be signaled if not 0
+ **/
+extern uint32_t ciaaMulticore_ipcFlush(ciaaMulticore_ipcChannel_t * ch);
+
+/** \brief receive a descriptor (receiver)
+ **
+ ** \param[inout] ch pointer to the channel
+ ** \param[out] desc received descriptor
+ ** \param[out] payload pointer to the payload or NULL if the message has no
+ **             payload. The payload shall be released with
+ **             ciaaMulticore_ipcRelease.
+ ** \return 1 if a descriptor has been received, 0 if the channel is empty
+ **/
+extern int32_t ciaaMulticore_ipcRecv(ciaaMulticore_ipcChannel_t * ch,
+      ciaaMulticore_ipcDesc_t * desc, void ** payload);
+
+/** \brief give a received payload buffer back to the sender (receiver)
+ **
+ ** \param[inout] ch pointer to the channel
+ ** \param[in] payload payload returned by ciaaMulticore_ipcRecv
+ **/
+extern void ciaaMulticore_ipcRelease(ciaaMulticore_ipcChannel_t * ch, void * payload);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef MULTICORE_IPC_H */
@@ -0,0 +1,407 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef MULTICORE_RPC_H
+#define MULTICORE_RPC_H
+/** \brief Multicore remote procedure calls header file.
+ **
+ ** Remote procedure calls are transported over a pair of ipc channels. Each
+ ** request carries a correlation id which is returned in the response, so
+ ** many calls may be pending at the same time and the caller is notified
+ ** asynchronously by a completion callback.
+ **
+ ** The procedures of an application are described by an interface list:
+ **
+ ** \code
+ ** #define DSP_INTERFACE(RPC)                           \
+ **    RPC(dsp_fir, dsp_firReq_t, dsp_firRsp_t)      \
+ **    RPC(dsp_rms, dsp_rmsReq_t, dsp_rmsRsp_t)
+ **
+ ** CIAA_MULTICORE_RPC_DECLARE(DSP_INTERFACE)
+ ** \endcode
+ **
+ ** which declares the procedure ids, the client stubs
+ ** int32_t dsp_fir(dsp_firReq_t const * req, ciaaMulticore_rpcDone_t done,
+ ** void * ctx) and the server functions
+ ** int32_t dsp_fir_server(dsp_firReq_t const * req, dsp_firRsp_t * rsp)
+ ** to be implemented on the remote core. CIAA_MULTICORE_RPC_DEFINE generates
+ ** the stubs and the dispatch table in one source file.
+ **
+ ** Some services are provided by the module itself: inter-core resources,
+ ** arbitrated by one of both cores, and remote alarms.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Multicore Multicore module
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdlib.h"
+#include "ciaaMulticore_Ipc.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief count of calls which may be pending at the same time, shall be
+ ** lower than 256 */
+#ifndef CIAA_MULTICORE_RPC_PENDING
+#define CIAA_MULTICORE_RPC_PENDING        8
+#endif
+
+/** \brief count of inter-core resources */
+#ifndef CIAA_MULTICORE_RPC_RESOURCES
+#define CIAA_MULTICORE_RPC_RESOURCES      8
+#endif
+
+/** \brief count of requests which may wait for each inter-core resource */
+#ifndef CIAA_MULTICORE_RPC_WAITERS
+#define CIAA_MULTICORE_RPC_WAITERS        4
+#endif
+
+/** \brief message type of the requests */
+#define CIAA_MULTICORE_RPC_MSG_REQ        0x10
+
+/** \brief message type of the responses */
+#define CIAA_MULTICORE_RPC_MSG_RSP        0x11
+
+/** \brief correlation id of the requests without response */
+#define CIAA_MULTICORE_RPC_NOREPLY        0xFFFFFFFFUL
+
+/** \brief status: the procedure has been executed */
+#define CIAA_MULTICORE_RPC_OK             0
+
+/** \brief status returned by a server which responds later with
+ ** ciaaMulticore_rpcRespond */
+#define CIAA_MULTICORE_RPC_DEFERRED       1
+
+/** \brief status: the procedure is not known by the remote core */
+#define CIAA_MULTICORE_RPC_E_NOPROC       (-2)
+
+/** \brief status: no buffer available for the response */
+#define CIAA_MULTICORE_RPC_E_NOBUF        (-3)
+
+/** \brief status: invalid parameter or too many waiting requests */
+#define CIAA_MULTICORE_RPC_E_LIMIT        (-4)
+
+/** \brief procedure ids of the services of the module */
+#define CIAA_MULTICORE_RPC_PROC_GETRESOURCE     0
+#define CIAA_MULTICORE_RPC_PROC_RELEASERESOURCE 1
+#define CIAA_MULTICORE_RPC_PROC_SETRELALARM     2
+#define CIAA_MULTICORE_RPC_PROC_CANCELALARM     3
+
+/** \brief first procedure id of the user interface */
+#define CIAA_MULTICORE_RPC_PROC_USER            0x10
+
+/** \brief interface list entry to declare the procedure ids */
+#define CIAA_MULTICORE_RPC_ENTRY_ID(name, req, rsp)                     \
+   name##_ID,
+
+/** \brief interface list entry to declare the client and server functions */
+#define CIAA_MULTICORE_RPC_ENTRY_DECLARE(name, req, rsp)                \
+   extern int32_t name(req const * in, ciaaMulticore_rpcDone_t done,    \
+         void * ctx);                                                   \
+   extern int32_t name##_server(req const * in, rsp * out);
+
+/** \brief interface list entry to define the client stub and the server
+ ** adapter */
+#define CIAA_MULTICORE_RPC_ENTRY_DEFINE(name, req, rsp)                 \
+   extern int32_t name(req const * in, ciaaMulticore_rpcDone_t done,    \
+         void * ctx)                                                    \
+   {                                                                    \
+      return ciaaMulticore_rpcCall(CIAA_MULTICORE_RPC_INSTANCE,         \
+            name##_ID, in, sizeof(req), done, ctx);                     \
+   }                                                                    \
+   static int32_t name##_adapter(ciaaMulticore_rpc_t * rpc,           \
+         uint32_t id, void const * in, void * out)                      \
+   {                                                                    \
+      (void)rpc;                                                        \
+      (void)id;                                                         \
+      return name##_server((req const *)in, (rsp *)out);                \
+   }
+
+/** \brief interface list entry of the dispatch table */
+#define CIAA_MULTICORE_RPC_ENTRY_PROC(name, req, rsp)                   \
+   { name##_adapter, sizeof(req), sizeof(rsp) },
+
+/** \brief declare the procedure ids and functions of an interface
+ **
+ ** \param[in] iface name of the interface list macro
+ **/
+#define CIAA_MULTICORE_RPC_DECLARE(iface)                               \
+   enum                                                                 \
+   {                                                                    \
+      iface##_FIRST = CIAA_MULTICORE_RPC_PROC_USER - 1,                 \
+      iface(CIAA_MULTICORE_RPC_ENTRY_ID)                                \
+      iface##_END                                                       \
+   };                                                                   \
+   iface(CIAA_MULTICORE_RPC_ENTRY_DECLARE)                              \
+   extern ciaaMulticore_rpcProc_t const iface##_procs[];
+
+/** \brief define the client stubs and the dispatch table of an interface
+ **
+ ** The stubs call the rpc instance given by the macro
+ ** CIAA_MULTICORE_RPC_INSTANCE, which has to be defined before.
+ **
+ ** \param[in] iface name of the interface list macro
+ **/
+#define CIAA_MULTICORE_RPC_DEFINE(iface)                                \
+   iface(CIAA_MULTICORE_RPC_ENTRY_DEFINE)                               \
+   ciaaMulticore_rpcProc_t const iface##_procs[] =                    \
+   {                                                                    \
+      iface(CIAA_MULTICORE_RPC_ENTRY_PROC)                              \
+   };
+
+/** \brief count of procedures of an interface */
+#define CIAA_MULTICORE_RPC_COUNT(iface)                                 \
+   ( iface##_END - CIAA_MULTICORE_RPC_PROC_USER )
+
+/*==================[typedef]================================================*/
+/** \brief completion callback of a call
+ **
+ ** Called in the context of the processing of the received messages.
+ **
+ ** \param[in] status status returned by the server or CIAA_MULTICORE_RPC_E_*
+ ** \param[in] rsp response of the server, only valid during the callback,
+ **               NULL if the procedure has no response
+ ** \param[in] ctx context given to the call
+ **/
+typedef void (*ciaaMulticore_rpcDone_t)(int32_t status, void const * rsp,
+      void * ctx);
+
+/** \brief rpc instance type */
+typedef struct ciaaMulticore_rpcStruct ciaaMulticore_rpc_t;
+
+/** \brief server function of a procedure
+ **
+ ** \param[inout] rpc instance which received the request
+ ** \param[in] id correlation id of the request, to be given to
+ **               ciaaMulticore_rpcRespond if CIAA_MULTICORE_RPC_DEFERRED is
+ **               returned
+ ** \param[in] req request, NULL if the procedure has no request
+ ** \param[out] rsp response, NULL if the procedure has no response
+ ** \return status to be sent to the caller
+ **/
+typedef int32_t (*ciaaMulticore_rpcServer_t)(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, void const * req, void * rsp);
+
+/** \brief dispatch table entry */
+typedef struct
+{
+   ciaaMulticore_rpcServer_t server;   /** <= server function */
+   uint16_t reqSize;                   /** <= size of the request */
+   uint16_t rspSize;                   /** <= size of the response */
+} ciaaMulticore_rpcProc_t;
+
+/** \brief pending call or request waiting for a resource */
+typedef struct
+{
+   uint32_t id;                  /** <= correlation id */
+   ciaaMulticore_rpcDone_t done; /** <= completion callback, NULL if free
+                                      (calls) or remote (waiters) */
+   void * ctx;                   /** <= context of the callback */
+} ciaaMulticore_rpcPending_t;
+
+/** \brief inter-core resource */
+typedef struct
+{
+   uint8_t holder;               /** <= core which holds the resource */
+   uint8_t head;                 /** <= first waiter */
+   uint8_t count;                /** <= count of waiters */
+   ciaaMulticore_rpcPending_t waiters[CIAA_MULTICORE_RPC_WAITERS];
+} ciaaMulticore_rpcResource_t;
+
+/** \brief rpc instance, one for each core */
+struct ciaaMulticore_rpcStruct
+{
+   ciaaMulticore_ipcChannel_t * tx;    /** <= channel to the remote core */
+   void (*signal)(void);               /** <= signal the remote core */
+   uint16_t core;                      /** <= id of this core */
+   uint16_t arbiter;                   /** <= 1 if the resources are
+                                            arbitrated by this core */
+   ciaaMulticore_rpcProc_t const * procs; /** <= user dispatch table */
+   uint32_t procsCount;                /** <= entries of procs */
+   uint32_t seq;                       /** <= sequence of the calls */
+   uint32_t dropped;                   /** <= messages which could not be
+                                            sent or were not expected */
+   ciaaMulticore_rpcPending_t pending[CIAA_MULTICORE_RPC_PENDING];
+   ciaaMulticore_rpcResource_t resources[CIAA_MULTICORE_RPC_RESOURCES];
+};
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief initialize a rpc instance
+ **
+ ** \param[out] rpc instance to be initialized
+ ** \param[in] tx channel of the messages sent to the remote core
+ ** \param[in] signal function to signal the remote core
+ ** \param[in] core id of this core
+ ** \param[in] arbiter 1 if this core arbitrates the inter-core resources,
+ **                    only one of both cores shall do it
+ **/
+extern void ciaaMulticore_rpcInit(ciaaMulticore_rpc_t * rpc,
+      ciaaMulticore_ipcChannel_t * tx, void (*signal)(void), uint16_t core,
+      uint16_t arbiter);
+
+/** \brief set the dispatch table of the procedures served by this core
+ **
+ ** \param[inout] rpc rpc instance
+ ** \param[in] procs dispatch table, entry 0 is CIAA_MULTICORE_RPC_PROC_USER
+ ** \param[in] count count of entries
+ **/
+extern void ciaaMulticore_rpcSetInterface(ciaaMulticore_rpc_t * rpc,
+      ciaaMulticore_rpcProc_t const * procs, uint32_t count);
+
+/** \brief call a remote procedure
+ **
+ ** The request is copied to a payload buffer and the remote core is
+ ** signaled.
+ **
+ ** \param[inout] rpc rpc instance
+ ** \param[in] proc procedure id
+ ** \param[in] req request or NULL
+ ** \param[in] size size of the request
+ ** \param[in] done completion callback, NULL if no response is expected
+ ** \param[in] ctx context of the callback
+ ** \return 1 on success, -1 if too many calls are pending or the channel is
+ **         full
+ **/
+extern int32_t ciaaMulticore_rpcCall(ciaaMulticore_rpc_t * rpc,
+      uint32_t proc, void const * req, size_t size,
+      ciaaMulticore_rpcDone_t done, void * ctx);
+
+/** \brief process a received rpc message
+ **
+ ** Executes the requests and completes the pending calls. The responses are
+ ** posted but not published, ciaaMulticore_rpcFlush shall be called after
+ ** processing all the received messages.
+ **
+ ** \param[inout] rpc rpc instance
+ ** \param[in] desc received descriptor of type CIAA_MULTICORE_RPC_MSG_REQ
+ **                 or CIAA_MULTICORE_RPC_MSG_RSP
+ ** \param[in] payload received payload or NULL, still owned by the caller
+ **/
+extern void ciaaMulticore_rpcReceive(ciaaMulticore_rpc_t * rpc,
+      ciaaMulticore_ipcDesc_t const * desc, void * payload);
+
+/** \brief publish the posted responses and signal the remote core
+ **
+ ** \param[inout] rpc rpc instance
+ ** \return count of published messages
+ **/
+extern uint32_t ciaaMulticore_rpcFlush(ciaaMulticore_rpc_t * rpc);
+
+/** \brief respond a request whose server returned CIAA_MULTICORE_RPC_DEFERRED
+ **
+ ** The response is published immediately.
+ **
+ ** \param[inout] rpc rpc instance
+ ** \param[in] id correlation id given to the server
+ ** \param[in] proc procedure id
+ ** \param[in] status status to be sent
+ ** \param[in] rsp response or NULL
+ ** \param[in] size size of the response
+ ** \return 1 on success, -1 if the response could not be sent
+ **/
+extern int32_t ciaaMulticore_rpcRespond(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, uint32_t proc, int32_t status, void const * rsp,
+      size_t size);
+
+/** \brief get an inter-core resource
+ **
+ ** The resource is granted when the completion callback is called with
+ ** CIAA_MULTICORE_RPC_OK, which happens before returning if the resource
+ ** is free and arbitrated by this core. The tasks of a core are not
+ ** distinguished, a resource held by a core may be released by any of its
+ ** tasks.
+ **
+ ** \param[inout] rpc rpc instance
+ ** \param[in] res resource, lower than CIAA_MULTICORE_RPC_RESOURCES
+ ** \param[in] done completion callback
+ ** \param[in] ctx context of the callback
+ ** \return 1 on success, -1 on error
+ **/
+extern int32_t ciaaMulticore_rpcGetResource(ciaaMulticore_rpc_t * rpc,
+      uint32_t res, ciaaMulticore_rpcDone_t done, void * ctx);
+
+/** \brief release an inter-core resource held by this core
+ **
+ ** \param[inout] rpc rpc instance
+ ** \param[in] res resource
+ ** \return 1 on success, -1 on error
+ **/
+extern int32_t ciaaMulticore_rpcReleaseResource(ciaaMulticore_rpc_t * rpc,
+      uint32_t res);
+
+/** \brief call SetRelAlarm on the remote core
+ **
+ ** \param[inout] rpc rpc instance
+ ** \param[in] alarm alarm of the remote core
+ ** \param[in] increment relative value in ticks
+ ** \param[in] cycle cycle value in ticks, 0 for single alarms
+ ** \param[in] done completion callback, the status is the StatusType
+ **                 returned by SetRelAlarm, NULL if it is not needed
+ ** \param[in] ctx context of the callback
+ ** \return 1 on success, -1 on error
+ **/
+extern int32_t ciaaMulticore_rpcSetRelAlarm(ciaaMulticore_rpc_t * rpc,
+      uint32_t alarm, uint32_t increment, uint32_t cycle,
+      ciaaMulticore_rpcDone_t done, void * ctx);
+
+/** \brief call CancelAlarm on the remote core
+ **
+ ** \param[inout] rpc rpc instance
+ ** \param[in] alarm alarm of the remote core
+ ** \param[in] done completion callback, the status is the StatusType
+ **                 returned by CancelAlarm, NULL if it is not needed
+ ** \param[in] ctx context of the callback
+ ** \return 1 on success, -1 on error
+ **/
+extern int32_t ciaaMulticore_rpcCancelAlarm(ciaaMulticore_rpc_t * rpc,
+      uint32_t alarm, ciaaMulticore_rpcDone_t done, void * ctx);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef MULTICORE_RPC_H */
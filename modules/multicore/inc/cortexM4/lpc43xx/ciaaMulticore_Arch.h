@@ -54,6 +54,9 @@ extern "C" {
 
 /*==================[macros]=================================================*/
 
+/** \brief core running this image */
+#define CIAA_MULTICORE_CORE_ID CIAA_MULTICORE_CORE_0
+
 /*==================[typedef]================================================*/
 
 /*==================[external data declaration]==============================*/
@@ -57,44 +57,124 @@
 #include "ciaaPOSIX_stdlib.h"
 #include "ciaaPOSIX_stddef.h"
 #include "ciaaMulticore.h"
-#include "ciaaLibs_CircBuf.h"
+#include "ciaaMulticore_Ipc.h"
+#include "ciaaMulticore_Rpc.h"
 #include "os.h"
 #include "ciaaMulticore_Arch.h"
 
 /*==================[macros and definitions]=================================*/
 
-#define CIAA_MULTICORE_CORE_1_IMAGE ((uint8_t *)0x1B000000)
+/** \brief channel of the messages received by this core */
+#define CIAA_MULTICORE_RX_CHANNEL (&ciaaMulticore_ipcChannels[CIAA_MULTICORE_CORE_ID])
 
-#define CIAA_MULTICORE_IPC_QUEUE_ADDR ((void *)0x20008000)
-
-#define CIAA_MULTICORE_IPC_QUEUE_LEN (1024)
+/** \brief channel of the messages sent by this core */
+#define CIAA_MULTICORE_TX_CHANNEL (&ciaaMulticore_ipcChannels[1 - CIAA_MULTICORE_CORE_ID])
 
 /*==================[internal data declaration]==============================*/
 
 /*==================[internal functions declaration]=========================*/
 
+/** \brief signal the other core, used by the rpc instance */
+static void ciaaMulticore_rpcSignal(void);
+
 /*==================[internal data definition]===============================*/
 
+/** \brief callback for the user messages */
+static ciaaMulticore_msgCallback_t ciaaMulticore_msgCallback = NULL;
+
 /*==================[external data definition]===============================*/
 
+ciaaMulticore_rpc_t ciaaMulticore_rpc;
+
 /*==================[internal functions definition]==========================*/
 
+static void ciaaMulticore_rpcSignal(void)
+{
+   (void)ciaaMulticore_sendSignal_Arch();
+}
+
 /*==================[external functions definition]==========================*/
 
 extern int32_t ciaaMulticore_init(void)
 {
    int32_t rv = -1;
 
+   /* the rpc instance has to be ready before the other core runs, the
+    * resources are arbitrated by the core 0 */
+   ciaaMulticore_rpcInit(&ciaaMulticore_rpc, CIAA_MULTICORE_TX_CHANNEL,
+         ciaaMulticore_rpcSignal, CIAA_MULTICORE_CORE_ID,
+         (CIAA_MULTICORE_CORE_0 == CIAA_MULTICORE_CORE_ID) ? 1 : 0);
+
    rv = ciaaMulticore_init_Arch();
 
    return rv;
 }
 
+extern void * ciaaMulticore_alloc(size_t size)
+{
+   void * rv;
+
+   /* the tx channel is shared with the responses posted by the inter-core
+    * interrupt handler */
+   SuspendOSInterrupts();
+   rv = ciaaMulticore_ipcAlloc(CIAA_MULTICORE_TX_CHANNEL, size);
+   ResumeOSInterrupts();
+
+   return rv;
+}
+
+extern int32_t ciaaMulticore_post(ciaaMulticore_ipcDesc_t const * desc, void * payload)
+{
+   int32_t rv = -1;
+
+   /* the reserved types would be handled by the other core as OSEK or rpc
+    * messages */
+   if(CIAA_MULTICORE_MSG_USER <= desc->type)
+   {
+      SuspendOSInterrupts();
+      rv = ciaaMulticore_ipcPost(CIAA_MULTICORE_TX_CHANNEL, desc, payload);
+      ResumeOSInterrupts();
+   }
+
+   return rv;
+}
+
+extern uint32_t ciaaMulticore_flush(void)
+{
+   uint32_t rv;
+
+   SuspendOSInterrupts();
+   rv = ciaaMulticore_ipcFlush(CIAA_MULTICORE_TX_CHANNEL);
+   ResumeOSInterrupts();
+
+   /* one signal for all the published messages */
+   if(rv > 0)
+   {
+      ciaaMulticore_sendSignal_Arch();
+   }
+
+   return rv;
+}
+
 extern int32_t ciaaMulticore_sendMessage(ciaaMulticore_ipcMsg_t m)
 {
    int32_t rv = -1;
+   ciaaMulticore_ipcDesc_t desc;
 
-   rv = ciaaLibs_circBufPut(ipc_queue, &m, sizeof(ciaaMulticore_ipcMsg_t));
+   desc.type = CIAA_MULTICORE_MSG_OSEK;
+   desc.src = CIAA_MULTICORE_CORE_ID;
+   desc.len = 0;
+   desc.id = m.id.pid;
+   desc.data0 = m.data0;
+   desc.data1 = m.data1;
+
+   SuspendOSInterrupts();
+   rv = ciaaMulticore_ipcPost(CIAA_MULTICORE_TX_CHANNEL, &desc, NULL);
+   if(rv > 0)
+   {
+      (void)ciaaMulticore_ipcFlush(CIAA_MULTICORE_TX_CHANNEL);
+   }
+   ResumeOSInterrupts();
 
    if(rv > 0)
    {
@@ -107,15 +187,108 @@ extern int32_t ciaaMulticore_sendMessage(ciaaMulticore_ipcMsg_t m)
 extern int32_t ciaaMulticore_recvMessage(ciaaMulticore_ipcMsg_t * m)
 {
    int32_t rv = -1;
+   ciaaMulticore_ipcDesc_t desc;
+   void * payload;
+   int32_t received;
 
-   if(!ciaaLibs_circBufEmpty(ipc_queue))
+   /* the rx channel is also read by the inter-core interrupt handler */
+   SuspendOSInterrupts();
+   received = ciaaMulticore_ipcRecv(CIAA_MULTICORE_RX_CHANNEL, &desc, &payload);
+   /* the message format has no payload */
+   if((received > 0) && (NULL != payload))
    {
-      rv = ciaaLibs_circBufGet(ipc_queue, m, sizeof(ciaaMulticore_ipcMsg_t));
+      ciaaMulticore_ipcRelease(CIAA_MULTICORE_RX_CHANNEL, payload);
+   }
+   ResumeOSInterrupts();
+
+   if(received > 0)
+   {
+      m->id.cpuid = desc.src;
+      m->id.pid = desc.id;
+      m->data0 = desc.data0;
+      m->data1 = desc.data1;
+
+      rv = sizeof(ciaaMulticore_ipcMsg_t);
    }
 
    return rv;
 }
 
+extern void ciaaMulticore_setMsgCallback(ciaaMulticore_msgCallback_t cb)
+{
+   ciaaMulticore_msgCallback = cb;
+}
+
+extern uint32_t ciaaMulticore_processMessages(void)
+{
+   uint32_t count = 0;
+   ciaaMulticore_ipcDesc_t desc;
+   ciaaMulticore_ipcMsg_t m;
+   void * payload;
+
+   /* one signal may cover many messages, process all of them */
+   while(ciaaMulticore_ipcRecv(CIAA_MULTICORE_RX_CHANNEL, &desc, &payload) > 0)
+   {
+      if(CIAA_MULTICORE_MSG_OSEK == desc.type)
+      {
+         m.id.cpuid = desc.src;
+         m.id.pid = desc.id;
+         m.data0 = desc.data0;
+         m.data1 = desc.data1;
+         ciaaMulticore_dispatch_OSEK_API(m);
+      }
+      else if((CIAA_MULTICORE_MSG_RPC_REQ == desc.type) ||
+              (CIAA_MULTICORE_MSG_RPC_RSP == desc.type))
+      {
+         ciaaMulticore_rpcReceive(&ciaaMulticore_rpc, &desc, payload);
+      }
+      else if((CIAA_MULTICORE_MSG_USER <= desc.type) &&
+              (NULL != ciaaMulticore_msgCallback))
+      {
+         ciaaMulticore_msgCallback(&desc, payload);
+      }
+
+      if(NULL != payload)
+      {
+         ciaaMulticore_ipcRelease(CIAA_MULTICORE_RX_CHANNEL, payload);
+      }
+
+      count++;
+   }
+
+   /* one signal for all the responses */
+   (void)ciaaMulticore_rpcFlush(&ciaaMulticore_rpc);
+
+   return count;
+}
+
+extern void ciaaMulticore_setInterface(ciaaMulticore_rpcProc_t const * procs, uint32_t count)
+{
+   ciaaMulticore_rpcSetInterface(&ciaaMulticore_rpc, procs, count);
+}
+
+extern int32_t ciaaMulticore_getResource(uint32_t res, ciaaMulticore_rpcDone_t done, void * ctx)
+{
+   return ciaaMulticore_rpcGetResource(&ciaaMulticore_rpc, res, done, ctx);
+}
+
+extern int32_t ciaaMulticore_releaseResource(uint32_t res)
+{
+   return ciaaMulticore_rpcReleaseResource(&ciaaMulticore_rpc, res);
+}
+
+extern int32_t ciaaMulticore_setRelAlarm(uint32_t alarm, uint32_t increment,
+      uint32_t cycle, ciaaMulticore_rpcDone_t done, void * ctx)
+{
+   return ciaaMulticore_rpcSetRelAlarm(&ciaaMulticore_rpc, alarm, increment,
+         cycle, done, ctx);
+}
+
+extern int32_t ciaaMulticore_cancelAlarm(uint32_t alarm, ciaaMulticore_rpcDone_t done, void * ctx)
+{
+   return ciaaMulticore_rpcCancelAlarm(&ciaaMulticore_rpc, alarm, done, ctx);
+}
+
 extern int32_t ciaaMulticore_dispatch_OSEK_API(ciaaMulticore_ipcMsg_t m)
 {
    int32_t rv = -1;
@@ -0,0 +1,235 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief Multicore inter-processor communication channels source file.
+ **
+ ** The channels do not depend on the ARCH, signaling the other core is done
+ ** by the caller, see ciaaMulticore.c.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Multicore Multicore module
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaMulticore_Ipc.h"
+#include "ciaaPOSIX_stdlib.h"
+#include "ciaaPOSIX_stdint.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief get the index of a payload buffer */
+#define ciaaMulticore_ipcBufIndex(ch, payload)                          \
+   ( (uint16_t)( ( (uintptr_t)(payload) - (uintptr_t)(ch)->pool ) /      \
+                 sizeof((ch)->pool[0]) ) )
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/** \brief move the buffers released by the receiver to the free list
+ **
+ ** \param[inout] ch pointer to the channel
+ **/
+static void ciaaMulticore_ipcReclaim(ciaaMulticore_ipcChannel_t * ch);
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void ciaaMulticore_ipcReclaim(ciaaMulticore_ipcChannel_t * ch)
+{
+   /* relTail may be changed by the receiver, therefore it has to be read
+    * only once */
+   uint32_t tail = ch->relTail;
+
+   /* read the released entries after the tail */
+   ciaaMulticore_ipcBarrier();
+
+   while (ch->relHead != tail)
+   {
+      ch->freeList[ch->freeCount] =
+         ch->rel[ch->relHead & (CIAA_MULTICORE_IPC_BUF_COUNT - 1)];
+      ch->freeCount++;
+      ch->relHead++;
+   }
+}
+
+/*==================[external functions definition]==========================*/
+extern void ciaaMulticore_ipcInit(ciaaMulticore_ipcChannel_t * ch)
+{
+   uint16_t i;
+
+   ch->descTail = 0;
+   ch->descWr = 0;
+   ch->descHead = 0;
+   ch->relHead = 0;
+   ch->relTail = 0;
+
+   /* all buffers are free */
+   for (i = 0; i < CIAA_MULTICORE_IPC_BUF_COUNT; i++)
+   {
+      ch->freeList[i] = CIAA_MULTICORE_IPC_BUF_COUNT - 1 - i;
+   }
+   ch->freeCount = CIAA_MULTICORE_IPC_BUF_COUNT;
+
+   ciaaMulticore_ipcBarrier();
+} /* end ciaaMulticore_ipcInit */
+
+extern void * ciaaMulticore_ipcAlloc(ciaaMulticore_ipcChannel_t * ch, size_t size)
+{
+   void * ret = NULL;
+
+   if (CIAA_MULTICORE_IPC_BUF_SIZE >= size)
+   {
+      /* only look at the released buffers if needed */
+      if (0 == ch->freeCount)
+      {
+         ciaaMulticore_ipcReclaim(ch);
+      }
+
+      if (0 < ch->freeCount)
+      {
+         ch->freeCount--;
+         ret = (void *) ch->pool[ch->freeList[ch->freeCount]];
+      }
+   }
+
+   return ret;
+} /* end ciaaMulticore_ipcAlloc */
+
+extern void ciaaMulticore_ipcFree(ciaaMulticore_ipcChannel_t * ch, void * payload)
+{
+   ch->freeList[ch->freeCount] = ciaaMulticore_ipcBufIndex(ch, payload);
+   ch->freeCount++;
+} /* end ciaaMulticore_ipcFree */
+
+extern int32_t ciaaMulticore_ipcPost(ciaaMulticore_ipcChannel_t * ch,
+      ciaaMulticore_ipcDesc_t const * desc, void * payload)
+{
+   int32_t ret = -1;
+   ciaaMulticore_ipcDesc_t * slot;
+
+   /* descHead may be changed by the receiver, therefore it has to be read
+    * only once */
+   uint32_t head = ch->descHead;
+
+   if (CIAA_MULTICORE_IPC_DESC_COUNT > (ch->descWr - head))
+   {
+      slot = &ch->desc[ch->descWr & (CIAA_MULTICORE_IPC_DESC_COUNT - 1)];
+      *slot = *desc;
+
+      if (NULL != payload)
+      {
+         slot->buf = ciaaMulticore_ipcBufIndex(ch, payload);
+      }
+      else
+      {
+         slot->buf = CIAA_MULTICORE_IPC_NOBUF;
+         slot->len = 0;
+      }
+
+      ch->descWr++;
+
+      ret = 1;
+   }
+
+   return ret;
+} /* end ciaaMulticore_ipcPost */
+
+extern uint32_t ciaaMulticore_ipcFlush(ciaaMulticore_ipcChannel_t * ch)
+{
+   uint32_t ret = ch->descWr - ch->descTail;
+
+   if (0 < ret)
+   {
+      /* descriptors and payloads have to be visible before the tail */
+      ciaaMulticore_ipcBarrier();
+
+      ch->descTail = ch->descWr;
+   }
+
+   return ret;
+} /* end ciaaMulticore_ipcFlush */
+
+extern int32_t ciaaMulticore_ipcRecv(ciaaMulticore_ipcChannel_t * ch,
+      ciaaMulticore_ipcDesc_t * desc, void ** payload)
+{
+   int32_t ret = 0;
+   uint32_t head = ch->descHead;
+
+   if (head != ch->descTail)
+   {
+      /* read the descriptor after the tail */
+      ciaaMulticore_ipcBarrier();
+
+      *desc = ch->desc[head & (CIAA_MULTICORE_IPC_DESC_COUNT - 1)];
+
+      if (CIAA_MULTICORE_IPC_NOBUF != desc->buf)
+      {
+         *payload = (void *) ch->pool[desc->buf];
+      }
+      else
+      {
+         *payload = NULL;
+      }
+
+      /* the descriptor has to be read before the sender can overwrite it */
+      ciaaMulticore_ipcBarrier();
+
+      ch->descHead = head + 1;
+
+      ret = 1;
+   }
+
+   return ret;
+} /* end ciaaMulticore_ipcRecv */
+
+extern void ciaaMulticore_ipcRelease(ciaaMulticore_ipcChannel_t * ch, void * payload)
+{
+   uint32_t tail = ch->relTail;
+
+   /* the ring can not overflow, each buffer is released only once */
+   ch->rel[tail & (CIAA_MULTICORE_IPC_BUF_COUNT - 1)] =
+      ciaaMulticore_ipcBufIndex(ch, payload);
+
+   ciaaMulticore_ipcBarrier();
+
+   ch->relTail = tail + 1;
+} /* end ciaaMulticore_ipcRelease */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
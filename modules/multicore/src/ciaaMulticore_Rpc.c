@@ -0,0 +1,670 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief Multicore remote procedure calls source file.
+ **
+ ** The rpc instances do not depend on the ARCH, the channels and the
+ ** function to signal the remote core are given by ciaaMulticore.c.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Multicore Multicore module
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaMulticore_Rpc.h"
+#include "ciaaMulticore_Ipc.h"
+#include "ciaaPOSIX_stdlib.h"
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_string.h"
+#include "os.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief bits of the correlation id used for the pending slot */
+#define CIAA_MULTICORE_RPC_SLOT_BITS      8
+
+/** \brief mask of the pending slot of a correlation id */
+#define CIAA_MULTICORE_RPC_SLOT_MASK      ( (1UL << CIAA_MULTICORE_RPC_SLOT_BITS) - 1 )
+
+/** \brief holders of an inter-core resource */
+#define CIAA_MULTICORE_RPC_HOLDER_NONE    0
+#define CIAA_MULTICORE_RPC_HOLDER_LOCAL   1
+#define CIAA_MULTICORE_RPC_HOLDER_REMOTE  2
+
+/** \brief count of services provided by the module */
+#define CIAA_MULTICORE_RPC_SERVICES       \
+   ( sizeof(ciaaMulticore_rpcServices) / sizeof(ciaaMulticore_rpcServices[0]) )
+
+/** \brief request of the remote SetRelAlarm */
+typedef struct
+{
+   uint32_t alarm;
+   uint32_t increment;
+   uint32_t cycle;
+} ciaaMulticore_rpcAlarmReq_t;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/** \brief get a payload buffer of the tx channel
+ **
+ ** \param[inout] rpc rpc instance
+ ** \param[in] size size in bytes, may be 0
+ ** \return pointer to the buffer, NULL if size is 0 or no buffer is available
+ **/
+static void * ciaaMulticore_rpcAlloc(ciaaMulticore_rpc_t * rpc, size_t size);
+
+/** \brief post a message to the tx channel without publishing it
+ **
+ ** On error the payload is given back to the channel.
+ **
+ ** \param[inout] rpc rpc instance
+ ** \param[in] type CIAA_MULTICORE_RPC_MSG_REQ or CIAA_MULTICORE_RPC_MSG_RSP
+ ** \param[in] id correlation id
+ ** \param[in] proc procedure id
+ ** \param[in] status status of the responses
+ ** \param[in] payload payload or NULL
+ ** \param[in] size size of the payload
+ ** \return 1 on success, -1 on error
+ **/
+static int32_t ciaaMulticore_rpcPost(ciaaMulticore_rpc_t * rpc,
+      uint16_t type, uint32_t id, uint32_t proc, int32_t status,
+      void * payload, size_t size);
+
+/** \brief copy a request or response to a payload buffer and post it
+ **
+ ** \return 1 on success, -1 on error
+ **/
+static int32_t ciaaMulticore_rpcSend(ciaaMulticore_rpc_t * rpc,
+      uint16_t type, uint32_t id, uint32_t proc, int32_t status,
+      void const * data, size_t size);
+
+/** \brief execute a received request and post its response */
+static void ciaaMulticore_rpcServe(ciaaMulticore_rpc_t * rpc,
+      ciaaMulticore_ipcDesc_t const * desc, void * payload);
+
+/** \brief complete the pending call of a received response */
+static void ciaaMulticore_rpcComplete(ciaaMulticore_rpc_t * rpc,
+      ciaaMulticore_ipcDesc_t const * desc, void * payload);
+
+/** \brief take an inter-core resource or wait for it (arbiter)
+ **
+ ** \return CIAA_MULTICORE_RPC_OK if taken, CIAA_MULTICORE_RPC_DEFERRED if
+ **         waiting, CIAA_MULTICORE_RPC_E_LIMIT if too many requests wait
+ **/
+static int32_t ciaaMulticore_rpcAcquire(ciaaMulticore_rpc_t * rpc,
+      uint32_t res, uint32_t id, ciaaMulticore_rpcDone_t done, void * ctx);
+
+/** \brief give an inter-core resource to the next waiter (arbiter)
+ **
+ ** \return CIAA_MULTICORE_RPC_OK or CIAA_MULTICORE_RPC_E_LIMIT if the
+ **         resource is not held by holder
+ **/
+static int32_t ciaaMulticore_rpcPass(ciaaMulticore_rpc_t * rpc,
+      uint32_t res, uint8_t holder);
+
+/** \brief servers of the services provided by the module */
+static int32_t ciaaMulticore_rpcGetResourceServer(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, void const * req, void * rsp);
+static int32_t ciaaMulticore_rpcReleaseResourceServer(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, void const * req, void * rsp);
+static int32_t ciaaMulticore_rpcSetRelAlarmServer(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, void const * req, void * rsp);
+static int32_t ciaaMulticore_rpcCancelAlarmServer(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, void const * req, void * rsp);
+
+/*==================[internal data definition]===============================*/
+/** \brief dispatch table of the services, indexed by
+ ** CIAA_MULTICORE_RPC_PROC_* */
+static ciaaMulticore_rpcProc_t const ciaaMulticore_rpcServices[] =
+{
+   { ciaaMulticore_rpcGetResourceServer, sizeof(uint32_t), 0 },
+   { ciaaMulticore_rpcReleaseResourceServer, sizeof(uint32_t), 0 },
+   { ciaaMulticore_rpcSetRelAlarmServer, sizeof(ciaaMulticore_rpcAlarmReq_t), 0 },
+   { ciaaMulticore_rpcCancelAlarmServer, sizeof(uint32_t), 0 },
+};
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void * ciaaMulticore_rpcAlloc(ciaaMulticore_rpc_t * rpc, size_t size)
+{
+   void * ret = NULL;
+
+   if (0 < size)
+   {
+      /* the channel is shared by the tasks and the interrupt handler */
+      SuspendOSInterrupts();
+      ret = ciaaMulticore_ipcAlloc(rpc->tx, size);
+      ResumeOSInterrupts();
+   }
+
+   return ret;
+}
+
+static int32_t ciaaMulticore_rpcPost(ciaaMulticore_rpc_t * rpc,
+      uint16_t type, uint32_t id, uint32_t proc, int32_t status,
+      void * payload, size_t size)
+{
+   int32_t ret;
+   ciaaMulticore_ipcDesc_t desc;
+
+   desc.type = type;
+   desc.src = rpc->core;
+   desc.len = (uint16_t)size;
+   desc.id = id;
+   desc.data0 = proc;
+   desc.data1 = (uint32_t)status;
+
+   SuspendOSInterrupts();
+   ret = ciaaMulticore_ipcPost(rpc->tx, &desc, payload);
+   if ( (0 > ret) && (NULL != payload) )
+   {
+      ciaaMulticore_ipcFree(rpc->tx, payload);
+   }
+   ResumeOSInterrupts();
+
+   if (0 > ret)
+   {
+      rpc->dropped++;
+   }
+
+   return ret;
+}
+
+static int32_t ciaaMulticore_rpcSend(ciaaMulticore_rpc_t * rpc,
+      uint16_t type, uint32_t id, uint32_t proc, int32_t status,
+      void const * data, size_t size)
+{
+   int32_t ret = -1;
+   void * payload = NULL;
+
+   if ( (NULL == data) || (0 == size) )
+   {
+      size = 0;
+   }
+   else
+   {
+      payload = ciaaMulticore_rpcAlloc(rpc, size);
+   }
+
+   if ( (0 == size) || (NULL != payload) )
+   {
+      if (NULL != payload)
+      {
+         ciaaPOSIX_memcpy(payload, data, size);
+      }
+
+      ret = ciaaMulticore_rpcPost(rpc, type, id, proc, status, payload, size);
+   }
+
+   return ret;
+}
+
+static void ciaaMulticore_rpcServe(ciaaMulticore_rpc_t * rpc,
+      ciaaMulticore_ipcDesc_t const * desc, void * payload)
+{
+   ciaaMulticore_rpcProc_t const * entry = NULL;
+   void * rsp = NULL;
+   size_t rspSize = 0;
+   int32_t status;
+
+   if (CIAA_MULTICORE_RPC_SERVICES > desc->data0)
+   {
+      entry = &ciaaMulticore_rpcServices[desc->data0];
+   }
+   else if ( (CIAA_MULTICORE_RPC_PROC_USER <= desc->data0) &&
+             (rpc->procsCount > (desc->data0 - CIAA_MULTICORE_RPC_PROC_USER)) )
+   {
+      entry = &rpc->procs[desc->data0 - CIAA_MULTICORE_RPC_PROC_USER];
+   }
+
+   if (NULL == entry)
+   {
+      status = CIAA_MULTICORE_RPC_E_NOPROC;
+   }
+   else if ( (0 < entry->reqSize) &&
+             ( (NULL == payload) || (entry->reqSize > desc->len) ) )
+   {
+      status = CIAA_MULTICORE_RPC_E_LIMIT;
+   }
+   else
+   {
+      /* the response is written directly to the payload buffer to be sent */
+      rspSize = entry->rspSize;
+      rsp = ciaaMulticore_rpcAlloc(rpc, rspSize);
+
+      if ( (0 < rspSize) && (NULL == rsp) )
+      {
+         status = CIAA_MULTICORE_RPC_E_NOBUF;
+      }
+      else
+      {
+         status = entry->server(rpc, desc->id, payload, rsp);
+      }
+   }
+
+   if ( (CIAA_MULTICORE_RPC_NOREPLY != desc->id) &&
+        (CIAA_MULTICORE_RPC_DEFERRED != status) )
+   {
+      (void)ciaaMulticore_rpcPost(rpc, CIAA_MULTICORE_RPC_MSG_RSP, desc->id,
+            desc->data0, status, rsp, (NULL != rsp) ? rspSize : 0);
+   }
+   else if (NULL != rsp)
+   {
+      SuspendOSInterrupts();
+      ciaaMulticore_ipcFree(rpc->tx, rsp);
+      ResumeOSInterrupts();
+   }
+}
+
+static void ciaaMulticore_rpcComplete(ciaaMulticore_rpc_t * rpc,
+      ciaaMulticore_ipcDesc_t const * desc, void * payload)
+{
+   uint32_t slot = desc->id & CIAA_MULTICORE_RPC_SLOT_MASK;
+   ciaaMulticore_rpcDone_t done = NULL;
+   void * ctx = NULL;
+
+   SuspendOSInterrupts();
+   if ( (CIAA_MULTICORE_RPC_PENDING > slot) &&
+        (NULL != rpc->pending[slot].done) &&
+        (desc->id == rpc->pending[slot].id) )
+   {
+      done = rpc->pending[slot].done;
+      ctx = rpc->pending[slot].ctx;
+
+      /* the slot is free before the callback, so it may call again */
+      rpc->pending[slot].done = NULL;
+   }
+   ResumeOSInterrupts();
+
+   if (NULL != done)
+   {
+      done((int32_t)desc->data1, payload, ctx);
+   }
+   else
+   {
+      /* response of an unknown call */
+      rpc->dropped++;
+   }
+}
+
+static int32_t ciaaMulticore_rpcAcquire(ciaaMulticore_rpc_t * rpc,
+      uint32_t res, uint32_t id, ciaaMulticore_rpcDone_t done, void * ctx)
+{
+   int32_t ret = CIAA_MULTICORE_RPC_E_LIMIT;
+   ciaaMulticore_rpcResource_t * resource = &rpc->resources[res];
+   ciaaMulticore_rpcPending_t * waiter;
+
+   SuspendOSInterrupts();
+   if (CIAA_MULTICORE_RPC_HOLDER_NONE == resource->holder)
+   {
+      resource->holder = (NULL != done) ? CIAA_MULTICORE_RPC_HOLDER_LOCAL :
+                                          CIAA_MULTICORE_RPC_HOLDER_REMOTE;
+      ret = CIAA_MULTICORE_RPC_OK;
+   }
+   else if (CIAA_MULTICORE_RPC_WAITERS > resource->count)
+   {
+      waiter = &resource->waiters[(resource->head + resource->count) %
+                                  CIAA_MULTICORE_RPC_WAITERS];
+      waiter->id = id;
+      waiter->done = done;
+      waiter->ctx = ctx;
+      resource->count++;
+      ret = CIAA_MULTICORE_RPC_DEFERRED;
+   }
+   ResumeOSInterrupts();
+
+   return ret;
+}
+
+static int32_t ciaaMulticore_rpcPass(ciaaMulticore_rpc_t * rpc,
+      uint32_t res, uint8_t holder)
+{
+   int32_t ret = CIAA_MULTICORE_RPC_E_LIMIT;
+   ciaaMulticore_rpcResource_t * resource = &rpc->resources[res];
+   ciaaMulticore_rpcPending_t next;
+   uint32_t granted = 0;
+
+   SuspendOSInterrupts();
+   if (holder == resource->holder)
+   {
+      if (0 < resource->count)
+      {
+         next = resource->waiters[resource->head];
+         resource->head = (resource->head + 1) % CIAA_MULTICORE_RPC_WAITERS;
+         resource->count--;
+         resource->holder = (NULL != next.done) ?
+                              CIAA_MULTICORE_RPC_HOLDER_LOCAL :
+                              CIAA_MULTICORE_RPC_HOLDER_REMOTE;
+         granted = 1;
+      }
+      else
+      {
+         resource->holder = CIAA_MULTICORE_RPC_HOLDER_NONE;
+      }
+      ret = CIAA_MULTICORE_RPC_OK;
+   }
+   ResumeOSInterrupts();
+
+   /* notify the new holder outside of the critical section */
+   if (1 == granted)
+   {
+      if (NULL != next.done)
+      {
+         next.done(CIAA_MULTICORE_RPC_OK, NULL, next.ctx);
+      }
+      else
+      {
+         (void)ciaaMulticore_rpcRespond(rpc, next.id,
+               CIAA_MULTICORE_RPC_PROC_GETRESOURCE, CIAA_MULTICORE_RPC_OK,
+               NULL, 0);
+      }
+   }
+
+   return ret;
+}
+
+static int32_t ciaaMulticore_rpcGetResourceServer(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, void const * req, void * rsp)
+{
+   int32_t ret = CIAA_MULTICORE_RPC_E_LIMIT;
+   uint32_t res = *(uint32_t const *)req;
+
+   (void)rsp;
+
+   if ( (1 == rpc->arbiter) && (CIAA_MULTICORE_RPC_RESOURCES > res) &&
+        (CIAA_MULTICORE_RPC_NOREPLY != id) )
+   {
+      ret = ciaaMulticore_rpcAcquire(rpc, res, id, NULL, NULL);
+   }
+
+   return ret;
+}
+
+static int32_t ciaaMulticore_rpcReleaseResourceServer(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, void const * req, void * rsp)
+{
+   int32_t ret = CIAA_MULTICORE_RPC_E_LIMIT;
+   uint32_t res = *(uint32_t const *)req;
+
+   (void)id;
+   (void)rsp;
+
+   if ( (1 == rpc->arbiter) && (CIAA_MULTICORE_RPC_RESOURCES > res) )
+   {
+      ret = ciaaMulticore_rpcPass(rpc, res, CIAA_MULTICORE_RPC_HOLDER_REMOTE);
+   }
+
+   return ret;
+}
+
+static int32_t ciaaMulticore_rpcSetRelAlarmServer(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, void const * req, void * rsp)
+{
+   ciaaMulticore_rpcAlarmReq_t const * alarm = req;
+
+   (void)rpc;
+   (void)id;
+   (void)rsp;
+
+   return (int32_t)SetRelAlarm((AlarmType)alarm->alarm,
+         (TickType)alarm->increment, (TickType)alarm->cycle);
+}
+
+static int32_t ciaaMulticore_rpcCancelAlarmServer(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, void const * req, void * rsp)
+{
+   (void)rpc;
+   (void)id;
+   (void)rsp;
+
+   return (int32_t)CancelAlarm((AlarmType)(*(uint32_t const *)req));
+}
+
+/*==================[external functions definition]==========================*/
+extern void ciaaMulticore_rpcInit(ciaaMulticore_rpc_t * rpc,
+      ciaaMulticore_ipcChannel_t * tx, void (*signal)(void), uint16_t core,
+      uint16_t arbiter)
+{
+   uint32_t i;
+
+   rpc->tx = tx;
+   rpc->signal = signal;
+   rpc->core = core;
+   rpc->arbiter = arbiter;
+   rpc->procs = NULL;
+   rpc->procsCount = 0;
+   rpc->seq = 0;
+   rpc->dropped = 0;
+
+   for (i = 0; i < CIAA_MULTICORE_RPC_PENDING; i++)
+   {
+      rpc->pending[i].done = NULL;
+   }
+
+   for (i = 0; i < CIAA_MULTICORE_RPC_RESOURCES; i++)
+   {
+      rpc->resources[i].holder = CIAA_MULTICORE_RPC_HOLDER_NONE;
+      rpc->resources[i].head = 0;
+      rpc->resources[i].count = 0;
+   }
+} /* end ciaaMulticore_rpcInit */
+
+extern void ciaaMulticore_rpcSetInterface(ciaaMulticore_rpc_t * rpc,
+      ciaaMulticore_rpcProc_t const * procs, uint32_t count)
+{
+   rpc->procs = procs;
+   rpc->procsCount = count;
+} /* end ciaaMulticore_rpcSetInterface */
+
+extern int32_t ciaaMulticore_rpcCall(ciaaMulticore_rpc_t * rpc,
+      uint32_t proc, void const * req, size_t size,
+      ciaaMulticore_rpcDone_t done, void * ctx)
+{
+   int32_t ret = -1;
+   uint32_t id = CIAA_MULTICORE_RPC_NOREPLY;
+   uint32_t slot = 0;
+
+   if (NULL != done)
+   {
+      /* get a pending slot, the id also carries a sequence to detect the
+       * responses of old calls */
+      SuspendOSInterrupts();
+      while ( (CIAA_MULTICORE_RPC_PENDING > slot) &&
+              (NULL != rpc->pending[slot].done) )
+      {
+         slot++;
+      }
+      if (CIAA_MULTICORE_RPC_PENDING > slot)
+      {
+         rpc->seq++;
+         id = (rpc->seq << CIAA_MULTICORE_RPC_SLOT_BITS) | slot;
+         rpc->pending[slot].id = id;
+         rpc->pending[slot].done = done;
+         rpc->pending[slot].ctx = ctx;
+      }
+      ResumeOSInterrupts();
+   }
+
+   if (CIAA_MULTICORE_RPC_PENDING > slot)
+   {
+      ret = ciaaMulticore_rpcSend(rpc, CIAA_MULTICORE_RPC_MSG_REQ, id, proc,
+            CIAA_MULTICORE_RPC_OK, req, size);
+
+      if (0 < ret)
+      {
+         (void)ciaaMulticore_rpcFlush(rpc);
+      }
+      else if (NULL != done)
+      {
+         rpc->pending[slot].done = NULL;
+      }
+   }
+
+   return ret;
+} /* end ciaaMulticore_rpcCall */
+
+extern void ciaaMulticore_rpcReceive(ciaaMulticore_rpc_t * rpc,
+      ciaaMulticore_ipcDesc_t const * desc, void * payload)
+{
+   if (CIAA_MULTICORE_RPC_MSG_REQ == desc->type)
+   {
+      ciaaMulticore_rpcServe(rpc, desc, payload);
+   }
+   else if (CIAA_MULTICORE_RPC_MSG_RSP == desc->type)
+   {
+      ciaaMulticore_rpcComplete(rpc, desc, payload);
+   }
+} /* end ciaaMulticore_rpcReceive */
+
+extern uint32_t ciaaMulticore_rpcFlush(ciaaMulticore_rpc_t * rpc)
+{
+   uint32_t ret;
+
+   /* the tail shall not be published by the task and the interrupt handler
+    * at the same time */
+   SuspendOSInterrupts();
+   ret = ciaaMulticore_ipcFlush(rpc->tx);
+   ResumeOSInterrupts();
+
+   /* one signal for all the published messages */
+   if (0 < ret)
+   {
+      rpc->signal();
+   }
+
+   return ret;
+} /* end ciaaMulticore_rpcFlush */
+
+extern int32_t ciaaMulticore_rpcRespond(ciaaMulticore_rpc_t * rpc,
+      uint32_t id, uint32_t proc, int32_t status, void const * rsp,
+      size_t size)
+{
+   int32_t ret;
+
+   ret = ciaaMulticore_rpcSend(rpc, CIAA_MULTICORE_RPC_MSG_RSP, id, proc,
+         status, rsp, size);
+
+   if (0 < ret)
+   {
+      (void)ciaaMulticore_rpcFlush(rpc);
+   }
+
+   return ret;
+} /* end ciaaMulticore_rpcRespond */
+
+extern int32_t ciaaMulticore_rpcGetResource(ciaaMulticore_rpc_t * rpc,
+      uint32_t res, ciaaMulticore_rpcDone_t done, void * ctx)
+{
+   int32_t ret = -1;
+   int32_t status;
+
+   if ( (CIAA_MULTICORE_RPC_RESOURCES > res) && (NULL != done) )
+   {
+      if (1 == rpc->arbiter)
+      {
+         status = ciaaMulticore_rpcAcquire(rpc, res, 0, done, ctx);
+
+         if (CIAA_MULTICORE_RPC_OK == status)
+         {
+            done(CIAA_MULTICORE_RPC_OK, NULL, ctx);
+         }
+
+         ret = (CIAA_MULTICORE_RPC_E_LIMIT != status) ? 1 : -1;
+      }
+      else
+      {
+         ret = ciaaMulticore_rpcCall(rpc, CIAA_MULTICORE_RPC_PROC_GETRESOURCE,
+               &res, sizeof(res), done, ctx);
+      }
+   }
+
+   return ret;
+} /* end ciaaMulticore_rpcGetResource */
+
+extern int32_t ciaaMulticore_rpcReleaseResource(ciaaMulticore_rpc_t * rpc,
+      uint32_t res)
+{
+   int32_t ret = -1;
+
+   if (CIAA_MULTICORE_RPC_RESOURCES > res)
+   {
+      if (1 == rpc->arbiter)
+      {
+         if (CIAA_MULTICORE_RPC_OK == ciaaMulticore_rpcPass(rpc, res,
+                  CIAA_MULTICORE_RPC_HOLDER_LOCAL))
+         {
+            ret = 1;
+         }
+      }
+      else
+      {
+         /* no response is needed, the next holder is notified by the
+          * arbiter */
+         ret = ciaaMulticore_rpcCall(rpc,
+               CIAA_MULTICORE_RPC_PROC_RELEASERESOURCE, &res, sizeof(res),
+               NULL, NULL);
+      }
+   }
+
+   return ret;
+} /* end ciaaMulticore_rpcReleaseResource */
+
+extern int32_t ciaaMulticore_rpcSetRelAlarm(ciaaMulticore_rpc_t * rpc,
+      uint32_t alarm, uint32_t increment, uint32_t cycle,
+      ciaaMulticore_rpcDone_t done, void * ctx)
+{
+   ciaaMulticore_rpcAlarmReq_t req;
+
+   req.alarm = alarm;
+   req.increment = increment;
+   req.cycle = cycle;
+
+   return ciaaMulticore_rpcCall(rpc, CIAA_MULTICORE_RPC_PROC_SETRELALARM,
+         &req, sizeof(req), done, ctx);
+} /* end ciaaMulticore_rpcSetRelAlarm */
+
+extern int32_t ciaaMulticore_rpcCancelAlarm(ciaaMulticore_rpc_t * rpc,
+      uint32_t alarm, ciaaMulticore_rpcDone_t done, void * ctx)
+{
+   return ciaaMulticore_rpcCall(rpc, CIAA_MULTICORE_RPC_PROC_CANCELALARM,
+         &alarm, sizeof(alarm), done, ctx);
+} /* end ciaaMulticore_rpcCancelAlarm */
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -53,13 +53,13 @@
 #include "ciaaPOSIX_stdlib.h"
 #include "ciaaPOSIX_stddef.h"
 #include "ciaaMulticore.h"
-#include "ciaaLibs_CircBuf.h"
+#include "ciaaMulticore_Ipc.h"
 #include "os.h"
 
 /*==================[macros and definitions]=================================*/
 
+/* two channels of sizeof(ciaaMulticore_ipcChannel_t) bytes each */
 #define CIAA_MULTICORE_IPC_QUEUE_ADDR ((void *)0x20008000)
-#define CIAA_MULTICORE_IPC_QUEUE_LEN (1024)
 
 /*==================[internal data declaration]==============================*/
 
@@ -69,7 +69,8 @@
 
 /*==================[external data definition]===============================*/
 
-ciaaLibs_CircBufType * ipc_queue = (ciaaLibs_CircBufType *)(CIAA_MULTICORE_IPC_QUEUE_ADDR);
+ciaaMulticore_ipcChannel_t * const ciaaMulticore_ipcChannels =
+   (ciaaMulticore_ipcChannel_t *)(CIAA_MULTICORE_IPC_QUEUE_ADDR);
 
 /*==================[internal functions definition]==========================*/
 
@@ -90,16 +91,10 @@ extern int32_t ciaaMulticore_sendSignal_Arch(void)
 
 ISR(M4_IRQHandler)
 {
-   static ciaaMulticore_ipcMsg_t m;
-   static int32_t rv;
-
    LPC_CREG->M4TXEVENT = 0; 	/* ACK */
 
-   rv = ciaaMulticore_recvMessage(&m);
-   if((rv > 0)&&(m.id.cpuid == CIAA_MULTICORE_CORE_1))
-   {
-      ciaaMulticore_dispatch_OSEK_API(m);
-   }
+   /* one signal may cover many messages */
+   ciaaMulticore_processMessages();
 }
 
 /** @} doxygen end group definition */
@@ -59,7 +59,7 @@
 #include "ciaaPOSIX_stdlib.h"
 #include "ciaaPOSIX_stddef.h"
 #include "ciaaMulticore.h"
-#include "ciaaLibs_CircBuf.h"
+#include "ciaaMulticore_Ipc.h"
 #include "os.h"
 
 
@@ -70,10 +70,9 @@
 
 #define CIAA_MULTICORE_CORE_1_IMAGE ((uint8_t *)0x1B000000)
 
+/* two channels of sizeof(ciaaMulticore_ipcChannel_t) bytes each */
 #define CIAA_MULTICORE_IPC_QUEUE_ADDR ((void *)0x20008000)
 
-#define CIAA_MULTICORE_IPC_QUEUE_LEN (1024)
-
 
 
 /*==================[internal data declaration]==============================*/
@@ -92,7 +91,8 @@
 
 
 
-ciaaLibs_CircBufType * ipc_queue = (ciaaLibs_CircBufType *)(CIAA_MULTICORE_IPC_QUEUE_ADDR);
+ciaaMulticore_ipcChannel_t * const ciaaMulticore_ipcChannels =
+   (ciaaMulticore_ipcChannel_t *)(CIAA_MULTICORE_IPC_QUEUE_ADDR);
 
 
 
@@ -106,24 +106,16 @@ ciaaLibs_CircBufType * ipc_queue = (ciaaLibs_CircBufType *)(CIAA_MULTICORE_IPC_Q
 
 extern int32_t ciaaMulticore_init_Arch(void)
 {
-   int32_t rv = -1;
-
-   /* Init IPC queue, only in master core */
-   rv = ciaaLibs_circBufInit(ipc_queue,
-      CIAA_MULTICORE_IPC_QUEUE_ADDR + sizeof(ciaaLibs_CircBufType),
-      CIAA_MULTICORE_IPC_QUEUE_LEN);
-
-   if(rv == 1)
-   {
-      NVIC_EnableIRQ(M0APP_IRQn);
+   /* Init IPC channels of both directions, only in master core */
+   ciaaMulticore_ipcInit(&ciaaMulticore_ipcChannels[CIAA_MULTICORE_CORE_0]);
+   ciaaMulticore_ipcInit(&ciaaMulticore_ipcChannels[CIAA_MULTICORE_CORE_1]);
 
-      /* Start slave core */
-      cr_start_m0(SLAVE_M0APP, CIAA_MULTICORE_CORE_1_IMAGE);
+   NVIC_EnableIRQ(M0APP_IRQn);
 
-      rv = 0;
-   }
+   /* Start slave core */
+   cr_start_m0(SLAVE_M0APP, CIAA_MULTICORE_CORE_1_IMAGE);
 
-   return rv;
+   return 0;
 }
 
 
@@ -142,16 +134,10 @@ extern int32_t ciaaMulticore_sendSignal_Arch(void)
 
 ISR(M0_IRQHandler)
 {
-   static ciaaMulticore_ipcMsg_t m;
-   static int32_t rv;
-
    LPC_CREG->M0APPTXEVENT = 0;   /* ACK */
 
-   rv = ciaaMulticore_recvMessage(&m);
-   if((rv > 0)&&(m.id.cpuid == CIAA_MULTICORE_CORE_0))
-   {
-      ciaaMulticore_dispatch_OSEK_API(m);
-   }
+   /* one signal may cover many messages */
+   ciaaMulticore_processMessages();
 }
 
 
@@ -0,0 +1,445 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the multicore ipc channels
+ **
+ ** The last test runs both cores as host threads over two channels and
+ ** reports the throughput and the latency of the channels. The inter-core
+ ** interrupt is emulated with a condition variable per core.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Multicore Multicore module
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaMulticore_Ipc.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+#include "pthread.h"
+#include "sched.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief count of messages sent in the throughput benchmark, kept small
+ ** as the test runs with every make tst */
+#define BENCH_MESSAGES        4096
+
+/** \brief count of messages posted before each flush */
+#define BENCH_BATCH           8
+
+/** \brief payload size of the throughput benchmark */
+#define BENCH_PAYLOAD         32
+
+/** \brief count of round trips of the latency benchmark */
+#define BENCH_ROUNDTRIPS      1000
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief channels: chan[0] transports messages to core 0, chan[1] to core 1 */
+static ciaaMulticore_ipcChannel_t chan[2];
+
+/** \brief emulated inter-core interrupt of each core */
+static struct {
+   pthread_mutex_t lock;
+   pthread_cond_t cond;
+   uint32_t pending;
+} irq[2];
+
+/** \brief errors found by the threads */
+static volatile uint32_t benchErrors;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/** \brief signal the emulated inter-core interrupt of a core */
+static void irqRaise(uint32_t core)
+{
+   pthread_mutex_lock(&irq[core].lock);
+   irq[core].pending = 1;
+   pthread_cond_signal(&irq[core].cond);
+   pthread_mutex_unlock(&irq[core].lock);
+}
+
+/** \brief wait for the emulated inter-core interrupt of a core */
+static void irqWait(uint32_t core)
+{
+   pthread_mutex_lock(&irq[core].lock);
+   while (0 == irq[core].pending)
+   {
+      pthread_cond_wait(&irq[core].cond, &irq[core].lock);
+   }
+   irq[core].pending = 0;
+   pthread_mutex_unlock(&irq[core].lock);
+}
+
+/** \brief core 1 of the throughput benchmark: receives and checks */
+static void * benchReceiver(void * arg)
+{
+   ciaaMulticore_ipcDesc_t desc;
+   void * payload;
+   uint32_t expected = 0;
+
+   (void)arg;
+
+   while (BENCH_MESSAGES > expected)
+   {
+      if (0 < ciaaMulticore_ipcRecv(&chan[1], &desc, &payload))
+      {
+         if ( (expected != desc.id) || (NULL == payload) ||
+              (expected != ((uint32_t *)payload)[0]) )
+         {
+            benchErrors++;
+         }
+         if (NULL != payload)
+         {
+            ciaaMulticore_ipcRelease(&chan[1], payload);
+         }
+         expected++;
+      }
+      else
+      {
+         irqWait(1);
+      }
+   }
+
+   return NULL;
+}
+
+/** \brief core 1 of the latency benchmark: answers each message */
+static void * benchEcho(void * arg)
+{
+   ciaaMulticore_ipcDesc_t desc;
+   void * payload;
+   uint32_t count = 0;
+
+   (void)arg;
+
+   while (BENCH_ROUNDTRIPS > count)
+   {
+      if (0 < ciaaMulticore_ipcRecv(&chan[1], &desc, &payload))
+      {
+         desc.src = 1;
+         while (0 > ciaaMulticore_ipcPost(&chan[0], &desc, NULL))
+         {
+            sched_yield();
+         }
+         ciaaMulticore_ipcFlush(&chan[0]);
+         irqRaise(0);
+         count++;
+      }
+      else
+      {
+         irqWait(1);
+      }
+   }
+
+   return NULL;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   uint32_t i;
+
+   ciaaMulticore_ipcInit(&chan[0]);
+   ciaaMulticore_ipcInit(&chan[1]);
+
+   for (i = 0; i < 2; i++)
+   {
+      pthread_mutex_init(&irq[i].lock, NULL);
+      pthread_cond_init(&irq[i].cond, NULL);
+      irq[i].pending = 0;
+   }
+   benchErrors = 0;
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+   uint32_t i;
+
+   for (i = 0; i < 2; i++)
+   {
+      pthread_mutex_destroy(&irq[i].lock);
+      pthread_cond_destroy(&irq[i].cond);
+   }
+}
+
+/** \brief test post, flush and receive of descriptors
+ **/
+void test_ciaaMulticore_ipcPostRecv(void) {
+   ciaaMulticore_ipcDesc_t desc;
+   ciaaMulticore_ipcDesc_t rx;
+   void * payload;
+   uint32_t i;
+
+   memset(&desc, 0, sizeof(desc));
+
+   /* empty channel */
+   TEST_ASSERT_EQUAL_INT(0, ciaaMulticore_ipcRecv(&chan[1], &rx, &payload));
+
+   /* post 3 messages, not visible before the flush */
+   for (i = 0; i < 3; i++)
+   {
+      desc.type = 0x100;
+      desc.id = i;
+      desc.data0 = 0x1000 + i;
+      desc.data1 = 0x2000 + i;
+      TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_ipcPost(&chan[1], &desc, NULL));
+   }
+   TEST_ASSERT_EQUAL_INT(0, ciaaMulticore_ipcCount(&chan[1]));
+   TEST_ASSERT_EQUAL_INT(0, ciaaMulticore_ipcRecv(&chan[1], &rx, &payload));
+
+   /* one flush publishes all of them */
+   TEST_ASSERT_EQUAL_INT(3, ciaaMulticore_ipcFlush(&chan[1]));
+   TEST_ASSERT_EQUAL_INT(0, ciaaMulticore_ipcFlush(&chan[1]));
+   TEST_ASSERT_EQUAL_INT(3, ciaaMulticore_ipcCount(&chan[1]));
+
+   /* received in order */
+   for (i = 0; i < 3; i++)
+   {
+      TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_ipcRecv(&chan[1], &rx, &payload));
+      TEST_ASSERT_TRUE(NULL == payload);
+      TEST_ASSERT_EQUAL_INT(0x100, rx.type);
+      TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_IPC_NOBUF, rx.buf);
+      TEST_ASSERT_EQUAL_INT(0, rx.len);
+      TEST_ASSERT_EQUAL_INT(i, rx.id);
+      TEST_ASSERT_EQUAL_INT(0x1000 + i, rx.data0);
+      TEST_ASSERT_EQUAL_INT(0x2000 + i, rx.data1);
+   }
+   TEST_ASSERT_EQUAL_INT(0, ciaaMulticore_ipcRecv(&chan[1], &rx, &payload));
+
+   /* the other channel is not affected */
+   TEST_ASSERT_EQUAL_INT(0, ciaaMulticore_ipcCount(&chan[0]));
+}
+
+/** \brief test a full descriptor ring
+ **/
+void test_ciaaMulticore_ipcFull(void) {
+   ciaaMulticore_ipcDesc_t desc;
+   ciaaMulticore_ipcDesc_t rx;
+   void * payload;
+   uint32_t i;
+
+   memset(&desc, 0, sizeof(desc));
+
+   /* descriptors are counted when posted, also if not flushed */
+   for (i = 0; i < CIAA_MULTICORE_IPC_DESC_COUNT; i++)
+   {
+      desc.id = i;
+      TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_ipcPost(&chan[1], &desc, NULL));
+   }
+   TEST_ASSERT_EQUAL_INT(-1, ciaaMulticore_ipcPost(&chan[1], &desc, NULL));
+   TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_IPC_DESC_COUNT, ciaaMulticore_ipcFlush(&chan[1]));
+
+   /* receiving one descriptor frees one place */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_ipcRecv(&chan[1], &rx, &payload));
+   TEST_ASSERT_EQUAL_INT(0, rx.id);
+   desc.id = CIAA_MULTICORE_IPC_DESC_COUNT;
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_ipcPost(&chan[1], &desc, NULL));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaMulticore_ipcPost(&chan[1], &desc, NULL));
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_ipcFlush(&chan[1]));
+
+   /* the ring wraps */
+   for (i = 1; i <= CIAA_MULTICORE_IPC_DESC_COUNT; i++)
+   {
+      TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_ipcRecv(&chan[1], &rx, &payload));
+      TEST_ASSERT_EQUAL_INT(i, rx.id);
+   }
+   TEST_ASSERT_EQUAL_INT(0, ciaaMulticore_ipcRecv(&chan[1], &rx, &payload));
+}
+
+/** \brief test the payloads passed by reference
+ **/
+void test_ciaaMulticore_ipcPayload(void) {
+   ciaaMulticore_ipcDesc_t desc;
+   ciaaMulticore_ipcDesc_t rx;
+   void * bufs[CIAA_MULTICORE_IPC_BUF_COUNT];
+   void * payload;
+   uint32_t i;
+
+   memset(&desc, 0, sizeof(desc));
+
+   /* too big */
+   TEST_ASSERT_TRUE(NULL == ciaaMulticore_ipcAlloc(&chan[1], CIAA_MULTICORE_IPC_BUF_SIZE + 1));
+
+   /* get all buffers */
+   for (i = 0; i < CIAA_MULTICORE_IPC_BUF_COUNT; i++)
+   {
+      bufs[i] = ciaaMulticore_ipcAlloc(&chan[1], CIAA_MULTICORE_IPC_BUF_SIZE);
+      TEST_ASSERT_TRUE(NULL != bufs[i]);
+   }
+   TEST_ASSERT_TRUE(NULL == ciaaMulticore_ipcAlloc(&chan[1], 1));
+
+   /* a not posted buffer can be given back by the sender */
+   ciaaMulticore_ipcFree(&chan[1], bufs[0]);
+   TEST_ASSERT_TRUE(bufs[0] == ciaaMulticore_ipcAlloc(&chan[1], 1));
+
+   /* send all of them */
+   for (i = 0; i < CIAA_MULTICORE_IPC_BUF_COUNT; i++)
+   {
+      memset(bufs[i], i, 10);
+      desc.id = i;
+      desc.len = 10;
+      TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_ipcPost(&chan[1], &desc, bufs[i]));
+   }
+   ciaaMulticore_ipcFlush(&chan[1]);
+
+   /* the receiver gets the same buffers without copy */
+   for (i = 0; i < CIAA_MULTICORE_IPC_BUF_COUNT; i++)
+   {
+      TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_ipcRecv(&chan[1], &rx, &payload));
+      TEST_ASSERT_TRUE(bufs[i] == payload);
+      TEST_ASSERT_EQUAL_INT(10, rx.len);
+      TEST_ASSERT_EQUAL_INT(i, ((uint8_t *)payload)[9]);
+   }
+
+   /* still no buffer until the receiver releases them */
+   TEST_ASSERT_TRUE(NULL == ciaaMulticore_ipcAlloc(&chan[1], 1));
+   ciaaMulticore_ipcRelease(&chan[1], bufs[3]);
+   ciaaMulticore_ipcRelease(&chan[1], bufs[7]);
+   payload = ciaaMulticore_ipcAlloc(&chan[1], 1);
+   TEST_ASSERT_TRUE((bufs[3] == payload) || (bufs[7] == payload));
+   TEST_ASSERT_TRUE(NULL != ciaaMulticore_ipcAlloc(&chan[1], 1));
+   TEST_ASSERT_TRUE(NULL == ciaaMulticore_ipcAlloc(&chan[1], 1));
+}
+
+/** \brief benchmark with both cores emulated by host threads
+ **/
+void test_ciaaMulticore_ipcBenchmark(void) {
+   pthread_t core1;
+   ciaaMulticore_ipcDesc_t desc;
+   ciaaMulticore_ipcDesc_t rx;
+   void * payload;
+   uint32_t sent = 0;
+   uint32_t batch;
+   uint32_t flushes = 0;
+   uint64_t start;
+   uint64_t elapsed;
+
+   memset(&desc, 0, sizeof(desc));
+
+   /* throughput: core 0 streams messages with payload to core 1 */
+   TEST_ASSERT_EQUAL_INT(0, pthread_create(&core1, NULL, benchReceiver, NULL));
+   start = getNs();
+   while (BENCH_MESSAGES > sent)
+   {
+      for (batch = 0; (BENCH_BATCH > batch) && (BENCH_MESSAGES > sent); batch++)
+      {
+         payload = ciaaMulticore_ipcAlloc(&chan[1], BENCH_PAYLOAD);
+         if (NULL == payload)
+         {
+            break;
+         }
+         ((uint32_t *)payload)[0] = sent;
+         desc.id = sent;
+         desc.len = BENCH_PAYLOAD;
+         if (0 > ciaaMulticore_ipcPost(&chan[1], &desc, payload))
+         {
+            ciaaMulticore_ipcFree(&chan[1], payload);
+            break;
+         }
+         sent++;
+      }
+      if (0 < ciaaMulticore_ipcFlush(&chan[1]))
+      {
+         irqRaise(1);
+         flushes++;
+      }
+      else
+      {
+         sched_yield();
+      }
+   }
+   pthread_join(core1, NULL);
+   elapsed = getNs() - start;
+   TEST_ASSERT_EQUAL_INT(0, benchErrors);
+   printf("ipc throughput: %u messages of %d bytes in %u signals, %.0f messages/s\n",
+         BENCH_MESSAGES, BENCH_PAYLOAD, flushes,
+         (double)BENCH_MESSAGES * 1e9 / (double)elapsed);
+
+   /* latency: core 0 sends a message and waits for the answer of core 1 */
+   TEST_ASSERT_EQUAL_INT(0, pthread_create(&core1, NULL, benchEcho, NULL));
+   start = getNs();
+   for (sent = 0; BENCH_ROUNDTRIPS > sent; sent++)
+   {
+      desc.id = sent;
+      ciaaMulticore_ipcPost(&chan[1], &desc, NULL);
+      ciaaMulticore_ipcFlush(&chan[1]);
+      irqRaise(1);
+      while (0 == ciaaMulticore_ipcRecv(&chan[0], &rx, &payload))
+      {
+         irqWait(0);
+      }
+      if (sent != rx.id)
+      {
+         benchErrors++;
+      }
+   }
+   elapsed = getNs() - start;
+   pthread_join(core1, NULL);
+   TEST_ASSERT_EQUAL_INT(0, benchErrors);
+   printf("ipc latency: %u round trips, %.0f ns per round trip\n",
+         BENCH_ROUNDTRIPS, (double)elapsed / BENCH_ROUNDTRIPS);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
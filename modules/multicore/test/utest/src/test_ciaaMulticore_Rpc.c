@@ -0,0 +1,661 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the multicore remote procedure
+ ** calls
+ **
+ ** The ipc channels are replaced by a minimal lock-free transport, so both
+ ** rpc instances can run on host threads. The last test reports the round
+ ** trip latency and the throughput of the calls.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Multicore Multicore module
+ ** @{ */
+/** \addtogroup UnitTests Unit Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaMulticore_Rpc.h"
+#include "mock_ciaaMulticore_Ipc.h"
+#include "mock_ciaaPOSIX_string.h"
+#include "mock_os.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+#include "pthread.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief count of round trips of the latency benchmark, kept small as
+ ** the test runs with every make tst */
+#define BENCH_ROUNDTRIPS      1000
+
+/** \brief count of calls of the throughput benchmark */
+#define BENCH_CALLS           4096
+
+/** \brief request of the test procedure */
+typedef struct
+{
+   int32_t a;
+   int32_t b;
+} test_addReq_t;
+
+/** \brief response of the test procedure */
+typedef struct
+{
+   int32_t sum;
+} test_addRsp_t;
+
+/** \brief interface of the test */
+#define TEST_INTERFACE(RPC)                           \
+   RPC(test_add, test_addReq_t, test_addRsp_t)        \
+   RPC(test_fail, test_addReq_t, test_addRsp_t)
+
+CIAA_MULTICORE_RPC_DECLARE(TEST_INTERFACE)
+
+/** \brief the stubs are called by the core 0 */
+#define CIAA_MULTICORE_RPC_INSTANCE (&rpc[0])
+
+/** \brief completion record of a call */
+typedef struct
+{
+   uint32_t calls;
+   int32_t status;
+   int32_t sum;
+} test_done_t;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief rpc instances of both cores */
+static ciaaMulticore_rpc_t rpc[2];
+
+/** \brief channel handles, chan[i] transports messages to core i */
+static ciaaMulticore_ipcChannel_t chan[2];
+
+/** \brief transport behind each channel handle */
+static struct {
+   ciaaMulticore_ipcDesc_t desc[CIAA_MULTICORE_IPC_DESC_COUNT];
+   void * payload[CIAA_MULTICORE_IPC_DESC_COUNT];
+   uint32_t wr;
+   volatile uint32_t tail;
+   volatile uint32_t head;
+   volatile uint32_t freeMask;
+   uint32_t buf[CIAA_MULTICORE_IPC_BUF_COUNT][CIAA_MULTICORE_IPC_BUF_SIZE / 4];
+} link[2];
+
+/** \brief emulated inter-core interrupt of each core */
+static struct {
+   pthread_mutex_t lock;
+   pthread_cond_t cond;
+   uint32_t pending;
+} irq[2];
+
+/** \brief signals received by each core */
+static uint32_t signals[2];
+
+/** \brief stop the server thread of the benchmark */
+static volatile uint32_t benchStop;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+CIAA_MULTICORE_RPC_DEFINE(TEST_INTERFACE)
+
+extern int32_t test_add_server(test_addReq_t const * in, test_addRsp_t * out)
+{
+   out->sum = in->a + in->b;
+
+   return CIAA_MULTICORE_RPC_OK;
+}
+
+extern int32_t test_fail_server(test_addReq_t const * in, test_addRsp_t * out)
+{
+   out->sum = 0;
+
+   return in->a;
+}
+
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t linkIndex(ciaaMulticore_ipcChannel_t * ch)
+{
+   return (uint32_t)(ch - chan);
+}
+
+static void * linkAlloc(ciaaMulticore_ipcChannel_t * ch, size_t size, int calls)
+{
+   uint32_t l = linkIndex(ch);
+   uint32_t mask;
+   uint32_t i;
+
+   (void)calls;
+
+   if (CIAA_MULTICORE_IPC_BUF_SIZE < size)
+   {
+      return NULL;
+   }
+
+   do
+   {
+      mask = link[l].freeMask;
+      if (0 == mask)
+      {
+         return NULL;
+      }
+      i = __builtin_ctz(mask);
+   } while (!__sync_bool_compare_and_swap(&link[l].freeMask, mask, mask & ~(1UL << i)));
+
+   return link[l].buf[i];
+}
+
+static void linkFree(ciaaMulticore_ipcChannel_t * ch, void * payload, int calls)
+{
+   uint32_t l = linkIndex(ch);
+   uint32_t i = (uint32_t)(((uint32_t *)payload - link[l].buf[0]) /
+                           (CIAA_MULTICORE_IPC_BUF_SIZE / 4));
+
+   (void)calls;
+
+   __sync_fetch_and_or(&link[l].freeMask, 1UL << i);
+}
+
+static int32_t linkPost(ciaaMulticore_ipcChannel_t * ch,
+      ciaaMulticore_ipcDesc_t const * desc, void * payload, int calls)
+{
+   uint32_t l = linkIndex(ch);
+   uint32_t slot;
+
+   (void)calls;
+
+   if (CIAA_MULTICORE_IPC_DESC_COUNT <= (link[l].wr - link[l].head))
+   {
+      return -1;
+   }
+
+   slot = link[l].wr & (CIAA_MULTICORE_IPC_DESC_COUNT - 1);
+   link[l].desc[slot] = *desc;
+   link[l].payload[slot] = payload;
+   link[l].wr++;
+
+   return 1;
+}
+
+static uint32_t linkFlush(ciaaMulticore_ipcChannel_t * ch, int calls)
+{
+   uint32_t l = linkIndex(ch);
+   uint32_t ret = link[l].wr - link[l].tail;
+
+   (void)calls;
+
+   __sync_synchronize();
+   link[l].tail = link[l].wr;
+
+   return ret;
+}
+
+static int32_t linkRecv(ciaaMulticore_ipcChannel_t * ch,
+      ciaaMulticore_ipcDesc_t * desc, void ** payload, int calls)
+{
+   uint32_t l = linkIndex(ch);
+   uint32_t head = link[l].head;
+   uint32_t slot = head & (CIAA_MULTICORE_IPC_DESC_COUNT - 1);
+
+   (void)calls;
+
+   if (head == link[l].tail)
+   {
+      return 0;
+   }
+
+   __sync_synchronize();
+   *desc = link[l].desc[slot];
+   *payload = link[l].payload[slot];
+   __sync_synchronize();
+   link[l].head = head + 1;
+
+   return 1;
+}
+
+static void * stringMemcpy(void * s1, void const * s2, size_t n, int calls)
+{
+   (void)calls;
+
+   return memcpy(s1, s2, n);
+}
+
+/** \brief signal the emulated inter-core interrupt of a core */
+static void irqRaise(uint32_t core)
+{
+   pthread_mutex_lock(&irq[core].lock);
+   irq[core].pending = 1;
+   signals[core]++;
+   pthread_cond_signal(&irq[core].cond);
+   pthread_mutex_unlock(&irq[core].lock);
+}
+
+/** \brief wait for the emulated inter-core interrupt of a core */
+static void irqWait(uint32_t core)
+{
+   pthread_mutex_lock(&irq[core].lock);
+   while (0 == irq[core].pending)
+   {
+      pthread_cond_wait(&irq[core].cond, &irq[core].lock);
+   }
+   irq[core].pending = 0;
+   pthread_mutex_unlock(&irq[core].lock);
+}
+
+static void signalCore0(void)
+{
+   irqRaise(0);
+}
+
+static void signalCore1(void)
+{
+   irqRaise(1);
+}
+
+/** \brief inter-core interrupt handler of a core, as in
+ ** ciaaMulticore_processMessages */
+static uint32_t process(uint32_t core)
+{
+   ciaaMulticore_ipcDesc_t desc;
+   void * payload;
+   uint32_t count = 0;
+
+   while (0 < ciaaMulticore_ipcRecv(&chan[core], &desc, &payload))
+   {
+      ciaaMulticore_rpcReceive(&rpc[core], &desc, payload);
+      if (NULL != payload)
+      {
+         ciaaMulticore_ipcRelease(&chan[core], payload);
+      }
+      count++;
+   }
+   (void)ciaaMulticore_rpcFlush(&rpc[core]);
+
+   return count;
+}
+
+/** \brief completion callback storing the result */
+static void testDone(int32_t status, void const * rsp, void * ctx)
+{
+   test_done_t * done = ctx;
+
+   done->calls++;
+   done->status = status;
+   done->sum = (NULL != rsp) ? ((test_addRsp_t const *)rsp)->sum : -1;
+}
+
+/** \brief core 1 of the benchmark: serves the calls */
+static void * benchServer(void * arg)
+{
+   (void)arg;
+
+   while (0 == benchStop)
+   {
+      irqWait(1);
+      (void)process(1);
+   }
+
+   return NULL;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   uint32_t i;
+
+   for (i = 0; i < 2; i++)
+   {
+      memset(&link[i], 0, sizeof(link[i]));
+      link[i].freeMask = (1UL << CIAA_MULTICORE_IPC_BUF_COUNT) - 1;
+      pthread_mutex_init(&irq[i].lock, NULL);
+      pthread_cond_init(&irq[i].cond, NULL);
+      irq[i].pending = 0;
+      signals[i] = 0;
+   }
+   benchStop = 0;
+
+   ciaaMulticore_ipcAlloc_StubWithCallback(linkAlloc);
+   ciaaMulticore_ipcFree_StubWithCallback(linkFree);
+   ciaaMulticore_ipcPost_StubWithCallback(linkPost);
+   ciaaMulticore_ipcFlush_StubWithCallback(linkFlush);
+   ciaaMulticore_ipcRecv_StubWithCallback(linkRecv);
+   ciaaMulticore_ipcRelease_StubWithCallback(linkFree);
+   ciaaPOSIX_memcpy_StubWithCallback(stringMemcpy);
+   SuspendOSInterrupts_Ignore();
+   ResumeOSInterrupts_Ignore();
+
+   /* core 0 arbitrates the resources */
+   ciaaMulticore_rpcInit(&rpc[0], &chan[1], signalCore1, 0, 1);
+   ciaaMulticore_rpcInit(&rpc[1], &chan[0], signalCore0, 1, 0);
+   ciaaMulticore_rpcSetInterface(&rpc[1], TEST_INTERFACE_procs,
+         CIAA_MULTICORE_RPC_COUNT(TEST_INTERFACE));
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+   uint32_t i;
+
+   for (i = 0; i < 2; i++)
+   {
+      pthread_mutex_destroy(&irq[i].lock);
+      pthread_cond_destroy(&irq[i].cond);
+   }
+}
+
+/** \brief test a call of a generated stub
+ **/
+void test_ciaaMulticore_rpcCall(void) {
+   test_addReq_t req = { 40, 2 };
+   test_done_t done;
+
+   memset(&done, 0, sizeof(done));
+
+   TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_RPC_PROC_USER, test_add_ID);
+   TEST_ASSERT_EQUAL_INT(2, CIAA_MULTICORE_RPC_COUNT(TEST_INTERFACE));
+
+   /* the request is sent and core 1 is signaled */
+   TEST_ASSERT_EQUAL_INT(1, test_add(&req, testDone, &done));
+   TEST_ASSERT_EQUAL_INT(1, signals[1]);
+   TEST_ASSERT_EQUAL_INT(0, done.calls);
+
+   /* core 1 executes it and responds */
+   TEST_ASSERT_EQUAL_INT(1, process(1));
+   TEST_ASSERT_EQUAL_INT(1, signals[0]);
+   TEST_ASSERT_EQUAL_INT(0, done.calls);
+
+   /* core 0 gets the response */
+   TEST_ASSERT_EQUAL_INT(1, process(0));
+   TEST_ASSERT_EQUAL_INT(1, done.calls);
+   TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_RPC_OK, done.status);
+   TEST_ASSERT_EQUAL_INT(42, done.sum);
+
+   /* the status of the server is returned */
+   req.a = -7;
+   TEST_ASSERT_EQUAL_INT(1, test_fail(&req, testDone, &done));
+   process(1);
+   process(0);
+   TEST_ASSERT_EQUAL_INT(2, done.calls);
+   TEST_ASSERT_EQUAL_INT(-7, done.status);
+
+   /* all payload buffers have been given back */
+   TEST_ASSERT_EQUAL_HEX32((1UL << CIAA_MULTICORE_IPC_BUF_COUNT) - 1, link[0].freeMask);
+   TEST_ASSERT_EQUAL_HEX32((1UL << CIAA_MULTICORE_IPC_BUF_COUNT) - 1, link[1].freeMask);
+}
+
+/** \brief test the correlation of many pending calls
+ **/
+void test_ciaaMulticore_rpcPending(void) {
+   test_addReq_t req;
+   test_done_t done[CIAA_MULTICORE_RPC_PENDING];
+   ciaaMulticore_ipcDesc_t desc;
+   uint32_t i;
+
+   memset(done, 0, sizeof(done));
+
+   for (i = 0; i < CIAA_MULTICORE_RPC_PENDING; i++)
+   {
+      req.a = i;
+      req.b = 100;
+      TEST_ASSERT_EQUAL_INT(1, test_add(&req, testDone, &done[i]));
+   }
+
+   /* no more pending slots */
+   TEST_ASSERT_EQUAL_INT(-1, test_add(&req, testDone, &done[0]));
+
+   /* one way calls do not need a slot */
+   TEST_ASSERT_EQUAL_INT(1, test_add(&req, NULL, NULL));
+
+   process(1);
+   TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_RPC_PENDING, process(0));
+
+   /* each response completes its own call */
+   for (i = 0; i < CIAA_MULTICORE_RPC_PENDING; i++)
+   {
+      TEST_ASSERT_EQUAL_INT(1, done[i].calls);
+      TEST_ASSERT_EQUAL_INT(100 + i, done[i].sum);
+   }
+
+   /* a response of an unknown call is dropped */
+   memset(&desc, 0, sizeof(desc));
+   desc.type = CIAA_MULTICORE_RPC_MSG_RSP;
+   desc.buf = CIAA_MULTICORE_IPC_NOBUF;
+   desc.id = 0x1234;
+   ciaaMulticore_rpcReceive(&rpc[0], &desc, NULL);
+   TEST_ASSERT_EQUAL_INT(1, rpc[0].dropped);
+
+   /* the slots are free again */
+   TEST_ASSERT_EQUAL_INT(1, test_add(&req, testDone, &done[0]));
+}
+
+/** \brief test the errors reported by the server
+ **/
+void test_ciaaMulticore_rpcErrors(void) {
+   test_done_t done;
+   uint32_t data = 0;
+
+   memset(&done, 0, sizeof(done));
+
+   /* unknown procedure */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcCall(&rpc[0],
+            CIAA_MULTICORE_RPC_PROC_USER + 2, NULL, 0, testDone, &done));
+   process(1);
+   process(0);
+   TEST_ASSERT_EQUAL_INT(1, done.calls);
+   TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_RPC_E_NOPROC, done.status);
+   TEST_ASSERT_EQUAL_INT(-1, done.sum);
+
+   /* request too short */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcCall(&rpc[0], test_add_ID,
+            &data, sizeof(data), testDone, &done));
+   process(1);
+   process(0);
+   TEST_ASSERT_EQUAL_INT(2, done.calls);
+   TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_RPC_E_LIMIT, done.status);
+
+   /* the core 0 serves no user procedures */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcCall(&rpc[1], test_add_ID,
+            NULL, 0, testDone, &done));
+   process(0);
+   process(1);
+   TEST_ASSERT_EQUAL_INT(3, done.calls);
+   TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_RPC_E_NOPROC, done.status);
+}
+
+/** \brief test the inter-core resources arbitrated by core 0
+ **/
+void test_ciaaMulticore_rpcResource(void) {
+   test_done_t local;
+   test_done_t remote;
+
+   memset(&local, 0, sizeof(local));
+   memset(&remote, 0, sizeof(remote));
+
+   /* invalid resource */
+   TEST_ASSERT_EQUAL_INT(-1, ciaaMulticore_rpcGetResource(&rpc[0],
+            CIAA_MULTICORE_RPC_RESOURCES, testDone, &local));
+
+   /* core 0 gets the free resource immediately */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcGetResource(&rpc[0], 2, testDone, &local));
+   TEST_ASSERT_EQUAL_INT(1, local.calls);
+   TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_RPC_OK, local.status);
+
+   /* core 1 has to wait */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcGetResource(&rpc[1], 2, testDone, &remote));
+   process(0);
+   process(1);
+   TEST_ASSERT_EQUAL_INT(0, remote.calls);
+
+   /* core 1 gets it when released by core 0 */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcReleaseResource(&rpc[0], 2));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaMulticore_rpcReleaseResource(&rpc[0], 2));
+   process(1);
+   TEST_ASSERT_EQUAL_INT(1, remote.calls);
+   TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_RPC_OK, remote.status);
+
+   /* now core 0 waits */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcGetResource(&rpc[0], 2, testDone, &local));
+   TEST_ASSERT_EQUAL_INT(1, local.calls);
+
+   /* until core 1 releases it */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcReleaseResource(&rpc[1], 2));
+   process(0);
+   TEST_ASSERT_EQUAL_INT(2, local.calls);
+   TEST_ASSERT_EQUAL_INT(CIAA_MULTICORE_RPC_OK, local.status);
+
+   /* a release of a resource not held by core 1 is ignored */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcReleaseResource(&rpc[1], 2));
+   process(0);
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcReleaseResource(&rpc[0], 2));
+   TEST_ASSERT_EQUAL_INT(0, rpc[0].dropped);
+   TEST_ASSERT_EQUAL_INT(0, rpc[1].dropped);
+}
+
+/** \brief test the remote alarms
+ **/
+void test_ciaaMulticore_rpcAlarm(void) {
+   test_done_t done;
+
+   memset(&done, 0, sizeof(done));
+
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcSetRelAlarm(&rpc[0], 3, 100, 10,
+            testDone, &done));
+   SetRelAlarm_ExpectAndReturn(3, 100, 10, E_OK);
+   process(1);
+   process(0);
+   TEST_ASSERT_EQUAL_INT(1, done.calls);
+   TEST_ASSERT_EQUAL_INT(E_OK, done.status);
+
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcCancelAlarm(&rpc[0], 3,
+            testDone, &done));
+   CancelAlarm_ExpectAndReturn(3, E_OS_ID);
+   process(1);
+   process(0);
+   TEST_ASSERT_EQUAL_INT(2, done.calls);
+   TEST_ASSERT_EQUAL_INT(E_OS_ID, done.status);
+
+   /* without completion */
+   TEST_ASSERT_EQUAL_INT(1, ciaaMulticore_rpcCancelAlarm(&rpc[0], 4, NULL, NULL));
+   CancelAlarm_ExpectAndReturn(4, E_OK);
+   process(1);
+   TEST_ASSERT_EQUAL_INT(0, process(0));
+}
+
+/** \brief benchmark with both cores emulated by host threads
+ **/
+void test_ciaaMulticore_rpcBenchmark(void) {
+   pthread_t core1;
+   test_addReq_t req;
+   test_done_t done;
+   uint32_t i;
+   uint32_t calls;
+   uint64_t start;
+   uint64_t elapsed;
+
+   memset(&done, 0, sizeof(done));
+
+   TEST_ASSERT_EQUAL_INT(0, pthread_create(&core1, NULL, benchServer, NULL));
+
+   /* latency: one call at a time */
+   start = getNs();
+   for (i = 0; i < BENCH_ROUNDTRIPS; i++)
+   {
+      req.a = i;
+      req.b = 1;
+      TEST_ASSERT_EQUAL_INT(1, test_add(&req, testDone, &done));
+      while (i == done.calls)
+      {
+         irqWait(0);
+         (void)process(0);
+      }
+   }
+   elapsed = getNs() - start;
+   TEST_ASSERT_EQUAL_INT(BENCH_ROUNDTRIPS, done.calls);
+   TEST_ASSERT_EQUAL_INT(BENCH_ROUNDTRIPS, done.sum);
+   printf("rpc round trip: %.2f us\n",
+         (double)elapsed / 1000.0 / (double)BENCH_ROUNDTRIPS);
+
+   /* throughput: as many pending calls as possible */
+   done.calls = 0;
+   calls = 0;
+   start = getNs();
+   while (BENCH_CALLS > done.calls)
+   {
+      while ( (BENCH_CALLS > calls) &&
+              (0 < test_add(&req, testDone, &done)) )
+      {
+         calls++;
+      }
+      irqWait(0);
+      (void)process(0);
+   }
+   elapsed = getNs() - start;
+   printf("rpc throughput: %.0f calls/s with %d pending calls\n",
+         (double)BENCH_CALLS * 1e9 / (double)elapsed, CIAA_MULTICORE_RPC_PENDING);
+
+   benchStop = 1;
+   irqRaise(1);
+   pthread_join(core1, NULL);
+
+   TEST_ASSERT_EQUAL_INT(0, rpc[0].dropped);
+   TEST_ASSERT_EQUAL_INT(0, rpc[1].dropped);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
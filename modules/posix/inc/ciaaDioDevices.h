@@ -145,6 +145,15 @@ extern void ciaaDioDevices_addDriver(ciaaDevices_deviceType * driver);
  **/
 extern void ciaaDioDevices_releaseDriver(ciaaDevices_deviceType const * driver);
 
+/** \brief indicates that edge events have been queued by the driver
+ **
+ ** Wakes up the task blocked reading events, may be called from an
+ ** interrupt.
+ **
+ ** \param[in] device upper layer device of the driver
+ **/
+extern void ciaaDioDevices_eventIndication(ciaaDevices_deviceType const * const device);
+
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
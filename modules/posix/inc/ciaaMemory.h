@@ -36,7 +36,14 @@
 #define CIAAMEMORY_H
 /** \brief CIAA Memory header file
  **
- ** This header file describes the Devices.
+ ** This header file describes the memory allocation hooks and the memory
+ ** usage instrumentation.
+ **
+ ** The stacks of the tasks are painted with CIAAMEMORY_STACK_PATTERN by
+ ** ciaaMemory_init, the high water mark of each stack is the part which
+ ** does not contain the pattern anymore. The heap and stack statistics can
+ ** be read with ciaaMemory_getStats or as a ciaaMemory_statsType from the
+ ** device /dev/mem.
  **
  **/
 
@@ -47,6 +54,7 @@
 
 /*==================[inclusions]=============================================*/
 #include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdlib.h"
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -54,8 +62,42 @@ extern "C" {
 #endif
 
 /*==================[macros]=================================================*/
+/** \brief path of the memory statistics device */
+#define CIAAMEMORY_DEVICE_PATH         "/dev/mem"
+
+/** \brief value written to the unused stack bytes */
+#define CIAAMEMORY_STACK_PATTERN       0xA5u
+
+/** \brief maximal count of tasks in the statistics */
+#ifndef CIAAMEMORY_TASKS
+#define CIAAMEMORY_TASKS               32
+#endif
+
+/** \brief bytes below the stack pointer of the running task which are not
+ **        painted, they are used while painting */
+#define CIAAMEMORY_STACK_MARGIN        128
 
 /*==================[typedef]================================================*/
+/** \brief statistics of the stack of a task */
+typedef struct {
+   uint32_t size;                /** <= size of the stack in bytes */
+   uint32_t painted;             /** <= painted bytes starting on the lowest
+                                        address, 0 if the task was active when
+                                        the stacks were painted */
+   uint32_t highWater;           /** <= maximal count of used bytes, only
+                                        valid if painted is not 0 */
+} ciaaMemory_stackStatsType;
+
+/** \brief memory statistics, also read from CIAAMEMORY_DEVICE_PATH */
+typedef struct {
+   ciaaPOSIX_heapStatsType heap;                         /** <= heap */
+   uint32_t tasks;                                       /** <= count of valid
+                                                                entries of
+                                                                stack */
+   ciaaMemory_stackStatsType stack[CIAAMEMORY_TASKS];    /** <= stack of each
+                                                                task */
+} ciaaMemory_statsType;
+
 typedef void* (*ciaaMemory_pfMallocType)(uint32_t size);
 
 typedef void (*ciaaMemory_pfFreeType)(void* pointer);
@@ -82,6 +124,32 @@ extern void ciaaMemory_SetMalloc (void* (*pf) (uint32_t));
  **/
 extern void ciaaMemory_SetFree (void (*pf) (void*));
 
+/** \brief initialize the memory instrumentation
+ **
+ ** Paints the stacks and adds the device CIAAMEMORY_DEVICE_PATH. Shall be
+ ** called once at start up before the other tasks are activated, the
+ ** stacks of the active tasks other than the caller are not painted.
+ **/
+extern void ciaaMemory_init(void);
+
+/** \brief paint the unused part of the stacks of the tasks */
+extern void ciaaMemory_stackPaint(void);
+
+/** \brief get the statistics of the stack of a task
+ **
+ ** \param[in] task id of the task
+ ** \param[out] stats pointer to the statistics
+ ** \return 1 if success -1 if the task does not exist
+ **/
+extern int32_t ciaaMemory_getStackStats(uint32_t task,
+      ciaaMemory_stackStatsType * stats);
+
+/** \brief get the statistics of the heap and of all stacks
+ **
+ ** \param[out] stats pointer to the statistics
+ **/
+extern void ciaaMemory_getStats(ciaaMemory_statsType * stats);
+
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
 }
@@ -55,13 +55,25 @@ extern "C" {
 #define EAGAIN 1             /* No more processes */
 #define EWOULDBLOCK EAGAIN   /* Operation would block */
 
+/** \brief Error value of the calling task
+ **
+ ** Each task has its own error value, the interrupts and the code running
+ ** before the first task share one more.
+ **/
+#define ciaaPOSIX_errno (*ciaaPOSIX_errnoLocation())
+
 /*==================[typedef]================================================*/
 
 /*==================[external data declaration]==============================*/
-/** \brief Error value */
-extern int16_t ciaaPOSIX_errno;
 
 /*==================[external functions declaration]=========================*/
+/** \brief returns the location of the error value of the calling task
+ **
+ ** Shall not be used directly, use ciaaPOSIX_errno instead.
+ **
+ ** \return pointer to the error value of the calling task
+ **/
+extern int16_t * ciaaPOSIX_errnoLocation(void);
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -0,0 +1,135 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef CIAAPOSIX_IOCTL_DIO
+#define CIAAPOSIX_IOCTL_DIO
+/** \brief IO Control macros for dio devices
+ **
+ ** This files contains the macros for IO control for dio devices
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup POSIX
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief set the outputs of a mask
+ **
+ ** The argument is the mask of the outputs to be set, the bit n is the
+ ** output n, e.g. (void *)0x05 sets the outputs 0 and 2. The other outputs
+ ** are not modified, also if they are changed at the same time by an
+ ** interrupt. Returns 0 if success or -1 if the device has no outputs.
+ **/
+#define ciaaPOSIX_IOCTL_DIO_SET           0x8100U
+
+/** \brief clear the outputs of a mask
+ **
+ ** As ciaaPOSIX_IOCTL_DIO_SET but the outputs of the mask are cleared.
+ **/
+#define ciaaPOSIX_IOCTL_DIO_CLEAR         0x8101U
+
+/** \brief toggle the outputs of a mask
+ **
+ ** As ciaaPOSIX_IOCTL_DIO_SET but the outputs of the mask are toggled.
+ **/
+#define ciaaPOSIX_IOCTL_DIO_TOGGLE        0x8102U
+
+/** \brief enable the edge events of the inputs of a mask
+ **
+ ** The argument is the mask of the inputs whose edges are queued with a
+ ** timestamp, e.g. (void *)0x03 for the inputs 0 and 1. While the mask is
+ ** not 0 a read returns whole ciaaPOSIX_dioEventType events instead of the
+ ** state of the inputs, blocking until an event is available unless the
+ ** device is in non blocking mode (ciaaPOSIX_IOCTL_SET_NONBLOCK_MODE). A
+ ** mask of 0 disables the events and discards the queued ones. Returns 0
+ ** if success or -1 if the device has no inputs.
+ **/
+#define ciaaPOSIX_IOCTL_DIO_SET_EVENTS    0x8103U
+
+/** \brief configure the debounce of the inputs
+ **
+ ** The argument is a pointer to a ciaaPOSIX_dioDebounceType. The state of
+ ** a debounced input changes once it has been sampled samples times more
+ ** with the new level than with the old one, the samples are taken on each
+ ** edge and every debounce period while the input is not stable. The edge
+ ** event gets the timestamp of the first edge. Returns 0 if success or -1
+ ** if the device has no inputs.
+ **/
+#define ciaaPOSIX_IOCTL_DIO_SET_DEBOUNCE  0x8104U
+
+/** \brief get the count of queued edge events
+ **
+ ** Allows to poll the events without blocking, returns the count of
+ ** events which can be read or -1 if the device has no inputs.
+ **/
+#define ciaaPOSIX_IOCTL_DIO_GET_EVENT_COUNT  0x8105U
+
+/*==================[typedef]================================================*/
+/** \brief edge event of an input */
+typedef struct {
+   uint32_t timestamp;     /** <- time of the edge in microseconds */
+   uint8_t input;          /** <- input number */
+   uint8_t level;          /** <- new level, 1 for a rising edge */
+} ciaaPOSIX_dioEventType;
+
+/** \brief debounce of ciaaPOSIX_IOCTL_DIO_SET_DEBOUNCE */
+typedef struct {
+   uint32_t inputs;        /** <- mask of the inputs to configure */
+   uint8_t samples;        /** <- samples to change the state, 0 to
+                             **    disable the debounce */
+} ciaaPOSIX_dioDebounceType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef CIAAPOSIX_IOCTL_DIO */
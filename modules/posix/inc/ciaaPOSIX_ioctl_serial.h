@@ -181,6 +181,25 @@ extern "C" {
  **/
 #define ciaaPOSIX_IOCTL_SET_NONBLOCK_MODE              9
 
+/** \brief set the transfer mode of serial devices
+ **
+ ** This ioctl command is used to select how the data are moved between the
+ ** buffers of a serial device and the hardware.
+ ** Possible values for arg are:
+ **   ciaaSERIAL_TRANSFER_IRQ (an interrupt per FIFO trigger level, default)
+ **   ciaaSERIAL_TRANSFER_DMA (the DMA moves the data, interrupts only at the
+ **                            end of a transfer or on an idle line)
+ **
+ ** Returned value for ioctl is 0 if success, -1 if the mode is not supported
+ ** by the device or can not be changed now, e.g. a DMA transmission is ongoing.
+ **/
+#define ciaaPOSIX_IOCTL_SET_TRANSFER_MODE              13
+
+/** \brief transfer mode macros for serial devices
+ **/
+#define ciaaSERIAL_TRANSFER_IRQ     (0)            /*!< interrupt driven transfers */
+#define ciaaSERIAL_TRANSFER_DMA     (1)            /*!< DMA driven transfers */
+
 /*==================[typedef]================================================*/
 
 /*==================[external data declaration]==============================*/
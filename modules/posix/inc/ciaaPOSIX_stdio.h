@@ -52,6 +52,7 @@
 #include "ciaaPOSIX_stddef.h"
 #include "ciaaPOSIX_ioctl_serial.h"
 #include "ciaaPOSIX_ioctl_block.h"
+#include <stdarg.h>
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -116,7 +117,49 @@ extern "C" {
 #define ciaaRESOLUTION_4BITS        6
 #define ciaaRESOLUTION_3BITS        7
 
+/** \brief start/stop the continuous acquisition of an analogic input device
+ **
+ ** This ioctl command scans the channels of arg continuously, arg is a
+ ** bit mask of (1 << ciaaCHANNEL_n), 0 stops the acquisition. The sample
+ ** rate set with ciaaPOSIX_IOCTL_SET_SAMPLE_RATE is shared by the scanned
+ ** channels. While scanning the samples are not read with ciaaPOSIX_read,
+ ** they are handed in blocks with ciaaPOSIX_IOCTL_GET_BLOCK.
+ **
+ ** Returned value for ioctl is 0 if success, -1 if a channel is not
+ ** supported.
+ **/
+#define ciaaPOSIX_IOCTL_SET_SCAN_CHANNELS              14
+
+/** \brief get the oldest block of samples of the continuous acquisition
+ **
+ ** This ioctl command fills the ciaaPOSIX_aioBlockType pointed by arg. The
+ ** samples are valid until the block is released with
+ ** ciaaPOSIX_IOCTL_RELEASE_BLOCK.
+ **
+ ** Returned value for ioctl is 0 if success, -1 if no block is available.
+ **/
+#define ciaaPOSIX_IOCTL_GET_BLOCK                      15
+
+/** \brief release the oldest block of samples of the continuous acquisition
+ **
+ ** Returned value for ioctl is 0 if success, -1 if no block is available.
+ **/
+#define ciaaPOSIX_IOCTL_RELEASE_BLOCK                  16
+
+/** \brief value of a sample of the continuous acquisition */
+#define ciaaAIO_SAMPLE_VALUE(sample)      ((uint16_t)((sample) & 0xFFFF))
+
+/** \brief channel (ciaaCHANNEL_n) of a sample of the continuous acquisition */
+#define ciaaAIO_SAMPLE_CHANNEL(sample)    ((uint8_t)((sample) >> 16))
+
 /*==================[typedef]================================================*/
+/** \brief block of samples of the continuous acquisition */
+typedef struct {
+   uint32_t const * samples;        /** <= samples, see ciaaAIO_SAMPLE_VALUE */
+   uint32_t count;                  /** <= count of samples */
+   uint32_t timestamp;              /** <= time of the last sample in cpu cycles */
+   uint32_t overruns;               /** <= blocks lost since the scan started */
+} ciaaPOSIX_aioBlockType;
 
 /*==================[external data declaration]==============================*/
 
@@ -246,8 +289,10 @@ extern off_t ciaaPOSIX_lseek(int32_t fildes, off_t offset, uint8_t whence);
 
 /** \brief print formated output
  **
- ** In Windows and posix this interface calls the system printf, in the CIAA HW
- ** calling this function has no effects
+ ** In Windows and posix this interface formats with ciaaPOSIX_vsnprintf and
+ ** writes to the system stdout, which is flushed only if the output ends a
+ ** line. In the CIAA HW calling this function has no effects, use
+ ** ciaaPOSIX_dprintf to print to a device.
  **
  ** \param[in] format
  **
@@ -256,6 +301,56 @@ extern off_t ciaaPOSIX_lseek(int32_t fildes, off_t offset, uint8_t whence);
  **/
 extern int32_t ciaaPOSIX_printf(const char * format, ...);
 
+/** \brief print formated output to a buffer
+ **
+ ** Formats as ciaaPOSIX_vsnprintf.
+ **
+ ** \param[out] str buffer to store the output
+ ** \param[in] size size of the buffer including the terminating null
+ ** \param[in] format format string
+ ** \return count of characters of the complete output without the
+ **         terminating null, if size or more the output was truncated
+ **/
+extern int32_t ciaaPOSIX_snprintf(char * str, size_t size, const char * format, ...);
+
+/** \brief print formated output with a variable argument list to a buffer
+ **
+ ** The formatter does not allocate memory, uses a constant amount of stack
+ ** and keeps no state, it may be called reentrant and from any task.
+ **
+ ** The conversion specifications are
+ ** %[flags][width][.precision][length]conversion with:
+ **   flags: - + space # 0
+ **   width and precision: a decimal number or *
+ **   length: hh h l ll j z t
+ **   conversion: d i u o x X c s p f F %
+ **
+ ** The conversion f prints the values as double, values which do not fit in
+ ** 64 bits are printed in exponential notation. Unknown conversions are
+ ** printed verbatim.
+ **
+ ** \param[out] str buffer to store the output, may be NULL if size is 0
+ ** \param[in] size size of the buffer including the terminating null
+ ** \param[in] format format string
+ ** \param[in] ap variable argument list
+ ** \return count of characters of the complete output without the
+ **         terminating null, if size or more the output was truncated
+ **/
+extern int32_t ciaaPOSIX_vsnprintf(char * str, size_t size, const char * format, va_list ap);
+
+/** \brief print formated output to a file descriptor
+ **
+ ** Formats as ciaaPOSIX_vsnprintf into a small buffer on the stack which is
+ ** written with ciaaPOSIX_write each time it is full, for a serial device the
+ ** output is copied directly to its tx ring buffer.
+ **
+ ** \param[in] fildes file descriptor
+ ** \param[in] format format string
+ ** \return -1 if failed, a non negative integer representing the count of
+ **         written bytes if success
+ **/
+extern int32_t ciaaPOSIX_dprintf(int32_t fildes, const char * format, ...);
+
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
 }
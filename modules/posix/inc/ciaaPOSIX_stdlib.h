@@ -64,7 +64,37 @@ extern "C" {
 /*@=namechecks@*/
 #endif
 
+/** \brief count of call sites of ciaaPOSIX_malloc which are recorded with
+ **        CIAA_CFG_MEMSTATS_CALLSITES */
+#ifndef CIAAPOSIX_HEAP_SITES
+#define CIAAPOSIX_HEAP_SITES        16
+#endif
+
 /*==================[typedef]================================================*/
+/** \brief statistics of the heap
+ **
+ ** The counters and the peak are only maintained if CIAA_CFG_MEMSTATS is
+ ** defined, in other case they are 0.
+ **/
+typedef struct {
+   uint32_t size;          /** <= size of the heap in bytes */
+   uint32_t used;          /** <= allocated bytes including the headers */
+   uint32_t peak;          /** <= maximal count of allocated bytes */
+   uint32_t largestFree;   /** <= biggest block which can be allocated */
+   uint32_t freeBlocks;    /** <= count of free blocks */
+   uint32_t fragmentation; /** <= per mille of the free memory which is not
+                                  in the largest free block */
+   uint32_t allocs;        /** <= count of successful allocations */
+   uint32_t frees;         /** <= count of frees */
+   uint32_t failed;        /** <= count of failed allocations */
+} ciaaPOSIX_heapStatsType;
+
+/** \brief allocations of a call site of ciaaPOSIX_malloc */
+typedef struct {
+   uintptr_t pc;           /** <= return address of the call */
+   uint32_t allocs;        /** <= count of successful allocations */
+   uint32_t bytes;         /** <= count of allocated bytes */
+} ciaaPOSIX_heapSiteType;
 
 /*==================[external data declaration]==============================*/
 
@@ -91,6 +121,25 @@ void *ciaaPOSIX_malloc(size_t size);
  **/
 void ciaaPOSIX_free(void *);
 
+/** \brief get the statistics of the heap
+ **
+ ** Walks the blocks of the heap, do not call it from an ISR.
+ **
+ ** \param[out] stats pointer to the statistics
+ **/
+void ciaaPOSIX_heapStats(ciaaPOSIX_heapStatsType * stats);
+
+/** \brief get the call sites of ciaaPOSIX_malloc
+ **
+ ** The call sites are only recorded if CIAA_CFG_MEMSTATS_CALLSITES is
+ ** defined, the first CIAAPOSIX_HEAP_SITES different callers are recorded.
+ **
+ ** \param[out] sites array to store the call sites
+ ** \param[in] count size of the array sites
+ ** \return count of call sites stored in sites
+ **/
+uint32_t ciaaPOSIX_heapSites(ciaaPOSIX_heapSiteType * sites, uint32_t count);
+
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
 }
@@ -51,10 +51,16 @@
 #include "ciaaPOSIX_errno.h"
 #include "ciaaLibs_CircBuf.h"
 #include "ciaak.h"       /* <= ciaa kernel header */
+#include "ciaak_Cfg.h"
 #include "os.h"
 
 /*==================[macros and definitions]=================================*/
-#define ciaaBlockDevices_MAXDEVICES          20
+#if (0 < CIAAK_BLOCK_DEVICES)
+#define ciaaBlockDevices_MAXDEVICES          CIAAK_BLOCK_DEVICES
+#else
+/* at least one entry, arrays of size 0 are not allowed */
+#define ciaaBlockDevices_MAXDEVICES          1
+#endif
 
 /*==================[typedef]================================================*/
 typedef struct {
@@ -64,6 +70,8 @@ typedef struct {
 
 typedef struct {
    ciaaDevices_deviceType const * device;
+   ciaaDevices_deviceType upDevice;
+   char path[CIAAK_PATH_SIZE];
    ciaaBlockDevices_blockerType blocked;
    uint8_t flags;
 } ciaaBlockDevices_deviceType;
@@ -123,8 +131,17 @@ extern void ciaaBlockDevices_addDriver(ciaaDevices_deviceType * driver)
    /* enter critical section */
    /* not needed, only 1 task running */
 
+   /* length of the path string of this device */
+   length = ciaaPOSIX_strlen(driver->path);
+   length += ciaaPOSIX_strlen(ciaaBlockDevices_prefix);
+   length += 2; /* for the / and the termination null */
+
+   /* the path has to fit in the planned path size */
+   ciaaPOSIX_assert(CIAAK_PATH_SIZE >= length);
+
    /* check if more drivers can be added */
-   if (ciaaBlockDevices_MAXDEVICES > ciaaBlockDevices.position) {
+   if ( (ciaaBlockDevices_MAXDEVICES > ciaaBlockDevices.position) &&
+        (CIAAK_PATH_SIZE >= length) ) {
 
       /* get position for next device */
       position = ciaaBlockDevices.position;
@@ -141,8 +158,8 @@ extern void ciaaBlockDevices_addDriver(ciaaDevices_deviceType * driver)
       /* initial flags */
       ciaaBlockDevices.devstr[position].flags = 0;
 
-      /* allocate memory for new device */
-      newDevice = (ciaaDevices_deviceType*) ciaak_malloc(sizeof(ciaaDevices_deviceType));
+      /* the new device is statically allocated with the device type */
+      newDevice = &ciaaBlockDevices.devstr[position].upDevice;
 
       /* set functions for this device */
       newDevice->open = ciaaBlockDevices_open;
@@ -159,13 +176,8 @@ extern void ciaaBlockDevices_addDriver(ciaaDevices_deviceType * driver)
       /* store newDevice layer information in the lower layer */
       driver->upLayer = newDevice;
 
-      /* create path string for this device */
-      length = ciaaPOSIX_strlen(driver->path);
-      length += ciaaPOSIX_strlen(ciaaBlockDevices_prefix);
-      length += 2; /* for the / and the termination null */
-
-      /* create path for the new device */
-      newDeviceName = (char *) ciaak_malloc(length);
+      /* path for the new device */
+      newDeviceName = ciaaBlockDevices.devstr[position].path;
 
       /* start a new string */
       *newDeviceName = 0;
@@ -260,6 +272,8 @@ extern ssize_t ciaaBlockDevices_read(ciaaDevices_deviceType const * const device
       ret = nbyte;
    }
 
+   ciaak_traceDeviceRead(device->path, ret);
+
    return ret;
 }
 
@@ -292,6 +306,8 @@ extern ssize_t ciaaBlockDevices_write(ciaaDevices_deviceType const * const devic
       ret = nbyte;
    }
 
+   ciaak_traceDeviceWrite(device->path, ret);
+
    return ret;
 }
 
@@ -45,17 +45,34 @@
 #include "ciaaDioDevices.h"
 #include "ciaaPOSIX_stdio.h"
 #include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_stdbool.h"
 #include "ciaaPOSIX_string.h"
 #include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_errno.h"
+#include "ciaaPOSIX_ioctl_dio.h"
+#include "ciaaPOSIX_ioctl_serial.h"
 #include "ciaak.h"            /* <= ciaa kernel header */
+#include "ciaak_Cfg.h"
 #include "os.h"
 
 /*==================[macros and definitions]=================================*/
-#define ciaaDioDevices_MAXDEVICES   20
+#if (0 < CIAAK_DIO_DEVICES)
+#define ciaaDioDevices_MAXDEVICES   CIAAK_DIO_DEVICES
+#else
+/* at least one entry, arrays of size 0 are not allowed */
+#define ciaaDioDevices_MAXDEVICES   1
+#endif
+#define ciaaDioDevices_NONBLOCK_MODE   0x01
+#define ciaaDioDevices_EVENT_MODE      0x02
+#define ciaaDioDevices_INVALID_TASK    255
 
 /*==================[typedef]================================================*/
 typedef struct {
    ciaaDevices_deviceType const * device;
+   ciaaDevices_deviceType upDevice;
+   char path[CIAAK_PATH_SIZE];
+   TaskType blocked;
+   uint8_t flags;
 } ciaaDioDevices_deviceType;
 
 /** \brief Dio Devices Type */
@@ -103,8 +120,17 @@ extern void ciaaDioDevices_addDriver(ciaaDevices_deviceType * driver)
    /* enter critical section */
    /* not needed, only 1 task running */
 
+   /* length of the path string of this device */
+   length = ciaaPOSIX_strlen(driver->path);
+   length += ciaaPOSIX_strlen(ciaaDioDevices_prefix);
+   length += 2; /* for the / and the termination null */
+
+   /* the path has to fit in the planned path size */
+   ciaaPOSIX_assert(CIAAK_PATH_SIZE >= length);
+
    /* check if more drivers can be added */
-   if (ciaaDioDevices_MAXDEVICES > ciaaDioDevices.position)
+   if ( (ciaaDioDevices_MAXDEVICES > ciaaDioDevices.position) &&
+        (CIAAK_PATH_SIZE >= length) )
    {
       /* get position for nexxt device */
       position = ciaaDioDevices.position;
@@ -118,8 +144,12 @@ extern void ciaaDioDevices_addDriver(ciaaDevices_deviceType * driver)
       /* add driver */
       ciaaDioDevices.devstr[position].device = driver;
 
-      /* allocate memory for new device */
-      newDevice = (ciaaDevices_deviceType*) ciaak_malloc(sizeof(ciaaDevices_deviceType));
+      /* no task blocked and initial flags */
+      ciaaDioDevices.devstr[position].blocked = ciaaDioDevices_INVALID_TASK;
+      ciaaDioDevices.devstr[position].flags = 0;
+
+      /* the new device is statically allocated with the device type */
+      newDevice = &ciaaDioDevices.devstr[position].upDevice;
 
       /* set functions for this device */
       newDevice->open = ciaaDioDevices_open;
@@ -135,13 +165,8 @@ extern void ciaaDioDevices_addDriver(ciaaDevices_deviceType * driver)
       /* store newDevice layer information in the lower layer */
       driver->upLayer = newDevice;
 
-      /* create path string for this device */
-      length = ciaaPOSIX_strlen(driver->path);
-      length += ciaaPOSIX_strlen(ciaaDioDevices_prefix);
-      length += 2; /* for the / and the termination null */
-
-      /* create path for the new device */
-      newDeviceName = (char*) ciaak_malloc(length);
+      /* path for the new device */
+      newDeviceName = ciaaDioDevices.devstr[position].path;
 
       /* start a new string */
       *newDeviceName = (char)0;
@@ -169,11 +194,18 @@ extern ciaaDevices_deviceType * ciaaDioDevices_open(char const * path,
       uint8_t const oflag)
 {
    ciaaDevices_deviceType * drv = (ciaaDevices_deviceType*) device->loLayer;
+   ciaaDioDevices_deviceType * dioDevice = (ciaaDioDevices_deviceType*) device->layer;
 
    /* serial devices does not support that the drivers update the device */
    /* the returned device shall be the same as passed */
    ciaaPOSIX_assert(drv->open(path, drv, oflag) == drv);
 
+   dioDevice->flags = 0;
+   if(oflag & ciaaPOSIX_O_NONBLOCK)
+   {
+      dioDevice->flags |= ciaaDioDevices_NONBLOCK_MODE;
+   }
+
    return device;
 }
 
@@ -188,8 +220,44 @@ extern int32_t ciaaDioDevices_ioctl(ciaaDevices_deviceType const * const device,
 {
    int32_t ret;
    ciaaDevices_deviceType * drv = (ciaaDevices_deviceType*) device->loLayer;
+   ciaaDioDevices_deviceType * dioDevice = (ciaaDioDevices_deviceType*) device->layer;
 
-   ret = drv->ioctl(drv, request, param);
+   switch(request)
+   {
+      case ciaaPOSIX_IOCTL_SET_NONBLOCK_MODE:
+         if((bool)(intptr_t)param == false)
+         {
+            /* Blocking mode */
+            dioDevice->flags &= ~ciaaDioDevices_NONBLOCK_MODE;
+         }
+         else
+         {
+            /* NonBlocking Mode */
+            dioDevice->flags |= ciaaDioDevices_NONBLOCK_MODE;
+         }
+         ret = 0;
+         break;
+
+      case ciaaPOSIX_IOCTL_DIO_SET_EVENTS:
+         ret = drv->ioctl(drv, request, param);
+         if(0 == ret)
+         {
+            /* the reads return events while some input generates them */
+            if(NULL != param)
+            {
+               dioDevice->flags |= ciaaDioDevices_EVENT_MODE;
+            }
+            else
+            {
+               dioDevice->flags &= ~ciaaDioDevices_EVENT_MODE;
+            }
+         }
+         break;
+
+      default:
+         ret = drv->ioctl(drv, request, param);
+         break;
+   }
 
    return ret;
 }
@@ -198,8 +266,40 @@ extern ssize_t ciaaDioDevices_read(ciaaDevices_deviceType const * const device,
 {
    ssize_t ret;
    ciaaDevices_deviceType * drv = (ciaaDevices_deviceType*) device->loLayer;
+   ciaaDioDevices_deviceType * dioDevice = (ciaaDioDevices_deviceType*) device->layer;
 
-   ret = drv->read(drv, buf, nbyte);
+   if((0 == (dioDevice->flags & ciaaDioDevices_EVENT_MODE)) ||
+      (sizeof(ciaaPOSIX_dioEventType) > nbyte))
+   {
+      ret = drv->read(drv, buf, nbyte);
+   }
+   else if(0 != (dioDevice->flags & ciaaDioDevices_NONBLOCK_MODE))
+   {
+      ret = drv->read(drv, buf, nbyte);
+      if(0 == ret)
+      {
+         /* shall return -1 and set errno to [EAGAIN] */
+         ciaaPOSIX_errno = EAGAIN;
+         ret = -1;
+      }
+   }
+   else
+   {
+      /* the task is registered before reading, an event queued meanwhile
+       * sets the task event and the wait returns at once */
+      GetTaskID(&dioDevice->blocked);
+      ret = drv->read(drv, buf, nbyte);
+      while(0 == ret)
+      {
+#ifdef POSIXE
+         WaitEvent(POSIXE);
+         ClearEvent(POSIXE);
+#endif
+         GetTaskID(&dioDevice->blocked);
+         ret = drv->read(drv, buf, nbyte);
+      }
+      dioDevice->blocked = ciaaDioDevices_INVALID_TASK;
+   }
 
    return ret;
 }
@@ -214,6 +314,23 @@ extern ssize_t ciaaDioDevices_write(ciaaDevices_deviceType const * const device,
    return ret;
 }
 
+extern void ciaaDioDevices_eventIndication(ciaaDevices_deviceType const * const device)
+{
+   ciaaDioDevices_deviceType * dioDevice = (ciaaDioDevices_deviceType*) device->layer;
+   TaskType taskID = dioDevice->blocked;
+
+   if(ciaaDioDevices_INVALID_TASK != taskID)
+   {
+      /* invalidate task id */
+      dioDevice->blocked = ciaaDioDevices_INVALID_TASK;
+
+#ifdef POSIXE
+      /* set task event */
+      SetEvent(taskID, POSIXE);
+#endif
+   }
+}
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /*==================[end of file]============================================*/
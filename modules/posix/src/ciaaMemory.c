@@ -32,9 +32,11 @@
  *
  */
 
-/** \brief CIAA Devices source file
+/** \brief CIAA Memory source file
  **
- ** This header file describes the Devices.
+ ** Memory allocation hooks and memory usage instrumentation. The stacks grow
+ ** to the lower addresses on all supported archs, the painted part starts
+ ** at the lowest address of each stack.
  **
  **/
 
@@ -44,18 +46,157 @@
  ** @{ */
 /*==================[inclusions]=============================================*/
 #include "ciaaMemory.h"
+#include "ciaaDevices.h"
+#include "ciaaPOSIX_stdio.h"
+#include "ciaaPOSIX_string.h"
+#include "ciaak_Cfg.h"
+#include "Os_Internal.h"
 
 /*==================[macros and definitions]=================================*/
 
 /*==================[internal data declaration]==============================*/
 
 /*==================[internal functions declaration]=========================*/
+static ciaaDevices_deviceType * ciaaMemory_open(char const * path,
+      ciaaDevices_deviceType * device, uint8_t const oflag);
+
+static int32_t ciaaMemory_close(ciaaDevices_deviceType const * const device);
+
+static int32_t ciaaMemory_ioctl(ciaaDevices_deviceType const * const device,
+      int32_t const request, void * param);
+
+static ssize_t ciaaMemory_read(ciaaDevices_deviceType const * const device,
+      uint8_t * const buf, size_t const nbyte);
+
+static ssize_t ciaaMemory_write(ciaaDevices_deviceType const * const device,
+      uint8_t const * const buf, size_t const nbyte);
+
+static off_t ciaaMemory_lseek(ciaaDevices_deviceType const * const device,
+      off_t const offset, uint8_t const whence);
 
 /*==================[internal data definition]===============================*/
+/** \brief painted bytes of each stack */
+static uint32_t ciaaMemory_painted[CIAAK_TASKS_COUNT];
+
+/** \brief statistics read from the device, taken at open */
+static ciaaMemory_statsType ciaaMemory_snapshot;
+
+/** \brief read position of the device */
+static off_t ciaaMemory_offset;
+
+/** \brief memory statistics device */
+static ciaaDevices_deviceType ciaaMemory_device = {
+   CIAAMEMORY_DEVICE_PATH,
+   ciaaMemory_open,
+   ciaaMemory_close,
+   ciaaMemory_read,
+   ciaaMemory_write,
+   ciaaMemory_ioctl,
+   ciaaMemory_lseek,
+   NULL,
+   NULL,
+   NULL
+};
 
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static ciaaDevices_deviceType * ciaaMemory_open(char const * path,
+      ciaaDevices_deviceType * device, uint8_t const oflag)
+{
+   ciaaDevices_deviceType * ret = NULL;
+
+   (void)path;
+   /* the statistics can only be read */
+   if (ciaaPOSIX_O_RDONLY == (oflag & (ciaaPOSIX_O_RDONLY | ciaaPOSIX_O_WRONLY | ciaaPOSIX_O_RDWR)))
+   {
+      ciaaMemory_getStats(&ciaaMemory_snapshot);
+      ciaaMemory_offset = 0;
+      ret = device;
+   }
+
+   return ret;
+} /* end ciaaMemory_open */
+
+static int32_t ciaaMemory_close(ciaaDevices_deviceType const * const device)
+{
+   (void)device;
+
+   return 0;
+} /* end ciaaMemory_close */
+
+static int32_t ciaaMemory_ioctl(ciaaDevices_deviceType const * const device,
+      int32_t const request, void * param)
+{
+   (void)device;
+   (void)request;
+   (void)param;
+
+   return -1;
+} /* end ciaaMemory_ioctl */
+
+static ssize_t ciaaMemory_read(ciaaDevices_deviceType const * const device,
+      uint8_t * const buf, size_t const nbyte)
+{
+   ssize_t ret = 0;
+
+   (void)device;
+   if (ciaaMemory_offset < (off_t)sizeof(ciaaMemory_snapshot))
+   {
+      ret = sizeof(ciaaMemory_snapshot) - ciaaMemory_offset;
+      if ((size_t)ret > nbyte)
+      {
+         ret = nbyte;
+      }
+      ciaaPOSIX_memcpy(buf, (uint8_t *)&ciaaMemory_snapshot + ciaaMemory_offset, ret);
+      ciaaMemory_offset += ret;
+   }
+
+   return ret;
+} /* end ciaaMemory_read */
+
+static ssize_t ciaaMemory_write(ciaaDevices_deviceType const * const device,
+      uint8_t const * const buf, size_t const nbyte)
+{
+   (void)device;
+   (void)buf;
+   (void)nbyte;
+
+   return -1;
+} /* end ciaaMemory_write */
+
+static off_t ciaaMemory_lseek(ciaaDevices_deviceType const * const device,
+      off_t const offset, uint8_t const whence)
+{
+   off_t ret = -1;
+
+   (void)device;
+   switch(whence)
+   {
+      case SEEK_SET:
+         ret = offset;
+         break;
+      case SEEK_CUR:
+         ret = ciaaMemory_offset + offset;
+         break;
+      case SEEK_END:
+         ret = sizeof(ciaaMemory_snapshot) + offset;
+         break;
+      default:
+         break;
+   }
+
+   if ((0 <= ret) && (ret <= (off_t)sizeof(ciaaMemory_snapshot)))
+   {
+      ciaaMemory_offset = ret;
+   }
+   else
+   {
+      ret = -1;
+   }
+
+   return ret;
+} /* end ciaaMemory_lseek */
 
 /*==================[external functions definition]==========================*/
 void* (*ciaaMemory_pfMalloc) (uint32_t size);
@@ -71,6 +212,86 @@ void ciaaMemory_SetFree (void (*pf) (void*))
    ciaaMemory_pfFree = pf;
 }
 
+extern void ciaaMemory_init(void)
+{
+   ciaaMemory_stackPaint();
+   ciaaDevices_addDevice(&ciaaMemory_device);
+} /* end ciaaMemory_init */
+
+extern void ciaaMemory_stackPaint(void)
+{
+   uint8_t marker; /* its address is near to the stack pointer */
+   TaskType running = INVALID_TASK;
+   TaskType task;
+   uint8_t * stack;
+   uint32_t size;
+
+   (void)GetTaskID(&running);
+
+   for(task = 0; task < CIAAK_TASKS_COUNT; task++)
+   {
+      stack = TasksConst[task].StackPtr;
+      size = 0;
+      if (running == task)
+      {
+         /* keep the frames of this function and of memset */
+         if ((&marker >= stack) &&
+             (&marker < &stack[TasksConst[task].StackSize]) &&
+             ((uint32_t)(&marker - stack) > CIAAMEMORY_STACK_MARGIN))
+         {
+            size = (&marker - stack) - CIAAMEMORY_STACK_MARGIN;
+         }
+      }
+      else if (TASK_ST_SUSPENDED == TasksVar[task].Flags.State)
+      {
+         /* not activated, the whole stack is unused */
+         size = TasksConst[task].StackSize;
+      }
+      else
+      {
+         /* the stack of an active task is unknown */
+      }
+      ciaaPOSIX_memset(stack, CIAAMEMORY_STACK_PATTERN, size);
+      ciaaMemory_painted[task] = size;
+   }
+} /* end ciaaMemory_stackPaint */
+
+extern int32_t ciaaMemory_getStackStats(uint32_t task,
+      ciaaMemory_stackStatsType * stats)
+{
+   int32_t ret = -1;
+   uint8_t const * stack;
+   uint32_t unused = 0;
+
+   if (CIAAK_TASKS_COUNT > task)
+   {
+      stack = TasksConst[task].StackPtr;
+      while ( (unused < ciaaMemory_painted[task]) &&
+              (CIAAMEMORY_STACK_PATTERN == stack[unused]) )
+      {
+         unused++;
+      }
+      stats->size = TasksConst[task].StackSize;
+      stats->painted = ciaaMemory_painted[task];
+      stats->highWater = stats->size - unused;
+      ret = 1;
+   }
+
+   return ret;
+} /* end ciaaMemory_getStackStats */
+
+extern void ciaaMemory_getStats(ciaaMemory_statsType * stats)
+{
+   uint32_t task;
+
+   ciaaPOSIX_heapStats(&stats->heap);
+   for(task = 0; (task < CIAAK_TASKS_COUNT) && (task < CIAAMEMORY_TASKS); task++)
+   {
+      (void)ciaaMemory_getStackStats(task, &stats->stack[task]);
+   }
+   stats->tasks = task;
+} /* end ciaaMemory_getStats */
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /*==================[end of file]============================================*/
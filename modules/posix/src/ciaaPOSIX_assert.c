@@ -42,22 +42,114 @@
  ** @{ */
 
 /*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_stdio.h"
+#include "os.h"
 
 /*==================[macros and definitions]=================================*/
+/** \brief marks a ring initialized, other values are left by a cold reset */
+#define ciaaPOSIX_ASSERT_MAGIC      0xA55E7C1AUL
+
+/** \brief the ring is not initialized by the startup code on the targets
+ **        whose linker scripts have a NOLOAD .noinit section */
+#if ( (ARCH == cortexM4) || (ARCH == cortexM0) )
+#define ciaaPOSIX_ASSERT_NOINIT     __attribute__ ((section (".noinit.ciaaPOSIX_assert")))
+#else
+#define ciaaPOSIX_ASSERT_NOINIT
+#endif
+
+/** \brief Assert ring type */
+typedef struct {
+   uint32_t magic;            /** <= ciaaPOSIX_ASSERT_MAGIC if initialized */
+   uint32_t count;            /** <= records written since cleared */
+   ciaaPOSIX_assertRecordType records[CIAAPOSIX_ASSERT_RECORDS];
+} ciaaPOSIX_assertRingType;
 
 /*==================[internal data declaration]==============================*/
 
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
+/** \brief records of the failures, survives a reset */
+static ciaaPOSIX_assertRingType ciaaPOSIX_assertRing ciaaPOSIX_ASSERT_NOINIT;
 
 /*==================[external data definition]===============================*/
 char const * const ciaaPOSIX_assert_msg = \
       "ASSERT Failed in %s:%d in expression %s\n";
 
 /*==================[internal functions definition]==========================*/
+/** \brief initializes the ring if it has not been since the power up */
+static void ciaaPOSIX_assertCheck(void)
+{
+   if(ciaaPOSIX_ASSERT_MAGIC != ciaaPOSIX_assertRing.magic)
+   {
+      ciaaPOSIX_assertRing.magic = ciaaPOSIX_ASSERT_MAGIC;
+      ciaaPOSIX_assertRing.count = 0;
+   }
+}
 
 /*==================[external functions definition]==========================*/
+extern void ciaaPOSIX_assertRecord(char const * file, uint32_t line, uintptr_t pc)
+{
+   ciaaPOSIX_assertRecordType * record;
+   TaskType taskID = CIAAPOSIX_ASSERT_NO_TASK;
+
+   (void)GetTaskID(&taskID);
+
+   ciaaPOSIX_assertCheck();
+   record = &ciaaPOSIX_assertRing.records[ciaaPOSIX_assertRing.count &
+      (CIAAPOSIX_ASSERT_RECORDS - 1)];
+   record->file = file;
+   record->pc = pc;
+   record->line = (uint16_t)line;
+   record->task = (uint8_t)taskID;
+   ciaaPOSIX_assertRing.count++;
+}
+
+extern void ciaaPOSIX_assertFailed(char const * file, int32_t line, char const * expr)
+{
+   /* the caller is the code with the failed assertion */
+   ciaaPOSIX_assertRecord(file, (uint32_t)line,
+         (uintptr_t)__builtin_return_address(0));
+
+   (void)ciaaPOSIX_printf(ciaaPOSIX_assert_msg, file, line, expr);
+   while(1==1);
+}
+
+extern uint32_t ciaaPOSIX_assertGetRecords(ciaaPOSIX_assertRecordType * records,
+      uint32_t count)
+{
+   uint32_t first;
+   uint32_t ret;
+
+   ciaaPOSIX_assertCheck();
+
+   /* the older records have been overwritten */
+   ret = ciaaPOSIX_assertRing.count;
+   if(ret > CIAAPOSIX_ASSERT_RECORDS)
+   {
+      ret = CIAAPOSIX_ASSERT_RECORDS;
+   }
+   if(ret > count)
+   {
+      ret = count;
+   }
+
+   first = ciaaPOSIX_assertRing.count - ret;
+   for(count = 0; count < ret; count++)
+   {
+      records[count] = ciaaPOSIX_assertRing.records[(first + count) &
+         (CIAAPOSIX_ASSERT_RECORDS - 1)];
+   }
+
+   return ret;
+}
+
+extern void ciaaPOSIX_assertClear(void)
+{
+   ciaaPOSIX_assertRing.magic = ciaaPOSIX_ASSERT_MAGIC;
+   ciaaPOSIX_assertRing.count = 0;
+}
 
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
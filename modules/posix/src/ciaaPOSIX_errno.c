@@ -43,6 +43,8 @@
 
 /*==================[inclusions]=============================================*/
 #include "ciaaPOSIX_errno.h"
+#include "ciaak_Cfg.h"
+#include "os.h"
 
 /*==================[macros and definitions]=================================*/
 
@@ -51,14 +53,29 @@
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
+/** \brief Error value of each task, the last one is for the interrupts
+ ** and the code running before the os
+ **/
+static int16_t ciaaPOSIX_errnos[CIAAK_TASKS_COUNT + 1];
 
 /*==================[external data definition]===============================*/
-/** \brief Error value */
-int16_t ciaaPOSIX_errno;
 
 /*==================[internal functions definition]==========================*/
 
 /*==================[external functions definition]==========================*/
+extern int16_t * ciaaPOSIX_errnoLocation(void)
+{
+   TaskType taskID = CIAAK_TASKS_COUNT;
+
+   /* the interrupts and the code before the os get an invalid task id */
+   (void)GetTaskID(&taskID);
+   if(CIAAK_TASKS_COUNT <= taskID)
+   {
+      taskID = CIAAK_TASKS_COUNT;
+   }
+
+   return &ciaaPOSIX_errnos[taskID];
+}
 
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
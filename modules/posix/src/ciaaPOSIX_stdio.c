@@ -57,6 +57,36 @@
 #endif
 
 /*==================[macros and definitions]=================================*/
+/** \brief size of the buffer on the stack of ciaaPOSIX_dprintf and
+ ** ciaaPOSIX_printf */
+#ifndef ciaaPOSIX_printf_CHUNK
+#define ciaaPOSIX_printf_CHUNK         64
+#endif
+
+/** \brief maximal digits of the fraction printed by the conversion f, the
+ ** remaining digits of the precision are printed as 0 */
+#define ciaaPOSIX_printf_FRACTION      17
+
+/** \brief characters to convert a 64 bits value or a double */
+#define ciaaPOSIX_printf_DIGITS        48
+
+/** \brief conversion flag - */
+#define ciaaPOSIX_printf_LEFT          0x01
+
+/** \brief conversion flag + */
+#define ciaaPOSIX_printf_PLUS          0x02
+
+/** \brief conversion flag space */
+#define ciaaPOSIX_printf_SPACE         0x04
+
+/** \brief conversion flag # */
+#define ciaaPOSIX_printf_ALT           0x08
+
+/** \brief conversion flag 0 */
+#define ciaaPOSIX_printf_ZERO          0x10
+
+/** \brief upper case conversion */
+#define ciaaPOSIX_printf_UPPER         0x20
 
 /*==================[internal data declaration]==============================*/
 /** \brief Filedescriptor type */
@@ -64,9 +94,43 @@ typedef struct {
    ciaaDevices_deviceType * device;
 } ciaaPOSIX_stdio_fildesType;
 
+/** \brief output of the formatter
+ **
+ ** The output is stored in a buffer provided by the caller, when the buffer
+ ** is full it is passed to the flush function or, without it, the rest of
+ ** the output is only counted.
+ **/
+typedef struct ciaaPOSIX_printf_outStruct {
+   char * buffer;                         /** <= buffer of the output */
+   size_t size;                           /** <= characters the buffer can store */
+   size_t used;                           /** <= characters stored in the buffer */
+   int32_t count;                         /** <= characters of the output */
+   char last;                             /** <= last character of the output */
+   int32_t fildes;                        /** <= file descriptor to be flushed to */
+   bool failed;                           /** <= the flush failed */
+   void (*flush)(struct ciaaPOSIX_printf_outStruct * out);
+} ciaaPOSIX_printf_outType;
+
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
+/** \brief pairs of decimal digits of the values 0 to 99 */
+static char const ciaaPOSIX_printf_pairs[] =
+   "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+   "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+   "8081828384858687888990919293949596979899";
+
+/** \brief hexadecimal digits in lower and upper case */
+static char const ciaaPOSIX_printf_hex[] = "0123456789abcdef0123456789ABCDEF";
+
+/** \brief powers of 10 up to the maximal fraction */
+static uint64_t const ciaaPOSIX_printf_pow10[ciaaPOSIX_printf_FRACTION + 1] = {
+   1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+   10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+   100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+   100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+   100000000000000000ULL
+};
 
 /*==================[external data definition]===============================*/
 /** \brief List of files descriptors */
@@ -76,6 +140,685 @@ ciaaPOSIX_stdio_fildesType ciaaPOSIX_stdio_fildes[ciaaPOSIX_stdio_MAXFILDES];
 char const * const ciaaPOSIX_stdio_devPrefix = "/dev";
 
 /*==================[internal functions definition]==========================*/
+/** \brief store characters in the output */
+static void ciaaPOSIX_printf_put(ciaaPOSIX_printf_outType * out,
+      char const * str, size_t length)
+{
+   size_t chunk;
+   size_t loopi;
+
+   if (0 < length)
+   {
+      out->count += length;
+      out->last = str[length - 1];
+   }
+
+   while (0 < length)
+   {
+      if (out->used == out->size)
+      {
+         if (NULL == out->flush)
+         {
+            /* the rest of the output is only counted */
+            length = 0;
+            break;
+         }
+         out->flush(out);
+      }
+
+      chunk = out->size - out->used;
+      if (chunk > length)
+      {
+         chunk = length;
+      }
+      for (loopi = 0; loopi < chunk; loopi++)
+      {
+         out->buffer[out->used + loopi] = str[loopi];
+      }
+      out->used += chunk;
+      str += chunk;
+      length -= chunk;
+   }
+}
+
+/** \brief store a character repeated in the output */
+static void ciaaPOSIX_printf_pad(ciaaPOSIX_printf_outType * out,
+      char c, int32_t count)
+{
+   static char const spaces[] = "                ";
+   static char const zeros[] = "0000000000000000";
+   char const * pad = ('0' == c) ? zeros : spaces;
+   int32_t chunk;
+
+   while (0 < count)
+   {
+      chunk = (count > (int32_t)(sizeof(spaces) - 1)) ?
+         (int32_t)(sizeof(spaces) - 1) : count;
+      ciaaPOSIX_printf_put(out, pad, chunk);
+      count -= chunk;
+   }
+}
+
+/** \brief write the buffer of the output to its file descriptor */
+static void ciaaPOSIX_printf_flushFildes(ciaaPOSIX_printf_outType * out)
+{
+   if ((0 < out->used) &&
+       ((ssize_t)out->used != ciaaPOSIX_write(out->fildes, out->buffer, out->used)))
+   {
+      out->failed = true;
+   }
+   out->used = 0;
+}
+
+#if (ARCH == x86)
+/** \brief write the buffer of the output to the stdout of the host */
+static void ciaaPOSIX_printf_flushStdout(ciaaPOSIX_printf_outType * out)
+{
+   if ((0 < out->used) &&
+       (out->used != fwrite(out->buffer, 1, out->used, stdout)))
+   {
+      out->failed = true;
+   }
+   out->used = 0;
+}
+#endif
+
+/** \brief convert an unsigned value to digits
+ **
+ ** The digits are stored backwards ending before end. The decimal values
+ ** are converted two digits at once and with 32 bits divisions as soon as
+ ** the value fits, as the targets have no 64 bits division instruction.
+ **
+ ** \param[in] end end of the buffer of the digits
+ ** \param[in] value value to be converted
+ ** \param[in] base 8, 10 or 16
+ ** \param[in] upper use upper case hexadecimal digits
+ ** \return count of digits, 0 if the value is 0
+ **/
+static int32_t ciaaPOSIX_printf_digits(char * end, uint64_t value,
+      uint32_t base, bool upper)
+{
+   char const * hex = &ciaaPOSIX_printf_hex[upper ? 16 : 0];
+   char * digit = end;
+   uint32_t value32;
+   uint32_t pair;
+   uint32_t shift = (8 == base) ? 3 : 4;
+
+   if (10 == base)
+   {
+      while (value > 0xFFFFFFFFULL)
+      {
+         pair = (uint32_t)(value % 100);
+         value /= 100;
+         *--digit = ciaaPOSIX_printf_pairs[2 * pair + 1];
+         *--digit = ciaaPOSIX_printf_pairs[2 * pair];
+      }
+      value32 = (uint32_t)value;
+      while (100 <= value32)
+      {
+         pair = value32 % 100;
+         value32 /= 100;
+         *--digit = ciaaPOSIX_printf_pairs[2 * pair + 1];
+         *--digit = ciaaPOSIX_printf_pairs[2 * pair];
+      }
+      if (10 <= value32)
+      {
+         *--digit = ciaaPOSIX_printf_pairs[2 * value32 + 1];
+         *--digit = ciaaPOSIX_printf_pairs[2 * value32];
+      }
+      else if (0 < value32)
+      {
+         *--digit = (char)('0' + value32);
+      }
+   }
+   else
+   {
+      while (0 < value)
+      {
+         *--digit = hex[value & (base - 1)];
+         value >>= shift;
+      }
+   }
+
+   return (int32_t)(end - digit);
+}
+
+/** \brief store a converted number with its padding
+ **
+ ** \param[inout] out output
+ ** \param[in] flags conversion flags
+ ** \param[in] width minimal width of the field
+ ** \param[in] prefix sign and prefix of the number
+ ** \param[in] zeros zeros between the prefix and the digits
+ ** \param[in] digits digits of the number
+ ** \param[in] count count of digits
+ ** \param[in] trailing zeros after the digits
+ **/
+static void ciaaPOSIX_printf_number(ciaaPOSIX_printf_outType * out,
+      uint32_t flags, int32_t width, char const * prefix, int32_t zeros,
+      char const * digits, int32_t count, int32_t trailing)
+{
+   int32_t prefixLength = 0;
+   int32_t pad;
+
+   while ('\0' != prefix[prefixLength])
+   {
+      prefixLength++;
+   }
+
+   pad = width - prefixLength - zeros - count - trailing;
+
+   if (ciaaPOSIX_printf_ZERO & flags)
+   {
+      /* the zeros are placed after the prefix */
+      zeros += (0 < pad) ? pad : 0;
+      pad = 0;
+   }
+   if (!(ciaaPOSIX_printf_LEFT & flags))
+   {
+      ciaaPOSIX_printf_pad(out, ' ', pad);
+   }
+   ciaaPOSIX_printf_put(out, prefix, prefixLength);
+   ciaaPOSIX_printf_pad(out, '0', zeros);
+   ciaaPOSIX_printf_put(out, digits, count);
+   ciaaPOSIX_printf_pad(out, '0', trailing);
+   if (ciaaPOSIX_printf_LEFT & flags)
+   {
+      ciaaPOSIX_printf_pad(out, ' ', pad);
+   }
+}
+
+/** \brief convert the fraction of a double to decimal digits
+ **
+ ** The fraction is converted exactly as a fixed point number of 128 bits,
+ ** each digit is taken from the carry of a multiplication by 10 done with
+ ** 32 bits words. The digits are rounded to the nearest and the ties to
+ ** the even digit, as the host does.
+ **
+ ** \param[in] value fraction to be converted, 0 <= value < 1
+ ** \param[in] fraction count of digits, up to ciaaPOSIX_printf_FRACTION
+ ** \param[in] odd the digit before the fraction is odd
+ ** \param[out] decimals digits of the fraction
+ ** \return true if the rounding carries to the integer part
+ **/
+static bool ciaaPOSIX_printf_fraction(double value, int32_t fraction,
+      bool odd, uint64_t * decimals)
+{
+   uint32_t words[4];
+   uint64_t mantissa;
+   uint64_t high = 0;
+   uint64_t low = 0;
+   uint64_t product;
+   uint32_t carry;
+   int32_t shift;
+   int32_t loopi;
+   int32_t loopj;
+   bool ret = false;
+   union {
+      double value;
+      uint64_t raw;
+   } bits;
+
+   /* value * 2^128 = mantissa * 2^(exponent - 1075 + 128), the bits lost
+    * by a right shift are below the 17 digits and below their half */
+   bits.value = value;
+   mantissa = bits.raw & 0x000FFFFFFFFFFFFFULL;
+   shift = (int32_t)((bits.raw >> 52) & 0x7FF);
+   if (0 == shift)
+   {
+      /* zero or subnormal */
+      shift = 1;
+   }
+   else
+   {
+      mantissa |= 0x0010000000000000ULL;
+   }
+   shift -= 1075 - 128;
+   if (64 <= shift)
+   {
+      high = mantissa << (shift - 64);
+   }
+   else if (0 < shift)
+   {
+      high = mantissa >> (64 - shift);
+      low = mantissa << shift;
+   }
+   else if (-64 < shift)
+   {
+      low = mantissa >> -shift;
+   }
+   words[0] = (uint32_t)(high >> 32);
+   words[1] = (uint32_t)high;
+   words[2] = (uint32_t)(low >> 32);
+   words[3] = (uint32_t)low;
+
+   *decimals = 0;
+   for (loopi = 0; loopi < fraction; loopi++)
+   {
+      carry = 0;
+      for (loopj = 3; loopj >= 0; loopj--)
+      {
+         product = (uint64_t)words[loopj] * 10 + carry;
+         words[loopj] = (uint32_t)product;
+         carry = (uint32_t)(product >> 32);
+      }
+      *decimals = *decimals * 10 + carry;
+      odd = (0 != (carry & 1));
+   }
+
+   /* the remainder is compared with the half */
+   if ((0x80000000UL < words[0]) ||
+       ((0x80000000UL == words[0]) &&
+        ((0 != (words[1] | words[2] | words[3])) || odd)))
+   {
+      (*decimals)++;
+      if (ciaaPOSIX_printf_pow10[fraction] == *decimals)
+      {
+         *decimals = 0;
+         ret = true;
+      }
+   }
+
+   return ret;
+}
+
+/** \brief convert a double with the conversion f
+ **
+ ** \param[inout] out output
+ ** \param[in] flags conversion flags
+ ** \param[in] width minimal width of the field
+ ** \param[in] precision digits of the fraction or -1 for the default
+ ** \param[in] value value to be converted
+ ** \param[in] sign sign to be printed for positive values or 0
+ **/
+static void ciaaPOSIX_printf_double(ciaaPOSIX_printf_outType * out,
+      uint32_t flags, int32_t width, int32_t precision, double value,
+      char sign)
+{
+   char digits[ciaaPOSIX_printf_DIGITS];
+   char * end = &digits[ciaaPOSIX_printf_DIGITS];
+   char prefix[2] = { '\0', '\0' };
+   bool upper = (0 != (ciaaPOSIX_printf_UPPER & flags));
+   int32_t fraction;
+   int32_t count;
+   int32_t exponent = 0;
+   uint64_t integer;
+   uint64_t decimals = 0;
+   int32_t loopi;
+   union {
+      double value;
+      uint64_t raw;
+   } bits;
+
+   if (0 > precision)
+   {
+      precision = 6;
+   }
+   fraction = (precision > ciaaPOSIX_printf_FRACTION) ?
+      ciaaPOSIX_printf_FRACTION : precision;
+
+   /* the sign is taken from its bit to print -0 and -nan */
+   bits.value = value;
+   if (0 != (bits.raw >> 63))
+   {
+      value = -value;
+      sign = '-';
+   }
+   prefix[0] = sign;
+
+   if (value != value)
+   {
+      ciaaPOSIX_printf_number(out, flags & ~ciaaPOSIX_printf_ZERO, width,
+            prefix, 0, upper ? "NAN" : "nan", 3, 0);
+   }
+   else if (value > 1.7976931348623157e308)
+   {
+      ciaaPOSIX_printf_number(out, flags & ~ciaaPOSIX_printf_ZERO, width,
+            prefix, 0, upper ? "INF" : "inf", 3, 0);
+   }
+   else
+   {
+      if (1e19 <= value)
+      {
+         /* the integer part does not fit, use exponential notation */
+         while (10 <= value)
+         {
+            value /= 10;
+            exponent++;
+         }
+      }
+
+      /* the fraction is exact after the integer part is subtracted */
+      integer = (uint64_t)value;
+      if (ciaaPOSIX_printf_fraction(value - (double)integer, fraction,
+               0 != (integer & 1), &decimals))
+      {
+         integer++;
+      }
+      if ((0 != exponent) && (10 <= integer))
+      {
+         /* the mantissa has been rounded up to 10 */
+         integer = 1;
+         exponent++;
+      }
+
+      if (0 != exponent)
+      {
+         count = ciaaPOSIX_printf_digits(end, exponent, 10, false);
+         end -= count;
+         if (2 > count)
+         {
+            *--end = '0';
+         }
+         *--end = '+';
+         *--end = upper ? 'E' : 'e';
+         /* the precision is limited to the digits of the fraction */
+         precision = fraction;
+      }
+      if (0 < fraction)
+      {
+         count = ciaaPOSIX_printf_digits(end, decimals, 10, false);
+         end -= count;
+         for (loopi = count; loopi < fraction; loopi++)
+         {
+            *--end = '0';
+         }
+      }
+      if ((0 < precision) || (ciaaPOSIX_printf_ALT & flags))
+      {
+         *--end = '.';
+      }
+      count = ciaaPOSIX_printf_digits(end, integer, 10, false);
+      end -= count;
+      if (0 == count)
+      {
+         *--end = '0';
+      }
+
+      ciaaPOSIX_printf_number(out, flags, width, prefix, 0, end,
+            (int32_t)(&digits[ciaaPOSIX_printf_DIGITS] - end),
+            precision - fraction);
+   }
+}
+
+/** \brief format to an output
+ **
+ ** \param[inout] out output
+ ** \param[in] format format string
+ ** \param[in] ap variable argument list
+ **/
+static void ciaaPOSIX_printf_format(ciaaPOSIX_printf_outType * out,
+      char const * format, va_list ap)
+{
+   char digits[ciaaPOSIX_printf_DIGITS];
+   char * end = &digits[ciaaPOSIX_printf_DIGITS];
+   char const * start;
+   char const * str;
+   char prefix[3];
+   char sign;
+   uint32_t flags;
+   uint32_t base;
+   int32_t width;
+   int32_t precision;
+   int32_t length;
+   int32_t count;
+   int32_t zeros;
+   uint64_t value;
+   bool isSigned;
+   char c;
+
+   while ('\0' != *format)
+   {
+      /* store the characters up to the next conversion at once */
+      start = format;
+      while (('\0' != *format) && ('%' != *format))
+      {
+         format++;
+      }
+      ciaaPOSIX_printf_put(out, start, format - start);
+      if ('\0' == *format)
+      {
+         break;
+      }
+      start = format++;
+
+      /* flags */
+      flags = 0;
+      for (;; format++)
+      {
+         if ('-' == *format)
+         {
+            flags |= ciaaPOSIX_printf_LEFT;
+         }
+         else if ('+' == *format)
+         {
+            flags |= ciaaPOSIX_printf_PLUS;
+         }
+         else if (' ' == *format)
+         {
+            flags |= ciaaPOSIX_printf_SPACE;
+         }
+         else if ('#' == *format)
+         {
+            flags |= ciaaPOSIX_printf_ALT;
+         }
+         else if ('0' == *format)
+         {
+            flags |= ciaaPOSIX_printf_ZERO;
+         }
+         else
+         {
+            break;
+         }
+      }
+
+      /* width */
+      width = 0;
+      if ('*' == *format)
+      {
+         width = va_arg(ap, int);
+         if (0 > width)
+         {
+            flags |= ciaaPOSIX_printf_LEFT;
+            width = -width;
+         }
+         format++;
+      }
+      while (('0' <= *format) && ('9' >= *format))
+      {
+         width = 10 * width + (*format++ - '0');
+      }
+
+      /* precision */
+      precision = -1;
+      if ('.' == *format)
+      {
+         format++;
+         precision = 0;
+         if ('*' == *format)
+         {
+            precision = va_arg(ap, int);
+            format++;
+         }
+         while (('0' <= *format) && ('9' >= *format))
+         {
+            precision = 10 * precision + (*format++ - '0');
+         }
+      }
+      if (ciaaPOSIX_printf_LEFT & flags)
+      {
+         flags &= ~ciaaPOSIX_printf_ZERO;
+      }
+
+      /* length, counted in the size of int */
+      length = 0;
+      if ('h' == *format)
+      {
+         length = ('h' == *++format) ? -2 : -1;
+         format += (-2 == length) ? 1 : 0;
+      }
+      else if ('l' == *format)
+      {
+         length = ('l' == *++format) ? 2 : 1;
+         format += (2 == length) ? 1 : 0;
+      }
+      else if (('j' == *format) || ('z' == *format) || ('t' == *format))
+      {
+         length = ('j' == *format) ? 2 :
+            ((sizeof(size_t) == sizeof(long long)) ? 2 : 1);
+         format++;
+      }
+
+      c = *format++;
+      isSigned = false;
+      base = 10;
+      sign = '\0';
+      switch (c)
+      {
+         case 'd':
+         case 'i':
+            isSigned = true;
+            break;
+         case 'o':
+            base = 8;
+            break;
+         case 'X':
+            flags |= ciaaPOSIX_printf_UPPER;
+            /* fall through */
+         case 'x':
+            base = 16;
+            break;
+         case 'p':
+            base = 16;
+            flags |= ciaaPOSIX_printf_ALT;
+            length = (sizeof(void *) == sizeof(long long)) ? 2 : 1;
+            break;
+         case 'u':
+            break;
+
+         case 'c':
+            digits[0] = (char)va_arg(ap, int);
+            ciaaPOSIX_printf_number(out, flags & ~ciaaPOSIX_printf_ZERO,
+                  width, "", 0, digits, 1, 0);
+            continue;
+
+         case 's':
+            str = va_arg(ap, char const *);
+            if (NULL == str)
+            {
+               str = "(null)";
+            }
+            for (count = 0; ((0 > precision) || (count < precision)) &&
+                  ('\0' != str[count]); count++)
+            {
+            }
+            ciaaPOSIX_printf_number(out, flags & ~ciaaPOSIX_printf_ZERO,
+                  width, "", 0, str, count, 0);
+            continue;
+
+         case 'F':
+            flags |= ciaaPOSIX_printf_UPPER;
+            /* fall through */
+         case 'f':
+            sign = (ciaaPOSIX_printf_PLUS & flags) ? '+' :
+               ((ciaaPOSIX_printf_SPACE & flags) ? ' ' : '\0');
+            ciaaPOSIX_printf_double(out, flags, width, precision,
+                  va_arg(ap, double), sign);
+            continue;
+
+         case '%':
+            ciaaPOSIX_printf_put(out, "%", 1);
+            continue;
+
+         default:
+            /* unknown conversion, printed verbatim */
+            if ('\0' == c)
+            {
+               format--;
+            }
+            ciaaPOSIX_printf_put(out, start, format - start);
+            continue;
+      }
+
+      /* get the integer argument */
+      if ('p' == c)
+      {
+         value = (uintptr_t)va_arg(ap, void *);
+      }
+      else if (2 == length)
+      {
+         value = isSigned ? (uint64_t)va_arg(ap, long long) :
+            va_arg(ap, unsigned long long);
+      }
+      else if (1 == length)
+      {
+         value = isSigned ? (uint64_t)(long long)va_arg(ap, long) :
+            va_arg(ap, unsigned long);
+      }
+      else
+      {
+         value = isSigned ? (uint64_t)(long long)va_arg(ap, int) :
+            va_arg(ap, unsigned int);
+         if (-2 == length)
+         {
+            value = isSigned ? (uint64_t)(long long)(signed char)value :
+               (unsigned char)value;
+         }
+         else if (-1 == length)
+         {
+            value = isSigned ? (uint64_t)(long long)(short)value :
+               (unsigned short)value;
+         }
+      }
+
+      /* sign and prefix */
+      count = 0;
+      if (isSigned)
+      {
+         if ((long long)value < 0)
+         {
+            value = -value;
+            prefix[count++] = '-';
+         }
+         else if (ciaaPOSIX_printf_PLUS & flags)
+         {
+            prefix[count++] = '+';
+         }
+         else if (ciaaPOSIX_printf_SPACE & flags)
+         {
+            prefix[count++] = ' ';
+         }
+      }
+      else if ((16 == base) && (ciaaPOSIX_printf_ALT & flags) && (0 != value))
+      {
+         prefix[count++] = '0';
+         prefix[count++] = (ciaaPOSIX_printf_UPPER & flags) ? 'X' : 'x';
+      }
+      prefix[count] = '\0';
+
+      count = ciaaPOSIX_printf_digits(end, value, base,
+            0 != (ciaaPOSIX_printf_UPPER & flags));
+
+      /* the precision is the minimal count of digits */
+      if (0 <= precision)
+      {
+         flags &= ~ciaaPOSIX_printf_ZERO;
+      }
+      else
+      {
+         precision = 1;
+      }
+      zeros = (precision > count) ? precision - count : 0;
+      if ((8 == base) && (ciaaPOSIX_printf_ALT & flags) && (0 == zeros))
+      {
+         /* the octal alternative form starts with 0 */
+         zeros = 1;
+      }
+
+      ciaaPOSIX_printf_number(out, flags, width, prefix, zeros, end - count,
+            count, 0);
+   }
+}
 
 /*==================[external functions definition]==========================*/
 void ciaaPOSIX_init(void)
@@ -312,14 +1055,24 @@ extern int32_t ciaaPOSIX_printf(const char * format, ...)
    int32_t ret;
 
 #if (ARCH == x86)
-   /* call vprintf passing all received parameters */
+   char buffer[ciaaPOSIX_printf_CHUNK];
+   ciaaPOSIX_printf_outType out = {
+      buffer, sizeof(buffer), 0, 0, '\0', -1, false, ciaaPOSIX_printf_flushStdout
+   };
    va_list args;
+
    va_start(args, format);
-   ret = vprintf(format, args);
+   ciaaPOSIX_printf_format(&out, format, args);
    va_end(args);
+   ciaaPOSIX_printf_flushStdout(&out);
+
    /* Fixes a Bug in Eclipse (173732) print to the console */
    /* See issue CIAA Firmware issue #35: https://github.com/ciaa/Firmware/issues/35 */
-   fflush(stdout);
+   if ('\n' == out.last)
+   {
+      fflush(stdout);
+   }
+   ret = out.failed ? -1 : out.count;
 #else
    /* parameter format is not used in no win nor posix arch, casted to void to
     * avoid compiler warning */
@@ -331,6 +1084,50 @@ extern int32_t ciaaPOSIX_printf(const char * format, ...)
    return ret;
 }
 
+extern int32_t ciaaPOSIX_snprintf(char * str, size_t size, const char * format, ...)
+{
+   int32_t ret;
+   va_list args;
+
+   va_start(args, format);
+   ret = ciaaPOSIX_vsnprintf(str, size, format, args);
+   va_end(args);
+
+   return ret;
+}
+
+extern int32_t ciaaPOSIX_vsnprintf(char * str, size_t size, const char * format, va_list ap)
+{
+   /* one character of the buffer is kept for the terminating null */
+   ciaaPOSIX_printf_outType out = {
+      str, (0 < size) ? size - 1 : 0, 0, 0, '\0', -1, false, NULL
+   };
+
+   ciaaPOSIX_printf_format(&out, format, ap);
+   if (0 < size)
+   {
+      str[out.used] = '\0';
+   }
+
+   return out.count;
+}
+
+extern int32_t ciaaPOSIX_dprintf(int32_t fildes, const char * format, ...)
+{
+   char buffer[ciaaPOSIX_printf_CHUNK];
+   ciaaPOSIX_printf_outType out = {
+      buffer, sizeof(buffer), 0, 0, '\0', fildes, false, ciaaPOSIX_printf_flushFildes
+   };
+   va_list args;
+
+   va_start(args, format);
+   ciaaPOSIX_printf_format(&out, format, args);
+   va_end(args);
+   ciaaPOSIX_printf_flushFildes(&out);
+
+   return out.failed ? -1 : out.count;
+}
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /*==================[end of file]============================================*/
@@ -48,10 +48,14 @@
 /*==================[inclusions]=============================================*/
 #include "ciaaPOSIX_stdlib.h"
 #include "ciaaPOSIX_stdint.h"
+#include "ciaak_Cfg.h"
 
 /*==================[macros and definitions]=================================*/
 
+#ifndef CIAA_HEAP_MEM_SIZE
+/** \brief size of the heap if not given by the generated configuration */
 #define CIAA_HEAP_MEM_SIZE 20000
+#endif
 #define CIAA_POSIX_STDLIB_AVAILABLE 1
 #define CIAA_POSIX_STDLIB_USED 0
 
@@ -83,6 +87,22 @@ static char ciaaPOSIX_buffer[CIAA_HEAP_MEM_SIZE];
 /** \brief ciaa POSIX sempahore */
 sem_t ciaaPOSIX_stdlib_sem;
 
+/** \brief statistics without counters */
+static ciaaPOSIX_heapStatsType const ciaaPOSIX_heapEmpty = { 0 };
+
+#ifdef CIAA_CFG_MEMSTATS
+/** \brief counters of the heap, the layout part is computed on request */
+static ciaaPOSIX_heapStatsType ciaaPOSIX_heapCounters;
+
+/** \brief allocated bytes including the headers */
+static uint32_t ciaaPOSIX_heapUsed;
+#endif
+
+#ifdef CIAA_CFG_MEMSTATS_CALLSITES
+/** \brief call sites of ciaaPOSIX_malloc */
+static ciaaPOSIX_heapSiteType ciaaPOSIX_heapSitesTable[CIAAPOSIX_HEAP_SITES];
+#endif
+
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
@@ -106,15 +126,56 @@ static void ciaaPOSIX_chunk_partition(ciaaPOSIX_chunk_header *chunk_header, uint
   chunk_header->is_available = CIAA_POSIX_STDLIB_USED;
 }
 
+#ifdef CIAA_CFG_MEMSTATS_CALLSITES
+/** \brief count an allocation of a call site
+ **
+ ** \param[in] pc return address of the call to ciaaPOSIX_malloc
+ ** \param[in] size count of allocated bytes
+ **
+ ** \remarks shall be called with the heap semaphore taken
+ **/
+static void ciaaPOSIX_heapSite(uintptr_t pc, size_t size)
+{
+   uint32_t i;
+
+   for(i = 0; i < CIAAPOSIX_HEAP_SITES; i++)
+   {
+      if ( (ciaaPOSIX_heapSitesTable[i].pc == pc) ||
+           (0 == ciaaPOSIX_heapSitesTable[i].allocs) )
+      {
+         ciaaPOSIX_heapSitesTable[i].pc = pc;
+         ciaaPOSIX_heapSitesTable[i].allocs++;
+         ciaaPOSIX_heapSitesTable[i].bytes += size;
+         break;
+      }
+   }
+}
+#endif
+
 /*==================[external functions definition]==========================*/
 
 void ciaaPOSIX_stdlib_init(void)
 {
+#ifdef CIAA_CFG_MEMSTATS_CALLSITES
+   uint32_t i;
+#endif
    int ciaaPOSIX_heap_available_size = CIAA_HEAP_MEM_SIZE - sizeof(ciaaPOSIX_chunk_header);
    first_chunk_header = (ciaaPOSIX_chunk_header*)&ciaaPOSIX_buffer;
    first_chunk_header->next = NULL;
    first_chunk_header->size = ciaaPOSIX_heap_available_size;
    first_chunk_header->is_available = CIAA_POSIX_STDLIB_AVAILABLE;
+#ifdef CIAA_CFG_MEMSTATS
+   ciaaPOSIX_heapCounters = ciaaPOSIX_heapEmpty;
+   ciaaPOSIX_heapUsed = 0;
+#endif
+#ifdef CIAA_CFG_MEMSTATS_CALLSITES
+   for(i = 0; i < CIAAPOSIX_HEAP_SITES; i++)
+   {
+      ciaaPOSIX_heapSitesTable[i].pc = 0;
+      ciaaPOSIX_heapSitesTable[i].allocs = 0;
+      ciaaPOSIX_heapSitesTable[i].bytes = 0;
+   }
+#endif
    /* init sempahore */
    ciaaPOSIX_sem_init(&ciaaPOSIX_stdlib_sem);
 }
@@ -138,10 +199,30 @@ void *ciaaPOSIX_malloc(size_t size)
       {
          ciaaPOSIX_chunk_partition(chunk_header, size);
          result  = ((char *)chunk_header)+sizeof(ciaaPOSIX_chunk_header);
+#ifdef CIAA_CFG_MEMSTATS
+         ciaaPOSIX_heapUsed += chunk_header->size + sizeof(ciaaPOSIX_chunk_header);
+         if (ciaaPOSIX_heapUsed > ciaaPOSIX_heapCounters.peak)
+         {
+            ciaaPOSIX_heapCounters.peak = ciaaPOSIX_heapUsed;
+         }
+#endif
+#ifdef CIAA_CFG_MEMSTATS_CALLSITES
+         ciaaPOSIX_heapSite((uintptr_t)__builtin_return_address(0), size);
+#endif
          break;
       }
       chunk_header = chunk_header->next;
    }
+#ifdef CIAA_CFG_MEMSTATS
+   if (NULL == result)
+   {
+      ciaaPOSIX_heapCounters.failed++;
+   }
+   else
+   {
+      ciaaPOSIX_heapCounters.allocs++;
+   }
+#endif
    /* exit critical section */
    ciaaPOSIX_sem_post(&ciaaPOSIX_stdlib_sem);
    return result;
@@ -160,6 +241,10 @@ void ciaaPOSIX_free(void *ptr)
       if (chunk_header == chunk_to_free)
       {
          chunk_header->is_available = CIAA_POSIX_STDLIB_AVAILABLE;
+#ifdef CIAA_CFG_MEMSTATS
+         ciaaPOSIX_heapUsed -= chunk_header->size + sizeof(ciaaPOSIX_chunk_header);
+         ciaaPOSIX_heapCounters.frees++;
+#endif
          break;
       }
       chunk_header = chunk_header->next;
@@ -181,6 +266,73 @@ void ciaaPOSIX_free(void *ptr)
    ciaaPOSIX_sem_post(&ciaaPOSIX_stdlib_sem);
 }
 
+void ciaaPOSIX_heapStats(ciaaPOSIX_heapStatsType * stats)
+{
+   ciaaPOSIX_chunk_header *chunk_header = first_chunk_header;
+   uint32_t freeBytes = 0;
+
+   /* enter critical section */
+   ciaaPOSIX_sem_wait(&ciaaPOSIX_stdlib_sem);
+
+#ifdef CIAA_CFG_MEMSTATS
+   *stats = ciaaPOSIX_heapCounters;
+#else
+   *stats = ciaaPOSIX_heapEmpty;
+#endif
+   stats->size = CIAA_HEAP_MEM_SIZE;
+
+   while (chunk_header)
+   {
+      if (chunk_header->is_available)
+      {
+         freeBytes += chunk_header->size;
+         stats->freeBlocks++;
+         if (chunk_header->size > stats->largestFree)
+         {
+            stats->largestFree = chunk_header->size;
+         }
+      }
+      else
+      {
+         stats->used += chunk_header->size + sizeof(ciaaPOSIX_chunk_header);
+      }
+      chunk_header = chunk_header->next;
+   }
+
+   /* exit critical section */
+   ciaaPOSIX_sem_post(&ciaaPOSIX_stdlib_sem);
+
+   if (0 != freeBytes)
+   {
+      stats->fragmentation = 1000 - ((stats->largestFree * 1000) / freeBytes);
+   }
+}
+
+uint32_t ciaaPOSIX_heapSites(ciaaPOSIX_heapSiteType * sites, uint32_t count)
+{
+   uint32_t ret = 0;
+
+#ifdef CIAA_CFG_MEMSTATS_CALLSITES
+   /* enter critical section */
+   ciaaPOSIX_sem_wait(&ciaaPOSIX_stdlib_sem);
+
+   while ( (ret < count) && (ret < CIAAPOSIX_HEAP_SITES) &&
+           (0 != ciaaPOSIX_heapSitesTable[ret].allocs) )
+   {
+      sites[ret] = ciaaPOSIX_heapSitesTable[ret];
+      ret++;
+   }
+
+   /* exit critical section */
+   ciaaPOSIX_sem_post(&ciaaPOSIX_stdlib_sem);
+#else
+   (void)sites;
+   (void)count;
+#endif
+
+   return ret;
+}
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /*==================[end of file]============================================*/
@@ -52,10 +52,16 @@
 #include "ciaaPOSIX_errno.h"
 #include "ciaaLibs_CircBuf.h"
 #include "ciaak.h"       /* <= ciaa kernel header */
+#include "ciaak_Cfg.h"
 #include "os.h"
 
 /*==================[macros and definitions]=================================*/
-#define ciaaSerialDevices_MAXDEVICES          20
+#if (0 < CIAAK_SERIAL_DEVICES)
+#define ciaaSerialDevices_MAXDEVICES          CIAAK_SERIAL_DEVICES
+#else
+/* at least one entry, arrays of size 0 are not allowed */
+#define ciaaSerialDevices_MAXDEVICES          1
+#endif
 #define ciaaSerialDevices_NONBLOCK_MODE       0x01
 
 /*==================[typedef]================================================*/
@@ -66,6 +72,8 @@ typedef struct {
 
 typedef struct {
    ciaaDevices_deviceType const * device;
+   ciaaDevices_deviceType upDevice;
+   char path[CIAAK_PATH_SIZE];
    ciaaSerialDevices_blockerType blocked;
    ciaaLibs_CircBufType rxBuf;
    ciaaLibs_CircBufType txBuf;
@@ -95,6 +103,11 @@ char const * const ciaaSerialDevices_prefix = "/dev/serial";
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
+/** \brief rx buffers of the serial devices */
+static uint8_t ciaaSerialDevices_rxBuffers[ciaaSerialDevices_MAXDEVICES][CIAAK_SERIAL_RX_SIZE];
+
+/** \brief tx buffers of the serial devices */
+static uint8_t ciaaSerialDevices_txBuffers[ciaaSerialDevices_MAXDEVICES][CIAAK_SERIAL_TX_SIZE];
 
 /*==================[external data definition]===============================*/
 
@@ -127,8 +140,17 @@ extern void ciaaSerialDevices_addDriver(ciaaDevices_deviceType * driver)
    /* enter critical section */
    /* not needed, only 1 task running */
 
+   /* length of the path string of this device */
+   length = ciaaPOSIX_strlen(driver->path);
+   length += ciaaPOSIX_strlen(ciaaSerialDevices_prefix);
+   length += 2; /* for the / and the termination null */
+
+   /* the path has to fit in the planned path size */
+   ciaaPOSIX_assert(CIAAK_PATH_SIZE >= length);
+
    /* check if more drivers can be added */
-   if (ciaaSerialDevices_MAXDEVICES > ciaaSerialDevices.position) {
+   if ( (ciaaSerialDevices_MAXDEVICES > ciaaSerialDevices.position) &&
+        (CIAAK_PATH_SIZE >= length) ) {
 
       /* get position for next device */
       position = ciaaSerialDevices.position;
@@ -144,14 +166,16 @@ extern void ciaaSerialDevices_addDriver(ciaaDevices_deviceType * driver)
 
       /* configure rx and tx buffers */
       /* TODO buffer size shall be created depending on the device type (eth != uart) */
-      ciaaLibs_circBufInit(&ciaaSerialDevices.devstr[position].rxBuf, ciaak_malloc(256), 256);
-      ciaaLibs_circBufInit(&ciaaSerialDevices.devstr[position].txBuf, ciaak_malloc(256), 256);
+      ciaaLibs_circBufInit(&ciaaSerialDevices.devstr[position].rxBuf,
+            ciaaSerialDevices_rxBuffers[position], CIAAK_SERIAL_RX_SIZE);
+      ciaaLibs_circBufInit(&ciaaSerialDevices.devstr[position].txBuf,
+            ciaaSerialDevices_txBuffers[position], CIAAK_SERIAL_TX_SIZE);
 
       /* initial flags */
       ciaaSerialDevices.devstr[position].flags = 0;
 
-      /* allocate memory for new device */
-      newDevice = (ciaaDevices_deviceType*) ciaak_malloc(sizeof(ciaaDevices_deviceType));
+      /* the new device is statically allocated with the device type */
+      newDevice = &ciaaSerialDevices.devstr[position].upDevice;
 
       /* set functions for this device */
       newDevice->open = ciaaSerialDevices_open;
@@ -167,13 +191,8 @@ extern void ciaaSerialDevices_addDriver(ciaaDevices_deviceType * driver)
       /* store newDevice layer information in the lower layer */
       driver->upLayer = newDevice;
 
-      /* create path string for this device */
-      length = ciaaPOSIX_strlen(driver->path);
-      length += ciaaPOSIX_strlen(ciaaSerialDevices_prefix);
-      length += 2; /* for the / and the termination null */
-
-      /* create path for the new device */
-      newDeviceName = (char *) ciaak_malloc(length);
+      /* path for the new device */
+      newDeviceName = ciaaSerialDevices.devstr[position].path;
 
       /* start a new string */
       *newDeviceName = 0;
@@ -318,6 +337,9 @@ extern ssize_t ciaaSerialDevices_read(ciaaDevices_deviceType const * const devic
                nbyte);
       }
    }
+
+   ciaak_traceDeviceRead(device->path, ret);
+
    return ret;
 }
 
@@ -374,6 +396,8 @@ extern ssize_t ciaaSerialDevices_write(ciaaDevices_deviceType const * const devi
    }
    while (total < nbyte);
 
+   ciaak_traceDeviceWrite(device->path, total);
+
    return total;
 }
 
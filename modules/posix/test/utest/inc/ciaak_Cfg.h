@@ -0,0 +1,95 @@
+/********************************************************
+ * DO NOT CHANGE THIS FILE, IT IS GENERATED AUTOMATICALY*
+ ********************************************************/
+
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _CIAAK_CFG_H_
+#define _CIAAK_CFG_H_
+/** \brief CIAA Kernel Generated Configuration Header File
+ **
+ ** Static memory plan used by the unit tests of the posix module.
+ **
+ ** \file ciaak_Cfg.h
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Kernel CIAA Kernel
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+
+/*==================[macros]=================================================*/
+/** \brief count of serial devices which can be registered */
+#define CIAAK_SERIAL_DEVICES        20
+
+/** \brief size of the rx buffer of each serial device, power of 2 */
+#define CIAAK_SERIAL_RX_SIZE        256
+
+/** \brief size of the tx buffer of each serial device, power of 2 */
+#define CIAAK_SERIAL_TX_SIZE        256
+
+/** \brief count of block devices which can be registered */
+#define CIAAK_BLOCK_DEVICES         20
+
+/** \brief count of dio devices which can be registered */
+#define CIAAK_DIO_DEVICES           20
+
+/** \brief size of the path of each device including the termination null */
+#define CIAAK_PATH_SIZE             32
+
+/** \brief size of the heap of ciaaPOSIX_malloc */
+#define CIAA_HEAP_MEM_SIZE          20000
+
+/** \brief total of the task stacks */
+#define CIAAK_STACKS_SIZE           1536
+
+/** \brief count of tasks, the task ids go from 0 to CIAAK_TASKS_COUNT - 1 */
+#define CIAAK_TASKS_COUNT           3
+
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAAK_CFG_H_ */
+
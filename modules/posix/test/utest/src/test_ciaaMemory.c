@@ -0,0 +1,246 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the test of the memory instrumentation
+ **
+ ** \file test_ciaaMemory.c
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup POSIX POSIX Implementation
+ ** @{ */
+/** \addtogroup ModuleTests Module Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaMemory.h"
+#include "ciaaPOSIX_stdio.h"
+#include "mock_ciaaDevices.h"
+#include "mock_ciaaPOSIX_stdlib.h"
+#include "mock_ciaaPOSIX_string.h"
+#include "mock_os.h"
+#include "Os_Internal.h"
+#include <string.h>
+
+/*==================[macros and definitions]=================================*/
+#define STACK_SIZE      256
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief stacks of the tasks */
+static uint8_t stacks[TASKS_COUNT][STACK_SIZE];
+
+/** \brief task id returned by GetTaskID */
+static TaskType runningTask;
+
+/** \brief device added by ciaaMemory_init */
+static ciaaDevices_deviceType * device;
+
+/*==================[external data definition]===============================*/
+const TaskConstType TasksConst[TASKS_COUNT] = {
+   { NULL, NULL, stacks[0], STACK_SIZE, 0, 1, { 0, 0, 0 }, 0, 0, 0 },
+   { NULL, NULL, stacks[1], STACK_SIZE, 0, 1, { 0, 0, 0 }, 0, 0, 0 },
+   { NULL, NULL, stacks[2], STACK_SIZE, 0, 1, { 0, 0, 0 }, 0, 0, 0 }
+};
+
+TaskVariableType TasksVar[TASKS_COUNT];
+
+/*==================[internal functions definition]==========================*/
+/** \brief returns the running task */
+static StatusType getTaskID(TaskType * taskID, int cmock_num_calls)
+{
+   *taskID = runningTask;
+
+   return 0;
+}
+
+static void * stubMemset(void * s, int c, size_t n, int cmock_num_calls)
+{
+   return memset(s, c, n);
+}
+
+static void * stubMemcpy(void * s1, void const * s2, size_t n, int cmock_num_calls)
+{
+   return memcpy(s1, s2, n);
+}
+
+static void heapStats(ciaaPOSIX_heapStatsType * stats, int cmock_num_calls)
+{
+   memset(stats, 0, sizeof(ciaaPOSIX_heapStatsType));
+   stats->size = 1000;
+   stats->used = 100;
+   stats->peak = 300;
+}
+
+static void addDevice(ciaaDevices_deviceType * dev, int cmock_num_calls)
+{
+   device = dev;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   uint32_t task;
+
+   GetTaskID_StubWithCallback(getTaskID);
+   ciaaPOSIX_memset_StubWithCallback(stubMemset);
+   ciaaPOSIX_memcpy_StubWithCallback(stubMemcpy);
+   ciaaPOSIX_heapStats_StubWithCallback(heapStats);
+   ciaaDevices_addDevice_StubWithCallback(addDevice);
+
+   memset(stacks, 0, sizeof(stacks));
+   for(task = 0; task < TASKS_COUNT; task++)
+   {
+      TasksVar[task].Flags.State = TASK_ST_SUSPENDED;
+   }
+   runningTask = INVALID_TASK;
+   device = NULL;
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test the painting and the high water mark of the stacks */
+void test_ciaaMemory_stackHighWater(void) {
+   ciaaMemory_stackStatsType stats;
+
+   /* the stack of an active task which is not running is unknown */
+   TasksVar[1].Flags.State = TASK_ST_READY;
+   ciaaMemory_stackPaint();
+
+   TEST_ASSERT_EQUAL_INT32(1, ciaaMemory_getStackStats(0, &stats));
+   TEST_ASSERT_EQUAL_UINT32(STACK_SIZE, stats.size);
+   TEST_ASSERT_EQUAL_UINT32(STACK_SIZE, stats.painted);
+   TEST_ASSERT_EQUAL_UINT32(0, stats.highWater);
+   TEST_ASSERT_EQUAL_UINT8(CIAAMEMORY_STACK_PATTERN, stacks[0][0]);
+   TEST_ASSERT_EQUAL_UINT8(CIAAMEMORY_STACK_PATTERN, stacks[0][STACK_SIZE - 1]);
+
+   TEST_ASSERT_EQUAL_INT32(1, ciaaMemory_getStackStats(1, &stats));
+   TEST_ASSERT_EQUAL_UINT32(0, stats.painted);
+   TEST_ASSERT_EQUAL_UINT8(0, stacks[1][STACK_SIZE - 1]);
+
+   /* the stacks grow to the lower addresses */
+   memset(&stacks[0][STACK_SIZE - 40], 0x11, 40);
+   TEST_ASSERT_EQUAL_INT32(1, ciaaMemory_getStackStats(0, &stats));
+   TEST_ASSERT_EQUAL_UINT32(40, stats.highWater);
+
+   /* a value equal to the pattern does not lower the high water mark */
+   stacks[0][STACK_SIZE - 100] = 0x22;
+   stacks[0][STACK_SIZE - 30] = CIAAMEMORY_STACK_PATTERN;
+   TEST_ASSERT_EQUAL_INT32(1, ciaaMemory_getStackStats(0, &stats));
+   TEST_ASSERT_EQUAL_UINT32(100, stats.highWater);
+
+   TEST_ASSERT_EQUAL_INT32(-1, ciaaMemory_getStackStats(TASKS_COUNT, &stats));
+}
+
+/** \brief test that the running task is not painted out of its stack */
+void test_ciaaMemory_stackPaintRunning(void) {
+   ciaaMemory_stackStatsType stats;
+
+   /* the stack of the test is not the one of the task */
+   runningTask = 2;
+   TasksVar[2].Flags.State = TASK_ST_RUNNING;
+   ciaaMemory_stackPaint();
+
+   TEST_ASSERT_EQUAL_INT32(1, ciaaMemory_getStackStats(2, &stats));
+   TEST_ASSERT_EQUAL_UINT32(0, stats.painted);
+   TEST_ASSERT_EQUAL_UINT8(0, stacks[2][0]);
+}
+
+/** \brief test the statistics read from the device */
+void test_ciaaMemory_device(void) {
+   ciaaMemory_statsType stats;
+   uint8_t buf[sizeof(ciaaMemory_statsType) + 8];
+
+   ciaaMemory_init();
+   TEST_ASSERT_NOT_NULL(device);
+   TEST_ASSERT_EQUAL_STRING(CIAAMEMORY_DEVICE_PATH, device->path);
+
+   /* task 1 used 64 bytes of its stack */
+   stacks[1][STACK_SIZE - 64] = 0;
+
+   /* only read only */
+   TEST_ASSERT_NULL(device->open(device->path, device, ciaaPOSIX_O_RDWR));
+   TEST_ASSERT_NULL(device->open(device->path, device, ciaaPOSIX_O_WRONLY));
+   TEST_ASSERT_EQUAL_PTR(device, device->open(device->path, device, ciaaPOSIX_O_RDONLY));
+
+   /* read in two parts */
+   TEST_ASSERT_EQUAL_INT(8, device->read(device, buf, 8));
+   TEST_ASSERT_EQUAL_INT(sizeof(ciaaMemory_statsType) - 8,
+         device->read(device, &buf[8], sizeof(buf) - 8));
+   TEST_ASSERT_EQUAL_INT(0, device->read(device, buf, sizeof(buf)));
+   memcpy(&stats, buf, sizeof(stats));
+   TEST_ASSERT_EQUAL_UINT32(1000, stats.heap.size);
+   TEST_ASSERT_EQUAL_UINT32(300, stats.heap.peak);
+   TEST_ASSERT_EQUAL_UINT32(TASKS_COUNT, stats.tasks);
+   TEST_ASSERT_EQUAL_UINT32(STACK_SIZE, stats.stack[1].painted);
+   TEST_ASSERT_EQUAL_UINT32(64, stats.stack[1].highWater);
+   TEST_ASSERT_EQUAL_UINT32(0, stats.stack[0].highWater);
+
+   /* the snapshot does not change while the device is open */
+   stacks[0][0] = 0;
+   TEST_ASSERT_EQUAL_INT(0, device->lseek(device, 0, SEEK_SET));
+   TEST_ASSERT_EQUAL_INT(sizeof(stats), device->read(device, buf, sizeof(buf)));
+   TEST_ASSERT_EQUAL_MEMORY(&stats, buf, sizeof(stats));
+
+   TEST_ASSERT_EQUAL_INT(sizeof(stats) - 4, device->lseek(device, -4, SEEK_END));
+   TEST_ASSERT_EQUAL_INT(sizeof(stats) - 8, device->lseek(device, -4, SEEK_CUR));
+   TEST_ASSERT_EQUAL_INT(-1, device->lseek(device, 1, SEEK_END));
+   TEST_ASSERT_EQUAL_INT(-1, device->lseek(device, -1, SEEK_SET));
+   TEST_ASSERT_EQUAL_INT(8, device->read(device, buf, sizeof(buf)));
+
+   TEST_ASSERT_EQUAL_INT(-1, device->write(device, buf, 1));
+   TEST_ASSERT_EQUAL_INT(-1, device->ioctl(device, 0, NULL));
+   TEST_ASSERT_EQUAL_INT(0, device->close(device));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
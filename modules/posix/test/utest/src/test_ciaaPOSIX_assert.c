@@ -0,0 +1,145 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the test of the assert ring
+ **
+ ** \file test_ciaaPOSIX_assert.c
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup POSIX POSIX Implementation
+ ** @{ */
+/** \addtogroup ModuleTests Module Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaPOSIX_assert.h"
+#include "mock_os.h"
+#include "mock_ciaaPOSIX_stdio.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief task id returned by GetTaskID */
+static TaskType runningTask;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief returns the running task */
+static StatusType getTaskID(TaskType * taskID, int cmock_num_calls)
+{
+   *taskID = runningTask;
+
+   return 0;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   GetTaskID_StubWithCallback(getTaskID);
+   runningTask = 2;
+   ciaaPOSIX_assertClear();
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test the records of the failures */
+void test_ciaaPOSIX_assert_record(void) {
+   ciaaPOSIX_assertRecordType records[4];
+   char const * const file = "ciaaDevices.c";
+
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaPOSIX_assertGetRecords(records, 4));
+
+   ciaaPOSIX_assertRecord(file, 120, 0x1A001234);
+   runningTask = CIAAPOSIX_ASSERT_NO_TASK;
+   ciaaPOSIX_assertRecord(NULL, 0, 0x1A005678);
+
+   TEST_ASSERT_EQUAL_UINT32(2, ciaaPOSIX_assertGetRecords(records, 4));
+   TEST_ASSERT_EQUAL_PTR(file, records[0].file);
+   TEST_ASSERT_EQUAL_UINT16(120, records[0].line);
+   TEST_ASSERT_EQUAL_UINT8(2, records[0].task);
+   TEST_ASSERT_EQUAL_HEX32(0x1A001234, records[0].pc);
+   TEST_ASSERT_NULL(records[1].file);
+   TEST_ASSERT_EQUAL_UINT8(CIAAPOSIX_ASSERT_NO_TASK, records[1].task);
+   TEST_ASSERT_EQUAL_HEX32(0x1A005678, records[1].pc);
+
+   /* the newest records are got */
+   TEST_ASSERT_EQUAL_UINT32(1, ciaaPOSIX_assertGetRecords(records, 1));
+   TEST_ASSERT_EQUAL_HEX32(0x1A005678, records[0].pc);
+
+   ciaaPOSIX_assertClear();
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaPOSIX_assertGetRecords(records, 4));
+}
+
+/** \brief test that the ring keeps the newest records */
+void test_ciaaPOSIX_assert_ring(void) {
+   ciaaPOSIX_assertRecordType records[CIAAPOSIX_ASSERT_RECORDS];
+   uint32_t loopi;
+
+   for(loopi = 0; loopi < CIAAPOSIX_ASSERT_RECORDS + 3; loopi++)
+   {
+      ciaaPOSIX_assertRecord("ciaaPOSIX_stdio.c", loopi, loopi);
+   }
+
+   TEST_ASSERT_EQUAL_UINT32(CIAAPOSIX_ASSERT_RECORDS,
+         ciaaPOSIX_assertGetRecords(records, CIAAPOSIX_ASSERT_RECORDS));
+   for(loopi = 0; loopi < CIAAPOSIX_ASSERT_RECORDS; loopi++)
+   {
+      TEST_ASSERT_EQUAL_UINT16(loopi + 3, records[loopi].line);
+   }
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
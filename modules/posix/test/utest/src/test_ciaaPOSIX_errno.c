@@ -0,0 +1,131 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the test of the errno
+ **
+ ** \file test_ciaaPOSIX_errno.c
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup POSIX POSIX Implementation
+ ** @{ */
+/** \addtogroup ModuleTests Module Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaPOSIX_errno.h"
+#include "ciaak_Cfg.h"
+#include "mock_os.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief task id returned by GetTaskID */
+static TaskType runningTask;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief returns the running task */
+static StatusType getTaskID(TaskType * taskID, int cmock_num_calls)
+{
+   *taskID = runningTask;
+
+   return 0;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   GetTaskID_StubWithCallback(getTaskID);
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test that each task has its own errno */
+void test_ciaaPOSIX_errno_perTask(void) {
+   runningTask = 0;
+   ciaaPOSIX_errno = EAGAIN;
+   runningTask = 1;
+   ciaaPOSIX_errno = 0;
+   runningTask = CIAAK_TASKS_COUNT - 1;
+   ciaaPOSIX_errno = 7;
+
+   runningTask = 0;
+   TEST_ASSERT_EQUAL_INT(EAGAIN, ciaaPOSIX_errno);
+   runningTask = 1;
+   TEST_ASSERT_EQUAL_INT(0, ciaaPOSIX_errno);
+   runningTask = CIAAK_TASKS_COUNT - 1;
+   TEST_ASSERT_EQUAL_INT(7, ciaaPOSIX_errno);
+
+   /* same location while the task does not change */
+   TEST_ASSERT_EQUAL_PTR(ciaaPOSIX_errnoLocation(), ciaaPOSIX_errnoLocation());
+}
+
+/** \brief test that the interrupts share an errno apart from the tasks */
+void test_ciaaPOSIX_errno_noTask(void) {
+   runningTask = 0;
+   ciaaPOSIX_errno = 0;
+
+   runningTask = 0xFF;
+   ciaaPOSIX_errno = EAGAIN;
+   runningTask = CIAAK_TASKS_COUNT;
+   TEST_ASSERT_EQUAL_INT(EAGAIN, ciaaPOSIX_errno);
+
+   runningTask = 0;
+   TEST_ASSERT_EQUAL_INT(0, ciaaPOSIX_errno);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
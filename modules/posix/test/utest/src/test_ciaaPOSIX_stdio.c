@@ -0,0 +1,360 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/** \brief This file implements the test of the stdio formatter
+ **
+ ** The output of ciaaPOSIX_snprintf is compared with the snprintf of the
+ ** host, the last test compares the time of both.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup POSIX POSIX Implementation
+ ** @{ */
+/** \addtogroup ModuleTests Module Tests
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "ciaaPOSIX_stdio.h"
+#include "ciaaPOSIX_stdbool.h"
+#include "mock_ciaaDevices.h"
+#include "mock_ciaaPOSIX_string.h"
+#include "mock_os.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+
+/*==================[macros and definitions]=================================*/
+/** \brief count of calls of the benchmark */
+#define BENCH_CALLS           200000
+
+/** \brief compare the output of the formatter with the one of the host */
+#define TEST_FORMAT(...)                                                   \
+   do {                                                                    \
+      char expected[128];                                                  \
+      char result[128];                                                    \
+      int32_t length = snprintf(expected, sizeof(expected), __VA_ARGS__);  \
+      TEST_ASSERT_EQUAL_INT(length,                                        \
+            ciaaPOSIX_snprintf(result, sizeof(result), __VA_ARGS__));      \
+      TEST_ASSERT_EQUAL_STRING(expected, result);                          \
+   } while (0)
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief data written to the device */
+static char written[1024];
+
+/** \brief count of bytes written to the device */
+static size_t writtenCount;
+
+/** \brief count of calls to the write of the device */
+static uint32_t writes;
+
+/** \brief the device fails to write */
+static bool writeFails;
+
+/*==================[external data definition]===============================*/
+char const * const ciaaPOSIX_assert_msg = \
+      "ASSERT Failed in %s:%d in expression %s\n";
+
+/*==================[internal functions definition]==========================*/
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int8_t stringStrncmp(char const * s1, char const * s2, size_t n, int calls)
+{
+   (void)calls;
+
+   return strncmp(s1, s2, n);
+}
+
+static size_t stringStrlen(char const * s, int calls)
+{
+   (void)calls;
+
+   return strlen(s);
+}
+
+static ciaaDevices_deviceType * deviceOpen(char const * path,
+      ciaaDevices_deviceType * device, uint8_t const oflag)
+{
+   return device;
+}
+
+static int32_t deviceClose(ciaaDevices_deviceType const * const device)
+{
+   return 0;
+}
+
+static ssize_t deviceWrite(ciaaDevices_deviceType const * const device,
+      uint8_t const * const buf, size_t const nbyte)
+{
+   ssize_t ret = -1;
+
+   writes++;
+   if (!writeFails)
+   {
+      memcpy(&written[writtenCount], buf, nbyte);
+      writtenCount += nbyte;
+      ret = nbyte;
+   }
+
+   return ret;
+}
+
+/** \brief device the output of ciaaPOSIX_dprintf is written to */
+static ciaaDevices_deviceType device = {
+   "/dev/serial/uart/0",
+   deviceOpen,
+   deviceClose,
+   NULL,
+   deviceWrite,
+   NULL,
+   NULL,
+   NULL,
+   NULL,
+   NULL
+};
+
+/** \brief open the test device */
+static int32_t openDevice(void)
+{
+   ciaaDevices_getDevice_ExpectAndReturn(device.path, &device);
+
+   return ciaaPOSIX_open(device.path, ciaaPOSIX_O_WRONLY);
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief set Up function
+ **
+ ** This function is called before each test case is executed
+ **
+ **/
+void setUp(void) {
+   writtenCount = 0;
+   writes = 0;
+   writeFails = false;
+
+   ciaaPOSIX_strncmp_StubWithCallback(stringStrncmp);
+   ciaaPOSIX_strlen_StubWithCallback(stringStrlen);
+   SuspendOSInterrupts_Ignore();
+   ResumeOSInterrupts_Ignore();
+   GetResource_IgnoreAndReturn(E_OK);
+   ReleaseResource_IgnoreAndReturn(E_OK);
+
+   ciaaPOSIX_init();
+}
+
+/** \brief tear Down function
+ **
+ ** This function is called after each test case is executed
+ **
+ **/
+void tearDown(void) {
+}
+
+/** \brief test the integer conversions */
+void test_ciaaPOSIX_snprintf_integers(void) {
+   TEST_FORMAT("plain text");
+   TEST_FORMAT("%d %i %d %d", 0, 42, -42, -2147483647 - 1);
+   TEST_FORMAT("%u %u", 0u, 4294967295u);
+   TEST_FORMAT("%x %X %o %#x %#X %#o %#x %#o", 0xbeefu, 0xbeefu, 0777u, 0xbeefu, 0xbeefu, 0777u, 0u, 0u);
+   TEST_FORMAT("%lld %llu %llx", -9223372036854775807LL - 1, 18446744073709551615ULL, 0x123456789abcdefULL);
+   TEST_FORMAT("%ld %lu %hd %hu %hhd %hhu", -123456L, 123456UL, -1234, 65535, -12, 255);
+   TEST_FORMAT("%hd %hhu", 70000, 300);
+   TEST_FORMAT("%zu %jd %td", (size_t)12345, (intmax_t)-5, (ptrdiff_t)-7);
+   TEST_FORMAT("[%5d] [%-5d] [%05d] [%+d] [% d] [%+05d] [%-+5d]", 42, 42, 42, 42, 42, -42, 42);
+   TEST_FORMAT("[%.3d] [%8.3d] [%.0d] [%5.0d] [%#.0o]", 7, -7, 0, 0, 0u);
+   TEST_FORMAT("[%*d] [%-*d] [%*d] [%.*d]", 6, 1, 6, 2, -6, 3, 4, 5);
+   TEST_FORMAT("[%#10x] [%#-10x] [%#010x] [%10.4x]", 0xabu, 0xabu, 0xabu, 0xabu);
+   TEST_FORMAT("%p", (void *)&device);
+   TEST_FORMAT("%d%%%d", 1, 2);
+}
+
+/** \brief test the flags ignored and the unknown conversions */
+void test_ciaaPOSIX_snprintf_special(void) {
+   char const * format = "[%08.3d] [%-05d] %y %";
+   char result[32];
+
+   /* the flag 0 is ignored with a precision or the flag - */
+   TEST_ASSERT_EQUAL_INT(23, ciaaPOSIX_snprintf(result, sizeof(result), format, 7, 7));
+   TEST_ASSERT_EQUAL_STRING("[     007] [7    ] %y %", result);
+}
+
+/** \brief test the character and string conversions */
+void test_ciaaPOSIX_snprintf_strings(void) {
+   char unterminated[3] = { 'a', 'b', 'c' };
+   char result[16];
+
+   TEST_FORMAT("%c%c%c", 'a', 'b', 'c');
+   TEST_FORMAT("[%3c] [%-3c]", 'x', 'y');
+   TEST_FORMAT("[%s] [%10s] [%-10s] [%.3s] [%10.2s]", "text", "text", "text", "text", "text");
+   TEST_ASSERT_EQUAL_INT(6, ciaaPOSIX_snprintf(result, sizeof(result), "%s", (char *)NULL));
+   TEST_ASSERT_EQUAL_STRING("(null)", result);
+   TEST_FORMAT("%.3s", unterminated);
+   TEST_FORMAT("%s and %s", "a string longer than the sixteen spaces of the padding", "another");
+   TEST_FORMAT("[%40s]", "padded to forty");
+}
+
+/** \brief test the double conversions */
+void test_ciaaPOSIX_snprintf_doubles(void) {
+   TEST_FORMAT("%f %f %f", 0.0, 1.0, -1.0);
+   TEST_FORMAT("%f %.2f %.0f %.1f", 3.14159265, 1234.5678, 2.7, 0.05);
+   TEST_FORMAT("[%10.3f] [%-10.3f] [%010.3f] [%+.2f] [% .2f]", 3.14159, 3.14159, -3.14159, 2.5, 2.5);
+   TEST_FORMAT("%#.0f %.9f %.17f", 3.0, 0.123456789, 0.25);
+   TEST_FORMAT("%.20f", 0.5);
+   TEST_FORMAT("%f %F %f %F", 1.0 / 0.0, -1.0 / 0.0, 0.0 / 0.0, 0.0 / 0.0);
+   TEST_FORMAT("%.3f", 9.9996);
+   TEST_FORMAT("%f", -0.0);
+   TEST_FORMAT("%.1f", 1e18);
+   /* the ties are rounded to even and the digits are exact */
+   TEST_FORMAT("%.0f %.0f %.0f %.0f", 0.5, 1.5, 2.5, -2.5);
+   TEST_FORMAT("%.1f %.2f %.2f", 0.25, 0.125, 0.375);
+   TEST_FORMAT("%.17f %.17f", 1.0 / 7, 2.0 / 3);
+   TEST_FORMAT("%.1f %.5f", 0.05, 1e-300);
+}
+
+/** \brief test the exponential notation of large doubles */
+void test_ciaaPOSIX_snprintf_large(void) {
+   char result[32];
+
+   TEST_ASSERT_EQUAL_INT(9, ciaaPOSIX_snprintf(result, sizeof(result), "%.3f", 1.5e20));
+   TEST_ASSERT_EQUAL_STRING("1.500e+20", result);
+   TEST_ASSERT_EQUAL_INT(10, ciaaPOSIX_snprintf(result, sizeof(result), "%.2f", -9.999e200));
+   TEST_ASSERT_EQUAL_STRING("-1.00e+201", result);
+}
+
+/** \brief test the truncation of the output */
+void test_ciaaPOSIX_snprintf_truncation(void) {
+   char result[8];
+
+   memset(result, 'x', sizeof(result));
+   TEST_ASSERT_EQUAL_INT(11, ciaaPOSIX_snprintf(result, 5, "hello %s", "world"));
+   TEST_ASSERT_EQUAL_STRING("hell", result);
+   TEST_ASSERT_EQUAL_INT('x', result[5]);
+
+   TEST_ASSERT_EQUAL_INT(11, ciaaPOSIX_snprintf(NULL, 0, "hello %s", "world"));
+
+   TEST_ASSERT_EQUAL_INT(3, ciaaPOSIX_snprintf(result, 1, "%d", 123));
+   TEST_ASSERT_EQUAL_STRING("", result);
+}
+
+/** \brief test the output to a device */
+void test_ciaaPOSIX_dprintf(void) {
+   char expected[512];
+   int32_t fildes = openDevice();
+   int32_t length;
+
+   TEST_ASSERT_EQUAL_INT(0, fildes);
+
+   TEST_ASSERT_EQUAL_INT(12, ciaaPOSIX_dprintf(fildes, "value: %5d", 42));
+   TEST_ASSERT_EQUAL_INT(1, writes);
+   TEST_ASSERT_EQUAL_MEMORY("value:    42", written, 12);
+
+   /* the output is written in chunks */
+   writtenCount = 0;
+   writes = 0;
+   length = snprintf(expected, sizeof(expected), "%300s|%d", "right", -1);
+   TEST_ASSERT_EQUAL_INT(length, ciaaPOSIX_dprintf(fildes, "%300s|%d", "right", -1));
+   TEST_ASSERT_EQUAL_INT(length, writtenCount);
+   TEST_ASSERT_EQUAL_MEMORY(expected, written, length);
+   TEST_ASSERT_TRUE(1 < writes);
+
+   writeFails = true;
+   TEST_ASSERT_EQUAL_INT(-1, ciaaPOSIX_dprintf(fildes, "fails"));
+   TEST_ASSERT_EQUAL_INT(-1, ciaaPOSIX_dprintf(ciaaPOSIX_stdio_MAXFILDES, "fails"));
+
+   TEST_ASSERT_EQUAL_INT(0, ciaaPOSIX_close(fildes));
+}
+
+/** \brief benchmark against the snprintf of the host */
+void test_ciaaPOSIX_snprintf_benchmark(void) {
+   char buffer[128];
+   uint64_t start;
+   uint64_t own;
+   uint64_t host;
+   uint32_t loopi;
+
+   start = getNs();
+   for (loopi = 0; loopi < BENCH_CALLS; loopi++)
+   {
+      ciaaPOSIX_snprintf(buffer, sizeof(buffer), "%d %u %08x %s %lld",
+            (int)loopi, 4000000000u - loopi, loopi, "name", -1234567890123LL);
+   }
+   own = getNs() - start;
+
+   start = getNs();
+   for (loopi = 0; loopi < BENCH_CALLS; loopi++)
+   {
+      snprintf(buffer, sizeof(buffer), "%d %u %08x %s %lld",
+            (int)loopi, 4000000000u - loopi, loopi, "name", -1234567890123LL);
+   }
+   host = getNs() - start;
+
+   printf("snprintf integers: ciaaPOSIX %.0f ns, host %.0f ns per call\n",
+         (double)own / BENCH_CALLS, (double)host / BENCH_CALLS);
+
+   start = getNs();
+   for (loopi = 0; loopi < BENCH_CALLS; loopi++)
+   {
+      ciaaPOSIX_snprintf(buffer, sizeof(buffer), "%.3f", (double)loopi * 0.001);
+   }
+   own = getNs() - start;
+
+   start = getNs();
+   for (loopi = 0; loopi < BENCH_CALLS; loopi++)
+   {
+      snprintf(buffer, sizeof(buffer), "%.3f", (double)loopi * 0.001);
+   }
+   host = getNs() - start;
+
+   printf("snprintf doubles: ciaaPOSIX %.0f ns, host %.0f ns per call\n",
+         (double)own / BENCH_CALLS, (double)host / BENCH_CALLS);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -45,8 +45,23 @@
 
 /*==================[inclusions]=============================================*/
 #include "unity.h"
+#include "ciaaPOSIX_stdlib.h"
+#include "mock_ciaaPOSIX_semaphore.h"
+#include "ciaak_Cfg.h"
+#include "stdio.h"
+#include "time.h"
 
 /*==================[macros and definitions]=================================*/
+/** \brief count of free and malloc pairs of the benchmark */
+#define BENCH_CALLS           1000000
+
+/** \brief count of blocks allocated at the same time by the benchmark, the
+ **        same workload is used by the slab benchmark of
+ **        test_ciaaLibs_PoolBuf.c */
+#define BENCH_LIVE            16
+
+/** \brief sizes requested by the benchmark */
+#define BENCH_SIZES           { 12, 24, 40, 60, 100, 8, 30, 16 }
 
 /*==================[internal data declaration]==============================*/
 
@@ -57,6 +72,36 @@
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static uint64_t getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/** \brief size of the biggest block which can be allocated */
+static size_t getLargestBlock(void)
+{
+   size_t min = 0;
+   size_t max = CIAA_HEAP_MEM_SIZE;
+   size_t size;
+   void * ptr;
+
+   while (min < max) {
+      size = (min + max + 1) / 2;
+      ptr = ciaaPOSIX_malloc(size);
+      if (NULL != ptr) {
+         ciaaPOSIX_free(ptr);
+         min = size;
+      } else {
+         max = size - 1;
+      }
+   }
+
+   return min;
+}
 
 /*==================[external functions definition]==========================*/
 /** \brief set Up function
@@ -66,9 +111,9 @@
  **/
 void setUp(void) {
    /* ignore calles to sempahore */
-   ciaaPOSIX_sem_init_CMockIgnoreAndReturn(1);
-   ciaaPOSIX_sem_wait_CMockIgnoreAndReturn(1);
-   ciaaPOSIX_sem_post_CMockIgnoreAndReturn(1);
+   ciaaPOSIX_sem_init_IgnoreAndReturn(1);
+   ciaaPOSIX_sem_wait_IgnoreAndReturn(1);
+   ciaaPOSIX_sem_post_IgnoreAndReturn(1);
 
    /* perform the initialization of ciaa Devices */
    ciaaPOSIX_stdlib_init();
@@ -110,12 +155,115 @@ void testGetMoreThanAvailable(void) {
 
    /* get more bytes than available */
    ptr1 = ciaaPOSIX_malloc(20);
-   ptr2 = ciaaPOSIX_malloc(10000); /** TODO <- Replace with a macro */
+   ptr2 = ciaaPOSIX_malloc(CIAA_HEAP_MEM_SIZE);
 
    TEST_ASSERT_TRUE(NULL != ptr1);
    TEST_ASSERT_TRUE(NULL == ptr2);
 }
 
+/** \brief test the statistics of the heap */
+void test_ciaaPOSIX_heapStats(void) {
+   ciaaPOSIX_heapStatsType stats;
+   ciaaPOSIX_heapSiteType sites[4];
+   void * ptr[3];
+
+   ciaaPOSIX_heapStats(&stats);
+   TEST_ASSERT_EQUAL_UINT32(CIAA_HEAP_MEM_SIZE, stats.size);
+   TEST_ASSERT_EQUAL_UINT32(0, stats.used);
+   TEST_ASSERT_EQUAL_UINT32(1, stats.freeBlocks);
+   TEST_ASSERT_EQUAL_UINT32(0, stats.fragmentation);
+
+   ptr[0] = ciaaPOSIX_malloc(100);
+   ptr[1] = ciaaPOSIX_malloc(1000);
+   ptr[2] = ciaaPOSIX_malloc(100);
+   ciaaPOSIX_free(ptr[1]);
+
+   /* the hole of 1000 bytes is not the largest free block */
+   ciaaPOSIX_heapStats(&stats);
+   TEST_ASSERT_TRUE(stats.used > 200);
+   TEST_ASSERT_TRUE(stats.used < 300);
+   TEST_ASSERT_EQUAL_UINT32(2, stats.freeBlocks);
+   TEST_ASSERT_TRUE(stats.largestFree > CIAA_HEAP_MEM_SIZE - 1300);
+   TEST_ASSERT_EQUAL_UINT32(1000 - ((stats.largestFree * 1000) / (stats.largestFree + 1000)),
+         stats.fragmentation);
+
+   TEST_ASSERT_NULL(ciaaPOSIX_malloc(CIAA_HEAP_MEM_SIZE));
+   ciaaPOSIX_heapStats(&stats);
+#ifdef CIAA_CFG_MEMSTATS
+   TEST_ASSERT_EQUAL_UINT32(3, stats.allocs);
+   TEST_ASSERT_EQUAL_UINT32(1, stats.frees);
+   TEST_ASSERT_EQUAL_UINT32(1, stats.failed);
+   TEST_ASSERT_EQUAL_UINT32(stats.used + 1000 + 8 + sizeof(void *), stats.peak);
+#else
+   TEST_ASSERT_EQUAL_UINT32(0, stats.allocs);
+   TEST_ASSERT_EQUAL_UINT32(0, stats.peak);
+#endif
+
+#ifdef CIAA_CFG_MEMSTATS_CALLSITES
+   /* each call is a call site, the failed one is not recorded */
+   TEST_ASSERT_EQUAL_UINT32(2, ciaaPOSIX_heapSites(sites, 2));
+   TEST_ASSERT_EQUAL_UINT32(3, ciaaPOSIX_heapSites(sites, 4));
+   TEST_ASSERT_EQUAL_UINT32(1, sites[0].allocs);
+   TEST_ASSERT_EQUAL_UINT32(100, sites[0].bytes);
+   TEST_ASSERT_EQUAL_UINT32(1000, sites[1].bytes);
+#else
+   TEST_ASSERT_EQUAL_UINT32(0, ciaaPOSIX_heapSites(sites, 2));
+#endif
+
+   ciaaPOSIX_free(ptr[0]);
+   ciaaPOSIX_free(ptr[2]);
+   ciaaPOSIX_heapStats(&stats);
+   TEST_ASSERT_EQUAL_UINT32(0, stats.used);
+   TEST_ASSERT_EQUAL_UINT32(1, stats.freeBlocks);
+}
+
+/** \brief measure the latency and the fragmentation of the heap
+ **
+ ** A window of BENCH_LIVE blocks of different sizes is allocated, each step
+ ** frees a pseudo random block of the window and allocates a new one.
+ **/
+void test_ciaaPOSIX_stdlib_benchmark(void) {
+   static size_t const sizes[] = BENCH_SIZES;
+   void * live[BENCH_LIVE];
+   size_t liveSize[BENCH_LIVE];
+   uint64_t start;
+   uint64_t ns;
+   uint32_t requested = 0;
+   uint32_t seed = 1;
+   uint32_t failed = 0;
+   uint32_t i;
+   uint32_t j;
+   size_t largest;
+
+   largest = getLargestBlock();
+   for(i = 0; i < BENCH_LIVE; i++) {
+      liveSize[i] = sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+      live[i] = ciaaPOSIX_malloc(liveSize[i]);
+   }
+
+   start = getNs();
+   for(i = 0; i < BENCH_CALLS; i++) {
+      seed = seed * 1103515245u + 12345u;
+      j = (seed >> 16) % BENCH_LIVE;
+      ciaaPOSIX_free(live[j]);
+      liveSize[j] = sizes[(seed >> 8) % (sizeof(sizes) / sizeof(sizes[0]))];
+      live[j] = ciaaPOSIX_malloc(liveSize[j]);
+      if (NULL == live[j]) {
+         failed++;
+      }
+   }
+   ns = getNs() - start;
+
+   for(i = 0; i < BENCH_LIVE; i++) {
+      requested += liveSize[i];
+   }
+
+   TEST_ASSERT_EQUAL_UINT32(0, failed);
+   printf("ciaaPOSIX_malloc: %.1f ns per free and malloc, %u failed, "
+         "%u bytes requested, largest free block %u of %u bytes\n",
+         (double)ns / BENCH_CALLS, failed, requested,
+         (uint32_t)getLargestBlock(), (uint32_t)largest);
+}
 
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
@@ -0,0 +1,139 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _CIAABENCH_H_
+#define _CIAABENCH_H_
+/** \brief CIAA benchmark runner of the hot paths
+ **
+ ** Each case calls a hot path of the core libraries a fixed count of times
+ ** per sample. The runner executes some warm-up samples, then measures the
+ ** samples with the monotonic clock and the cycle counter of the cpu and
+ ** reports the median and the 99th percentile per call in ns and cycles.
+ ** The results are printed and written as JSON, which is compared against a
+ ** baseline by modules/tools/scripts/bench.pl.
+ **
+ ** The runner is built for the x86 ARCH by the bench rule of the root
+ ** makefile, see make help.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Tools CIAA Tools
+ ** @{ */
+/** \addtogroup Benchmarks Benchmarks
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** \brief default count of measured samples of each case */
+#ifndef CIAABENCH_SAMPLES
+#define CIAABENCH_SAMPLES        101
+#endif
+
+/** \brief default count of warm-up samples of each case */
+#ifndef CIAABENCH_WARMUP
+#define CIAABENCH_WARMUP         10
+#endif
+
+/** \brief maximal count of measured samples of each case */
+#define CIAABENCH_MAX_SAMPLES    10001
+
+/** \brief returns the cycle counter of the cpu */
+#if (ARCH == x86)
+#include <x86intrin.h>
+#define ciaaBench_cycles()       ((uint64_t)__rdtsc())
+#else
+#define ciaaBench_cycles()       (0)
+#endif
+
+/*==================[typedef]================================================*/
+/** \brief benchmark case type */
+typedef struct {
+   char const * name;            /** <- name of the case, key of the results */
+   void (*setup)(uint32_t calls);/** <- prepares a sample, not measured,
+                                        may be NULL */
+   void (*run)(uint32_t calls);  /** <- calls the hot path calls times */
+   uint32_t calls;               /** <- calls per sample */
+} ciaaBench_caseType;
+
+/** \brief results of a case, per call */
+typedef struct {
+   double nsMedian;              /** <- median of the ns */
+   double nsP99;                 /** <- 99th percentile of the ns */
+   double cyclesMedian;          /** <- median of the cycles */
+   double cyclesP99;             /** <- 99th percentile of the cycles */
+} ciaaBench_resultType;
+
+/*==================[external data declaration]==============================*/
+/** \brief cases of the benchmark */
+extern ciaaBench_caseType const ciaaBench_cases[];
+
+/** \brief count of cases of ciaaBench_cases */
+extern uint32_t const ciaaBench_casesCount;
+
+/*==================[external functions declaration]=========================*/
+/** \brief initializes the modules used by the cases
+ **
+ ** Called once before the first case.
+ **/
+extern void ciaaBench_casesInit(void);
+
+/** \brief measures a case
+ **
+ ** \param[in] bcase case to be measured
+ ** \param[in] warmup count of samples executed before the measurement
+ ** \param[in] samples count of measured samples, 1 to CIAABENCH_MAX_SAMPLES
+ ** \param[out] result median and 99th percentile per call
+ **/
+extern void ciaaBench_run(ciaaBench_caseType const * bcase, uint32_t warmup,
+      uint32_t samples, ciaaBench_resultType * result);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef _CIAABENCH_H_ */
@@ -0,0 +1,258 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief CIAA benchmark runner of the hot paths
+ **
+ ** Usage: bench.bin [-o results.json] [-n samples] [-w warmup]
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Tools CIAA Tools
+ ** @{ */
+/** \addtogroup Benchmarks Benchmarks
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaBench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** \brief ns per call of each sample */
+static double ciaaBench_ns[CIAABENCH_MAX_SAMPLES];
+
+/** \brief cycles per call of each sample */
+static double ciaaBench_cyc[CIAABENCH_MAX_SAMPLES];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief returns the monotonic clock in ns */
+static uint64_t ciaaBench_getNs(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+/** \brief compares two doubles for qsort */
+static int ciaaBench_compare(void const * a, void const * b)
+{
+   double da = *(double const *)a;
+   double db = *(double const *)b;
+
+   return (da > db) - (da < db);
+}
+
+/** \brief executes one sample of a case
+ **
+ ** \param[in] bcase case to be executed
+ ** \param[out] ns ns per call
+ ** \param[out] cycles cycles per call
+ **/
+static void ciaaBench_sample(ciaaBench_caseType const * bcase, double * ns,
+      double * cycles)
+{
+   uint64_t startNs;
+   uint64_t startCycles;
+   uint64_t endCycles;
+   uint64_t endNs;
+
+   if (NULL != bcase->setup)
+   {
+      bcase->setup(bcase->calls);
+   }
+
+   startNs = ciaaBench_getNs();
+   startCycles = ciaaBench_cycles();
+   bcase->run(bcase->calls);
+   endCycles = ciaaBench_cycles();
+   endNs = ciaaBench_getNs();
+
+   *ns = (double)(endNs - startNs) / bcase->calls;
+   *cycles = (double)(endCycles - startCycles) / bcase->calls;
+}
+
+/** \brief writes the results as JSON
+ **
+ ** \param[in] path file to be written
+ ** \param[in] warmup count of warm-up samples
+ ** \param[in] samples count of measured samples
+ ** \param[in] results results of each case of ciaaBench_cases
+ ** \return 0 on success, -1 if the file can not be written
+ **/
+static int32_t ciaaBench_writeJson(char const * path, uint32_t warmup,
+      uint32_t samples, ciaaBench_resultType const * results)
+{
+   int32_t ret = -1;
+   FILE * file = fopen(path, "w");
+   uint32_t i;
+
+   if (NULL != file)
+   {
+      fprintf(file, "{\n   \"warmup\": %u,\n   \"samples\": %u,\n   \"cases\": {\n",
+            warmup, samples);
+      for(i = 0; i < ciaaBench_casesCount; i++)
+      {
+         fprintf(file, "      \"%s\": {\n"
+               "         \"calls\": %u,\n"
+               "         \"ns\": { \"median\": %.3f, \"p99\": %.3f },\n"
+               "         \"cycles\": { \"median\": %.3f, \"p99\": %.3f }\n"
+               "      }%s\n",
+               ciaaBench_cases[i].name, ciaaBench_cases[i].calls,
+               results[i].nsMedian, results[i].nsP99,
+               results[i].cyclesMedian, results[i].cyclesP99,
+               (i + 1 < ciaaBench_casesCount) ? "," : "");
+      }
+      fprintf(file, "   }\n}\n");
+
+      if (0 == fclose(file))
+      {
+         ret = 0;
+      }
+   }
+
+   return ret;
+}
+
+/*==================[external functions definition]==========================*/
+extern void ciaaBench_run(ciaaBench_caseType const * bcase, uint32_t warmup,
+      uint32_t samples, ciaaBench_resultType * result)
+{
+   double ns;
+   double cycles;
+   uint32_t i;
+
+   /* warm up the caches and the branch predictors */
+   for(i = 0; i < warmup; i++)
+   {
+      ciaaBench_sample(bcase, &ns, &cycles);
+   }
+
+   for(i = 0; i < samples; i++)
+   {
+      ciaaBench_sample(bcase, &ciaaBench_ns[i], &ciaaBench_cyc[i]);
+   }
+
+   qsort(ciaaBench_ns, samples, sizeof(double), ciaaBench_compare);
+   qsort(ciaaBench_cyc, samples, sizeof(double), ciaaBench_compare);
+
+   result->nsMedian = ciaaBench_ns[samples / 2];
+   result->nsP99 = ciaaBench_ns[(samples * 99) / 100];
+   result->cyclesMedian = ciaaBench_cyc[samples / 2];
+   result->cyclesP99 = ciaaBench_cyc[(samples * 99) / 100];
+}
+
+int main(int argc, char * argv[])
+{
+   static ciaaBench_resultType results[64];
+   char const * json = NULL;
+   uint32_t samples = CIAABENCH_SAMPLES;
+   uint32_t warmup = CIAABENCH_WARMUP;
+   int ret = 0;
+   int i;
+
+   for(i = 1; (i < argc) && (0 == ret); i++)
+   {
+      if ((0 == strcmp(argv[i], "-o")) && (i + 1 < argc))
+      {
+         json = argv[++i];
+      }
+      else if ((0 == strcmp(argv[i], "-n")) && (i + 1 < argc))
+      {
+         samples = (uint32_t)strtoul(argv[++i], NULL, 0);
+      }
+      else if ((0 == strcmp(argv[i], "-w")) && (i + 1 < argc))
+      {
+         warmup = (uint32_t)strtoul(argv[++i], NULL, 0);
+      }
+      else
+      {
+         ret = 1;
+      }
+   }
+
+   if ((0 == samples) || (samples > CIAABENCH_MAX_SAMPLES) ||
+       (ciaaBench_casesCount > sizeof(results) / sizeof(results[0])))
+   {
+      ret = 1;
+   }
+
+   if (0 != ret)
+   {
+      printf("Usage: %s [-o results.json] [-n samples] [-w warmup]\n", argv[0]);
+   }
+   else
+   {
+      ciaaBench_casesInit();
+
+      printf("%-32s %8s %12s %12s %12s %12s\n", "case", "calls",
+            "median ns", "p99 ns", "median cyc", "p99 cyc");
+      for(i = 0; i < (int)ciaaBench_casesCount; i++)
+      {
+         ciaaBench_run(&ciaaBench_cases[i], warmup, samples, &results[i]);
+         printf("%-32s %8u %12.1f %12.1f %12.1f %12.1f\n",
+               ciaaBench_cases[i].name, ciaaBench_cases[i].calls,
+               results[i].nsMedian, results[i].nsP99,
+               results[i].cyclesMedian, results[i].cyclesP99);
+      }
+
+      if ((NULL != json) &&
+          (0 != ciaaBench_writeJson(json, warmup, samples, results)))
+      {
+         printf("%s: can not write %s\n", argv[0], json);
+         ret = 1;
+      }
+   }
+
+   return ret;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,657 @@
+/* Copyright 2016, ACSE & CADIEEL
+ *    ACSE   : http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *    CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief CIAA benchmark cases of the hot paths
+ **
+ ** The ring buffer, the heap, the string functions, the devices lookup and
+ ** the matrix kernels. The sizes are the ones used by the drivers and the
+ ** examples: 16 bytes records, 64 and 1024 bytes copies and 8x8 matrixes.
+ **
+ ** The inline fast paths of the ring buffer and the typed ring are measured
+ ** with the same bytes and records as the byte ring to compare them.
+ **
+ ** The queue cases transfer the elements from 1 to 8 producer threads to
+ ** as many consumer threads, one by one and in batches of 16. A sample
+ ** includes the start and the join of the threads. The consumers check
+ ** that the elements of each producer are got in order.
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Tools CIAA Tools
+ ** @{ */
+/** \addtogroup Benchmarks Benchmarks
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaBench.h"
+#include "ciaaLibs_CircBuf.h"
+#include "ciaaLibs_Matrix.h"
+#include "ciaaLibs_Queue.h"
+#include "ciaaPOSIX_stdlib.h"
+#include "ciaaPOSIX_string.h"
+#include "ciaaDevices.h"
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+/*==================[macros and definitions]=================================*/
+/** \brief size of the ring buffer, shall be a power of 2 */
+#define BENCH_RING_SIZE          2048
+
+/** \brief size of a record put to and got from the ring buffer */
+#define BENCH_RECORD_SIZE        16
+
+/** \brief count of elements allocated at the same time by the heap cases,
+ **        the same workload as the benchmarks of the unit tests */
+#define BENCH_LIVE               16
+
+/** \brief sizes requested by the heap cases */
+#define BENCH_SIZES              { 12, 24, 40, 60, 100, 8, 30, 16 }
+
+/** \brief count of devices registered for the lookup */
+#define BENCH_DEVICES            12
+
+/** \brief rows and columns of the matrixes */
+#define BENCH_MATRIX_N           8
+
+/** \brief count of records of the typed ring, shall be a power of 2 */
+#define BENCH_RECORDS            64
+
+/** \brief elements of the queue, shall be a power of 2 */
+#define BENCH_QUEUE_SIZE         1024
+
+/** \brief maximal count of producers and of consumers of the queue */
+#define BENCH_THREADS            8
+
+/** \brief elements transferred by a sample of the queue cases */
+#define BENCH_ELEMENTS           16384
+
+/** \brief record of the typed ring */
+typedef struct {
+   uint8_t data[BENCH_RECORD_SIZE];
+} recordType;
+
+/** \brief element of the queue */
+typedef struct {
+   uint32_t producer;
+   uint32_t seq;
+} elementType;
+
+/** \brief arguments of a producer or consumer thread */
+typedef struct {
+   uint32_t id;                  /** <= id of the producer */
+   uint32_t count;               /** <= elements to put or to get */
+   uint32_t batch;               /** <= elements per call */
+   uint32_t errors;              /** <= elements got out of order */
+   uint32_t last[BENCH_THREADS]; /** <= next seq of each producer */
+} threadArgType;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+static void circBufPutSetup(uint32_t calls);
+static void circBufPutRun(uint32_t calls);
+static void circBufGetSetup(uint32_t calls);
+static void circBufGetRun(uint32_t calls);
+static void circBufPut1Run(uint32_t calls);
+static void circBufGet1Setup(uint32_t calls);
+static void circBufGet1Run(uint32_t calls);
+static void circBufPutByteRun(uint32_t calls);
+static void circBufGetByteRun(uint32_t calls);
+static void circBufPutSmallRun(uint32_t calls);
+static void circBufGetSmallSetup(uint32_t calls);
+static void circBufGetSmallRun(uint32_t calls);
+static void ringPutSetup(uint32_t calls);
+static void ringPutRun(uint32_t calls);
+static void ringGetSetup(uint32_t calls);
+static void ringGetRun(uint32_t calls);
+static void mallocSetup(uint32_t calls);
+static void mallocRun(uint32_t calls);
+static void freeSetup(uint32_t calls);
+static void freeRun(uint32_t calls);
+static void memcpy64Run(uint32_t calls);
+static void memcpy1024Run(uint32_t calls);
+static void getDeviceRun(uint32_t calls);
+static void matrixAddRun(uint32_t calls);
+static void matrixSubRun(uint32_t calls);
+static void matrixMulRun(uint32_t calls);
+static void * queueProducer(void * arg);
+static void * queueConsumer(void * arg);
+static void queueRun(uint32_t threads, uint32_t batch, uint32_t calls);
+static void queueSetup(uint32_t calls);
+static void queue1Run(uint32_t calls);
+static void queue2Run(uint32_t calls);
+static void queue4Run(uint32_t calls);
+static void queue8Run(uint32_t calls);
+static void queue1BatchRun(uint32_t calls);
+static void queue2BatchRun(uint32_t calls);
+static void queue4BatchRun(uint32_t calls);
+static void queue8BatchRun(uint32_t calls);
+
+/*==================[internal data definition]===============================*/
+/** \brief ring buffer of the ring buffer cases */
+static ciaaLibs_CircBufType ring;
+
+/** \brief storage of ring */
+static uint8_t ringBuf[BENCH_RING_SIZE];
+
+/** \brief record put to and got from ring */
+static uint8_t record[BENCH_RECORD_SIZE];
+
+/** \brief typed ring of records */
+CIAALIBS_RING_DECLARE(recordRing, recordType, BENCH_RECORDS);
+
+/** \brief record put to and got from recordRing */
+static recordType typedRecord;
+
+/** \brief blocks allocated by the heap cases */
+static void * live[BENCH_LIVE];
+
+/** \brief count of valid entries of live */
+static uint32_t liveCount;
+
+/** \brief source and destination of the copies */
+static uint8_t copySrc[1024];
+static uint8_t copyDst[1024];
+
+/** \brief paths of the devices, the looked up device is the last one */
+static char const * const devicePaths[BENCH_DEVICES] = {
+   "/dev/serial/uart/0", "/dev/serial/uart/1", "/dev/serial/uart/2",
+   "/dev/block/fd/0", "/dev/dio/in/0", "/dev/dio/out/0",
+   "/dev/aio/in/0", "/dev/aio/out/0", "/dev/net/eth/0",
+   "/dev/mem", "/dev/trace", "/dev/serial/usb/0",
+};
+
+/** \brief devices registered for the lookup */
+static ciaaDevices_deviceType devices[BENCH_DEVICES];
+
+/** \brief device found by the last lookup, keeps the calls alive */
+static ciaaDevices_deviceType * volatile found;
+
+/** \brief data of the matrixes */
+static float matAData[BENCH_MATRIX_N * BENCH_MATRIX_N];
+static float matBData[BENCH_MATRIX_N * BENCH_MATRIX_N];
+static float matCData[BENCH_MATRIX_N * BENCH_MATRIX_N];
+
+/** \brief matrixes of the matrix cases */
+static ciaaLibs_matrix_t matA;
+static ciaaLibs_matrix_t matB;
+static ciaaLibs_matrix_t matC;
+
+/** \brief queue of the queue cases */
+CIAALIBS_QUEUEDECLARE(benchQueue, elementType, BENCH_QUEUE_SIZE);
+
+/** \brief arguments of the producers */
+static threadArgType producers[BENCH_THREADS];
+
+/** \brief arguments of the consumers */
+static threadArgType consumers[BENCH_THREADS];
+
+/*==================[external data definition]===============================*/
+/** \brief cases of the benchmark */
+ciaaBench_caseType const ciaaBench_cases[] = {
+   { "ciaaLibs_circBufPut",         circBufPutSetup,  circBufPutRun,    64 },
+   { "ciaaLibs_circBufGet",         circBufGetSetup,  circBufGetRun,    64 },
+   { "ciaaLibs_circBufPutSmall",    circBufPutSetup,  circBufPutSmallRun, 64 },
+   { "ciaaLibs_circBufGetSmall",    circBufGetSmallSetup, circBufGetSmallRun, 64 },
+   { "CIAALIBS_RING_put",           ringPutSetup,     ringPutRun,       BENCH_RECORDS },
+   { "CIAALIBS_RING_get",           ringGetSetup,     ringGetRun,       BENCH_RECORDS },
+   { "ciaaLibs_circBufPut_1",       circBufPutSetup,  circBufPut1Run,   1024 },
+   { "ciaaLibs_circBufGet_1",       circBufGet1Setup, circBufGet1Run,   1024 },
+   { "ciaaLibs_circBufPutByte",     circBufPutSetup,  circBufPutByteRun, 1024 },
+   { "ciaaLibs_circBufGetByte",     circBufGet1Setup, circBufGetByteRun, 1024 },
+   { "ciaaPOSIX_malloc",            mallocSetup,      mallocRun,        BENCH_LIVE },
+   { "ciaaPOSIX_free",              freeSetup,        freeRun,          BENCH_LIVE },
+   { "ciaaPOSIX_memcpy_64",         NULL,             memcpy64Run,      256 },
+   { "ciaaPOSIX_memcpy_1024",       NULL,             memcpy1024Run,    64 },
+   { "ciaaDevices_getDevice",       NULL,             getDeviceRun,     256 },
+   { "ciaaLibs_MatrixAdd_float",    NULL,             matrixAddRun,     64 },
+   { "ciaaLibs_MatrixSub_float",    NULL,             matrixSubRun,     64 },
+   { "ciaaLibs_MatrixMul_float",    NULL,             matrixMulRun,     16 },
+   { "ciaaLibs_queue_1x1",          queueSetup,       queue1Run,        BENCH_ELEMENTS },
+   { "ciaaLibs_queue_2x2",          queueSetup,       queue2Run,        BENCH_ELEMENTS },
+   { "ciaaLibs_queue_4x4",          queueSetup,       queue4Run,        BENCH_ELEMENTS },
+   { "ciaaLibs_queue_8x8",          queueSetup,       queue8Run,        BENCH_ELEMENTS },
+   { "ciaaLibs_queue_1x1_16",       queueSetup,       queue1BatchRun,   BENCH_ELEMENTS },
+   { "ciaaLibs_queue_2x2_16",       queueSetup,       queue2BatchRun,   BENCH_ELEMENTS },
+   { "ciaaLibs_queue_4x4_16",       queueSetup,       queue4BatchRun,   BENCH_ELEMENTS },
+   { "ciaaLibs_queue_8x8_16",       queueSetup,       queue8BatchRun,   BENCH_ELEMENTS },
+};
+
+/** \brief count of cases of ciaaBench_cases */
+uint32_t const ciaaBench_casesCount =
+   sizeof(ciaaBench_cases) / sizeof(ciaaBench_cases[0]);
+
+/*==================[internal functions definition]==========================*/
+static void circBufPutSetup(uint32_t calls)
+{
+   (void)calls;
+   ciaaLibs_circBufInit(&ring, ringBuf, sizeof(ringBuf));
+}
+
+static void circBufPutRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_circBufPut(&ring, record, sizeof(record));
+   }
+}
+
+static void circBufGetSetup(uint32_t calls)
+{
+   ciaaLibs_circBufInit(&ring, ringBuf, sizeof(ringBuf));
+   circBufPutRun(calls);
+}
+
+static void circBufGetRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_circBufGet(&ring, record, sizeof(record));
+   }
+}
+
+static void circBufPut1Run(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_circBufPut(&ring, record, 1);
+   }
+}
+
+static void circBufGet1Setup(uint32_t calls)
+{
+   ciaaLibs_circBufInit(&ring, ringBuf, sizeof(ringBuf));
+   circBufPut1Run(calls);
+}
+
+static void circBufGet1Run(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_circBufGet(&ring, record, 1);
+   }
+}
+
+static void circBufPutByteRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_circBufPutByte(&ring, record[0]);
+   }
+}
+
+static void circBufGetByteRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_circBufGetByte(&ring, record);
+   }
+}
+
+static void circBufPutSmallRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_circBufPutSmall(&ring, record, sizeof(record));
+   }
+}
+
+static void circBufGetSmallSetup(uint32_t calls)
+{
+   ciaaLibs_circBufInit(&ring, ringBuf, sizeof(ringBuf));
+   circBufPutSmallRun(calls);
+}
+
+static void circBufGetSmallRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_circBufGetSmall(&ring, record, sizeof(record));
+   }
+}
+
+/** \brief empties the typed ring */
+static void ringPutSetup(uint32_t calls)
+{
+   (void)calls;
+   while (0 != recordRing_get(&typedRecord))
+   {
+   }
+}
+
+static void ringPutRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      recordRing_put(&typedRecord);
+   }
+}
+
+static void ringGetSetup(uint32_t calls)
+{
+   ringPutSetup(calls);
+   ringPutRun(calls);
+}
+
+static void ringGetRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      recordRing_get(&typedRecord);
+   }
+}
+
+/** \brief frees the blocks allocated by the previous sample */
+static void mallocSetup(uint32_t calls)
+{
+   (void)calls;
+   while (0 != liveCount)
+   {
+      ciaaPOSIX_free(live[--liveCount]);
+   }
+}
+
+static void mallocRun(uint32_t calls)
+{
+   static size_t const sizes[] = BENCH_SIZES;
+
+   while (0 != calls--)
+   {
+      live[liveCount] = ciaaPOSIX_malloc(sizes[liveCount % (sizeof(sizes) / sizeof(sizes[0]))]);
+      liveCount++;
+   }
+}
+
+static void freeSetup(uint32_t calls)
+{
+   mallocSetup(calls);
+   mallocRun(calls);
+}
+
+static void freeRun(uint32_t calls)
+{
+   uint32_t i;
+
+   /* free every second block first to exercise the merge of the chunks */
+   for(i = 0; i < calls; i += 2)
+   {
+      ciaaPOSIX_free(live[i]);
+   }
+   for(i = 1; i < calls; i += 2)
+   {
+      ciaaPOSIX_free(live[i]);
+   }
+   liveCount = 0;
+}
+
+static void memcpy64Run(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaPOSIX_memcpy(copyDst, copySrc, 64);
+   }
+}
+
+static void memcpy1024Run(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaPOSIX_memcpy(copyDst, copySrc, 1024);
+   }
+}
+
+static void getDeviceRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      found = ciaaDevices_getDevice("/dev/serial/usb/0");
+   }
+}
+
+static void matrixAddRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_MatrixAdd_float(&matA, &matB, &matC);
+   }
+}
+
+static void matrixSubRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_MatrixSub_float(&matA, &matB, &matC);
+   }
+}
+
+static void matrixMulRun(uint32_t calls)
+{
+   while (0 != calls--)
+   {
+      ciaaLibs_MatrixMul_float(&matA, &matB, &matC);
+   }
+}
+
+/** \brief producer thread, puts its elements with increasing seq */
+static void * queueProducer(void * arg)
+{
+   threadArgType * p = (threadArgType *)arg;
+   elementType elements[16];
+   uint32_t seq = 0;
+   uint32_t put;
+   uint32_t n;
+   uint32_t i;
+
+   while (seq < p->count)
+   {
+      n = ((p->count - seq) < p->batch) ? (p->count - seq) : p->batch;
+      for(i = 0; i < n; i++)
+      {
+         elements[i].producer = p->id;
+         elements[i].seq = seq + i;
+      }
+      i = 0;
+      while (i < n)
+      {
+         put = ciaaLibs_queuePut(&benchQueue, &elements[i], n - i);
+         if (0 == put)
+         {
+            /* the queue is full, let the consumers run */
+            sched_yield();
+         }
+         i += put;
+      }
+      seq += n;
+   }
+
+   return NULL;
+}
+
+/** \brief consumer thread, checks that the elements of each producer are
+ **        got in order */
+static void * queueConsumer(void * arg)
+{
+   threadArgType * c = (threadArgType *)arg;
+   elementType elements[16];
+   uint32_t got = 0;
+   uint32_t n;
+   uint32_t i;
+
+   while (got < c->count)
+   {
+      n = ((c->count - got) < c->batch) ? (c->count - got) : c->batch;
+      n = ciaaLibs_queueGet(&benchQueue, elements, n);
+      if (0 == n)
+      {
+         /* the queue is empty, let the producers run */
+         sched_yield();
+      }
+      for(i = 0; i < n; i++)
+      {
+         if (elements[i].seq < c->last[elements[i].producer])
+         {
+            c->errors++;
+         }
+         c->last[elements[i].producer] = elements[i].seq + 1;
+      }
+      got += n;
+   }
+
+   return NULL;
+}
+
+/** \brief transfers the elements from the producers to the consumers
+ **
+ ** \param[in] threads count of producers and of consumers
+ ** \param[in] batch elements per call
+ ** \param[in] calls total count of elements, a multiple of threads
+ **/
+static void queueRun(uint32_t threads, uint32_t batch, uint32_t calls)
+{
+   pthread_t prod[BENCH_THREADS];
+   pthread_t cons[BENCH_THREADS];
+   uint32_t errors = 0;
+   uint32_t i;
+
+   for(i = 0; i < threads; i++)
+   {
+      producers[i].id = i;
+      producers[i].count = calls / threads;
+      producers[i].batch = batch;
+      consumers[i].count = calls / threads;
+      consumers[i].batch = batch;
+      pthread_create(&prod[i], NULL, queueProducer, &producers[i]);
+      pthread_create(&cons[i], NULL, queueConsumer, &consumers[i]);
+   }
+   for(i = 0; i < threads; i++)
+   {
+      pthread_join(prod[i], NULL);
+      pthread_join(cons[i], NULL);
+      errors += consumers[i].errors;
+   }
+
+   if ((0 != errors) || (0 != ciaaLibs_queueCount(&benchQueue)))
+   {
+      printf("ciaaLibs_queue: %u elements out of order, %u left\n",
+            errors, ciaaLibs_queueCount(&benchQueue));
+   }
+}
+
+/** \brief empties the queue and clears the arguments of the threads */
+static void queueSetup(uint32_t calls)
+{
+   (void)calls;
+   ciaaLibs_queueInit(&benchQueue, benchQueue_buf, benchQueue_turn,
+         BENCH_QUEUE_SIZE, sizeof(elementType));
+   ciaaPOSIX_memset(producers, 0, sizeof(producers));
+   ciaaPOSIX_memset(consumers, 0, sizeof(consumers));
+}
+
+static void queue1Run(uint32_t calls)
+{
+   queueRun(1, 1, calls);
+}
+
+static void queue2Run(uint32_t calls)
+{
+   queueRun(2, 1, calls);
+}
+
+static void queue4Run(uint32_t calls)
+{
+   queueRun(4, 1, calls);
+}
+
+static void queue8Run(uint32_t calls)
+{
+   queueRun(8, 1, calls);
+}
+
+static void queue1BatchRun(uint32_t calls)
+{
+   queueRun(1, 16, calls);
+}
+
+static void queue2BatchRun(uint32_t calls)
+{
+   queueRun(2, 16, calls);
+}
+
+static void queue4BatchRun(uint32_t calls)
+{
+   queueRun(4, 16, calls);
+}
+
+static void queue8BatchRun(uint32_t calls)
+{
+   queueRun(8, 16, calls);
+}
+
+/*==================[external functions definition]==========================*/
+extern void ciaaBench_casesInit(void)
+{
+   uint32_t i;
+
+   ciaaPOSIX_stdlib_init();
+   ciaaDevices_init();
+
+   for(i = 0; i < BENCH_DEVICES; i++)
+   {
+      devices[i].path = devicePaths[i];
+      ciaaDevices_addDevice(&devices[i]);
+   }
+
+   for(i = 0; i < sizeof(copySrc); i++)
+   {
+      copySrc[i] = (uint8_t)i;
+   }
+
+   for(i = 0; i < BENCH_MATRIX_N * BENCH_MATRIX_N; i++)
+   {
+      matAData[i] = (float)(i % 5) * 0.25f;
+      matBData[i] = (float)(i % 7) * 0.5f;
+   }
+   ciaaLibs_MatrixInit(&matA, BENCH_MATRIX_N, BENCH_MATRIX_N, CIAA_LIBS_FLOAT_32, matAData);
+   ciaaLibs_MatrixInit(&matB, BENCH_MATRIX_N, BENCH_MATRIX_N, CIAA_LIBS_FLOAT_32, matBData);
+   ciaaLibs_MatrixInit(&matC, BENCH_MATRIX_N, BENCH_MATRIX_N, CIAA_LIBS_FLOAT_32, matCData);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -51,6 +51,10 @@ class FileWriter extends OutputWriter
 
    private $ob_file;
 
+   private $outfile;
+
+   private $unchanged = false;
+
    public function printMsg($msg)
    {
       print $msg;
@@ -84,6 +88,7 @@ class FileWriter extends OutputWriter
          rename($outfile, $outfile . ".old");
       }
       $this->ob_file = fopen($outfile, "w");
+      $this->outfile = $outfile;
       return $outfile;
    }
 
@@ -92,6 +97,23 @@ class FileWriter extends OutputWriter
       $this->buffering=false;
       $this->flush();
       fclose($this->ob_file);
+
+      /* keep the time of an identical output so make does not rebuild its
+       * dependents */
+      $old = $this->outfile . ".old";
+      clearstatcache();
+      $this->unchanged = ( file_exists($old) &&
+                           (filesize($old) == filesize($this->outfile)) &&
+                           (sha1_file($old) === sha1_file($this->outfile)) );
+      if ($this->unchanged)
+      {
+         touch($this->outfile, filemtime($old));
+      }
+   }
+
+   public function unchanged()
+   {
+      return $this->unchanged;
    }
 
    public function ob_file_callback($buffer)
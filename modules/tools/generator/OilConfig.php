@@ -59,76 +59,119 @@ require_once("OilParser.php");
 class OilConfig {
    protected $config = array();
 
+   /** \brief entries by root and by type, in config order
+    **
+    ** $index[root]["*"] holds all the entries of a root and
+    ** $index[root]["=" . type] the ones of a type, built on the first query
+    ** after the config changed. The type is prefixed so numeric types keep
+    ** string keys and can not collide with "*".
+    **/
+   protected $index = null;
+
    function OilConfig()
    {
    }
 
-   function parseOilFile($file)
+   /** \brief Parse an oil file and add its entries to the configuration
+    **
+    ** If a cache directory is given the parsed entries are stored there,
+    ** named by the hash of the file and of the parser, and reused as long as
+    ** neither changes.
+    **
+    ** \param[in] file oil file to be parsed
+    ** \param[in] cacheDir directory of the cache, null to disable it
+    ** \return true if the entries were taken from the cache
+    **/
+   function parseOilFile($file, $cacheDir = null)
    {
-      $parser = new OilParser();
-      $parser->loadFile($file);
-      $parser->parse();
-      foreach ($parser->getOil() as $item) {
+      $items = false;
+
+      if ($cacheDir !== null && file_exists($file))
+      {
+         $cacheFile = $cacheDir . "/" . sha1(sha1_file($file) . sha1_file(dirname(__FILE__) . "/OilParser.php")) . ".oil.ser";
+         if (file_exists($cacheFile))
+         {
+            $items = @unserialize(file_get_contents($cacheFile));
+         }
+      }
+
+      $cached = is_array($items);
+      if (! $cached)
+      {
+         $parser = new OilParser();
+         $parser->loadFile($file);
+         $parser->parse();
+         $items = $parser->getOil();
+
+         if ($cacheDir !== null)
+         {
+            /* rename is atomic, a parallel generator never reads half a file */
+            $tmp = $cacheFile . "." . getmypid();
+            if (file_put_contents($tmp, serialize($items)) !== false)
+            {
+               rename($tmp, $cacheFile);
+            }
+         }
+      }
+
+      foreach ($items as $item) {
           $this->config[] = $item;
       }
+      $this->index = null;
+
+      return $cached;
    }
 
    function setConfig($config)
    {
       $this->config = $config;
+      $this->index = null;
    }
 
-   function parseAutosarFile()
-   {
-   }
-
-   function getValue($root, $type)
+   /** \brief Returns the entries of root of type, all types for '*' */
+   protected function lookup($root, $type)
    {
-      foreach ($this->config as $element)
+      if ($this->index === null)
       {
-         if ( ($element["root"] == $root) && ($element["type"] == $type) )
+         $this->index = array();
+         foreach ($this->config as $element)
          {
-            return $element["value"];
+            $this->index[$element["root"]]["*"][] = $element;
+            $this->index[$element["root"]]["=" . $element["type"]][] = $element;
          }
       }
-      return false;
+
+      $key = ($type == '*') ? "*" : "=" . $type;
+
+      return isset($this->index[$root][$key]) ? $this->index[$root][$key] : array();
    }
 
-   private function compare($element, $root, $type)
+   function parseAutosarFile()
    {
-      return ( $element['root']==$root &&
-         ($element['type'] == $type || $type == '*')
-      );
    }
 
-   function getCount($root, $type)
+   function getValue($root, $type)
    {
-      $count = 0;
+      $elements = $this->lookup($root, $type);
 
-      foreach ($this->config as $element)
-      {
-         if ( $this->compare($element, $root, $type) )
-         {
-            $count++;
-         }
-      }
+      return (count($elements) > 0 && $type != '*') ? $elements[0]["value"] : false;
+   }
 
-      return $count;
+   function getCount($root, $type)
+   {
+      return count($this->lookup($root, $type));
    }
 
    function getList($root, $type, $where = array() )
    {
       $list = array();
 
-      foreach ($this->config as $element)
+      foreach ($this->lookup($root, $type) as $element)
       {
-         if ( $this->compare($element, $root, $type) )
-         {
-            if (empty($where)) {
-               $list[] = $element["value"];
-            } else {
-              die();
-            }
+         if (empty($where)) {
+            $list[] = $element["value"];
+         } else {
+           die();
          }
       }
 
@@ -152,12 +195,9 @@ class OilConfig {
    {
       $ret = array();
 
-      foreach ($this->config as $element)
+      foreach ($this->lookup($root, '*') as $element)
       {
-         if ( $element["root"] == $root )
-         {
-            $ret[] = $element["type"];
-         }
+         $ret[] = $element["type"];
       }
 
       return $ret;
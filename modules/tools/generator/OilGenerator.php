@@ -61,6 +61,12 @@ class OilGenerator
    private $path = "";
    private $log;
    private $writer;
+   private $definitions = array();
+   private $cache = true;
+   private $cacheDir = null;
+   private $inputsHash = "";
+   private $outputs = array();
+   private $times = array();
 
    /** \brief Compare Files Function
    **/
@@ -115,7 +121,7 @@ class OilGenerator
 
    function printHelp()
    {
-      $this->writer->printMsg( "php generator.php [-l] [-h] [--cmdline] [-b PATH ] [-Ddef[=definition]] -c <CONFIG_1> [<CONFIG_N>] -o <OUTPUTDIR> -t <TEMPLATE_1> [<TEMPLATE_N>] [ -H <HELPER_1> [HELPER_N]]>\n");
+      $this->writer->printMsg( "php generator.php [-l] [-h] [--cmdline] [--no-cache] [-b PATH ] [-Ddef[=definition]] -c <CONFIG_1> [<CONFIG_N>] -o <OUTPUTDIR> -t <TEMPLATE_1> [<TEMPLATE_N>] [ -H <HELPER_1> [HELPER_N]]>\n");
       $this->writer->printMsg( "      -c   indicate the configuration input files\n");
       $this->writer->printMsg( "      -o   output directory\n");
       $this->writer->printMsg( "      -t   indicates the templates to be processed\n");
@@ -126,6 +132,7 @@ class OilGenerator
       $this->writer->printMsg( "      -l   displays a short license overview\n");
       $this->writer->printMsg( "      -D   defines\n");
       $this->writer->printMsg( "      --cmdline print the command line\n");
+      $this->writer->printMsg( "      --no-cache render all templates, ignoring the cache in <OUTPUTDIR>/.cache\n");
    }
 
    function processArgs($args)
@@ -156,6 +163,9 @@ class OilGenerator
          case "-v":
             $this->verbose = true;
             break;
+         case "--no-cache":
+            $this->cache = false;
+            break;
          case "-H":
             $atLeastOneHelper = true;
          case "-c":
@@ -418,10 +428,124 @@ class OilGenerator
       foreach ($configFiles as $file)
       {
          $this->log->info("reading " . $file);
-         $this->config->parseOilFile($file);
+         $start = microtime(true);
+         $cached = $this->config->parseOilFile($file, $this->cacheDir);
+         $this->times[] = array($file, microtime(true) - $start, $cached ? "cached" : "parsed");
+      }
+   }
+
+   /** \brief Prepare the cache of the generation
+    **
+    ** The cache lives in the .cache directory of the output directory. A
+    ** template is rendered again only if its output file was modified or
+    ** removed or if the hash of its inputs changed: the template itself,
+    ** the config files, the helpers, the definitions and the generator.
+    ** Files included by the templates are not tracked, use --no-cache
+    ** after changing them.
+    **/
+   public function openCache($configFiles, $baseOutDir, $helperFiles)
+   {
+      if ($this->cache)
+      {
+         $this->cacheDir = $baseOutDir . "/.cache";
+         if (! is_dir($this->cacheDir) && ! @mkdir($this->cacheDir, 0777, true))
+         {
+            $this->log->warning("Cache directory $this->cacheDir can not be created, cache disabled");
+            $this->cacheDir = null;
+         }
+      }
+
+      if ($this->cacheDir !== null)
+      {
+         $hashes = array(serialize($this->definitions));
+         $inputs = array_merge($configFiles, $helperFiles, glob(dirname(__FILE__) . "/*.php"));
+         foreach ($inputs as $file)
+         {
+            $hashes[] = $file . "=" . sha1_file($file);
+         }
+         $this->inputsHash = sha1(implode("\n", $hashes));
+
+         $manifest = $this->cacheDir . "/outputs.ser";
+         if (file_exists($manifest))
+         {
+            $this->outputs = @unserialize(file_get_contents($manifest));
+            if (! is_array($this->outputs))
+            {
+               $this->outputs = array();
+            }
+         }
+      }
+   }
+
+   public function closeCache()
+   {
+      /* a run with errors keeps the previous manifest, the outputs of the
+       * failed run do not match it and are rendered again */
+      if ( ($this->cacheDir !== null) && ($this->log->getErrors() == 0) )
+      {
+         $manifest = $this->cacheDir . "/outputs.ser";
+         $tmp = $manifest . "." . getmypid();
+         if (file_put_contents($tmp, serialize($this->outputs)) !== false)
+         {
+            rename($tmp, $manifest);
+         }
+      }
+   }
+
+   /** \brief Returns the key of the output of a template, false without cache */
+   public function templateKey($file, $outfile)
+   {
+      $key = false;
+
+      if ($this->cacheDir !== null)
+      {
+         /* the php files shared by the templates of a module, in the ginc
+          * directory next to the one of the template, are part of the key */
+         $shared = "";
+         $includes = glob(dirname(dirname($file)) . "/ginc/*.php");
+         foreach (($includes === false) ? array() : $includes as $include)
+         {
+            $shared .= sha1_file($include);
+         }
+         $key = sha1($this->inputsHash . $outfile . sha1_file($file) . $shared);
+      }
+
+      return $key;
+   }
+
+   /** \brief Checks if the output of a template is up to date */
+   public function isCached($key, $outfile)
+   {
+      return ( ($key !== false) &&
+               isset($this->outputs[$outfile]) &&
+               ($this->outputs[$outfile]["key"] === $key) &&
+               file_exists($outfile) &&
+               ($this->outputs[$outfile]["hash"] === sha1_file($outfile)) );
+   }
+
+   /** \brief Records the output of a template in the cache */
+   public function addOutput($key, $outfile)
+   {
+      if ($key !== false)
+      {
+         $this->outputs[$outfile] = array("key" => $key, "hash" => sha1_file($outfile));
       }
    }
 
+   public function printTimes()
+   {
+      $total = 0;
+
+      $this->log->info("generation times:");
+      foreach ($this->times as $time)
+      {
+         list($file, $seconds, $status) = $time;
+         $this->log->info(sprintf("   %9.2f ms %-9s %s", $seconds * 1000, $status, $file));
+         $total += $seconds;
+      }
+      $this->log->info(sprintf("   %9.2f ms total", $total * 1000));
+   }
+
    public function loadHelpers($helperFiles)
    {
       foreach ($helperFiles as $file)
@@ -441,12 +565,43 @@ class OilGenerator
          }
          else
          {
-            $outfile = $this->writer->open($file, $baseOutDir, $directorySeparator);
-            $this->writer->start();
-            $clone = clone($this);
-            $clone->isolatedInclude($file);
-            $this->writer->close();
-            $runagain = $this->isMak($outfile, $runagain);
+            $start = microtime(true);
+            $key = false;
+            $outfile = "";
+            if (method_exists($this->writer, 'outputFileName'))
+            {
+               $outfile = $this->writer->outputFileName($file, $baseOutDir, $directorySeparator);
+               $key = $this->templateKey($file, $outfile);
+            }
+
+            if ($this->isCached($key, $outfile))
+            {
+               $this->log->info("skipping " . $file . ", " . $outfile . " is up to date");
+               $status = "cached";
+            }
+            else
+            {
+               $errors = $this->log->getErrors();
+               $outfile = $this->writer->open($file, $baseOutDir, $directorySeparator);
+               $this->writer->start();
+               $clone = clone($this);
+               $clone->isolatedInclude($file);
+               $this->writer->close();
+               $runagain = $this->isMak($outfile, $runagain);
+               $status = $this->writer->unchanged() ? "unchanged" : "rendered";
+
+               /* an output with errors is rendered again by the next run */
+               if ($this->log->getErrors() > $errors)
+               {
+                  $status = "failed";
+                  unset($this->outputs[$outfile]);
+               }
+               else
+               {
+                  $this->addOutput($key, $outfile);
+               }
+            }
+            $this->times[] = array($file, microtime(true) - $start, $status);
          }
       }
       return $runagain;
@@ -471,6 +626,8 @@ class OilGenerator
 
          $this->config = new OilConfig();
 
+         $this->openCache($configFiles, $baseOutDir, $helperFiles);
+
          $runagain = false;
 
          $this->parseOilFiles($configFiles);
@@ -481,6 +638,10 @@ class OilGenerator
 
          $runagain = $this->renderTemplates($templateFiles, $baseOutDir, $directorySeparator, $runagain);
 
+         $this->closeCache();
+
+         $this->printTimes();
+
          $this->log->info($this->log->getReport());
 
          if ($this->log->getErrors() > 0)
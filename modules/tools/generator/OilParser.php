@@ -71,23 +71,15 @@ class OilParser {
 
    function normalize()
    {
-      for ($l = 0; $l < count($this->lines); $l++)
-      {
-
-         $this->lines[$l] = $this->removeMultiBlank($this->lines[$l]);
+      /* the whole file in one pass of each replacement instead of line by line */
+      $this->lines = preg_replace("/[ \t]+/", ' ', $this->lines);
 
-         /* remove spaces and tabs at start and end of the line */
-         $this->lines[$l] = trim($this->lines[$l]);
+      /* remove spaces and tabs at start and end of the line */
+      $this->lines = array_map('trim', $this->lines);
 
-         /* remove spaces sides of = */
-         $this->lines[$l] = str_replace(" = ", "=", $this->lines[$l]);   // untested
+      /* remove spaces sides of =, space before ; and ; */
+      $this->lines = str_replace(array(" = ", " ;", ";"), array("=", ";", ""), $this->lines);
 
-         /* remove space before ; */
-         $this->lines[$l] = str_replace(" ;",";", $this->lines[$l]);     // untested
-
-         /* remove ; */
-         $this->lines[$l] = str_replace(";","", $this->lines[$l]);       // only one?
-      }
       return $this->lines;
    }
 
@@ -104,8 +96,9 @@ class OilParser {
    function removeComments()
    {
       $state = 'searching opening';
+      $count = count($this->lines);
 
-      for ($l = 0; $l < count($this->lines); $l++)
+      for ($l = 0; $l < $count; $l++)
       {
          if ($state == 'searching opening' ) {
             $start = strpos($this->lines[$l], "/");
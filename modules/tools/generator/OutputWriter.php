@@ -90,6 +90,14 @@ abstract class OutputWriter
       }
    }
 
+   /** \brief Returns true if the last closed output was identical to the
+    ** previous one and was therefore left untouched
+    **/
+   public function unchanged()
+   {
+      return false;
+   }
+
    public function setLog($log)
    {
       $this->log = $log;
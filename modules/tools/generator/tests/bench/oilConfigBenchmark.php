@@ -0,0 +1,160 @@
+<?php
+/* Copyright 2016, ACSE & CADIEEL
+ *      ACSE: http://www.sase.com.ar/asociacion-civil-sistemas-embebidos/ciaa/
+ *      CADIEEL: http://www.cadieel.org.ar
+ * All rights reserved.
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief FreeOSEK Generator OilConfig benchmark
+ **
+ ** Parses a synthetic oil file with many tasks, alarms and resources and
+ ** runs the queries a template issues for each of them, with the indexed
+ ** OilConfig and with a linear scan as reference. Both shall return the
+ ** same results.
+ **
+ ** Usage: php oilConfigBenchmark.php [count, default 1000]
+ **
+ ** \file oilConfigBenchmark.php
+ **
+ **/
+
+/** \addtogroup FreeOSEK
+ ** @{ */
+/** \addtogroup Generator
+ ** @{ */
+
+/*==================[inclusions]=============================================*/
+require_once(dirname(__FILE__) . '/../../OilConfig.php');
+
+/*==================[class definition]=======================================*/
+/** \brief OilConfig with the linear scan of the config for each query */
+class LinearOilConfig extends OilConfig
+{
+   protected function lookup($root, $type)
+   {
+      $ret = array();
+
+      foreach ($this->config as $element)
+      {
+         if ( $element['root'] == $root &&
+            ($element['type'] == $type || $type == '*') )
+         {
+            $ret[] = $element;
+         }
+      }
+
+      return $ret;
+   }
+}
+
+/** \brief writes an oil file with count tasks, alarms and resources */
+function writeOil($file, $count)
+{
+   $oil = "OSEK OSEK {\n   OS ExampleOS {\n      STATUS = EXTENDED;\n   };\n";
+   for ($i = 0; $i < $count; $i++)
+   {
+      $oil .= "   RESOURCE = Resource$i;\n";
+      $oil .= "   TASK Task$i {\n" .
+              "      PRIORITY = " . ($i % 32) . ";\n" .
+              "      ACTIVATION = 1;\n" .
+              "      STACK = 512;\n" .
+              "      TYPE = BASIC;\n" .
+              "      SCHEDULE = FULL;\n" .
+              "      RESOURCE = Resource$i;\n" .
+              "   }\n";
+      $oil .= "   ALARM Alarm$i {\n" .
+              "      COUNTER = HardwareCounter;\n" .
+              "      ACTION = ACTIVATETASK {\n" .
+              "         TASK = Task$i;\n" .
+              "      }\n" .
+              "      AUTOSTART = FALSE;\n" .
+              "   }\n";
+   }
+   $oil .= "};\n";
+   file_put_contents($file, $oil);
+}
+
+/** \brief runs the queries of a template, returns a digest of the results */
+function query($config)
+{
+   $results = array();
+
+   foreach ($config->getList("/OSEK", "TASK") as $task)
+   {
+      $results[] = $config->getValue("/OSEK/" . $task, "PRIORITY");
+      $results[] = $config->getValue("/OSEK/" . $task, "STACK");
+      $results[] = $config->getValue("/OSEK/" . $task, "SCHEDULE");
+      $results[] = implode(",", $config->getList("/OSEK/" . $task, "RESOURCE"));
+      $results[] = $config->getCount("/OSEK/" . $task, "EVENT");
+   }
+   foreach ($config->getList("/OSEK", "ALARM") as $alarm)
+   {
+      $results[] = $config->getValue("/OSEK/" . $alarm, "COUNTER");
+      $results[] = $config->getValue("/OSEK/" . $alarm . "/ACTIVATETASK", "TASK");
+      $results[] = implode(",", $config->getAttributes("/OSEK/" . $alarm));
+   }
+   $results[] = $config->getCount("/OSEK", "RESOURCE");
+
+   return sha1(implode("\n", $results));
+}
+
+/*==================[benchmark]==============================================*/
+$count = ($argc > 1) ? intval($argv[1]) : 1000;
+$file = sys_get_temp_dir() . "/oilConfigBenchmark" . getmypid() . ".oil";
+
+writeOil($file, $count);
+
+$digests = array();
+foreach (array("OilConfig", "LinearOilConfig") as $class)
+{
+   $config = new $class();
+
+   $start = microtime(true);
+   $config->parseOilFile($file);
+   $parsed = microtime(true);
+   $digests[$class] = query($config);
+   $end = microtime(true);
+
+   printf("%-16s %d tasks/alarms/resources: parse %8.1f ms, queries %8.1f ms\n",
+      $class, $count, ($parsed - $start) * 1000, ($end - $parsed) * 1000);
+}
+
+unlink($file);
+
+if ($digests["OilConfig"] !== $digests["LinearOilConfig"])
+{
+   print "ERROR: the indexed and the linear queries differ\n";
+   exit(1);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
@@ -134,6 +134,30 @@ class OilConfigTest extends PHPUnit_Framework_TestCase
       $this->assertEquals($expected, $config->getCount($data[0],$data[1]) ,$msg);
    }
 
+   public function testGetAttributes()
+   {
+      $config = new OilConfig();
+      $config->setConfig($this->config);
+      $this->assertEquals(array("USERESSCHEDULER","MEMMAP"), $config->getAttributes("/OSEK/ExampleOS"));
+      $this->assertEquals(array(), $config->getAttributes("/OSEKO"));
+   }
+
+   public function testSetConfigAfterQuery()
+   {
+      $config = new OilConfig();
+      $config->setConfig($this->config);
+      $this->assertEquals("POSIX", $config->getValue("/OSEK","RESOURCE"));
+      $config->setConfig(array(
+         array(
+            "root" => "/OSEK",
+            "type" => "RESOURCE",
+            "value"=> "OTHER"
+         )
+      ));
+      $this->assertEquals("OTHER", $config->getValue("/OSEK","RESOURCE"));
+      $this->assertEquals(0, $config->getCount("/OSEK","COUNTER"));
+   }
+
 }
 
 /** @} doxygen end group definition */
@@ -122,6 +122,89 @@ class OilGeneratorTest extends PHPUnit_Framework_TestCase
       $this->assertEquals($expected,$args);
    }
 
+   public function testProcessArgs_noCache()
+   {
+      $og = new OilGenerator(new NullWriter());
+      $dir = sys_get_temp_dir() . '/OilGeneratorTest' . getmypid();
+      $file = dirname(__FILE__). '/fixtures/fileA.txt';
+
+      mkdir($dir);
+      $og->processArgs(array('--no-cache','-c','mock.oil','-o','mockdir','-t','mocktemplate'));
+      $og->openCache(array($file), $dir, array());
+      $this->assertFalse($og->templateKey($file, $dir . '/out.c'));
+      $this->assertFalse(is_dir($dir . '/.cache'));
+      rmdir($dir);
+   }
+
+   public function testCache()
+   {
+      $dir = sys_get_temp_dir() . '/OilGeneratorTest' . getmypid();
+      $file = dirname(__FILE__). '/fixtures/fileA.txt';
+      $other = dirname(__FILE__). '/fixtures/fileNotLikeA.txt';
+      $outfile = $dir . '/out.c';
+
+      mkdir($dir);
+      file_put_contents($outfile, "generated");
+
+      $og = new OilGenerator(new NullWriter());
+      $og->openCache(array($file), $dir, array());
+      $key = $og->templateKey($file, $outfile);
+      $this->assertNotEquals(false, $key);
+      $this->assertFalse($og->isCached($key, $outfile), '// not recorded');
+      $og->addOutput($key, $outfile);
+      $this->assertTrue($og->isCached($key, $outfile), '// recorded');
+      $this->assertFalse($og->isCached($og->templateKey($other, $outfile), $outfile), '// other template');
+      $og->closeCache();
+
+      /* the next generation finds the output in the cache */
+      $og = new OilGenerator(new NullWriter());
+      $og->openCache(array($file), $dir, array());
+      $this->assertTrue($og->isCached($key, $outfile), '// next generation');
+      $og = new OilGenerator(new NullWriter());
+      $og->openCache(array($other), $dir, array());
+      $this->assertFalse($og->isCached($og->templateKey($file, $outfile), $outfile), '// other config');
+
+      /* a modified output is generated again */
+      file_put_contents($outfile, "modified");
+      $this->assertFalse($og->isCached($key, $outfile), '// modified');
+
+      array_map('unlink', glob($dir . '/.cache/*'));
+      rmdir($dir . '/.cache');
+      unlink($outfile);
+      rmdir($dir);
+   }
+
+   public function testCache_error()
+   {
+      $dir = sys_get_temp_dir() . '/OilGeneratorTest' . getmypid();
+      $file = dirname(__FILE__). '/fixtures/fileA.txt';
+      $template = $dir . '/templates/error.c.php';
+      $outfile = $dir . '/error.c';
+
+      mkdir($dir . '/templates', 0777, true);
+      file_put_contents($template, "<?php \$this->log->error('bad configuration'); ?>broken\n");
+
+      $og = new OilGenerator(new FileWriter());
+      $og->openCache(array($file), $dir, array());
+      $key = $og->templateKey($template, $outfile);
+      $og->renderTemplates(array($template), $dir, '/templates/', false);
+      $this->assertTrue(file_exists($outfile), '// rendered');
+      $this->assertFalse($og->isCached($key, $outfile), '// failed output recorded');
+      $og->closeCache();
+
+      /* the next generation renders the template again */
+      $og = new OilGenerator(new FileWriter());
+      $og->openCache(array($file), $dir, array());
+      $this->assertFalse($og->isCached($key, $outfile), '// failed output cached');
+
+      array_map('unlink', glob($dir . '/.cache/*'));
+      rmdir($dir . '/.cache');
+      array_map('unlink', glob($dir . '/error.c*'));
+      unlink($template);
+      rmdir($dir . '/templates');
+      rmdir($dir);
+   }
+
    /**
    * @expectedException OilGeneratorException
    */
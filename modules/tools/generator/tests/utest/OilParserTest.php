@@ -99,6 +99,26 @@ class OilParserTest extends PHPUnit_Framework_TestCase
       $this->assertEquals($expected, $parser->removeComments() ,$msg);
    }
 
+   public function normalizeProvider()
+   {
+      return array(
+         array(array('OS ExampleOS {'),array("\tOS  ExampleOS {"),'blanks'),
+         array(array('STATUS=EXTENDED'),array("   STATUS = EXTENDED ;  "),'assignment'),
+         array(array('TASK InitTask', ''),array("TASK InitTask;", " \t "),'semicolon'),
+      );
+   }
+
+   /**
+   * @dataProvider normalizeProvider
+   *
+   */
+   public function testNormalize($expected, $data, $msg)
+   {
+      $parser = new OilParser();
+      $parser->loadArray($data);
+      $this->assertEquals($expected, $parser->normalize() ,$msg);
+   }
+
    public function removeMultiBlankProvider()
    {
       return array(
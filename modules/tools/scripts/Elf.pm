@@ -0,0 +1,103 @@
+#!/usr/bin/perl
+
+package Elf;
+
+use strict;
+use warnings;
+
+###############################################################################
+# Section headers and constant strings of an elf file, used by the host tools
+# which decode the binary records of the target (ciaaLog.pl, ciaaTrace.pl)
+###############################################################################
+
+# read the section headers of an elf file
+sub new {
+   my $class = shift;
+   my $self = {
+      _file => shift,
+   };
+   my $data;
+
+   open(my $fh, "<", $self->{_file}) or die "$0: open $self->{_file} $!";
+   binmode($fh);
+   local $/;
+   $data = <$fh>;
+   close($fh);
+
+   die "$0: $self->{_file} is not an elf file\n" unless (substr($data, 0, 4) eq "\x7fELF");
+
+   my $is64 = (ord(substr($data, 4, 1)) == 2);
+   my $le = (ord(substr($data, 5, 1)) == 1);
+   my ($w16, $w32, $w64) = $le ? ("v", "V", "Q<") : ("n", "N", "Q>");
+
+   my ($shoff, $shentsize, $shnum, $shstrndx);
+   if ($is64) {
+      $shoff = unpack($w64, substr($data, 0x28, 8));
+      ($shentsize, $shnum, $shstrndx) = unpack("$w16$w16$w16", substr($data, 0x3A, 6));
+   } else {
+      $shoff = unpack($w32, substr($data, 0x20, 4));
+      ($shentsize, $shnum, $shstrndx) = unpack("$w16$w16$w16", substr($data, 0x2E, 6));
+   }
+
+   my @secs;
+   for (my $i = 0; $i < $shnum; $i++) {
+      my $sh = substr($data, $shoff + $i * $shentsize, $shentsize);
+      my %sec;
+      if ($is64) {
+         @sec{qw(name type flags addr offset size)} =
+            unpack("$w32$w32$w64$w64$w64$w64", $sh);
+      } else {
+         @sec{qw(name type flags addr offset size)} =
+            unpack("$w32$w32$w32$w32$w32$w32", $sh);
+      }
+      push @secs, \%sec;
+   }
+
+   my $strtab = $secs[$shstrndx]->{offset};
+   foreach my $sec (@secs) {
+      $sec->{name} = unpack("Z*", substr($data, $strtab + $sec->{name}));
+   }
+
+   $self->{_data} = $data;
+   $self->{_word} = $w32;
+   $self->{_sections} = \@secs;
+
+   bless $self, $class;
+   return $self;
+}
+
+# unpack format of a 32 bits word with the endianness of the target
+sub word {
+   my ($self) = @_;
+   return $self->{_word};
+}
+
+# get a section by its name, undef if not found
+sub section {
+   my ($self, $name) = @_;
+   my ($sec) = grep { $_->{name} eq $name } @{$self->{_sections}};
+   return $sec;
+}
+
+# get the string at an offset of a section
+sub sectionString {
+   my ($self, $sec, $offset) = @_;
+   return unpack("Z*", substr($self->{_data}, $sec->{offset} + $offset));
+}
+
+# get a constant string of the image by its address, undef if not found
+sub string {
+   my ($self, $addr) = @_;
+
+   foreach my $sec (@{$self->{_sections}}) {
+      # allocated and with content in the file
+      next unless (($sec->{flags} & 0x2) && ($sec->{type} != 8));
+      if (($addr >= $sec->{addr}) && ($addr < $sec->{addr} + $sec->{size})) {
+         return $self->sectionString($sec, $addr - $sec->{addr});
+      }
+   }
+
+   return undef;
+}
+
+1;
@@ -0,0 +1,77 @@
+#!/usr/bin/perl
+
+use warnings;
+use strict;
+use JSON::PP;
+
+###############################################################################
+# Comparator of the results of the benchmark runner
+#
+# Compares the median ns per call of each case of the results written by
+# modules/tools/bench against a baseline written by the same runner and
+# flags the cases which are slower than the baseline by more than the
+# threshold. The 99th percentile is reported but not checked, it depends too
+# much on the load of the host.
+#
+# Usage: bench.pl results.json [baseline.json [threshold %]]
+#
+# Exits with 1 if a case regressed, if the baseline is not present the
+# results are only printed.
+###############################################################################
+
+############################# CONFIGURATION ###################################
+###############################################################################
+# default threshold in percent
+my $threshold = 10;
+
+############################# END OF CONFIGURATION ############################
+my $num_args = $#ARGV + 1;
+if (($num_args < 1) || ($num_args > 3)) {
+   print "\nUsage: bench.pl results.json [baseline.json [threshold]]\n";
+   exit 1;
+}
+
+my $results = read_json($ARGV[0]);
+my $baseline;
+if (($num_args > 1) && (-e $ARGV[1])) {
+   $baseline = read_json($ARGV[1]);
+} elsif ($num_args > 1) {
+   print "bench.pl: baseline $ARGV[1] not found, store one with make bench_baseline\n";
+}
+$threshold = $ARGV[2] if ($num_args > 2);
+
+my $regressions = 0;
+printf("%-32s %12s %12s %12s %9s\n", "case", "median ns", "p99 ns", "baseline", "delta");
+foreach my $name (sort keys %{$results->{cases}}) {
+   my $case = $results->{cases}{$name};
+   my $line = sprintf("%-32s %12.1f %12.1f", $name, $case->{ns}{median}, $case->{ns}{p99});
+
+   if (defined($baseline) && defined($baseline->{cases}{$name})) {
+      my $base = $baseline->{cases}{$name}{ns}{median};
+      my $delta = ($base > 0) ? (($case->{ns}{median} - $base) * 100.0 / $base) : 0;
+      $line .= sprintf(" %12.1f %+8.1f%%", $base, $delta);
+      if ($delta > $threshold) {
+         $line .= " REGRESSION";
+         $regressions++;
+      }
+   } elsif (defined($baseline)) {
+      $line .= sprintf(" %12s %9s", "-", "new");
+   }
+   print "$line\n";
+}
+
+if ($regressions != 0) {
+   print "bench.pl: $regressions case(s) slower than the baseline by more than $threshold%\n";
+   exit 1;
+}
+
+# read a json file
+sub read_json {
+   my ($path) = @_;
+   open(my $in, "<", $path) or die "$0: open $path $!";
+   local $/;
+   my $json = decode_json(<$in>);
+   close($in);
+
+   return $json;
+}
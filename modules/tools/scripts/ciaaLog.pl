@@ -0,0 +1,119 @@
+#!/usr/bin/perl
+
+use warnings;
+use strict;
+use FindBin;
+
+use lib $FindBin::Bin;
+use Elf;
+
+###############################################################################
+# Decoder of the ciaaLog binary records
+#
+# Reads the records written by ciaaLog_drain from a file, a serial port or
+# stdin and prints the messages. The format strings are taken from the
+# ciaaLog section of the elf file of the image which wrote the records.
+#
+# Usage: ciaaLog.pl image.axf [records.bin|/dev/ttyUSB1]
+###############################################################################
+
+############################# CONFIGURATION ###################################
+###############################################################################
+# name of the section containing the format strings
+my $log_section = "ciaaLog";
+# marker of the first word of a record
+my $marker = 0xC1;
+# maximal count of arguments of a record
+my $max_args = 4;
+
+############################# END OF CONFIGURATION ############################
+my $num_args = $#ARGV + 1;
+if (($num_args < 1) || ($num_args > 2)) {
+   print "\nUsage: ciaaLog.pl image.axf [records.bin]\n";
+   exit;
+}
+
+my $elf = new Elf($ARGV[0]);
+my $word = $elf->word();
+
+my $log = $elf->section($log_section);
+die "$0: section $log_section not found in $ARGV[0]\n" unless defined $log;
+
+my $in = \*STDIN;
+if ($num_args == 2) {
+   open($in, "<", $ARGV[1]) or die "$0: open $ARGV[1] $!";
+}
+binmode($in);
+
+my $skipped = 0;
+while (defined(my $header = read_word())) {
+   my $nargs = $header & 0x7;
+   my $offset = ($header & 0x00FFFFFF) >> 3;
+   if ( ((($header >> 24) & 0xFF) != $marker) || ($nargs > $max_args) ||
+        ($offset >= $log->{size}) ) {
+      # not a record header, resynchronize on the next word
+      $skipped++;
+      next;
+   }
+   if ($skipped != 0) {
+      print "ciaaLog.pl: $skipped words skipped\n";
+      $skipped = 0;
+   }
+
+   my @args;
+   for (my $i = 0; $i < $nargs; $i++) {
+      my $arg = read_word();
+      exit unless defined $arg;
+      push @args, $arg;
+   }
+
+   my $fmt = $elf->sectionString($log, $offset);
+   print format_record($fmt, @args), "\n";
+}
+
+# read one 32 bits word of the records with the endianness of the target
+sub read_word {
+   my $data = "";
+   while (length($data) < 4) {
+      my $ret = read($in, $data, 4 - length($data), length($data));
+      return undef if (!defined($ret) || ($ret == 0));
+   }
+   return unpack($word, $data);
+}
+
+# printf like formatting of the 32 bits arguments
+sub format_record {
+   my ($fmt, @args) = @_;
+
+   $fmt =~ s{%([-+ #0]*\d*(?:\.\d+)?)[hlzjt]*([diouxXcsp%])}{
+      my ($flags, $conv) = ($1, $2);
+      my $out;
+      if ($conv eq "%") {
+         $out = "%";
+      } else {
+         my $arg = shift(@args);
+         $arg = 0 unless defined $arg;
+         if (($conv eq "d") || ($conv eq "i")) {
+            $arg -= 4294967296 if ($arg & 0x80000000);
+            $out = sprintf("%${flags}d", $arg);
+         } elsif ($conv eq "s") {
+            $out = sprintf("%${flags}s", get_string($arg));
+         } elsif ($conv eq "p") {
+            $out = sprintf("0x%08x", $arg);
+         } else {
+            $out = sprintf("%${flags}${conv}", $arg);
+         }
+      }
+      $out;
+   }ge;
+
+   return $fmt;
+}
+
+# get a constant string of the image by its address
+sub get_string {
+   my ($addr) = @_;
+   my $str = $elf->string($addr);
+
+   return defined($str) ? $str : sprintf("<0x%08x>", $addr);
+}
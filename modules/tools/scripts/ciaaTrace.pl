@@ -0,0 +1,132 @@
+#!/usr/bin/perl
+
+use warnings;
+use strict;
+use FindBin;
+use Getopt::Long;
+
+use lib $FindBin::Bin;
+use Elf;
+
+###############################################################################
+# Converter of the ciaak trace records to the Chrome trace event format
+#
+# Reads the records written by ciaak_traceDrain, one file per core, and
+# prints a json file which can be opened with chrome://tracing or
+# https://ui.perfetto.dev. The tasks and the interrupts are shown as slices,
+# the bytes transferred by each device as counters. The device names are
+# taken from the elf file of the image if given.
+#
+# Usage: ciaaTrace.pl [-e image.axf] [-f frequency] core0.bin [core1.bin ...]
+###############################################################################
+
+############################# CONFIGURATION ###################################
+###############################################################################
+# marker of the first word of a record
+my $marker = 0xCE;
+# words of a record
+my $record_words = 3;
+# thread id of the first interrupt, the tasks use their id
+my $isr_tid = 1000;
+
+############################# END OF CONFIGURATION ############################
+my $elf_file;
+my $frequency;
+
+if (!GetOptions("e=s" => \$elf_file, "f=i" => \$frequency) || ($#ARGV < 0)) {
+   print "\nUsage: ciaaTrace.pl [-e image.axf] [-f frequency] core0.bin [core1.bin ...]\n";
+   exit;
+}
+
+my $elf = defined($elf_file) ? new Elf($elf_file) : undef;
+
+my @events;
+my %names;
+
+foreach my $file (@ARGV) {
+   decode_file($file);
+}
+
+# names of the cores, tasks and interrupts
+foreach my $key (sort keys %names) {
+   my ($pid, $tid) = split(/:/, $key);
+   if ($tid eq "") {
+      push @events, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":$pid,\"args\":{\"name\":\"$names{$key}\"}}";
+   } else {
+      push @events, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":$pid,\"tid\":$tid,\"args\":{\"name\":\"$names{$key}\"}}";
+   }
+}
+
+print "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+print join(",\n", @events), "\n";
+print "]}\n";
+
+# decode the records of one core
+sub decode_file {
+   my ($file) = @_;
+   my $data;
+
+   open(my $in, "<", $file) or die "$0: open $file $!";
+   binmode($in);
+   local $/;
+   $data = <$in>;
+   close($in);
+
+   # the target writes its own endianness, the marker is on the first word
+   my $word = "V";
+   if (length($data) >= 4) {
+      $word = "N" if ((unpack("V", $data) >> 24) != $marker);
+   }
+   my @words = unpack("$word*", substr($data, 0, length($data) & ~3));
+
+   my $freq = $frequency;
+   my $last;
+   my $time = 0;
+   my %devices;
+   my %bytes;
+   my $i = 0;
+
+   while ($i + $record_words <= @words) {
+      my ($header, $stamp, $value) = @words[$i .. $i + $record_words - 1];
+      if ((($header >> 24) & 0xFF) != $marker) {
+         # not a record header, resynchronize on the next word
+         $i++;
+         next;
+      }
+      $i += $record_words;
+
+      my $type = ($header >> 20) & 0xF;
+      my $core = ($header >> 16) & 0xF;
+      my $id = $header & 0xFFFF;
+
+      # the timestamps are 32 bits, they wrap
+      $time += defined($last) ? (($stamp - $last) & 0xFFFFFFFF) : 0;
+      $last = $stamp;
+      my $ts = (defined($freq) && ($freq != 0)) ? sprintf("%.3f", $time * 1e6 / $freq) : $time;
+
+      $names{"$core:"} = "core $core";
+
+      if ($type == 0) {
+         $freq = $value unless defined($frequency);
+      } elsif (($type == 1) || ($type == 2)) {
+         my $ph = ($type == 1) ? "B" : "E";
+         $names{"$core:$id"} = "task $id";
+         push @events, "{\"name\":\"task $id\",\"cat\":\"task\",\"ph\":\"$ph\",\"pid\":$core,\"tid\":$id,\"ts\":$ts}";
+      } elsif (($type == 3) || ($type == 4)) {
+         my $ph = ($type == 3) ? "B" : "E";
+         my $tid = $isr_tid + $id;
+         $names{"$core:$tid"} = "isr $id";
+         push @events, "{\"name\":\"isr $id\",\"cat\":\"isr\",\"ph\":\"$ph\",\"pid\":$core,\"tid\":$tid,\"ts\":$ts}";
+      } elsif (($type == 5) || ($type == 6)) {
+         my $dir = ($type == 5) ? "read" : "written";
+         my $name = defined($devices{$id}) ? $devices{$id} : "device $id";
+         $bytes{"$id:$dir"} += $value;
+         push @events, "{\"name\":\"$name $dir\",\"cat\":\"device\",\"ph\":\"C\",\"pid\":$core,\"ts\":$ts,\"args\":{\"bytes\":" . $bytes{"$id:$dir"} . "}}";
+      } elsif ($type == 7) {
+         my $name = defined($elf) ? $elf->string($value) : undef;
+         $devices{$id} = defined($name) ? $name : "device $id";
+      } elsif ($type == 8) {
+         push @events, "{\"name\":\"$value records dropped\",\"cat\":\"trace\",\"ph\":\"i\",\"s\":\"p\",\"pid\":$core,\"ts\":$ts}";
+      }
+   }
+}